@@ -9,9 +9,18 @@
 #include "VectorMath.h"
 #include <vector>
 #include <stack>
+#include <algorithm>
+#include <limits>
 
 #include "AABB.h"
 
+#if defined(ENABLE_TBB) && !defined(__HIPCC__)
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_invoke.h>
+#include <tbb/parallel_sort.h>
+#endif
+
 #ifndef __AABB_TREE_H__
 #define __AABB_TREE_H__
 
@@ -39,6 +48,9 @@ namespace detail
 
 const unsigned int NODE_CAPACITY = 16;           //!< Maximum number of particles in a node
 const unsigned int INVALID_NODE = 0xffffffff;   //!< Invalid node index sentinel
+const unsigned int WIDE_NODE_WIDTH = 4;         //!< Number of children of a node in the wide tree
+const unsigned int WIDE_LEAF_FLAG = 0x80000000; //!< Flags a wide node child that is a leaf of the binary tree
+const unsigned int WIDE_STACK_SIZE = 192;       //!< Size of the traversal stack for the wide tree
 
 #ifndef __HIPCC__
 
@@ -66,6 +78,85 @@ struct PYBIND11_EXPORT AABBNode
     unsigned int num_particles;                 //!< Number of particles contained in the node
     } __attribute__((aligned(32)));
 
+//! Node in the wide view of an AABBTree
+/*! Stores the boxes of up to WIDE_NODE_WIDTH children in structure of arrays form, so that a query box can be tested
+    against all of them at once with SSE (single precision) or AVX (double precision). Empty child slots hold inverted
+    boxes that never overlap.
+*/
+struct PYBIND11_EXPORT AABBWideNode
+    {
+    //! Default constructor
+    AABBWideNode()
+        {
+        for (unsigned int i = 0; i < WIDE_NODE_WIDTH; i++)
+            {
+            lower_x[i] = lower_y[i] = lower_z[i] = std::numeric_limits<Scalar>::max();
+            upper_x[i] = upper_y[i] = upper_z[i] = -std::numeric_limits<Scalar>::max();
+            child[i] = INVALID_NODE;
+            }
+        }
+
+    //! Set the box of a child slot
+    void setBox(unsigned int slot, const AABB& aabb)
+        {
+        vec3<Scalar> lower = aabb.getLower();
+        vec3<Scalar> upper = aabb.getUpper();
+        lower_x[slot] = lower.x; lower_y[slot] = lower.y; lower_z[slot] = lower.z;
+        upper_x[slot] = upper.x; upper_y[slot] = upper.y; upper_z[slot] = upper.z;
+        }
+
+    Scalar lower_x[WIDE_NODE_WIDTH];    //!< x coordinates of the lower corners of the children
+    Scalar lower_y[WIDE_NODE_WIDTH];    //!< y coordinates of the lower corners of the children
+    Scalar lower_z[WIDE_NODE_WIDTH];    //!< z coordinates of the lower corners of the children
+    Scalar upper_x[WIDE_NODE_WIDTH];    //!< x coordinates of the upper corners of the children
+    Scalar upper_y[WIDE_NODE_WIDTH];    //!< y coordinates of the upper corners of the children
+    Scalar upper_z[WIDE_NODE_WIDTH];    //!< z coordinates of the upper corners of the children
+
+    //! Index of the wide node of each child, or the index of the binary leaf node OR'ed with WIDE_LEAF_FLAG
+    unsigned int child[WIDE_NODE_WIDTH];
+    } __attribute__((aligned(32)));
+
+//! Test a box against all children of a wide node
+/*! \param node Wide node to test
+    \param lower Lower corner of the query box
+    \param upper Upper corner of the query box
+    \returns A bit mask with bit i set when child i overlaps the query box
+
+    The comparisons are the same as in overlap(), so the result agrees exactly with testing each child separately.
+*/
+inline unsigned int overlapWide(const AABBWideNode& node, const vec3<Scalar>& lower, const vec3<Scalar>& upper)
+    {
+    #if defined(__AVX__) && !defined(SINGLE_PRECISION)
+    __m256d x = _mm256_and_pd(_mm256_cmp_pd(_mm256_loadu_pd(node.lower_x), _mm256_set1_pd(upper.x), _CMP_LE_OQ),
+                              _mm256_cmp_pd(_mm256_loadu_pd(node.upper_x), _mm256_set1_pd(lower.x), _CMP_GE_OQ));
+    __m256d y = _mm256_and_pd(_mm256_cmp_pd(_mm256_loadu_pd(node.lower_y), _mm256_set1_pd(upper.y), _CMP_LE_OQ),
+                              _mm256_cmp_pd(_mm256_loadu_pd(node.upper_y), _mm256_set1_pd(lower.y), _CMP_GE_OQ));
+    __m256d z = _mm256_and_pd(_mm256_cmp_pd(_mm256_loadu_pd(node.lower_z), _mm256_set1_pd(upper.z), _CMP_LE_OQ),
+                              _mm256_cmp_pd(_mm256_loadu_pd(node.upper_z), _mm256_set1_pd(lower.z), _CMP_GE_OQ));
+    return _mm256_movemask_pd(_mm256_and_pd(x, _mm256_and_pd(y, z)));
+
+    #elif defined(__SSE__) && defined(SINGLE_PRECISION)
+    __m128 x = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(node.lower_x), _mm_set1_ps(upper.x)),
+                          _mm_cmpge_ps(_mm_loadu_ps(node.upper_x), _mm_set1_ps(lower.x)));
+    __m128 y = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(node.lower_y), _mm_set1_ps(upper.y)),
+                          _mm_cmpge_ps(_mm_loadu_ps(node.upper_y), _mm_set1_ps(lower.y)));
+    __m128 z = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(node.lower_z), _mm_set1_ps(upper.z)),
+                          _mm_cmpge_ps(_mm_loadu_ps(node.upper_z), _mm_set1_ps(lower.z)));
+    return _mm_movemask_ps(_mm_and_ps(x, _mm_and_ps(y, z)));
+
+    #else
+    unsigned int mask = 0;
+    for (unsigned int i = 0; i < WIDE_NODE_WIDTH; i++)
+        {
+        if (node.lower_x[i] <= upper.x && node.upper_x[i] >= lower.x
+            && node.lower_y[i] <= upper.y && node.upper_y[i] >= lower.y
+            && node.lower_z[i] <= upper.z && node.upper_z[i] >= lower.z)
+            mask |= 1 << i;
+        }
+    return mask;
+    #endif
+    }
+
 //! AABB Tree
 /*! An AABBTree stores a binary tree of AABBs. A leaf node stores up to NODE_CAPACITY particles by index. The bounding
     box of a leaf node surrounds all the bounding boxes of its contained particles. Internal nodes have AABBs that
@@ -90,16 +181,34 @@ struct PYBIND11_EXPORT AABBNode
     For performance, no recursive calls are used. Instead, each function is either turned into a loop if it uses
     tail recursion, or it uses a local stack to traverse the tree. The stack is cached between calls to limit
     the amount of dynamic memory allocation.
+
+    Two build methods are available. The median build recursively splits the longest axis of each node at its center.
+    The morton build (the default) sorts the particles along a Morton (Z-order) curve of their AABB centers and
+    splits the sorted list at the highest differing bit of the Morton codes, as in a linear BVH, down to leaves of at
+    most NODE_CAPACITY particles. Because a subtree over L leaves always holds 2L-1 nodes, the pre-order index of
+    every node is known before it is built, so the sort and both halves of every split run concurrently with TBB.
+    Both methods store the nodes in pre-order with skip counts for the stackless traversal.
+
+    When enabled with setWideNodes(), buildTree() also collapses the binary tree into a 4-wide tree of AABBWideNode,
+    whose child boxes are tested together with SSE or AVX in traverse() and query(). The leaves of the wide tree are
+    the leaves of the binary tree, and update() keeps both views consistent.
 */
 class PYBIND11_EXPORT AABBTree
     {
     public:
         //! Construct an AABBTree
         AABBTree()
-            : m_nodes(0), m_num_nodes(0), m_node_capacity(0), m_root(0)
+            : m_nodes(0), m_num_nodes(0), m_node_capacity(0), m_root(0), m_wide(false)
             {
             }
 
+        //! Methods to build the tree
+        enum BuildMethod
+            {
+            median, //!< Recursive split at the center of the longest axis
+            morton  //!< Linear BVH over the Morton order of the particles
+            };
+
         // Destructor
         ~AABBTree()
             {
@@ -114,6 +223,9 @@ class PYBIND11_EXPORT AABBTree
             m_node_capacity = from.m_node_capacity;
             m_root = from.m_root;
             m_mapping = from.m_mapping;
+            m_wide = from.m_wide;
+            m_wide_nodes = from.m_wide_nodes;
+            m_wide_slot = from.m_wide_slot;
 
             m_nodes = NULL;
 
@@ -138,6 +250,9 @@ class PYBIND11_EXPORT AABBTree
             m_node_capacity = from.m_node_capacity;
             m_root = from.m_root;
             m_mapping = from.m_mapping;
+            m_wide = from.m_wide;
+            m_wide_nodes = from.m_wide_nodes;
+            m_wide_slot = from.m_wide_slot;
 
             if (m_nodes)
                 free(m_nodes);
@@ -160,13 +275,34 @@ class PYBIND11_EXPORT AABBTree
             }
 
         //! Build a tree smartly from a list of AABBs
-        inline void buildTree(AABB *aabbs, unsigned int N);
+        inline void buildTree(AABB *aabbs, unsigned int N, BuildMethod method=morton);
 
         //! Find all particles that overlap with the query AABB
         inline unsigned int query(std::vector<unsigned int>& hits, const AABB& aabb) const;
 
+        //! Call a function for every leaf node that overlaps with the query AABB
+        template<class Visitor>
+        inline unsigned int traverse(const AABB& aabb, Visitor&& visit) const;
+
+        //! Set whether buildTree() also builds the wide view of the tree
+        void setWideNodes(bool wide)
+            {
+            m_wide = wide;
+            if (!wide)
+                {
+                m_wide_nodes.clear();
+                m_wide_slot.clear();
+                }
+            }
+
+        //! Get the number of nodes in the wide view of the tree (0 if not built)
+        inline unsigned int getNumWideNodes() const
+            {
+            return (unsigned int)m_wide_nodes.size();
+            }
+
         //! Update the AABB of a particle
-        inline void update(unsigned int idx, const AABB& aabb);
+        inline bool update(unsigned int idx, const AABB& aabb);
 
         //! Get the height of a given particle's leaf node
         inline unsigned int height(unsigned int idx);
@@ -248,15 +384,49 @@ class PYBIND11_EXPORT AABBTree
         unsigned int m_root;                //!< Index to the root node of the tree
         std::vector<unsigned int> m_mapping;//!< Reverse mapping to find node given a particle index
 
+        bool m_wide;                                //!< True if the wide view is built with the tree
+        std::vector<AABBWideNode> m_wide_nodes;     //!< Nodes of the wide view, the root is node 0
+        std::vector<unsigned int> m_wide_slot;      //!< Wide node and slot (node*WIDE_NODE_WIDTH+slot) of each node
+
         //! Initialize the tree to hold N particles
         inline void init(unsigned int N);
 
         //! Build a node of the tree recursively
         inline unsigned int buildNode(AABB *aabbs, std::vector<unsigned int>& idx, unsigned int start, unsigned int len, unsigned int parent);
 
+        //! Build the tree over the Morton order of the AABBs
+        inline void buildMorton(AABB *aabbs, unsigned int N);
+
+        //! Partition a range of particles in Morton order into leaves
+        inline void findMortonLeaves(const std::vector< std::pair<unsigned int, unsigned int> >& keys,
+                                     unsigned int first,
+                                     unsigned int last,
+                                     std::vector<unsigned int>& leaf_start);
+
+        //! Build the subtree over a range of leaves in Morton order
+        inline void buildMortonNode(AABB *aabbs,
+                                    const std::vector< std::pair<unsigned int, unsigned int> >& keys,
+                                    const std::vector<unsigned int>& leaf_start,
+                                    unsigned int idx,
+                                    unsigned int first,
+                                    unsigned int last,
+                                    unsigned int parent);
+
+        //! Build the wide view of the tree
+        inline void buildWide();
+
+        //! Collapse a subtree into a wide node, recursively
+        inline unsigned int buildWideNode(unsigned int node, unsigned int depth, unsigned int& max_depth);
+
         //! Allocate a new node
         inline unsigned int allocateNode();
 
+        //! Grow the node memory to hold at least n nodes
+        inline void reserveNodes(unsigned int n);
+
+        //! Copy the AABB of a node into its slot in the wide view
+        inline void updateWideSlot(unsigned int node);
+
         //! Update the skip value for a node
         inline unsigned int updateSkip(unsigned int idx);
     };
@@ -284,12 +454,63 @@ inline void AABBTree::init(unsigned int N)
     \returns the number of box overlap checks made during the recursion
 
     The *hits* vector is not cleared, elements are only added with push_back. query() traverses the tree and finds all
-    of the leaf nodes that intersect *aabb*. The index of each intersecting leaf node is added to the hits vector.
+    of the leaf nodes that intersect *aabb*. The index of each particle in an intersecting leaf node is added to the
+    hits vector.
 */
 inline unsigned int AABBTree::query(std::vector<unsigned int>& hits, const AABB& aabb) const
+    {
+    return traverse(aabb, [&](unsigned int leaf)
+        {
+        const AABBNode& leaf_node = m_nodes[leaf];
+        for (unsigned int i = 0; i < leaf_node.num_particles; i++)
+            hits.push_back(leaf_node.particles[i]);
+        });
+    }
+
+/*! \param aabb The AABB to query
+    \param visit Function called with the index of every leaf node that intersects *aabb*
+    \returns the number of box overlap checks made during the traversal
+
+    When the wide view is built, all children of a wide node are tested at once and the wide nodes still to be
+    visited are held on a small local stack. Otherwise, the binary tree is searched in a stackless fashion.
+*/
+template<class Visitor>
+inline unsigned int AABBTree::traverse(const AABB& aabb, Visitor&& visit) const
     {
     unsigned int box_overlap_counts = 0;
 
+    if (m_wide_nodes.size())
+        {
+        const vec3<Scalar> lower = aabb.getLower();
+        const vec3<Scalar> upper = aabb.getUpper();
+
+        unsigned int stack[WIDE_STACK_SIZE];
+        unsigned int stack_size = 0;
+        stack[stack_size++] = 0;
+
+        while (stack_size > 0)
+            {
+            const AABBWideNode& current_node = m_wide_nodes[stack[--stack_size]];
+
+            box_overlap_counts += WIDE_NODE_WIDTH;
+            const unsigned int mask = overlapWide(current_node, lower, upper);
+
+            for (unsigned int i = 0; i < WIDE_NODE_WIDTH; i++)
+                {
+                if (!(mask & (1 << i)))
+                    continue;
+
+                const unsigned int child = current_node.child[i];
+                if (child & WIDE_LEAF_FLAG)
+                    visit(child & ~WIDE_LEAF_FLAG);
+                else
+                    stack[stack_size++] = child;
+                }
+            }
+
+        return box_overlap_counts;
+        }
+
     // avoid pointer indirection overhead of std::vector
     AABBNode* nodes = &m_nodes[0];
 
@@ -304,8 +525,7 @@ inline unsigned int AABBTree::query(std::vector<unsigned int>& hits, const AABB&
             {
             if (current_node.left == INVALID_NODE)
                 {
-                for (unsigned int i = 0; i < current_node.num_particles; i++)
-                    hits.push_back(current_node.particles[i]);
+                visit(current_node_idx);
                 }
             }
         else
@@ -321,11 +541,12 @@ inline unsigned int AABBTree::query(std::vector<unsigned int>& hits, const AABB&
 
 /*! \param idx Particle index to update
     \param aabb New AABB for particle *idx*
+    \returns true if the node had to be grown to enclose *aabb*
 
     Update the node for particle *idx* and its parent nodes to reflect a new position and/or extents. update() does not
     change the tree topology, so it is best for slight changes.
 */
-inline void AABBTree::update(unsigned int idx, const AABB& aabb)
+inline bool AABBTree::update(unsigned int idx, const AABB& aabb)
     {
     assert(idx < m_mapping.size());
 
@@ -337,6 +558,7 @@ inline void AABBTree::update(unsigned int idx, const AABB& aabb)
     if (!contains(m_nodes[node_idx].aabb, aabb))
         {
         m_nodes[node_idx].aabb = merge(m_nodes[node_idx].aabb, aabb);
+        updateWideSlot(node_idx);
 
         // update all parent node AABBs
         unsigned int current_node = m_nodes[node_idx].parent;
@@ -346,9 +568,14 @@ inline void AABBTree::update(unsigned int idx, const AABB& aabb)
             unsigned int right_idx = m_nodes[current_node].right;
 
             m_nodes[current_node].aabb = merge(m_nodes[left_idx].aabb, m_nodes[right_idx].aabb);
+            updateWideSlot(current_node);
             current_node = m_nodes[current_node].parent;
             }
+
+        return true;
         }
+
+    return false;
     }
 
 /*! \param idx Particle to get height for
@@ -381,20 +608,249 @@ inline unsigned int AABBTree::height(unsigned int idx)
 
 /*! \param aabbs List of AABBs for each particle (must be 32-byte aligned)
     \param N Number of AABBs in the list
+    \param method Method used to build the tree
 
-    Builds a balanced tree from a given list of AABBs for each particle. Data in \a aabbs will be modified during
+    Builds a balanced tree from a given list of AABBs for each particle. Data in \a aabbs may be modified during
     the construction process.
 */
-inline void AABBTree::buildTree(AABB *aabbs, unsigned int N)
+inline void AABBTree::buildTree(AABB *aabbs, unsigned int N, BuildMethod method)
     {
     init(N);
 
-    std::vector<unsigned int> idx;
-    for (unsigned int i = 0; i < N; i++)
-        idx.push_back(i);
+    if (method == morton)
+        {
+        buildMorton(aabbs, N);
+        }
+    else
+        {
+        std::vector<unsigned int> idx;
+        for (unsigned int i = 0; i < N; i++)
+            idx.push_back(i);
+
+        m_root = buildNode(aabbs, idx, 0, N, INVALID_NODE);
+        updateSkip(m_root);
+        }
+
+    if (m_wide)
+        buildWide();
+    }
+
+//! Spread the lower 10 bits of an integer out to every third bit
+inline unsigned int expandMortonBits(unsigned int v)
+    {
+    v = (v * 0x00010001u) & 0xFF0000FFu;
+    v = (v * 0x00000101u) & 0x0F00F00Fu;
+    v = (v * 0x00000011u) & 0xC30C30C3u;
+    v = (v * 0x00000005u) & 0x49249249u;
+    return v;
+    }
+
+//! Find where to split a sorted range of Morton codes
+/*! \param code Function returning the Morton code of element i
+    \param first First element of the range
+    \param last One past the last element of the range (at least first+2)
+    \returns The first element of the right half, first < split < last
+
+    The range is split where the highest bit that differs between its first and last code changes, or in the middle
+    when all codes are equal.
+*/
+template<class CodeFunction>
+inline unsigned int splitMortonRange(const CodeFunction& code, unsigned int first, unsigned int last)
+    {
+    const unsigned int code_first = code(first);
+    const unsigned int code_last = code(last-1);
+    if (code_first == code_last)
+        return first + (last - first)/2;
+
+    // binary search for the last element that shares more leading bits with the first one than the last one does
+    const int prefix = __builtin_clz(code_first ^ code_last);
+    unsigned int left_last = first;
+    unsigned int step = last - 1 - first;
+    do
+        {
+        step = (step + 1) >> 1;
+        const unsigned int candidate = left_last + step;
+        if (candidate < last - 1)
+            {
+            const unsigned int code_candidate = code(candidate);
+            if (code_candidate == code_first || __builtin_clz(code_first ^ code_candidate) > prefix)
+                left_last = candidate;
+            }
+        }
+    while (step > 1);
+
+    return left_last + 1;
+    }
+
+const unsigned int MORTON_PARALLEL_N = 4096;       //!< Minimum number of particles to compute Morton codes in parallel
+const unsigned int MORTON_PARALLEL_LEAVES = 64;    //!< Minimum number of leaves to build the two subtrees in parallel
+
+/*! \param aabbs List of AABBs for each particle
+    \param N Number of AABBs in the list
+
+    The centers of the AABBs are quantized to 10 bits per dimension within their bounding box and interleaved into
+    30-bit Morton codes. The particles are sorted by code, with ties broken by index so that the tree does not depend
+    on the number of threads. The sorted list is split recursively at the Morton code bits into leaves of at most
+    NODE_CAPACITY particles, and the leaves are then arranged into the tree by buildMortonNode().
+*/
+inline void AABBTree::buildMorton(AABB *aabbs, unsigned int N)
+    {
+    if (N == 0)
+        return;
+
+    // bounding box of the AABB centers
+    vec3<Scalar> lower = aabbs[0].getPosition();
+    vec3<Scalar> upper = lower;
+    for (unsigned int i = 1; i < N; i++)
+        {
+        vec3<Scalar> r = aabbs[i].getPosition();
+        lower.x = std::min(lower.x, r.x); lower.y = std::min(lower.y, r.y); lower.z = std::min(lower.z, r.z);
+        upper.x = std::max(upper.x, r.x); upper.y = std::max(upper.y, r.y); upper.z = std::max(upper.z, r.z);
+        }
 
-    m_root = buildNode(aabbs, idx, 0, N, INVALID_NODE);
-    updateSkip(m_root);
+    vec3<Scalar> extent = upper - lower;
+    vec3<Scalar> scale(extent.x > Scalar(0.0) ? Scalar(1023.999)/extent.x : Scalar(0.0),
+                       extent.y > Scalar(0.0) ? Scalar(1023.999)/extent.y : Scalar(0.0),
+                       extent.z > Scalar(0.0) ? Scalar(1023.999)/extent.z : Scalar(0.0));
+
+    std::vector< std::pair<unsigned int, unsigned int> > keys(N);
+    auto make_keys = [&](unsigned int first, unsigned int last)
+        {
+        for (unsigned int i = first; i < last; i++)
+            {
+            vec3<Scalar> r = aabbs[i].getPosition() - lower;
+            unsigned int x = std::min((unsigned int)(r.x*scale.x), 1023u);
+            unsigned int y = std::min((unsigned int)(r.y*scale.y), 1023u);
+            unsigned int z = std::min((unsigned int)(r.z*scale.z), 1023u);
+            unsigned int code = (expandMortonBits(x) << 2) | (expandMortonBits(y) << 1) | expandMortonBits(z);
+            keys[i] = std::make_pair(code, i);
+            }
+        };
+
+    #ifdef ENABLE_TBB
+    if (N >= MORTON_PARALLEL_N)
+        {
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N),
+            [&](const tbb::blocked_range<unsigned int>& r)
+            {
+            make_keys(r.begin(), r.end());
+            });
+        tbb::parallel_sort(keys.begin(), keys.end());
+        }
+    else
+    #endif
+        {
+        make_keys(0, N);
+        std::sort(keys.begin(), keys.end());
+        }
+
+    // leaf l holds the particles keys[leaf_start[l]] to keys[leaf_start[l+1]-1]
+    std::vector<unsigned int> leaf_start;
+    leaf_start.reserve(2*N/NODE_CAPACITY + 2);
+    findMortonLeaves(keys, 0, N, leaf_start);
+    leaf_start.push_back(N);
+
+    // a binary tree over n_leaves leaves has 2*n_leaves-1 nodes
+    const unsigned int n_leaves = (unsigned int)leaf_start.size() - 1;
+    reserveNodes(2*n_leaves-1);
+    m_num_nodes = 2*n_leaves-1;
+    m_root = 0;
+
+    buildMortonNode(aabbs, keys, leaf_start, 0, 0, n_leaves, INVALID_NODE);
+    }
+
+/*! \param keys Morton codes and indices of the particles in sorted order
+    \param first First particle of the range
+    \param last One past the last particle of the range
+    \param leaf_start Output list of the first particle of every leaf, in order
+
+    Ending the leaves at changes of the Morton code bits keeps them spatially compact.
+*/
+inline void AABBTree::findMortonLeaves(const std::vector< std::pair<unsigned int, unsigned int> >& keys,
+                                       unsigned int first,
+                                       unsigned int last,
+                                       std::vector<unsigned int>& leaf_start)
+    {
+    if (last - first <= NODE_CAPACITY)
+        {
+        leaf_start.push_back(first);
+        return;
+        }
+
+    auto code = [&keys](unsigned int i) { return keys[i].first; };
+    const unsigned int split = splitMortonRange(code, first, last);
+    findMortonLeaves(keys, first, split, leaf_start);
+    findMortonLeaves(keys, split, last, leaf_start);
+    }
+
+/*! \param aabbs List of AABBs for each particle
+    \param keys Morton codes and indices of the particles in sorted order
+    \param leaf_start First particle of every leaf, followed by the number of particles
+    \param idx Pre-order index of the node to build
+    \param first First leaf of the subtree
+    \param last One past the last leaf of the subtree
+    \param parent Index of the parent node
+
+    An internal node splits its leaves with splitMortonRange() applied to the codes of their first particles, which
+    reproduces the splits made by findMortonLeaves(). The left child directly follows its parent, and the right child
+    follows the 2*(split-first)-1 nodes of the left subtree, so the two subtrees can be built independently.
+*/
+inline void AABBTree::buildMortonNode(AABB *aabbs,
+                                      const std::vector< std::pair<unsigned int, unsigned int> >& keys,
+                                      const std::vector<unsigned int>& leaf_start,
+                                      unsigned int idx,
+                                      unsigned int first,
+                                      unsigned int last,
+                                      unsigned int parent)
+    {
+    AABBNode& node = m_nodes[idx];
+    node = AABBNode();
+    node.parent = parent;
+
+    // handle the case of a leaf node creation
+    if (last - first == 1)
+        {
+        const unsigned int start = leaf_start[first];
+        const unsigned int end = leaf_start[first+1];
+
+        node.aabb = aabbs[keys[start].second];
+        node.num_particles = end - start;
+        for (unsigned int i = start; i < end; i++)
+            {
+            const unsigned int p = keys[i].second;
+            node.aabb = merge(node.aabb, aabbs[p]);
+            node.particles[i-start] = p;
+            node.particle_tags[i-start] = aabbs[p].tag;
+            m_mapping[p] = idx;
+            }
+        return;
+        }
+
+    auto code = [&keys, &leaf_start](unsigned int l) { return keys[leaf_start[l]].first; };
+    const unsigned int split = splitMortonRange(code, first, last);
+
+    const unsigned int left = idx + 1;
+    const unsigned int right = idx + 2*(split - first);
+    node.left = left;
+    node.right = right;
+    node.skip = 2*(last - first) - 2;
+
+    auto build_left = [&]() { buildMortonNode(aabbs, keys, leaf_start, left, first, split, idx); };
+    auto build_right = [&]() { buildMortonNode(aabbs, keys, leaf_start, right, split, last, idx); };
+
+    #ifdef ENABLE_TBB
+    if (last - first >= MORTON_PARALLEL_LEAVES)
+        {
+        tbb::parallel_invoke(build_left, build_right);
+        }
+    else
+    #endif
+        {
+        build_left();
+        build_right();
+        }
+
+    m_nodes[idx].aabb = merge(m_nodes[left].aabb, m_nodes[right].aabb);
     }
 
 /*! \param aabbs List of AABBs
@@ -574,17 +1030,131 @@ inline unsigned int AABBTree::updateSkip(unsigned int idx)
         }
     }
 
+/*! Each wide node takes the place of an internal node of the binary tree. Its children are found by repeatedly
+    replacing the internal child with the largest surface area by its own two children, until there are
+    WIDE_NODE_WIDTH children or all of them are leaves. Trees that are too deep for the traversal stack in traverse()
+    are left without a wide view.
+*/
+inline void AABBTree::buildWide()
+    {
+    m_wide_nodes.clear();
+    m_wide_slot.assign(m_num_nodes, INVALID_NODE);
+
+    if (m_num_nodes == 0)
+        return;
+
+    unsigned int max_depth = 0;
+    buildWideNode(m_root, 0, max_depth);
+
+    // every level of the wide tree leaves at most WIDE_NODE_WIDTH-1 nodes on the traversal stack
+    if ((max_depth+1)*(WIDE_NODE_WIDTH-1) + 1 > WIDE_STACK_SIZE)
+        {
+        m_wide_nodes.clear();
+        m_wide_slot.clear();
+        }
+    }
+
+/*! \param node Index of the binary node to collapse
+    \param depth Depth of the new wide node
+    \param max_depth Maximum depth of any wide node built so far
+    \returns The index of the new wide node
+*/
+inline unsigned int AABBTree::buildWideNode(unsigned int node, unsigned int depth, unsigned int& max_depth)
+    {
+    const unsigned int wide_idx = (unsigned int)m_wide_nodes.size();
+    m_wide_nodes.push_back(AABBWideNode());
+    max_depth = std::max(max_depth, depth);
+
+    unsigned int children[WIDE_NODE_WIDTH];
+    unsigned int n_children = 0;
+    if (isNodeLeaf(node))
+        {
+        // only a tree made of a single leaf gets here
+        children[n_children++] = node;
+        }
+    else
+        {
+        children[n_children++] = m_nodes[node].left;
+        children[n_children++] = m_nodes[node].right;
+
+        while (n_children < WIDE_NODE_WIDTH)
+            {
+            unsigned int open = INVALID_NODE;
+            Scalar open_area = Scalar(-1.0);
+            for (unsigned int i = 0; i < n_children; i++)
+                {
+                if (isNodeLeaf(children[i]))
+                    continue;
+
+                vec3<Scalar> ext = m_nodes[children[i]].aabb.getUpper() - m_nodes[children[i]].aabb.getLower();
+                Scalar area = ext.x*ext.y + ext.y*ext.z + ext.z*ext.x;
+                if (area > open_area)
+                    {
+                    open = i;
+                    open_area = area;
+                    }
+                }
+
+            if (open == INVALID_NODE)
+                break;
+
+            const unsigned int opened = children[open];
+            children[open] = m_nodes[opened].left;
+            children[n_children++] = m_nodes[opened].right;
+            }
+        }
+
+    for (unsigned int i = 0; i < n_children; i++)
+        {
+        const unsigned int child = children[i];
+        unsigned int wide_child = child | WIDE_LEAF_FLAG;
+        if (!isNodeLeaf(child))
+            wide_child = buildWideNode(child, depth+1, max_depth);
+
+        // note: building the children may reallocate m_wide_nodes
+        m_wide_nodes[wide_idx].child[i] = wide_child;
+        m_wide_nodes[wide_idx].setBox(i, m_nodes[child].aabb);
+        m_wide_slot[child] = wide_idx*WIDE_NODE_WIDTH + i;
+        }
+
+    return wide_idx;
+    }
+
+/*! \param node Index of the binary node that changed
+*/
+inline void AABBTree::updateWideSlot(unsigned int node)
+    {
+    if (m_wide_slot.size() && m_wide_slot[node] != INVALID_NODE)
+        {
+        const unsigned int slot = m_wide_slot[node];
+        m_wide_nodes[slot / WIDE_NODE_WIDTH].setBox(slot % WIDE_NODE_WIDTH, m_nodes[node].aabb);
+        }
+    }
+
 /*! Allocates a new node in the tree
 */
 inline unsigned int AABBTree::allocateNode()
+    {
+    reserveNodes(m_num_nodes+1);
+
+    m_nodes[m_num_nodes] = AABBNode();
+    m_num_nodes++;
+    return m_num_nodes-1;
+    }
+
+/*! \param n Number of nodes to make room for
+
+    Existing nodes are kept.
+*/
+inline void AABBTree::reserveNodes(unsigned int n)
     {
     // grow the memory if needed
-    if (m_num_nodes >= m_node_capacity)
+    if (n > m_node_capacity)
         {
         // determine new capacity
         AABBNode *m_new_nodes = NULL;
-        unsigned int m_new_node_capacity = m_node_capacity*2;
-        if (m_new_node_capacity == 0)
+        unsigned int m_new_node_capacity = std::max(m_node_capacity*2, n);
+        if (m_new_node_capacity < 16)
             m_new_node_capacity = 16;
 
         // allocate new memory
@@ -603,10 +1173,6 @@ inline unsigned int AABBTree::allocateNode()
         m_nodes = m_new_nodes;
         m_node_capacity = m_new_node_capacity;
         }
-
-    m_nodes[m_num_nodes] = AABBNode();
-    m_num_nodes++;
-    return m_num_nodes-1;
     }
 
 // end group overlap
@@ -14,6 +14,8 @@
 
 #include <pybind11/numpy.h>
 
+#include <algorithm>
+
 #ifdef ENABLE_HIP
 #include "BondedGroupData.cuh"
 #include "CachedAllocator.h"
@@ -286,6 +288,196 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::initializeFromS
         }
     }
 
+#ifdef ENABLE_MPI
+//! Initialize from a distributed snapshot
+/*! \param snapshot The slice of the groups held by this rank
+    \param ptl_owners Where ParticleData::initializeFromDistributedSnapshot() sent the particles
+
+    The slices are tagged in rank order. Every group is first sent to the ranks that held its member particles in the
+    particle snapshot, which then forward it to the ranks that now own these particles. A rank keeps the groups that
+    have at least one local member, like addBondedGroup() does.
+ */
+template<unsigned int group_size, typename Group, const char *name, bool has_type_mapping>
+void BondedGroupData<group_size, Group, name, has_type_mapping>::initializeFromDistributedSnapshot(
+    const Snapshot& snapshot, const SnapshotParticleOwners& ptl_owners)
+    {
+    const MPI_Comm mpi_comm = m_exec_conf->getMPICommunicator();
+    unsigned int n_ranks = m_exec_conf->getNRanks();
+    unsigned int my_rank = m_exec_conf->getRank();
+
+    assert(ptl_owners.tag_offset.size() == n_ranks+1);
+    unsigned int n_ptls = ptl_owners.tag_offset[n_ranks];
+
+    // check the input for errors, every rank checks its own slice
+    unsigned int n_invalid = 0;
+    if (! snapshot.validate())
+        {
+        m_exec_conf->msg->errorAllRanks() << "init.*: invalid " << name << " data snapshot." << std::endl;
+        n_invalid++;
+        }
+
+    for (unsigned int group_idx = 0; group_idx < snapshot.groups.size() && ! n_invalid; ++group_idx)
+        {
+        const members_t& members = snapshot.groups[group_idx];
+        for (unsigned int i = 0; i < group_size; ++i)
+            {
+            bool duplicate = false;
+            for (unsigned int j = 0; j < i; ++j)
+                duplicate |= members.tag[i] == members.tag[j];
+
+            if (members.tag[i] >= n_ptls || duplicate)
+                {
+                m_exec_conf->msg->errorAllRanks() << name << ".*: Invalid particle tags in " << name << " "
+                    << group_idx << " of the snapshot" << std::endl;
+                n_invalid++;
+                break;
+                }
+            }
+
+        if (has_type_mapping && snapshot.type_id[group_idx] >= snapshot.type_mapping.size())
+            {
+            m_exec_conf->msg->errorAllRanks() << name << ".*: Invalid " << name << " type "
+                << snapshot.type_id[group_idx] << "! The number of types is " << snapshot.type_mapping.size()
+                << std::endl;
+            n_invalid++;
+            }
+        }
+
+    // all ranks throw together
+    MPI_Allreduce(MPI_IN_PLACE, &n_invalid, 1, MPI_UNSIGNED, MPI_SUM, mpi_comm);
+    if (n_invalid)
+        {
+        throw std::runtime_error(std::string("Error initializing ") + name + std::string(" data."));
+        }
+
+    // re-initialize data structures
+    initialize();
+
+    m_type_mapping = snapshot.type_mapping;
+
+    // the slices are tagged in rank order
+    unsigned int n_slice = snapshot.groups.size();
+    std::vector<unsigned int> slice_sizes;
+    all_gather_v(n_slice, slice_sizes, mpi_comm);
+
+    unsigned int tag_offset = 0;
+    unsigned int nglobal = 0;
+    for (unsigned int rank = 0; rank < n_ranks; ++rank)
+        {
+        if (rank == my_rank)
+            tag_offset = nglobal;
+        nglobal += slice_sizes[rank];
+        }
+
+    // send every group to the ranks that read its member particles
+    std::vector< std::vector<packed_t> > send_groups(n_ranks);
+    for (unsigned int group_idx = 0; group_idx < n_slice; ++group_idx)
+        {
+        packed_t g;
+        g.tags = snapshot.groups[group_idx];
+        if (has_type_mapping)
+            g.typeval.type = snapshot.type_id[group_idx];
+        else
+            g.typeval.val = snapshot.val[group_idx];
+        g.group_tag = tag_offset + group_idx;
+        for (unsigned int i = 0; i < group_size; ++i)
+            g.ranks.idx[i] = 0;
+
+        unsigned int dest[group_size];
+        unsigned int n_dest = 0;
+        for (unsigned int i = 0; i < group_size; ++i)
+            {
+            // the last slice that starts at or before the tag holds it, skipping empty slices
+            unsigned int rank = std::upper_bound(ptl_owners.tag_offset.begin(), ptl_owners.tag_offset.end(),
+                g.tags.tag[i]) - ptl_owners.tag_offset.begin() - 1;
+
+            if (std::find(dest, dest + n_dest, rank) == dest + n_dest)
+                {
+                dest[n_dest++] = rank;
+                send_groups[rank].push_back(g);
+                }
+            }
+        }
+
+    std::vector<packed_t> recv_groups;
+    all_to_all_v(send_groups, recv_groups, mpi_comm);
+
+    // forward the groups to the ranks that own the member particles of the local slice
+    for (unsigned int rank = 0; rank < n_ranks; ++rank)
+        send_groups[rank].clear();
+
+    unsigned int ptl_begin = ptl_owners.tag_offset[my_rank];
+    unsigned int ptl_end = ptl_owners.tag_offset[my_rank+1];
+    for (typename std::vector<packed_t>::const_iterator it = recv_groups.begin(); it != recv_groups.end(); ++it)
+        {
+        unsigned int dest[group_size];
+        unsigned int n_dest = 0;
+        for (unsigned int i = 0; i < group_size; ++i)
+            {
+            unsigned int tag = it->tags.tag[i];
+            if (tag < ptl_begin || tag >= ptl_end)
+                continue;
+
+            unsigned int rank = ptl_owners.owner[tag - ptl_begin];
+            if (std::find(dest, dest + n_dest, rank) == dest + n_dest)
+                {
+                dest[n_dest++] = rank;
+                send_groups[rank].push_back(*it);
+                }
+            }
+        }
+
+    all_to_all_v(send_groups, recv_groups, mpi_comm);
+    std::vector< std::vector<packed_t> >().swap(send_groups);
+
+    // groups with members from several slices arrive more than once
+    std::sort(recv_groups.begin(), recv_groups.end(),
+        [](const packed_t& a, const packed_t& b) { return a.group_tag < b.group_tag; });
+    recv_groups.erase(std::unique(recv_groups.begin(), recv_groups.end(),
+        [](const packed_t& a, const packed_t& b) { return a.group_tag == b.group_tag; }), recv_groups.end());
+
+    // store the local groups
+    unsigned int n_local = recv_groups.size();
+    m_groups.resize(n_local);
+    m_group_typeval.resize(n_local);
+    m_group_tag.resize(n_local);
+    m_group_ranks.resize(n_local);
+    m_group_rtag.resize(nglobal);
+
+        {
+        ArrayHandle<members_t> h_groups(m_groups, access_location::host, access_mode::overwrite);
+        ArrayHandle<typeval_t> h_typeval(m_group_typeval, access_location::host, access_mode::overwrite);
+        ArrayHandle<unsigned int> h_group_tag(m_group_tag, access_location::host, access_mode::overwrite);
+        ArrayHandle<ranks_t> h_group_ranks(m_group_ranks, access_location::host, access_mode::overwrite);
+        ArrayHandle<unsigned int> h_group_rtag(m_group_rtag, access_location::host, access_mode::overwrite);
+
+        std::fill(h_group_rtag.data, h_group_rtag.data + nglobal, GROUP_NOT_LOCAL);
+
+        for (unsigned int group_idx = 0; group_idx < n_local; ++group_idx)
+            {
+            const packed_t& g = recv_groups[group_idx];
+            h_groups.data[group_idx] = g.tags;
+            h_typeval.data[group_idx] = g.typeval;
+            h_group_tag.data[group_idx] = g.group_tag;
+            h_group_ranks.data[group_idx] = g.ranks;
+            h_group_rtag.data[g.group_tag] = group_idx;
+            }
+        }
+
+    // update list of active tags
+    for (unsigned int tag = 0; tag < nglobal; ++tag)
+        m_tag_set.insert(m_tag_set.end(), tag);
+    m_invalid_cached_tags = true;
+
+    m_n_groups = n_local;
+    m_nglobal = nglobal;
+
+    // notify observers
+    m_group_num_change_signal.emit();
+    notifyGroupReorder();
+    }
+#endif
+
 template<unsigned int group_size, typename Group, const char *name, bool has_type_mapping>
 unsigned int BondedGroupData<group_size, Group, name, has_type_mapping>::addBondedGroup(Group g)
     {
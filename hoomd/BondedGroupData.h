@@ -252,6 +252,11 @@ class BondedGroupData
         //! Initialize from a snapshot
         virtual void initializeFromSnapshot(const Snapshot& snapshot);
 
+        #ifdef ENABLE_MPI
+        //! Initialize from snapshots that hold a slice of the groups on every rank
+        void initializeFromDistributedSnapshot(const Snapshot& snapshot, const SnapshotParticleOwners& ptl_owners);
+        #endif
+
         //! Take a snapshot
         virtual std::map<unsigned int, unsigned int> takeSnapshot(Snapshot& snapshot) const;
 
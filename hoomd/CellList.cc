@@ -13,6 +13,11 @@
 
 #include <algorithm>
 
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
+
 using namespace std;
 namespace py = pybind11;
 
@@ -22,7 +27,7 @@ namespace py = pybind11;
 CellList::CellList(std::shared_ptr<SystemDefinition> sysdef)
     : Compute(sysdef),  m_nominal_width(Scalar(1.0)), m_radius(1), m_compute_xyzf(true), m_compute_tdb(false),
       m_compute_orientation(false), m_compute_idx(false), m_flag_charge(false), m_flag_type(false), m_sort_cell_list(false),
-      m_compute_adj_list(true)
+      m_compute_adj_list(true), m_compact(false)
     {
     m_exec_conf->msg->notice(5) << "Constructing CellList" << endl;
 
@@ -282,6 +287,25 @@ void CellList::initializeMemory()
     m_cell_size.swap(cell_size);
     TAG_ALLOCATION(m_cell_size);
 
+    // in the compact layout, the member arrays hold one entry per particle instead of Nmax per cell
+    unsigned int n_members = m_cell_list_indexer.getNumElements();
+    if (m_compact)
+        {
+        GlobalArray<unsigned int> cell_start(m_cell_indexer.getNumElements()+1, m_exec_conf);
+        m_cell_start.swap(cell_start);
+        TAG_ALLOCATION(m_cell_start);
+
+        n_members = m_pdata->getN() + m_pdata->getNGhosts();
+        if (n_members == 0)
+            n_members = 1;
+        }
+    else
+        {
+        // array is not needed, discard it
+        GlobalArray<unsigned int> cell_start;
+        m_cell_start.swap(cell_start);
+        }
+
     if (m_compute_adj_list)
         {
         // if we have less than radius*2+1 cells in a direction, restrict to unique neighbors
@@ -313,7 +337,7 @@ void CellList::initializeMemory()
 
     if (m_compute_xyzf)
         {
-        GlobalArray<Scalar4> xyzf(m_cell_list_indexer.getNumElements(), m_exec_conf);
+        GlobalArray<Scalar4> xyzf(n_members, m_exec_conf);
         m_xyzf.swap(xyzf);
         TAG_ALLOCATION(m_xyzf);
         }
@@ -325,7 +349,7 @@ void CellList::initializeMemory()
 
     if (m_compute_tdb)
         {
-        GlobalArray<Scalar4> tdb(m_cell_list_indexer.getNumElements(), m_exec_conf);
+        GlobalArray<Scalar4> tdb(n_members, m_exec_conf);
         m_tdb.swap(tdb);
         TAG_ALLOCATION(m_tdb);
         }
@@ -338,7 +362,7 @@ void CellList::initializeMemory()
 
     if (m_compute_orientation)
         {
-        GlobalArray<Scalar4> orientation(m_cell_list_indexer.getNumElements(), m_exec_conf);
+        GlobalArray<Scalar4> orientation(n_members, m_exec_conf);
         m_orientation.swap(orientation);
         TAG_ALLOCATION(m_orientation);
         }
@@ -351,7 +375,7 @@ void CellList::initializeMemory()
 
     if (m_compute_idx || m_sort_cell_list)
         {
-        GlobalArray<unsigned int> idx(m_cell_list_indexer.getNumElements(), m_exec_conf);
+        GlobalArray<unsigned int> idx(n_members, m_exec_conf);
         m_idx.swap(idx);
         TAG_ALLOCATION(m_idx);
         }
@@ -435,8 +459,77 @@ void CellList::initializeCellAdj()
         m_prof->pop();
     }
 
+/*! \param n Index of the particle
+    \param postype Position and type of the particle
+    \param box Local box
+    \param ghost_width Width of the ghost layer
+    \param conditions Condition flags to set when the particle cannot be binned
+    \returns The cell index of the particle, or 0xffffffff if it does not belong in any cell
+*/
+unsigned int CellList::findCell(unsigned int n,
+                                const Scalar4& postype,
+                                const BoxDim& box,
+                                const Scalar3& ghost_width,
+                                uint3& conditions) const
+    {
+    Scalar3 p = make_scalar3(postype.x, postype.y, postype.z);
+    if (std::isnan(p.x) || std::isnan(p.y) || std::isnan(p.z))
+        {
+        conditions.y = n+1;
+        return 0xffffffff;
+        }
+
+    // find the bin each particle belongs in
+    Scalar3 f = box.makeFraction(p,ghost_width);
+    int ib = (int)(f.x * m_dim.x);
+    int jb = (int)(f.y * m_dim.y);
+    int kb = (int)(f.z * m_dim.z);
+
+    // check if the particle is inside the unit cell + ghost layer in all dimensions
+    if ((f.x < Scalar(-0.00001) || f.x >= Scalar(1.00001)) ||
+        (f.y < Scalar(-0.00001) || f.y >= Scalar(1.00001)) ||
+        (f.z < Scalar(-0.00001) || f.z >= Scalar(1.00001)) )
+        {
+        // if a ghost particle is out of bounds, silently ignore it
+        if (n < m_pdata->getN())
+            conditions.z = n+1;
+        return 0xffffffff;
+        }
+
+    // need to handle the case where the particle is exactly at the box hi
+    uchar3 periodic = box.getPeriodic();
+    if (ib == (int)m_dim.x && periodic.x)
+        ib = 0;
+    if (jb == (int)m_dim.y && periodic.y)
+        jb = 0;
+    if (kb == (int)m_dim.z && periodic.z)
+        kb = 0;
+
+    // sanity check
+    assert((ib < (int)(m_dim.x) && jb < (int)(m_dim.y) && kb < (int)(m_dim.z)) || n>=m_pdata->getN());
+
+    // all particles should be in a valid cell
+    if (ib < 0 || ib >= (int)m_dim.x ||
+        jb < 0 || jb >= (int)m_dim.y ||
+        kb < 0 || kb >= (int)m_dim.z)
+        {
+        // but ghost particles that are out of range should not produce an error
+        if (n < m_pdata->getN())
+            conditions.z = n+1;
+        return 0xffffffff;
+        }
+
+    return m_cell_indexer(ib, jb, kb);
+    }
+
 void CellList::computeCellList()
     {
+    if (m_compact)
+        {
+        computeCellListCompact();
+        return;
+        }
+
     if (m_prof)
         m_prof->push("compute");
 
@@ -457,7 +550,6 @@ void CellList::computeCellList()
     uint3 conditions = make_uint3(0,0,0);
 
     // shorthand copies of the indexers
-    Index3D ci = m_cell_indexer;
     Index2D cli = m_cell_list_indexer;
 
     // clear the bin sizes to 0
@@ -465,63 +557,15 @@ void CellList::computeCellList()
 
     Scalar3 ghost_width = getGhostWidth();
 
-    // get periodic flags
-    uchar3 periodic = box.getPeriodic();
-
     // for each particle
     unsigned n_tot_particles = m_pdata->getN() + m_pdata->getNGhosts();
 
     for (unsigned int n = 0; n < n_tot_particles; n++)
         {
-        Scalar3 p = make_scalar3(h_pos.data[n].x, h_pos.data[n].y, h_pos.data[n].z);
-        if (std::isnan(p.x) || std::isnan(p.y) || std::isnan(p.z))
-            {
-            conditions.y = n+1;
-            continue;
-            }
-
-
         // find the bin each particle belongs in
-        Scalar3 f = box.makeFraction(p,ghost_width);
-        int ib = (int)(f.x * m_dim.x);
-        int jb = (int)(f.y * m_dim.y);
-        int kb = (int)(f.z * m_dim.z);
-
-        // check if the particle is inside the unit cell + ghost layer in all dimensions
-        if ((f.x < Scalar(-0.00001) || f.x >= Scalar(1.00001)) ||
-            (f.y < Scalar(-0.00001) || f.y >= Scalar(1.00001)) ||
-            (f.z < Scalar(-0.00001) || f.z >= Scalar(1.00001)) )
-            {
-            // if a ghost particle is out of bounds, silently ignore it
-            if (n < m_pdata->getN())
-                conditions.z = n+1;
-            continue;
-            }
-
-        // need to handle the case where the particle is exactly at the box hi
-        if (ib == (int)m_dim.x && periodic.x)
-            ib = 0;
-        if (jb == (int)m_dim.y && periodic.y)
-            jb = 0;
-        if (kb == (int)m_dim.z && periodic.z)
-            kb = 0;
-
-        // sanity check
-        assert((ib < (int)(m_dim.x) && jb < (int)(m_dim.y) && kb < (int)(m_dim.z)) || n>=m_pdata->getN());
-
-        // record its bin
-        unsigned int bin = ci(ib, jb, kb);
-
-        // all particles should be in a valid cell
-        if (ib < 0 || ib >= (int)m_dim.x ||
-            jb < 0 || jb >= (int)m_dim.y ||
-            kb < 0 || kb >= (int)m_dim.z)
-            {
-            // but ghost particles that are out of range should not produce an error
-            if (n < m_pdata->getN())
-                conditions.z = n+1;
+        unsigned int bin = findCell(n, h_pos.data[n], box, ghost_width, conditions);
+        if (bin == 0xffffffff)
             continue;
-            }
 
         // setup the flag value to store
         Scalar flag;
@@ -579,6 +623,206 @@ void CellList::computeCellList()
         m_prof->pop();
     }
 
+/*! The compact layout is built with a counting sort in three passes:
+     1. Each particle is binned, and the occupancy of each cell is counted separately for each block of particles.
+     2. The counts are summed and prefix summed into m_cell_start, and the block counts are replaced by the offset at
+        which each block starts writing into each cell.
+     3. Each block scatters its particles into place.
+
+    Blocks are processed in parallel when TBB is enabled. Because the blocks are contiguous ranges of particles and
+    are ordered within each cell, the members of a cell are in particle index order independent of the number of
+    threads. The number of blocks is limited so that the per block counts do not take up more memory than a few
+    entries per particle.
+*/
+void CellList::computeCellListCompact()
+    {
+    if (m_prof)
+        m_prof->push("compute");
+
+    const unsigned int n_tot_particles = m_pdata->getN() + m_pdata->getNGhosts();
+    const unsigned int n_cells = m_cell_indexer.getNumElements();
+
+    // grow the member arrays when the number of particles (including ghosts) has increased
+    if (m_compute_xyzf && m_xyzf.getNumElements() < n_tot_particles)
+        m_xyzf.resize(n_tot_particles);
+    if (m_compute_tdb && m_tdb.getNumElements() < n_tot_particles)
+        m_tdb.resize(n_tot_particles);
+    if (m_compute_orientation && m_orientation.getNumElements() < n_tot_particles)
+        m_orientation.resize(n_tot_particles);
+    if ((m_compute_idx || m_sort_cell_list) && m_idx.getNumElements() < n_tot_particles)
+        m_idx.resize(n_tot_particles);
+
+    // acquire the particle data
+    ArrayHandle< Scalar4 > h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle< Scalar4 > h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+    ArrayHandle< Scalar > h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
+    ArrayHandle< unsigned int > h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
+    ArrayHandle< Scalar > h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
+    const BoxDim& box = m_pdata->getBox();
+
+    // access the cell list data arrays
+    ArrayHandle<unsigned int> h_cell_size(m_cell_size, access_location::host, access_mode::overwrite);
+    ArrayHandle<unsigned int> h_cell_start(m_cell_start, access_location::host, access_mode::overwrite);
+    ArrayHandle<Scalar4> h_xyzf(m_xyzf, access_location::host, access_mode::overwrite);
+    ArrayHandle<Scalar4> h_cell_orientation(m_orientation, access_location::host, access_mode::overwrite);
+    ArrayHandle<unsigned int> h_cell_idx(m_idx, access_location::host, access_mode::overwrite);
+    ArrayHandle<Scalar4> h_tdb(m_tdb, access_location::host, access_mode::overwrite);
+
+    Scalar3 ghost_width = getGhostWidth();
+
+    // split the particles into blocks
+    unsigned int n_blocks = 1;
+    #ifdef ENABLE_TBB
+    n_blocks = std::max(m_exec_conf->getNumThreads(), 1u);
+    n_blocks = std::min(n_blocks, std::max(4*n_tot_particles/std::max(n_cells,1u), 1u));
+    #endif
+    auto block_begin = [n_tot_particles, n_blocks](unsigned int b)
+        { return (unsigned int)(((size_t)n_tot_particles*b)/n_blocks); };
+
+    m_particle_cell.resize(n_tot_particles);
+    m_block_count.assign((size_t)n_blocks*n_cells, 0);
+    std::vector<uint3> block_conditions(n_blocks, make_uint3(0,0,0));
+
+    // pass 1: bin and count the particles
+    auto count_block = [&](unsigned int b)
+        {
+        unsigned int *count = &m_block_count[(size_t)b*n_cells];
+        for (unsigned int n = block_begin(b); n < block_begin(b+1); ++n)
+            {
+            unsigned int bin = findCell(n, h_pos.data[n], box, ghost_width, block_conditions[b]);
+            m_particle_cell[n] = bin;
+            if (bin != 0xffffffff)
+                ++count[bin];
+            }
+        };
+
+    // pass 2b: turn the per block counts into per block offsets
+    auto offset_cells = [&](unsigned int first, unsigned int last)
+        {
+        for (unsigned int cell = first; cell < last; ++cell)
+            {
+            unsigned int offset = h_cell_start.data[cell];
+            for (unsigned int b = 0; b < n_blocks; ++b)
+                {
+                unsigned int count = m_block_count[(size_t)b*n_cells + cell];
+                m_block_count[(size_t)b*n_cells + cell] = offset;
+                offset += count;
+                }
+            }
+        };
+
+    // pass 3: scatter the particles into their cells
+    auto scatter_block = [&](unsigned int b)
+        {
+        unsigned int *offset = &m_block_count[(size_t)b*n_cells];
+        for (unsigned int n = block_begin(b); n < block_begin(b+1); ++n)
+            {
+            unsigned int bin = m_particle_cell[n];
+            if (bin == 0xffffffff)
+                continue;
+
+            unsigned int k = offset[bin]++;
+
+            // setup the flag value to store
+            Scalar flag;
+            if (m_flag_charge)
+                flag = h_charge.data[n];
+            else if (m_flag_type)
+                flag = h_pos.data[n].w;
+            else
+                flag = __int_as_scalar(n);
+
+            if (m_compute_xyzf)
+                h_xyzf.data[k] = make_scalar4(h_pos.data[n].x, h_pos.data[n].y, h_pos.data[n].z, flag);
+
+            if (m_compute_tdb)
+                h_tdb.data[k] = make_scalar4(h_pos.data[n].w,
+                                             h_diameter.data[n],
+                                             __int_as_scalar(h_body.data[n]),
+                                             Scalar(0.0));
+
+            if (m_compute_orientation)
+                h_cell_orientation.data[k] = h_orientation.data[n];
+
+            if (m_compute_idx)
+                h_cell_idx.data[k] = n;
+            }
+        };
+
+    #ifdef ENABLE_TBB
+    if (n_blocks > 1)
+        {
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_blocks, 1),
+            [&](const tbb::blocked_range<unsigned int>& r)
+            {
+            for (unsigned int b = r.begin(); b != r.end(); ++b)
+                count_block(b);
+            });
+        }
+    else
+    #endif
+        {
+        count_block(0);
+        }
+
+    // pass 2a: cell sizes and the exclusive prefix sum over the cells
+    unsigned int max_size = 0;
+    h_cell_start.data[0] = 0;
+    for (unsigned int cell = 0; cell < n_cells; ++cell)
+        {
+        unsigned int size = 0;
+        for (unsigned int b = 0; b < n_blocks; ++b)
+            size += m_block_count[(size_t)b*n_cells + cell];
+
+        h_cell_size.data[cell] = size;
+        h_cell_start.data[cell+1] = h_cell_start.data[cell] + size;
+        max_size = std::max(max_size, size);
+        }
+
+    #ifdef ENABLE_TBB
+    if (n_blocks > 1)
+        {
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_cells),
+            [&](const tbb::blocked_range<unsigned int>& r)
+            {
+            offset_cells(r.begin(), r.end());
+            });
+
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_blocks, 1),
+            [&](const tbb::blocked_range<unsigned int>& r)
+            {
+            for (unsigned int b = r.begin(); b != r.end(); ++b)
+                scatter_block(b);
+            });
+        }
+    else
+    #endif
+        {
+        offset_cells(0, n_cells);
+        scatter_block(0);
+        }
+
+    // there are no overflows in the compact layout, Nmax only reports the fullest cell
+    m_Nmax = std::max(max_size, 1u);
+    m_cell_list_indexer = Index2D(m_Nmax, n_cells);
+
+    uint3 conditions = make_uint3(0,0,0);
+    for (unsigned int b = 0; b < n_blocks; ++b)
+        {
+        conditions.y = std::max(conditions.y, block_conditions[b].y);
+        conditions.z = std::max(conditions.z, block_conditions[b].z);
+        }
+
+        {
+        // write out conditions
+        ArrayHandle<uint3> h_conditions(m_conditions, access_location::host, access_mode::overwrite);
+        *h_conditions.data = conditions;
+        }
+
+    if (m_prof)
+        m_prof->pop();
+    }
+
 bool CellList::checkConditions()
     {
     bool result = false;
@@ -652,6 +896,8 @@ void export_CellList(py::module& m)
         .def("setFlagCharge", &CellList::setFlagCharge)
         .def("setFlagIndex", &CellList::setFlagIndex)
         .def("setSortCellList", &CellList::setSortCellList)
+        .def("setCompact", &CellList::setCompact)
+        .def("getCompact", &CellList::getCompact)
         .def("getDim", &CellList::getDim, py::return_value_policy::reference_internal)
         .def("getNmax", &CellList::getNmax)
         .def("benchmark", &CellList::benchmark)
@@ -11,6 +11,7 @@
 #include "Compute.h"
 
 #include <memory>
+#include <vector>
 #include <hoomd/extern/nano-signal-slot/nano_signal_slot.hpp>
 
 /*! \file CellList.h
@@ -26,6 +27,39 @@
 #ifndef __CELLLIST_H__
 #define __CELLLIST_H__
 
+//! Indexes the members of the cells in either storage layout of CellList
+/*! Host code reading the xyzf, tdb, orientation or idx arrays of a CellList should index them through this class
+    instead of the Index2D returned by getCellListIndexer(), so that it works with both the padded and the compact
+    layout.
+    \code
+    ArrayHandle<unsigned int> h_cell_start(cl->getCellStartArray(), access_location::host, access_mode::read);
+    CellListMemberIndexer cli(cl->getCellListIndexer(), cl->getCompact() ? h_cell_start.data : NULL);
+    xyzf = h_xyzf.data[cli(offset, cidx)];
+    \endcode
+*/
+class CellListMemberIndexer
+    {
+    public:
+        //! Construct an indexer
+        /*! \param cli Indexer for the padded layout
+            \param cell_start Start of each cell in the compact layout, NULL for the padded layout
+        */
+        CellListMemberIndexer(const Index2D& cli, const unsigned int *cell_start)
+            : m_cli(cli), m_cell_start(cell_start)
+            {
+            }
+
+        //! Get the index of member \a offset of cell \a cidx
+        inline unsigned int operator()(unsigned int offset, unsigned int cidx) const
+            {
+            return m_cell_start ? m_cell_start[cidx] + offset : m_cli(offset, cidx);
+            }
+
+    private:
+        Index2D m_cli;                      //!< Indexer for the padded layout
+        const unsigned int *m_cell_start;   //!< Start of each cell in the compact layout
+    };
+
 //! Computes a cell list from the particles in the system
 /*! \b Overview:
     Cell lists are useful data structures when working with locality queries on particles. The most notable usage of
@@ -75,6 +109,18 @@
      - <code>cell_adj[cell_adj_indexer(offset,cidx)]</code> is the cell index for neighboring cell \c offset to \c cidx.
        \c offset can vary from 0 to (radius*2+1)^3-1 (typically 26 with radius 1)
 
+    <b>Compact layout:</b>
+
+    The padded layout above reserves Nmax slots for every cell, where Nmax is the occupancy of the fullest cell. In
+    inhomogeneous systems this wastes memory, and every time a cell overflows the arrays are reallocated and the cell
+    list is recomputed. With setCompact(true), the CPU implementation instead stores the members of all cells back to
+    back (a compressed sparse row layout). The \c cell_start array (length Ncells+1) gives the first member of each
+    cell, and the members of cell \c cidx are at <code>cell_start[cidx]</code> to
+    <code>cell_start[cidx]+cell_size[cidx]-1</code>. The compact layout is built with a counting sort: each particle
+    is binned and counted, the counts are prefix summed into \c cell_start, and the particles are scattered into place.
+    The members of each cell are in particle index order, just like in the padded layout. Use CellListMemberIndexer
+    to index either layout. getNmax() returns the occupancy of the fullest cell in the compact layout.
+
     <b>Parameters:</b>
      - \c width - minimum width of a cell in any x,y,z direction
      - \c radius - integer radius of cells to generate in \c cell_adj (1,2,3,4,...)
@@ -206,6 +252,19 @@ class PYBIND11_EXPORT CellList : public Compute
             return m_sort_cell_list;
             }
 
+        //! Set the flag to use the compact storage layout
+        virtual void setCompact(bool compact)
+            {
+            m_compact = compact;
+            m_params_changed = true;
+            }
+
+        //! Get whether the cell list uses the compact storage layout
+        bool getCompact() const
+            {
+            return m_compact;
+            }
+
         //! Set the flag to compute the cell adjacency list
         void setComputeAdjList(bool compute_adj_list)
             {
@@ -294,6 +353,12 @@ class PYBIND11_EXPORT CellList : public Compute
             throw std::runtime_error("Per-device cell size array not available in base class.\n");
             }
 
+        //! Get the first member of each cell in the compact layout
+        const GlobalArray<unsigned int>& getCellStartArray() const
+            {
+            return m_cell_start;
+            }
+
         //! Get the adjacency list
         const GlobalArray<unsigned int>& getCellAdjArray() const
             {
@@ -383,6 +448,7 @@ class PYBIND11_EXPORT CellList : public Compute
 
         // values computed by compute()
         GlobalArray<unsigned int> m_cell_size;  //!< Number of members in each cell
+        GlobalArray<unsigned int> m_cell_start; //!< First member of each cell (compact layout only)
         GlobalArray<unsigned int> m_cell_adj;   //!< Cell adjacency list
         GlobalArray<Scalar4> m_xyzf;            //!< Cell list with position and flags
         GlobalArray<Scalar4> m_tdb;             //!< Cell list with type,diameter,body
@@ -392,6 +458,10 @@ class PYBIND11_EXPORT CellList : public Compute
 
         bool m_sort_cell_list;               //!< If true, sort cell list
         bool m_compute_adj_list;            //!< If true, compute the cell adjacency lists
+        bool m_compact;                     //!< If true, use the compact storage layout
+
+        std::vector<unsigned int> m_particle_cell;  //!< Cell of each particle (compact layout only)
+        std::vector<unsigned int> m_block_count;    //!< Per block cell occupancy/offsets (compact layout only)
 
         //! Computes what the dimensions should me
         uint3 computeDimensions();
@@ -411,6 +481,16 @@ class PYBIND11_EXPORT CellList : public Compute
         //! Compute the cell list
         virtual void computeCellList();
 
+        //! Compute the cell list in the compact layout
+        void computeCellListCompact();
+
+        //! Find the cell that a particle belongs in
+        unsigned int findCell(unsigned int n,
+                              const Scalar4& postype,
+                              const BoxDim& box,
+                              const Scalar3& ghost_width,
+                              uint3& conditions) const;
+
         //! Check the status of the conditions
         bool checkConditions();
 
@@ -60,6 +60,13 @@ class PYBIND11_EXPORT CellListGPU : public CellList
             return m_per_device;
             }
 
+        //! The compact layout is only implemented on the CPU
+        virtual void setCompact(bool compact)
+            {
+            if (compact)
+                throw std::runtime_error("The compact cell list layout is not supported on the GPU.");
+            }
+
 
         //! Get the cell list containing index (per device)
         virtual const GlobalArray<unsigned int>& getIndexArrayPerDevice() const
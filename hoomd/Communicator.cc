@@ -23,6 +23,15 @@ namespace py = pybind11;
 
 #include <vector>
 
+//! Route of a local particle, routes are numbered like the 27 neighbor directions (see initializeNeighborArrays())
+static const unsigned int ghost_route_self = 13;
+
+//! Change of the route of a ghost that is sent across each of the six faces
+static const int ghost_route_step[6] = {1, -1, 3, -3, 9, -9};
+
+//! MPI tag of the single stage ghost update message for route 0
+static const int direct_ghost_tag = 64;
+
 template<class group_data>
 Communicator::GroupCommunicator<group_data>::GroupCommunicator(Communicator& comm, std::shared_ptr<group_data> gdata)
     : m_comm(comm), m_exec_conf(comm.m_exec_conf), m_gdata(gdata)
@@ -1078,6 +1087,7 @@ Communicator::Communicator(std::shared_ptr<SystemDefinition> sysdef,
             m_nettorque_copybuf(m_exec_conf),
             m_netvirial_copybuf(m_exec_conf),
             m_netvirial_recvbuf(m_exec_conf),
+            m_ghost_field_copybuf(m_exec_conf),
             m_plan(m_exec_conf),
             m_plan_reverse(m_exec_conf),
             m_tag_reverse(m_exec_conf),
@@ -1089,6 +1099,13 @@ Communicator::Communicator(std::shared_ptr<SystemDefinition> sysdef,
             m_has_ghost_particles(false),
             m_last_flags(0),
             m_comm_pending(false),
+            m_work_time(0),
+            m_ghost_overlap(false),
+            m_ghost_update_dir(0),
+            m_ghost_update_offset(0),
+            m_single_stage(false),
+            m_direct_ghosts_valid(false),
+            m_direct_fields(0),
             m_bond_comm(*this, m_sysdef->getBondData()),
             m_angle_comm(*this, m_sysdef->getAngleData()),
             m_dihedral_comm(*this, m_sysdef->getDihedralData()),
@@ -1131,6 +1148,12 @@ Communicator::Communicator(std::shared_ptr<SystemDefinition> sysdef,
         m_num_recv_forward_ghosts_reverse[dir] = 0;
         }
 
+    for (unsigned int dir = 0; dir <= NEIGH_MAX; ++dir)
+        {
+        m_direct_send_begin[dir] = 0;
+        m_direct_recv_begin[dir] = 0;
+        }
+
     // connect to particle sort signal
     m_pdata->getParticleSortSignal().connect<Communicator, &Communicator::forceMigrate>(this);
 
@@ -1188,12 +1211,12 @@ Communicator::Communicator(std::shared_ptr<SystemDefinition> sysdef,
     initializeNeighborArrays();
 
     /* create a type for pdata_element */
-    const int nitems=14;
-    int blocklengths[14] = {4,4,3,1,1,3,1,4,4,3,1,4,4,6};
-    MPI_Datatype types[14] = {MPI_HOOMD_SCALAR, MPI_HOOMD_SCALAR, MPI_HOOMD_SCALAR, MPI_HOOMD_SCALAR,
+    const int nitems=15;
+    int blocklengths[15] = {4,4,3,1,1,3,1,4,4,3,1,1,4,4,6};
+    MPI_Datatype types[15] = {MPI_HOOMD_SCALAR, MPI_HOOMD_SCALAR, MPI_HOOMD_SCALAR, MPI_HOOMD_SCALAR,
         MPI_HOOMD_SCALAR, MPI_INT, MPI_UNSIGNED, MPI_HOOMD_SCALAR, MPI_HOOMD_SCALAR, MPI_HOOMD_SCALAR,
-        MPI_UNSIGNED, MPI_HOOMD_SCALAR, MPI_HOOMD_SCALAR, MPI_HOOMD_SCALAR};
-    MPI_Aint offsets[14];
+        MPI_UNSIGNED, MPI_UNSIGNED, MPI_HOOMD_SCALAR, MPI_HOOMD_SCALAR, MPI_HOOMD_SCALAR};
+    MPI_Aint offsets[15];
 
     offsets[0] = offsetof(pdata_element, pos);
     offsets[1] = offsetof(pdata_element, vel);
@@ -1206,9 +1229,10 @@ Communicator::Communicator(std::shared_ptr<SystemDefinition> sysdef,
     offsets[8] = offsetof(pdata_element, angmom);
     offsets[9] = offsetof(pdata_element, inertia);
     offsets[10] = offsetof(pdata_element, tag);
-    offsets[11] = offsetof(pdata_element, net_force);
-    offsets[12] = offsetof(pdata_element, net_torque);
-    offsets[13] = offsetof(pdata_element, net_virial);
+    offsets[11] = offsetof(pdata_element, group_flags);
+    offsets[12] = offsetof(pdata_element, net_force);
+    offsets[13] = offsetof(pdata_element, net_torque);
+    offsets[14] = offsetof(pdata_element, net_virial);
 
     MPI_Datatype tmp;
     MPI_Type_create_struct(nitems, blocklengths, offsets, types, &tmp);
@@ -1234,6 +1258,8 @@ Communicator::~Communicator()
     m_sysdef->getConstraintData()->getGroupNumChangeSignal().disconnect<Communicator, &Communicator::setConstraintsChanged>(this);
     m_sysdef->getPairData()->getGroupNumChangeSignal().disconnect<Communicator, &Communicator::setPairsChanged>(this);
 
+    freeDirectGhostRequests();
+
     MPI_Type_free(&m_mpi_pdata_element);
     }
 
@@ -1252,6 +1278,10 @@ void Communicator::initializeNeighborArrays()
 
     m_nneigh = 0;
 
+    // directions along which we do not communicate map onto ourselves
+    for (unsigned int dir = 0; dir < NEIGH_MAX; ++dir)
+        m_neighbor_rank[dir] = h_cart_ranks.data[di(l,m,n)];
+
     // loop over neighbors
     for (int ix=-1; ix <= 1; ix++)
         {
@@ -1295,6 +1325,7 @@ void Communicator::initializeNeighborArrays()
                 unsigned int mask = 1 << dir;
 
                 unsigned int neighbor = h_cart_ranks.data[di(i,j,k)];
+                m_neighbor_rank[dir] = neighbor;
                 h_neighbors.data[m_nneigh] = neighbor;
                 h_adj_mask.data[m_nneigh] = mask;
                 m_nneigh++;
@@ -1330,8 +1361,11 @@ void Communicator::initializeNeighborArrays()
     }
 
 //! Interface to the communication methods.
-void Communicator::communicate(unsigned int timestep)
+void Communicator::communicate(unsigned int timestep, bool allow_overlap)
     {
+    // complete a ghost update left pending at the last call
+    finishUpdateGhosts(timestep);
+
     // Guard to prevent recursive triggering of migration
     m_is_communicating = true;
 
@@ -1343,7 +1377,10 @@ void Communicator::communicate(unsigned int timestep)
                                         }
                                       , timestep);
 
-    if (!m_force_migrate && !m_compute_callbacks.empty() && m_has_ghost_particles)
+    // with overlap, the caller does not need the compute callbacks on time steps without migration
+    const bool overlap = allow_overlap && m_ghost_overlap;
+
+    if (!m_force_migrate && !m_compute_callbacks.empty() && m_has_ghost_particles && !overlap)
         {
         // do an obligatory update before determining whether to migrate
         beginUpdateGhosts(timestep);
@@ -1371,11 +1408,13 @@ void Communicator::communicate(unsigned int timestep)
     bool migrate = migrate_request || m_force_migrate || !m_has_ghost_particles;
 
     // Update ghosts if we are not migrating
-    if (!migrate && m_compute_callbacks.empty())
+    if (!migrate && (m_compute_callbacks.empty() || overlap))
         {
         beginUpdateGhosts(timestep);
 
-        finishUpdateGhosts(timestep);
+        // with overlap, the caller computes the forces that do not depend on ghosts before completing the update
+        if (! overlap)
+            finishUpdateGhosts(timestep);
         }
 
     // Check if migration of particles is requested
@@ -1618,6 +1657,11 @@ void Communicator::exchangeGhosts()
             h_plan.data[i] = 0;
         }
 
+    // record the route of every ghost for the single stage ghost update
+    m_direct_ghosts_valid = false;
+    if (m_single_stage)
+        m_ghost_route.assign(m_pdata->getN(), ghost_route_self);
+
     /*
      * Mark non-bonded atoms for sending
      */
@@ -1720,6 +1764,9 @@ void Communicator::exchangeGhosts()
         // resize buffers
         m_plan_copybuf.resize(max_copy_ghosts);
 
+        if (m_single_stage)
+            m_route_copybuf.resize(max_copy_ghosts);
+
         if (flags[comm_flag::position])
             m_pos_copybuf.resize(max_copy_ghosts);
 
@@ -1779,6 +1826,8 @@ void Communicator::exchangeGhosts()
                     if (flags[comm_flag::velocity]) h_velocity_copybuf.data[m_num_copy_ghosts[dir]] = h_vel.data[idx];
                     if (flags[comm_flag::orientation]) h_orientation_copybuf.data[m_num_copy_ghosts[dir]] = h_orientation.data[idx];
                     h_plan_copybuf.data[m_num_copy_ghosts[dir]] = h_plan.data[idx];
+                    if (m_single_stage)
+                        m_route_copybuf[m_num_copy_ghosts[dir]] = m_ghost_route[idx] + ghost_route_step[dir];
 
                     h_copy_ghosts.data[m_num_copy_ghosts[dir]] = h_tag.data[idx];
                     m_num_copy_ghosts[dir]++;
@@ -1833,6 +1882,9 @@ void Communicator::exchangeGhosts()
         // resize plan array
         m_plan.resize(m_pdata->getN() + m_pdata->getNGhosts());
 
+        if (m_single_stage)
+            m_ghost_route.resize(m_pdata->getN() + m_pdata->getNGhosts());
+
         // exchange particle data, write directly to the particle data arrays
         if (m_prof)
             {
@@ -2039,6 +2091,26 @@ void Communicator::exchangeGhosts()
                 m_reqs.push_back(req);
                 }
 
+            if (m_single_stage)
+                {
+                MPI_Isend(m_num_copy_ghosts[dir] ? &m_route_copybuf.front() : NULL,
+                    m_num_copy_ghosts[dir]*sizeof(unsigned int),
+                    MPI_BYTE,
+                    send_neighbor,
+                    10,
+                    m_mpi_comm,
+                    &req);
+                m_reqs.push_back(req);
+                MPI_Irecv(m_num_recv_ghosts[dir] ? &m_ghost_route[start_idx] : NULL,
+                    m_num_recv_ghosts[dir]*sizeof(unsigned int),
+                    MPI_BYTE,
+                    recv_neighbor,
+                    10,
+                    m_mpi_comm,
+                    &req);
+                m_reqs.push_back(req);
+                }
+
             m_stats.resize(m_reqs.size());
             MPI_Waitall(m_reqs.size(), &m_reqs.front(), &m_stats.front());
             }
@@ -2081,6 +2153,9 @@ void Communicator::exchangeGhosts()
 
     m_ghosts_added = m_pdata->getNGhosts();
 
+    if (m_single_stage)
+        buildDirectGhostLists();
+
     // exchange ghost constraints along with ghost particles
     m_constraint_comm.exchangeGhostGroups(m_plan, mask);
 
@@ -2328,6 +2403,10 @@ void Communicator::exchangeGhosts()
     }
 
 //! update positions of ghost particles
+/*! Ghosts received in one stage may be forwarded in the following stages, so only the transfers of the first
+    communicating direction can be in flight when this method returns. finishUpdateGhosts() completes them and
+    performs the remaining stages. With the single stage update, all transfers are in flight.
+*/
 void Communicator::beginUpdateGhosts(unsigned int timestep)
     {
     // we have a current m_copy_ghosts liss which contain the indices of particles
@@ -2337,168 +2416,435 @@ void Communicator::beginUpdateGhosts(unsigned int timestep)
 
     m_exec_conf->msg->notice(7) << "Communicator: update ghosts" << std::endl;
 
-    // update data in these arrays
+    if (m_single_stage && m_direct_ghosts_valid)
+        {
+        startDirectGhostUpdate();
+        m_comm_pending = true;
+        }
+    else
+        {
+        m_ghost_update_dir = 0;
+        m_ghost_update_offset = m_pdata->getN();
+        m_comm_pending = postGhostUpdate();
+        }
 
-    unsigned int num_tot_recv_ghosts = 0; // total number of ghosts received
+    if (m_prof)
+        m_prof->pop();
+    }
 
-    for (unsigned int dir = 0; dir < 6; dir ++)
+/*! \param timestep The time step
+ */
+void Communicator::finishUpdateGhosts(unsigned int timestep)
+    {
+    if (! m_comm_pending)
+        return;
+
+    m_comm_pending = false;
+
+    if (m_prof)
+        m_prof->push("comm_ghost_update");
+
+    if (m_single_stage && m_direct_ghosts_valid)
         {
-        if (! isCommunicating(dir) ) continue;
+        completeDirectGhostUpdate();
+        }
+    else
+        {
+        completeGhostUpdate();
+        while (postGhostUpdate())
+            completeGhostUpdate();
+        }
 
-        CommFlags flags = getFlags();
+    if (m_prof)
+        m_prof->pop();
+    }
 
-        if (flags[comm_flag::position])
-            {
-            ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
-            ArrayHandle<Scalar4> h_pos_copybuf(m_pos_copybuf, access_location::host, access_mode::overwrite);
-            ArrayHandle<unsigned int> h_copy_ghosts(m_copy_ghosts[dir], access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+/*! Fills the send buffers of the next direction starting at m_ghost_update_dir and posts the non-blocking sends
+    and receives. Only non-permanent fields (position, velocity, orientation) need to be considered here, charge,
+    body, image and diameter are not updated between neighbor list builds.
 
-            // copy positions of ghost particles
-            for (unsigned int ghost_idx = 0; ghost_idx < m_num_copy_ghosts[dir]; ghost_idx++)
-                {
-                unsigned int idx = h_rtag.data[h_copy_ghosts.data[ghost_idx]];
+    \returns false if there are no more directions to communicate
+*/
+bool Communicator::postGhostUpdate()
+    {
+    while (m_ghost_update_dir < 6 && ! isCommunicating(m_ghost_update_dir))
+        m_ghost_update_dir++;
 
-                assert(idx < m_pdata->getN() + m_pdata->getNGhosts());
+    if (m_ghost_update_dir == 6)
+        return false;
 
-                // copy position into send buffer
-                h_pos_copybuf.data[ghost_idx] = h_pos.data[idx];
-                }
-            }
+    const unsigned int dir = m_ghost_update_dir;
+    CommFlags flags = getFlags();
 
-        if (flags[comm_flag::velocity])
-            {
-            ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::read);
-            ArrayHandle<Scalar4> h_velocity_copybuf(m_velocity_copybuf, access_location::host, access_mode::overwrite);
-            ArrayHandle<unsigned int> h_copy_ghosts(m_copy_ghosts[dir], access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+    unsigned int send_neighbor = m_decomposition->getNeighborRank(dir);
 
-            // copy velocity of ghost particles
-            for (unsigned int ghost_idx = 0; ghost_idx < m_num_copy_ghosts[dir]; ghost_idx++)
-                {
-                unsigned int idx = h_rtag.data[h_copy_ghosts.data[ghost_idx]];
+    // we receive from the direction opposite to the one we send to
+    unsigned int recv_neighbor;
+    if (dir % 2 == 0)
+        recv_neighbor = m_decomposition->getNeighborRank(dir+1);
+    else
+        recv_neighbor = m_decomposition->getNeighborRank(dir-1);
 
-                assert(idx < m_pdata->getN() + m_pdata->getNGhosts());
+    const unsigned int start_idx = m_ghost_update_offset;
 
-                // copy velocity into send buffer
-                h_velocity_copybuf.data[ghost_idx] = h_vel.data[idx];
-                }
+    m_reqs.clear();
+    MPI_Request req;
+
+    ArrayHandle<unsigned int> h_copy_ghosts(m_copy_ghosts[dir], access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+
+    if (flags[comm_flag::position])
+        {
+        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar4> h_pos_copybuf(m_pos_copybuf, access_location::host, access_mode::overwrite);
+
+        // copy positions of ghost particles
+        for (unsigned int ghost_idx = 0; ghost_idx < m_num_copy_ghosts[dir]; ghost_idx++)
+            {
+            unsigned int idx = h_rtag.data[h_copy_ghosts.data[ghost_idx]];
+
+            assert(idx < m_pdata->getN() + m_pdata->getNGhosts());
+
+            // copy position into send buffer
+            h_pos_copybuf.data[ghost_idx] = h_pos.data[idx];
             }
 
-        if (flags[comm_flag::orientation])
+        // exchange particle data, write directly to the particle data arrays
+        MPI_Isend(h_pos_copybuf.data, m_num_copy_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, send_neighbor, 1, m_mpi_comm, &req);
+        m_reqs.push_back(req);
+        MPI_Irecv(h_pos.data + start_idx, m_num_recv_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, recv_neighbor, 1, m_mpi_comm, &req);
+        m_reqs.push_back(req);
+        }
+
+    if (flags[comm_flag::velocity])
+        {
+        ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar4> h_velocity_copybuf(m_velocity_copybuf, access_location::host, access_mode::overwrite);
+
+        // copy velocity of ghost particles
+        for (unsigned int ghost_idx = 0; ghost_idx < m_num_copy_ghosts[dir]; ghost_idx++)
             {
-            ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
-            ArrayHandle<Scalar4> h_orientation_copybuf(m_orientation_copybuf, access_location::host, access_mode::overwrite);
-            ArrayHandle<unsigned int> h_copy_ghosts(m_copy_ghosts[dir], access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+            unsigned int idx = h_rtag.data[h_copy_ghosts.data[ghost_idx]];
 
-            // copy orientation of ghost particles
-            for (unsigned int ghost_idx = 0; ghost_idx < m_num_copy_ghosts[dir]; ghost_idx++)
-                {
-                unsigned int idx = h_rtag.data[h_copy_ghosts.data[ghost_idx]];
+            assert(idx < m_pdata->getN() + m_pdata->getNGhosts());
 
-                assert(idx < m_pdata->getN() + m_pdata->getNGhosts());
+            // copy velocity into send buffer
+            h_velocity_copybuf.data[ghost_idx] = h_vel.data[idx];
+            }
 
-                // copy orientation into send buffer
-                h_orientation_copybuf.data[ghost_idx] = h_orientation.data[idx];
-                }
+        MPI_Isend(h_velocity_copybuf.data, m_num_copy_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, send_neighbor, 2, m_mpi_comm, &req);
+        m_reqs.push_back(req);
+        MPI_Irecv(h_vel.data + start_idx, m_num_recv_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, recv_neighbor, 2, m_mpi_comm, &req);
+        m_reqs.push_back(req);
+        }
+
+    if (flags[comm_flag::orientation])
+        {
+        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar4> h_orientation_copybuf(m_orientation_copybuf, access_location::host, access_mode::overwrite);
+
+        // copy orientation of ghost particles
+        for (unsigned int ghost_idx = 0; ghost_idx < m_num_copy_ghosts[dir]; ghost_idx++)
+            {
+            unsigned int idx = h_rtag.data[h_copy_ghosts.data[ghost_idx]];
+
+            assert(idx < m_pdata->getN() + m_pdata->getNGhosts());
+
+            // copy orientation into send buffer
+            h_orientation_copybuf.data[ghost_idx] = h_orientation.data[idx];
             }
 
+        MPI_Isend(h_orientation_copybuf.data, m_num_copy_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, send_neighbor, 3, m_mpi_comm, &req);
+        m_reqs.push_back(req);
+        MPI_Irecv(h_orientation.data + start_idx, m_num_recv_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, recv_neighbor, 3, m_mpi_comm, &req);
+        m_reqs.push_back(req);
+        }
+
+    return true;
+    }
 
-        unsigned int send_neighbor = m_decomposition->getNeighborRank(dir);
+/*! Completes the transfers posted by postGhostUpdate() and advances to the next direction.
+*/
+void Communicator::completeGhostUpdate()
+    {
+    const unsigned int dir = m_ghost_update_dir;
+    const unsigned int start_idx = m_ghost_update_offset;
+    CommFlags flags = getFlags();
 
-        // we receive from the direction opposite to the one we send to
-        unsigned int recv_neighbor;
-        if (dir % 2 == 0)
-            recv_neighbor = m_decomposition->getNeighborRank(dir+1);
-        else
-            recv_neighbor = m_decomposition->getNeighborRank(dir-1);
+    if (m_prof)
+        m_prof->push("MPI send/recv");
 
+    if (m_reqs.size())
+        {
+        m_stats.resize(m_reqs.size());
+        MPI_Waitall(m_reqs.size(), &m_reqs.front(), &m_stats.front());
+        }
 
-        unsigned int start_idx;
+    if (m_prof)
+        m_prof->pop(0, (m_num_recv_ghosts[dir]+m_num_copy_ghosts[dir])*sizeof(Scalar4)*(m_reqs.size()/2));
 
-        if (m_prof)
-            m_prof->push("MPI send/recv");
+    // wrap particle positions (only if copying positions)
+    if (flags[comm_flag::position])
+        {
+        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
 
-        start_idx = m_pdata->getN() + num_tot_recv_ghosts;
+        const BoxDim shifted_box = getShiftedBox();
+        for (unsigned int idx = start_idx; idx < start_idx + m_num_recv_ghosts[dir]; idx++)
+            {
+            Scalar4& pos = h_pos.data[idx];
 
-        num_tot_recv_ghosts += m_num_recv_ghosts[dir];
+            // wrap particles received across a global boundary
+            int3 img = make_int3(0,0,0);
+            shifted_box.wrap(pos, img);
+            }
+        }
 
-        size_t sz = 0;
-        // only non-permanent fields (position, velocity, orientation) need to be considered here
-        // charge, body, image and diameter are not updated between neighbor list builds
-        if (flags[comm_flag::position])
+    m_ghost_update_offset += m_num_recv_ghosts[dir];
+    m_ghost_update_dir++;
+    }
+
+/*! A particle is sent as a ghost to every combination of the directions in its plan, with at most one direction
+    per dimension. During exchangeGhosts(), every ghost records its route, i.e. the direction from its owner. Ghosts
+    with the same route have the same owner and are forwarded in the same stages, so they arrive in the order of
+    the particle indices on the owner. This method builds the lists of particles sent to and ghosts received from
+    every direction in that order.
+*/
+void Communicator::buildDirectGhostLists()
+    {
+    const unsigned int N = m_pdata->getN();
+    const unsigned int n_ghosts = m_pdata->getNGhosts();
+    assert(m_ghost_route.size() == N + n_ghosts);
+
+    // only consider directions along which we communicate
+    unsigned int mask = 0;
+    for (unsigned int dir = 0; dir < 6; ++dir)
+        if (isCommunicating(dir))
+            mask |= 1 << dir;
+
+    unsigned int n_send[NEIGH_MAX];
+    unsigned int n_recv[NEIGH_MAX];
+    for (unsigned int route = 0; route < NEIGH_MAX; ++route)
+        n_send[route] = n_recv[route] = 0;
+
+    ArrayHandle<unsigned int> h_plan(m_plan, access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+
+    unsigned int routes[NEIGH_MAX];
+    for (unsigned int pass = 0; pass < 2; ++pass)
+        {
+        if (pass == 1)
             {
-            m_reqs.resize(2);
-            m_stats.resize(2);
+            // convert the counts into offsets
+            m_direct_send_begin[0] = m_direct_recv_begin[0] = 0;
+            for (unsigned int route = 0; route < NEIGH_MAX; ++route)
+                {
+                m_direct_send_begin[route+1] = m_direct_send_begin[route] + n_send[route];
+                m_direct_recv_begin[route+1] = m_direct_recv_begin[route] + n_recv[route];
+                n_send[route] = m_direct_send_begin[route];
+                n_recv[route] = m_direct_recv_begin[route];
+                }
+            m_direct_send_tags.resize(m_direct_send_begin[NEIGH_MAX]);
+            m_direct_recv_idx.resize(m_direct_recv_begin[NEIGH_MAX]);
+            }
 
-            ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
-            ArrayHandle<Scalar4> h_pos_copybuf(m_pos_copybuf, access_location::host, access_mode::read);
+        for (unsigned int idx = 0; idx < N; ++idx)
+            {
+            unsigned int plan = h_plan.data[idx] & mask;
+            if (! plan)
+                continue;
 
-            // exchange particle data, write directly to the particle data arrays
-            MPI_Isend(h_pos_copybuf.data, m_num_copy_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, send_neighbor, 1, m_mpi_comm, &m_reqs[0]);
-            MPI_Irecv(h_pos.data + start_idx, m_num_recv_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, recv_neighbor, 1, m_mpi_comm, &m_reqs[1]);
-            MPI_Waitall(2, &m_reqs.front(), &m_stats.front());
+            // combine the directions in the plan, one (or none) per dimension
+            unsigned int n_routes = 0;
+            for (int iz = -1; iz <= 1; ++iz)
+                {
+                if ((iz == 1 && !(plan & send_up)) || (iz == -1 && !(plan & send_down)))
+                    continue;
+                for (int iy = -1; iy <= 1; ++iy)
+                    {
+                    if ((iy == 1 && !(plan & send_north)) || (iy == -1 && !(plan & send_south)))
+                        continue;
+                    for (int ix = -1; ix <= 1; ++ix)
+                        {
+                        if ((ix == 1 && !(plan & send_east)) || (ix == -1 && !(plan & send_west)))
+                            continue;
+                        if (ix || iy || iz)
+                            routes[n_routes++] = ((iz+1)*3+(iy+1))*3+(ix+1);
+                        }
+                    }
+                }
 
-            sz += sizeof(Scalar4);
+            for (unsigned int i = 0; i < n_routes; ++i)
+                {
+                if (pass == 0)
+                    n_send[routes[i]]++;
+                else
+                    m_direct_send_tags[n_send[routes[i]]++] = h_tag.data[idx];
+                }
             }
 
-        if (flags[comm_flag::velocity])
+        for (unsigned int idx = N; idx < N + n_ghosts; ++idx)
             {
-            m_reqs.resize(2);
-            m_stats.resize(2);
+            unsigned int route = m_ghost_route[idx];
+            assert(route < NEIGH_MAX && route != ghost_route_self);
 
-            ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
-            ArrayHandle<Scalar4> h_vel_copybuf(m_velocity_copybuf, access_location::host, access_mode::read);
+            if (pass == 0)
+                n_recv[route]++;
+            else
+                m_direct_recv_idx[n_recv[route]++] = idx;
+            }
+        }
 
-            // exchange particle data, write directly to the particle data arrays
-            MPI_Isend(h_vel_copybuf.data, m_num_copy_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, send_neighbor, 2, m_mpi_comm, &m_reqs[0]);
-            MPI_Irecv(h_vel.data + start_idx, m_num_recv_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, recv_neighbor, 2, m_mpi_comm, &m_reqs[1]);
-            MPI_Waitall(2, &m_reqs.front(), &m_stats.front());
+    // the buffers have changed
+    freeDirectGhostRequests();
+    m_direct_ghosts_valid = true;
+    }
 
-            sz += sizeof(Scalar4);
+/*! \param fields Bit mask of the fields to send (1: position, 2: velocity, 4: orientation)
+
+    The persistent requests refer to the send and receive buffers, which are allocated here.
+*/
+void Communicator::initDirectGhostRequests(unsigned int fields)
+    {
+    freeDirectGhostRequests();
+    m_direct_fields = fields;
+
+    const unsigned int n_fields = (fields & 1) + ((fields >> 1) & 1) + ((fields >> 2) & 1);
+    if (! n_fields)
+        return;
+
+    m_direct_sendbuf.resize(m_direct_send_begin[NEIGH_MAX]*n_fields);
+    m_direct_recvbuf.resize(m_direct_recv_begin[NEIGH_MAX]*n_fields);
+
+    for (unsigned int route = 0; route < NEIGH_MAX; ++route)
+        {
+        MPI_Request req;
+
+        // send to the neighbor in the direction of the route
+        unsigned int n_send = m_direct_send_begin[route+1] - m_direct_send_begin[route];
+        if (n_send)
+            {
+            MPI_Send_init(&m_direct_sendbuf[m_direct_send_begin[route]*n_fields],
+                n_send*n_fields*sizeof(Scalar4),
+                MPI_BYTE,
+                m_neighbor_rank[route],
+                direct_ghost_tag + route,
+                m_mpi_comm,
+                &req);
+            m_direct_reqs.push_back(req);
             }
 
-        if (flags[comm_flag::orientation])
+        // receive from the neighbor in the opposite direction
+        unsigned int n_recv = m_direct_recv_begin[route+1] - m_direct_recv_begin[route];
+        if (n_recv)
             {
-            m_reqs.resize(2);
-            m_stats.resize(2);
+            MPI_Recv_init(&m_direct_recvbuf[m_direct_recv_begin[route]*n_fields],
+                n_recv*n_fields*sizeof(Scalar4),
+                MPI_BYTE,
+                m_neighbor_rank[NEIGH_MAX - 1 - route],
+                direct_ghost_tag + route,
+                m_mpi_comm,
+                &req);
+            m_direct_reqs.push_back(req);
+            }
+        }
+    }
 
-            ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
-            ArrayHandle<Scalar4> h_orientation_copybuf(m_orientation_copybuf, access_location::host, access_mode::read);
+void Communicator::freeDirectGhostRequests()
+    {
+    // the requests must not be active
+    if (m_comm_pending && m_single_stage && m_direct_ghosts_valid && m_direct_reqs.size())
+        {
+        m_stats.resize(m_direct_reqs.size());
+        MPI_Waitall(m_direct_reqs.size(), &m_direct_reqs.front(), &m_stats.front());
+        m_comm_pending = false;
+        }
 
-            // exchange particle data, write directly to the particle data arrays
-            MPI_Isend(h_orientation_copybuf.data, m_num_copy_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, send_neighbor, 3, m_mpi_comm, &m_reqs[0]);
-            MPI_Irecv(h_orientation.data + start_idx, m_num_recv_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, recv_neighbor, 3, m_mpi_comm, &m_reqs[1]);
-            MPI_Waitall(2, &m_reqs.front(), &m_stats.front());
+    for (unsigned int i = 0; i < m_direct_reqs.size(); ++i)
+        MPI_Request_free(&m_direct_reqs[i]);
+    m_direct_reqs.clear();
+    m_direct_fields = 0;
+    }
 
-            sz += sizeof(Scalar4);
+/*! Only non-permanent fields (position, velocity, orientation) need to be considered here, charge, body, image and
+    diameter are not updated between neighbor list builds.
+*/
+void Communicator::startDirectGhostUpdate()
+    {
+    CommFlags flags = getFlags();
+    unsigned int fields = 0;
+    if (flags[comm_flag::position])
+        fields |= 1;
+    if (flags[comm_flag::velocity])
+        fields |= 2;
+    if (flags[comm_flag::orientation])
+        fields |= 4;
+
+    if (fields != m_direct_fields)
+        initDirectGhostRequests(fields);
+
+    if (! m_direct_reqs.size())
+        return;
+
+        {
+        ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+
+        // pack the fields of every particle
+        Scalar4 *buf = &m_direct_sendbuf.front();
+        for (unsigned int i = 0; i < m_direct_send_tags.size(); ++i)
+            {
+            unsigned int idx = h_rtag.data[m_direct_send_tags[i]];
+            assert(idx < m_pdata->getN());
+
+            if (fields & 1) *buf++ = h_pos.data[idx];
+            if (fields & 2) *buf++ = h_vel.data[idx];
+            if (fields & 4) *buf++ = h_orientation.data[idx];
             }
+        }
 
-        if (m_prof)
-            m_prof->pop(0, (m_num_recv_ghosts[dir]+m_num_copy_ghosts[dir])*sz);
+    MPI_Startall(m_direct_reqs.size(), &m_direct_reqs.front());
+    }
 
+void Communicator::completeDirectGhostUpdate()
+    {
+    if (! m_direct_reqs.size())
+        return;
 
-        // wrap particle positions (only if copying positions)
-        if (flags[comm_flag::position])
-            {
-            ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+    const unsigned int fields = m_direct_fields;
 
-            const BoxDim shifted_box = getShiftedBox();
-            for (unsigned int idx = start_idx; idx < start_idx + m_num_recv_ghosts[dir]; idx++)
-                {
-                Scalar4& pos = h_pos.data[idx];
+    if (m_prof)
+        m_prof->push("MPI send/recv");
 
-                // wrap particles received across a global boundary
-                int3 img = make_int3(0,0,0);
-                shifted_box.wrap(pos, img);
-                }
-            }
+    m_stats.resize(m_direct_reqs.size());
+    MPI_Waitall(m_direct_reqs.size(), &m_direct_reqs.front(), &m_stats.front());
 
-        } // end dir loop
+    if (m_prof)
+        m_prof->pop(0, (m_direct_sendbuf.size() + m_direct_recvbuf.size())*sizeof(Scalar4));
 
-        if (m_prof)
-            m_prof->pop();
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
+
+    const BoxDim shifted_box = getShiftedBox();
+    const Scalar4 *buf = &m_direct_recvbuf.front();
+    for (unsigned int i = 0; i < m_direct_recv_idx.size(); ++i)
+        {
+        unsigned int idx = m_direct_recv_idx[i];
+        assert(idx >= m_pdata->getN() && idx < m_pdata->getN() + m_pdata->getNGhosts());
+
+        if (fields & 1)
+            {
+            // wrap particles received across a global boundary
+            Scalar4 pos = *buf++;
+            int3 img = make_int3(0,0,0);
+            shifted_box.wrap(pos, img);
+            h_pos.data[idx] = pos;
+            }
+        if (fields & 2) h_vel.data[idx] = *buf++;
+        if (fields & 4) h_orientation.data[idx] = *buf++;
+        }
     }
 
 void Communicator::updateNetForce(unsigned int timestep)
@@ -2821,6 +3167,77 @@ void Communicator::updateNetForce(unsigned int timestep)
             m_prof->pop();
     }
 
+/*! \param field Per-particle field to update, the ghost entries are overwritten
+ */
+void Communicator::updateGhostField(const GlobalArray<Scalar>& field)
+    {
+    assert(field.getNumElements() >= m_pdata->getN() + m_pdata->getNGhosts());
+
+    if (m_prof)
+        m_prof->push("comm_ghost_field");
+
+    m_exec_conf->msg->notice(7) << "Communicator: update ghost field" << std::endl;
+
+    unsigned int num_tot_recv_ghosts = 0; // total number of ghosts received
+
+    for (unsigned int dir = 0; dir < 6; dir ++)
+        {
+        if (! isCommunicating(dir) ) continue;
+
+        m_ghost_field_copybuf.resize(m_num_copy_ghosts[dir]);
+
+            {
+            ArrayHandle<Scalar> h_field(field, access_location::host, access_mode::read);
+            ArrayHandle<Scalar> h_ghost_field_copybuf(m_ghost_field_copybuf, access_location::host, access_mode::overwrite);
+            ArrayHandle<unsigned int> h_copy_ghosts(m_copy_ghosts[dir], access_location::host, access_mode::read);
+            ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+
+            // the ghosts sent in this direction may include ghosts received in a previous stage
+            for (unsigned int ghost_idx = 0; ghost_idx < m_num_copy_ghosts[dir]; ghost_idx++)
+                {
+                unsigned int idx = h_rtag.data[h_copy_ghosts.data[ghost_idx]];
+
+                assert(idx < m_pdata->getN() + m_pdata->getNGhosts());
+
+                h_ghost_field_copybuf.data[ghost_idx] = h_field.data[idx];
+                }
+            }
+
+        unsigned int send_neighbor = m_decomposition->getNeighborRank(dir);
+
+        // we receive from the direction opposite to the one we send to
+        unsigned int recv_neighbor;
+        if (dir % 2 == 0)
+            recv_neighbor = m_decomposition->getNeighborRank(dir+1);
+        else
+            recv_neighbor = m_decomposition->getNeighborRank(dir-1);
+
+        unsigned int start_idx = m_pdata->getN() + num_tot_recv_ghosts;
+        num_tot_recv_ghosts += m_num_recv_ghosts[dir];
+
+        if (m_prof)
+            m_prof->push("MPI send/recv");
+
+            {
+            m_reqs.resize(2);
+            m_stats.resize(2);
+
+            ArrayHandle<Scalar> h_field(field, access_location::host, access_mode::readwrite);
+            ArrayHandle<Scalar> h_ghost_field_copybuf(m_ghost_field_copybuf, access_location::host, access_mode::read);
+
+            // write directly into the ghost entries of the field
+            MPI_Isend(h_ghost_field_copybuf.data, m_num_copy_ghosts[dir]*sizeof(Scalar), MPI_BYTE, send_neighbor, 1, m_mpi_comm, &m_reqs[0]);
+            MPI_Irecv(h_field.data + start_idx, m_num_recv_ghosts[dir]*sizeof(Scalar), MPI_BYTE, recv_neighbor, 1, m_mpi_comm, &m_reqs[1]);
+            MPI_Waitall(2, &m_reqs.front(), &m_stats.front());
+            }
+
+        if (m_prof)
+            m_prof->pop(0, (m_num_recv_ghosts[dir]+m_num_copy_ghosts[dir])*sizeof(Scalar));
+        }
+
+    if (m_prof)
+        m_prof->pop();
+    }
 
 void Communicator::removeGhostParticleTags()
     {
@@ -2927,6 +3344,9 @@ void export_Communicator(py::module& m)
     .def(py::init<std::shared_ptr<SystemDefinition>, std::shared_ptr<DomainDecomposition> >())
     .def_property_readonly("domain_decomposition",
                            &Communicator::getDomainDecomposition)
+    .def_property("ghost_overlap", &Communicator::getGhostOverlap, &Communicator::setGhostOverlap)
+    .def_property("single_stage_ghost_update", &Communicator::getSingleStageGhostUpdate,
+                  &Communicator::setSingleStageGhostUpdate)
     ;
     }
 #endif // ENABLE_MPI
@@ -213,6 +213,91 @@ class PYBIND11_EXPORT Communicator
             return m_decomposition;
             }
 
+        //! Add wall clock time spent on local work on this rank
+        /*! \param t Time in nanoseconds
+         *
+         * The time is accumulated until the next call to resetWorkTime(). LoadBalancer uses it to balance the
+         * measured work instead of the number of particles.
+         */
+        void addWorkTime(int64_t t)
+            {
+            m_work_time += t;
+            }
+
+        //! Get the wall clock time (in nanoseconds) spent on local work since the last reset
+        int64_t getWorkTime() const
+            {
+            return m_work_time;
+            }
+
+        //! Reset the accumulated work time
+        void resetWorkTime()
+            {
+            m_work_time = 0;
+            }
+
+        //! Set whether ghost position updates overlap with the force computation
+        /*! When enabled, communicate(timestep, true) leaves a ghost position update in flight on time steps without
+         *  particle migration. The integrator then computes the forces on particles that do not interact with ghost
+         *  particles, calls finishUpdateGhosts() and computes the remaining forces. Integrators with rigid bodies
+         *  do not overlap. Only supported on the CPU.
+         */
+        void setGhostOverlap(bool overlap)
+            {
+            if (overlap && m_exec_conf->isCUDAEnabled())
+                {
+                m_exec_conf->msg->error() << "comm: Overlapping ghost updates with force computation is only "
+                                          << "supported on the CPU" << std::endl;
+                throw std::runtime_error("Error setting ghost overlap mode");
+                }
+            m_ghost_overlap = overlap;
+            }
+
+        //! Get whether ghost position updates overlap with the force computation
+        bool getGhostOverlap() const
+            {
+            return m_ghost_overlap;
+            }
+
+        //! Set whether ghost updates exchange data with all neighbors in a single round
+        /*! By default, ghost updates proceed in up to six stages, one per face of the domain, and ghosts in the edges
+         *  and corners are forwarded through intermediate ranks. With the single stage update, every rank sends
+         *  the ghost data directly to each of its up to 26 neighbors using persistent MPI requests. The routes are
+         *  recorded during the next ghost exchange. Only supported on the CPU.
+         */
+        void setSingleStageGhostUpdate(bool single_stage)
+            {
+            if (single_stage && m_exec_conf->isCUDAEnabled())
+                {
+                m_exec_conf->msg->error() << "comm: Single stage ghost updates are only supported on the CPU"
+                                          << std::endl;
+                throw std::runtime_error("Error setting ghost update mode");
+                }
+
+            if (single_stage == m_single_stage)
+                return;
+
+            // complete an update in flight before switching modes
+            finishUpdateGhosts(0);
+            m_single_stage = single_stage;
+            m_direct_ghosts_valid = false;
+
+            // record the ghost routes
+            forceMigrate();
+            }
+
+        //! Get whether ghost updates exchange data with all neighbors in a single round
+        bool getSingleStageGhostUpdate() const
+            {
+            return m_single_stage;
+            }
+
+        //! Returns true if a ghost update has been started but not yet completed with finishUpdateGhosts()
+        bool isGhostUpdatePending() const
+            {
+            return m_comm_pending;
+            }
+
 
         //! Subscribe to list of call-backs for ghost communication
         /*!
@@ -280,8 +365,13 @@ class PYBIND11_EXPORT Communicator
         /*! Interface to the communication methods.
          * This method is supposed to be called every time step and automatically performs all necessary
          * communication steps.
+         *
+         * \param timestep The time step
+         * \param allow_overlap If true and ghost overlap is enabled, a ghost position update is left pending
+         *        and the caller must complete it with finishUpdateGhosts(). The caller guarantees that the compute
+         *        callbacks are not needed on time steps without particle migration.
          */
-        void communicate(unsigned int timestep);
+        void communicate(unsigned int timestep, bool allow_overlap = false);
 
         //@}
 
@@ -312,17 +402,24 @@ class PYBIND11_EXPORT Communicator
          *
          * \param timestep The time step
          */
-        virtual void finishUpdateGhosts(unsigned int timestep)
-            {
-            // the base class implementation is currently empty
-            m_comm_pending = false;
-            }
+        virtual void finishUpdateGhosts(unsigned int timestep);
 
         /*! Communicate the net particle force
          * \parm timestep The time step
          */
         virtual void updateNetForce(unsigned int timestep);
 
+        /*! Copy a per-particle field from the local particles to their ghost copies
+         * Computes use this to share intermediate per-particle quantities between two passes of a force
+         * evaluation, e.g. the derivative of the embedding function in EAM. The current ghost exchange lists
+         * are reused, so the ghost entries of \a field are ordered like the ghost particle data.
+         *
+         * \param field Array with at least N + N_ghosts elements, indexed like the particle data
+         *
+         * \pre The ghost exchange list has been constructed in a previous time step, using exchangeGhosts().
+         */
+        virtual void updateGhostField(const GlobalArray<Scalar>& field);
+
         /*! This methods finds all the particles that are no longer inside the domain
          * boundaries and transfers them to neighboring processors.
          *
@@ -491,6 +588,7 @@ class PYBIND11_EXPORT Communicator
         GlobalVector<Scalar4> m_nettorque_copybuf;   //!< Buffer for net torque
         GlobalVector<Scalar> m_netvirial_copybuf;   //!< Buffer for net virial
         GlobalVector<Scalar> m_netvirial_recvbuf;   //!< Buffer for net virial (receive)
+        GlobalVector<Scalar> m_ghost_field_copybuf; //!< Buffer for per-particle ghost fields
 
         GlobalVector<unsigned int> m_copy_ghosts[6]; //!< Per-direction list of indices of particles to send as ghosts
         unsigned int m_num_copy_ghosts[6];       //!< Number of local particles that are sent to neighboring processors
@@ -551,6 +649,23 @@ class PYBIND11_EXPORT Communicator
         CommFlags m_last_flags;                       //!< Flags of last ghost exchange
 
         bool m_comm_pending;                     //!< If true, a communication is in process
+        int64_t m_work_time;                     //!< Accumulated time spent on local work (in ns)
+        bool m_ghost_overlap;                    //!< True if ghost updates may overlap with the force computation
+        unsigned int m_ghost_update_dir;         //!< Direction of the ghost update stage in flight
+        unsigned int m_ghost_update_offset;      //!< Index of the first ghost received in that stage
+        bool m_single_stage;                     //!< True if ghost updates exchange data with all neighbors at once
+        bool m_direct_ghosts_valid;              //!< True if the single stage ghost update lists are current
+        unsigned int m_neighbor_rank[NEIGH_MAX]; //!< Rank of the neighbor in each direction (including ourselves)
+        std::vector<unsigned int> m_ghost_route;   //!< Direction from the owner to every particle (during ghost exchange)
+        std::vector<unsigned int> m_route_copybuf; //!< Buffer for ghost routes
+        std::vector<unsigned int> m_direct_send_tags;  //!< Tags of the particles sent, grouped by direction
+        std::vector<unsigned int> m_direct_recv_idx;   //!< Indices of the ghosts received, grouped by direction
+        unsigned int m_direct_send_begin[NEIGH_MAX+1]; //!< First particle sent in every direction
+        unsigned int m_direct_recv_begin[NEIGH_MAX+1]; //!< First ghost received from every direction
+        std::vector<Scalar4> m_direct_sendbuf;   //!< Send buffer of the single stage ghost update
+        std::vector<Scalar4> m_direct_recvbuf;   //!< Receive buffer of the single stage ghost update
+        std::vector<MPI_Request> m_direct_reqs;  //!< Persistent requests of the single stage ghost update
+        unsigned int m_direct_fields;            //!< Fields the persistent requests have been set up for
         std::vector<MPI_Request> m_reqs; //!< Container for all MPI communication requests
         std::vector<MPI_Status> m_stats; //!< Container for all MPI communication statuses
 
@@ -632,6 +747,27 @@ class PYBIND11_EXPORT Communicator
             }
 
     private:
+        //! Post the ghost update transfers of the next communicating direction
+        bool postGhostUpdate();
+
+        //! Wait for the ghost update transfers in flight and wrap the received positions
+        void completeGhostUpdate();
+
+        //! Build the send and receive lists of the single stage ghost update from the recorded routes
+        void buildDirectGhostLists();
+
+        //! Set up the persistent requests of the single stage ghost update
+        void initDirectGhostRequests(unsigned int fields);
+
+        //! Free the persistent requests of the single stage ghost update
+        void freeDirectGhostRequests();
+
+        //! Fill the send buffers and start the single stage ghost update
+        void startDirectGhostUpdate();
+
+        //! Wait for the single stage ghost update and copy the received data into the ghosts
+        void completeDirectGhostUpdate();
+
         std::vector<pdata_element> m_sendbuf;  //!< Buffer for particles that are sent
         std::vector<pdata_element> m_recvbuf;  //!< Buffer for particles that are received
 
@@ -679,6 +815,7 @@ class PYBIND11_EXPORT Communicator
             {
             removeGhostParticleTags();
             m_has_ghost_particles = false;
+            m_direct_ghosts_valid = false;
             }
 
     };
@@ -150,6 +150,9 @@ void DCDDumpWriter::analyze(unsigned int timestep)
 
     m_pdata->takeSnapshot(snapshot);
 
+    // collect the member tags on the root rank
+    m_group->gatherMemberTags();
+
 #ifdef ENABLE_MPI
     // if we are not the root processor, do not perform file I/O
     if (m_comm && !m_exec_conf->isRoot())
@@ -29,7 +29,11 @@ namespace py = pybind11;
     \post All forces are initialized to 0
 */
 ForceCompute::ForceCompute(std::shared_ptr<SystemDefinition> sysdef)
-     : Compute(sysdef), m_particles_sorted(false)
+     : Compute(sysdef), m_particles_sorted(false), m_interior_computed(false), m_accumulate_net_force(false),
+       m_net_force_accumulated(false), m_force_arrays_stale(false), m_accumulated_timestep(0)
+#ifdef ENABLE_MPI
+       , m_record_work_time(true)
+#endif
     {
     assert(m_pdata);
     assert(m_pdata->getMaxN() > 0);
@@ -171,6 +175,7 @@ ForceCompute::~ForceCompute()
 */
 Scalar ForceCompute::calcEnergySum()
     {
+    computeForceArrays();
     ArrayHandle<Scalar4> h_force(m_force,access_location::host,access_mode::read);
     // always perform the sum in double precision for better accuracy
     // this is cheating and is really just a temporary hack to get logging up and running
@@ -195,6 +200,7 @@ Scalar ForceCompute::calcEnergySum()
 */
 Scalar ForceCompute::calcEnergyGroup(std::shared_ptr<ParticleGroup> group)
     {
+    computeForceArrays();
     unsigned int group_size = group->getNumMembers();
     ArrayHandle<Scalar4> h_force(m_force,access_location::host,access_mode::read);
 
@@ -220,6 +226,7 @@ Scalar ForceCompute::calcEnergyGroup(std::shared_ptr<ParticleGroup> group)
 
 vec3<double> ForceCompute::calcForceGroup(std::shared_ptr<ParticleGroup> group)
     {
+    computeForceArrays();
     unsigned int group_size = group->getNumMembers();
     ArrayHandle<Scalar4> h_force(m_force,access_location::host,access_mode::read);
 
@@ -245,6 +252,7 @@ vec3<double> ForceCompute::calcForceGroup(std::shared_ptr<ParticleGroup> group)
 */
 std::vector<Scalar> ForceCompute::calcVirialGroup(std::shared_ptr<ParticleGroup> group)
     {
+    computeForceArrays();
     const unsigned int group_size = group->getNumMembers();
     const ArrayHandle<Scalar> h_virial(m_virial,access_location::host,access_mode::read);
 
@@ -465,13 +473,77 @@ void ForceCompute::compute(unsigned int timestep)
         shouldCompute(timestep) ||
         m_pdata->getFlags() != m_computed_flags)
         {
-        computeForces(timestep);
+        // the forces go either to the per-particle arrays or to the net force arrays
+        m_net_force_accumulated = m_accumulate_net_force;
+        m_force_arrays_stale = m_accumulate_net_force;
+        m_accumulated_timestep = timestep;
+
+#ifdef ENABLE_MPI
+        if (m_comm && m_record_work_time)
+            {
+            // record the time spent on the local work for load balancing
+            ClockSource clk;
+            computeForces(timestep);
+            m_comm->addWorkTime(clk.getTime());
+            }
+        else
+#endif
+            {
+            computeForces(timestep);
+            }
+        }
+    else
+        {
+        // the forces are current, but have not been added to the net force arrays
+        m_net_force_accumulated = false;
         }
 
     m_particles_sorted = false;
+    m_interior_computed = false;
     m_computed_flags = m_pdata->getFlags();
     }
 
+#ifdef ENABLE_MPI
+/*! \param timestep Current time step
+
+    Uses the same criteria as compute() to decide whether forces need to be computed, without changing the state
+    that compute() depends on.
+*/
+void ForceCompute::computeInterior(unsigned int timestep)
+    {
+    m_interior_computed = false;
+
+    if (m_particles_sorted ||
+        peekCompute(timestep) ||
+        m_pdata->getFlags() != m_computed_flags)
+        {
+        ClockSource clk;
+        m_force_arrays_stale = m_accumulate_net_force;
+        m_accumulated_timestep = timestep;
+        m_interior_computed = computeInteriorForces(timestep);
+        if (m_comm)
+            m_comm->addWorkTime(clk.getTime());
+        }
+    }
+#endif
+
+/*! When the last computation added the forces to the net force arrays, computes them again into m_force, m_virial
+    and m_torque. This is only valid as long as the particles have not moved since, which holds for the loggers and
+    analyzers that run between time steps.
+*/
+void ForceCompute::computeForceArrays()
+    {
+    if (! m_force_arrays_stale)
+        return;
+
+    m_force_arrays_stale = false;
+
+    bool accumulate = m_accumulate_net_force;
+    m_accumulate_net_force = false;
+    computeForces(m_accumulated_timestep);
+    m_accumulate_net_force = accumulate;
+    }
+
 /*! \param num_iters Number of iterations to average for the benchmark
     \returns Milliseconds of execution time per calculation
 
@@ -512,6 +584,7 @@ double ForceCompute::benchmark(unsigned int num_iters)
  */
 Scalar4 ForceCompute::getTorque(unsigned int tag)
     {
+    computeForceArrays();
     unsigned int i = m_pdata->getRTag(tag);
     bool found = (i < m_pdata->getN());
     Scalar4 result = make_scalar4(0.0,0.0,0.0,0.0);
@@ -535,6 +608,7 @@ Scalar4 ForceCompute::getTorque(unsigned int tag)
  */
 Scalar3 ForceCompute::getForce(unsigned int tag)
     {
+    computeForceArrays();
     unsigned int i = m_pdata->getRTag(tag);
     bool found = (i < m_pdata->getN());
     Scalar3 result = make_scalar3(0.0,0.0,0.0);
@@ -559,6 +633,7 @@ Scalar3 ForceCompute::getForce(unsigned int tag)
  */
 Scalar ForceCompute::getVirial(unsigned int tag, unsigned int component)
     {
+    computeForceArrays();
     unsigned int i = m_pdata->getRTag(tag);
     bool found = (i < m_pdata->getN());
     Scalar result = Scalar(0.0);
@@ -582,6 +657,7 @@ Scalar ForceCompute::getVirial(unsigned int tag, unsigned int component)
  */
 Scalar ForceCompute::getEnergy(unsigned int tag)
     {
+    computeForceArrays();
     unsigned int i = m_pdata->getRTag(tag);
     bool found = (i < m_pdata->getN());
     Scalar result = Scalar(0.0);
@@ -67,7 +67,8 @@ class PYBIND11_EXPORT ForceCompute : public Compute
         #ifdef ENABLE_MPI
         //! Pre-compute the forces
         /*! This method is called in MPI simulations BEFORE the particles are migrated
-         * and can be used to overlap computation with communication
+         * and can be used to overlap computation with communication. It is not called on time steps
+         * where the ghost update overlaps with computeInterior().
          */
         virtual void preCompute(unsigned int timestep){}
         #endif
@@ -75,6 +76,82 @@ class PYBIND11_EXPORT ForceCompute : public Compute
         //! Computes the forces
         virtual void compute(unsigned int timestep);
 
+        #ifdef ENABLE_MPI
+        //! Computes the forces on particles that do not interact with ghost particles
+        /*! This method is called while a ghost position update is in flight. The following call to compute() at the
+         * same time step completes the forces on the remaining particles.
+         */
+        void computeInterior(unsigned int timestep);
+        #endif
+
+        //! Request that computed forces are added directly to the net force, virial and torque
+        /*! While set, compute() and computeInterior() add the forces to the net force arrays of the particle data
+         * instead of filling the per-particle arrays of this ForceCompute, if the sub-class supports it. The
+         * per-particle arrays are then computed on demand, when they are accessed before the next computation.
+         * Only supported on the CPU.
+         */
+        void setAccumulateNetForce(bool accumulate)
+            {
+            m_accumulate_net_force = accumulate && !m_exec_conf->isCUDAEnabled() && supportsNetForceAccumulation();
+            }
+
+        #ifdef ENABLE_MPI
+        //! Set whether compute() adds its wall clock time to the work time of the Communicator
+        /*! Integrator disables this while ForceComputes run concurrently, and records the time of the whole
+         * concurrent section instead, because the times of overlapping tasks do not add up to the wall time.
+         */
+        void setRecordWorkTime(bool record)
+            {
+            m_record_work_time = record;
+            }
+        #endif
+
+        //! Returns true if the last call to compute() added the forces to the net force arrays
+        bool isNetForceAccumulated() const
+            {
+            return m_net_force_accumulated;
+            }
+
+        //! Returns true if compute() adds the forces to the net force arrays
+        bool getAccumulateNetForce() const
+            {
+            return m_accumulate_net_force;
+            }
+
+        //! Returns true if compute() may run concurrently with other ForceComputes
+        /*! Sub-classes that return true only read shared data in computeForces(), do not communicate, and bring all
+            other Computes they modify up to date through getDependencies() and prepareConcurrentCompute(). Their
+            computeForces() may still use multiple threads.
+        */
+        virtual bool canComputeConcurrently() const
+            {
+            return false;
+            }
+
+        //! Get the Computes that computeForces() depends on
+        /*! These are computed before ForceComputes run concurrently, so that calls to their compute() method from
+            computeForces() do not change them.
+        */
+        virtual std::vector< std::shared_ptr<Compute> > getDependencies()
+            {
+            return std::vector< std::shared_ptr<Compute> >();
+            }
+
+        //! Update data that computeForces() would otherwise update on demand
+        /*! Called before ForceComputes run concurrently, for shared data that is not a Compute, such as the bonded
+            group tables.
+            \param timestep Current time step
+        */
+        virtual void prepareConcurrentCompute(unsigned int timestep)
+            {
+            }
+
+        //! Get the name of the profiler category for this ForceCompute
+        virtual std::string getProfileName() const
+            {
+            return "Force";
+            }
+
         //! Benchmark the force compute
         virtual double benchmark(unsigned int num_iters);
 
@@ -129,18 +206,21 @@ class PYBIND11_EXPORT ForceCompute : public Compute
         //! Get the array of computed forces
         GlobalArray<Scalar4>& getForceArray()
             {
+            computeForceArrays();
             return m_force;
             }
 
         //! Get the array of computed virials
         GlobalArray<Scalar>& getVirialArray()
             {
+            computeForceArrays();
             return m_virial;
             }
 
         //! Get the array of computed torques
         GlobalArray<Scalar4>& getTorqueArray()
             {
+            computeForceArrays();
             return m_torque;
             }
 
@@ -178,6 +258,14 @@ class PYBIND11_EXPORT ForceCompute : public Compute
 
     protected:
         bool m_particles_sorted;    //!< Flag set to true when particles are resorted in memory
+        bool m_interior_computed;   //!< Flag set to true when computeForces() only needs to add the boundary forces
+        bool m_accumulate_net_force;    //!< Flag set to true when computeForces() adds to the net force arrays
+        bool m_net_force_accumulated;   //!< True if the last computation added the forces to the net force arrays
+        bool m_force_arrays_stale;      //!< True if m_force, m_virial and m_torque do not hold the last computation
+        unsigned int m_accumulated_timestep;    //!< Time step of the last computation added to the net force
+        #ifdef ENABLE_MPI
+        bool m_record_work_time;        //!< True if compute() adds its time to the work time of the Communicator
+        #endif
 
         //! Helper function called when particles are sorted
         /*! setParticlesSorted() is passed as a slot to the particle sort signal.
@@ -223,6 +311,47 @@ class PYBIND11_EXPORT ForceCompute : public Compute
             \param timestep Current time step
         */
         virtual void computeForces(unsigned int timestep){}
+
+        //! Compute the forces on the particles that do not interact with ghost particles
+        /*! Sub-classes that support overlapping the force computation with the ghost update implement this method
+            and return true. computeForces() is then called with m_interior_computed set and only adds the forces
+            on the remaining particles. The default implementation computes nothing and returns false.
+            \param timestep Current time step
+        */
+        virtual bool computeInteriorForces(unsigned int timestep)
+            {
+            return false;
+            }
+
+        //! Returns true if computeForces() supports adding the forces to the net force arrays
+        /*! Sub-classes that return true write their output to getForceOutput(), getVirialOutput() and
+            getTorqueOutput() and must not overwrite the values already there when m_accumulate_net_force is set.
+        */
+        virtual bool supportsNetForceAccumulation() const
+            {
+            return false;
+            }
+
+        //! Get the array computeForces() writes the forces to
+        const GlobalArray<Scalar4>& getForceOutput() const
+            {
+            return m_accumulate_net_force ? m_pdata->getNetForce() : m_force;
+            }
+
+        //! Get the array computeForces() writes the virials to
+        const GlobalArray<Scalar>& getVirialOutput() const
+            {
+            return m_accumulate_net_force ? m_pdata->getNetVirial() : m_virial;
+            }
+
+        //! Get the array computeForces() writes the torques to
+        const GlobalArray<Scalar4>& getTorqueOutput() const
+            {
+            return m_accumulate_net_force ? m_pdata->getNetTorqueArray() : m_torque;
+            }
+
+        //! Compute the per-particle arrays if the last computation only added to the net force arrays
+        void computeForceArrays();
     };
 
 //! Exports the ForceCompute class to python
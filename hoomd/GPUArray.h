@@ -30,6 +30,7 @@
 #include <algorithm>
 #include <stdlib.h>
 #include <memory>
+#include <atomic>
 
 //! Specifies where to acquire the data
 struct access_location
@@ -539,13 +540,17 @@ class GPUArray : public GPUArrayBase<T, GPUArray<T> >
         //! Release the data pointer
         inline void release() const
             {
-            m_acquired = false;
+            // a negative count marks a single exclusive handle
+            if (m_acquired.load() < 0)
+                m_acquired.store(0);
+            else
+                m_acquired.fetch_sub(1);
             }
 
         //! Returns the acquire state
         inline bool isAcquired() const
             {
-            return m_acquired;
+            return m_acquired.load() != 0;
             }
 
         //! Need to be friend with dispatch
@@ -562,7 +567,7 @@ class GPUArray : public GPUArrayBase<T, GPUArray<T> >
         unsigned int m_pitch;                   //!< Pitch of the rows in elements
         unsigned int m_height;                  //!< Number of allocated rows
 
-        mutable bool m_acquired;                //!< Tracks whether the data has been acquired
+        mutable std::atomic<int> m_acquired;    //!< Number of shared host read handles, or -1 if acquired exclusively
         mutable data_location::Enum m_data_location;    //!< Tracks the current location of the data
 #ifdef ENABLE_HIP
         bool m_mapped;                          //!< True if we are using mapped memory
@@ -655,7 +660,7 @@ class GPUArrayDispatch : public ArrayHandleDispatch<T>
 // *****************************************
 
 template<class T> GPUArray<T>::GPUArray() :
-        m_num_elements(0), m_pitch(0), m_height(0), m_acquired(false), m_data_location(data_location::host)
+        m_num_elements(0), m_pitch(0), m_height(0), m_acquired(0), m_data_location(data_location::host)
 #ifdef ENABLE_HIP
         , m_mapped(false)
 #endif
@@ -663,7 +668,7 @@ template<class T> GPUArray<T>::GPUArray() :
     }
 
 template<class T> GPUArray<T>::GPUArray(std::shared_ptr<const ExecutionConfiguration> exec_conf) :
-        m_num_elements(0), m_pitch(0), m_height(0), m_acquired(false), m_data_location(data_location::host),
+        m_num_elements(0), m_pitch(0), m_height(0), m_acquired(0), m_data_location(data_location::host),
 #ifdef ENABLE_HIP
         m_mapped(false),
 #endif
@@ -676,7 +681,7 @@ template<class T> GPUArray<T>::GPUArray(std::shared_ptr<const ExecutionConfigura
     \param exec_conf Shared pointer to the execution configuration for managing CUDA initialization and shutdown
 */
 template<class T> GPUArray<T>::GPUArray(unsigned int num_elements, std::shared_ptr<const ExecutionConfiguration> exec_conf) :
-        m_num_elements(num_elements), m_pitch(num_elements), m_height(1), m_acquired(false), m_data_location(data_location::host),
+        m_num_elements(num_elements), m_pitch(num_elements), m_height(1), m_acquired(0), m_data_location(data_location::host),
 #ifdef ENABLE_HIP
         m_mapped(false),
 #endif
@@ -692,7 +697,7 @@ template<class T> GPUArray<T>::GPUArray(unsigned int num_elements, std::shared_p
     \param exec_conf Shared pointer to the execution configuration for managing CUDA initialization and shutdown
 */
 template<class T> GPUArray<T>::GPUArray(unsigned int width, unsigned int height, std::shared_ptr<const ExecutionConfiguration> exec_conf) :
-        m_height(height), m_acquired(false), m_data_location(data_location::host),
+        m_height(height), m_acquired(0), m_data_location(data_location::host),
 #ifdef ENABLE_HIP
         m_mapped(false),
 #endif
@@ -715,7 +720,7 @@ template<class T> GPUArray<T>::GPUArray(unsigned int width, unsigned int height,
     \param mapped True if we are using mapped-pinned memory
 */
 template<class T> GPUArray<T>::GPUArray(unsigned int num_elements, std::shared_ptr<const ExecutionConfiguration> exec_conf, bool mapped) :
-        m_num_elements(num_elements), m_pitch(num_elements), m_height(1), m_acquired(false), m_data_location(data_location::host),
+        m_num_elements(num_elements), m_pitch(num_elements), m_height(1), m_acquired(0), m_data_location(data_location::host),
         m_mapped(mapped),
         m_exec_conf(exec_conf)
     {
@@ -730,7 +735,7 @@ template<class T> GPUArray<T>::GPUArray(unsigned int num_elements, std::shared_p
     \param mapped True if we are using mapped-pinned memory
 */
 template<class T> GPUArray<T>::GPUArray(unsigned int width, unsigned int height, std::shared_ptr<const ExecutionConfiguration> exec_conf, bool mapped) :
-        m_height(height), m_acquired(false), m_data_location(data_location::host),
+        m_height(height), m_acquired(0), m_data_location(data_location::host),
         m_mapped(mapped),
         m_exec_conf(exec_conf)
     {
@@ -748,7 +753,7 @@ template<class T> GPUArray<T>::GPUArray(unsigned int width, unsigned int height,
 
 template<class T> GPUArray<T>::GPUArray(const GPUArray& from) noexcept
     : m_num_elements(from.m_num_elements), m_pitch(from.m_pitch),
-      m_height(from.m_height), m_acquired(false), m_data_location(data_location::host),
+      m_height(from.m_height), m_acquired(0), m_data_location(data_location::host),
 #ifdef ENABLE_HIP
         m_mapped(from.m_mapped),
 #endif
@@ -812,7 +817,7 @@ template<class T> GPUArray<T>::GPUArray(GPUArray&& from) noexcept
     : m_num_elements(std::move(from.m_num_elements)),
     m_pitch(std::move(from.m_pitch)),
     m_height(std::move(from.m_height)),
-    m_acquired(std::move(from.m_acquired)),
+    m_acquired(from.m_acquired.load()),
     m_data_location(std::move(from.m_data_location)),
 #ifdef ENABLE_HIP
     m_mapped(std::move(from.m_mapped)),
@@ -837,7 +842,7 @@ template<class T> GPUArray<T>& GPUArray<T>::operator=(GPUArray&& rhs) noexcept
     #endif
         h_data = std::move(rhs.h_data);
         m_data_location = std::move(rhs.m_data_location);
-        m_acquired = std::move(rhs.m_acquired);
+        m_acquired.store(rhs.m_acquired.load());
         }
 
     return *this;
@@ -864,7 +869,9 @@ template<class T> void GPUArray<T>::swap(GPUArray& from)
     std::swap(m_num_elements, from.m_num_elements);
     std::swap(m_pitch, from.m_pitch);
     std::swap(m_height, from.m_height);
-    std::swap(m_acquired, from.m_acquired);
+    int acquired = m_acquired.load();
+    m_acquired.store(from.m_acquired.load());
+    from.m_acquired.store(acquired);
     std::swap(m_data_location, from.m_data_location);
     std::swap(m_exec_conf, from.m_exec_conf);
 #ifdef ENABLE_HIP
@@ -1070,11 +1077,27 @@ ArrayHandleDispatch<T> GPUArray<T>::acquire(const access_location::Enum location
 #endif
                                         ) const
     {
-    if (m_acquired)
+    // reading on the host does not change the state of data that is already there, so any number of threads may
+    // hold such handles at the same time. All other accesses are exclusive.
+    bool shared = location == access_location::host && mode == access_mode::read;
+    #ifdef ENABLE_HIP
+    shared = shared && m_data_location != data_location::device;
+    #endif
+    if (shared)
+        {
+        int acquired = m_acquired.load();
+        do
+            {
+            if (acquired < 0)
+                throw std::runtime_error("Cannot acquire access to array in use.");
+            } while (!m_acquired.compare_exchange_weak(acquired, acquired + 1));
+        }
+    else
         {
-        throw std::runtime_error("Cannot acquire access to array in use.");
+        int acquired = 0;
+        if (!m_acquired.compare_exchange_strong(acquired, -1))
+            throw std::runtime_error("Cannot acquire access to array in use.");
         }
-    m_acquired = true;
 
     // base case - handle acquiring a NULL GPUArray by simply returning NULL to prevent any memcpys from being attempted
     if (isNull())
@@ -3,6 +3,7 @@
 
 #include "GSD.h"
 #include "GSDDumpWriter.h"
+#include "GSDPositionCodec.h"
 #include "Filesystem.h"
 #include "HOOMDVersion.h"
 
@@ -32,6 +33,12 @@ std::list<std::string> GSDDumpWriter::particle_chunks {"particles/typeid",
                                                        "particles/angmom",
                                                        "particles/image"};
 
+//! Maximum number of frames between key frames of compressed positions
+static const uint64_t position_key_frame_interval = 32;
+
+//! Name of the compressed position chunk
+static const char *compressed_position_chunk = "hoomd/compressed/particles/position";
+
 /*! Constructs the GSDDumpWriter. After construction, settings are set. No file operations are
     attempted until analyze() is called.
 
@@ -51,6 +58,13 @@ GSDDumpWriter::GSDDumpWriter(std::shared_ptr<SystemDefinition> sysdef,
     : Analyzer(sysdef), m_fname(fname), m_mode(mode),
                         m_truncate(truncate),
                         m_is_initialized(false),
+                        m_async(false),
+                        m_nframes(0),
+                        m_cur_buffer(0),
+                        m_position_precision(0),
+                        m_last_position_bits(0),
+                        m_last_position_frame(0),
+                        m_last_position_key_frame(0),
                         m_group(group)
     {
     m_exec_conf->msg->notice(5) << "Constructing GSDDumpWriter: " << m_fname << " " << mode << " " << truncate << endl;
@@ -59,6 +73,7 @@ GSDDumpWriter::GSDDumpWriter(std::shared_ptr<SystemDefinition> sysdef,
         throw std::invalid_argument("Invalid GSD file mode: " + mode);
         }
     m_log_writer = pybind11::none();
+    m_n_chunks[0] = m_n_chunks[1] = 0;
     }
 
 //! Initializes the output file for writing
@@ -115,6 +130,7 @@ void GSDDumpWriter::initFileIO()
         throw std::invalid_argument("Invalid GSD file mode: " + m_mode);
         }
 
+    m_nframes = gsd_get_nframes(&m_handle);
     m_is_initialized = true;
     }
 
@@ -129,6 +145,16 @@ GSDDumpWriter::~GSDDumpWriter()
 
     if (root && m_is_initialized)
         {
+        // complete the last frame before closing the file
+        try
+            {
+            finishWrite();
+            }
+        catch (const std::exception& e)
+            {
+            m_exec_conf->msg->error() << e.what() << endl;
+            }
+
         m_exec_conf->msg->notice(5) << "GSD: close gsd file " << m_fname << endl;
         gsd_close(&m_handle);
         }
@@ -138,6 +164,9 @@ GSDDumpWriter::~GSDDumpWriter()
 
     The first call to analyze() will create or overwrite the file and write out the current system configuration
     as frame 0. Subsequent calls will append frames to the file, or keep overwriting frame 0 if m_truncate is true.
+
+    In asynchronous mode, the chunks are packed into the current buffer and written by a background thread. The
+    previous frame must be complete before the chunks from the write signal are written to the file directly.
 */
 void GSDDumpWriter::analyze(unsigned int timestep)
     {
@@ -152,6 +181,9 @@ void GSDDumpWriter::analyze(unsigned int timestep)
     SnapshotParticleData<float> snapshot;
     const std::map<unsigned int, unsigned int>& map = m_pdata->takeSnapshot<float>(snapshot);
 
+    // collect the member tags on the root rank
+    m_group->gatherMemberTags();
+
 #ifdef ENABLE_MPI
     // if we are not the root processor, do not perform file I/O
     root = m_exec_conf->isRoot();
@@ -164,16 +196,22 @@ void GSDDumpWriter::analyze(unsigned int timestep)
     // truncate the file if requested
     if (m_truncate && root)
         {
-        m_exec_conf->msg->notice(10) << "GSD: truncating file" << endl;
-        retval = gsd_truncate(&m_handle);
-        GSDUtils::checkError(retval, m_fname);
+        // in asynchronous mode, the file is truncated below, once the previous frame is written
+        if (!m_async)
+            {
+            m_exec_conf->msg->notice(10) << "GSD: truncating file" << endl;
+            retval = gsd_truncate(&m_handle);
+            GSDUtils::checkError(retval, m_fname);
+            }
+        m_nframes = 0;
         }
 
     uint64_t nframes = 0;
     if (root)
         {
-        nframes = gsd_get_nframes(&m_handle);
+        nframes = m_nframes;
         m_exec_conf->msg->notice(10) << "GSD: " << m_fname << " has " << nframes << " frames" << endl;
+        m_n_chunks[m_cur_buffer] = 0;
         }
 
     #ifdef ENABLE_MPI
@@ -219,6 +257,19 @@ void GSDDumpWriter::analyze(unsigned int timestep)
             writeTopology(bdata_snapshot, adata_snapshot, ddata_snapshot, idata_snapshot, cdata_snapshot, pdata_snapshot);
         }
 
+    if (root)
+        {
+        // the slots write to the file directly
+        finishWrite();
+
+        if (m_truncate && m_async)
+            {
+            m_exec_conf->msg->notice(10) << "GSD: truncating file" << endl;
+            retval = gsd_truncate(&m_handle);
+            GSDUtils::checkError(retval, m_fname);
+            }
+        }
+
     // emit on all ranks, the slot needs to handle the mpi logic.
     m_write_signal.emit(m_handle);
 
@@ -229,15 +280,132 @@ void GSDDumpWriter::analyze(unsigned int timestep)
 
     if (root)
         {
-        m_exec_conf->msg->notice(10) << "GSD: ending frame" << endl;
-        retval = gsd_end_frame(&m_handle);
-        GSDUtils::checkError(retval, m_fname);
+        if (m_async)
+            {
+            m_exec_conf->msg->notice(10) << "GSD: writing frame in the background" << endl;
+            unsigned int buffer = m_cur_buffer;
+            m_pending_write = std::async(std::launch::async, [this, buffer] { return writeBufferedFrame(buffer); });
+            m_cur_buffer ^= 1;
+            }
+        else
+            {
+            m_exec_conf->msg->notice(10) << "GSD: ending frame" << endl;
+            retval = gsd_end_frame(&m_handle);
+            GSDUtils::checkError(retval, m_fname);
+            }
+        m_nframes++;
         }
 
     if (m_prof)
         m_prof->pop();
     }
 
+/*! \param name Name of the chunk
+    \param type Data type
+    \param N Number of rows
+    \param M Number of columns
+    \param data Chunk data
+
+    In asynchronous mode, the data is copied so that the caller may release it immediately.
+*/
+void GSDDumpWriter::writeChunk(const char *name, gsd_type type, uint64_t N, uint32_t M, const void *data)
+    {
+    if (!m_async)
+        {
+        int retval = gsd_write_chunk(&m_handle, name, type, N, M, 0, data);
+        GSDUtils::checkError(retval, m_fname);
+        return;
+        }
+
+    // reuse the chunks (and their memory) of the frame written two frames ago
+    std::vector<PendingChunk>& chunks = m_chunk_buffer[m_cur_buffer];
+    unsigned int& n_chunks = m_n_chunks[m_cur_buffer];
+    if (n_chunks == chunks.size())
+        chunks.resize(n_chunks+1);
+
+    PendingChunk& chunk = chunks[n_chunks++];
+    chunk.name = name;
+    chunk.type = type;
+    chunk.N = N;
+    chunk.M = M;
+    size_t size = N * M * gsd_sizeof_type(type);
+    chunk.data.resize(size);
+    if (size > 0)
+        memcpy(&chunk.data[0], data, size);
+    }
+
+/*! Rethrows any error that occurred while writing the frame in the background.
+*/
+void GSDDumpWriter::finishWrite()
+    {
+    if (m_pending_write.valid())
+        {
+        int retval = m_pending_write.get();
+        GSDUtils::checkError(retval, m_fname);
+        }
+    }
+
+void GSDDumpWriter::flush()
+    {
+    bool root=true;
+    #ifdef ENABLE_MPI
+    root = m_exec_conf->isRoot();
+    #endif
+
+    if (root)
+        finishWrite();
+    }
+
+/*! \param precision Grid spacing as a fraction of the box length, or None
+*/
+void GSDDumpWriter::setPositionPrecision(pybind11::object precision)
+    {
+    if (precision.is_none())
+        {
+        m_position_precision = Scalar(0.0);
+        return;
+        }
+
+    Scalar value = pybind11::cast<Scalar>(precision);
+    if (!(value > Scalar(0.0) && value < Scalar(1.0)))
+        {
+        throw std::invalid_argument("GSD: position_precision must be between 0 and 1");
+        }
+    m_position_precision = value;
+    }
+
+pybind11::object GSDDumpWriter::getPositionPrecision()
+    {
+    if (m_position_precision > Scalar(0.0))
+        return pybind11::cast(m_position_precision);
+    return pybind11::none();
+    }
+
+/*! \param buffer Index of the chunk buffer to write
+    \returns GSD_SUCCESS, or the first error code
+
+    This method runs on the background thread. It must not access any state other than the file handle and the given
+    buffer, and must not throw.
+*/
+int GSDDumpWriter::writeBufferedFrame(unsigned int buffer)
+    {
+    const std::vector<PendingChunk>& chunks = m_chunk_buffer[buffer];
+    for (unsigned int i = 0; i < m_n_chunks[buffer]; i++)
+        {
+        const PendingChunk& chunk = chunks[i];
+        int retval = gsd_write_chunk(&m_handle,
+                                     chunk.name.c_str(),
+                                     chunk.type,
+                                     chunk.N,
+                                     chunk.M,
+                                     0,
+                                     chunk.N > 0 ? (const void *)&chunk.data[0] : nullptr);
+        if (retval != GSD_SUCCESS)
+            return retval;
+        }
+
+    return gsd_end_frame(&m_handle);
+    }
 
 void GSDDumpWriter::writeTypeMapping(std::string chunk, std::vector< std::string > type_mapping)
     {
@@ -253,8 +421,7 @@ void GSDDumpWriter::writeTypeMapping(std::string chunk, std::vector< std::string
         std::vector<char> types(max_len * type_mapping.size());
         for (unsigned int i = 0; i < type_mapping.size(); i++)
             strncpy(&types[max_len*i], type_mapping[i].c_str(), max_len);
-        int retval = gsd_write_chunk(&m_handle, chunk.c_str(), GSD_TYPE_UINT8, type_mapping.size(), max_len, 0, (void *)&types[0]);
-        GSDUtils::checkError(retval, m_fname);
+        writeChunk(chunk.c_str(), GSD_TYPE_UINT8, type_mapping.size(), max_len, &types[0]);
         }
 
     }
@@ -269,18 +436,15 @@ void GSDDumpWriter::writeTypeMapping(std::string chunk, std::vector< std::string
 */
 void GSDDumpWriter::writeFrameHeader(unsigned int timestep)
     {
-    int retval;
     m_exec_conf->msg->notice(10) << "GSD: writing configuration/step" << endl;
     uint64_t step = timestep;
-    retval = gsd_write_chunk(&m_handle, "configuration/step", GSD_TYPE_UINT64, 1, 1, 0, (void *)&step);
-    GSDUtils::checkError(retval, m_fname);
+    writeChunk("configuration/step", GSD_TYPE_UINT64, 1, 1, &step);
 
-    if (gsd_get_nframes(&m_handle) == 0)
+    if (m_nframes == 0)
         {
         m_exec_conf->msg->notice(10) << "GSD: writing configuration/dimensions" << endl;
         uint8_t dimensions = m_sysdef->getNDimensions();
-        retval = gsd_write_chunk(&m_handle, "configuration/dimensions", GSD_TYPE_UINT8, 1, 1, 0, (void *)&dimensions);
-        GSDUtils::checkError(retval, m_fname);
+        writeChunk("configuration/dimensions", GSD_TYPE_UINT8, 1, 1, &dimensions);
         }
 
     m_exec_conf->msg->notice(10) << "GSD: writing configuration/box" << endl;
@@ -292,13 +456,11 @@ void GSDDumpWriter::writeFrameHeader(unsigned int timestep)
     box_a[3] = box.getTiltFactorXY();
     box_a[4] = box.getTiltFactorXZ();
     box_a[5] = box.getTiltFactorYZ();
-    retval = gsd_write_chunk(&m_handle, "configuration/box", GSD_TYPE_FLOAT, 6, 1, 0, (void *)box_a);
-    GSDUtils::checkError(retval, m_fname);
+    writeChunk("configuration/box", GSD_TYPE_FLOAT, 6, 1, box_a);
 
     m_exec_conf->msg->notice(10) << "GSD: writing particles/N" << endl;
     uint32_t N = m_group->getNumMembersGlobal();
-    retval = gsd_write_chunk(&m_handle, "particles/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
-    GSDUtils::checkError(retval, m_fname);
+    writeChunk("particles/N", GSD_TYPE_UINT32, 1, 1, &N);
     }
 
 /*! \param snapshot particle data snapshot to write out to the file
@@ -308,9 +470,7 @@ void GSDDumpWriter::writeFrameHeader(unsigned int timestep)
 void GSDDumpWriter::writeAttributes(const SnapshotParticleData<float>& snapshot, const std::map<unsigned int, unsigned int> &map)
     {
     uint32_t N = m_group->getNumMembersGlobal();
-    int retval;
-    uint64_t nframes = gsd_get_nframes(&m_handle);
-
+    
     writeTypeMapping("particles/types", snapshot.type_mapping);
 
         {
@@ -332,12 +492,11 @@ void GSDDumpWriter::writeAttributes(const SnapshotParticleData<float>& snapshot,
             type[group_idx] = uint32_t(snapshot.type[it->second]);
             }
 
-        if (!all_default || (nframes > 0 && m_nondefault["particles/typeid"]))
+        if (!all_default || (m_nframes > 0 && m_nondefault["particles/typeid"]))
             {
             m_exec_conf->msg->notice(10) << "GSD: writing particles/typeid" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&type[0]);
-            GSDUtils::checkError(retval, m_fname);
-            if (nframes == 0)
+            writeChunk("particles/typeid", GSD_TYPE_UINT32, N, 1, &type[0]);
+            if (m_nframes == 0)
                 m_nondefault["particles/typeid"] = true;
             }
         }
@@ -361,12 +520,11 @@ void GSDDumpWriter::writeAttributes(const SnapshotParticleData<float>& snapshot,
             data[group_idx] = float(snapshot.mass[it->second]);
             }
 
-        if (!all_default || (nframes > 0 && m_nondefault["particles/mass"]))
+        if (!all_default || (m_nframes > 0 && m_nondefault["particles/mass"]))
             {
             m_exec_conf->msg->notice(10) << "GSD: writing particles/mass" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/mass", GSD_TYPE_FLOAT, N, 1, 0, (void *)&data[0]);
-            GSDUtils::checkError(retval, m_fname);
-            if (nframes == 0)
+            writeChunk("particles/mass", GSD_TYPE_FLOAT, N, 1, &data[0]);
+            if (m_nframes == 0)
                 m_nondefault["particles/mass"] = true;
             }
 
@@ -385,12 +543,11 @@ void GSDDumpWriter::writeAttributes(const SnapshotParticleData<float>& snapshot,
             data[group_idx] = float(snapshot.charge[it->second]);
             }
 
-        if (!all_default || (nframes > 0 && m_nondefault["particles/charge"]))
+        if (!all_default || (m_nframes > 0 && m_nondefault["particles/charge"]))
             {
             m_exec_conf->msg->notice(10) << "GSD: writing particles/charge" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/charge", GSD_TYPE_FLOAT, N, 1, 0, (void *)&data[0]);
-            GSDUtils::checkError(retval, m_fname);
-            if (nframes == 0)
+            writeChunk("particles/charge", GSD_TYPE_FLOAT, N, 1, &data[0]);
+            if (m_nframes == 0)
                 m_nondefault["particles/charge"] = true;
             }
 
@@ -410,12 +567,11 @@ void GSDDumpWriter::writeAttributes(const SnapshotParticleData<float>& snapshot,
             data[group_idx] = float(snapshot.diameter[it->second]);
             }
 
-        if (!all_default || (nframes > 0 && m_nondefault["particles/diameter"]))
+        if (!all_default || (m_nframes > 0 && m_nondefault["particles/diameter"]))
             {
             m_exec_conf->msg->notice(10) << "GSD: writing particles/diameter" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/diameter", GSD_TYPE_FLOAT, N, 1, 0, (void *)&data[0]);
-            GSDUtils::checkError(retval, m_fname);
-            if (nframes == 0)
+            writeChunk("particles/diameter", GSD_TYPE_FLOAT, N, 1, &data[0]);
+            if (m_nframes == 0)
                 m_nondefault["particles/diameter"] = true;
             }
         }
@@ -439,12 +595,11 @@ void GSDDumpWriter::writeAttributes(const SnapshotParticleData<float>& snapshot,
             body[group_idx] = int32_t(snapshot.body[it->second]);
             }
 
-        if (!all_default || (nframes > 0 && m_nondefault["particles/body"]))
+        if (!all_default || (m_nframes > 0 && m_nondefault["particles/body"]))
             {
             m_exec_conf->msg->notice(10) << "GSD: writing particles/body" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/body", GSD_TYPE_INT32, N, 1, 0, (void *)&body[0]);
-            GSDUtils::checkError(retval, m_fname);
-            if (nframes == 0)
+            writeChunk("particles/body", GSD_TYPE_INT32, N, 1, &body[0]);
+            if (m_nframes == 0)
                 m_nondefault["particles/body"] = true;
             }
         }
@@ -474,12 +629,11 @@ void GSDDumpWriter::writeAttributes(const SnapshotParticleData<float>& snapshot,
             data[group_idx*3+2] = float(snapshot.inertia[it->second].z);
             }
 
-        if (!all_default || (nframes > 0 && m_nondefault["particles/moment_inertia"]))
+        if (!all_default || (m_nframes > 0 && m_nondefault["particles/moment_inertia"]))
             {
             m_exec_conf->msg->notice(10) << "GSD: writing particles/moment_inertia" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/moment_inertia", GSD_TYPE_FLOAT, N, 3, 0, (void *)&data[0]);
-            GSDUtils::checkError(retval, m_fname);
-            if (nframes == 0)
+            writeChunk("particles/moment_inertia", GSD_TYPE_FLOAT, N, 3, &data[0]);
+            if (m_nframes == 0)
                 m_nondefault["particles/moment_inertia"] = true;
             }
         }
@@ -492,9 +646,7 @@ void GSDDumpWriter::writeAttributes(const SnapshotParticleData<float>& snapshot,
 void GSDDumpWriter::writeProperties(const SnapshotParticleData<float>& snapshot, const std::map<unsigned int, unsigned int> &map)
     {
     uint32_t N = m_group->getNumMembersGlobal();
-    int retval;
-    uint64_t nframes = gsd_get_nframes(&m_handle);
-
+    
         {
         std::vector<float> data(uint64_t(N)*3);
         data.reserve(1); //! make sure we allocate
@@ -512,9 +664,35 @@ void GSDDumpWriter::writeProperties(const SnapshotParticleData<float>& snapshot,
             data[group_idx*3+2] = float(snapshot.pos[it->second].z);
             }
 
-        m_exec_conf->msg->notice(10) << "GSD: writing particles/position" << endl;
-        retval = gsd_write_chunk(&m_handle, "particles/position", GSD_TYPE_FLOAT, N, 3, 0, (void *)&data[0]);
-        GSDUtils::checkError(retval, m_fname);
+        if (m_position_precision > Scalar(0.0))
+            {
+            unsigned int bits = GSDPositionCodec::getBits(m_position_precision);
+            GSDPositionCodec::quantize(m_position_grid, &data[0], N, m_pdata->getGlobalBox(), bits);
+
+            // store differences to the previous frame when this writer wrote it with the same settings
+            bool key_frame = m_nframes == 0
+                             || m_last_position_frame + 1 != m_nframes
+                             || m_nframes - m_last_position_key_frame >= position_key_frame_interval
+                             || m_last_position_bits != bits
+                             || m_last_position_grid.size() != m_position_grid.size();
+
+            std::vector<uint8_t> encoded;
+            GSDPositionCodec::encode(encoded, m_position_grid, key_frame ? NULL : &m_last_position_grid, bits);
+
+            m_exec_conf->msg->notice(10) << "GSD: writing " << compressed_position_chunk << endl;
+            writeChunk(compressed_position_chunk, GSD_TYPE_UINT8, encoded.size(), 1, &encoded[0]);
+
+            if (key_frame)
+                m_last_position_key_frame = m_nframes;
+            m_last_position_frame = m_nframes;
+            m_last_position_bits = bits;
+            m_position_grid.swap(m_last_position_grid);
+            }
+        else
+            {
+            m_exec_conf->msg->notice(10) << "GSD: writing particles/position" << endl;
+            writeChunk("particles/position", GSD_TYPE_FLOAT, N, 3, &data[0]);
+            }
         }
 
         {
@@ -544,12 +722,11 @@ void GSDDumpWriter::writeProperties(const SnapshotParticleData<float>& snapshot,
             data[group_idx*4+3] = float(snapshot.orientation[it->second].v.z);
             }
 
-        if (!all_default || (nframes > 0 && m_nondefault["particles/orientation"]))
+        if (!all_default || (m_nframes > 0 && m_nondefault["particles/orientation"]))
             {
             m_exec_conf->msg->notice(10) << "GSD: writing particles/orientation" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/orientation", GSD_TYPE_FLOAT, N, 4, 0, (void *)&data[0]);
-            GSDUtils::checkError(retval, m_fname);
-            if (nframes == 0)
+            writeChunk("particles/orientation", GSD_TYPE_FLOAT, N, 4, &data[0]);
+            if (m_nframes == 0)
                 m_nondefault["particles/orientation"] = true;
             }
         }
@@ -562,9 +739,7 @@ void GSDDumpWriter::writeProperties(const SnapshotParticleData<float>& snapshot,
 void GSDDumpWriter::writeMomenta(const SnapshotParticleData<float>& snapshot, const std::map<unsigned int, unsigned int> &map)
     {
     uint32_t N = m_group->getNumMembersGlobal();
-    int retval;
-    uint64_t nframes = gsd_get_nframes(&m_handle);
-
+    
         {
         std::vector<float> data(uint64_t(N)*3);
         data.reserve(1); //! make sure we allocate
@@ -590,12 +765,11 @@ void GSDDumpWriter::writeMomenta(const SnapshotParticleData<float>& snapshot, co
             data[group_idx*3+2] = float(snapshot.vel[it->second].z);
             }
 
-        if (!all_default || (nframes > 0 && m_nondefault["particles/velocity"]))
+        if (!all_default || (m_nframes > 0 && m_nondefault["particles/velocity"]))
             {
             m_exec_conf->msg->notice(10) << "GSD: writing particles/velocity" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/velocity", GSD_TYPE_FLOAT, N, 3, 0, (void *)&data[0]);
-            GSDUtils::checkError(retval, m_fname);
-            if (nframes == 0)
+            writeChunk("particles/velocity", GSD_TYPE_FLOAT, N, 3, &data[0]);
+            if (m_nframes == 0)
                 m_nondefault["particles/velocity"] = true;
             }
         }
@@ -627,12 +801,11 @@ void GSDDumpWriter::writeMomenta(const SnapshotParticleData<float>& snapshot, co
             data[group_idx*4+3] = float(snapshot.angmom[it->second].v.z);
             }
 
-        if (!all_default || (nframes > 0 && m_nondefault["particles/angmom"]))
+        if (!all_default || (m_nframes > 0 && m_nondefault["particles/angmom"]))
             {
             m_exec_conf->msg->notice(10) << "GSD: writing particles/angmom" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/angmom", GSD_TYPE_FLOAT, N, 4, 0, (void *)&data[0]);
-            GSDUtils::checkError(retval, m_fname);
-            if (nframes == 0)
+            writeChunk("particles/angmom", GSD_TYPE_FLOAT, N, 4, &data[0]);
+            if (m_nframes == 0)
                 m_nondefault["particles/angmom"] = true;
             }
         }
@@ -662,12 +835,11 @@ void GSDDumpWriter::writeMomenta(const SnapshotParticleData<float>& snapshot, co
             data[group_idx*3+2] = float(snapshot.image[it->second].z);
             }
 
-        if (!all_default || (nframes > 0 && m_nondefault["particles/image"]))
+        if (!all_default || (m_nframes > 0 && m_nondefault["particles/image"]))
             {
             m_exec_conf->msg->notice(10) << "GSD: writing particles/image" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/image", GSD_TYPE_INT32, N, 3, 0, (void *)&data[0]);
-            GSDUtils::checkError(retval, m_fname);
-            if (nframes == 0)
+            writeChunk("particles/image", GSD_TYPE_INT32, N, 3, &data[0]);
+            if (m_nframes == 0)
                 m_nondefault["particles/image"] = true;
             }
         }
@@ -693,77 +865,64 @@ void GSDDumpWriter::writeTopology(BondData::Snapshot& bond,
         {
         m_exec_conf->msg->notice(10) << "GSD: writing bonds/N" << endl;
         uint32_t N = bond.size;
-        int retval = gsd_write_chunk(&m_handle, "bonds/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
-        GSDUtils::checkError(retval, m_fname);
+        writeChunk("bonds/N", GSD_TYPE_UINT32, 1, 1, &N);
 
         writeTypeMapping("bonds/types", bond.type_mapping);
 
         m_exec_conf->msg->notice(10) << "GSD: writing bonds/typeid" << endl;
-        retval = gsd_write_chunk(&m_handle, "bonds/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&bond.type_id[0]);
-        GSDUtils::checkError(retval, m_fname);
+        writeChunk("bonds/typeid", GSD_TYPE_UINT32, N, 1, &bond.type_id[0]);
 
         m_exec_conf->msg->notice(10) << "GSD: writing bonds/group" << endl;
-        retval = gsd_write_chunk(&m_handle, "bonds/group", GSD_TYPE_UINT32, N, 2, 0, (void *)&bond.groups[0]);
-        GSDUtils::checkError(retval, m_fname);
+        writeChunk("bonds/group", GSD_TYPE_UINT32, N, 2, &bond.groups[0]);
         }
     if (angle.size > 0)
         {
         m_exec_conf->msg->notice(10) << "GSD: writing angles/N" << endl;
         uint32_t N = angle.size;
-        int retval = gsd_write_chunk(&m_handle, "angles/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
-        GSDUtils::checkError(retval, m_fname);
+        writeChunk("angles/N", GSD_TYPE_UINT32, 1, 1, &N);
 
         writeTypeMapping("angles/types", angle.type_mapping);
 
         m_exec_conf->msg->notice(10) << "GSD: writing angles/typeid" << endl;
-        retval = gsd_write_chunk(&m_handle, "angles/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&angle.type_id[0]);
-        GSDUtils::checkError(retval, m_fname);
+        writeChunk("angles/typeid", GSD_TYPE_UINT32, N, 1, &angle.type_id[0]);
 
         m_exec_conf->msg->notice(10) << "GSD: writing angles/group" << endl;
-        retval = gsd_write_chunk(&m_handle, "angles/group", GSD_TYPE_UINT32, N, 3, 0, (void *)&angle.groups[0]);
-        GSDUtils::checkError(retval, m_fname);
+        writeChunk("angles/group", GSD_TYPE_UINT32, N, 3, &angle.groups[0]);
         }
     if (dihedral.size > 0)
         {
         m_exec_conf->msg->notice(10) << "GSD: writing dihedrals/N" << endl;
         uint32_t N = dihedral.size;
-        int retval = gsd_write_chunk(&m_handle, "dihedrals/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
-        GSDUtils::checkError(retval, m_fname);
+        writeChunk("dihedrals/N", GSD_TYPE_UINT32, 1, 1, &N);
 
         writeTypeMapping("dihedrals/types", dihedral.type_mapping);
 
         m_exec_conf->msg->notice(10) << "GSD: writing dihedrals/typeid" << endl;
-        retval = gsd_write_chunk(&m_handle, "dihedrals/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&dihedral.type_id[0]);
-        GSDUtils::checkError(retval, m_fname);
+        writeChunk("dihedrals/typeid", GSD_TYPE_UINT32, N, 1, &dihedral.type_id[0]);
 
         m_exec_conf->msg->notice(10) << "GSD: writing dihedrals/group" << endl;
-        retval = gsd_write_chunk(&m_handle, "dihedrals/group", GSD_TYPE_UINT32, N, 4, 0, (void *)&dihedral.groups[0]);
-        GSDUtils::checkError(retval, m_fname);
+        writeChunk("dihedrals/group", GSD_TYPE_UINT32, N, 4, &dihedral.groups[0]);
         }
     if (improper.size > 0)
         {
         m_exec_conf->msg->notice(10) << "GSD: writing impropers/N" << endl;
         uint32_t N = improper.size;
-        int retval = gsd_write_chunk(&m_handle, "impropers/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
-        GSDUtils::checkError(retval, m_fname);
+        writeChunk("impropers/N", GSD_TYPE_UINT32, 1, 1, &N);
 
         writeTypeMapping("impropers/types", improper.type_mapping);
 
         m_exec_conf->msg->notice(10) << "GSD: writing impropers/typeid" << endl;
-        retval = gsd_write_chunk(&m_handle, "impropers/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&improper.type_id[0]);
-        GSDUtils::checkError(retval, m_fname);
+        writeChunk("impropers/typeid", GSD_TYPE_UINT32, N, 1, &improper.type_id[0]);
 
         m_exec_conf->msg->notice(10) << "GSD: writing impropers/group" << endl;
-        retval = gsd_write_chunk(&m_handle, "impropers/group", GSD_TYPE_UINT32, N, 4, 0, (void *)&improper.groups[0]);
-        GSDUtils::checkError(retval, m_fname);
+        writeChunk("impropers/group", GSD_TYPE_UINT32, N, 4, &improper.groups[0]);
         }
 
     if (constraint.size > 0)
         {
         m_exec_conf->msg->notice(10) << "GSD: writing constraints/N" << endl;
         uint32_t N = constraint.size;
-        int retval = gsd_write_chunk(&m_handle, "constraints/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
-        GSDUtils::checkError(retval, m_fname);
+        writeChunk("constraints/N", GSD_TYPE_UINT32, 1, 1, &N);
 
         m_exec_conf->msg->notice(10) << "GSD: writing constraints/value" << endl;
             {
@@ -772,31 +931,26 @@ void GSDDumpWriter::writeTopology(BondData::Snapshot& bond,
             for (unsigned int i = 0; i < N; i++)
                 data[i] = float(constraint.val[i]);
 
-            retval = gsd_write_chunk(&m_handle, "constraints/value", GSD_TYPE_FLOAT, N, 1, 0, (void *)&data[0]);
-            GSDUtils::checkError(retval, m_fname);
+            writeChunk("constraints/value", GSD_TYPE_FLOAT, N, 1, &data[0]);
             }
 
         m_exec_conf->msg->notice(10) << "GSD: writing constraints/group" << endl;
-        retval = gsd_write_chunk(&m_handle, "constraints/group", GSD_TYPE_UINT32, N, 2, 0, (void *)&constraint.groups[0]);
-        GSDUtils::checkError(retval, m_fname);
+        writeChunk("constraints/group", GSD_TYPE_UINT32, N, 2, &constraint.groups[0]);
         }
 
     if (pair.size > 0)
         {
         m_exec_conf->msg->notice(10) << "GSD: writing pairs/N" << endl;
         uint32_t N = pair.size;
-        int retval = gsd_write_chunk(&m_handle, "pairs/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
-        GSDUtils::checkError(retval, m_fname);
+        writeChunk("pairs/N", GSD_TYPE_UINT32, 1, 1, &N);
 
         writeTypeMapping("pairs/types", pair.type_mapping);
 
         m_exec_conf->msg->notice(10) << "GSD: writing pairs/typeid" << endl;
-        retval = gsd_write_chunk(&m_handle, "pairs/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&pair.type_id[0]);
-        GSDUtils::checkError(retval, m_fname);
+        writeChunk("pairs/typeid", GSD_TYPE_UINT32, N, 1, &pair.type_id[0]);
 
         m_exec_conf->msg->notice(10) << "GSD: writing pairs/group" << endl;
-        retval = gsd_write_chunk(&m_handle, "pairs/group", GSD_TYPE_UINT32, N, 2, 0, (void *)&pair.groups[0]);
-        GSDUtils::checkError(retval, m_fname);
+        writeChunk("pairs/group", GSD_TYPE_UINT32, N, 2, &pair.groups[0]);
         }
     }
 
@@ -894,14 +1048,7 @@ void GSDDumpWriter::writeLogQuantities(pybind11::dict dict)
                 throw invalid_argument("Invalid numpy dimension in gsd log data [" + name + "]");
                 }
 
-            int retval = gsd_write_chunk(&m_handle,
-                                        name.c_str(),
-                                        type,
-                                        N,
-                                        M,
-                                        0,
-                                        (void *)arr.data());
-            GSDUtils::checkError(retval, m_fname);
+            writeChunk(name.c_str(), type, N, M, arr.data());
             }
         }
     }
@@ -952,6 +1099,10 @@ void export_GSDDumpWriter(py::module& m)
         .def("setWriteProperty", &GSDDumpWriter::setWriteProperty)
         .def("setWriteMomentum", &GSDDumpWriter::setWriteMomentum)
         .def("setWriteTopology", &GSDDumpWriter::setWriteTopology)
+        .def("flush", &GSDDumpWriter::flush)
+        .def_property("asynchronous", &GSDDumpWriter::getAsynchronous, &GSDDumpWriter::setAsynchronous)
+        .def_property("position_precision", &GSDDumpWriter::getPositionPrecision,
+                      &GSDDumpWriter::setPositionPrecision)
         .def("writeLogQuantities", &GSDDumpWriter::writeLogQuantities)
         .def_property("log_writer", &GSDDumpWriter::getLogWriter, &GSDDumpWriter::setLogWriter)
         .def_property_readonly("filename", &GSDDumpWriter::getFilename)
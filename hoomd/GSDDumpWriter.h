@@ -9,6 +9,8 @@
 
 #include <string>
 #include <memory>
+#include <vector>
+#include <future>
 #include "hoomd/extern/gsd.h"
 
 /*! \file GSDDumpWriter.h
@@ -28,6 +30,17 @@
 
     The file is not opened until the first call to analyze().
 
+    When a position precision is set, particles/position is replaced by a compressed chunk (see GSDPositionCodec).
+    Positions are quantized to the given fraction of the box length and stored as differences to the previous
+    frame, with a key frame at least every 32 frames to bound the cost of random access. GSDReader decodes these
+    chunks, other GSD readers do not.
+
+    In asynchronous mode, analyze() gathers and packs the frame into memory and hands it to a background thread
+    that writes it to the file, so the simulation continues while the frame is written. The packed chunks are double
+    buffered: the next call to analyze() packs into the other buffer and waits for the previous write to complete only
+    before it writes the chunks provided by the write signal and starts the next write. Call flush() to wait for the
+    last frame to be written to the file. All MPI communication remains on the calling thread.
+
     \ingroup analyzers
 */
 class PYBIND11_EXPORT GSDDumpWriter : public Analyzer
@@ -64,6 +77,29 @@ class PYBIND11_EXPORT GSDDumpWriter : public Analyzer
             m_write_topology = b;
             }
 
+        //! Enable or disable asynchronous writes
+        void setAsynchronous(bool b)
+            {
+            if (!b)
+                flush();
+            m_async = b;
+            }
+
+        //! Check if writes are asynchronous
+        bool getAsynchronous()
+            {
+            return m_async;
+            }
+
+        //! Wait until all frames are written to the file
+        void flush();
+
+        //! Set the precision of compressed positions (None to write uncompressed positions)
+        void setPositionPrecision(pybind11::object precision);
+
+        //! Get the precision of compressed positions
+        pybind11::object getPositionPrecision();
+
         std::string getFilename()
             {
             return m_fname;
@@ -145,7 +181,31 @@ class PYBIND11_EXPORT GSDDumpWriter : public Analyzer
         bool m_write_property;              //!< True if properties should be written
         bool m_write_momentum;              //!< True if momenta should be written
         bool m_write_topology;              //!< True if topology should be written
+        bool m_async;                       //!< True if frames are written by a background thread
         gsd_handle m_handle;                //!< Handle to the file
+        uint64_t m_nframes;                 //!< Number of frames in the file, including frames not yet written
+
+        //! A data chunk waiting to be written to the file
+        struct PendingChunk
+            {
+            std::string name;               //!< Chunk name
+            gsd_type type;                  //!< Data type
+            uint64_t N;                     //!< Number of rows
+            uint32_t M;                     //!< Number of columns
+            std::vector<char> data;         //!< Chunk data
+            };
+
+        std::vector<PendingChunk> m_chunk_buffer[2]; //!< Double buffered chunks of asynchronously written frames
+        unsigned int m_n_chunks[2];                  //!< Number of chunks in use in each buffer
+        unsigned int m_cur_buffer;                   //!< Buffer that the current frame is packed into
+        std::future<int> m_pending_write;            //!< Result of the write in progress
+
+        Scalar m_position_precision;                 //!< Grid spacing of compressed positions (0 to disable)
+        std::vector<uint32_t> m_position_grid;       //!< Quantized positions of the current frame
+        std::vector<uint32_t> m_last_position_grid;  //!< Quantized positions of the last written frame
+        unsigned int m_last_position_bits;           //!< Bits per coordinate in the last written frame
+        uint64_t m_last_position_frame;              //!< Frame index of the last compressed positions
+        uint64_t m_last_position_key_frame;          //!< Frame index of the last compressed key frame
 
         static std::list<std::string> particle_chunks;
 
@@ -157,6 +217,15 @@ class PYBIND11_EXPORT GSDDumpWriter : public Analyzer
 
         hoomd::detail::SharedSignal<int (gsd_handle&)> m_write_signal;
 
+        //! Write a data chunk to the file, or add it to the current frame's buffer in asynchronous mode
+        void writeChunk(const char *name, gsd_type type, uint64_t N, uint32_t M, const void *data);
+
+        //! Wait for the write in progress to complete
+        void finishWrite();
+
+        //! Write the buffered chunks and end the frame (executed on the background thread)
+        int writeBufferedFrame(unsigned int buffer);
+
         //! Write a type mapping out to the file
         void writeTypeMapping(std::string chunk, std::vector< std::string > type_mapping);
 
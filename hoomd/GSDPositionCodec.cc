@@ -0,0 +1,298 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file GSDPositionCodec.cc
+    \brief Defines the GSDPositionCodec class
+*/
+
+#include "GSDPositionCodec.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string.h>
+
+using namespace std;
+
+namespace hoomd
+    {
+namespace detail
+    {
+//! Magic bytes at the start of each encoded chunk
+static const char codec_magic[4] = {'H', 'Q', 'P', '1'};
+
+//! Flag marking delta frames
+static const uint8_t codec_flag_delta = 1;
+
+const unsigned int GSDPositionCodec::block_size;
+const unsigned int GSDPositionCodec::escape;
+const size_t GSDPositionCodec::header_size;
+const unsigned int GSDPositionCodec::max_bits;
+
+//! Writes values with a given number of bits, least significant bit first
+class BitWriter
+    {
+    public:
+        BitWriter(std::vector<uint8_t>& out) : m_out(out), m_acc(0), m_nbits(0) { }
+
+        //! Write the lowest n bits of value (n <= 32)
+        void put(uint32_t value, unsigned int n)
+            {
+            m_acc |= (uint64_t(value) & ((uint64_t(1) << n) - 1)) << m_nbits;
+            m_nbits += n;
+            while (m_nbits >= 8)
+                {
+                m_out.push_back(uint8_t(m_acc & 0xff));
+                m_acc >>= 8;
+                m_nbits -= 8;
+                }
+            }
+
+        //! Write the remaining bits
+        void flush()
+            {
+            if (m_nbits > 0)
+                m_out.push_back(uint8_t(m_acc & 0xff));
+            m_acc = 0;
+            m_nbits = 0;
+            }
+
+    private:
+        std::vector<uint8_t>& m_out;
+        uint64_t m_acc;
+        unsigned int m_nbits;
+    };
+
+//! Reads values written by BitWriter
+class BitReader
+    {
+    public:
+        BitReader(const uint8_t *data, size_t size) : m_data(data), m_size(size), m_pos(0), m_acc(0), m_nbits(0) { }
+
+        //! Read n bits (n <= 32)
+        uint32_t get(unsigned int n)
+            {
+            while (m_nbits < n)
+                {
+                if (m_pos >= m_size)
+                    throw runtime_error("GSD: Compressed position chunk is truncated");
+                m_acc |= uint64_t(m_data[m_pos++]) << m_nbits;
+                m_nbits += 8;
+                }
+            uint32_t value = uint32_t(m_acc & ((uint64_t(1) << n) - 1));
+            m_acc >>= n;
+            m_nbits -= n;
+            return value;
+            }
+
+        //! Count the 1 bits before the next 0 bit, stopping at limit
+        unsigned int getUnary(unsigned int limit)
+            {
+            unsigned int count = 0;
+            while (count < limit && get(1))
+                count++;
+            return count;
+            }
+
+    private:
+        const uint8_t *m_data;
+        size_t m_size;
+        size_t m_pos;
+        uint64_t m_acc;
+        unsigned int m_nbits;
+    };
+
+/*! \param precision Grid spacing as a fraction of the box length
+    \returns Number of bits needed for a grid spacing no larger than precision
+*/
+unsigned int GSDPositionCodec::getBits(Scalar precision)
+    {
+    unsigned int bits = (unsigned int)std::ceil(std::log2(Scalar(1.0) / precision));
+    return std::min(std::max(bits, 1u), max_bits);
+    }
+
+/*! \param q Grid coordinates (output, 3N values)
+    \param pos Positions (3N values)
+    \param N Number of particles
+    \param box Box the particles are in
+    \param bits Bits per coordinate
+*/
+void GSDPositionCodec::quantize(std::vector<uint32_t>& q,
+                                const float *pos,
+                                uint64_t N,
+                                const BoxDim& box,
+                                unsigned int bits)
+    {
+    const int64_t S = int64_t(1) << bits;
+    q.resize(N*3);
+
+    for (uint64_t i = 0; i < N; i++)
+        {
+        Scalar3 f = box.makeFraction(make_scalar3(pos[i*3+0], pos[i*3+1], pos[i*3+2]));
+        Scalar fc[3] = {f.x, f.y, f.z};
+        for (unsigned int c = 0; c < 3; c++)
+            {
+            // clamp rather than wrap, a particle on the upper boundary must not change its image
+            int64_t v = int64_t(std::floor(fc[c] * Scalar(S)));
+            q[i*3+c] = uint32_t(std::min(std::max(v, int64_t(0)), S-1));
+            }
+        }
+    }
+
+/*! \param pos Positions (output, 3N values)
+    \param q Grid coordinates
+    \param box Box the particles are in
+    \param bits Bits per coordinate
+*/
+void GSDPositionCodec::dequantize(float *pos,
+                                  const std::vector<uint32_t>& q,
+                                  const BoxDim& box,
+                                  unsigned int bits)
+    {
+    const Scalar scale = Scalar(1.0) / Scalar(uint64_t(1) << bits);
+    const uint64_t N = q.size() / 3;
+
+    for (uint64_t i = 0; i < N; i++)
+        {
+        Scalar3 f = make_scalar3((Scalar(q[i*3+0]) + Scalar(0.5)) * scale,
+                                 (Scalar(q[i*3+1]) + Scalar(0.5)) * scale,
+                                 (Scalar(q[i*3+2]) + Scalar(0.5)) * scale);
+        Scalar3 p = box.makeCoordinates(f);
+        pos[i*3+0] = float(p.x);
+        pos[i*3+1] = float(p.y);
+        pos[i*3+2] = float(p.z);
+        }
+    }
+
+/*! \param out Encoded chunk (output)
+    \param q Grid coordinates
+    \param reference Grid coordinates of the previous frame, or NULL to write a key frame
+    \param bits Bits per coordinate
+*/
+void GSDPositionCodec::encode(std::vector<uint8_t>& out,
+                              const std::vector<uint32_t>& q,
+                              const std::vector<uint32_t> *reference,
+                              unsigned int bits)
+    {
+    assert(!reference || reference->size() == q.size());
+    const uint32_t mask = uint32_t((uint64_t(1) << bits) - 1);
+    const uint32_t half = uint32_t(1) << (bits - 1);
+    const uint64_t n_values = q.size();
+
+    out.resize(header_size);
+    memcpy(&out[0], codec_magic, 4);
+    out[4] = uint8_t(bits);
+    out[5] = reference ? codec_flag_delta : 0;
+    out[6] = out[7] = 0;
+    uint64_t N = n_values / 3;
+    memcpy(&out[8], &N, sizeof(uint64_t));
+
+    // a rough guess, most values need less than one byte
+    out.reserve(header_size + n_values);
+
+    BitWriter writer(out);
+    uint32_t block[block_size];
+    for (uint64_t start = 0; start < n_values; start += block_size)
+        {
+        unsigned int n = (unsigned int)std::min(uint64_t(block_size), n_values - start);
+
+        // zig-zag encode the difference to the reference, taken modulo the grid size
+        uint64_t sum = 0;
+        for (unsigned int j = 0; j < n; j++)
+            {
+            uint32_t r = reference ? (*reference)[start+j] : 0;
+            uint32_t d = (q[start+j] - r) & mask;
+            int32_t s = (d & half) ? int32_t(d) - int32_t(mask) - 1 : int32_t(d);
+            block[j] = (uint32_t(s) << 1) ^ uint32_t(s >> 31);
+            sum += block[j];
+            }
+
+        // choose the Rice parameter that fits the block mean
+        unsigned int k = 0;
+        while (k < bits && (uint64_t(n) << (k+1)) <= sum)
+            k++;
+        writer.put(k, 5);
+
+        for (unsigned int j = 0; j < n; j++)
+            {
+            uint32_t quotient = block[j] >> k;
+            if (quotient < escape)
+                {
+                writer.put((uint32_t(1) << quotient) - 1, quotient);
+                writer.put(0, 1);
+                writer.put(block[j], k);
+                }
+            else
+                {
+                writer.put((uint32_t(1) << escape) - 1, escape);
+                writer.put(block[j], bits);
+                }
+            }
+        }
+    writer.flush();
+    }
+
+/*! \param data Encoded chunk
+    \param size Size of the encoded chunk in bytes
+    \returns True if the chunk stores differences to the previous frame
+*/
+bool GSDPositionCodec::isDelta(const uint8_t *data, size_t size)
+    {
+    if (size < header_size || memcmp(data, codec_magic, 4) != 0)
+        throw runtime_error("GSD: Invalid compressed position chunk");
+    return (data[5] & codec_flag_delta) != 0;
+    }
+
+/*! \param q Grid coordinates. For delta frames, holds the grid coordinates of the previous frame on input.
+    \param data Encoded chunk
+    \param size Size of the encoded chunk in bytes
+    \param bits Bits per coordinate (output)
+*/
+void GSDPositionCodec::decode(std::vector<uint32_t>& q, const uint8_t *data, size_t size, unsigned int& bits)
+    {
+    bool delta = isDelta(data, size);
+    bits = data[4];
+    if (bits < 1 || bits > max_bits)
+        throw runtime_error("GSD: Invalid compressed position chunk");
+
+    uint64_t N;
+    memcpy(&N, data+8, sizeof(uint64_t));
+    const uint64_t n_values = N*3;
+
+    if (delta)
+        {
+        if (q.size() != n_values)
+            throw runtime_error("GSD: Compressed positions do not match the previous frame");
+        }
+    else
+        {
+        q.assign(n_values, 0);
+        }
+
+    const uint32_t mask = uint32_t((uint64_t(1) << bits) - 1);
+    BitReader reader(data + header_size, size - header_size);
+    for (uint64_t start = 0; start < n_values; start += block_size)
+        {
+        unsigned int n = (unsigned int)std::min(uint64_t(block_size), n_values - start);
+        unsigned int k = reader.get(5);
+        if (k > bits)
+            throw runtime_error("GSD: Invalid compressed position chunk");
+
+        for (unsigned int j = 0; j < n; j++)
+            {
+            unsigned int quotient = reader.getUnary(escape);
+            uint32_t u;
+            if (quotient < escape)
+                u = (uint32_t(quotient) << k) | reader.get(k);
+            else
+                u = reader.get(bits);
+
+            // undo the zig-zag encoding, the sum wraps modulo the grid size
+            uint32_t d = (u >> 1) ^ (0u - (u & 1));
+            q[start+j] = (q[start+j] + d) & mask;
+            }
+        }
+    }
+
+    } // namespace detail
+    } // namespace hoomd
@@ -0,0 +1,89 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#pragma once
+
+#include "BoxDim.h"
+
+#include <vector>
+#include <stdint.h>
+#include <stddef.h>
+
+/*! \file GSDPositionCodec.h
+    \brief Declares the GSDPositionCodec class
+*/
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#include <pybind11/pybind11.h>
+
+namespace hoomd
+    {
+namespace detail
+    {
+//! Compressed encoding of particle positions in GSD files
+/*! Positions are quantized to a grid of 2^bits cells along each box vector. The grid coordinates are stored either
+    directly (key frames) or as differences to the grid coordinates of the previous frame (delta frames). Differences
+    are taken modulo the grid size, so particles that cross a periodic boundary still produce small values.
+
+    The values are mapped to unsigned integers (zig-zag encoding) and written with an adaptive Rice code: each block
+    of 64 values stores the Rice parameter that fits its mean, and values far above the mean are escaped and stored
+    with a fixed number of bits. Rice codes are close to optimal for the geometric distribution of small differences
+    and decode at a rate of several hundred million values per second.
+
+    An encoded chunk is a byte array:
+    - 4 bytes magic "HQP1"
+    - uint8 bits per coordinate
+    - uint8 flags (1 for delta frames)
+    - 2 bytes reserved
+    - uint64 number of particles
+    - the Rice coded bit stream of the 3N values (x, y, z of each particle)
+*/
+class PYBIND11_EXPORT GSDPositionCodec
+    {
+    public:
+        //! Get the number of bits per coordinate needed to resolve the given fraction of the box length
+        static unsigned int getBits(Scalar precision);
+
+        //! Quantize positions to grid coordinates
+        static void quantize(std::vector<uint32_t>& q,
+                             const float *pos,
+                             uint64_t N,
+                             const BoxDim& box,
+                             unsigned int bits);
+
+        //! Convert grid coordinates to positions (at the center of the grid cell)
+        static void dequantize(float *pos,
+                               const std::vector<uint32_t>& q,
+                               const BoxDim& box,
+                               unsigned int bits);
+
+        //! Encode grid coordinates
+        static void encode(std::vector<uint8_t>& out,
+                           const std::vector<uint32_t>& q,
+                           const std::vector<uint32_t> *reference,
+                           unsigned int bits);
+
+        //! Check if an encoded chunk is a delta frame
+        static bool isDelta(const uint8_t *data, size_t size);
+
+        //! Decode grid coordinates
+        static void decode(std::vector<uint32_t>& q, const uint8_t *data, size_t size, unsigned int& bits);
+
+        //! Number of values per block that share a Rice parameter
+        static const unsigned int block_size = 64;
+
+        //! Quotients at or above this value are escaped
+        static const unsigned int escape = 24;
+
+        //! Size of the chunk header in bytes
+        static const size_t header_size = 16;
+
+        //! Largest supported number of bits per coordinate
+        static const unsigned int max_bits = 24;
+    };
+
+    } // namespace detail
+    } // namespace hoomd
@@ -3,6 +3,7 @@
 
 #include "GSD.h"
 #include "GSDReader.h"
+#include "GSDPositionCodec.h"
 #include "SnapshotSystemData.h"
 #include "ExecutionConfiguration.h"
 #include "hoomd/extern/gsd.h"
@@ -19,21 +20,26 @@ namespace py = pybind11;
     \param name File name to read
     \param frame Frame index to read from the file
     \param from_end Count frames back from the end of the file
+    \param distributed Read a slice of the frame on every rank
 
     The GSDReader constructor opens the GSD file, initializes an empty snapshot, and reads the file into
-    memory (on the root rank).
+    memory (on the root rank, or a slice on every rank in a distributed read).
 */
 GSDReader::GSDReader(std::shared_ptr<const ExecutionConfiguration> exec_conf,
                      const std::string &name,
                      const uint64_t frame,
-                     bool from_end)
-    : m_exec_conf(exec_conf), m_timestep(0), m_name(name), m_frame(frame)
+                     bool from_end,
+                     bool distributed)
+    : m_exec_conf(exec_conf), m_timestep(0), m_name(name), m_frame(frame), m_distributed(false),
+      m_n_particles(0)
     {
     m_snapshot = std::shared_ptr< SnapshotSystemData<float> >(new SnapshotSystemData<float>);
 
     #ifdef ENABLE_MPI
-    // if we are not the root processor, do not perform file I/O
-    if (!m_exec_conf->isRoot())
+    m_distributed = distributed && m_exec_conf->getNRanks() > 1;
+
+    // if we are not the root processor, do not perform file I/O unless we read a slice
+    if (!m_distributed && !m_exec_conf->isRoot())
         {
         return;
         }
@@ -68,6 +74,23 @@ GSDReader::GSDReader(std::shared_ptr<const ExecutionConfiguration> exec_conf,
         throw runtime_error("Error opening GSD file");
         }
 
+    #ifdef ENABLE_MPI
+    // compressed positions can only be decoded as a whole, read them on the root rank
+    const char *compressed_name = "hoomd/compressed/particles/position";
+    if (m_distributed && (gsd_find_chunk(&m_handle, m_frame, compressed_name) != NULL
+                          || gsd_find_chunk(&m_handle, 0, compressed_name) != NULL))
+        {
+        m_exec_conf->msg->notice(2) << "data.gsd_snapshot: " << name
+                                    << " stores compressed positions, reading the frame on the root rank" << endl;
+        m_distributed = false;
+        if (!m_exec_conf->isRoot())
+            {
+            gsd_close(&m_handle);
+            return;
+            }
+        }
+    #endif
+
     readHeader();
     readParticles();
     readTopology();
@@ -77,7 +100,7 @@ GSDReader::~GSDReader()
     {
     #ifdef ENABLE_MPI
     // if we are not the root processor, do not perform file I/O
-    if (!m_exec_conf->isRoot())
+    if (!m_distributed && !m_exec_conf->isRoot())
         {
         return;
         }
@@ -127,6 +150,76 @@ bool GSDReader::readChunk(void *data, uint64_t frame, const char *name, size_t e
         }
     }
 
+/*! \param N Number of rows in the chunk
+    \param begin First row read by this rank
+    \param end One past the last row read by this rank
+
+    In a distributed read, the rows are split into contiguous slices in rank order. Otherwise, the root rank reads all
+    rows.
+*/
+void GSDReader::getSlice(uint64_t N, uint64_t& begin, uint64_t& end) const
+    {
+    begin = 0;
+    end = N;
+
+    #ifdef ENABLE_MPI
+    if (m_distributed)
+        {
+        uint64_t rank = m_exec_conf->getRank();
+        uint64_t n_ranks = m_exec_conf->getNRanks();
+        begin = N * rank / n_ranks;
+        end = N * (rank + 1) / n_ranks;
+        }
+    #endif
+    }
+
+/*! \param data Pointer to data to read into, with room for the rows of this rank
+    \param frame Frame index to read from
+    \param name Name of the data chunk
+    \param row_size Expected size of one row in bytes
+    \param cur_n N in the current frame.
+
+    Like readChunk(), but reads only the rows given by getSlice(). The rows of a chunk are contiguous in the file, so
+    every rank reads its slice directly.
+*/
+bool GSDReader::readSlice(void *data, uint64_t frame, const char *name, size_t row_size, uint64_t cur_n)
+    {
+    const struct gsd_index_entry* entry = gsd_find_chunk(&m_handle, frame, name);
+    if (entry == NULL && frame != 0)
+        entry = gsd_find_chunk(&m_handle, 0, name);
+
+    if (entry == NULL || entry->N != cur_n)
+        {
+        m_exec_conf->msg->notice(10) << "data.gsd_snapshot: chunk not found " << name << endl;
+        return false;
+        }
+
+    m_exec_conf->msg->notice(7) << "data.gsd_snapshot: reading chunk " << name << endl;
+    size_t actual_size = entry->M * gsd_sizeof_type((enum gsd_type)entry->type);
+    if (actual_size != row_size)
+        {
+        m_exec_conf->msg->error() << "data.gsd_snapshot: " << "Expecting " << row_size*cur_n << " bytes in " << name
+                                  << " but found " << actual_size*entry->N << endl;
+        throw runtime_error("Error reading GSD file");
+        }
+
+    uint64_t begin, end;
+    getSlice(cur_n, begin, end);
+
+    // ranks with an empty slice have nothing to read
+    if (end > begin)
+        {
+        struct gsd_index_entry slice = *entry;
+        slice.location += begin * row_size;
+        slice.N = end - begin;
+
+        int retval = gsd_read_chunk(&m_handle, data, &slice);
+        GSDUtils::checkError(retval, m_name);
+        }
+
+    return true;
+    }
+
 /*! \param frame Frame index to read from
     \param name Name of the data chunk
 
@@ -169,6 +262,65 @@ std::vector<std::string> GSDReader::readTypes(uint64_t frame, const char *name)
         }
     }
 
+/*! \param frame Frame index to read from
+    \param cur_n N in the current frame.
+
+    Attempts to read the compressed positions at the given frame. Compressed positions in delta frames are decoded
+    starting from the preceding key frame. Return false if there are no compressed positions at this frame, or
+    their number does not match the current N.
+*/
+bool GSDReader::readCompressedPositions(uint64_t frame, unsigned int cur_n)
+    {
+    const char *name = "hoomd/compressed/particles/position";
+    if (gsd_find_chunk(&m_handle, frame, name) == NULL)
+        return false;
+
+    m_exec_conf->msg->notice(7) << "data.gsd_snapshot: reading chunk " << name << endl;
+
+    // walk back to the key frame
+    std::vector< std::vector<uint8_t> > chain;
+    uint64_t cur_frame = frame;
+    while (true)
+        {
+        const struct gsd_index_entry* entry = gsd_find_chunk(&m_handle, cur_frame, name);
+        if (entry == NULL)
+            {
+            m_exec_conf->msg->error() << "data.gsd_snapshot: " << "Missing compressed positions in frame "
+                                      << cur_frame << endl;
+            throw runtime_error("Error reading GSD file");
+            }
+
+        chain.push_back(std::vector<uint8_t>(entry->N * entry->M * gsd_sizeof_type((enum gsd_type)entry->type)));
+        int retval = gsd_read_chunk(&m_handle, &chain.back()[0], entry);
+        GSDUtils::checkError(retval, m_name);
+
+        if (!GSDPositionCodec::isDelta(&chain.back()[0], chain.back().size()))
+            break;
+
+        if (cur_frame == 0)
+            {
+            m_exec_conf->msg->error() << "data.gsd_snapshot: " << "Compressed positions have no key frame" << endl;
+            throw runtime_error("Error reading GSD file");
+            }
+        cur_frame--;
+        }
+
+    // decode forward from the key frame
+    std::vector<uint32_t> grid;
+    unsigned int bits = 0;
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+        GSDPositionCodec::decode(grid, &(*it)[0], it->size(), bits);
+
+    if (grid.size() != uint64_t(cur_n)*3)
+        {
+        m_exec_conf->msg->notice(10) << "data.gsd_snapshot: chunk not found " << name << endl;
+        return false;
+        }
+
+    GSDPositionCodec::dequantize((float *)&m_snapshot->particle_data.pos[0], grid, m_snapshot->global_box, bits);
+    return true;
+    }
+
 /*! Read the same data chunks written by GSDDumpWriter::writeFrameHeader
 */
 void GSDReader::readHeader()
@@ -191,86 +343,106 @@ void GSDReader::readHeader()
         m_exec_conf->msg->error() << "data.gsd_snapshot: " << "cannot read a file with 0 particles" << endl;
         throw runtime_error("Error reading GSD file");
         }
-    m_snapshot->particle_data.resize(N);
+
+    m_n_particles = N;
+
+    uint64_t begin, end;
+    getSlice(N, begin, end);
+    m_snapshot->particle_data.resize(end - begin);
     }
 
 /*! Read the same data chunks for particles
 */
 void GSDReader::readParticles()
     {
-    uint64_t N = m_snapshot->particle_data.size;
+    uint64_t N = m_n_particles;
     m_snapshot->particle_data.type_mapping = readTypes(m_frame, "particles/types");
 
     // the snapshot already has default values, if a chunk is not found, the value
     // is already at the default, and the failed read is not a problem
-    readChunk(&m_snapshot->particle_data.type[0], m_frame, "particles/typeid", N*4, N);
-    readChunk(&m_snapshot->particle_data.mass[0], m_frame, "particles/mass", N*4, N);
-    readChunk(&m_snapshot->particle_data.charge[0], m_frame, "particles/charge", N*4, N);
-    readChunk(&m_snapshot->particle_data.diameter[0], m_frame, "particles/diameter", N*4, N);
-    readChunk(&m_snapshot->particle_data.body[0], m_frame, "particles/body", N*4, N);
-    readChunk(&m_snapshot->particle_data.inertia[0], m_frame, "particles/moment_inertia", N*12, N);
-    readChunk(&m_snapshot->particle_data.pos[0], m_frame, "particles/position", N*12, N);
-    readChunk(&m_snapshot->particle_data.orientation[0], m_frame, "particles/orientation", N*16, N);
-    readChunk(&m_snapshot->particle_data.vel[0], m_frame, "particles/velocity", N*12, N);
-    readChunk(&m_snapshot->particle_data.angmom[0], m_frame, "particles/angmom", N*16, N);
-    readChunk(&m_snapshot->particle_data.image[0], m_frame, "particles/image", N*12, N);
+    readSlice(m_snapshot->particle_data.type.data(), m_frame, "particles/typeid", 4, N);
+    readSlice(m_snapshot->particle_data.mass.data(), m_frame, "particles/mass", 4, N);
+    readSlice(m_snapshot->particle_data.charge.data(), m_frame, "particles/charge", 4, N);
+    readSlice(m_snapshot->particle_data.diameter.data(), m_frame, "particles/diameter", 4, N);
+    readSlice(m_snapshot->particle_data.body.data(), m_frame, "particles/body", 4, N);
+    readSlice(m_snapshot->particle_data.inertia.data(), m_frame, "particles/moment_inertia", 12, N);
+
+    // positions written by GSDDumpWriter with a position precision are compressed, and take precedence over frame 0
+    if (!readCompressedPositions(m_frame, N)
+        && !readSlice(m_snapshot->particle_data.pos.data(), m_frame, "particles/position", 12, N)
+        && m_frame != 0)
+        {
+        readCompressedPositions(0, N);
+        }
+
+    readSlice(m_snapshot->particle_data.orientation.data(), m_frame, "particles/orientation", 16, N);
+    readSlice(m_snapshot->particle_data.vel.data(), m_frame, "particles/velocity", 12, N);
+    readSlice(m_snapshot->particle_data.angmom.data(), m_frame, "particles/angmom", 16, N);
+    readSlice(m_snapshot->particle_data.image.data(), m_frame, "particles/image", 12, N);
     }
 
 /*! Read the same data chunks for topology
 */
 void GSDReader::readTopology()
     {
-    uint64_t N = 0;
+    uint64_t begin, end;
+
+    unsigned int N = 0;
     readChunk(&N, m_frame, "bonds/N", 4);
     if (N > 0)
         {
-        m_snapshot->bond_data.resize(N);
+        getSlice(N, begin, end);
+        m_snapshot->bond_data.resize(end - begin);
         m_snapshot->bond_data.type_mapping = readTypes(m_frame, "bonds/types");
-        readChunk(&m_snapshot->bond_data.type_id[0], m_frame, "bonds/typeid", N*4, N);
-        readChunk(&m_snapshot->bond_data.groups[0], m_frame, "bonds/group", N*8, N);
+        readSlice(m_snapshot->bond_data.type_id.data(), m_frame, "bonds/typeid", 4, N);
+        readSlice(m_snapshot->bond_data.groups.data(), m_frame, "bonds/group", 8, N);
         }
 
     N = 0;
     readChunk(&N, m_frame, "angles/N", 4);
     if (N > 0)
         {
-        m_snapshot->angle_data.resize(N);
+        getSlice(N, begin, end);
+        m_snapshot->angle_data.resize(end - begin);
         m_snapshot->angle_data.type_mapping = readTypes(m_frame, "angles/types");
-        readChunk(&m_snapshot->angle_data.type_id[0], m_frame, "angles/typeid", N*4, N);
-        readChunk(&m_snapshot->angle_data.groups[0], m_frame, "angles/group", N*12, N);
+        readSlice(m_snapshot->angle_data.type_id.data(), m_frame, "angles/typeid", 4, N);
+        readSlice(m_snapshot->angle_data.groups.data(), m_frame, "angles/group", 12, N);
         }
 
     N = 0;
     readChunk(&N, m_frame, "dihedrals/N", 4);
     if (N > 0)
         {
-        m_snapshot->dihedral_data.resize(N);
+        getSlice(N, begin, end);
+        m_snapshot->dihedral_data.resize(end - begin);
         m_snapshot->dihedral_data.type_mapping = readTypes(m_frame, "dihedrals/types");
-        readChunk(&m_snapshot->dihedral_data.type_id[0], m_frame, "dihedrals/typeid", N*4, N);
-        readChunk(&m_snapshot->dihedral_data.groups[0], m_frame, "dihedrals/group", N*16, N);
+        readSlice(m_snapshot->dihedral_data.type_id.data(), m_frame, "dihedrals/typeid", 4, N);
+        readSlice(m_snapshot->dihedral_data.groups.data(), m_frame, "dihedrals/group", 16, N);
         }
 
     N = 0;
     readChunk(&N, m_frame, "impropers/N", 4);
     if (N > 0)
         {
-        m_snapshot->improper_data.resize(N);
+        getSlice(N, begin, end);
+        m_snapshot->improper_data.resize(end - begin);
         m_snapshot->improper_data.type_mapping = readTypes(m_frame, "impropers/types");
-        readChunk(&m_snapshot->improper_data.type_id[0], m_frame, "impropers/typeid", N*4, N);
-        readChunk(&m_snapshot->improper_data.groups[0], m_frame, "impropers/group", N*16, N);
+        readSlice(m_snapshot->improper_data.type_id.data(), m_frame, "impropers/typeid", 4, N);
+        readSlice(m_snapshot->improper_data.groups.data(), m_frame, "impropers/group", 16, N);
         }
 
     N = 0;
     readChunk(&N, m_frame, "constraints/N", 4);
     if (N > 0)
         {
-        m_snapshot->constraint_data.resize(N);
-        std::vector<float> data(N);
-        readChunk(&data[0], m_frame, "constraints/value", N*4, N);
-        for (unsigned int i=0; i < N; i++)
+        getSlice(N, begin, end);
+        m_snapshot->constraint_data.resize(end - begin);
+        std::vector<float> data(end - begin);
+        readSlice(data.data(), m_frame, "constraints/value", 4, N);
+        for (unsigned int i=0; i < end - begin; i++)
             m_snapshot->constraint_data.val[i] = Scalar(data[i]);
 
-        readChunk(&m_snapshot->constraint_data.groups[0], m_frame, "constraints/group", N*8, N);
+        readSlice(m_snapshot->constraint_data.groups.data(), m_frame, "constraints/group", 8, N);
         }
 
     if (m_handle.header.schema_version >= gsd_make_version(1,1))
@@ -279,10 +451,11 @@ void GSDReader::readTopology()
         readChunk(&N, m_frame, "pairs/N", 4);
         if (N > 0)
             {
-            m_snapshot->pair_data.resize(N);
+            getSlice(N, begin, end);
+            m_snapshot->pair_data.resize(end - begin);
             m_snapshot->pair_data.type_mapping = readTypes(m_frame, "pairs/types");
-            readChunk(&m_snapshot->pair_data.type_id[0], m_frame, "pairs/typeid", N*4, N);
-            readChunk(&m_snapshot->pair_data.groups[0], m_frame, "pairs/group", N*8, N);
+            readSlice(m_snapshot->pair_data.type_id.data(), m_frame, "pairs/typeid", 4, N);
+            readSlice(m_snapshot->pair_data.groups.data(), m_frame, "pairs/group", 8, N);
             }
         }
     }
@@ -444,9 +617,11 @@ void export_GSDReader(py::module& m)
     {
     py::class_< GSDReader, std::shared_ptr<GSDReader> >(m,"GSDReader")
     .def(py::init<std::shared_ptr<const ExecutionConfiguration>, const string&, const uint64_t, bool>())
+    .def(py::init<std::shared_ptr<const ExecutionConfiguration>, const string&, const uint64_t, bool, bool>())
     .def("getTimeStep", &GSDReader::getTimeStep)
     .def("getSnapshot", &GSDReader::getSnapshot)
     .def("clearSnapshot", &GSDReader::clearSnapshot)
+    .def("isDistributed", &GSDReader::isDistributed)
     .def("readTypeShapesPy", &GSDReader::readTypeShapesPy)
     ;
 
@@ -22,6 +22,11 @@ template <class Real> struct SnapshotSystemData;
 /*! Read an input GSD file and generate a system snapshot. GSDReader can read any frame from a GSD
     file into the snapshot. For information on the GSD specification, see http://gsd.readthedocs.io/
 
+    By default, only the root rank reads the file. In a distributed read, every rank opens the file and reads a
+    contiguous slice of the particles and of each kind of bonded group into its snapshot, to be passed to
+    SystemDefinition::initializeFromDistributedSnapshot(). Frames with compressed positions are always read on the root
+    rank, because the positions can only be decoded as a whole.
+
     \ingroup data_structs
 */
 class PYBIND11_EXPORT GSDReader
@@ -31,7 +36,8 @@ class PYBIND11_EXPORT GSDReader
         GSDReader(std::shared_ptr<const ExecutionConfiguration> exec_conf,
                   const std::string &name,
                   const uint64_t frame,
-                  bool from_end);
+                  bool from_end,
+                  bool distributed=false);
 
         //! Destructor
         ~GSDReader();
@@ -62,6 +68,12 @@ class PYBIND11_EXPORT GSDReader
             return m_frame;
             }
 
+        //! Returns true when every rank holds a slice of the system in its snapshot
+        bool isDistributed() const
+            {
+            return m_distributed;
+            }
+
         //! Helper function to read a quantity from the file
         bool readChunk(void *data, uint64_t frame, const char *name, size_t expected_size, unsigned int cur_n=0);
 
@@ -86,10 +98,21 @@ class PYBIND11_EXPORT GSDReader
         uint64_t m_frame;                                            //!< Cached frame
         std::shared_ptr< SnapshotSystemData<float> > m_snapshot;   //!< The snapshot to read
         gsd_handle m_handle;                                         //!< Handle to the file
+        bool m_distributed;                                          //!< True if every rank reads a slice of the frame
+        unsigned int m_n_particles;                                  //!< Number of particles in the frame
+
+        //! Helper function to find the rows of a chunk read by this rank
+        void getSlice(uint64_t N, uint64_t& begin, uint64_t& end) const;
+
+        //! Helper function to read the rows of a per-particle or per-group chunk read by this rank
+        bool readSlice(void *data, uint64_t frame, const char *name, size_t row_size, uint64_t cur_n);
 
         //! Helper function to read a type list from the file
         std::vector<std::string> readTypes(uint64_t frame, const char *name);
 
+        //! Helper function to read compressed positions from the file
+        bool readCompressedPositions(uint64_t frame, unsigned int cur_n);
+
         // helper functions to read sections of the file
         void readHeader();
         void readParticles();
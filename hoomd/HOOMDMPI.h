@@ -24,6 +24,8 @@
 
 #include <sstream>
 #include <vector>
+#include <type_traits>
+#include <cassert>
 
 #include <cereal/types/set.hpp>
 #include <cereal/types/string.hpp>
@@ -416,6 +418,64 @@ void all_gather_v(const T& in_value, std::vector<T> & out_values, const MPI_Comm
     delete[] rbuf;
     }
 
+//! Wrapper around MPI_Alltoallv that exchanges vectors of plain data
+/*! \param in_values Elements to send, in_values[r] is sent to rank r
+    \param out_values Elements received from all ranks, in rank order
+    \param mpi_comm The communicator
+
+    Unlike the other wrappers, the elements are not serialized but sent as raw bytes, so this is suitable for
+    large buffers of trivially copyable types, such as pdata_element.
+*/
+template<typename T>
+void all_to_all_v(const std::vector< std::vector<T> >& in_values, std::vector<T>& out_values, const MPI_Comm mpi_comm)
+    {
+    static_assert(std::is_trivially_copyable<T>::value, "all_to_all_v requires a trivially copyable type");
+
+    int size;
+    MPI_Comm_size(mpi_comm, &size);
+    assert(in_values.size() == (unsigned int) size);
+
+    std::vector<int> send_counts(size);
+    std::vector<int> send_displs(size);
+    std::vector<int> recv_counts(size);
+    std::vector<int> recv_displs(size);
+
+    // pack the send buffer
+    unsigned int n_send = 0;
+    for (unsigned int i = 0; i < (unsigned int) size; i++)
+        {
+        send_displs[i] = n_send;
+        send_counts[i] = in_values[i].size();
+        n_send += in_values[i].size();
+        }
+
+    std::vector<T> send_buf;
+    send_buf.reserve(n_send);
+    for (unsigned int i = 0; i < (unsigned int) size; i++)
+        send_buf.insert(send_buf.end(), in_values[i].begin(), in_values[i].end());
+
+    // exchange the number of elements
+    MPI_Alltoall(&send_counts.front(), 1, MPI_INT, &recv_counts.front(), 1, MPI_INT, mpi_comm);
+
+    unsigned int n_recv = 0;
+    for (unsigned int i = 0; i < (unsigned int) size; i++)
+        {
+        recv_displs[i] = n_recv;
+        n_recv += recv_counts[i];
+        }
+    out_values.resize(n_recv);
+
+    // count in elements rather than bytes, so large buffers do not overflow the int arguments
+    MPI_Datatype mpi_type;
+    MPI_Type_contiguous(sizeof(T), MPI_BYTE, &mpi_type);
+    MPI_Type_commit(&mpi_type);
+
+    MPI_Alltoallv(send_buf.data(), &send_counts.front(), &send_displs.front(), mpi_type,
+                  out_values.data(), &recv_counts.front(), &recv_displs.front(), mpi_type, mpi_comm);
+
+    MPI_Type_free(&mpi_type);
+    }
+
 //! Wrapper around MPI_Send that handles any serializable object
 template<typename T>
 void send(const T& val,const unsigned int dest, const MPI_Comm mpi_comm)
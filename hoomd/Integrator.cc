@@ -13,6 +13,11 @@ namespace py = pybind11;
 #include "Communicator.h"
 #endif
 
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
+
 #include <pybind11/stl_bind.h>
 PYBIND11_MAKE_OPAQUE(std::vector<std::shared_ptr<ForceConstraint> >);
 PYBIND11_MAKE_OPAQUE(std::vector<std::shared_ptr<ForceCompute> >);
@@ -22,7 +27,8 @@ using namespace std;
 /** @param sysdef System to update
     @param deltaT Time step to use
 */
-Integrator::Integrator(std::shared_ptr<SystemDefinition> sysdef, Scalar deltaT) : Updater(sysdef), m_deltaT(deltaT)
+Integrator::Integrator(std::shared_ptr<SystemDefinition> sysdef, Scalar deltaT)
+    : Updater(sysdef), m_deltaT(deltaT), m_fused_net_force(false), m_concurrent_forces(false)
     {
     if (m_deltaT <= 0.0)
         m_exec_conf->msg->warning() << "integrate.*: A timestep of less than 0.0 was specified" << endl;
@@ -97,6 +103,32 @@ void Integrator::setDeltaT(Scalar deltaT)
      m_deltaT = deltaT;
     }
 
+/** @param fused True if forces should be added directly to the net force
+*/
+void Integrator::setFusedNetForce(bool fused)
+    {
+    if (fused && m_exec_conf->isCUDAEnabled())
+        {
+        m_exec_conf->msg->error() << "integrate.*: Fused net force accumulation is only supported on the CPU" << endl;
+        throw runtime_error("Error setting fused net force");
+        }
+
+    m_fused_net_force = fused;
+    }
+
+/** @param concurrent True if independent forces should be computed concurrently
+*/
+void Integrator::setConcurrentForces(bool concurrent)
+    {
+    if (concurrent && m_exec_conf->isCUDAEnabled())
+        {
+        m_exec_conf->msg->error() << "integrate.*: Concurrent force computes are only supported on the CPU" << endl;
+        throw runtime_error("Error setting concurrent forces");
+        }
+
+    m_concurrent_forces = concurrent;
+    }
+
 /** \return the timestep deltaT
 */
 Scalar Integrator::getDeltaT()
@@ -308,8 +340,49 @@ Scalar Integrator::computeTotalMomentum(unsigned int timestep)
 void Integrator::computeNetForce(unsigned int timestep)
     {
     std::vector< std::shared_ptr<ForceCompute> >::iterator force_compute;
-    for (force_compute = m_forces.begin(); force_compute != m_forces.end(); ++force_compute)
-        (*force_compute)->compute(timestep);
+
+    if (m_fused_net_force)
+        {
+        // the force computes add to the net force arrays, so they have to be zeroed first
+            {
+            const GlobalArray<Scalar4>& net_force  = m_pdata->getNetForce();
+            const GlobalArray<Scalar>&  net_virial = m_pdata->getNetVirial();
+            const GlobalArray<Scalar4>& net_torque = m_pdata->getNetTorqueArray();
+            ArrayHandle<Scalar4> h_net_force(net_force, access_location::host, access_mode::overwrite);
+            ArrayHandle<Scalar> h_net_virial(net_virial, access_location::host, access_mode::overwrite);
+            ArrayHandle<Scalar4> h_net_torque(net_torque, access_location::host, access_mode::overwrite);
+
+            memset((void *)h_net_force.data, 0, sizeof(Scalar4)*net_force.getNumElements());
+            memset((void *)h_net_virial.data, 0, sizeof(Scalar)*net_virial.getNumElements());
+            memset((void *)h_net_torque.data, 0, sizeof(Scalar4)*net_torque.getNumElements());
+            }
+
+        for (force_compute = m_forces.begin(); force_compute != m_forces.end(); ++force_compute)
+            (*force_compute)->setAccumulateNetForce(true);
+        }
+
+    #ifdef ENABLE_MPI
+    if (m_comm && m_comm->isGhostUpdatePending())
+        {
+        // compute the forces that do not depend on ghost particles while the ghost update is in flight
+        for (force_compute = m_forces.begin(); force_compute != m_forces.end(); ++force_compute)
+            (*force_compute)->computeInterior(timestep);
+
+        m_comm->finishUpdateGhosts(timestep);
+        }
+    #endif
+
+    #ifdef ENABLE_TBB
+    if (m_concurrent_forces && m_exec_conf->getNumThreads() > 1)
+        {
+        computeForcesConcurrently(timestep);
+        }
+    else
+    #endif
+        {
+        for (force_compute = m_forces.begin(); force_compute != m_forces.end(); ++force_compute)
+            (*force_compute)->compute(timestep);
+        }
 
     if (m_prof)
         {
@@ -324,14 +397,18 @@ void Integrator::computeNetForce(unsigned int timestep)
         const GlobalArray<Scalar4>& net_force  = m_pdata->getNetForce();
         const GlobalArray<Scalar>&  net_virial = m_pdata->getNetVirial();
         const GlobalArray<Scalar4>& net_torque = m_pdata->getNetTorqueArray();
-        ArrayHandle<Scalar4> h_net_force(net_force, access_location::host, access_mode::overwrite);
-        ArrayHandle<Scalar> h_net_virial(net_virial, access_location::host, access_mode::overwrite);
-        ArrayHandle<Scalar4> h_net_torque(net_torque, access_location::host, access_mode::overwrite);
+        const access_mode::Enum net_mode = m_fused_net_force ? access_mode::readwrite : access_mode::overwrite;
+        ArrayHandle<Scalar4> h_net_force(net_force, access_location::host, net_mode);
+        ArrayHandle<Scalar> h_net_virial(net_virial, access_location::host, net_mode);
+        ArrayHandle<Scalar4> h_net_torque(net_torque, access_location::host, net_mode);
 
-        // start by zeroing the net force and virial arrays
-        memset((void *)h_net_force.data, 0, sizeof(Scalar4)*net_force.getNumElements());
-        memset((void *)h_net_virial.data, 0, sizeof(Scalar)*net_virial.getNumElements());
-        memset((void *)h_net_torque.data, 0, sizeof(Scalar4)*net_torque.getNumElements());
+        // start by zeroing the net force and virial arrays, unless the forces have already been added
+        if (!m_fused_net_force)
+            {
+            memset((void *)h_net_force.data, 0, sizeof(Scalar4)*net_force.getNumElements());
+            memset((void *)h_net_virial.data, 0, sizeof(Scalar)*net_virial.getNumElements());
+            memset((void *)h_net_torque.data, 0, sizeof(Scalar4)*net_torque.getNumElements());
+            }
 
         for (unsigned int i = 0; i < 6; ++i)
            external_virial[i] = Scalar(0.0);
@@ -349,6 +426,15 @@ void Integrator::computeNetForce(unsigned int timestep)
 
         for (force_compute = m_forces.begin(); force_compute != m_forces.end(); ++force_compute)
             {
+            for (unsigned int k = 0; k < 6; k++)
+                external_virial[k] += (*force_compute)->getExternalVirial(k);
+
+            external_energy += (*force_compute)->getExternalEnergy();
+
+            // skip forces that have already been added to the net force
+            if ((*force_compute)->isNetForceAccumulated())
+                continue;
+
             GlobalArray<Scalar4>& h_force_array = (*force_compute)->getForceArray();
             GlobalArray<Scalar>& h_virial_array = (*force_compute)->getVirialArray();
             GlobalArray<Scalar4>& h_torque_array = (*force_compute)->getTorqueArray();
@@ -379,14 +465,15 @@ void Integrator::computeNetForce(unsigned int timestep)
                     h_net_virial.data[k*net_virial_pitch+j] += h_virial.data[k*virial_pitch+j];
                     }
                 }
-
-            for (unsigned int k = 0; k < 6; k++)
-                external_virial[k] += (*force_compute)->getExternalVirial(k);
-
-            external_energy += (*force_compute)->getExternalEnergy();
             }
         }
 
+    if (m_fused_net_force)
+        {
+        for (force_compute = m_forces.begin(); force_compute != m_forces.end(); ++force_compute)
+            (*force_compute)->setAccumulateNetForce(false);
+        }
+
     for (unsigned int k = 0; k < 6; k++)
         m_pdata->setExternalVirial(k, external_virial[k]);
 
@@ -484,6 +571,90 @@ void Integrator::computeNetForce(unsigned int timestep)
         }
     }
 
+#ifdef ENABLE_TBB
+/** @param timestep Current time step of the simulation
+
+    Force computes that cannot run concurrently are computed first, in order. Next, the computes and other data that
+    the others depend on, such as a shared neighbor list or the bonded group tables, are brought up to date. The
+    remaining force computes then run as concurrent tasks. Each writes to its own arrays, except for those that add
+    to the net force arrays, which share one task. Every force compute gets the same result as in sequence, so the
+    net force does not depend on the number of threads. In MPI simulations, the wall time of the concurrent section
+    is added once to the work time used for load balancing.
+*/
+void Integrator::computeForcesConcurrently(unsigned int timestep)
+    {
+    std::vector< std::shared_ptr<ForceCompute> > concurrent;
+    for (auto& fc : m_forces)
+        {
+        if (fc->canComputeConcurrently())
+            concurrent.push_back(fc);
+        else
+            fc->compute(timestep);
+        }
+
+    for (auto& fc : concurrent)
+        {
+        std::vector< std::shared_ptr<Compute> > dependencies = fc->getDependencies();
+        for (auto& dependency : dependencies)
+            dependency->compute(timestep);
+        fc->prepareConcurrentCompute(timestep);
+        }
+
+    // the first task computes the forces that add to the net force arrays, in order
+    std::vector< std::vector<unsigned int> > tasks(1);
+    for (unsigned int i = 0; i < concurrent.size(); ++i)
+        {
+        if (concurrent[i]->getAccumulateNetForce())
+            tasks[0].push_back(i);
+        else
+            tasks.push_back(std::vector<unsigned int>(1, i));
+        }
+
+    if (m_prof)
+        {
+        m_prof->push("Concurrent forces");
+        m_prof->beginConcurrent();
+        }
+
+    #ifdef ENABLE_MPI
+    // the tasks overlap in time, so the work time of the whole section is recorded once on this thread
+    for (auto& fc : concurrent)
+        fc->setRecordWorkTime(false);
+    ClockSource section_clk;
+    #endif
+
+    std::vector<int64_t> elapsed_time(concurrent.size(), 0);
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, (unsigned int)tasks.size(), 1),
+        [&](const tbb::blocked_range<unsigned int>& r)
+        {
+        for (unsigned int t = r.begin(); t != r.end(); ++t)
+            {
+            for (unsigned int i : tasks[t])
+                {
+                ClockSource clk;
+                concurrent[i]->compute(timestep);
+                elapsed_time[i] = clk.getTime();
+                }
+            }
+        });
+
+    #ifdef ENABLE_MPI
+    for (auto& fc : concurrent)
+        fc->setRecordWorkTime(true);
+    if (m_comm)
+        m_comm->addWorkTime(section_clk.getTime());
+    #endif
+
+    if (m_prof)
+        {
+        m_prof->endConcurrent();
+        for (unsigned int i = 0; i < concurrent.size(); ++i)
+            m_prof->addTaskTime(concurrent[i]->getProfileName(), elapsed_time[i]);
+        m_prof->pop();
+        }
+    }
+#endif
+
 #ifdef ENABLE_HIP
 /** @param timestep Current time step of the simulation
     \post All added force computes in \a m_forces are computed and totaled up in \a m_net_force and \a m_net_virial
@@ -943,6 +1114,8 @@ void export_Integrator(py::module& m)
     .def(py::init< std::shared_ptr<SystemDefinition>, Scalar >())
     .def("updateGroupDOF", &Integrator::updateGroupDOF)
     .def_property("dt", &Integrator::getDeltaT, &Integrator::setDeltaT)
+    .def_property("fused_net_force", &Integrator::getFusedNetForce, &Integrator::setFusedNetForce)
+    .def_property("concurrent_forces", &Integrator::getConcurrentForces, &Integrator::setConcurrentForces)
 	.def_property_readonly("forces", &Integrator::getForces)
 	.def_property_readonly("constraints", &Integrator::getConstraintForces)
     ;
@@ -100,6 +100,30 @@ class PYBIND11_EXPORT Integrator : public Updater
         /// Return the timestep
         Scalar getDeltaT();
 
+        /// Set whether forces are added directly to the net force
+        /** @param fused If true, force computes that support it add their forces to the net force, virial and torque
+            instead of filling their own arrays, which are only computed when queried. Only supported on the CPU.
+        */
+        void setFusedNetForce(bool fused);
+
+        /// Returns true if forces are added directly to the net force
+        bool getFusedNetForce() const
+            {
+            return m_fused_net_force;
+            }
+
+        /// Set whether independent forces are computed concurrently
+        /** @param concurrent If true, force computes that support it are computed concurrently on multiple threads.
+            Only supported on the CPU. Force computes are computed in sequence in builds without TBB.
+        */
+        void setConcurrentForces(bool concurrent);
+
+        /// Returns true if independent forces are computed concurrently
+        bool getConcurrentForces() const
+            {
+            return m_concurrent_forces;
+            }
+
         /// Update the number of degrees of freedom for a group
         /** @param group Group to set the degrees of freedom for.
         */
@@ -166,12 +190,23 @@ class PYBIND11_EXPORT Integrator : public Updater
         /// The HalfStepHook, if active
         std::shared_ptr<HalfStepHook> m_half_step_hook;
 
+        /// True if forces are added directly to the net force
+        bool m_fused_net_force;
+
+        /// True if independent forces are computed concurrently
+        bool m_concurrent_forces;
+
         /// helper function to compute initial accelerations
         void computeAccelerations(unsigned int timestep);
 
         /// helper function to compute net force/virial
         void computeNetForce(unsigned int timestep);
 
+#ifdef ENABLE_TBB
+        /// helper function to compute independent forces concurrently
+        void computeForcesConcurrently(unsigned int timestep);
+#endif
+
 #ifdef ENABLE_HIP
         /// helper function to compute net force/virial on the GPU
         void computeNetForceGPU(unsigned int timestep);
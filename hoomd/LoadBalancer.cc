@@ -35,7 +35,8 @@ LoadBalancer::LoadBalancer(std::shared_ptr<SystemDefinition> sysdef,
           m_mpi_comm(m_exec_conf->getMPICommunicator()), m_max_imbalance(Scalar(1.0)),
           m_recompute_max_imbalance(true), m_needs_migrate(false),
           m_needs_recount(false), m_tolerance(Scalar(1.05)), m_maxiter(1),
-          m_max_scale(Scalar(0.05)), m_N_own(m_pdata->getN()),
+          m_max_scale(Scalar(0.05)), m_balance_time(false), m_weight(Scalar(1.0)),
+          m_particle_imbalance(Scalar(1.0)), m_time_imbalance(Scalar(1.0)), m_N_own(m_pdata->getN()),
           m_max_max_imbalance(1.0), m_total_max_imbalance(0.0), m_n_calls(0),
           m_n_iterations(0), m_n_rebalances(0)
     {
@@ -69,6 +70,9 @@ void LoadBalancer::update(unsigned int timestep)
     // no adjustment has been made yet, so set m_N_own to the number of particles on the rank
     resetNOwn(m_pdata->getN());
 
+    // measure the cost per particle since the last update
+    measureLoad();
+
     // figure out which rank is the reduction root for broadcasting
     const Index3D& di = m_decomposition->getDomainIndexer();
     unsigned int reduce_root(0);
@@ -115,17 +119,17 @@ void LoadBalancer::update(unsigned int timestep)
                 min_frac_i = min_domain_frac.z;
                 }
 
-            vector<unsigned int> N_i;
+            vector<Scalar> load_i;
             bool adjusted = false;
 
-            // reduce the number of particles in the slice along dim
-            bool active = reduce(N_i, dim, reduce_root);
+            // reduce the load in the slice along dim
+            bool active = reduce(load_i, dim, reduce_root);
 
             // attempt an adjustment
             vector<Scalar> cum_frac = m_decomposition->getCumulativeFractions(dim);
             if (active)
                 {
-                adjusted = adjust(cum_frac, N_i, L_i, min_frac_i);
+                adjusted = adjust(cum_frac, load_i, L_i, min_frac_i);
                 }
 
             // broadcast if an adjustment has been made on the root
@@ -153,19 +157,98 @@ void LoadBalancer::update(unsigned int timestep)
             }
         }
 
+    // record the particle imbalance that was achieved
+    if (m_balance_time)
+        {
+        Scalar cur_imb = Scalar(getNOwn()) / (Scalar(m_pdata->getNGlobal()) / Scalar(m_exec_conf->getNRanks()));
+        MPI_Allreduce(&cur_imb, &m_particle_imbalance, 1, MPI_HOOMD_SCALAR, MPI_MAX, m_mpi_comm);
+        }
+    else
+        {
+        m_particle_imbalance = getMaxImbalance();
+        }
+
     if (m_prof) m_prof->pop(m_exec_conf);
     }
 
 /*!
- * Computes the imbalance factor I = N / <N> for each rank, and computes the maximum among all ranks.
+ * Collects the wall clock time that the force computes on each rank reported to the Communicator since the last call
+ * and computes the maximum time imbalance. When balancing the time, the cost per particle of this rank relative to
+ * the average cost per particle of all ranks sets the weight of its particles. Ranks without particles (or without a
+ * time measurement) count their particles with the average cost.
+ *
+ * \note All ranks must participate in this call since it involves collective MPI calls.
+ */
+void LoadBalancer::measureLoad()
+    {
+    // time spent on this rank since the last update (in seconds)
+    double t = double(m_comm->getWorkTime()) * 1e-9;
+    m_comm->resetWorkTime();
+
+    double total_time(0.0), max_time(0.0);
+    MPI_Allreduce(&t, &total_time, 1, MPI_DOUBLE, MPI_SUM, m_mpi_comm);
+    MPI_Allreduce(&t, &max_time, 1, MPI_DOUBLE, MPI_MAX, m_mpi_comm);
+
+    const double avg_time = total_time / double(m_exec_conf->getNRanks());
+    m_time_imbalance = (avg_time > 0.0) ? Scalar(max_time / avg_time) : Scalar(1.0);
+
+    m_weight = Scalar(1.0);
+    const unsigned int N = m_pdata->getN();
+    if (m_balance_time && total_time > 0.0 && N > 0)
+        {
+        const double avg_cost = total_time / double(m_pdata->getNGlobal());
+        m_weight = Scalar((t / double(N)) / avg_cost);
+        }
+
+    m_recompute_max_imbalance = true;
+    }
+
+/*!
+ * \param load "particles" or "time"
+ */
+void LoadBalancer::setLoad(const std::string& load)
+    {
+    if (load == "particles")
+        {
+        m_balance_time = false;
+        }
+    else if (load == "time")
+        {
+        m_balance_time = true;
+        }
+    else
+        {
+        m_exec_conf->msg->error() << "comm.balance: unknown load " << load << endl;
+        throw invalid_argument("Unknown load");
+        }
+
+    m_recompute_max_imbalance = true;
+    }
+
+/*!
+ * Computes the imbalance factor I = N / <N> for each rank, and computes the maximum among all ranks. When balancing the
+ * time, N is the load (weighted number of particles) of the rank.
  */
 Scalar LoadBalancer::getMaxImbalance()
     {
     if (m_recompute_max_imbalance)
         {
-        Scalar cur_imb = Scalar(getNOwn()) / (Scalar(m_pdata->getNGlobal()) / Scalar(m_exec_conf->getNRanks()));
         Scalar max_imb(0.0);
-        MPI_Allreduce(&cur_imb, &max_imb, 1, MPI_HOOMD_SCALAR, MPI_MAX, m_mpi_comm);
+        if (m_balance_time)
+            {
+            // the total load changes when particles move between ranks with different costs
+            Scalar cur_load = getOwnLoad();
+            Scalar total_load(0.0), max_load(0.0);
+            MPI_Allreduce(&cur_load, &total_load, 1, MPI_HOOMD_SCALAR, MPI_SUM, m_mpi_comm);
+            MPI_Allreduce(&cur_load, &max_load, 1, MPI_HOOMD_SCALAR, MPI_MAX, m_mpi_comm);
+            max_imb = (total_load > Scalar(0.0))
+                      ? max_load / (total_load / Scalar(m_exec_conf->getNRanks())) : Scalar(1.0);
+            }
+        else
+            {
+            Scalar cur_imb = Scalar(getNOwn()) / (Scalar(m_pdata->getNGlobal()) / Scalar(m_exec_conf->getNRanks()));
+            MPI_Allreduce(&cur_imb, &max_imb, 1, MPI_HOOMD_SCALAR, MPI_MAX, m_mpi_comm);
+            }
 
         m_max_imbalance = max_imb;
         m_recompute_max_imbalance = false;
@@ -178,34 +261,34 @@ Scalar LoadBalancer::getMaxImbalance()
     }
 
 /*!
- * \param N_i Vector holding the total number of particles in each slice (will be allocated on call)
+ * \param load_i Vector holding the total load in each slice (will be allocated on call)
  * \param dim The dimension of the slices (x=0, y=1, z=2)
  * \param reduce_root The rank to perform the reduction on
- * \returns true if the current rank holds the active \a N_i
+ * \returns true if the current rank holds the active \a load_i
  *
- * \post \a N_i holds the number of particles in each slice along \a dim
+ * \post \a load_i holds the load (number of particles, weighted when balancing the time) in each slice along \a dim
  *
  * \note reduce() relies on collective MPI calls, and so all ranks must call it. However, for efficiency the data will
  *       be active only on Cartesian rank \a reduce_root, as indicated by the return value. As a result, only \a reduce_root
- *       actually needs to allocate memory for \a N_i.
+ *       actually needs to allocate memory for \a load_i.
  *
  * The reduction is performed by performing an all-to-one gather, followed by summation on \a reduce_root. This
  * operation may be suboptimal for very large numbers of processors, and could be replaced by cascading send operations
  * down dimensions. Generally, load balancing should not be performed too frequently, and so we do not pursue this
  * optimization right now.
  */
-bool LoadBalancer::reduce(std::vector<unsigned int>& N_i, unsigned int dim, unsigned int reduce_root)
+bool LoadBalancer::reduce(std::vector<Scalar>& load_i, unsigned int dim, unsigned int reduce_root)
     {
     // do nothing if there is only one rank
-    if (N_i.size() == 1) return false;
+    if (load_i.size() == 1) return false;
 
     const Index3D& di = m_decomposition->getDomainIndexer();
-    std::vector<unsigned int> N_per_rank(di.getNumElements());
+    std::vector<Scalar> load_per_rank(di.getNumElements());
 
-    // get the number of particles the current rank owns (the quantity to be reduced)
-    unsigned int N_own = getNOwn();
+    // get the load of the current rank (the quantity to be reduced)
+    Scalar load_own = getOwnLoad();
 
-    MPI_Gather(&N_own, 1, MPI_UNSIGNED, &N_per_rank[0], 1, MPI_UNSIGNED, reduce_root, m_mpi_comm);
+    MPI_Gather(&load_own, 1, MPI_HOOMD_SCALAR, &load_per_rank[0], 1, MPI_HOOMD_SCALAR, reduce_root, m_mpi_comm);
 
     // only the root rank performs the reduction
     if (m_exec_conf->getRank() != reduce_root)
@@ -213,54 +296,54 @@ bool LoadBalancer::reduce(std::vector<unsigned int>& N_i, unsigned int dim, unsi
 
     // rearrange the data from ranks to cartesian order in case it is jumbled around
     ArrayHandle<unsigned int> h_cart_ranks_inv(m_decomposition->getInverseCartRanks(), access_location::host, access_mode::read);
-    std::vector<unsigned int> N_per_cart_rank(di.getNumElements());
+    std::vector<Scalar> load_per_cart_rank(di.getNumElements());
     for (unsigned int cur_rank=0; cur_rank < di.getNumElements(); ++cur_rank)
         {
-        N_per_cart_rank[h_cart_ranks_inv.data[cur_rank]] = N_per_rank[cur_rank];
+        load_per_cart_rank[h_cart_ranks_inv.data[cur_rank]] = load_per_rank[cur_rank];
         }
 
     // perform the summation along dim in as cache friendly of a way as we can manage
     if (dim == 0) // to x
         {
-        N_i.clear(); N_i.resize(di.getW());
+        load_i.clear(); load_i.resize(di.getW());
         for (unsigned int i=0; i < di.getW(); ++i)
             {
-            N_i[i] = 0;
+            load_i[i] = Scalar(0.0);
             for (unsigned int k=0; k < di.getD(); ++k)
                 {
                 for (unsigned int j=0; j < di.getH(); ++j)
                     {
-                    N_i[i] += N_per_cart_rank[di(i,j,k)];
+                    load_i[i] += load_per_cart_rank[di(i,j,k)];
                     }
                 }
             }
         }
     else if (dim == 1) // to y
         {
-        N_i.clear(); N_i.resize(di.getH());
+        load_i.clear(); load_i.resize(di.getH());
         for (unsigned int j=0; j < di.getH(); ++j)
             {
-            N_i[j] = 0;
+            load_i[j] = Scalar(0.0);
             for (unsigned int k=0; k < di.getD(); ++k)
                 {
                 for (unsigned int i=0; i < di.getW(); ++i)
                     {
-                    N_i[j] += N_per_cart_rank[di(i,j,k)];
+                    load_i[j] += load_per_cart_rank[di(i,j,k)];
                     }
                 }
             }
         }
     else if (dim == 2) // to z
         {
-        N_i.clear(); N_i.resize(di.getD());
+        load_i.clear(); load_i.resize(di.getD());
         for (unsigned int k=0; k < di.getD(); ++k)
             {
-            N_i[k] = 0;
+            load_i[k] = Scalar(0.0);
             for (unsigned int j=0; j < di.getH(); ++j)
                 {
                 for (unsigned int i=0; i < di.getW(); ++i)
                     {
-                    N_i[k] += N_per_cart_rank[di(i,j,k)];
+                    load_i[k] += load_per_cart_rank[di(i,j,k)];
                     }
                 }
             }
@@ -276,7 +359,7 @@ bool LoadBalancer::reduce(std::vector<unsigned int>& N_i, unsigned int dim, unsi
 
 /*!
  * \param cum_frac_i The cumulative fraction array to write output into
- * \param N_i The reduced number of particles along the dimension
+ * \param load_i The reduced load along the dimension
  * \param L_i The global box length along the dimension
  * \param min_frac_i The minimum fractional width of a domain
  *
@@ -294,30 +377,30 @@ bool LoadBalancer::reduce(std::vector<unsigned int>& N_i, unsigned int dim, unsi
  *     successful, apply the adjustment to \a cum_frac_i.
  */
 bool LoadBalancer::adjust(vector<Scalar>& cum_frac_i,
-                          const vector<unsigned int>& N_i,
+                          const vector<Scalar>& load_i,
                           Scalar L_i,
                           Scalar min_frac_i)
     {
-    if (N_i.size() == 1)
+    if (load_i.size() == 1)
         return false;
 
-    // target particles per rank is uniform distribution
-    const Scalar target = Scalar(m_pdata->getNGlobal()) / Scalar(N_i.size());
+    // target load per rank is uniform distribution
+    const Scalar target = std::accumulate(load_i.begin(), load_i.end(), Scalar(0.0)) / Scalar(load_i.size());
 
     // make the minimum domain slightly bigger so that the optimization won't fail at equality
     const Scalar min_domain_size = Scalar(1.00001) * min_frac_i * L_i;
     // if system is overconstrained (exactly decomposed) don't do any adjusting
-    if (min_domain_size * Scalar(N_i.size()) >= L_i)
+    if (min_domain_size * Scalar(load_i.size()) >= L_i)
         {
         return false;
         }
 
     // imbalance factors for each rank
-    vector<Scalar> new_widths(N_i.size());
-    for (unsigned int i=0; i < N_i.size(); ++i)
+    vector<Scalar> new_widths(load_i.size());
+    for (unsigned int i=0; i < load_i.size(); ++i)
         {
-        const Scalar imb_factor = Scalar(N_i[i]) / target;
-        Scalar scale_factor = (N_i[i] > 0) ? Scalar(1.0) / imb_factor : (Scalar(1.0) + m_max_scale); // as in gromacs, use half the imbalance factor to scale
+        const Scalar imb_factor = load_i[i] / target;
+        Scalar scale_factor = (load_i[i] > Scalar(0.0)) ? Scalar(1.0) / imb_factor : (Scalar(1.0) + m_max_scale); // as in gromacs, use half the imbalance factor to scale
 
         // limit rescaling to 5% either direction
         // we should use absolute distance here, it is necessary to control balancing in corrugated systems
@@ -337,7 +420,7 @@ bool LoadBalancer::adjust(vector<Scalar>& cum_frac_i,
     // setup the augmented A matrix, with scale factor eps for the actual least squares part (to enforce the inequality
     // constraints correctly)
     const Scalar eps(0.001);
-    unsigned int m = N_i.size();
+    unsigned int m = load_i.size();
     unsigned int n = m - 1;
     Eigen::MatrixXd A = Eigen::MatrixXd::Zero(2*m,n+m);
     A(0,0) = 1.0; A(m,0) = eps;
@@ -570,6 +653,9 @@ void export_LoadBalancer(py::module& m)
     .def_property("x", &LoadBalancer::getEnableX, &LoadBalancer::setEnableX)
     .def_property("y", &LoadBalancer::getEnableY, &LoadBalancer::setEnableY)
     .def_property("z", &LoadBalancer::getEnableZ, &LoadBalancer::setEnableZ)
+    .def_property("load", &LoadBalancer::getLoad, &LoadBalancer::setLoad)
+    .def_property_readonly("particle_imbalance", &LoadBalancer::getParticleImbalance)
+    .def_property_readonly("time_imbalance", &LoadBalancer::getTimeImbalance)
     ;
     }
 #endif // ENABLE_MPI
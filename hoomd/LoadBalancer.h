@@ -28,8 +28,14 @@
 //! Updates domain decompositions to balance the load
 /*!
  * Adjusts the boundaries of the processor domains to distribute the load close to evenly between them. The load imbalance
- * is defined as the number of particles owned by a rank divided by the average number of particles per rank if the
- * particles had a uniform distribution.
+ * is defined as the load of a rank divided by the average load per rank. By default, the load of a rank is the number of
+ * particles it owns.
+ *
+ * When balancing the measured time, the load of a rank is the number of particles it owns weighted by its cost per
+ * particle: the wall clock time spent in force computes (including neighbor list builds) on the rank since the last
+ * update, divided by the number of particles on the rank, relative to the average over all ranks. The cost per particle
+ * is assumed to stay constant while the domain boundaries move, so regions with many pair neighbors or expensive
+ * bonded interactions end up in smaller domains. The force computes report their time to the Communicator.
  *
  * At each load balancing step, we attempt to rescale the domain size by the inverse of the load balance, subject to the
  * following constraints that are imposed to both maintain a stable balancing and to keep communication isolated to the
@@ -120,6 +126,30 @@ class PYBIND11_EXPORT LoadBalancer : public Tuner
         /// Get value of m_enable_z
         bool getEnableZ(bool enable) {return m_enable_z;}
 
+        //! Set the quantity to balance
+        /*!
+         * \param load "particles" to balance the number of particles, "time" to balance the measured time
+         */
+        virtual void setLoad(const std::string& load);
+
+        //! Get the quantity to balance
+        std::string getLoad() const
+            {
+            return m_balance_time ? "time" : "particles";
+            }
+
+        //! Get the maximum particle imbalance after the last update
+        Scalar getParticleImbalance() const
+            {
+            return m_particle_imbalance;
+            }
+
+        //! Get the maximum imbalance of the measured time before the last update
+        Scalar getTimeImbalance() const
+            {
+            return m_time_imbalance;
+            }
+
         //! Take one timestep forward
         virtual void update(unsigned int timestep);
 
@@ -137,8 +167,8 @@ class PYBIND11_EXPORT LoadBalancer : public Tuner
         Scalar m_max_imbalance;             //!< Maximum imbalance
         bool m_recompute_max_imbalance;     //!< Flag if maximum imbalance needs to be computed
 
-        //! Reduce the particle numbers per rank down to one dimension
-        bool reduce(std::vector<unsigned int>& N_i, unsigned int dim, unsigned int reduce_root);
+        //! Reduce the loads per rank down to one dimension
+        bool reduce(std::vector<Scalar>& load_i, unsigned int dim, unsigned int reduce_root);
 
         //! Set flags within the class that a resize has been performed
         void signalResize()
@@ -150,11 +180,20 @@ class PYBIND11_EXPORT LoadBalancer : public Tuner
 
         //! Adjust the partitioning along a single dimension
         bool adjust(std::vector<Scalar>& cum_frac_i,
-                    const std::vector<unsigned int>& N_i,
+                    const std::vector<Scalar>& load_i,
                     Scalar L_i,
                     Scalar min_domain_frac);
         bool m_needs_migrate;   //!< Flag to signal that migration is necessary
 
+        //! Measure the time spent since the last update and compute the cost per particle of this rank
+        void measureLoad();
+
+        //! Gets the load of this rank
+        Scalar getOwnLoad()
+            {
+            return m_weight * Scalar(getNOwn());
+            }
+
         //! Compute the number of particles on each rank after an adjustment
         void computeOwnedParticles();
 
@@ -188,6 +227,11 @@ class PYBIND11_EXPORT LoadBalancer : public Tuner
 
         const Scalar m_max_scale;   //!< Maximum fraction to rescale either direction (5%)
 
+        bool m_balance_time;        //!< Flag to balance the measured time instead of the number of particles
+        Scalar m_weight;            //!< Cost per particle of this rank relative to the average
+        Scalar m_particle_imbalance;    //!< Maximum particle imbalance after the last update
+        Scalar m_time_imbalance;        //!< Maximum imbalance of the measured time before the last update
+
     private:
         unsigned int m_N_own;               //!< Number of particles owned by this rank
 
@@ -44,6 +44,21 @@ LoadBalancerGPU::~LoadBalancerGPU()
     m_pdata->getMaxParticleNumberChangeSignal().disconnect<LoadBalancerGPU, &LoadBalancerGPU::slotMaxNumChanged>(this);
     }
 
+/*!
+ * \param load "particles" or "time"
+ *
+ * Kernels run asynchronously, so the force computes cannot measure their time on the GPU.
+ */
+void LoadBalancerGPU::setLoad(const std::string& load)
+    {
+    if (load == "time")
+        {
+        m_exec_conf->msg->error() << "comm.balance: Balancing the measured time is not supported on the GPU" << std::endl;
+        throw std::runtime_error("Error setting LoadBalancer load");
+        }
+    LoadBalancer::setLoad(load);
+    }
+
 void LoadBalancerGPU::countParticlesOffRank(std::map<unsigned int, unsigned int>& cnts)
     {
     // do nothing if rank doesn't own any particles
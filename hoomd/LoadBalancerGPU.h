@@ -55,6 +55,9 @@ class PYBIND11_EXPORT LoadBalancerGPU : public LoadBalancer
             GPUArray<unsigned int> off_ranks(m_pdata->getMaxN(), m_exec_conf);
             m_off_ranks.swap(off_ranks);
             }
+        //! Set the quantity to balance
+        virtual void setLoad(const std::string& load);
+
     protected:
         //! Count the number of particles that have gone off either edge of the rank along a dimension on the GPU
         virtual void countParticlesOffRank(std::map<unsigned int, unsigned int>& cnts);
@@ -29,6 +29,7 @@
 #include <stdexcept>
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
 
 using namespace std;
 
@@ -63,6 +64,7 @@ ParticleData::ParticleData(unsigned int N, const BoxDim &global_box, unsigned in
           m_max_nparticles(0),
           m_nglobal(0),
           m_accel_set(false),
+          m_group_flags_used(0),
           m_resize_factor(9./8.),
           m_arrays_allocated(false)
     {
@@ -144,6 +146,7 @@ ParticleData::ParticleData(const SnapshotParticleData<Real>& snapshot,
       m_max_nparticles(0),
       m_nglobal(0),
       m_accel_set(false),
+      m_group_flags_used(0),
       m_resize_factor(9./8.),
       m_arrays_allocated(false)
     {
@@ -376,6 +379,11 @@ void ParticleData::allocate(unsigned int N)
     m_body.swap(body);
     TAG_ALLOCATION(m_body);
 
+    // group membership flags
+    GlobalArray< unsigned int > group_flags(N, m_exec_conf);
+    m_group_flags.swap(group_flags);
+    TAG_ALLOCATION(m_group_flags);
+
     GlobalArray< Scalar4 > net_force(N, m_exec_conf);
     m_net_force.swap(net_force);
     TAG_ALLOCATION(m_net_force);
@@ -488,6 +496,11 @@ void ParticleData::allocateAlternateArrays(unsigned int N)
     m_body_alt.swap(body_alt);
     TAG_ALLOCATION(m_body_alt);
 
+    // group membership flags
+    GlobalArray< unsigned int > group_flags_alt(N, m_exec_conf);
+    m_group_flags_alt.swap(group_flags_alt);
+    TAG_ALLOCATION(m_group_flags_alt);
+
     // orientation
     GlobalArray< Scalar4 > orientation_alt(N, m_exec_conf);
     m_orientation_alt.swap(orientation_alt);
@@ -646,6 +659,7 @@ void ParticleData::reallocate(unsigned int max_n)
     m_image.resize(max_n);
     m_tag.resize(max_n);
     m_body.resize(max_n);
+    m_group_flags.resize(max_n);
 
     m_net_force.resize(max_n);
     m_net_virial.resize(max_n,6);
@@ -698,6 +712,7 @@ void ParticleData::reallocate(unsigned int max_n)
         m_image_alt.resize(max_n);
         m_tag_alt.resize(max_n);
         m_body_alt.resize(max_n);
+        m_group_flags_alt.resize(max_n);
         m_orientation_alt.resize(max_n);
         m_angmom_alt.resize(max_n);
         m_inertia_alt.resize(max_n);
@@ -802,6 +817,55 @@ bool ParticleData::inBox(const SnapshotParticleData<Real> &snap)
     return in_box;
     }
 
+#ifdef ENABLE_MPI
+/*! \param pos Position of the particle, wrapped into the global box on return
+    \param img Image of the particle, updated on return
+    \param cart_ranks Map from Cartesian domain indices to ranks
+    \returns the rank of the domain the particle is placed into, or a value >= the number of ranks if it is out of
+             bounds
+*/
+unsigned int ParticleData::placeSnapshotParticle(Scalar3& pos, int3& img, const unsigned int *cart_ranks) const
+    {
+    const Index3D& di = m_decomposition->getDomainIndexer();
+
+    Scalar3 f = m_global_box.makeFraction(pos);
+    int i= f.x * ((Scalar)di.getW());
+    int j= f.y * ((Scalar)di.getH());
+    int k= f.z * ((Scalar)di.getD());
+
+    // wrap particles that are exactly on a boundary
+    // we only need to wrap in the negative direction, since
+    // processor ids are rounded toward zero
+    char3 flags = make_char3(0,0,0);
+    if (i == (int) di.getW())
+        {
+        i = 0;
+        flags.x = 1;
+        }
+
+    if (j == (int) di.getH())
+        {
+        j = 0;
+        flags.y = 1;
+        }
+
+    if (k == (int) di.getD())
+        {
+        k = 0;
+        flags.z = 1;
+        }
+
+    // only wrap if the particles is on one of the boundaries
+    BoxDim global_box = m_global_box;
+    uchar3 periodic = make_uchar3(flags.x,flags.y,flags.z);
+    global_box.setPeriodic(periodic);
+    global_box.wrap(pos, img, flags);
+
+    // place particle using actual domain fractions, not global box fraction
+    return m_decomposition->placeParticle(m_global_box, pos, cart_ranks);
+    }
+#endif
+
 //! Initialize from a snapshot
 /*! \param snapshot the initial particle data
     \param ignore_bodies If True, ignore particles that have a body flag set
@@ -890,11 +954,8 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
                 throw std::runtime_error("Error initializing ParticleData");
                 }
 
-            const Index3D& di = m_decomposition->getDomainIndexer();
             unsigned int n_ranks = m_exec_conf->getNRanks();
 
-            BoxDim global_box = m_global_box;
-
             // loop over particles in snapshot, place them into domains
             for (typename std::vector< vec3<Real> >::const_iterator it=snapshot.pos.begin(); it != snapshot.pos.end(); it++)
                 {
@@ -909,41 +970,8 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
                 // determine domain the particle is placed into
                 Scalar3 pos = vec_to_scalar3(*it);
                 Scalar3 f = m_global_box.makeFraction(pos);
-                int i= f.x * ((Scalar)di.getW());
-                int j= f.y * ((Scalar)di.getH());
-                int k= f.z * ((Scalar)di.getD());
-
-                // wrap particles that are exactly on a boundary
-                // we only need to wrap in the negative direction, since
-                // processor ids are rounded toward zero
-                char3 flags = make_char3(0,0,0);
-                if (i == (int) di.getW())
-                    {
-                    i = 0;
-                    flags.x = 1;
-                    }
-
-                if (j == (int) di.getH())
-                    {
-                    j = 0;
-                    flags.y = 1;
-                    }
-
-                if (k == (int) di.getD())
-                    {
-                    k = 0;
-                    flags.z = 1;
-                    }
-
                 int3 img = snapshot.image[snap_idx];
-
-                // only wrap if the particles is on one of the boundaries
-                uchar3 periodic = make_uchar3(flags.x,flags.y,flags.z);
-                global_box.setPeriodic(periodic);
-                global_box.wrap(pos, img, flags);
-
-                // place particle using actual domain fractions, not global box fraction
-                unsigned int rank = m_decomposition->placeParticle(m_global_box, pos, h_cart_ranks.data);
+                unsigned int rank = placeSnapshotParticle(pos, img, h_cart_ranks.data);
 
                 if (rank >= n_ranks)
                     {
@@ -1161,6 +1189,12 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
         m_type_mapping = snapshot.type_mapping;
         }
 
+    // groups re-evaluate their membership when the global particle number changes
+        {
+        ArrayHandle< unsigned int > h_group_flags(m_group_flags, access_location::host, access_mode::overwrite);
+        memset(h_group_flags.data, 0, sizeof(unsigned int)*m_group_flags.getNumElements());
+        }
+
     // copy over accel_set flag from snapshot
     m_accel_set = snapshot.is_accel_set;
 
@@ -1178,6 +1212,159 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
     m_num_types_signal.emit();
     }
 
+#ifdef ENABLE_MPI
+//! Initialize from a distributed snapshot
+/*! \param snapshot The slice of the particle data held by this rank
+    \param owners Filled with the tag offsets of all slices and the ranks the particles of the local slice are sent to
+
+    Every rank holds a contiguous slice of the particles, and the slices are tagged in rank order. Each rank places the
+    particles of its own slice into domains, and all ranks exchange them in a single all-to-all step, packed as
+    pdata_element like migrating particles. Unlike initializeFromSnapshot(), no rank holds the whole system at any time.
+
+    \pre The global box and the domain decomposition are set.
+ */
+template <class Real>
+void ParticleData::initializeFromDistributedSnapshot(const SnapshotParticleData<Real>& snapshot,
+    SnapshotParticleOwners& owners)
+    {
+    m_exec_conf->msg->notice(4) << "ParticleData: initializing from distributed snapshot" << std::endl;
+
+    assert(m_decomposition);
+
+    const MPI_Comm mpi_comm = m_exec_conf->getMPICommunicator();
+    unsigned int n_ranks = m_exec_conf->getNRanks();
+    unsigned int my_rank = m_exec_conf->getRank();
+
+    // check the input for errors, every rank checks its own slice
+    unsigned int n_invalid = (snapshot.validate() && snapshot.type_mapping.size() > 0) ? 0 : 1;
+    MPI_Allreduce(MPI_IN_PLACE, &n_invalid, 1, MPI_UNSIGNED, MPI_SUM, mpi_comm);
+    if (n_invalid)
+        {
+        m_exec_conf->msg->error() << "init.*: invalid particle data snapshot."
+                                << std::endl << std::endl;
+        throw std::runtime_error("Error initializing particle data.");
+        }
+
+    // the slices are tagged in rank order
+    unsigned int n_slice = snapshot.size;
+    std::vector<unsigned int> slice_sizes;
+    all_gather_v(n_slice, slice_sizes, mpi_comm);
+
+    owners.tag_offset.resize(n_ranks+1);
+    owners.tag_offset[0] = 0;
+    for (unsigned int rank = 0; rank < n_ranks; ++rank)
+        owners.tag_offset[rank+1] = owners.tag_offset[rank] + slice_sizes[rank];
+
+    unsigned int nglobal = owners.tag_offset[n_ranks];
+    unsigned int tag_offset = owners.tag_offset[my_rank];
+
+    // place the particles of the local slice into domains
+    std::vector< std::vector<pdata_element> > send_ptls(n_ranks);
+    owners.owner.resize(n_slice);
+    unsigned int n_out_of_bounds = 0;
+
+        {
+        ArrayHandle<unsigned int> h_cart_ranks(m_decomposition->getCartRanks(), access_location::host, access_mode::read);
+
+        for (unsigned int snap_idx = 0; snap_idx < n_slice; ++snap_idx)
+            {
+            Scalar3 pos = vec_to_scalar3(snapshot.pos[snap_idx]);
+            int3 img = snapshot.image[snap_idx];
+            unsigned int rank = placeSnapshotParticle(pos, img, h_cart_ranks.data);
+
+            if (rank >= n_ranks)
+                {
+                m_exec_conf->msg->errorAllRanks() << "init.*: Particle " << tag_offset + snap_idx
+                    << " out of bounds (x: " << pos.x << " y: " << pos.y << " z: " << pos.z << ")." << std::endl;
+                n_out_of_bounds++;
+                owners.owner[snap_idx] = my_rank;
+                continue;
+                }
+
+            pdata_element p;
+            p.pos = make_scalar4(pos.x, pos.y, pos.z, __int_as_scalar(snapshot.type[snap_idx]));
+            p.vel = make_scalar4(snapshot.vel[snap_idx].x,
+                                 snapshot.vel[snap_idx].y,
+                                 snapshot.vel[snap_idx].z,
+                                 snapshot.mass[snap_idx]);
+            p.accel = vec_to_scalar3(snapshot.accel[snap_idx]);
+            p.charge = snapshot.charge[snap_idx];
+            p.diameter = snapshot.diameter[snap_idx];
+            p.image = img;
+            p.body = snapshot.body[snap_idx];
+            p.orientation = quat_to_scalar4(snapshot.orientation[snap_idx]);
+            p.angmom = quat_to_scalar4(snapshot.angmom[snap_idx]);
+            p.inertia = vec_to_scalar3(snapshot.inertia[snap_idx]);
+            p.tag = tag_offset + snap_idx;
+            p.group_flags = 0;
+            p.net_force = make_scalar4(0,0,0,0);
+            p.net_torque = make_scalar4(0,0,0,0);
+            for (unsigned int j = 0; j < 6; ++j)
+                p.net_virial[j] = Scalar(0.0);
+
+            send_ptls[rank].push_back(p);
+            owners.owner[snap_idx] = rank;
+            }
+        }
+
+    // all ranks throw together
+    MPI_Allreduce(MPI_IN_PLACE, &n_out_of_bounds, 1, MPI_UNSIGNED, MPI_SUM, mpi_comm);
+    if (n_out_of_bounds)
+        {
+        m_exec_conf->msg->error() << "init.*: " << n_out_of_bounds << " particles out of bounds." << std::endl;
+        throw std::runtime_error("Error initializing from snapshot.");
+        }
+
+    // send the particles to the ranks that own them
+    std::vector<pdata_element> recv_ptls;
+    all_to_all_v(send_ptls, recv_ptls, mpi_comm);
+    std::vector< std::vector<pdata_element> >().swap(send_ptls);
+
+    // remove all ghost particles
+    removeAllGhostParticles();
+
+    // clear set of active tags
+    m_tag_set.clear();
+
+    // clear reservoir of recycled tags
+    while (! m_recycled_tags.empty())
+        m_recycled_tags.pop();
+
+    m_type_mapping = snapshot.type_mapping;
+
+    // reset all reverse lookup tags to NOT_LOCAL flag
+    m_rtag.resize(nglobal);
+        {
+        ArrayHandle<unsigned int> h_rtag(m_rtag, access_location::host, access_mode::overwrite);
+        std::fill(h_rtag.data, h_rtag.data + nglobal, NOT_LOCAL);
+        }
+
+    // update list of active tags
+    for (unsigned int tag = 0; tag < nglobal; tag++)
+        m_tag_set.insert(m_tag_set.end(), tag);
+
+    // Now that active tag list has changed, invalidate the cache
+    m_invalid_cached_tags = true;
+
+    // fill the particle data with the received particles
+    resize(0);
+    addParticles(recv_ptls);
+
+    // copy over accel_set flag from snapshot
+    m_accel_set = snapshot.is_accel_set;
+
+    // set global number of particles
+    setNGlobal(nglobal);
+
+    // zero the origin
+    m_origin = make_scalar3(0,0,0);
+    m_o_image = make_int3(0,0,0);
+
+    // notify listeners that number of types has changed
+    m_num_types_signal.emit();
+    }
+#endif
+
 //! take a particle data snapshot
 /* \param snapshot The snapshot to write to
    \returns a map to lookup the snapshot index from a particle tag
@@ -2284,6 +2471,7 @@ unsigned int ParticleData::addParticle(unsigned int type)
         ArrayHandle<unsigned int> h_body(getBodies(), access_location::host, access_mode::readwrite);
         ArrayHandle<Scalar4> h_orientation(getOrientationArray(), access_location::host, access_mode::readwrite);
         ArrayHandle<unsigned int> h_tag(getTags(), access_location::host, access_mode::readwrite);
+        ArrayHandle<unsigned int> h_group_flags(m_group_flags, access_location::host, access_mode::readwrite);
         ArrayHandle<unsigned int> h_comm_flag(m_comm_flags, access_location::host, access_mode::readwrite);
 
         unsigned int idx = old_nparticles;
@@ -2300,6 +2488,7 @@ unsigned int ParticleData::addParticle(unsigned int type)
         h_body.data[idx] = NO_BODY;
         h_orientation.data[idx] = make_scalar4(1.0,0.0,0.0,0.0);
         h_tag.data[idx] = tag;
+        h_group_flags.data[idx] = 0;
         h_comm_flag.data[idx] = 0;
         }
 
@@ -2387,6 +2576,7 @@ void ParticleData::removeParticle(unsigned int tag)
             ArrayHandle<Scalar4> h_orientation(getOrientationArray(), access_location::host, access_mode::readwrite);
             ArrayHandle<unsigned int> h_tag(getTags(), access_location::host, access_mode::readwrite);
             ArrayHandle<unsigned int> h_rtag(getRTags(), access_location::host, access_mode::readwrite);
+            ArrayHandle<unsigned int> h_group_flags(m_group_flags, access_location::host, access_mode::readwrite);
             ArrayHandle<unsigned int> h_comm_flag(m_comm_flags, access_location::host, access_mode::readwrite);
 
             h_pos.data[idx] = h_pos.data[size-1];
@@ -2398,6 +2588,7 @@ void ParticleData::removeParticle(unsigned int tag)
             h_body.data[idx] = h_body.data[size-1];
             h_orientation.data[idx] = h_orientation.data[size-1];
             h_tag.data[idx] = h_tag.data[size-1];
+            h_group_flags.data[idx] = h_group_flags.data[size-1];
             h_comm_flag.data[idx] = h_comm_flag.data[size-1];
 
             unsigned int last_tag = h_tag.data[size-1];
@@ -2442,6 +2633,41 @@ unsigned int ParticleData::getNthTag(unsigned int n)
     return m_cached_tag_set[n];
     }
 
+/*! \returns The index of a free bit in the group membership flags, or NO_GROUP_FLAG if all bits are taken
+
+    The bit is initially cleared on all particles. The caller owns it until releaseGroupFlag() is called.
+*/
+unsigned int ParticleData::acquireGroupFlag()
+    {
+    for (unsigned int bit = 0; bit < sizeof(unsigned int)*8; ++bit)
+        {
+        unsigned int mask = 1u << bit;
+        if (! (m_group_flags_used & mask))
+            {
+            m_group_flags_used |= mask;
+            return bit;
+            }
+        }
+
+    return NO_GROUP_FLAG;
+    }
+
+/*! \param bit Group membership bit previously obtained from acquireGroupFlag()
+ */
+void ParticleData::releaseGroupFlag(unsigned int bit)
+    {
+    assert(bit < sizeof(unsigned int)*8);
+    unsigned int mask = 1u << bit;
+    assert(m_group_flags_used & mask);
+
+    // clear the bit so that the next owner starts from an empty group
+    ArrayHandle<unsigned int> h_group_flags(m_group_flags, access_location::host, access_mode::readwrite);
+    for (unsigned int idx = 0; idx < getN() + getNGhosts(); ++idx)
+        h_group_flags.data[idx] &= ~mask;
+
+    m_group_flags_used &= ~mask;
+    }
+
 void export_BoxDim(py::module& m)
     {
     void (BoxDim::*wrap_overload)(Scalar3&, int3&, char3) const = &BoxDim::wrap;
@@ -2499,6 +2725,10 @@ template ParticleData::ParticleData(const SnapshotParticleData<double>& snapshot
                                            std::shared_ptr<DomainDecomposition> decomposition
                                           );
 template void ParticleData::initializeFromSnapshot<double>(const SnapshotParticleData<double> & snapshot, bool ignore_bodies);
+#ifdef ENABLE_MPI
+template void ParticleData::initializeFromDistributedSnapshot<double>(const SnapshotParticleData<double>& snapshot,
+    SnapshotParticleOwners& owners);
+#endif
 template std::map<unsigned int, unsigned int> ParticleData::takeSnapshot<double>(SnapshotParticleData<double> &snapshot);
 
 
@@ -2508,6 +2738,10 @@ template ParticleData::ParticleData(const SnapshotParticleData<float>& snapshot,
                                            std::shared_ptr<DomainDecomposition> decomposition
                                           );
 template void ParticleData::initializeFromSnapshot<float>(const SnapshotParticleData<float> & snapshot, bool ignore_bodies);
+#ifdef ENABLE_MPI
+template void ParticleData::initializeFromDistributedSnapshot<float>(const SnapshotParticleData<float>& snapshot,
+    SnapshotParticleOwners& owners);
+#endif
 template std::map<unsigned int, unsigned int> ParticleData::takeSnapshot<float>(SnapshotParticleData<float> &snapshot);
 
 
@@ -2698,6 +2932,7 @@ void ParticleData::removeParticles(std::vector<pdata_element>& out, std::vector<
         ArrayHandle<Scalar> h_net_virial(getNetVirial(), access_location::host, access_mode::readwrite);
 
         ArrayHandle<unsigned int> h_tag(getTags(), access_location::host, access_mode::readwrite);
+        ArrayHandle<unsigned int> h_group_flags(getGroupFlags(), access_location::host, access_mode::read);
 
         ArrayHandle<unsigned int> h_rtag(getRTags(), access_location::host, access_mode::read);
 
@@ -2717,6 +2952,7 @@ void ParticleData::removeParticles(std::vector<pdata_element>& out, std::vector<
         ArrayHandle<Scalar4> h_net_torque_alt(m_net_torque_alt, access_location::host, access_mode::overwrite);
         ArrayHandle<Scalar> h_net_virial_alt(m_net_virial_alt, access_location::host, access_mode::overwrite);
         ArrayHandle<unsigned int> h_tag_alt(m_tag_alt, access_location::host, access_mode::overwrite);
+        ArrayHandle<unsigned int> h_group_flags_alt(m_group_flags_alt, access_location::host, access_mode::overwrite);
 
         unsigned int n =0;
         unsigned int m = 0;
@@ -2742,6 +2978,7 @@ void ParticleData::removeParticles(std::vector<pdata_element>& out, std::vector<
                 for (unsigned int j = 0; j < 6; ++j)
                     h_net_virial_alt.data[net_virial_pitch*j+n] = h_net_virial.data[net_virial_pitch*j+i];
                 h_tag_alt.data[n] = h_tag.data[i];
+                h_group_flags_alt.data[n] = h_group_flags.data[i];
                 ++n;
                 }
             else
@@ -2763,6 +3000,7 @@ void ParticleData::removeParticles(std::vector<pdata_element>& out, std::vector<
                 for (unsigned int j = 0; j < 6; ++j)
                     p.net_virial[j] = h_net_virial.data[net_virial_pitch*j+i];
                 p.tag = h_tag.data[i];
+                p.group_flags = h_group_flags.data[i];
                 out[m++] = p;
                 }
             }
@@ -2790,6 +3028,7 @@ void ParticleData::removeParticles(std::vector<pdata_element>& out, std::vector<
     swapNetTorque();
     swapNetVirial();
     swapTags();
+    swapGroupFlags();
 
         {
         ArrayHandle<unsigned int> h_rtag(getRTags(), access_location::host, access_mode::readwrite);
@@ -2841,6 +3080,7 @@ void ParticleData::addParticles(const std::vector<pdata_element>& in)
         ArrayHandle<Scalar> h_net_virial(getNetVirial(), access_location::host, access_mode::readwrite);
         ArrayHandle<unsigned int> h_tag(getTags(), access_location::host, access_mode::readwrite);
         ArrayHandle<unsigned int> h_rtag(getRTags(), access_location::host, access_mode::readwrite);
+        ArrayHandle<unsigned int> h_group_flags(m_group_flags, access_location::host, access_mode::readwrite);
         ArrayHandle<unsigned int> h_comm_flags(m_comm_flags, access_location::host, access_mode::readwrite);
 
         unsigned int net_virial_pitch = m_net_virial.getPitch();
@@ -2864,6 +3104,7 @@ void ParticleData::addParticles(const std::vector<pdata_element>& in)
             for (unsigned int j = 0; j < 6; ++j)
                 h_net_virial.data[net_virial_pitch*j+n] = p.net_virial[j];
             h_tag.data[n] = p.tag;
+            h_group_flags.data[n] = p.group_flags;
             n++;
             }
 
@@ -2933,6 +3174,7 @@ void ParticleData::removeParticlesGPU(GlobalVector<pdata_element>& out, GlobalVe
         ArrayHandle<Scalar4> d_net_torque(getNetTorqueArray(), access_location::device, access_mode::read);
         ArrayHandle<Scalar> d_net_virial(getNetVirial(), access_location::device, access_mode::read);
         ArrayHandle<unsigned int> d_tag(getTags(), access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_group_flags(getGroupFlags(), access_location::device, access_mode::read);
 
         // access alternate particle data arrays to write to
         ArrayHandle<Scalar4> d_pos_alt(m_pos_alt, access_location::device, access_mode::overwrite);
@@ -2949,6 +3191,7 @@ void ParticleData::removeParticlesGPU(GlobalVector<pdata_element>& out, GlobalVe
         ArrayHandle<Scalar4> d_net_torque_alt(m_net_torque_alt, access_location::device, access_mode::overwrite);
         ArrayHandle<Scalar> d_net_virial_alt(m_net_virial_alt, access_location::device, access_mode::overwrite);
         ArrayHandle<unsigned int> d_tag_alt(m_tag_alt, access_location::device, access_mode::overwrite);
+        ArrayHandle<unsigned int> d_group_flags_alt(m_group_flags_alt, access_location::device, access_mode::overwrite);
 
         ArrayHandle<unsigned int> d_comm_flags(getCommFlags(), access_location::device, access_mode::readwrite);
 
@@ -2981,6 +3224,7 @@ void ParticleData::removeParticlesGPU(GlobalVector<pdata_element>& out, GlobalVe
                            d_net_virial.data,
                            getNetVirial().getPitch(),
                            d_tag.data,
+                           d_group_flags.data,
                            d_rtag.data,
                            d_pos_alt.data,
                            d_vel_alt.data,
@@ -2996,6 +3240,7 @@ void ParticleData::removeParticlesGPU(GlobalVector<pdata_element>& out, GlobalVe
                            d_net_torque_alt.data,
                            d_net_virial_alt.data,
                            d_tag_alt.data,
+                           d_group_flags_alt.data,
                            d_out.data,
                            d_comm_flags.data,
                            d_comm_flags_out.data,
@@ -3039,6 +3284,7 @@ void ParticleData::removeParticlesGPU(GlobalVector<pdata_element>& out, GlobalVe
     swapNetTorque();
     swapNetVirial();
     swapTags();
+    swapGroupFlags();
 
     // notify subscribers
     notifyParticleSort();
@@ -3074,6 +3320,7 @@ void ParticleData::addParticlesGPU(const GlobalVector<pdata_element>& in)
         ArrayHandle<Scalar4> d_net_torque(getNetTorqueArray(), access_location::device, access_mode::readwrite);
         ArrayHandle<Scalar> d_net_virial(getNetVirial(), access_location::device, access_mode::readwrite);
         ArrayHandle<unsigned int> d_tag(getTags(), access_location::device, access_mode::readwrite);
+        ArrayHandle<unsigned int> d_group_flags(getGroupFlags(), access_location::device, access_mode::readwrite);
         ArrayHandle<unsigned int> d_rtag(getRTags(), access_location::device, access_mode::readwrite);
         ArrayHandle<unsigned int> d_comm_flags(getCommFlags(), access_location::device, access_mode::readwrite);
 
@@ -3099,6 +3346,7 @@ void ParticleData::addParticlesGPU(const GlobalVector<pdata_element>& in)
             d_net_virial.data,
             getNetVirial().getPitch(),
             d_tag.data,
+            d_group_flags.data,
             d_rtag.data,
             d_in.data,
             d_comm_flags.data);
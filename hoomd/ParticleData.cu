@@ -37,6 +37,7 @@ __global__ void gpu_scatter_particle_data_kernel(
     const Scalar *d_net_virial,
     unsigned int net_virial_pitch,
     const unsigned int *d_tag,
+    const unsigned int *d_group_flags,
     unsigned int *d_rtag,
     Scalar4 *d_pos_alt,
     Scalar4 *d_vel_alt,
@@ -52,6 +53,7 @@ __global__ void gpu_scatter_particle_data_kernel(
     Scalar4 *d_net_torque_alt,
     Scalar *d_net_virial_alt,
     unsigned int *d_tag_alt,
+    unsigned int *d_group_flags_alt,
     pdata_element *d_out,
     unsigned int *d_comm_flags,
     unsigned int *d_comm_flags_out,
@@ -85,6 +87,7 @@ __global__ void gpu_scatter_particle_data_kernel(
         for (unsigned int j = 0; j < 6; ++j)
             p.net_virial[j] = d_net_virial[j*net_virial_pitch+idx];
         p.tag = d_tag[idx];
+        p.group_flags = d_group_flags[idx];
         d_out[scan_remove] = p;
         d_comm_flags_out[scan_remove] = d_comm_flags[idx];
 
@@ -112,6 +115,7 @@ __global__ void gpu_scatter_particle_data_kernel(
             d_net_virial_alt[j*net_virial_pitch+scan_keep] = d_net_virial[j*net_virial_pitch+idx];
         unsigned int tag = d_tag[idx];
         d_tag_alt[scan_keep] = tag;
+        d_group_flags_alt[scan_keep] = d_group_flags[idx];
 
         // update rtag
         d_rtag[tag] = scan_keep;
@@ -146,6 +150,7 @@ __global__ void gpu_select_sent_particles(
     \param d_net_virial Net virial
     \param net_virial_pitch Pitch of net virial array
     \param d_tag Device array of particle tags
+    \param d_group_flags Device array of group membership flags
     \param d_rtag Device array for reverse-lookup table
     \param d_pos_alt Device array of particle positions (output)
     \param d_vel_alt Device array of particle velocities (output)
@@ -160,6 +165,8 @@ __global__ void gpu_select_sent_particles(
     \param d_net_force Net force (output)
     \param d_net_torque Net torque (output)
     \param d_net_virial Net virial (output)
+    \param d_tag_alt Device array of particle tags (output)
+    \param d_group_flags_alt Device array of group membership flags (output)
     \param d_out Output array for packed particle data
     \param max_n_out Maximum number of elements to write to output array
 
@@ -181,6 +188,7 @@ unsigned int gpu_pdata_remove(const unsigned int N,
                     const Scalar *d_net_virial,
                     unsigned int net_virial_pitch,
                     const unsigned int *d_tag,
+                    const unsigned int *d_group_flags,
                     unsigned int *d_rtag,
                     Scalar4 *d_pos_alt,
                     Scalar4 *d_vel_alt,
@@ -196,6 +204,7 @@ unsigned int gpu_pdata_remove(const unsigned int N,
                     Scalar4 *d_net_torque_alt,
                     Scalar *d_net_virial_alt,
                     unsigned int *d_tag_alt,
+                    unsigned int *d_group_flags_alt,
                     pdata_element *d_out,
                     unsigned int *d_comm_flags,
                     unsigned int *d_comm_flags_out,
@@ -220,6 +229,7 @@ unsigned int gpu_pdata_remove(const unsigned int N,
     assert(d_net_torque);
     assert(d_net_virial);
     assert(d_tag);
+    assert(d_group_flags);
     assert(d_rtag);
     assert(d_pos_alt);
     assert(d_vel_alt);
@@ -235,6 +245,7 @@ unsigned int gpu_pdata_remove(const unsigned int N,
     assert(d_net_torque_alt);
     assert(d_net_virial_alt);
     assert(d_tag_alt);
+    assert(d_group_flags_alt);
     assert(d_out);
     assert(d_comm_flags);
     assert(d_comm_flags_out);
@@ -317,6 +328,7 @@ unsigned int gpu_pdata_remove(const unsigned int N,
                 d_net_virial,
                 net_virial_pitch,
                 d_tag,
+                d_group_flags,
                 d_rtag,
                 d_pos_alt,
                 d_vel_alt,
@@ -332,6 +344,7 @@ unsigned int gpu_pdata_remove(const unsigned int N,
                 d_net_torque_alt,
                 d_net_virial_alt,
                 d_tag_alt,
+                d_group_flags_alt,
                 d_out,
                 d_comm_flags,
                 d_comm_flags_out,
@@ -365,6 +378,7 @@ __global__ void gpu_pdata_add_particles_kernel(unsigned int old_nparticles,
                     Scalar *d_net_virial,
                     unsigned int net_virial_pitch,
                     unsigned int *d_tag,
+                    unsigned int *d_group_flags,
                     unsigned int *d_rtag,
                     const pdata_element *d_in,
                     unsigned int *d_comm_flags)
@@ -391,6 +405,7 @@ __global__ void gpu_pdata_add_particles_kernel(unsigned int old_nparticles,
     for (unsigned int j = 0; j < 6; ++j)
         d_net_virial[j*net_virial_pitch+add_idx] = p.net_virial[j];
     d_tag[add_idx] = p.tag;
+    d_group_flags[add_idx] = p.group_flags;
     d_rtag[p.tag] = add_idx;
     d_comm_flags[add_idx] = 0;
     }
@@ -411,6 +426,7 @@ __global__ void gpu_pdata_add_particles_kernel(unsigned int old_nparticles,
     \param d_net_torque Net torque
     \param d_net_virial Net virial
     \param d_tag Device array of particle tags
+    \param d_group_flags Device array of group membership flags
     \param d_rtag Device array for reverse-lookup table
     \param d_in Device array of packed input particle data
     \param d_comm_flags Device array of communication flags (pdata)
@@ -432,6 +448,7 @@ void gpu_pdata_add_particles(const unsigned int old_nparticles,
                     Scalar *d_net_virial,
                     unsigned int net_virial_pitch,
                     unsigned int *d_tag,
+                    unsigned int *d_group_flags,
                     unsigned int *d_rtag,
                     const pdata_element *d_in,
                     unsigned int *d_comm_flags)
@@ -450,6 +467,7 @@ void gpu_pdata_add_particles(const unsigned int old_nparticles,
     assert(d_net_torque);
     assert(d_net_virial);
     assert(d_tag);
+    assert(d_group_flags);
     assert(d_rtag);
     assert(d_in);
 
@@ -474,6 +492,7 @@ void gpu_pdata_add_particles(const unsigned int old_nparticles,
         d_net_virial,
         net_virial_pitch,
         d_tag,
+        d_group_flags,
         d_rtag,
         d_in,
         d_comm_flags);
@@ -42,6 +42,7 @@ struct pdata_element
     Scalar4 angmom;            //!< Angular momentum
     Scalar3 inertia;           //!< Moments of inertia
     unsigned int tag;          //!< global tag
+    unsigned int group_flags;  //!< group membership bits
     Scalar4 net_force;         //!< net force
     Scalar4 net_torque;        //!< net torque
     Scalar net_virial[6];      //!< net virial
@@ -68,6 +69,7 @@ unsigned int gpu_pdata_remove(const unsigned int N,
                     const Scalar *d_net_virial,
                     unsigned int net_virial_pitch,
                     const unsigned int *d_tag,
+                    const unsigned int *d_group_flags,
                     unsigned int *d_rtag,
                     Scalar4 *d_pos_alt,
                     Scalar4 *d_vel_alt,
@@ -83,6 +85,7 @@ unsigned int gpu_pdata_remove(const unsigned int N,
                     Scalar4 *d_net_torque_alt,
                     Scalar *d_net_virial_alt,
                     unsigned int *d_tag_alt,
+                    unsigned int *d_group_flags_alt,
                     pdata_element *d_out,
                     unsigned int *d_comm_flags,
                     unsigned int *d_comm_flags_out,
@@ -109,6 +112,7 @@ void gpu_pdata_add_particles(const unsigned int old_nparticles,
                     Scalar *d_net_virial,
                     unsigned int net_virial_pitch,
                     unsigned int *d_tag,
+                    unsigned int *d_group_flags,
                     unsigned int *d_rtag,
                     const pdata_element *d_in,
                     unsigned int *d_comm_flags);
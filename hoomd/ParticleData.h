@@ -110,6 +110,9 @@ const unsigned int MIN_FLOPPY = 0x80000000;
 //! Sentinel value in \a r_tag to signify that this particle is not currently present on the local processor
 const unsigned int NOT_LOCAL = 0xffffffff;
 
+//! Sentinel value returned by ParticleData::acquireGroupFlag() when all group membership bits are in use
+const unsigned int NO_GROUP_FLAG = 0xffffffff;
+
 #ifdef ENABLE_MPI
 namespace cereal
     {
@@ -261,11 +264,25 @@ struct pdata_element
     Scalar4 angmom;            //!< Angular momentum
     Scalar3 inertia;           //!< Principal moments of inertia
     unsigned int tag;          //!< global tag
+    unsigned int group_flags;  //!< group membership bits
     Scalar4 net_force;         //!< net force
     Scalar4 net_torque;        //!< net torque
     Scalar net_virial[6];      //!< net virial
     };
 
+#ifdef ENABLE_MPI
+//! Records where the particles of a distributed snapshot were sent
+/*! In a distributed snapshot, every rank holds a contiguous slice of the particles, and the slices are tagged in rank
+    order. ParticleData::initializeFromDistributedSnapshot() sends each particle to the rank that owns it, and the bonded
+    group data uses this record to send the groups to the same ranks as their member particles.
+*/
+struct SnapshotParticleOwners
+    {
+    std::vector<unsigned int> tag_offset; //!< First tag in the slice of every rank, followed by the number of particles
+    std::vector<unsigned int> owner;      //!< Rank that owns each particle of the local slice
+    };
+#endif
+
 //! Manages all of the data arrays for the particles
 /*! <h1> General </h1>
     ParticleData stores and manages particle coordinates, velocities, accelerations, type,
@@ -611,6 +628,18 @@ class PYBIND11_EXPORT ParticleData
         //! Return body ids
         const GlobalArray< unsigned int >& getBodies() const { return m_body; }
 
+        //! Return group membership flags
+        /*! Bit \a b of a particle's flags is set when the particle belongs to the ParticleGroup that holds bit \a b.
+            The flags travel with the particles when they are sorted or migrated.
+        */
+        const GlobalArray< unsigned int >& getGroupFlags() const { return m_group_flags; }
+
+        //! Reserve a group membership bit
+        unsigned int acquireGroupFlag();
+
+        //! Return a group membership bit to the pool and clear it on all local particles
+        void releaseGroupFlag(unsigned int bit);
+
         /*!
          * Access methods to stand-by arrays for fast swapping in of reordered particle data
          *
@@ -680,6 +709,12 @@ class PYBIND11_EXPORT ParticleData
         //! Swap in bodies
         inline void swapBodies() { m_body.swap(m_body_alt); }
 
+        //! Return group membership flags (alternate array)
+        const GlobalArray< unsigned int >& getAltGroupFlags() const { return m_group_flags_alt; }
+
+        //! Swap in group membership flags
+        inline void swapGroupFlags() { m_group_flags.swap(m_group_flags_alt); }
+
         //! Get the net force array (alternate array)
         const GlobalArray< Scalar4 >& getAltNetForce() const { return m_net_force_alt; }
 
@@ -996,6 +1031,13 @@ class PYBIND11_EXPORT ParticleData
         template <class Real>
         void initializeFromSnapshot(const SnapshotParticleData<Real> & snapshot, bool ignore_bodies=false);
 
+        #ifdef ENABLE_MPI
+        //! Initialize from snapshots that hold a slice of the particles on every rank
+        template <class Real>
+        void initializeFromDistributedSnapshot(const SnapshotParticleData<Real>& snapshot,
+            SnapshotParticleOwners& owners);
+        #endif
+
         //! Take a snapshot
         template <class Real>
         std::map<unsigned int, unsigned int> takeSnapshot(SnapshotParticleData<Real> &snapshot);
@@ -1161,11 +1203,14 @@ class PYBIND11_EXPORT ParticleData
         GlobalArray<unsigned int> m_tag;               //!< particle tags
         GlobalVector<unsigned int> m_rtag;             //!< reverse lookup tags
         GlobalArray<unsigned int> m_body;              //!< rigid body ids
+        GlobalArray<unsigned int> m_group_flags;       //!< group membership bits
         GlobalArray< Scalar4 > m_orientation;          //!< Orientation quaternion for each particle (ignored if not anisotropic)
         GlobalArray< Scalar4 > m_angmom;               //!< Angular momementum quaternion for each particle
         GlobalArray< Scalar3 > m_inertia;              //!< Principal moments of inertia for each particle
         GlobalArray<unsigned int> m_comm_flags;        //!< Array of communication flags
 
+        unsigned int m_group_flags_used;              //!< Group membership bits handed out to ParticleGroups
+
         std::stack<unsigned int> m_recycled_tags;    //!< Global tags of removed particles
         std::set<unsigned int> m_tag_set;            //!< Lookup table for tags by active index
         std::vector<unsigned int> m_cached_tag_set;   //!< Cached constant-time lookup table for tags by active index
@@ -1188,6 +1233,7 @@ class PYBIND11_EXPORT ParticleData
         GlobalArray<int3> m_image_alt;                 //!< particle images (swap-in)
         GlobalArray<unsigned int> m_tag_alt;           //!< particle tags (swap-in)
         GlobalArray<unsigned int> m_body_alt;          //!< rigid body ids (swap-in)
+        GlobalArray<unsigned int> m_group_flags_alt;   //!< group membership bits (swap-in)
         GlobalArray<Scalar4> m_orientation_alt;        //!< orientations (swap-in)
         GlobalArray<Scalar4> m_angmom_alt;             //!< angular momenta (swap-in)
         GlobalArray<Scalar3> m_inertia_alt;             //!< Principal moments of inertia for each particle (swap-in)
@@ -1238,6 +1284,11 @@ class PYBIND11_EXPORT ParticleData
         template <class Real>
         bool inBox(const SnapshotParticleData<Real>& snap);
 
+        #ifdef ENABLE_MPI
+        //! Helper function to wrap a snapshot particle into the global box and find the rank of its domain
+        unsigned int placeSnapshotParticle(Scalar3& pos, int3& img, const unsigned int *cart_ranks) const;
+        #endif
+
         //! Update the CUDA memory hints
         void setGPUAdvice();
     };
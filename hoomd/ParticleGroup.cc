@@ -222,7 +222,10 @@ ParticleGroup::ParticleGroup(std::shared_ptr<SystemDefinition> sysdef,
     : m_sysdef(sysdef),
       m_pdata(sysdef->getParticleData()),
       m_exec_conf(m_pdata->getExecConf()),
+      m_member_tags_valid(true),
       m_num_local_members(0),
+      m_num_global_members(0),
+      m_group_flag(NO_GROUP_FLAG),
       m_particles_sorted(true),
       m_reallocated(false),
       m_global_ptl_num_change(false),
@@ -235,6 +238,17 @@ ParticleGroup::ParticleGroup(std::shared_ptr<SystemDefinition> sysdef,
         m_gpu_partition = GPUPartition(m_exec_conf->getGPUIds());
     #endif
 
+    #ifdef ENABLE_MPI
+    // dynamic groups keep their membership with the particles instead of replicating the tag list on every rank
+    if (m_pdata->getDomainDecomposition() && m_selector && m_update_tags)
+        {
+        m_group_flag = m_pdata->acquireGroupFlag();
+        if (m_group_flag == NO_GROUP_FLAG)
+            m_exec_conf->msg->notice(2) << "ParticleGroup: all group membership flags are in use, "
+                                        << "storing member tags on every rank" << std::endl;
+        }
+    #endif
+
     // update member tag arrays
     updateMemberTags(true);
 
@@ -260,7 +274,10 @@ ParticleGroup::ParticleGroup(std::shared_ptr<SystemDefinition> sysdef, const std
     : m_sysdef(sysdef),
       m_pdata(sysdef->getParticleData()),
       m_exec_conf(m_pdata->getExecConf()),
+      m_member_tags_valid(true),
       m_num_local_members(0),
+      m_num_global_members(0),
+      m_group_flag(NO_GROUP_FLAG),
       m_particles_sorted(true),
       m_reallocated(false),
       m_global_ptl_num_change(false),
@@ -301,6 +318,7 @@ ParticleGroup::ParticleGroup(std::shared_ptr<SystemDefinition> sysdef, const std
     GlobalArray<unsigned int> member_tags_array(member_tags.size(), m_exec_conf);
     m_member_tags.swap(member_tags_array);
     TAG_ALLOCATION(m_member_tags);
+    m_num_global_members = member_tags.size();
 
         {
         ArrayHandle<unsigned int> h_member_tags(m_member_tags, access_location::host, access_mode::overwrite);
@@ -352,6 +370,9 @@ ParticleGroup::~ParticleGroup()
         m_pdata->getParticleSortSignal().disconnect<ParticleGroup, &ParticleGroup::slotParticleSort>(this);
         m_pdata->getMaxParticleNumberChangeSignal().disconnect<ParticleGroup, &ParticleGroup::slotReallocate>(this);
         m_pdata->getGlobalParticleNumberChangeSignal().disconnect<ParticleGroup, &ParticleGroup::slotGlobalParticleNumChange>(this);
+
+        if (m_group_flag != NO_GROUP_FLAG)
+            m_pdata->releaseGroupFlag(m_group_flag);
         }
     }
 
@@ -359,6 +380,13 @@ ParticleGroup::~ParticleGroup()
  */
 void ParticleGroup::updateMemberTags(bool force_update) const
     {
+    if (m_group_flag != NO_GROUP_FLAG)
+        {
+        // dynamic groups always re-evaluate the selector
+        updateMemberFlags();
+        return;
+        }
+
     if (m_selector && !(m_update_tags || force_update) && ! m_warning_printed)
         {
         m_pdata->getExecConf()->msg->warning()
@@ -403,6 +431,7 @@ void ParticleGroup::updateMemberTags(bool force_update) const
         GlobalArray<unsigned int> member_tags_array(member_tags.size(), m_pdata->getExecConf());
         m_member_tags.swap(member_tags_array);
         TAG_ALLOCATION(m_member_tags);
+        m_num_global_members = member_tags.size();
 
         // sort member tags
         std::sort(member_tags.begin(), member_tags.end());
@@ -433,10 +462,162 @@ void ParticleGroup::updateMemberTags(bool force_update) const
     rebuildIndexList();
     }
 
+/*! The selector returns the tags of local particles only, so no communication is needed to find the members.
+    The global member count is obtained by a reduction, and the sorted tag list is only built on request.
+ */
+void ParticleGroup::updateMemberFlags() const
+    {
+    assert(m_group_flag != NO_GROUP_FLAG);
+
+    m_exec_conf->msg->notice(7) << "ParticleGroup: rebuilding membership flags" << std::endl;
+
+    vector<unsigned int> member_tags = m_selector->getSelectedTags(m_sysdef);
+
+        {
+        ArrayHandle<unsigned int> h_group_flags(m_pdata->getGroupFlags(), access_location::host, access_mode::readwrite);
+        ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+
+        unsigned int mask = 1u << m_group_flag;
+        unsigned int nparticles = m_pdata->getN();
+        for (unsigned int idx = 0; idx < nparticles; ++idx)
+            h_group_flags.data[idx] &= ~mask;
+
+        // ignore tags of particles owned by other ranks
+        unsigned int n_tags = m_pdata->getRTags().size();
+        for (auto tag : member_tags)
+            {
+            if (tag < n_tags && h_rtag.data[tag] < nparticles)
+                h_group_flags.data[h_rtag.data[tag]] |= mask;
+            }
+        }
+
+    // the index list holds at most all local particles
+    if (m_is_member.getNumElements() != m_pdata->getMaxN())
+        {
+        GlobalArray<unsigned int> is_member(m_pdata->getMaxN(), m_exec_conf);
+        m_is_member.swap(is_member);
+        TAG_ALLOCATION(m_is_member);
+        }
+
+    if (m_member_idx.getNumElements() != m_pdata->getMaxN())
+        {
+        GlobalArray<unsigned int> member_idx(m_pdata->getMaxN(), m_exec_conf);
+        m_member_idx.swap(member_idx);
+        TAG_ALLOCATION(m_member_idx);
+        }
+
+    // drop the stale tag list
+    GlobalArray<unsigned int> member_tags_array;
+    m_member_tags.swap(member_tags_array);
+    m_member_tags_valid = false;
+
+    rebuildIndexList();
+
+    m_num_global_members = m_num_local_members;
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        {
+        MPI_Allreduce(MPI_IN_PLACE, &m_num_global_members, 1, MPI_UNSIGNED, MPI_SUM, m_exec_conf->getMPICommunicator());
+        }
+    #endif
+    }
+
+/*! \param all_ranks If true, every rank receives the full list, otherwise only the root rank does
+    \returns The sorted tags of all group members
+ */
+std::vector<unsigned int> ParticleGroup::collectMemberTags(bool all_ranks) const
+    {
+    std::vector<unsigned int> member_tags(m_num_local_members);
+
+        {
+        ArrayHandle<unsigned int> h_member_idx(m_member_idx, access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+        for (unsigned int i = 0; i < m_num_local_members; ++i)
+            member_tags[i] = h_tag.data[h_member_idx.data[i]];
+        }
+
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        {
+        std::vector< std::vector<unsigned int> > member_tags_proc(m_exec_conf->getNRanks());
+        if (all_ranks)
+            all_gather_v(member_tags, member_tags_proc, m_exec_conf->getMPICommunicator());
+        else
+            gather_v(member_tags, member_tags_proc, 0, m_exec_conf->getMPICommunicator());
+
+        member_tags.clear();
+        if (all_ranks || m_exec_conf->isRoot())
+            {
+            member_tags.reserve(m_num_global_members);
+            for (unsigned int irank = 0; irank < m_exec_conf->getNRanks(); ++irank)
+                member_tags.insert(member_tags.end(), member_tags_proc[irank].begin(), member_tags_proc[irank].end());
+            }
+        }
+    #endif
+
+    std::sort(member_tags.begin(), member_tags.end());
+    return member_tags;
+    }
+
+/*! This is a collective call. Afterwards, getMemberTag() can be used on the root rank until the membership changes.
+    Groups that replicate their tag list on every rank return immediately.
+ */
+void ParticleGroup::gatherMemberTags() const
+    {
+    checkRebuild();
+
+    if (m_member_tags_valid)
+        return;
+
+    std::vector<unsigned int> member_tags = collectMemberTags(false);
+
+    GlobalArray<unsigned int> member_tags_array(member_tags.size(), m_exec_conf);
+    m_member_tags.swap(member_tags_array);
+    TAG_ALLOCATION(m_member_tags);
+
+        {
+        ArrayHandle<unsigned int> h_member_tags(m_member_tags, access_location::host, access_mode::overwrite);
+        std::copy(member_tags.begin(), member_tags.end(), h_member_tags.data);
+        }
+
+    m_member_tags_valid = m_exec_conf->isRoot();
+    }
+
+/*! \returns The sorted tags of all group members on every rank
+    \note This is a collective call for groups that store their membership in the particle flags
+ */
+std::vector<unsigned int> ParticleGroup::getMemberTagsAllRanks() const
+    {
+    checkRebuild();
+
+    if (m_group_flag != NO_GROUP_FLAG)
+        return collectMemberTags(true);
+
+    ArrayHandle<unsigned int> h_member_tags(m_member_tags, access_location::host, access_mode::read);
+    return std::vector<unsigned int>(h_member_tags.data, h_member_tags.data + m_num_global_members);
+    }
+
+void ParticleGroup::checkMemberTags() const
+    {
+    if (! m_member_tags_valid)
+        {
+        m_exec_conf->msg->error() << "group: member tags are not available on this rank, "
+                                  << "call gatherMemberTags() on all ranks first." << std::endl;
+        throw std::runtime_error("Error accessing ParticleGroup member tags");
+        }
+    }
+
 void ParticleGroup::reallocate() const
     {
     m_is_member.resize(m_pdata->getMaxN());
 
+    if (m_group_flag != NO_GROUP_FLAG)
+        {
+        // the index list holds at most all local particles, and there is no tag lookup table
+        m_member_idx.resize(m_pdata->getMaxN());
+        return;
+        }
+
     if (m_is_member_tag.getNumElements() != m_pdata->getRTags().size())
         {
         // reallocate if necessary
@@ -514,36 +695,23 @@ std::shared_ptr<ParticleGroup> ParticleGroup::groupUnion(std::shared_ptr<Particl
 
     if (a != b)
         {
-        unsigned int n_a = a->getNumMembersGlobal();
-        unsigned int n_b = b->getNumMembersGlobal();
-
         // make the union
-        ArrayHandle<unsigned int> h_members_a(a->m_member_tags, access_location::host, access_mode::read);
-        ArrayHandle<unsigned int> h_members_b(b->m_member_tags, access_location::host, access_mode::read);
+        vector<unsigned int> members_a = a->getMemberTagsAllRanks();
+        vector<unsigned int> members_b = b->getMemberTagsAllRanks();
 
         insert_iterator< vector<unsigned int> > ii(member_tags, member_tags.begin());
-        set_union(h_members_a.data,
-                  h_members_a.data + n_a,
-                  h_members_b.data,
-                  h_members_b.data + n_b,
+        set_union(members_a.begin(),
+                  members_a.end(),
+                  members_b.begin(),
+                  members_b.end(),
                   ii);
         }
     else
         {
-        unsigned int n_a = a->getNumMembersGlobal();
-
-        // If the two arguments are the same, just return a copy of the whole group (we cannot
-        // acquire the member_tags array twice)
-        ArrayHandle<unsigned int> h_members_a(a->m_member_tags, access_location::host, access_mode::read);
-
-        insert_iterator< vector<unsigned int> > ii(member_tags, member_tags.begin());
-        std::copy(h_members_a.data,
-                  h_members_a.data + n_a,
-                  ii);
+        // If the two arguments are the same, just return a copy of the whole group
+        member_tags = a->getMemberTagsAllRanks();
         }
 
-
-
     // create the new particle group
     std::shared_ptr<ParticleGroup> new_group(new ParticleGroup(a->m_sysdef, member_tags));
 
@@ -565,31 +733,21 @@ std::shared_ptr<ParticleGroup> ParticleGroup::groupIntersection(std::shared_ptr<
 
     if (a != b)
         {
-        unsigned int n_a = a->getNumMembersGlobal();
-        unsigned int n_b = b->getNumMembersGlobal();
-
         // make the intersection
-        ArrayHandle<unsigned int> h_members_a(a->m_member_tags, access_location::host, access_mode::read);
-        ArrayHandle<unsigned int> h_members_b(b->m_member_tags, access_location::host, access_mode::read);
+        vector<unsigned int> members_a = a->getMemberTagsAllRanks();
+        vector<unsigned int> members_b = b->getMemberTagsAllRanks();
 
         insert_iterator< vector<unsigned int> > ii(member_tags, member_tags.begin());
-        set_intersection(h_members_a.data,
-                         h_members_a.data + n_a,
-                         h_members_b.data,
-                         h_members_b.data + n_b,
-                         ii);
+        set_intersection(members_a.begin(),
+                  members_a.end(),
+                  members_b.begin(),
+                  members_b.end(),
+                  ii);
         }
     else
         {
-        unsigned int n_a = a->getNumMembersGlobal();
-        // If the two arguments are the same, just return a copy of the whole group (we cannot
-        // acquire the member_tags array twice)
-        ArrayHandle<unsigned int> h_members_a(a->m_member_tags, access_location::host, access_mode::read);
-
-        insert_iterator< vector<unsigned int> > ii(member_tags, member_tags.begin());
-        std::copy(h_members_a.data,
-                  h_members_a.data + n_a,
-                  ii);
+        // If the two arguments are the same, just return a copy of the whole group
+        member_tags = a->getMemberTagsAllRanks();
         }
 
     // create the new particle group
@@ -613,26 +771,22 @@ std::shared_ptr<ParticleGroup> ParticleGroup::groupDifference(std::shared_ptr<Pa
 
     if (a != b)
         {
-        unsigned int n_a = a->getNumMembersGlobal();
-        unsigned int n_b = b->getNumMembersGlobal();
         // make the difference
-        ArrayHandle<unsigned int> h_members_a(a->m_member_tags, access_location::host, access_mode::read);
-        ArrayHandle<unsigned int> h_members_b(b->m_member_tags, access_location::host, access_mode::read);
+        vector<unsigned int> members_a = a->getMemberTagsAllRanks();
+        vector<unsigned int> members_b = b->getMemberTagsAllRanks();
 
         insert_iterator< vector<unsigned int> > ii(member_tags, member_tags.begin());
-        set_difference(h_members_a.data,
-                  h_members_a.data + n_a,
-                  h_members_b.data,
-                  h_members_b.data + n_b,
+        set_difference(members_a.begin(),
+                  members_a.end(),
+                  members_b.begin(),
+                  members_b.end(),
                   ii);
         }
     else
         {
-        // If the two arguments are the same, just return an empty group (we cannot
-        // acquire the member_tags array twice)
+        // If the two arguments are the same, just return an empty group
         }
 
-
     // create the new particle group
     std::shared_ptr<ParticleGroup> new_group(new ParticleGroup(a->m_sysdef, member_tags));
 
@@ -678,17 +832,31 @@ void ParticleGroup::rebuildIndexList() const
 
         // rebuild the membership flags for the  indices in the group and construct member list
         ArrayHandle<unsigned int> h_is_member(m_is_member, access_location::host, access_mode::readwrite);
-        ArrayHandle<unsigned int> h_is_member_tag(m_is_member_tag, access_location::host, access_mode::read);
-        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
         ArrayHandle<unsigned int> h_member_idx(m_member_idx, access_location::host, access_mode::readwrite);
         unsigned int nparticles = m_pdata->getN();
+
+        if (m_group_flag != NO_GROUP_FLAG)
+            {
+            // the membership travels with the particles
+            ArrayHandle<unsigned int> h_group_flags(m_pdata->getGroupFlags(), access_location::host, access_mode::read);
+            for (unsigned int idx = 0; idx < nparticles; idx ++)
+                h_is_member.data[idx] = (h_group_flags.data[idx] >> m_group_flag) & 1;
+            }
+        else
+            {
+            ArrayHandle<unsigned int> h_is_member_tag(m_is_member_tag, access_location::host, access_mode::read);
+            ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+            for (unsigned int idx = 0; idx < nparticles; idx ++)
+                {
+                assert(h_tag.data[idx] <= m_pdata->getMaximumTag());
+                h_is_member.data[idx] = h_is_member_tag.data[h_tag.data[idx]];
+                }
+            }
+
         unsigned int cur_member = 0;
         for (unsigned int idx = 0; idx < nparticles; idx ++)
             {
-            assert(h_tag.data[idx] <= m_pdata->getMaximumTag());
-            unsigned int is_member = h_is_member_tag.data[h_tag.data[idx]];
-            h_is_member.data[idx] =  is_member;
-            if (is_member)
+            if (h_is_member.data[idx])
                 {
                 h_member_idx.data[cur_member] = idx;
                 cur_member++;
@@ -696,7 +864,7 @@ void ParticleGroup::rebuildIndexList() const
             }
 
         m_num_local_members = cur_member;
-        assert(m_num_local_members <= m_member_tags.getNumElements());
+        assert(m_group_flag != NO_GROUP_FLAG || m_num_local_members <= m_member_tags.getNumElements());
         }
 
     // index has been rebuilt
@@ -743,20 +911,31 @@ void ParticleGroup::updateGPUAdvice() const
 void ParticleGroup::rebuildIndexListGPU() const
     {
     ArrayHandle<unsigned int> d_is_member(m_is_member, access_location::device, access_mode::overwrite);
-    ArrayHandle<unsigned int> d_is_member_tag(m_is_member_tag, access_location::device, access_mode::read);
     ArrayHandle<unsigned int> d_member_idx(m_member_idx, access_location::device, access_mode::overwrite);
-    ArrayHandle<unsigned int> d_tag(m_pdata->getTags(), access_location::device, access_mode::read);
 
     // get temporary buffer
     ScopedAllocation<unsigned int> d_tmp(m_pdata->getExecConf()->getCachedAllocator(), m_pdata->getN());
 
     // reset membership properties
-    if (m_member_tags.getNumElements() > 0)
+    if (m_group_flag != NO_GROUP_FLAG || m_member_tags.getNumElements() > 0)
         {
-        gpu_rebuild_index_list(m_pdata->getN(),
-                           d_is_member_tag.data,
-                           d_is_member.data,
-                           d_tag.data);
+        if (m_group_flag != NO_GROUP_FLAG)
+            {
+            ArrayHandle<unsigned int> d_group_flags(m_pdata->getGroupFlags(), access_location::device, access_mode::read);
+            gpu_rebuild_index_list_flags(m_pdata->getN(),
+                               d_group_flags.data,
+                               m_group_flag,
+                               d_is_member.data);
+            }
+        else
+            {
+            ArrayHandle<unsigned int> d_is_member_tag(m_is_member_tag, access_location::device, access_mode::read);
+            ArrayHandle<unsigned int> d_tag(m_pdata->getTags(), access_location::device, access_mode::read);
+            gpu_rebuild_index_list(m_pdata->getN(),
+                               d_is_member_tag.data,
+                               d_is_member.data,
+                               d_tag.data);
+            }
         if (m_exec_conf->isCUDAErrorCheckingEnabled())
             CHECK_CUDA_ERROR();
 
@@ -896,6 +1075,7 @@ void export_ParticleGroup(py::module& m)
             .def(py::init<>())
             .def("getNumMembersGlobal", &ParticleGroup::getNumMembersGlobal)
             .def("getMemberTag", &ParticleGroup::getMemberTag)
+            .def("gatherMemberTags", &ParticleGroup::gatherMemberTags)
             .def("getTotalMass", &ParticleGroup::getTotalMass)
             .def("getCenterOfMass", &ParticleGroup::getCenterOfMass)
             .def("groupUnion", &ParticleGroup::groupUnion)
@@ -137,6 +137,16 @@ class PYBIND11_EXPORT ParticleFilterRigidCenter : public ParticleFilter
     For that it needs a list of indices of all the particles in the group. To facilitates this, the list of indices
     in the group will be stored in a GPUArray.
 
+    <b>Domain decomposition</b>
+
+    The sorted tag list and the per-tag lookup table scale with the global number of particles, on every rank.
+    Dynamic groups (built from a ParticleFilter with update_tags=true) in domain decomposition runs therefore do
+    not store them. Such a group instead owns one bit of the per-particle group flags in ParticleData
+    (see ParticleData::acquireGroupFlag()), which travels with the particles when they are sorted or migrated. The
+    filter is evaluated on the local particles only, and the global member count is obtained by a reduction.
+    The sorted tag list is assembled on the root rank only when a writer asks for it with gatherMemberTags().
+    When all bits are taken, the group falls back to the replicated tag list.
+
     \ingroup data_structs
 */
 class PYBIND11_EXPORT ParticleGroup
@@ -146,7 +156,8 @@ class PYBIND11_EXPORT ParticleGroup
         // @{
 
         //! Constructs an empty particle group
-        ParticleGroup() : m_num_local_members(0) {};
+        ParticleGroup() : m_member_tags_valid(true), m_num_local_members(0), m_num_global_members(0),
+            m_group_flag(NO_GROUP_FLAG) {};
 
         //! Constructs a particle group of all particles that meet the given selection
         ParticleGroup(std::shared_ptr<SystemDefinition> sysdef, std::shared_ptr<ParticleFilter> selector,
@@ -166,6 +177,9 @@ class PYBIND11_EXPORT ParticleGroup
         //! Updates the members tags of a particle group according to a selection
         void updateMemberTags(bool force_update) const;
 
+        //! Collect the sorted member tags so that getMemberTag() can be called on the root rank
+        void gatherMemberTags() const;
+
         // @}
         //! \name Accessor methods
         // @{
@@ -177,7 +191,7 @@ class PYBIND11_EXPORT ParticleGroup
             {
             checkRebuild();
 
-            return (unsigned int)m_member_tags.getNumElements();
+            return m_num_global_members;
             }
 
         //! Get the number of members that are present on the local processor
@@ -193,10 +207,13 @@ class PYBIND11_EXPORT ParticleGroup
         //! Get a member from the group
         /*! \param i Index from 0 to getNumMembersGlobal()-1 of the group member to get
             \returns Tag of the member at index \a i
+            \note Groups that store their membership in the particle flags need a prior call to gatherMemberTags()
+                  on all ranks, after which the tags are available on the root rank.
         */
         unsigned int getMemberTag(unsigned int i) const
             {
             checkRebuild();
+            checkMemberTags();
 
             assert(i < getNumMembersGlobal());
             ArrayHandle<unsigned int> h_member_tags(m_member_tags, access_location::host, access_mode::read);
@@ -335,7 +352,10 @@ class PYBIND11_EXPORT ParticleGroup
         mutable GlobalArray<unsigned int> m_is_member;    //!< One byte per particle, == 1 if index is a local member of the group
         mutable GlobalArray<unsigned int> m_member_idx;    //!< List of all particle indices in the group
         mutable GlobalArray<unsigned int> m_member_tags;   //!< Lists the tags of the particle members
+        mutable bool m_member_tags_valid;               //!< True if m_member_tags lists the current members
         mutable unsigned int m_num_local_members;       //!< Number of members on the local processor
+        mutable unsigned int m_num_global_members;      //!< Number of members on all processors
+        unsigned int m_group_flag;                      //!< Bit of the particle group flags holding the membership, or NO_GROUP_FLAG
         mutable bool m_particles_sorted;                //!< True if particle have been sorted since last rebuild
         mutable bool m_reallocated;                     //!< True if particle data arrays have been reallocated
         mutable bool m_global_ptl_num_change;           //!< True if the global particle number changed
@@ -413,6 +433,18 @@ class PYBIND11_EXPORT ParticleGroup
         //! Helper function to build the 1:1 hash for tag membership
         void buildTagHash() const;
 
+        //! Helper function to set the membership flags of the local particles from the selector
+        void updateMemberFlags() const;
+
+        //! Helper function to collect the sorted tags of all members
+        std::vector<unsigned int> collectMemberTags(bool all_ranks) const;
+
+        //! Helper function to get a copy of the member tags on every rank
+        std::vector<unsigned int> getMemberTagsAllRanks() const;
+
+        //! Helper function to make sure the member tags are available
+        void checkMemberTags() const;
+
 #ifdef ENABLE_HIP
         //! Helper function to rebuild the index lists after the particles have been sorted
         void rebuildIndexListGPU() const;
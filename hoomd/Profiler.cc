@@ -191,7 +191,7 @@ void ProfileDataElem::output_line(std::ostream &o,
 ////////////////////////////////////////////////////////////////////
 // Profiler
 
-Profiler::Profiler(const std::string& name) : m_name(name)
+Profiler::Profiler(const std::string& name) : m_name(name), m_concurrent(false)
     {
     // push the root onto the top of the stack so that it is the default
     m_stack.push(&m_root);
@@ -204,6 +204,17 @@ Profiler::Profiler(const std::string& name) : m_name(name)
     #endif
     }
 
+/*! \param name Name of the sub-category
+    \param elapsed_time Time taken by the task (in nanoseconds)
+
+    Call this after the concurrent tasks have finished, from the thread that pushes and pops.
+*/
+void Profiler::addTaskTime(const std::string& name, int64_t elapsed_time)
+    {
+    assert(!m_stack.empty());
+    m_stack.top()->m_children[name].m_elapsed_time += elapsed_time;
+    }
+
 void Profiler::output(std::ostream &o)
     {
     // perform a sanity check, but don't bail out
@@ -118,6 +118,10 @@ class PYBIND11_EXPORT ProfileDataElem
     to provide accurate timing information.
 
     These profiles can of course be output via normal ostream operators.
+
+    push() and pop() are not thread safe. While tasks run concurrently, beginConcurrent() turns them into no-ops,
+    and the time taken by each task is added to the profile afterwards with addTaskTime(). The times of concurrent
+    tasks may add up to more than the time of the category they are in.
     \ingroup utils
     */
 class PYBIND11_EXPORT Profiler
@@ -135,11 +139,27 @@ class PYBIND11_EXPORT Profiler
         //! Pops back up to the next super-category & syncs the GPUs
         void pop(std::shared_ptr<const ExecutionConfiguration> exec_conf, uint64_t flop_count = 0, uint64_t byte_count = 0);
 
+        //! Ignore push() and pop() while tasks run concurrently
+        void beginConcurrent()
+            {
+            m_concurrent = true;
+            }
+
+        //! Stop ignoring push() and pop()
+        void endConcurrent()
+            {
+            m_concurrent = false;
+            }
+
+        //! Adds the time taken by a task to a sub-category of the current category
+        void addTaskTime(const std::string& name, int64_t elapsed_time);
+
     private:
         ClockSource m_clk;  //!< Clock to provide timing information
         std::string m_name; //!< The name of this profile
         ProfileDataElem m_root; //!< The root profile element
         std::stack<ProfileDataElem *> m_stack;  //!< A stack of data elements for the push/pop structure
+        bool m_concurrent;  //!< True while push() and pop() are ignored
 
         //! Output helper function
         void output(std::ostream &o);
@@ -188,6 +208,10 @@ inline void Profiler::pop(std::shared_ptr<const ExecutionConfiguration> exec_con
 
 inline void Profiler::push(const std::string& name)
     {
+    // concurrent tasks are timed with addTaskTime()
+    if (m_concurrent)
+        return;
+
     // sanity checks
     assert(!m_stack.empty());
 
@@ -214,6 +238,9 @@ inline void Profiler::push(const std::string& name)
 
 inline void Profiler::pop(uint64_t flop_count, uint64_t byte_count)
     {
+    if (m_concurrent)
+        return;
+
     // sanity checks
     assert(!m_stack.empty());
     assert(!(m_stack.top() == &m_root));
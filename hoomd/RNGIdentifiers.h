@@ -30,6 +30,8 @@ struct RNGIdentifier
     static const uint32_t HPMCDepletants = 0x6b71abc8;
     static const uint32_t HPMCDepletantNum = 0x89effeba;
     static const uint32_t HPMCMonoAccept = 0xbfabfabf;
+    static const uint32_t HPMCMonoCheckerboard = 0x5c8e1b3d;
+    static const uint32_t HPMCMonoNEC = 0x3e0c7a91;
     static const uint32_t UpdaterBoxMC= 0xf6a510ab;
     static const uint32_t UpdaterClusters =  0x09365bf5;
     static const uint32_t UpdaterClustersPairwise = 0x50060112;
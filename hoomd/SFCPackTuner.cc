@@ -120,6 +120,7 @@ void SFCPackTuner::applySortOrder()
     ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::readwrite);
     ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::readwrite);
     ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_group_flags(m_pdata->getGroupFlags(), access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(), access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::host, access_mode::readwrite);
     ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::readwrite);
@@ -228,6 +229,12 @@ void SFCPackTuner::applySortOrder()
     for (unsigned int i = 0; i < m_pdata->getN(); i++)
         h_body.data[i] = uint_tmp[i];
 
+    // sort group membership flags
+    for (unsigned int i = 0; i < m_pdata->getN(); i++)
+        uint_tmp[i] = h_group_flags.data[m_sort_order[i]];
+    for (unsigned int i = 0; i < m_pdata->getN(); i++)
+        h_group_flags.data[i] = uint_tmp[i];
+
     // sort global tag
     for (unsigned int i = 0; i < m_pdata->getN(); i++)
         uint_tmp[i] = h_tag.data[m_sort_order[i]];
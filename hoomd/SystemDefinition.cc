@@ -167,18 +167,52 @@ void SystemDefinition::initializeFromSnapshot(std::shared_ptr< SnapshotSystemDat
     m_pair_data->initializeFromSnapshot(snapshot->pair_data);
     }
 
+/*! \param snapshot The slice of the system held by this rank
+
+    Every rank holds a contiguous slice of the particles and of each kind of bonded group, together with the box,
+    dimensions and type names. The particles and groups are sent to the ranks that own them without gathering the
+    system on the root rank. Without domain decomposition, the snapshot holds the whole system.
+*/
+template <class Real>
+void SystemDefinition::initializeFromDistributedSnapshot(std::shared_ptr< SnapshotSystemData<Real> > snapshot)
+    {
+    #ifdef ENABLE_MPI
+    if (m_particle_data->getDomainDecomposition())
+        {
+        setNDimensions(snapshot->dimensions);
+
+        m_particle_data->setGlobalBox(snapshot->global_box);
+
+        SnapshotParticleOwners owners;
+        m_particle_data->initializeFromDistributedSnapshot(snapshot->particle_data, owners);
+        m_bond_data->initializeFromDistributedSnapshot(snapshot->bond_data, owners);
+        m_angle_data->initializeFromDistributedSnapshot(snapshot->angle_data, owners);
+        m_dihedral_data->initializeFromDistributedSnapshot(snapshot->dihedral_data, owners);
+        m_improper_data->initializeFromDistributedSnapshot(snapshot->improper_data, owners);
+        m_constraint_data->initializeFromDistributedSnapshot(snapshot->constraint_data, owners);
+        m_pair_data->initializeFromDistributedSnapshot(snapshot->pair_data, owners);
+        }
+    else
+    #endif
+        {
+        initializeFromSnapshot(snapshot);
+        }
+    }
+
 // instantiate both float and double methods
 template SystemDefinition::SystemDefinition(std::shared_ptr< SnapshotSystemData<float> > snapshot,
                                                    std::shared_ptr<ExecutionConfiguration> exec_conf,
                                                    std::shared_ptr<DomainDecomposition> decomposition);
 template std::shared_ptr< SnapshotSystemData<float> > SystemDefinition::takeSnapshot<float>();
 template void SystemDefinition::initializeFromSnapshot<float>(std::shared_ptr< SnapshotSystemData<float> > snapshot);
+template void SystemDefinition::initializeFromDistributedSnapshot<float>(std::shared_ptr< SnapshotSystemData<float> > snapshot);
 
 template SystemDefinition::SystemDefinition(std::shared_ptr< SnapshotSystemData<double> > snapshot,
                                                    std::shared_ptr<ExecutionConfiguration> exec_conf,
                                                    std::shared_ptr<DomainDecomposition> decomposition);
 template std::shared_ptr< SnapshotSystemData<double> > SystemDefinition::takeSnapshot<double>();
 template void SystemDefinition::initializeFromSnapshot<double>(std::shared_ptr< SnapshotSystemData<double> > snapshot);
+template void SystemDefinition::initializeFromDistributedSnapshot<double>(std::shared_ptr< SnapshotSystemData<double> > snapshot);
 
 void export_SystemDefinition(py::module& m)
     {
@@ -204,5 +238,7 @@ void export_SystemDefinition(py::module& m)
     .def("takeSnapshot_double", &SystemDefinition::takeSnapshot<double>)
     .def("initializeFromSnapshot", &SystemDefinition::initializeFromSnapshot<float>)
     .def("initializeFromSnapshot", &SystemDefinition::initializeFromSnapshot<double>)
+    .def("initializeFromDistributedSnapshot", &SystemDefinition::initializeFromDistributedSnapshot<float>)
+    .def("initializeFromDistributedSnapshot", &SystemDefinition::initializeFromDistributedSnapshot<double>)
     ;
     }
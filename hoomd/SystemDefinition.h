@@ -151,6 +151,10 @@ class PYBIND11_EXPORT SystemDefinition
         template <class Real>
         void initializeFromSnapshot(std::shared_ptr< SnapshotSystemData<Real> > snapshot);
 
+        //! Re-initialize the system from snapshots that hold a slice of the system on every rank
+        template <class Real>
+        void initializeFromDistributedSnapshot(std::shared_ptr< SnapshotSystemData<Real> > snapshot);
+
     private:
         unsigned int m_n_dimensions;                        //!< Dimensionality of the system
         std::shared_ptr<ParticleData> m_particle_data;    //!< Particle data for the system
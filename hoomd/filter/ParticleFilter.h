@@ -24,7 +24,8 @@
     of particle tags meeting the criteria.
 
     In MPI simulations, getSelectedTags() should return only tags on the local
-    rank.
+    rank. ParticleGroup evaluates filters on every rank without gathering the
+    result, so the cost of a filter should scale with the local particle count.
 
     The base class getSelectedTags() method returns an empty vector.
 */
@@ -32,12 +32,28 @@ class PYBIND11_EXPORT ParticleFilterTags : public ParticleFilter
          *  sysdef System Definition
          *
          *  Returns:
-         *  m_tags
+         *  the tags in m_tags of all rank local particles
         */
         virtual std::vector<unsigned int> getSelectedTags(
                 std::shared_ptr<SystemDefinition> sysdef) const
             {
-            return m_tags;
+            const auto pdata = sysdef->getParticleData();
+            const ArrayHandle<unsigned int> h_rtag(pdata->getRTags(),
+                                                   access_location::host,
+                                                   access_mode::read);
+
+            // keep the tags of particles owned by this rank
+            const auto N = pdata->getN();
+            const auto n_tags = pdata->getRTags().size();
+            std::vector<unsigned int> member_tags;
+            for (auto tag: m_tags)
+                {
+                if (tag < n_tags && h_rtag.data[tag] < N)
+                    {
+                    member_tags.push_back(tag);
+                    }
+                }
+            return member_tags;
             }
     protected:
         std::vector<unsigned int> m_tags;     //< Tags to use for filter
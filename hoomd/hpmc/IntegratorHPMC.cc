@@ -20,7 +20,7 @@ namespace hpmc
 IntegratorHPMC::IntegratorHPMC(std::shared_ptr<SystemDefinition> sysdef,
                                unsigned int seed)
     : Integrator(sysdef, 0.005), m_seed(seed),  m_translation_move_probability(32768), m_nselect(4),
-      m_nominal_width(1.0), m_extra_ghost_width(0), m_external_base(NULL), m_patch_log(false),
+      m_checkerboard(false), m_nominal_width(1.0), m_extra_ghost_width(0), m_external_base(NULL), m_patch_log(false),
       m_past_first_run(false)
       #ifdef ENABLE_MPI
       ,m_communicator_ghost_width_connected(false),
@@ -336,6 +336,7 @@ void export_IntegratorHPMC(py::module& m)
         .def_property_readonly("seed", &IntegratorHPMC::getSeed)
         .def_property("nselect", &IntegratorHPMC::getNSelect, &IntegratorHPMC::setNSelect)
         .def_property("translation_move_probability", &IntegratorHPMC::getTranslationMoveProbability, &IntegratorHPMC::setTranslationMoveProbability)
+        .def_property("checkerboard", &IntegratorHPMC::getCheckerboard, &IntegratorHPMC::setCheckerboard)
         ;
 
     py::class_< hpmc_counters_t >(m, "hpmc_counters_t")
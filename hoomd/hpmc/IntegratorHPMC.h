@@ -341,6 +341,21 @@ class PYBIND11_EXPORT IntegratorHPMC : public Integrator
             return m_nselect;
             }
 
+        //! Set the checkerboard sweep mode
+        /*! \param checkerboard True to sweep over the particles in a checkerboard decomposition of the local box
+        */
+        void setCheckerboard(bool checkerboard)
+            {
+            m_checkerboard = checkerboard;
+            }
+
+        //! Get the checkerboard sweep mode
+        //! \returns True if the particles are swept in a checkerboard decomposition of the local box
+        inline bool getCheckerboard()
+            {
+            return m_checkerboard;
+            }
+
         //! Get performance in moves per second
         virtual double getMPS()
             {
@@ -504,6 +519,7 @@ class PYBIND11_EXPORT IntegratorHPMC : public Integrator
         unsigned int m_seed;                        //!< Random number seed
         unsigned int m_translation_move_probability;     //!< Fraction of moves that are translation moves.
         unsigned int m_nselect;                     //!< Number of particles to select for trial moves
+        bool m_checkerboard;                        //!< True to sweep in a checkerboard decomposition (CPU only)
 
         GPUVector<Scalar> m_d;                      //!< Maximum move displacement by type
         GPUVector<Scalar> m_a;                      //!< Maximum angular displacement by type
@@ -113,6 +113,192 @@ class UpdateOrder
         std::vector<unsigned int> m_update_order; //!< Update order
     };
 
+//! Helper class to manage the checkerboard decomposition of the local box
+/*! The local box is divided into cells that are at least as wide as the interaction range. Along each direction
+    with more than one cell, the number of cells is even, so that cells with even and odd indices alternate also
+    across the periodic boundaries. The parity of the cell indices defines the color of a cell. Particles in
+    different cells of the same color cannot interact as long as they stay in their cells, so the cells of one
+    color can be updated independently of each other.
+
+    shift() moves the grid by a random offset and shuffles the order of the colors, bin() sorts the particles
+    into the cells.
+
+    \ingroup hpmc_data_structs
+*/
+class CheckerboardCells
+    {
+    public:
+        //! Number of colors
+        static const unsigned int n_colors = 8;
+
+        //! Constructor
+        CheckerboardCells()
+            : m_dim(make_uint3(1,1,1)), m_shift(make_scalar3(0,0,0))
+            {
+            for (unsigned int color = 0; color < n_colors; color++)
+                m_color_order[color] = color;
+            }
+
+        //! Set the cell dimensions
+        /*! \param box Local box
+            \param width Minimum cell width
+            \param ndim Number of dimensions
+            \param max_cells Upper limit for the number of cells
+        */
+        void setBox(const BoxDim& box, Scalar width, unsigned int ndim, unsigned int max_cells)
+            {
+            m_box = box;
+            max_cells = std::max(max_cells, (unsigned int)n_colors);
+
+            Scalar3 npd = box.getNearestPlaneDistance();
+            Scalar L[3] = {npd.x, npd.y, npd.z};
+            unsigned int dim[3] = {1, 1, 1};
+            for (unsigned int d = 0; d < ndim; d++)
+                {
+                Scalar n = width > Scalar(0.0) ? slow::floor(L[d] / width) : Scalar(max_cells);
+                if (n >= Scalar(2.0))
+                    dim[d] = (unsigned int)std::min(n, Scalar(max_cells)) & ~1u;
+                }
+
+            // there is no use in more cells than particles, coarsen the grid
+            while (dim[0]*dim[1]*dim[2] > max_cells)
+                {
+                unsigned int d = (dim[0] >= dim[1] && dim[0] >= dim[2]) ? 0 : (dim[1] >= dim[2] ? 1 : 2);
+                dim[d] = std::max(2u, (dim[d]/2) & ~1u);
+                }
+
+            uint3 new_dim = make_uint3(dim[0], dim[1], dim[2]);
+            if (new_dim.x == m_dim.x && new_dim.y == m_dim.y && new_dim.z == m_dim.z && m_color_cells[0].size())
+                return;
+
+            m_dim = new_dim;
+            m_cell_indexer = Index3D(m_dim.x, m_dim.y, m_dim.z);
+
+            // list the cells of each color
+            for (unsigned int color = 0; color < n_colors; color++)
+                m_color_cells[color].clear();
+            for (unsigned int cell = 0; cell < m_cell_indexer.getNumElements(); cell++)
+                m_color_cells[getColor(cell)].push_back(cell);
+            }
+
+        //! Draw a new grid offset and color order
+        /*! \param rng Random number generator
+        */
+        template<class RNG>
+        void shift(RNG& rng)
+            {
+            Scalar3 width = make_scalar3(Scalar(1.0)/m_dim.x, Scalar(1.0)/m_dim.y, Scalar(1.0)/m_dim.z);
+            m_shift.x = hoomd::UniformDistribution<Scalar>(0, width.x)(rng);
+            m_shift.y = hoomd::UniformDistribution<Scalar>(0, width.y)(rng);
+            m_shift.z = hoomd::UniformDistribution<Scalar>(0, width.z)(rng);
+
+            for (unsigned int color = 0; color < n_colors; color++)
+                m_color_order[color] = color;
+            for (unsigned int k = n_colors - 1; k > 0; k--)
+                std::swap(m_color_order[k], m_color_order[hoomd::UniformIntDistribution(k)(rng)]);
+            }
+
+        //! Get the cell a position is in
+        unsigned int getCell(const vec3<Scalar>& pos) const
+            {
+            Scalar3 f = m_box.makeFraction(vec_to_scalar3(pos));
+            return m_cell_indexer(wrapIndex(f.x + m_shift.x, m_dim.x),
+                                  wrapIndex(f.y + m_shift.y, m_dim.y),
+                                  wrapIndex(f.z + m_shift.z, m_dim.z));
+            }
+
+        //! Get the color of a cell
+        unsigned int getColor(unsigned int cell) const
+            {
+            uint3 c = m_cell_indexer.getTriple(cell);
+            return (c.x & 1) | ((c.y & 1) << 1) | ((c.z & 1) << 2);
+            }
+
+        //! Sort the particles into the cells
+        /*! \param h_postype Particle positions
+            \param N Number of local particles
+            \param update_order Order of the particles within each cell
+        */
+        void bin(const Scalar4 *h_postype, unsigned int N, UpdateOrder& update_order)
+            {
+            const unsigned int n_cells = m_cell_indexer.getNumElements();
+            m_cell.resize(N);
+            m_cell_start.assign(n_cells+1, 0);
+            for (unsigned int i = 0; i < N; i++)
+                {
+                m_cell[i] = getCell(vec3<Scalar>(h_postype[i]));
+                m_cell_start[m_cell[i]+1]++;
+                }
+            for (unsigned int cell = 0; cell < n_cells; cell++)
+                m_cell_start[cell+1] += m_cell_start[cell];
+
+            m_cell_fill.assign(m_cell_start.begin(), m_cell_start.end()-1);
+            m_particles.resize(N);
+            for (unsigned int cur_particle = 0; cur_particle < N; cur_particle++)
+                {
+                unsigned int i = update_order[cur_particle];
+                m_particles[m_cell_fill[m_cell[i]]++] = i;
+                }
+            }
+
+        //! Get the color updated in the given phase of a sweep
+        unsigned int getColorOrder(unsigned int phase) const
+            {
+            return m_color_order[phase];
+            }
+
+        //! Get the cells of a color
+        const std::vector<unsigned int>& getColorCells(unsigned int color) const
+            {
+            return m_color_cells[color];
+            }
+
+        //! Get the cell of a local particle at the time of the last bin() call
+        unsigned int getParticleCell(unsigned int i) const
+            {
+            return m_cell[i];
+            }
+
+        //! Get the index of the first particle of a cell in getParticles()
+        unsigned int getCellStart(unsigned int cell) const
+            {
+            return m_cell_start[cell];
+            }
+
+        //! Get the index of the last particle of a cell in getParticles(), plus one
+        unsigned int getCellEnd(unsigned int cell) const
+            {
+            return m_cell_start[cell+1];
+            }
+
+        //! Get the particles, sorted by cell
+        const std::vector<unsigned int>& getParticles() const
+            {
+            return m_particles;
+            }
+
+    private:
+        BoxDim m_box;                                           //!< Local box
+        uint3 m_dim;                                            //!< Number of cells along each direction
+        Index3D m_cell_indexer;                                 //!< Indexes the cells
+        Scalar3 m_shift;                                        //!< Grid offset (fractional coordinates)
+        unsigned int m_color_order[n_colors];                   //!< Order of the colors in a sweep
+        std::vector<unsigned int> m_color_cells[n_colors];      //!< Cells of each color
+        std::vector<unsigned int> m_cell;                       //!< Cell of each particle
+        std::vector<unsigned int> m_cell_start;                 //!< Start of each cell in m_particles
+        std::vector<unsigned int> m_cell_fill;                  //!< Fill pointers used in bin()
+        std::vector<unsigned int> m_particles;                  //!< Particles sorted by cell
+
+        //! Map a shifted fractional coordinate to a cell index
+        static unsigned int wrapIndex(Scalar f, unsigned int n)
+            {
+            if (n == 1)
+                return 0;
+            int c = int(slow::floor(f * Scalar(n))) % int(n);
+            return c < 0 ? c + n : c;
+            }
+    };
+
 }; // end namespace detail
 
 //! HPMC on systems of mono-disperse shapes
@@ -455,6 +641,10 @@ class IntegratorHPMCMono : public IntegratorHPMC
 
         Scalar m_extra_image_width;                 //! Extra width to extend the image list
 
+        detail::CheckerboardCells m_checkerboard_cells;     //!< Checkerboard decomposition for concurrent sweeps
+        std::vector<unsigned char> m_checkerboard_moved;    //!< Flags particles moved in the current checkerboard phase
+        bool m_checkerboard_warning_issued;                 //!< True if the unsupported checkerboard warning was issued
+
         Index2D m_overlap_idx;                      //!!< Indexer for interaction matrix
 
         /* Depletants related data members */
@@ -516,6 +706,7 @@ IntegratorHPMCMono<Shape>::IntegratorHPMCMono(std::shared_ptr<SystemDefinition>
               m_image_list_valid(false),
               m_hasOrientation(true),
               m_extra_image_width(0.0),
+              m_checkerboard_warning_issued(false),
               m_quermass(false),
               m_sweep_radius(0.0)
     {
@@ -823,6 +1014,37 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
     // access interaction matrix
     ArrayHandle<unsigned int> h_overlaps(m_overlaps, access_location::host, access_mode::read);
 
+    // depletants and external fields are not supported in checkerboard sweeps
+    bool checkerboard = m_checkerboard && !has_depletants && !m_external;
+    if (m_checkerboard && !checkerboard && !m_checkerboard_warning_issued)
+        {
+        m_exec_conf->msg->warning() << "hpmc: Checkerboard sweeps do not support depletants or external fields, "
+                                    << "sweeping serially." << std::endl;
+        m_checkerboard_warning_issued = true;
+        }
+
+    // particles move at most once per phase of a checkerboard sweep, but the AABB tree is only updated after each
+    // phase: extend the search by the largest move distance
+    Scalar search_margin(0.0);
+    if (checkerboard)
+        {
+        m_checkerboard_cells.setBox(box, m_nominal_width, ndim, m_pdata->getN());
+        m_checkerboard_moved.assign(m_pdata->getN(), 0);
+
+        ArrayHandle<Scalar> h_d(m_d, access_location::host, access_mode::read);
+        for (unsigned int typ = 0; typ < m_pdata->getNTypes(); typ++)
+            search_margin = std::max(search_margin, h_d.data[typ]);
+        }
+
+    // particles in other cells of the color being updated are out of range, and may be moving concurrently
+    unsigned int active_color = 0;
+    const unsigned int N_local = m_pdata->getN();
+    auto is_concurrent = [&](unsigned int j, unsigned int cell)
+        {
+        return checkerboard && j < N_local && m_checkerboard_cells.getParticleCell(j) != cell
+            && m_checkerboard_cells.getColor(m_checkerboard_cells.getParticleCell(j)) == active_color;
+        };
+
     // loop over local particles nselect times
     for (unsigned int i_nselect = 0; i_nselect < m_nselect; i_nselect++)
         {
@@ -836,11 +1058,9 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
         ArrayHandle<Scalar> h_d(m_d, access_location::host, access_mode::read);
         ArrayHandle<Scalar> h_a(m_a, access_location::host, access_mode::read);
 
-        // loop through N particles in a shuffled order
-        for (unsigned int cur_particle = 0; cur_particle < m_pdata->getN(); cur_particle++)
+        // make a trial move for particle i, in checkerboard sweeps cell is the checkerboard cell of i
+        auto trial_move = [&](unsigned int i, hpmc_counters_t& counters, unsigned int cell)
             {
-            unsigned int i = m_update_order[cur_particle];
-
             // read in the current position and orientation
             Scalar4 postype_i = h_postype.data[i];
             Scalar4 orientation_i = h_orientation.data[i];
@@ -851,7 +1071,7 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
                 {
                 // only move particle if active
                 if (!isActive(make_scalar3(postype_i.x, postype_i.y, postype_i.z), box, ghost_fraction))
-                    continue;
+                    return;
                 }
             #endif
 
@@ -872,7 +1092,7 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
                     {
                     if (!shape_i.ignoreStatistics())
                         counters.translate_accept_count++;
-                    continue;
+                    return;
                     }
 
                 move_translate(pos_i, rng_i, h_d.data[typ_i], ndim);
@@ -882,9 +1102,17 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
                     {
                     // check if particle has moved into the ghost layer, and skip if it is
                     if (!isActive(vec_to_scalar3(pos_i), box, ghost_fraction))
-                        continue;
+                        return;
                     }
                 #endif
+
+                // moves out of the checkerboard cell are rejected
+                if (checkerboard && m_checkerboard_cells.getCell(pos_i) != cell)
+                    {
+                    if (!shape_i.ignoreStatistics())
+                        counters.translate_reject_count++;
+                    return;
+                    }
                 }
             else
                 {
@@ -892,7 +1120,7 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
                     {
                     if (!shape_i.ignoreStatistics())
                         counters.rotate_accept_count++;
-                    continue;
+                    return;
                     }
 
                 if (ndim == 2)
@@ -914,6 +1142,7 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
             OverlapReal R_query = std::max(shape_i.getCircumsphereDiameter()/OverlapReal(2.0),
                 r_cut_patch-getMinCoreDiameter()/(OverlapReal)2.0);
             detail::AABB aabb_i_local = detail::AABB(vec3<Scalar>(0,0,0),R_query);
+            detail::AABB aabb_i_search = detail::AABB(vec3<Scalar>(0,0,0),R_query + search_margin);
 
             // patch + field interaction deltaU
             double patch_field_energy_diff = 0;
@@ -924,7 +1153,7 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
             for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
                 {
                 vec3<Scalar> pos_i_image = pos_i + m_image_list[cur_image];
-                detail::AABB aabb = aabb_i_local;
+                detail::AABB aabb = aabb_i_search;
                 aabb.translate(pos_i_image);
 
                 // stackless search
@@ -939,6 +1168,9 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
                                 // read in its position and orientation
                                 unsigned int j = m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
 
+                                if (is_concurrent(j, cell))
+                                    continue;
+
                                 Scalar4 postype_j;
                                 Scalar4 orientation_j;
 
@@ -1018,7 +1250,7 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
                 for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
                     {
                     vec3<Scalar> pos_i_image = pos_old + m_image_list[cur_image];
-                    detail::AABB aabb = aabb_i_local;
+                    detail::AABB aabb = aabb_i_search;
                     aabb.translate(pos_i_image);
 
                     // stackless search
@@ -1033,6 +1265,9 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
                                     // read in its position and orientation
                                     unsigned int j = m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
 
+                                    if (is_concurrent(j, cell))
+                                        continue;
+
                                     Scalar4 postype_j;
                                     Scalar4 orientation_j;
 
@@ -1122,7 +1357,16 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
                 // update the position of the particle in the tree for future updates
                 detail::AABB aabb = aabb_i_local;
                 aabb.translate(pos_i);
-                m_aabb_tree.update(i, aabb);
+                if (checkerboard)
+                    {
+                    // concurrent sweeps update the tree when all cells of the color are done
+                    m_aabbs[i] = aabb;
+                    m_checkerboard_moved[i] = 1;
+                    }
+                else
+                    {
+                    m_aabb_tree.update(i, aabb);
+                    }
 
                 // update position of particle
                 h_postype.data[i] = make_scalar4(pos_i.x,pos_i.y,pos_i.z,postype_i.w);
@@ -1143,7 +1387,66 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
                         counters.rotate_reject_count++;
                     }
                 }
-            } // end loop over all particles
+            };
+
+        if (!checkerboard)
+            {
+            // loop through N particles in a shuffled order
+            for (unsigned int cur_particle = 0; cur_particle < m_pdata->getN(); cur_particle++)
+                trial_move(m_update_order[cur_particle], counters, 0);
+            }
+        else
+            {
+            hoomd::RandomGenerator rng_cells(hoomd::RNGIdentifier::HPMCMonoCheckerboard, m_seed, timestep, m_exec_conf->getRank()*m_nselect + i_nselect);
+            m_checkerboard_cells.shift(rng_cells);
+            m_checkerboard_cells.bin(h_postype.data, m_pdata->getN(), m_update_order);
+            const std::vector<unsigned int>& particles = m_checkerboard_cells.getParticles();
+
+            // sweep over the colors in a random order
+            for (unsigned int phase = 0; phase < detail::CheckerboardCells::n_colors; phase++)
+                {
+                active_color = m_checkerboard_cells.getColorOrder(phase);
+                const std::vector<unsigned int>& cells = m_checkerboard_cells.getColorCells(active_color);
+
+                // the particles in each cell are updated in the shuffled order
+                auto sweep_cells = [&](unsigned int first, unsigned int last, hpmc_counters_t& cell_counters)
+                    {
+                    for (unsigned int k = first; k < last; k++)
+                        {
+                        unsigned int cell = cells[k];
+                        for (unsigned int p = m_checkerboard_cells.getCellStart(cell); p < m_checkerboard_cells.getCellEnd(cell); p++)
+                            trial_move(particles[p], cell_counters, cell);
+                        }
+                    };
+
+                #ifdef ENABLE_TBB
+                tbb::enumerable_thread_specific<hpmc_counters_t> thread_counters;
+                tbb::parallel_for(tbb::blocked_range<unsigned int>(0, (unsigned int)cells.size()),
+                    [&](const tbb::blocked_range<unsigned int>& r)
+                    {
+                    sweep_cells(r.begin(), r.end(), thread_counters.local());
+                    });
+                for (auto c = thread_counters.begin(); c != thread_counters.end(); ++c)
+                    counters = counters + *c;
+                #else
+                sweep_cells(0, (unsigned int)cells.size(), counters);
+                #endif
+
+                // update the AABB tree with the particles moved in this phase
+                for (unsigned int k = 0; k < cells.size(); k++)
+                    {
+                    for (unsigned int p = m_checkerboard_cells.getCellStart(cells[k]); p < m_checkerboard_cells.getCellEnd(cells[k]); p++)
+                        {
+                        unsigned int i = particles[p];
+                        if (m_checkerboard_moved[i])
+                            {
+                            m_aabb_tree.update(i, m_aabbs[i]);
+                            m_checkerboard_moved[i] = 0;
+                            }
+                        }
+                    }
+                }
+            }
         } // end loop over nselect
 
         {
@@ -1875,7 +2178,15 @@ const detail::AABBTree& IntegratorHPMCMono<Shape>::buildAABBTree()
             if (n_aabb > 0)
                 {
                 growAABBList(n_aabb);
+
+                // each particle writes only its own AABB
+                #ifdef ENABLE_TBB
+                tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_aabb),
+                    [&](const tbb::blocked_range<unsigned int>& r) {
+                for (unsigned int cur_particle = r.begin(); cur_particle != r.end(); ++cur_particle)
+                #else
                 for (unsigned int cur_particle = 0; cur_particle < n_aabb; cur_particle++)
+                #endif
                     {
                     unsigned int i = cur_particle;
                     unsigned int typ_i = __scalar_as_int(h_postype.data[i].w);
@@ -1890,6 +2201,11 @@ const detail::AABBTree& IntegratorHPMCMono<Shape>::buildAABBTree()
                         m_aabbs[i] = detail::AABB(vec3<Scalar>(h_postype.data[i]), radius);
                         }
                     }
+                #ifdef ENABLE_TBB
+                    });
+                #endif
+
+                // the Morton code build runs in parallel with TBB
                 m_aabb_tree.buildTree(m_aabbs, n_aabb);
                 }
             }
@@ -0,0 +1,474 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifndef _INTEGRATOR_HPMC_MONO_NEC_H_
+#define _INTEGRATOR_HPMC_MONO_NEC_H_
+
+/*! \file IntegratorHPMCMonoNEC.h
+    \brief Declaration of IntegratorHPMCMonoNEC
+*/
+
+#include "IntegratorHPMCMono.h"
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#include <pybind11/pybind11.h>
+
+namespace hpmc
+{
+
+//! Event chain Monte Carlo of hard shapes
+/*! Instead of local trial displacements, IntegratorHPMCMonoNEC moves particles in straight event chains. A chain
+    starts at a randomly selected particle and moves it along a random direction until it touches another particle.
+    The collision lifts the remaining chain length to that particle, which continues along the same direction. The
+    chain ends when the total displacement reaches the chain length. Chains are never rejected, and they satisfy
+    global balance for hard shapes.
+
+    Collision distances are computed with sweep_distance(). Spheres and convex polygons specialize it with exact
+    expressions, other shapes resolve the contact with their overlap test. Candidate
+    collision partners are found in the AABB tree with the box spanned by the shape over one chain segment. The
+    segment length is limited to the maximum move distance d of the active particle, so that the image list stays
+    valid, and the active particle is wrapped back into the box after each segment.
+
+    Particles with orientational degrees of freedom perform local rotation trial moves with probability
+    1 - translation_move_probability instead of a chain.
+
+    The collisions also sample the pressure: the sum of the projected center to center distances at the collisions
+    divided by the total chain length gives the excess pressure in units of N kT / V.
+
+    Event chains do not support domain decomposition, depletants, patch energies or external fields.
+
+    \ingroup hpmc_integrators
+*/
+template< class Shape >
+class IntegratorHPMCMonoNEC : public IntegratorHPMCMono<Shape>
+    {
+    public:
+        //! Construct the integrator
+        IntegratorHPMCMonoNEC(std::shared_ptr<SystemDefinition> sysdef, unsigned int seed);
+
+        //! Destructor
+        virtual ~IntegratorHPMCMonoNEC()
+            {
+            this->m_exec_conf->msg->notice(5) << "Destroying IntegratorHPMCMonoNEC" << std::endl;
+            }
+
+        //! Take one timestep forward
+        virtual void update(unsigned int timestep);
+
+        //! Reset statistics counters
+        virtual void resetStats()
+            {
+            IntegratorHPMCMono<Shape>::resetStats();
+            m_chain_distance = 0.0;
+            m_chain_lift = 0.0;
+            }
+
+        //! Set the chain length
+        /*! \param chain_length Total displacement of each event chain
+        */
+        void setChainLength(Scalar chain_length)
+            {
+            if (chain_length < Scalar(0.0))
+                {
+                this->m_exec_conf->msg->error() << "integrate.HPMC: chain_length must be non-negative" << std::endl;
+                throw std::runtime_error("Error setting chain length");
+                }
+            m_chain_length = chain_length;
+            }
+
+        //! Get the chain length
+        Scalar getChainLength()
+            {
+            return m_chain_length;
+            }
+
+        //! Get the pressure sampled by the event chains since the start of the run
+        /*! \returns beta P in units of inverse volume, or 0 when no chain has moved yet
+        */
+        Scalar getPressure()
+            {
+            if (m_chain_distance == 0.0)
+                return Scalar(0.0);
+
+            const BoxDim& box = this->m_pdata->getGlobalBox();
+            Scalar V = box.getVolume(this->m_sysdef->getNDimensions() == 2);
+            return Scalar(this->m_pdata->getNGlobal()) / V * Scalar(1.0 + m_chain_lift / m_chain_distance);
+            }
+
+    protected:
+        Scalar m_chain_length;          //!< Total displacement of each event chain
+        double m_chain_distance;        //!< Total chain displacement since the start of the run
+        double m_chain_lift;            //!< Sum of the projected collision distances since the start of the run
+
+        //! Find the first collision of a particle moving along a direction
+        Scalar sweepNeighbors(unsigned int i, const vec3<Scalar>& pos_i, const Shape& shape_i, unsigned int typ_i,
+            const vec3<Scalar>& direction, Scalar max_distance, const Scalar4 *h_postype, const Scalar4 *h_orientation,
+            const unsigned int *h_overlaps, hpmc_counters_t& counters, unsigned int& next, Scalar& lift);
+
+        //! Test whether a particle overlaps with any other particle
+        bool checkOverlaps(unsigned int i, const vec3<Scalar>& pos_i, const Shape& shape_i, unsigned int typ_i,
+            const Scalar4 *h_postype, const Scalar4 *h_orientation, const unsigned int *h_overlaps,
+            hpmc_counters_t& counters);
+    };
+
+/*! \param sysdef System definition
+    \param seed Random number seed
+*/
+template< class Shape >
+IntegratorHPMCMonoNEC<Shape>::IntegratorHPMCMonoNEC(std::shared_ptr<SystemDefinition> sysdef, unsigned int seed)
+    : IntegratorHPMCMono<Shape>(sysdef, seed), m_chain_length(1.0), m_chain_distance(0.0), m_chain_lift(0.0)
+    {
+    this->m_exec_conf->msg->notice(5) << "Constructing IntegratorHPMCMonoNEC" << std::endl;
+    }
+
+/*! \param timestep Current time step
+*/
+template< class Shape >
+void IntegratorHPMCMonoNEC<Shape>::update(unsigned int timestep)
+    {
+    this->m_exec_conf->msg->notice(10) << "HPMCMonoNEC update: " << timestep << std::endl;
+    IntegratorHPMC::update(timestep);
+
+    #ifdef ENABLE_MPI
+    if (this->m_pdata->getDomainDecomposition())
+        {
+        this->m_exec_conf->msg->error() << "Event chain integrators do not support MPI domain decomposition" << std::endl;
+        throw std::runtime_error("Error in IntegratorHPMCMonoNEC");
+        }
+    #endif
+
+    for (unsigned int typ = 0; typ < this->m_pdata->getNTypes(); typ++)
+        {
+        if (this->m_fugacity[typ] != 0.0)
+            {
+            this->m_exec_conf->msg->error() << "Event chain integrators do not support depletants" << std::endl;
+            throw std::runtime_error("Error in IntegratorHPMCMonoNEC");
+            }
+        }
+
+    if (this->m_patch || this->m_external)
+        {
+        this->m_exec_conf->msg->error() << "Event chain integrators do not support patch energies or external fields"
+                                        << std::endl;
+        throw std::runtime_error("Error in IntegratorHPMCMonoNEC");
+        }
+
+    // get needed vars
+    ArrayHandle<hpmc_counters_t> h_counters(this->m_count_total, access_location::host, access_mode::readwrite);
+    hpmc_counters_t& counters = h_counters.data[0];
+
+    const BoxDim& box = this->m_pdata->getBox();
+    unsigned int ndim = this->m_sysdef->getNDimensions();
+
+    // Shuffle the order of particles for this step
+    this->m_update_order.resize(this->m_pdata->getN());
+    this->m_update_order.shuffle(timestep);
+
+    // update the AABB Tree
+    this->buildAABBTree();
+    // limit m_d entries so that particles cannot possibly wander more than one box image in one segment
+    this->limitMoveDistances();
+    // update the image list
+    this->updateImageList();
+
+    if (this->m_prof) this->m_prof->push(this->m_exec_conf, "HPMC NEC update");
+
+        {
+        ArrayHandle<Scalar4> h_postype(this->m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar4> h_orientation(this->m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
+        ArrayHandle<int3> h_image(this->m_pdata->getImages(), access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar> h_d(this->m_d, access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_a(this->m_a, access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_overlaps(this->m_overlaps, access_location::host, access_mode::read);
+
+        for (unsigned int i_nselect = 0; i_nselect < this->m_nselect; i_nselect++)
+            {
+            // loop through N particles in a shuffled order
+            for (unsigned int cur_particle = 0; cur_particle < this->m_pdata->getN(); cur_particle++)
+                {
+                unsigned int i = this->m_update_order[cur_particle];
+
+                hoomd::RandomGenerator rng_i(hoomd::RNGIdentifier::HPMCMonoNEC, this->m_seed, i, i_nselect, timestep);
+                Scalar4 postype_i = h_postype.data[i];
+                unsigned int typ_i = __scalar_as_int(postype_i.w);
+                Shape shape_i(quat<Scalar>(h_orientation.data[i]), this->m_params[typ_i]);
+                unsigned int move_type_select = hoomd::UniformIntDistribution(0xffff)(rng_i);
+                bool move_type_translate = !shape_i.hasOrientation()
+                    || (move_type_select < this->m_translation_move_probability);
+
+                if (move_type_translate)
+                    {
+                    // draw the chain direction
+                    vec3<Scalar> direction;
+                    if (ndim == 2)
+                        {
+                        Scalar theta = hoomd::UniformDistribution<Scalar>(Scalar(0.0), Scalar(2.0*M_PI))(rng_i);
+                        direction = vec3<Scalar>(slow::cos(theta), slow::sin(theta), Scalar(0.0));
+                        }
+                    else
+                        {
+                        hoomd::SpherePointGenerator<Scalar>()(rng_i, direction);
+                        }
+
+                    // move the active particle until the chain length is used up
+                    unsigned int k = i;
+                    Scalar remaining = m_chain_length;
+                    while (remaining > Scalar(0.0))
+                        {
+                        Scalar4 postype_k = h_postype.data[k];
+                        unsigned int typ_k = __scalar_as_int(postype_k.w);
+                        Shape shape_k(quat<Scalar>(h_orientation.data[k]), this->m_params[typ_k]);
+                        vec3<Scalar> pos_k(postype_k);
+
+                        Scalar segment = std::min(remaining, h_d.data[typ_k]);
+                        if (segment <= Scalar(0.0))
+                            break;
+
+                        unsigned int next = k;
+                        Scalar lift(0.0);
+                        Scalar s = sweepNeighbors(k, pos_k, shape_k, typ_k, direction, segment, h_postype.data,
+                            h_orientation.data, h_overlaps.data, counters, next, lift);
+
+                        pos_k += s*direction;
+                        h_postype.data[k] = vec_to_scalar4(pos_k, postype_k.w);
+                        box.wrap(h_postype.data[k], h_image.data[k]);
+
+                        // update the position of the particle in the tree for future updates
+                        this->m_aabb_tree.update(k, shape_k.getAABB(vec3<Scalar>(h_postype.data[k])));
+
+                        if (!shape_k.ignoreStatistics())
+                            counters.translate_accept_count++;
+
+                        remaining -= s;
+                        m_chain_distance += s;
+
+                        // lift the chain to the particle that was hit
+                        if (next != k)
+                            {
+                            m_chain_lift += lift;
+                            k = next;
+                            }
+                        }
+                    }
+                else
+                    {
+                    if (h_a.data[typ_i] == 0.0)
+                        {
+                        if (!shape_i.ignoreStatistics())
+                            counters.rotate_accept_count++;
+                        continue;
+                        }
+
+                    if (ndim == 2)
+                        move_rotate<2>(shape_i.orientation, rng_i, h_a.data[typ_i]);
+                    else
+                        move_rotate<3>(shape_i.orientation, rng_i, h_a.data[typ_i]);
+
+                    vec3<Scalar> pos_i(postype_i);
+                    if (!checkOverlaps(i, pos_i, shape_i, typ_i, h_postype.data, h_orientation.data, h_overlaps.data,
+                        counters))
+                        {
+                        if (!shape_i.ignoreStatistics())
+                            counters.rotate_accept_count++;
+
+                        h_orientation.data[i] = quat_to_scalar4(shape_i.orientation);
+                        this->m_aabb_tree.update(i, shape_i.getAABB(pos_i));
+                        }
+                    else if (!shape_i.ignoreStatistics())
+                        {
+                        counters.rotate_reject_count++;
+                        }
+                    }
+                } // end loop over all particles
+            } // end loop over nselect
+        }
+
+    if (this->m_prof) this->m_prof->pop(this->m_exec_conf);
+
+    // migrate and exchange particles
+    this->communicate(true);
+
+    // all particle have been moved, the aabb tree is now invalid
+    this->m_aabb_tree_invalid = true;
+
+    // set current MPS value
+    hpmc_counters_t run_counters = this->getCounters(1);
+    double cur_time = double(this->m_clock.getTime()) / Scalar(1e9);
+    this->m_mps = double(run_counters.getNMoves()) / cur_time;
+    }
+
+/*! \param i Index of the moving particle
+    \param pos_i Position of the moving particle
+    \param shape_i Shape of the moving particle
+    \param typ_i Type of the moving particle
+    \param direction Unit vector along which the particle moves
+    \param max_distance Length of the segment to search
+    \param h_postype Particle positions and types
+    \param h_orientation Particle orientations
+    \param h_overlaps Interaction matrix
+    \param counters Counters to increment
+    \param next Set to the index of the particle hit first, left unchanged if no particle is hit
+    \param lift Set to the center to center distance to the hit particle projected onto the direction, after the move
+    \returns The distance particle i moves before it hits another particle, or max_distance
+*/
+template< class Shape >
+Scalar IntegratorHPMCMonoNEC<Shape>::sweepNeighbors(unsigned int i, const vec3<Scalar>& pos_i, const Shape& shape_i,
+    unsigned int typ_i, const vec3<Scalar>& direction, Scalar max_distance, const Scalar4 *h_postype,
+    const Scalar4 *h_orientation, const unsigned int *h_overlaps, hpmc_counters_t& counters, unsigned int& next,
+    Scalar& lift)
+    {
+    OverlapReal s_min = OverlapReal(max_distance);
+    unsigned int err_count = 0;
+
+    // the search volume covers the shape over the whole segment
+    detail::AABB aabb_i_local = detail::merge(shape_i.getAABB(vec3<Scalar>(0,0,0)),
+                                              shape_i.getAABB(max_distance*direction));
+
+    const unsigned int n_images = this->m_image_list.size();
+    for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
+        {
+        vec3<Scalar> pos_i_image = pos_i + this->m_image_list[cur_image];
+        detail::AABB aabb = aabb_i_local;
+        aabb.translate(pos_i_image);
+
+        // stackless search
+        for (unsigned int cur_node_idx = 0; cur_node_idx < this->m_aabb_tree.getNumNodes(); cur_node_idx++)
+            {
+            if (detail::overlap(this->m_aabb_tree.getNodeAABB(cur_node_idx), aabb))
+                {
+                if (this->m_aabb_tree.isNodeLeaf(cur_node_idx))
+                    {
+                    for (unsigned int cur_p = 0; cur_p < this->m_aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
+                        {
+                        unsigned int j = this->m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+
+                        // skip i==j in the 0 image
+                        if (cur_image == 0 && i == j)
+                            continue;
+
+                        Scalar4 postype_j = h_postype[j];
+                        unsigned int typ_j = __scalar_as_int(postype_j.w);
+                        if (!h_overlaps[this->m_overlap_idx(typ_i,typ_j)])
+                            continue;
+
+                        Shape shape_j(quat<Scalar>(h_orientation[j]), this->m_params[typ_j]);
+                        vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
+
+                        counters.overlap_checks++;
+                        OverlapReal s = sweep_distance(r_ij, direction, shape_i, shape_j, s_min, err_count);
+                        if (s < s_min)
+                            {
+                            s_min = s;
+                            next = j;
+                            lift = dot(r_ij, direction) - Scalar(s);
+                            }
+                        }
+                    }
+                }
+            else
+                {
+                // skip ahead
+                cur_node_idx += this->m_aabb_tree.getNodeSkip(cur_node_idx);
+                }
+            } // end loop over AABB nodes
+        } // end loop over images
+
+    if (err_count > 0)
+        counters.overlap_err_count += err_count;
+
+    return Scalar(s_min);
+    }
+
+/*! \param i Index of the particle
+    \param pos_i Position of the particle
+    \param shape_i Shape of the particle
+    \param typ_i Type of the particle
+    \param h_postype Particle positions and types
+    \param h_orientation Particle orientations
+    \param h_overlaps Interaction matrix
+    \param counters Counters to increment
+    \returns True if particle i overlaps with any other particle
+*/
+template< class Shape >
+bool IntegratorHPMCMonoNEC<Shape>::checkOverlaps(unsigned int i, const vec3<Scalar>& pos_i, const Shape& shape_i,
+    unsigned int typ_i, const Scalar4 *h_postype, const Scalar4 *h_orientation, const unsigned int *h_overlaps,
+    hpmc_counters_t& counters)
+    {
+    unsigned int err_count = 0;
+    bool overlap = false;
+
+    detail::AABB aabb_i_local = shape_i.getAABB(vec3<Scalar>(0,0,0));
+
+    const unsigned int n_images = this->m_image_list.size();
+    for (unsigned int cur_image = 0; cur_image < n_images && !overlap; cur_image++)
+        {
+        vec3<Scalar> pos_i_image = pos_i + this->m_image_list[cur_image];
+        detail::AABB aabb = aabb_i_local;
+        aabb.translate(pos_i_image);
+
+        // stackless search
+        for (unsigned int cur_node_idx = 0; cur_node_idx < this->m_aabb_tree.getNumNodes() && !overlap; cur_node_idx++)
+            {
+            if (detail::overlap(this->m_aabb_tree.getNodeAABB(cur_node_idx), aabb))
+                {
+                if (this->m_aabb_tree.isNodeLeaf(cur_node_idx))
+                    {
+                    for (unsigned int cur_p = 0; cur_p < this->m_aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
+                        {
+                        unsigned int j = this->m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+
+                        // skip i==j in the 0 image
+                        if (cur_image == 0 && i == j)
+                            continue;
+
+                        Scalar4 postype_j = h_postype[j];
+                        unsigned int typ_j = __scalar_as_int(postype_j.w);
+                        Shape shape_j(quat<Scalar>(h_orientation[j]), this->m_params[typ_j]);
+                        vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
+
+                        counters.overlap_checks++;
+                        if (h_overlaps[this->m_overlap_idx(typ_i,typ_j)]
+                            && check_circumsphere_overlap(r_ij, shape_i, shape_j)
+                            && test_overlap(r_ij, shape_i, shape_j, err_count))
+                            {
+                            overlap = true;
+                            break;
+                            }
+                        }
+                    }
+                }
+            else
+                {
+                // skip ahead
+                cur_node_idx += this->m_aabb_tree.getNodeSkip(cur_node_idx);
+                }
+            } // end loop over AABB nodes
+        } // end loop over images
+
+    if (err_count > 0)
+        counters.overlap_err_count += err_count;
+
+    return overlap;
+    }
+
+//! Export the IntegratorHPMCMonoNEC class to python
+/*! \param name Name of the class in the exported python module
+    \tparam Shape An instantiation of IntegratorHPMCMonoNEC<Shape> will be exported
+*/
+template < class Shape > void export_IntegratorHPMCMonoNEC(pybind11::module& m, const std::string& name)
+    {
+    pybind11::class_< IntegratorHPMCMonoNEC<Shape>, IntegratorHPMCMono<Shape>,
+        std::shared_ptr< IntegratorHPMCMonoNEC<Shape> > >(m, name.c_str())
+        .def(pybind11::init< std::shared_ptr<SystemDefinition>, unsigned int >())
+        .def_property("chain_length", &IntegratorHPMCMonoNEC<Shape>::getChainLength,
+            &IntegratorHPMCMonoNEC<Shape>::setChainLength)
+        .def("getPressure", &IntegratorHPMCMonoNEC<Shape>::getPressure)
+        ;
+    }
+
+} // end namespace hpmc
+
+#endif // _INTEGRATOR_HPMC_MONO_NEC_H_
@@ -559,6 +559,57 @@ DEVICE inline bool test_overlap_separating_planes(const PolygonVertices& a,
     return true;
     }
 
+/** Distance that the vertices of one polygon can move along a direction before they hit the edges of another
+
+    @param a Polygon whose vertices move
+    @param qa Orientation of the first polygon
+    @param b Polygon whose edges are tested
+    @param qb Orientation of the second polygon
+    @param ab_t Vector pointing from *a*'s center to *b*'s center, in the space frame
+    @param d Unit vector along which *a* moves, in the space frame
+    @param max_distance Largest distance of interest
+    @returns the smallest distance at which a vertex of *a* enters *b*, or *max_distance*
+
+    @pre Polygon vertices are in **counter-clockwise** order
+*/
+DEVICE inline OverlapReal sweep_vertices_to_edges(const PolygonVertices& a,
+                                                  const quat<OverlapReal>& qa,
+                                                  const PolygonVertices& b,
+                                                  const quat<OverlapReal>& qb,
+                                                  const vec2<OverlapReal>& ab_t,
+                                                  const vec2<OverlapReal>& d,
+                                                  OverlapReal max_distance)
+    {
+    vec2<OverlapReal> pa[MAX_POLY2D_VERTS];
+    for (unsigned int i = 0; i < a.N; i++)
+        pa[i] = rotate(qa, vec2<OverlapReal>(a.x[i], a.y[i]));
+
+    OverlapReal s = max_distance;
+    vec2<OverlapReal> q0 = rotate(qb, vec2<OverlapReal>(b.x[b.N-1], b.y[b.N-1])) + ab_t;
+    for (unsigned int j = 0; j < b.N; j++)
+        {
+        vec2<OverlapReal> q1 = rotate(qb, vec2<OverlapReal>(b.x[j], b.y[j])) + ab_t;
+        vec2<OverlapReal> e = q1 - q0;
+
+        // vertices moving along d can only enter through edges with an outward normal against d
+        OverlapReal denom = perpdot(d, e);
+        if (denom < OverlapReal(0.0))
+            {
+            for (unsigned int i = 0; i < a.N; i++)
+                {
+                // solve pa[i] + t d = q0 + u e
+                vec2<OverlapReal> w = q0 - pa[i];
+                OverlapReal t = perpdot(w, e) / denom;
+                OverlapReal u = perpdot(w, d) / denom;
+                if (u >= OverlapReal(0.0) && u <= OverlapReal(1.0) && t > -OverlapReal(SMALL) && t < s)
+                    s = detail::max(t, OverlapReal(0.0));
+                }
+            }
+        q0 = q1;
+        }
+
+    return s;
+    }
 }; // end namespace detail
 
 /** Convex polygon overlap test
@@ -595,6 +646,47 @@ DEVICE inline bool test_overlap<ShapeConvexPolygon,ShapeConvexPolygon>(const vec
     #endif
     }
 
+/** Convex polygon sweep distance
+
+    @param r_ab Vector defining the position of shape b relative to shape a (r_b - r_a)
+    @param direction Unit vector along which shape a moves
+    @param a first shape
+    @param b second shape
+    @param max_distance Largest distance of interest
+    @param err in/out variable incremented when error conditions occur in the overlap test
+    @returns the distance a moves before it touches b, or *max_distance* when they do not touch within it
+
+    The polygons first touch when a vertex of *a* hits an edge of *b*, or a vertex of *b* hits an edge of *a* moving
+    in the opposite direction.
+*/
+template <>
+DEVICE inline OverlapReal sweep_distance<ShapeConvexPolygon,ShapeConvexPolygon>(const vec3<Scalar>& r_ab,
+                                                                                const vec3<Scalar>& direction,
+                                                                                const ShapeConvexPolygon& a,
+                                                                                const ShapeConvexPolygon& b,
+                                                                                OverlapReal max_distance,
+                                                                                unsigned int& err)
+    {
+    vec2<OverlapReal> dr(r_ab.x, r_ab.y);
+    vec2<OverlapReal> d(direction.x, direction.y);
+
+    // skip pairs whose circumspheres do not meet along the way, the circumspheres intersect for displacements in
+    // [proj - sqrt(disc), proj + sqrt(disc)]. b may be in the path of a even when its center is behind a's center.
+    OverlapReal R = OverlapReal(0.5)*(a.verts.diameter + b.verts.diameter);
+    OverlapReal proj = dot(dr,d);
+    OverlapReal disc = proj*proj - dot(dr,dr) + R*R;
+    if (disc < OverlapReal(0.0))
+        return max_distance;
+    OverlapReal sqrt_disc = fast::sqrt(disc);
+    if (proj + sqrt_disc < OverlapReal(0.0) || proj - sqrt_disc >= max_distance)
+        return max_distance;
+
+    quat<OverlapReal> qa(a.orientation);
+    quat<OverlapReal> qb(b.orientation);
+    OverlapReal s = detail::sweep_vertices_to_edges(a.verts, qa, b.verts, qb, dr, d, max_distance);
+    return detail::sweep_vertices_to_edges(b.verts, qb, a.verts, qa, -dr, -d, s);
+    }
+
 #ifndef __HIPCC__
 template<>
 inline std::string getShapeSpec(const ShapeConvexPolygon& poly)
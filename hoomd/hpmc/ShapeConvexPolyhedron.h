@@ -13,6 +13,7 @@
 #include "hoomd/hpmc/OBB.h"
 
 #include <cfloat>
+#include <climits>
 
 #ifdef __HIPCC__
 #define DEVICE __device__
@@ -20,7 +21,9 @@
 #else
 #define DEVICE
 #define HOSTDEVICE
+#include <algorithm>
 #include <iostream>
+#include <vector>
 #if defined (__SSE__)
 #include <immintrin.h>
 #endif
@@ -32,6 +35,17 @@ namespace hpmc
 namespace detail
 {
 
+/** Minimum number of vertices for which the support function hill-climbs on the vertex adjacency graph
+
+    The vectorized scan of all vertices in single precision is faster for medium sized polyhedra (see
+    benchmark_convex_polyhedron).
+*/
+#if !defined(__HIPCC__) && defined(__SSE__) && (defined(SINGLE_PRECISION) || defined(ENABLE_HPMC_MIXED_PRECISION))
+const unsigned int SUPPORT_HILL_CLIMB_MIN_VERTS = 128;
+#else
+const unsigned int SUPPORT_HILL_CLIMB_MIN_VERTS = 32;
+#endif
+
 /** Convex polyhedron vertices
 
     Define the parameters of a convex polyhedron for HPMC shape overlap checks. Convex polyhedra are
@@ -40,6 +54,9 @@ namespace detail
     makes them rounded convex polyhedra. Coordinates are stored with x, y, and z in separate arrays
     to support vector intrinsics on the CPU. These arrays are stored in ManagedArray to support
     arbitrary numbers of verticles.
+
+    Polyhedra with at least SUPPORT_HILL_CLIMB_MIN_VERTS vertices also store the adjacency graph of
+    the vertices along the edges of the convex hull, which the support function climbs on the CPU.
 */
 struct PolyhedronVertices : ShapeParams
     {
@@ -145,6 +162,13 @@ struct PolyhedronVertices : ShapeParams
                  hull_verts[i] = indexBuffer[i];
             }
 
+        adj_start = ManagedArray<unsigned int>();
+        adj = ManagedArray<unsigned int>();
+        if (N >= SUPPORT_HILL_CLIMB_MIN_VERTS && n_hull_verts > 0)
+            {
+            buildAdjacency(managed);
+            }
+
         if (N >= 1)
             {
             std::vector<OverlapReal> vertex_radii(N, sweep_radius);
@@ -156,6 +180,43 @@ struct PolyhedronVertices : ShapeParams
             }
         }
 
+    /** Build the vertex adjacency graph from the edges of the convex hull
+
+        The neighbors of vertex i are adj[adj_start[i]] to adj[adj_start[i+1]-1]. Vertices that
+        are not on the hull have no neighbors.
+
+        @param managed Set to true to store the graph in managed memory
+    */
+    void buildAdjacency(bool managed)
+        {
+        std::vector< std::vector<unsigned int> > neighbors(N);
+        for (unsigned int i = 0; i < n_hull_verts; i += 3)
+            {
+            for (unsigned int k = 0; k < 3; k++)
+                {
+                unsigned int a = hull_verts[i+k];
+                unsigned int b = hull_verts[i+(k+1)%3];
+                neighbors[a].push_back(b);
+                neighbors[b].push_back(a);
+                }
+            }
+
+        adj_start = ManagedArray<unsigned int>(N+1, managed);
+        unsigned int n_adj = 0;
+        for (unsigned int i = 0; i < N; i++)
+            {
+            std::sort(neighbors[i].begin(), neighbors[i].end());
+            neighbors[i].erase(std::unique(neighbors[i].begin(), neighbors[i].end()), neighbors[i].end());
+            adj_start[i] = n_adj;
+            n_adj += neighbors[i].size();
+            }
+        adj_start[N] = n_adj;
+
+        adj = ManagedArray<unsigned int>(n_adj, managed);
+        for (unsigned int i = 0; i < N; i++)
+            std::copy(neighbors[i].begin(), neighbors[i].end(), adj.get() + adj_start[i]);
+        }
+
     /// Construct from a Python dictionary
     PolyhedronVertices(pybind11::dict v, bool managed=false)
         : PolyhedronVertices((unsigned int)pybind11::len(v["vertices"]), managed)
@@ -249,6 +310,12 @@ struct PolyhedronVertices : ShapeParams
     /// Number of vertices in the convex hull
     unsigned int n_hull_verts;
 
+    /// Offsets of the neighbors of each vertex in adj (empty when the graph is not built)
+    ManagedArray<unsigned int> adj_start;
+
+    /// Neighbors of the vertices along the edges of the convex hull
+    ManagedArray<unsigned int> adj;
+
     /// Number of vertices
     unsigned int N;
 
@@ -265,10 +332,40 @@ struct PolyhedronVertices : ShapeParams
     detail::OBB obb;
     }__attribute__((aligned(32)));
 
+/** Support vertices found in earlier calls of the support function
+
+    Stores the last support vertex found for a direction in each of the eight octants. Directions
+    in the same octant tend to have nearby support vertices, so these are good starting points for
+    the hill climb in SupportFuncConvexPolyhedron.
+*/
+struct SupportVertexCache
+    {
+    /// Default constructor marks all octants as empty
+    DEVICE SupportVertexCache()
+        {
+        for (unsigned int i = 0; i < 8; i++)
+            vertex[i] = UINT_MAX;
+        }
+
+    /// Octant of a direction
+    DEVICE static unsigned int octant(const vec3<OverlapReal>& n)
+        {
+        return (n.x < OverlapReal(0.0)) | ((n.y < OverlapReal(0.0)) << 1) | ((n.z < OverlapReal(0.0)) << 2);
+        }
+
+    /// Last support vertex in each octant (UINT_MAX if none)
+    unsigned int vertex[8];
+    };
+
 /** Support function for ShapePolyhedron
 
     SupportFuncPolyhedron is a functor that computes the support function for ShapePolyhedron. For a
     given input vector in local coordinates, it finds the vertex most in that direction.
+
+    When the vertices have an adjacency graph, the CPU code climbs the graph from the last support
+    vertex found in the same octant of directions: it moves to the neighbor most in the direction
+    of n until no neighbor improves on the current vertex. Because the graph follows the edges of
+    the convex hull, this local maximum is the global maximum. Otherwise, all vertices are scanned.
 */
 class SupportFuncConvexPolyhedron
     {
@@ -276,14 +373,21 @@ class SupportFuncConvexPolyhedron
         /** Construct a support function for a convex polyhedron
 
             @param _verts Polyhedron vertices
+            @param extra_sweep_radius Radius of a sphere to sweep the polyhedron by
+            @param _cache Support vertices from earlier calls, shared with other support functions
+                   of the same shape (a private cache is used when NULL)
 
             Note that for performance it is assumed that unused vertices (beyond N) have already
             been set to zero.
         */
         DEVICE SupportFuncConvexPolyhedron(const PolyhedronVertices& _verts,
-            OverlapReal extra_sweep_radius=OverlapReal(0.0))
+            OverlapReal extra_sweep_radius=OverlapReal(0.0),
+            SupportVertexCache *_cache=NULL)
             : verts(_verts), sweep_radius(extra_sweep_radius)
             {
+            #if !defined(__HIPCC__)
+            cache = _cache;
+            #endif
             }
 
         /** Compute the support function
@@ -298,181 +402,257 @@ class SupportFuncConvexPolyhedron
 
             if (verts.N > 0)
                 {
-                #if !defined(__HIPCC__) && defined(__AVX__) && (defined(SINGLE_PRECISION) || defined(ENABLE_HPMC_MIXED_PRECISION))
-                // process dot products with AVX 8 at a time on the CPU when working with more than
-                // 4 verts
-                __m256 nx_v = _mm256_broadcast_ss(&n.x);
-                __m256 ny_v = _mm256_broadcast_ss(&n.y);
-                __m256 nz_v = _mm256_broadcast_ss(&n.z);
-                __m256 max_dot_v = _mm256_broadcast_ss(&max_dot);
-                float d_s[verts.x.size()] __attribute__((aligned(32)));
-
-                for (unsigned int i = 0; i < verts.N; i+=8)
+                #if !defined(__HIPCC__)
+                if (verts.adj_start.size() > 0)
                     {
-                    __m256 x_v = _mm256_load_ps(verts.x.get() + i);
-                    __m256 y_v = _mm256_load_ps(verts.y.get() + i);
-                    __m256 z_v = _mm256_load_ps(verts.z.get() + i);
-
-                    __m256 d_v = _mm256_add_ps(_mm256_mul_ps(nx_v, x_v), _mm256_add_ps(_mm256_mul_ps(ny_v, y_v), _mm256_mul_ps(nz_v, z_v)));
-
-                    // determine a maximum in each of the 8 channels as we go
-                    max_dot_v = _mm256_max_ps(max_dot_v, d_v);
-
-                    _mm256_store_ps(d_s + i, d_v);
+                    max_idx = climb(n);
                     }
-
-                // find the maximum of the 8 channels
-                // http://stackoverflow.com/questions/17638487/minimum-of-4-sp-values-in-m128
-                max_dot_v = _mm256_max_ps(max_dot_v, _mm256_shuffle_ps(max_dot_v, max_dot_v, _MM_SHUFFLE(2, 1, 0, 3)));
-                max_dot_v = _mm256_max_ps(max_dot_v, _mm256_shuffle_ps(max_dot_v, max_dot_v, _MM_SHUFFLE(1, 0, 3, 2)));
-                // shuffles work only within the two 128b segments, so right now we have two separate max values
-                // swap the left and right hand sides and max again to get the final max
-                max_dot_v = _mm256_max_ps(max_dot_v, _mm256_permute2f128_ps(max_dot_v, max_dot_v, 1));
-
-                // loop again and find the max. The reason this is in a 2nd loop is because branch mis-predictions
-                // and the extra max calls kill performance if this is in the first loop
-                // Use BSF to find the first index of the max element
-                // https://software.intel.com/en-us/forums/topic/285956
-                for (unsigned int i = 0; i < verts.N; i+=8)
+                else
+                #endif
                     {
-                    __m256 d_v = _mm256_load_ps(d_s + i);
+                    max_idx = scan(n, max_dot);
+                    }
+
+                vec3<OverlapReal> v(verts.x[max_idx], verts.y[max_idx], verts.z[max_idx]);
+                if (sweep_radius != OverlapReal(0.0))
+                    return v + (sweep_radius * fast::rsqrt(dot(n,n))) * n;
+                else
+                    return v;
+                } // end if(verts.N > 0)
+            else
+                {
+                if (sweep_radius != OverlapReal(0.0))
+                    return (sweep_radius * fast::rsqrt(dot(n,n))) * n;
+                else
+                    return vec3<OverlapReal>(0.0, 0.0, 0.0); // No verts!
+                }
+            }
 
-                    int id = __builtin_ffs(_mm256_movemask_ps(_mm256_cmp_ps(max_dot_v, d_v, 0)));
+        #if !defined(__HIPCC__)
+        /** Find the support vertex by hill climbing on the vertex adjacency graph
 
-                    if (id)
+            @param n Normal vector input (in the local frame)
+            @returns Index of the vertex furthest in the direction of n
+        */
+        unsigned int climb(const vec3<OverlapReal>& n) const
+            {
+            SupportVertexCache& octant_cache = cache ? *cache : local_cache;
+            const unsigned int octant = SupportVertexCache::octant(n);
+
+            // start from the last support vertex in this octant, or any vertex on the hull
+            unsigned int cur = octant_cache.vertex[octant];
+            if (cur >= verts.N)
+                cur = verts.hull_verts[0];
+
+            const OverlapReal *x = verts.x.get();
+            const OverlapReal *y = verts.y.get();
+            const OverlapReal *z = verts.z.get();
+            const unsigned int *adj_start = verts.adj_start.get();
+            const unsigned int *adj = verts.adj.get();
+
+            OverlapReal cur_dot = n.x*x[cur] + n.y*y[cur] + n.z*z[cur];
+            while (true)
+                {
+                // move to the neighbor furthest in the direction of n
+                unsigned int next = cur;
+                for (unsigned int k = adj_start[cur]; k < adj_start[cur+1]; k++)
+                    {
+                    const unsigned int j = adj[k];
+                    const OverlapReal d = n.x*x[j] + n.y*y[j] + n.z*z[j];
+                    if (d > cur_dot)
                         {
-                        max_idx = i + id - 1;
-                        break;
+                        cur_dot = d;
+                        next = j;
                         }
                     }
-                #elif !defined(__HIPCC__) && defined(__SSE__) && (defined(SINGLE_PRECISION) || defined(ENABLE_HPMC_MIXED_PRECISION))
-                // process dot products with SSE 4 at a time on the CPU
-                __m128 nx_v = _mm_load_ps1(&n.x);
-                __m128 ny_v = _mm_load_ps1(&n.y);
-                __m128 nz_v = _mm_load_ps1(&n.z);
-                __m128 max_dot_v = _mm_load_ps1(&max_dot);
-                float d_s[verts.x.size()] __attribute__((aligned(16)));
-
-                for (unsigned int i = 0; i < verts.N; i+=4)
-                    {
-                    __m128 x_v = _mm_load_ps(verts.x.get() + i);
-                    __m128 y_v = _mm_load_ps(verts.y.get() + i);
-                    __m128 z_v = _mm_load_ps(verts.z.get() + i);
 
-                    __m128 d_v = _mm_add_ps(_mm_mul_ps(nx_v, x_v), _mm_add_ps(_mm_mul_ps(ny_v, y_v), _mm_mul_ps(nz_v, z_v)));
+                if (next == cur)
+                    break;
+                cur = next;
+                }
 
-                    // determine a maximum in each of the 4 channels as we go
-                    max_dot_v = _mm_max_ps(max_dot_v, d_v);
+            octant_cache.vertex[octant] = cur;
+            return cur;
+            }
+        #endif
 
-                    _mm_store_ps(d_s + i, d_v);
-                    }
+        /** Find the support vertex by scanning all vertices
+
+            @param n Normal vector input (in the local frame)
+            @param max_dot Lower bound of the dot product
+            @returns Index of the vertex furthest in the direction of n
+        */
+        DEVICE unsigned int scan(const vec3<OverlapReal>& n, OverlapReal max_dot) const
+            {
+            unsigned int max_idx = 0;
 
-                // find the maximum of the 4 channels
-                // http://stackoverflow.com/questions/17638487/minimum-of-4-sp-values-in-m128
-                max_dot_v = _mm_max_ps(max_dot_v, _mm_shuffle_ps(max_dot_v, max_dot_v, _MM_SHUFFLE(2, 1, 0, 3)));
-                max_dot_v = _mm_max_ps(max_dot_v, _mm_shuffle_ps(max_dot_v, max_dot_v, _MM_SHUFFLE(1, 0, 3, 2)));
+            #if !defined(__HIPCC__) && defined(__AVX__) && (defined(SINGLE_PRECISION) || defined(ENABLE_HPMC_MIXED_PRECISION))
+            // process dot products with AVX 8 at a time on the CPU when working with more than
+            // 4 verts
+            __m256 nx_v = _mm256_broadcast_ss(&n.x);
+            __m256 ny_v = _mm256_broadcast_ss(&n.y);
+            __m256 nz_v = _mm256_broadcast_ss(&n.z);
+            __m256 max_dot_v = _mm256_broadcast_ss(&max_dot);
+            float d_s[verts.x.size()] __attribute__((aligned(32)));
 
-                // loop again and find the max. The reason this is in a 2nd loop is because branch mis-predictions
-                // and the extra max calls kill performance if this is in the first loop
-                // Use BSF to find the first index of the max element
-                // https://software.intel.com/en-us/forums/topic/285956
-                for (unsigned int i = 0; i < verts.N; i+=4)
-                    {
-                    __m128 d_v = _mm_load_ps(d_s + i);
+            for (unsigned int i = 0; i < verts.N; i+=8)
+                {
+                __m256 x_v = _mm256_load_ps(verts.x.get() + i);
+                __m256 y_v = _mm256_load_ps(verts.y.get() + i);
+                __m256 z_v = _mm256_load_ps(verts.z.get() + i);
 
-                    int id = __builtin_ffs(_mm_movemask_ps(_mm_cmpeq_ps(max_dot_v, d_v)));
+                __m256 d_v = _mm256_add_ps(_mm256_mul_ps(nx_v, x_v), _mm256_add_ps(_mm256_mul_ps(ny_v, y_v), _mm256_mul_ps(nz_v, z_v)));
 
-                    if (id)
-                        {
-                        max_idx = i + id - 1;
-                        break;
-                        }
+                // determine a maximum in each of the 8 channels as we go
+                max_dot_v = _mm256_max_ps(max_dot_v, d_v);
+
+                _mm256_store_ps(d_s + i, d_v);
+                }
+
+            // find the maximum of the 8 channels
+            // http://stackoverflow.com/questions/17638487/minimum-of-4-sp-values-in-m128
+            max_dot_v = _mm256_max_ps(max_dot_v, _mm256_shuffle_ps(max_dot_v, max_dot_v, _MM_SHUFFLE(2, 1, 0, 3)));
+            max_dot_v = _mm256_max_ps(max_dot_v, _mm256_shuffle_ps(max_dot_v, max_dot_v, _MM_SHUFFLE(1, 0, 3, 2)));
+            // shuffles work only within the two 128b segments, so right now we have two separate max values
+            // swap the left and right hand sides and max again to get the final max
+            max_dot_v = _mm256_max_ps(max_dot_v, _mm256_permute2f128_ps(max_dot_v, max_dot_v, 1));
+
+            // loop again and find the max. The reason this is in a 2nd loop is because branch mis-predictions
+            // and the extra max calls kill performance if this is in the first loop
+            // Use BSF to find the first index of the max element
+            // https://software.intel.com/en-us/forums/topic/285956
+            for (unsigned int i = 0; i < verts.N; i+=8)
+                {
+                __m256 d_v = _mm256_load_ps(d_s + i);
+
+                int id = __builtin_ffs(_mm256_movemask_ps(_mm256_cmp_ps(max_dot_v, d_v, 0)));
+
+                if (id)
+                    {
+                    max_idx = i + id - 1;
+                    break;
                     }
-                #else
+                }
+            #elif !defined(__HIPCC__) && defined(__SSE__) && (defined(SINGLE_PRECISION) || defined(ENABLE_HPMC_MIXED_PRECISION))
+            // process dot products with SSE 4 at a time on the CPU
+            __m128 nx_v = _mm_load_ps1(&n.x);
+            __m128 ny_v = _mm_load_ps1(&n.y);
+            __m128 nz_v = _mm_load_ps1(&n.z);
+            __m128 max_dot_v = _mm_load_ps1(&max_dot);
+            float d_s[verts.x.size()] __attribute__((aligned(16)));
+
+            for (unsigned int i = 0; i < verts.N; i+=4)
+                {
+                __m128 x_v = _mm_load_ps(verts.x.get() + i);
+                __m128 y_v = _mm_load_ps(verts.y.get() + i);
+                __m128 z_v = _mm_load_ps(verts.z.get() + i);
+
+                __m128 d_v = _mm_add_ps(_mm_mul_ps(nx_v, x_v), _mm_add_ps(_mm_mul_ps(ny_v, y_v), _mm_mul_ps(nz_v, z_v)));
+
+                // determine a maximum in each of the 4 channels as we go
+                max_dot_v = _mm_max_ps(max_dot_v, d_v);
 
-                // if no AVX or SSE, or running in double precision, fall back on serial computation
-                // this code path also triggers on the GPU
+                _mm_store_ps(d_s + i, d_v);
+                }
+
+            // find the maximum of the 4 channels
+            // http://stackoverflow.com/questions/17638487/minimum-of-4-sp-values-in-m128
+            max_dot_v = _mm_max_ps(max_dot_v, _mm_shuffle_ps(max_dot_v, max_dot_v, _MM_SHUFFLE(2, 1, 0, 3)));
+            max_dot_v = _mm_max_ps(max_dot_v, _mm_shuffle_ps(max_dot_v, max_dot_v, _MM_SHUFFLE(1, 0, 3, 2)));
+
+            // loop again and find the max. The reason this is in a 2nd loop is because branch mis-predictions
+            // and the extra max calls kill performance if this is in the first loop
+            // Use BSF to find the first index of the max element
+            // https://software.intel.com/en-us/forums/topic/285956
+            for (unsigned int i = 0; i < verts.N; i+=4)
+                {
+                __m128 d_v = _mm_load_ps(d_s + i);
 
-                OverlapReal max_dot0 = dot(n, vec3<OverlapReal>(verts.x[0], verts.y[0], verts.z[0]));
-                unsigned int max_idx0 = 0;
-                OverlapReal max_dot1 = dot(n, vec3<OverlapReal>(verts.x[1], verts.y[1], verts.z[1]));
-                unsigned int max_idx1 = 1;
-                OverlapReal max_dot2 = dot(n, vec3<OverlapReal>(verts.x[2], verts.y[2], verts.z[2]));
-                unsigned int max_idx2 = 2;
-                OverlapReal max_dot3 = dot(n, vec3<OverlapReal>(verts.x[3], verts.y[3], verts.z[3]));
-                unsigned int max_idx3 = 3;
+                int id = __builtin_ffs(_mm_movemask_ps(_mm_cmpeq_ps(max_dot_v, d_v)));
 
-                for (unsigned int i = 4; i < verts.N; i+=4)
+                if (id)
                     {
-                    const OverlapReal *verts_x = verts.x.get() + i;
-                    const OverlapReal *verts_y = verts.y.get() + i;
-                    const OverlapReal *verts_z = verts.z.get() + i;
-                    OverlapReal d0 = dot(n, vec3<OverlapReal>(verts_x[0], verts_y[0], verts_z[0]));
-                    OverlapReal d1 = dot(n, vec3<OverlapReal>(verts_x[1], verts_y[1], verts_z[1]));
-                    OverlapReal d2 = dot(n, vec3<OverlapReal>(verts_x[2], verts_y[2], verts_z[2]));
-                    OverlapReal d3 = dot(n, vec3<OverlapReal>(verts_x[3], verts_y[3], verts_z[3]));
-
-                    if (d0 > max_dot0)
-                        {
-                        max_dot0 = d0;
-                        max_idx0 = i;
-                        }
-                    if (d1 > max_dot1)
-                        {
-                        max_dot1 = d1;
-                        max_idx1 = i+1;
-                        }
-                    if (d2 > max_dot2)
-                        {
-                        max_dot2 = d2;
-                        max_idx2 = i+2;
-                        }
-                    if (d3 > max_dot3)
-                        {
-                        max_dot3 = d3;
-                        max_idx3 = i+3;
-                        }
+                    max_idx = i + id - 1;
+                    break;
                     }
+                }
+            #else
 
+            // if no AVX or SSE, or running in double precision, fall back on serial computation
+            // this code path also triggers on the GPU
 
-                max_dot = max_dot0;
-                max_idx = max_idx0;
+            OverlapReal max_dot0 = dot(n, vec3<OverlapReal>(verts.x[0], verts.y[0], verts.z[0]));
+            unsigned int max_idx0 = 0;
+            OverlapReal max_dot1 = dot(n, vec3<OverlapReal>(verts.x[1], verts.y[1], verts.z[1]));
+            unsigned int max_idx1 = 1;
+            OverlapReal max_dot2 = dot(n, vec3<OverlapReal>(verts.x[2], verts.y[2], verts.z[2]));
+            unsigned int max_idx2 = 2;
+            OverlapReal max_dot3 = dot(n, vec3<OverlapReal>(verts.x[3], verts.y[3], verts.z[3]));
+            unsigned int max_idx3 = 3;
 
-                if (max_dot1 > max_dot)
+            for (unsigned int i = 4; i < verts.N; i+=4)
+                {
+                const OverlapReal *verts_x = verts.x.get() + i;
+                const OverlapReal *verts_y = verts.y.get() + i;
+                const OverlapReal *verts_z = verts.z.get() + i;
+                OverlapReal d0 = dot(n, vec3<OverlapReal>(verts_x[0], verts_y[0], verts_z[0]));
+                OverlapReal d1 = dot(n, vec3<OverlapReal>(verts_x[1], verts_y[1], verts_z[1]));
+                OverlapReal d2 = dot(n, vec3<OverlapReal>(verts_x[2], verts_y[2], verts_z[2]));
+                OverlapReal d3 = dot(n, vec3<OverlapReal>(verts_x[3], verts_y[3], verts_z[3]));
+
+                if (d0 > max_dot0)
                     {
-                    max_dot = max_dot1;
-                    max_idx = max_idx1;
+                    max_dot0 = d0;
+                    max_idx0 = i;
                     }
-                if (max_dot2 > max_dot)
+                if (d1 > max_dot1)
                     {
-                    max_dot = max_dot2;
-                    max_idx = max_idx2;
+                    max_dot1 = d1;
+                    max_idx1 = i+1;
                     }
-                if (max_dot3 > max_dot)
+                if (d2 > max_dot2)
                     {
-                    max_dot = max_dot3;
-                    max_idx = max_idx3;
+                    max_dot2 = d2;
+                    max_idx2 = i+2;
                     }
-                #endif
+                if (d3 > max_dot3)
+                    {
+                    max_dot3 = d3;
+                    max_idx3 = i+3;
+                    }
+                }
 
-                vec3<OverlapReal> v(verts.x[max_idx], verts.y[max_idx], verts.z[max_idx]);
-                if (sweep_radius != OverlapReal(0.0))
-                    return v + (sweep_radius * fast::rsqrt(dot(n,n))) * n;
-                else
-                    return v;
-                } // end if(verts.N > 0)
-            else
+
+            max_dot = max_dot0;
+            max_idx = max_idx0;
+
+            if (max_dot1 > max_dot)
                 {
-                if (sweep_radius != OverlapReal(0.0))
-                    return (sweep_radius * fast::rsqrt(dot(n,n))) * n;
-                else
-                    return vec3<OverlapReal>(0.0, 0.0, 0.0); // No verts!
+                max_dot = max_dot1;
+                max_idx = max_idx1;
+                }
+            if (max_dot2 > max_dot)
+                {
+                max_dot = max_dot2;
+                max_idx = max_idx2;
+                }
+            if (max_dot3 > max_dot)
+                {
+                max_dot = max_dot3;
+                max_idx = max_idx3;
                 }
+            #endif
+
+            return max_idx;
             }
 
     private:
         const PolyhedronVertices& verts;      //!< Vertices of the polyhedron
         const OverlapReal sweep_radius; //!< Extra sweep radius
+        #if !defined(__HIPCC__)
+        SupportVertexCache *cache;      //!< Shared cache of support vertices (may be NULL)
+        mutable SupportVertexCache local_cache; //!< Private cache of support vertices
+        #endif
     };
 
 /** Geometric primitives for closest point calculation
@@ -781,6 +961,11 @@ struct ShapeConvexPolyhedron
 
     /// Shape parameters
     const detail::PolyhedronVertices& verts;
+
+    #if !defined(__HIPCC__)
+    /// Support vertices found in earlier overlap tests with this shape (e.g. during one trial move)
+    mutable detail::SupportVertexCache support_cache;
+    #endif
     };
 
 /** Convex polyhedron overlap test
@@ -805,8 +990,17 @@ DEVICE inline bool test_overlap(const vec3<Scalar>& r_ab,
 
     OverlapReal DaDb = a.getCircumsphereDiameter() + b.getCircumsphereDiameter();
 
-    return detail::xenocollide_3d(detail::SupportFuncConvexPolyhedron(a.verts,sweep_radius_a),
-                                  detail::SupportFuncConvexPolyhedron(b.verts,sweep_radius_b),
+    // the support vertex caches are only kept on the CPU
+    #if !defined(__HIPCC__)
+    detail::SupportVertexCache *cache_a = &a.support_cache;
+    detail::SupportVertexCache *cache_b = &b.support_cache;
+    #else
+    detail::SupportVertexCache *cache_a = NULL;
+    detail::SupportVertexCache *cache_b = NULL;
+    #endif
+
+    return detail::xenocollide_3d(detail::SupportFuncConvexPolyhedron(a.verts,sweep_radius_a,cache_a),
+                                  detail::SupportFuncConvexPolyhedron(b.verts,sweep_radius_b,cache_b),
                                   rotate(conj(quat<OverlapReal>(a.orientation)), dr),
                                   conj(quat<OverlapReal>(a.orientation))* quat<OverlapReal>(b.orientation),
                                   DaDb/2.0,
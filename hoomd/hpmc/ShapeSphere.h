@@ -11,6 +11,7 @@
 #include "hoomd/AABB.h"
 #include "hoomd/hpmc/OBB.h"
 #include "hoomd/hpmc/HPMCMiscFunctions.h"
+#include "hoomd/hpmc/SweepDistance.h"
 #include <sstream>
 
 #include <stdexcept>
@@ -467,6 +468,37 @@ DEVICE inline bool test_overlap<ShapeSphere, ShapeSphere>(const vec3<Scalar>& r_
         }
     }
 
+//! Sphere-Sphere sweep distance
+/*! \param r_ab Vector defining the position of shape b relative to shape a (r_b - r_a)
+    \param direction Unit vector along which shape a moves
+    \param a first shape
+    \param b second shape
+    \param max_distance Largest distance of interest
+    \param err in/out variable incremented when error conditions occur in the overlap test
+    \returns the distance a moves before it touches b, or *max_distance* when they do not touch within it
+
+    \ingroup shape
+*/
+template <>
+DEVICE inline OverlapReal sweep_distance<ShapeSphere, ShapeSphere>(const vec3<Scalar>& r_ab,
+    const vec3<Scalar>& direction, const ShapeSphere& a, const ShapeSphere& b, OverlapReal max_distance,
+    unsigned int& err)
+    {
+    vec3<OverlapReal> dr(r_ab);
+    vec3<OverlapReal> d(direction);
+
+    OverlapReal RaRb = a.params.radius + b.params.radius;
+    OverlapReal proj = dot(dr,d);
+    OverlapReal disc = proj*proj - dot(dr,dr) + RaRb*RaRb;
+
+    // b is behind a or a passes it by
+    if (proj <= OverlapReal(0.0) || disc < OverlapReal(0.0))
+        return max_distance;
+
+    OverlapReal s = detail::max(proj - fast::sqrt(disc), OverlapReal(0.0));
+    return detail::min(s, max_distance);
+    }
+
 //! Test for overlap of a third particle with the intersection of two shapes
 /*! \param a First shape to test
     \param b Second shape to test
@@ -138,6 +138,10 @@ struct ShapeSpheropolyhedron
     quat<Scalar> orientation;    //!< Orientation of the polyhedron
 
     const detail::PolyhedronVertices& verts;     //!< Vertices
+
+    #if !defined(__HIPCC__)
+    mutable detail::SupportVertexCache support_cache;  //!< Support vertices found in earlier overlap tests
+    #endif
     };
 
 //! Convex polyhedron overlap test
@@ -163,8 +167,17 @@ DEVICE inline bool test_overlap(const vec3<Scalar>& r_ab,
 
     OverlapReal DaDb = a.getCircumsphereDiameter() + b.getCircumsphereDiameter();
 
-    return xenocollide_3d(detail::SupportFuncConvexPolyhedron(a.verts,a.verts.sweep_radius+sweep_radius_a),
-                          detail::SupportFuncConvexPolyhedron(b.verts,b.verts.sweep_radius+sweep_radius_b),
+    // the support vertex caches are only kept on the CPU
+    #if !defined(__HIPCC__)
+    detail::SupportVertexCache *cache_a = &a.support_cache;
+    detail::SupportVertexCache *cache_b = &b.support_cache;
+    #else
+    detail::SupportVertexCache *cache_a = NULL;
+    detail::SupportVertexCache *cache_b = NULL;
+    #endif
+
+    return xenocollide_3d(detail::SupportFuncConvexPolyhedron(a.verts,a.verts.sweep_radius+sweep_radius_a,cache_a),
+                          detail::SupportFuncConvexPolyhedron(b.verts,b.verts.sweep_radius+sweep_radius_b,cache_b),
                           rotate(conj(quat<OverlapReal>(a.orientation)),dr),
                           conj(quat<OverlapReal>(a.orientation)) * quat<OverlapReal>(b.orientation),
                           DaDb/2.0,
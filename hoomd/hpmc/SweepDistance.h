@@ -0,0 +1,132 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#pragma once
+
+#include "hoomd/HOOMDMath.h"
+#include "hoomd/VectorMath.h"
+#include "HPMCPrecisionSetup.h"
+#include "HPMCMiscFunctions.h"
+
+/*! \file SweepDistance.h
+    \brief Declares the sweep distance shape function used by event chain Monte Carlo
+*/
+
+// need to declare these functions with __device__ qualifiers when building in nvcc
+// DEVICE is __device__ when included in nvcc and blank when included into the host compiler
+#ifdef __HIPCC__
+#define DEVICE __device__
+#else
+#define DEVICE
+#endif
+
+namespace hpmc
+{
+
+namespace detail
+{
+
+//! Sweep distance of two shapes from their overlap test
+/*! \param r_ab Vector defining the position of shape b relative to shape a (r_b - r_a)
+    \param direction Unit vector along which shape a moves
+    \param a first shape
+    \param b second shape
+    \param max_distance Largest distance of interest
+    \param err in/out variable incremented when error conditions occur in the overlap test
+    \returns the distance a moves before it touches b, or *max_distance* when they do not touch within it
+
+    The shapes cannot touch before their circumspheres do, so a first advances to just before the displacement
+    where the circumspheres meet. Within the circumspheres the separation has no lower bound, and a marches in steps
+    of 1/64 of the smaller circumsphere diameter until test_overlap() reports a contact. The contact is then bisected
+    between the last disjoint and the first overlapping position, and the disjoint end is returned. A grazing contact
+    that lasts for less than one step along the path can be missed.
+*/
+template <class ShapeA, class ShapeB>
+DEVICE inline OverlapReal sweep_distance_bisect(const vec3<Scalar>& r_ab, const vec3<Scalar>& direction,
+    const ShapeA& a, const ShapeB& b, OverlapReal max_distance, unsigned int& err)
+    {
+    vec3<OverlapReal> dr(r_ab);
+    vec3<OverlapReal> d(direction);
+
+    // the circumspheres intersect for displacements in [proj - sqrt(disc), proj + sqrt(disc)]
+    OverlapReal R = OverlapReal(0.5)*(a.getCircumsphereDiameter() + b.getCircumsphereDiameter());
+    OverlapReal proj = dot(dr,d);
+    OverlapReal disc = proj*proj - dot(dr,dr) + R*R;
+    if (disc < OverlapReal(0.0))
+        return max_distance;
+    OverlapReal sqrt_disc = fast::sqrt(disc);
+    if (proj + sqrt_disc < OverlapReal(0.0) || proj - sqrt_disc >= max_distance)
+        return max_distance;
+    OverlapReal s_end = detail::min(proj + sqrt_disc, max_distance);
+
+    // start one step before the circumspheres meet, where the shapes are disjoint unless they overlap at s = 0
+    OverlapReal step = detail::min(a.getCircumsphereDiameter(), b.getCircumsphereDiameter())/OverlapReal(64.0);
+    OverlapReal s_begin = detail::max(proj - sqrt_disc - step, OverlapReal(0.0));
+    if (test_overlap(r_ab - Scalar(s_begin)*direction, a, b, err))
+        return s_begin;
+
+    // march through the circumsphere intersection
+    unsigned int n_steps = (unsigned int)ceil((s_end - s_begin)/step);
+    OverlapReal s_free = s_begin;
+    OverlapReal s_hit = s_end;
+    bool hit = false;
+    for (unsigned int i = 1; i <= n_steps && !hit; ++i)
+        {
+        OverlapReal s = (i == n_steps) ? s_end : s_begin + (s_end - s_begin)*OverlapReal(i)/OverlapReal(n_steps);
+        if (test_overlap(r_ab - Scalar(s)*direction, a, b, err))
+            {
+            s_hit = s;
+            hit = true;
+            }
+        else
+            {
+            s_free = s;
+            }
+        }
+
+    if (!hit)
+        return max_distance;
+
+    // bisect the contact
+    for (unsigned int i = 0; i < 32; ++i)
+        {
+        OverlapReal s = OverlapReal(0.5)*(s_free + s_hit);
+        if (s <= s_free || s >= s_hit)
+            break;
+
+        if (test_overlap(r_ab - Scalar(s)*direction, a, b, err))
+            s_hit = s;
+        else
+            s_free = s;
+        }
+
+    return s_free;
+    }
+
+} // end namespace detail
+
+//! Distance that shape a can move along a direction before it touches shape b
+/*! \param r_ab Vector defining the position of shape b relative to shape a (r_b - r_a)
+    \param direction Unit vector along which shape a moves
+    \param a first shape
+    \param b second shape
+    \param max_distance Largest distance of interest
+    \param err in/out variable incremented when error conditions occur in the overlap test
+    \returns the distance a moves before it touches b, or *max_distance* when they do not touch within it
+
+    Event chains apply the returned displacement without checking for overlaps afterwards. Shapes with an exact
+    expression specialize this template. All other shapes use detail::sweep_distance_bisect(), which resolves the
+    contact with test_overlap().
+
+    \ingroup shape
+*/
+template <class ShapeA, class ShapeB>
+DEVICE inline OverlapReal sweep_distance(const vec3<Scalar>& r_ab, const vec3<Scalar>& direction,
+    const ShapeA& a, const ShapeB& b, OverlapReal max_distance, unsigned int& err)
+    {
+    return detail::sweep_distance_bisect(r_ab, direction, a, b, max_distance, err);
+    }
+
+}; // end namespace hpmc
+
+#undef DEVICE
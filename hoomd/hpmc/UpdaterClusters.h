@@ -13,6 +13,7 @@
 
 #include <set>
 #include <list>
+#include <atomic>
 
 #include "Moves.h"
 #include "HPMCCounters.h"
@@ -23,8 +24,8 @@
 #include <tbb/concurrent_unordered_set.h>
 #include <tbb/concurrent_vector.h>
 #include <tbb/parallel_for.h>
-#include <tbb/task.h>
-#include <atomic>
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
 #endif
 
 namespace hpmc
@@ -33,216 +34,235 @@ namespace hpmc
 namespace detail
 {
 
-#ifdef ENABLE_TBB
-//! Wrapper around std::atomic_flag to allow use in a std::vector
-class my_atomic_flag
-    {
-    public:
-        //! Default constructor
-        my_atomic_flag()
-            {
-            f.clear();
-            }
-
-        //! Copy constructor
-        /*! \note this constructor doesn't really copy the value of its argument,
-            it just reset's the flag to zero
-         */
-        my_atomic_flag(const my_atomic_flag& other)
-            {
-            f.clear();
-            }
-
-        //! Assignment operator (non-atomic)
-        /*! \note this assignment operator doesn't really copy the value of its argument,
-            it just reset's the flag to zero
-         */
-        my_atomic_flag& operator =( const my_atomic_flag& other)
-            {
-            f.clear();
-            return *this;
-            }
-
-        //! Sets flag and returns old value
-        bool test_and_set()
-            {
-            return f.test_and_set();
-            }
-
-    private:
-        std::atomic_flag f;
-    };
-#endif
+//! Undirected graph with connected component labeling
+/*! Edges are collected in per-thread buffers so that addEdge() may be called concurrently without locks or hashing.
+    connectedComponents() concatenates the buffers into one contiguous edge list and labels the components with a
+    lock-free union-find. Each edge links the roots of its two end points, always attaching the root with the larger
+    index to the one with the smaller index (link-by-index), so that concurrent links cannot form cycles and the final
+    root of each component is its smallest vertex. find() compresses paths by halving them with atomic updates.
 
-// Graph class represents a undirected graph
-// using adjacency list representation
+    The components are returned in compressed sparse row form, ordered by their smallest vertex, with the vertices of
+    each component in ascending order. The result is therefore independent of the number of threads.
+*/
 class Graph
     {
     public:
-        Graph() {}      //!< Default constructor
+        Graph() : m_n_vertices(0) {}      //!< Default constructor
 
         inline Graph(unsigned int V);   // Constructor
 
+        //! Remove all edges and set the number of vertices
         inline void resize(unsigned int V);
 
+        //! Add an undirected edge, safe to call concurrently
         inline void addEdge(unsigned int v, unsigned int w);
 
-        #ifdef ENABLE_TBB
-        inline void connectedComponents(std::vector<tbb::concurrent_vector<unsigned int> >& cc);
-        #else
-        inline void connectedComponents(std::vector<std::vector<unsigned int> >& cc);
-        #endif
+        //! Label the connected components
+        /*! \param cc_start Set to the index of the first vertex of each component in cc, plus the total at the end
+            \param cc Set to the vertices, grouped by component
+        */
+        inline void connectedComponents(std::vector<unsigned int>& cc_start, std::vector<unsigned int>& cc);
+
+        //! Get the number of edges added since the last resize()
+        inline unsigned int getNumEdges();
 
     private:
-        #ifndef ENABLE_TBB
-        std::multimap<unsigned int,unsigned int> adj;
-        #else
-        tbb::concurrent_unordered_multimap<unsigned int, unsigned int> adj;
-        #endif
+        unsigned int m_n_vertices;                                   //!< Number of vertices
 
-        #ifndef ENABLE_TBB
-        std::vector<unsigned int> visited;
+        #ifdef ENABLE_TBB
+        tbb::enumerable_thread_specific< std::vector< std::pair<unsigned int, unsigned int> > > m_thread_edges;
         #else
-        std::vector<my_atomic_flag> visited;
+        std::vector< std::pair<unsigned int, unsigned int> > m_thread_edges;
         #endif
+        std::vector< std::pair<unsigned int, unsigned int> > m_edges;   //!< Contiguous list of all edges
 
-        #ifndef ENABLE_TBB
-        // A function used by DFS
-        inline void DFSUtil(unsigned int v, std::vector<unsigned int>& visited, std::vector<unsigned int>& cur_cc);
-        #endif
+        std::vector< std::atomic<unsigned int> > m_parent;      //!< Union-find parent of each vertex
+        std::vector<unsigned int> m_label;                      //!< Root of each vertex
+        std::vector<unsigned int> m_cc_fill;                    //!< Fill pointers for the component list
 
-        #ifdef ENABLE_TBB
-        class DFSTask : public tbb::task
+        //! Find the root of a vertex, halving the path on the way
+        unsigned int find(unsigned int v)
             {
-            public:
-                DFSTask(unsigned int _root, std::vector<my_atomic_flag>& _visited,
-                    tbb::concurrent_vector<unsigned int>& _cc,
-                    const tbb::concurrent_unordered_multimap<unsigned int, unsigned int>& _adj)
-                    : root(_root), visited(_visited), cc(_cc), adj(_adj)
-                    { }
-
-                tbb::task* execute()
+            unsigned int p = m_parent[v].load(std::memory_order_relaxed);
+            while (p != v)
+                {
+                unsigned int gp = m_parent[p].load(std::memory_order_relaxed);
+                if (gp != p)
                     {
-                    cc.push_back(root);
+                    // point v to its grandparent, which is closer to the root (another thread may have done so)
+                    m_parent[v].compare_exchange_weak(p, gp, std::memory_order_relaxed);
+                    }
+                v = p;
+                p = m_parent[v].load(std::memory_order_relaxed);
+                }
+            return v;
+            }
 
-                    unsigned int count = 0;
-                    tbb::task_list list;
+        //! Merge the components of two vertices
+        void unite(unsigned int v, unsigned int w)
+            {
+            while (true)
+                {
+                unsigned int rv = find(v);
+                unsigned int rw = find(w);
+                if (rv == rw)
+                    return;
 
-                    auto begin = adj.equal_range(root).first;
-                    auto end = adj.equal_range(root).second;
+                // link the larger root to the smaller one
+                if (rv < rw)
+                    std::swap(rv, rw);
 
-                    for (auto it = begin; it != end; ++it)
-                        {
-                        unsigned int neighbor = it->second;
-                        if (!visited[neighbor].test_and_set())
-                            {
-                            if (count++ == 0)
-                                {
-                                root = neighbor; // for task recycling
-                                continue;
-                                }
-                            list.push_back(*new(allocate_child()) DFSTask(neighbor, visited, cc, adj));
-                            }
-                        }
+                unsigned int expected = rv;
+                if (m_parent[rv].compare_exchange_strong(expected, rw, std::memory_order_relaxed))
+                    return;
 
-                    if (count)
-                        {
-                        set_ref_count(count);
-                        spawn(list);
+                // rv was linked by another thread in the meantime, retry from the new roots
+                }
+            }
+    };
 
-                        recycle_as_safe_continuation();
-                        }
+Graph::Graph(unsigned int V)
+    : m_n_vertices(0)
+    {
+    resize(V);
+    }
 
-                    return NULL;
-                    }
+void Graph::resize(unsigned int V)
+    {
+    m_n_vertices = V;
 
-            private:
-                unsigned int root;
-                std::vector<my_atomic_flag> & visited;
-                tbb::concurrent_vector<unsigned int>& cc;
-                const tbb::concurrent_unordered_multimap<unsigned int, unsigned int>& adj;
-            };
-        #endif // ENABLE_TBB
+    #ifdef ENABLE_TBB
+    for (auto it = m_thread_edges.begin(); it != m_thread_edges.end(); ++it)
+        it->clear();
+    #else
+    m_thread_edges.clear();
+    #endif
 
-    };
+    if (m_parent.size() != V)
+        m_parent = std::vector< std::atomic<unsigned int> >(V);
+    }
 
-// Gather connected components in an undirected graph
-#ifdef ENABLE_TBB
-void Graph::connectedComponents(std::vector<tbb::concurrent_vector<unsigned int> >& cc)
-#else
-void Graph::connectedComponents(std::vector<std::vector<unsigned int> >& cc)
-#endif
+// method to add an undirected edge
+void Graph::addEdge(unsigned int v, unsigned int w)
+    {
+    #ifdef ENABLE_TBB
+    m_thread_edges.local().push_back(std::make_pair(v,w));
+    #else
+    m_thread_edges.push_back(std::make_pair(v,w));
+    #endif
+    }
+
+unsigned int Graph::getNumEdges()
+    {
+    #ifdef ENABLE_TBB
+    unsigned int n_edges = 0;
+    for (auto it = m_thread_edges.begin(); it != m_thread_edges.end(); ++it)
+        n_edges += it->size();
+    return n_edges;
+    #else
+    return m_thread_edges.size();
+    #endif
+    }
+
+void Graph::connectedComponents(std::vector<unsigned int>& cc_start, std::vector<unsigned int>& cc)
     {
+    const unsigned int V = m_n_vertices;
+
+    // concatenate the per-thread edge buffers
     #ifdef ENABLE_TBB
-    for (unsigned int v = 0; v < visited.size(); ++v)
+    std::vector<unsigned int> offset;
+    std::vector< std::vector< std::pair<unsigned int, unsigned int> >* > buffers;
+    unsigned int n_edges = 0;
+    for (auto it = m_thread_edges.begin(); it != m_thread_edges.end(); ++it)
         {
-        if (! visited[v].test_and_set())
-            {
-            tbb::concurrent_vector<unsigned int> component;
-            DFSTask& a = *new(tbb::task::allocate_root()) DFSTask(v, visited, component, adj);
-            tbb::task::spawn_root_and_wait(a);
-            cc.push_back(component);
-            }
+        offset.push_back(n_edges);
+        buffers.push_back(&(*it));
+        n_edges += it->size();
         }
+    m_edges.resize(n_edges);
+    tbb::parallel_for((unsigned int)0, (unsigned int)buffers.size(), [&](unsigned int b)
+        {
+        std::copy(buffers[b]->begin(), buffers[b]->end(), m_edges.begin() + offset[b]);
+        });
     #else
-    std::fill(visited.begin(), visited.end(), 0);
+    m_edges.swap(m_thread_edges);
+    m_thread_edges.clear();
+    unsigned int n_edges = m_edges.size();
+    #endif
 
-    // Depth first search
-    for (unsigned int v=0; v<visited.size(); v++)
+    // every vertex starts in its own component
+    #ifdef ENABLE_TBB
+    tbb::parallel_for((unsigned int)0, V, [&](unsigned int v)
+    #else
+    for (unsigned int v = 0; v < V; ++v)
+    #endif
         {
-        if (visited[v] == false)
-            {
-            std::vector<unsigned int> cur_cc;
-            DFSUtil(v, visited, cur_cc);
-            cc.push_back(cur_cc);
-            }
+        m_parent[v].store(v, std::memory_order_relaxed);
         }
+    #ifdef ENABLE_TBB
+        );
     #endif
-    }
 
-#ifndef ENABLE_TBB
-void Graph::DFSUtil(unsigned int v, std::vector<unsigned int>& visited, std::vector<unsigned int>& cur_cc)
-    {
-    visited[v] = 1;
-    cur_cc.push_back(v);
-
-    // Recur for all the vertices
-    // adjacent to this vertex
-    auto begin = adj.equal_range(v).first;
-    auto end = adj.equal_range(v).second;
-    for(auto i = begin; i != end; ++i)
+    // link the end points of every edge
+    #ifdef ENABLE_TBB
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_edges),
+        [&](const tbb::blocked_range<unsigned int>& r)
         {
-        if(!visited[i->second])
-            DFSUtil(i->second, visited, cur_cc);
-        }
-    }
-#endif
-Graph::Graph(unsigned int V)
-    {
-    #ifndef ENABLE_TBB
-    visited.resize(V, 0);
+        for (unsigned int e = r.begin(); e != r.end(); ++e)
+            unite(m_edges[e].first, m_edges[e].second);
+        });
     #else
-    visited.resize(V);
+    for (unsigned int e = 0; e < n_edges; ++e)
+        unite(m_edges[e].first, m_edges[e].second);
     #endif
-    }
 
-void Graph::resize(unsigned int V)
-    {
-    #ifndef ENABLE_TBB
-    visited.resize(V, 0);
+    // resolve the final root of every vertex, which is the smallest vertex in its component
+    m_label.resize(V);
+    #ifdef ENABLE_TBB
+    tbb::parallel_for((unsigned int)0, V, [&](unsigned int v)
     #else
-    visited.clear();
-    visited.resize(V);
+    for (unsigned int v = 0; v < V; ++v)
+    #endif
+        {
+        m_label[v] = find(v);
+        }
+    #ifdef ENABLE_TBB
+        );
     #endif
 
-    adj.clear();
-    }
+    // count the vertices per component, numbering the components in the order of their roots
+    cc_start.clear();
+    m_cc_fill.resize(V);
+    for (unsigned int v = 0; v < V; ++v)
+        {
+        if (m_label[v] == v)
+            {
+            m_cc_fill[v] = cc_start.size();
+            cc_start.push_back(0);
+            }
+        cc_start[m_cc_fill[m_label[v]]]++;
+        }
 
-// method to add an undirected edge
-void Graph::addEdge(unsigned int v, unsigned int w)
-    {
-    adj.insert(std::make_pair(v,w));
-    adj.insert(std::make_pair(w,v));
+    // exclusive prefix sum
+    unsigned int n_cc = cc_start.size();
+    unsigned int sum = 0;
+    for (unsigned int c = 0; c < n_cc; ++c)
+        {
+        unsigned int n = cc_start[c];
+        cc_start[c] = sum;
+        sum += n;
+        }
+    cc_start.push_back(sum);
+
+    // fill in the vertices in ascending order
+    for (unsigned int v = 0; v < V; ++v)
+        {
+        if (m_label[v] == v)
+            m_cc_fill[v] = cc_start[m_cc_fill[v]];
+        }
+    cc.resize(V);
+    for (unsigned int v = 0; v < V; ++v)
+        cc[m_cc_fill[m_label[v]]++] = v;
     }
 } // end namespace detail
 
@@ -477,11 +497,8 @@ class UpdaterClusters : public Updater
         Scalar m_swap_move_ratio;                   //!< Type swap / geometric move ratio
         Scalar m_flip_probability;                  //!< Cluster flip probability
 
-        #ifdef ENABLE_TBB
-        std::vector<tbb::concurrent_vector<unsigned int> > m_clusters; //!< Cluster components
-        #else
-        std::vector<std::vector<unsigned int> > m_clusters; //!< Cluster components
-        #endif
+        std::vector<unsigned int> m_cluster_start;  //!< Start of each cluster in m_clusters, plus the total at the end
+        std::vector<unsigned int> m_clusters;       //!< Particles, grouped by cluster
 
         detail::Graph m_G; //!< The graph
 
@@ -2022,22 +2039,24 @@ void UpdaterClusters<Shape>::update(unsigned int timestep)
 
         if (this->m_prof) this->m_prof->push("connected components");
         // compute connected components
-        m_clusters.clear();
-        m_G.connectedComponents(m_clusters);
+        m_G.connectedComponents(m_cluster_start, m_clusters);
         if (this->m_prof) this->m_prof->pop();
 
         if (this->m_prof) this->m_prof->push("reject");
 
         // move every cluster independently
-        m_count_total.n_clusters += m_clusters.size();
+        const unsigned int n_clusters = m_cluster_start.size() - 1;
+        m_count_total.n_clusters += n_clusters;
 
-        for (unsigned int icluster = 0; icluster < m_clusters.size(); icluster++)
+        for (unsigned int icluster = 0; icluster < n_clusters; icluster++)
             {
-            m_count_total.n_particles_in_clusters += m_clusters[icluster].size();
+            auto cluster_begin = m_clusters.begin() + m_cluster_start[icluster];
+            auto cluster_end = m_clusters.begin() + m_cluster_start[icluster+1];
+            m_count_total.n_particles_in_clusters += cluster_end - cluster_begin;
 
             // if any particle in the cluster is rejected, the cluster is not transformed
             bool reject = false;
-            for (auto it = m_clusters[icluster].begin(); it != m_clusters[icluster].end(); ++it)
+            for (auto it = cluster_begin; it != cluster_end; ++it)
                 {
                 bool mpi = false;
                 #ifdef ENABLE_MPI
@@ -2057,7 +2076,7 @@ void UpdaterClusters<Shape>::update(unsigned int timestep)
                 int n_A_old = 0, n_A_new = 0;
                 int n_B_old = 0, n_B_new = 0;
 
-                for (auto it = m_clusters[icluster].begin(); it != m_clusters[icluster].end(); ++it)
+                for (auto it = cluster_begin; it != cluster_end; ++it)
                     {
                     unsigned int i = *it;
                     if (snap.type[i] == m_ab_types[0])
@@ -2079,7 +2098,7 @@ void UpdaterClusters<Shape>::update(unsigned int timestep)
             if (reject || !flip)
                 {
                 // revert cluster
-                for (auto it = m_clusters[icluster].begin(); it != m_clusters[icluster].end(); ++it)
+                for (auto it = cluster_begin; it != cluster_end; ++it)
                     {
                     // particle index
                     unsigned int i = *it;
@@ -2108,7 +2127,7 @@ void UpdaterClusters<Shape>::update(unsigned int timestep)
                 }
             else if (flip)
                 {
-                for (auto it = m_clusters[icluster].begin(); it != m_clusters[icluster].end(); ++it)
+                for (auto it = cluster_begin; it != cluster_end; ++it)
                     {
                     // particle index
                     unsigned int i = *it;
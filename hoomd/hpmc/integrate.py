@@ -105,6 +105,24 @@ class HPMCIntegrator(BaseIntegrator):
 
         seed (int): Random number seed.
 
+        checkerboard (bool): Set to `True` to sweep over the particles in a
+            checkerboard decomposition of the local box (CPU only, **default:**
+            `False`). See below.
+
+    .. rubric:: Checkerboard sweeps
+
+    By default, the CPU implementation attempts the trial moves one particle at
+    a time. When `checkerboard` is `True`, it divides the local box into cells
+    that are at least as wide as the largest interaction range and colors the
+    cells like a checkerboard. Each sweep visits the colors in a random order,
+    with a random offset of the cell grid. Trial moves that would take a
+    particle out of its cell are rejected, so particles in different cells of
+    the same color never interact and TBB enabled builds update these cells in
+    parallel. The resulting trajectory does not depend on the number of
+    threads, but differs from the default sweep. Checkerboard sweeps do not
+    support depletants or external fields, with these the integrator falls back
+    to the default sweep.
+
     .. rubric:: Attributes
     """
 
@@ -117,7 +135,8 @@ class HPMCIntegrator(BaseIntegrator):
         param_dict = ParameterDict(
             seed=int(seed),
             translation_move_probability=float(translation_move_probability),
-            nselect=int(nselect))
+            nselect=int(nselect),
+            checkerboard=False)
         self._param_dict.update(param_dict)
 
         # Set standard typeparameters for hpmc integrators
@@ -446,6 +465,80 @@ class Sphere(HPMCIntegrator):
         """
         return super()._return_type_shapes()
 
+class SphereEventChain(Sphere):
+    """Hard sphere event chain Monte Carlo.
+
+    Args:
+        seed (int): Random number seed.
+
+        d (float): Default maximum length of a chain segment (distance units).
+
+        a (float): Default maximum size of rotation trial moves.
+
+        chain_length (float): Total displacement of each event chain (distance
+            units).
+
+        translation_move_probability (float): Fraction of moves that are
+            event chains.
+
+        nselect (int): Number of event chains or rotation trial moves to
+            perform per particle per timestep.
+
+    Perform event chain Monte Carlo of hard spheres (see `Sphere`). Instead of
+    a local trial move, each selected particle starts an event chain: it moves
+    along a random direction until it touches another particle, which then
+    continues along the same direction. The chain ends when the total
+    displacement reaches `chain_length`. Event chains are never rejected and
+    decorrelate dense systems much faster than local trial moves.
+
+    The chain is searched for collisions in segments no longer than `d`, which
+    must be set to a value of the order of the particle diameter.
+    ``translate_moves`` counts the chain segments. Orientable spheres perform
+    rotation trial moves with probability ``1 - translation_move_probability``.
+
+    Note:
+        `SphereEventChain` runs on the CPU and does not support MPI domain
+        decomposition, depletants, patch energies or external fields.
+
+    Examples::
+
+        mc = hoomd.hpmc.integrate.SphereEventChain(seed=415236, d=1.0,
+                                                   chain_length=10.0)
+        mc.shape["A"] = dict(diameter=1.0)
+
+    Attributes:
+        chain_length (float): Total displacement of each event chain
+            (distance units).
+    """
+    _cpp_cls = 'IntegratorHPMCMonoNECSphere'
+
+    def __init__(self,
+                 seed,
+                 d=1.0,
+                 a=0.1,
+                 chain_length=10.0,
+                 translation_move_probability=0.5,
+                 nselect=1):
+
+        # initialize base class
+        super().__init__(seed, d, a, translation_move_probability, nselect)
+
+        self._param_dict.update(
+            ParameterDict(chain_length=float(chain_length)))
+
+    @log
+    def pressure(self):
+        """float: :math:`\\beta P`, pressure sampled by the event chains \
+        (in units of inverse volume).
+
+        Calculated from the distances between the colliding particles. The
+        average is reset at the start of each `hoomd.Simulation.run`.
+        """
+        if self._attached:
+            return self._cpp_obj.getPressure()
+        else:
+            return None
+
 
 class ConvexPolygon(HPMCIntegrator):
     """Hard convex polygon Monte Carlo.
@@ -545,6 +638,76 @@ class ConvexPolygon(HPMCIntegrator):
         """
         return super(ConvexPolygon, self)._return_type_shapes()
 
+class ConvexPolygonEventChain(ConvexPolygon):
+    """Hard convex polygon event chain Monte Carlo.
+
+    Args:
+        seed (int): Random number seed.
+
+        d (float): Default maximum length of a chain segment (distance units).
+
+        a (float): Default maximum size of rotation trial moves.
+
+        chain_length (float): Total displacement of each event chain (distance
+            units).
+
+        translation_move_probability (float): Fraction of moves that are
+            event chains.
+
+        nselect (int): Number of event chains or rotation trial moves to
+            perform per particle per timestep.
+
+    Perform event chain Monte Carlo of hard convex polygons (see
+    `ConvexPolygon`) with the event chains described in `SphereEventChain`.
+    Particles perform rotation trial moves with probability
+    ``1 - translation_move_probability``.
+
+    Note:
+        `ConvexPolygonEventChain` runs on the CPU and does not support MPI
+        domain decomposition, depletants, patch energies or external fields.
+
+    Examples::
+
+        mc = hoomd.hpmc.integrate.ConvexPolygonEventChain(seed=415236, d=1.0,
+                                                          a=0.3)
+        mc.shape["A"] = dict(vertices=[(-0.5, -0.5),
+                                       (0.5, -0.5),
+                                       (0.5, 0.5),
+                                       (-0.5, 0.5)]);
+
+    Attributes:
+        chain_length (float): Total displacement of each event chain
+            (distance units).
+    """
+    _cpp_cls = 'IntegratorHPMCMonoNECConvexPolygon'
+
+    def __init__(self,
+                 seed,
+                 d=1.0,
+                 a=0.1,
+                 chain_length=10.0,
+                 translation_move_probability=0.5,
+                 nselect=1):
+
+        # initialize base class
+        super().__init__(seed, d, a, translation_move_probability, nselect)
+
+        self._param_dict.update(
+            ParameterDict(chain_length=float(chain_length)))
+
+    @log
+    def pressure(self):
+        """float: :math:`\\beta P`, pressure sampled by the event chains \
+        (in units of inverse volume).
+
+        Calculated from the distances between the colliding particles. The
+        average is reset at the start of each `hoomd.Simulation.run`.
+        """
+        if self._attached:
+            return self._cpp_obj.getPressure()
+        else:
+            return None
+
 
 class ConvexSpheropolygon(HPMCIntegrator):
     """Hard convex spheropolygon Monte Carlo.
@@ -0,0 +1,110 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file benchmark_cluster_graph.cc
+    \brief Times the connected component labeling of UpdaterClusters on large graphs
+
+    Bonds of a simple cubic lattice are occupied with a given probability, near the bond percolation threshold by
+    default, which produces clusters of all sizes as in cluster moves of dense systems. Usage:
+
+        benchmark_cluster_graph [N] [bond probability] [threads]
+*/
+
+#include "hoomd/ClockSource.h"
+#include "hoomd/RandomNumbers.h"
+#include "hoomd/hpmc/UpdaterClusters.h"
+
+#ifdef ENABLE_TBB
+#include <tbb/task_scheduler_init.h>
+#endif
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+using namespace hpmc;
+
+//! Fill the graph with the occupied bonds of a periodic simple cubic lattice with L^3 sites
+void add_bonds(detail::Graph& G, unsigned int L, double p, unsigned int seed)
+    {
+    const unsigned int V = L*L*L;
+
+    auto add_site = [&](unsigned int v)
+        {
+        unsigned int x = v % L;
+        unsigned int y = (v / L) % L;
+        unsigned int z = v / (L*L);
+        unsigned int neighbors[3] = {(x+1)%L + y*L + z*L*L, x + ((y+1)%L)*L + z*L*L, x + y*L + ((z+1)%L)*L*L};
+        hoomd::RandomGenerator rng(hoomd::RNGIdentifier::UpdaterClustersPairwise, seed, v);
+        for (unsigned int k = 0; k < 3; k++)
+            {
+            if (hoomd::detail::generate_canonical<double>(rng) < p)
+                G.addEdge(v, neighbors[k]);
+            }
+        };
+
+    #ifdef ENABLE_TBB
+    tbb::parallel_for((unsigned int)0, V, add_site);
+    #else
+    for (unsigned int v = 0; v < V; v++)
+        add_site(v);
+    #endif
+    }
+
+int main(int argc, char **argv)
+    {
+    unsigned int N = argc > 1 ? atoi(argv[1]) : 0;
+    double p = argc > 2 ? atof(argv[2]) : 0.2488;
+
+    #ifdef ENABLE_TBB
+    int n_threads = argc > 3 ? atoi(argv[3]) : tbb::task_scheduler_init::automatic;
+    tbb::task_scheduler_init init(n_threads);
+    #endif
+
+    std::vector<unsigned int> sizes;
+    if (N > 0)
+        {
+        sizes.push_back(N);
+        }
+    else
+        {
+        sizes.push_back(1000000);
+        sizes.push_back(10000000);
+        }
+
+    const unsigned int repeat = 5;
+    for (unsigned int s = 0; s < sizes.size(); s++)
+        {
+        unsigned int L = (unsigned int)std::round(std::cbrt(double(sizes[s])));
+        unsigned int V = L*L*L;
+
+        detail::Graph G;
+        std::vector<unsigned int> cc_start, cc;
+        double t_fill = 0, t_cc = 0;
+        unsigned int n_edges = 0;
+
+        for (unsigned int r = 0; r < repeat + 1; r++)
+            {
+            ClockSource clk;
+            G.resize(V);
+            add_bonds(G, L, p, r);
+            int64_t t0 = clk.getTime();
+            n_edges = G.getNumEdges();
+            G.connectedComponents(cc_start, cc);
+            int64_t t1 = clk.getTime();
+
+            // the first repetition warms up the allocations
+            if (r > 0)
+                {
+                t_fill += double(t0) / 1e9;
+                t_cc += double(t1 - t0) / 1e9;
+                }
+            }
+
+        std::cout << "N = " << V << ", edges = " << n_edges << ", clusters = " << cc_start.size() - 1
+                  << ": add edges " << t_fill / repeat * 1e3 << " ms, connected components "
+                  << t_cc / repeat * 1e3 << " ms" << std::endl;
+        }
+
+    return 0;
+    }
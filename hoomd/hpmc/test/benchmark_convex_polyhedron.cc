@@ -0,0 +1,95 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file benchmark_convex_polyhedron.cc
+    \brief Times the support function of convex polyhedra with many vertices
+
+    Vertices are placed randomly on the unit sphere. The support function is evaluated for a slowly
+    turning direction, as in the iterations of XenoCollide, with either a scan of all vertices or
+    the hill climb on the vertex adjacency graph. Usage:
+
+        benchmark_convex_polyhedron [N]
+*/
+
+#include "hoomd/ClockSource.h"
+#include "hoomd/RandomNumbers.h"
+#include "hoomd/hpmc/ShapeConvexPolyhedron.h"
+
+#include <cstdlib>
+#include <iostream>
+
+using namespace hpmc;
+using namespace hpmc::detail;
+
+int main(int argc, char **argv)
+    {
+    unsigned int N = argc > 1 ? atoi(argv[1]) : 0;
+
+    std::vector<unsigned int> sizes;
+    if (N > 0)
+        {
+        sizes.push_back(N);
+        }
+    else
+        {
+        for (unsigned int n = 8; n <= 1024; n *= 2)
+            sizes.push_back(n);
+        }
+
+    const unsigned int n_calls = 1000000;
+    for (unsigned int s = 0; s < sizes.size(); s++)
+        {
+        hoomd::RandomGenerator rng(123, sizes[s]);
+        hoomd::SpherePointGenerator<OverlapReal> gen;
+        std::vector< vec3<OverlapReal> > vlist(sizes[s]);
+        for (unsigned int i = 0; i < sizes[s]; i++)
+            gen(rng, vlist[i]);
+
+        PolyhedronVertices verts(vlist, 0, 0);
+        // time the hill climb also below SUPPORT_HILL_CLIMB_MIN_VERTS
+        if (verts.adj_start.size() == 0)
+            verts.buildAdjacency(false);
+
+        std::vector< vec3<OverlapReal> > directions(n_calls);
+        vec3<OverlapReal> n(1,0,0);
+        for (unsigned int i = 0; i < n_calls; i++)
+            {
+            vec3<OverlapReal> dn;
+            gen(rng, dn);
+            n = (i % 20 == 0) ? dn : n + OverlapReal(0.1)*dn;
+            directions[i] = n;
+            }
+
+        SupportVertexCache cache;
+        SupportFuncConvexPolyhedron support(verts, 0, &cache);
+
+        std::vector<unsigned int> idx_scan(n_calls), idx_climb(n_calls);
+
+        ClockSource clk;
+        for (unsigned int i = 0; i < n_calls; i++)
+            idx_scan[i] = support.scan(directions[i], -FLT_MAX);
+        int64_t t0 = clk.getTime();
+        for (unsigned int i = 0; i < n_calls; i++)
+            idx_climb[i] = support.climb(directions[i]);
+        int64_t t1 = clk.getTime();
+
+        // both methods find the same support point up to ties in the dot product
+        unsigned int n_wrong = 0;
+        for (unsigned int i = 0; i < n_calls; i++)
+            {
+            const vec3<OverlapReal>& d = directions[i];
+            unsigned int a = idx_scan[i], b = idx_climb[i];
+            OverlapReal d_scan = dot(d, vec3<OverlapReal>(verts.x[a], verts.y[a], verts.z[a]));
+            OverlapReal d_climb = dot(d, vec3<OverlapReal>(verts.x[b], verts.y[b], verts.z[b]));
+            if (d_scan - d_climb > OverlapReal(1e-5)*fast::sqrt(dot(d,d)))
+                n_wrong++;
+            }
+
+        std::cout << "N = " << sizes[s] << ", edges = " << verts.adj.size() / 2
+                  << ": scan " << double(t0) / n_calls << " ns, hill climb "
+                  << double(t1 - t0) / n_calls << " ns per call, wrong support points " << n_wrong
+                  << std::endl;
+        }
+
+    return 0;
+    }
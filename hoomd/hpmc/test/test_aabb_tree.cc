@@ -106,3 +106,123 @@ UP_TEST( bigger )
         UP_ASSERT(in(i, hits));
         }
     }
+
+//! Sorted list of the particles whose AABBs overlap a query AABB
+std::vector<unsigned int> brute_force(const std::vector<AABB>& aabbs, const AABB& query)
+    {
+    std::vector<unsigned int> hits;
+    for (unsigned int i = 0; i < aabbs.size(); i++)
+        {
+        if (overlap(aabbs[i], query))
+            hits.push_back(i);
+        }
+    return hits;
+    }
+
+UP_TEST( build_methods )
+    {
+    const unsigned int N = 5000;
+    hoomd::RandomGenerator rng(2);
+
+    // include a cluster of coincident points, which all have the same Morton code
+    std::vector<AABB> aabbs(N);
+    for (unsigned int i = 0; i < N; i++)
+        {
+        vec3<Scalar> p(50, 50, 50);
+        if (i >= 100)
+            p = vec3<Scalar>(hoomd::detail::generate_canonical<float>(rng),
+                             hoomd::detail::generate_canonical<float>(rng),
+                             hoomd::detail::generate_canonical<float>(rng)) * Scalar(100);
+        aabbs[i] = AABB(p, Scalar(1.0));
+        aabbs[i].tag = 3*i;
+        }
+
+    // the builds may reorder the list of AABBs
+    std::vector<AABB> median_aabbs(aabbs), morton_aabbs(aabbs), wide_aabbs(aabbs);
+    AABBTree median, morton, wide;
+    median.buildTree(&median_aabbs[0], N, AABBTree::median);
+    morton.buildTree(&morton_aabbs[0], N, AABBTree::morton);
+    wide.setWideNodes(true);
+    wide.buildTree(&wide_aabbs[0], N);
+
+    UP_ASSERT_EQUAL(median.getNumWideNodes(), 0);
+    UP_ASSERT_EQUAL(morton.getNumWideNodes(), 0);
+    UP_ASSERT(wide.getNumWideNodes() > 0);
+
+    // every particle is in exactly one leaf, with its tag
+    std::vector<unsigned int> count(N, 0);
+    unsigned int n_leaves = 0;
+    for (unsigned int node = 0; node < morton.getNumNodes(); node++)
+        {
+        if (!morton.isNodeLeaf(node))
+            continue;
+        n_leaves++;
+        UP_ASSERT(morton.getNodeNumParticles(node) <= NODE_CAPACITY);
+        for (unsigned int j = 0; j < morton.getNodeNumParticles(node); j++)
+            {
+            unsigned int p = morton.getNodeParticle(node, j);
+            UP_ASSERT_EQUAL(morton.getNodeParticleTag(node, j), 3*p);
+            UP_ASSERT(contains(morton.getNodeAABB(node), aabbs[p]));
+            count[p]++;
+            }
+        }
+    for (unsigned int i = 0; i < N; i++)
+        UP_ASSERT_EQUAL(count[i], 1);
+
+    // the tree is binary, and the skip of the root covers all other nodes
+    UP_ASSERT_EQUAL(morton.getNumNodes(), 2*n_leaves-1);
+    UP_ASSERT_EQUAL(morton.getNodeSkip(0), morton.getNumNodes()-1);
+
+    // all trees find the same particles as a brute force search
+    for (unsigned int q = 0; q < 200; q++)
+        {
+        vec3<Scalar> p = vec3<Scalar>(hoomd::detail::generate_canonical<float>(rng),
+                                      hoomd::detail::generate_canonical<float>(rng),
+                                      hoomd::detail::generate_canonical<float>(rng)) * Scalar(100);
+        AABB query(p, Scalar(3.0));
+        if (q == 0)
+            query = AABB(vec3<Scalar>(50, 50, 50), Scalar(0.5));
+
+        // the trees return all particles in overlapping leaves
+        std::vector<unsigned int> expected = brute_force(aabbs, query);
+        auto exact = [&](const std::vector<unsigned int>& hits)
+            {
+            std::vector<unsigned int> result;
+            for (unsigned int j : hits)
+                {
+                if (overlap(aabbs[j], query))
+                    result.push_back(j);
+                }
+            std::sort(result.begin(), result.end());
+            return result;
+            };
+
+        std::vector<unsigned int> median_hits, morton_hits, wide_hits;
+        median.query(median_hits, query);
+        morton.query(morton_hits, query);
+        wide.query(wide_hits, query);
+        UP_ASSERT(exact(median_hits) == expected);
+        UP_ASSERT(exact(morton_hits) == expected);
+
+        // the wide view visits the same leaves as the binary tree
+        std::sort(morton_hits.begin(), morton_hits.end());
+        std::sort(wide_hits.begin(), wide_hits.end());
+        UP_ASSERT(wide_hits == morton_hits);
+        }
+
+    // updates are seen by the wide view
+    for (unsigned int i = 0; i < N; i++)
+        {
+        aabbs[i].translate(vec3<Scalar>(hoomd::detail::generate_canonical<float>(rng),
+                                        hoomd::detail::generate_canonical<float>(rng),
+                                        hoomd::detail::generate_canonical<float>(rng)) * Scalar(5));
+        wide.update(i, aabbs[i]);
+        }
+
+    for (unsigned int i = 0; i < N; i++)
+        {
+        std::vector<unsigned int> hits;
+        wide.query(hits, AABB(aabbs[i].getPosition(), Scalar(0.01)));
+        UP_ASSERT(in(i, hits));
+        }
+    }
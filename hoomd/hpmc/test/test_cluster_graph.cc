@@ -0,0 +1,108 @@
+
+#include "hoomd/ExecutionConfiguration.h"
+#include "hoomd/RandomNumbers.h"
+
+#include "hoomd/test/upp11_config.h"
+
+HOOMD_UP_MAIN();
+
+#include "hoomd/hpmc/UpdaterClusters.h"
+
+#include <iostream>
+#include <queue>
+
+#include <pybind11/pybind11.h>
+
+using namespace hpmc;
+using namespace hpmc::detail;
+using namespace std;
+
+//! Label the components of a random graph and compare them with a breadth first search
+void test_random_graph(unsigned int V, unsigned int n_edges, unsigned int seed)
+    {
+    hoomd::RandomGenerator rng(hoomd::RNGIdentifier::UpdaterClusters, seed, V, n_edges);
+
+    Graph G;
+    G.resize(V);
+    vector< vector<unsigned int> > adj(V);
+    vector< pair<unsigned int, unsigned int> > edges;
+    for (unsigned int e = 0; e < n_edges; e++)
+        {
+        unsigned int v = hoomd::UniformIntDistribution(V-1)(rng);
+        unsigned int w = hoomd::UniformIntDistribution(V-1)(rng);
+        edges.push_back(make_pair(v,w));
+        adj[v].push_back(w);
+        adj[w].push_back(v);
+        }
+
+    // add the edges concurrently
+    #ifdef ENABLE_TBB
+    tbb::parallel_for((unsigned int)0, n_edges, [&](unsigned int e)
+        {
+        G.addEdge(edges[e].first, edges[e].second);
+        });
+    #else
+    for (unsigned int e = 0; e < n_edges; e++)
+        G.addEdge(edges[e].first, edges[e].second);
+    #endif
+    UP_ASSERT_EQUAL(G.getNumEdges(), n_edges);
+
+    vector<unsigned int> cc_start, cc;
+    G.connectedComponents(cc_start, cc);
+
+    // reference labels in the order of the smallest vertex of each component
+    vector<int> label(V, -1);
+    unsigned int n_cc = 0;
+    for (unsigned int v = 0; v < V; v++)
+        {
+        if (label[v] != -1)
+            continue;
+        queue<unsigned int> q;
+        q.push(v);
+        label[v] = n_cc;
+        while (!q.empty())
+            {
+            unsigned int u = q.front();
+            q.pop();
+            for (unsigned int k = 0; k < adj[u].size(); k++)
+                {
+                if (label[adj[u][k]] == -1)
+                    {
+                    label[adj[u][k]] = n_cc;
+                    q.push(adj[u][k]);
+                    }
+                }
+            }
+        n_cc++;
+        }
+
+    UP_ASSERT_EQUAL(cc_start.size(), n_cc+1);
+    UP_ASSERT_EQUAL(cc_start[n_cc], V);
+    UP_ASSERT_EQUAL(cc.size(), V);
+    for (unsigned int c = 0; c < n_cc; c++)
+        {
+        UP_ASSERT(cc_start[c] < cc_start[c+1]);
+        for (unsigned int k = cc_start[c]; k < cc_start[c+1]; k++)
+            {
+            UP_ASSERT_EQUAL(label[cc[k]], (int)c);
+            if (k > cc_start[c])
+                UP_ASSERT(cc[k-1] < cc[k]);
+            }
+        }
+
+    // the graph can be reused
+    G.resize(V);
+    UP_ASSERT_EQUAL(G.getNumEdges(), 0u);
+    G.connectedComponents(cc_start, cc);
+    UP_ASSERT_EQUAL(cc_start.size(), V+1);
+    }
+
+UP_TEST( cluster_graph_test )
+    {
+    test_random_graph(1, 0, 1);
+    test_random_graph(100, 0, 2);
+    test_random_graph(1000, 300, 3);
+    test_random_graph(1000, 500, 4);
+    test_random_graph(100000, 60000, 5);
+    test_random_graph(100000, 200000, 6);
+    }
@@ -929,3 +929,61 @@ UP_TEST( overlap_two_cubes_no_rot_sphere_sweep )
     UP_ASSERT(!err_count);
     UP_ASSERT(!result);
     }
+
+UP_TEST( support_hill_climb )
+    {
+    // points on the unit sphere and in its interior
+    hoomd::RandomGenerator rng(7);
+    hoomd::SpherePointGenerator<OverlapReal> gen;
+    const unsigned int n_hull = 200;
+    vector< vec3<OverlapReal> > vlist;
+    for (unsigned int i = 0; i < n_hull + 50; i++)
+        {
+        vec3<OverlapReal> v;
+        gen(rng, v);
+        if (i >= n_hull)
+            v *= OverlapReal(0.9)*hoomd::detail::generate_canonical<OverlapReal>(rng);
+        vlist.push_back(v);
+        }
+    PolyhedronVertices verts(vlist, 0, 0);
+
+    // large polyhedra have an adjacency graph, small ones do not
+    UP_ASSERT_EQUAL(verts.adj_start.size(), verts.N+1);
+    UP_ASSERT(verts.adj.size() > 0);
+    for (unsigned int i = n_hull; i < verts.N; i++)
+        UP_ASSERT_EQUAL(verts.adj_start[i], verts.adj_start[i+1]);
+
+    vector< vec3<OverlapReal> > cube;
+    for (int x = -1; x <= 1; x += 2)
+        for (int y = -1; y <= 1; y += 2)
+            for (int z = -1; z <= 1; z += 2)
+                cube.push_back(vec3<OverlapReal>(0.5*x, 0.5*y, 0.5*z));
+    PolyhedronVertices cube_verts(cube, 0, 0);
+    UP_ASSERT_EQUAL(cube_verts.adj_start.size(), 0u);
+
+    // the climb from the cached vertices finds the same support point as scanning all vertices
+    SupportVertexCache cache;
+    SupportFuncConvexPolyhedron sa(verts, 0, &cache);
+    vec3<OverlapReal> n(1,0,0);
+    for (unsigned int i = 0; i < 1000; i++)
+        {
+        // walk the direction slowly as in a XenoCollide iteration, with occasional jumps
+        vec3<OverlapReal> dn;
+        gen(rng, dn);
+        n = (i % 50 == 0) ? dn : n + OverlapReal(0.1)*dn;
+
+        unsigned int idx = sa.scan(n, -FLT_MAX);
+        OverlapReal max_dot = dot(n, vec3<OverlapReal>(verts.x[idx], verts.y[idx], verts.z[idx]));
+        MY_CHECK_CLOSE(dot(n, sa(n)), max_dot, tol_small);
+        }
+
+    // overlap tests of shapes with large polyhedra agree with the bounding spheres
+    quat<Scalar> o;
+    ShapeConvexPolyhedron a(o, verts);
+    ShapeConvexPolyhedron b(quat<Scalar>::fromAxisAngle(vec3<Scalar>(0,0,1), 0.3), verts);
+    UP_ASSERT(test_overlap(vec3<Scalar>(1.6,0,0), a, b, err_count));
+    UP_ASSERT(!test_overlap(vec3<Scalar>(2.1,0,0), a, b, err_count));
+    UP_ASSERT(test_overlap(vec3<Scalar>(0,-1.6,0.1), a, b, err_count));
+    UP_ASSERT(!test_overlap(vec3<Scalar>(0,-2.1,0.1), a, b, err_count));
+    UP_ASSERT(!err_count);
+    }
@@ -0,0 +1,280 @@
+
+#include "hoomd/ExecutionConfiguration.h"
+#include "hoomd/BoxDim.h"
+#include "hoomd/HOOMDMath.h"
+
+#include "hoomd/test/upp11_config.h"
+
+HOOMD_UP_MAIN();
+
+#include "hoomd/hpmc/IntegratorHPMCMonoNEC.h"
+#include "hoomd/hpmc/ShapeSphere.h"
+#include "hoomd/hpmc/ShapeConvexPolygon.h"
+
+#include <iostream>
+
+#include <pybind11/pybind11.h>
+#include <memory>
+
+using namespace hpmc;
+using namespace hpmc::detail;
+using namespace std;
+
+unsigned int err_count = 0;
+
+UP_TEST( sweep_sphere )
+    {
+    SphereParams par;
+    par.radius = 0.5;
+    par.ignore = 0;
+    par.isOriented = false;
+    ShapeSphere a(quat<Scalar>(), par);
+    ShapeSphere b(quat<Scalar>(), par);
+
+    // head on
+    vec3<Scalar> d(1,0,0);
+    MY_CHECK_CLOSE(sweep_distance(vec3<Scalar>(3,0,0), d, a, b, OverlapReal(10), err_count), 2.0, tol);
+
+    // off center, the spheres touch when the x distance is sqrt(1 - 0.6^2)
+    MY_CHECK_CLOSE(sweep_distance(vec3<Scalar>(3,0.6,0), d, a, b, OverlapReal(10), err_count), 2.2, tol);
+
+    // out of reach, passing by and behind
+    UP_ASSERT_EQUAL(sweep_distance(vec3<Scalar>(3,0,0), d, a, b, OverlapReal(1.5), err_count), OverlapReal(1.5));
+    UP_ASSERT_EQUAL(sweep_distance(vec3<Scalar>(3,1.1,0), d, a, b, OverlapReal(10), err_count), OverlapReal(10));
+    UP_ASSERT_EQUAL(sweep_distance(vec3<Scalar>(-3,0,0), d, a, b, OverlapReal(10), err_count), OverlapReal(10));
+    }
+
+UP_TEST( sweep_convex_polygon )
+    {
+    PolygonVertices verts;
+    verts.N = 4;
+    verts.ignore = 0;
+    verts.sweep_radius = 0;
+    verts.x[0] = -0.5; verts.y[0] = -0.5;
+    verts.x[1] = 0.5; verts.y[1] = -0.5;
+    verts.x[2] = 0.5; verts.y[2] = 0.5;
+    verts.x[3] = -0.5; verts.y[3] = 0.5;
+    verts.diameter = 2*sqrt(0.5);
+
+    ShapeConvexPolygon a(quat<Scalar>(), verts);
+    ShapeConvexPolygon b(quat<Scalar>(), verts);
+    vec3<Scalar> d(1,0,0);
+
+    // aligned squares touch face to face
+    MY_CHECK_CLOSE(sweep_distance(vec3<Scalar>(3,0.3,0), d, a, b, OverlapReal(10), err_count), 2.0, tol);
+
+    // a square rotated by 45 degrees hits with its corner
+    ShapeConvexPolygon b_rot(quat<Scalar>::fromAxisAngle(vec3<Scalar>(0,0,1), M_PI/4), verts);
+    MY_CHECK_CLOSE(sweep_distance(vec3<Scalar>(3,0,0), d, a, b_rot, OverlapReal(10), err_count), 3.0 - 0.5 - sqrt(0.5), tol);
+
+    // the corner of the rotated square hits the face of the other
+    MY_CHECK_CLOSE(sweep_distance(vec3<Scalar>(3,0,0), d, b_rot, a, OverlapReal(10), err_count), 3.0 - 0.5 - sqrt(0.5), tol);
+
+    // the squares pass by each other
+    UP_ASSERT_EQUAL(sweep_distance(vec3<Scalar>(3,1.01,0), d, a, b, OverlapReal(10), err_count), OverlapReal(10));
+
+    // the result agrees with the overlap test
+    vec3<Scalar> d_diag(sqrt(0.5), sqrt(0.5), 0);
+    vec3<Scalar> r_ab(2.5, 1.7, 0);
+    OverlapReal s = sweep_distance(r_ab, d_diag, a, b_rot, OverlapReal(10), err_count);
+    UP_ASSERT(s < OverlapReal(10));
+    UP_ASSERT(!test_overlap(r_ab - Scalar(s - 1e-3)*d_diag, a, b_rot, err_count));
+    UP_ASSERT(test_overlap(r_ab - Scalar(s + 1e-3)*d_diag, a, b_rot, err_count));
+    }
+
+//! Build a rectangle centered on the origin with the given side lengths along x and y
+PolygonVertices make_rectangle(OverlapReal lx, OverlapReal ly)
+    {
+    PolygonVertices verts;
+    verts.N = 4;
+    verts.ignore = 0;
+    verts.sweep_radius = 0;
+    verts.x[0] = -lx/2; verts.y[0] = -ly/2;
+    verts.x[1] = lx/2; verts.y[1] = -ly/2;
+    verts.x[2] = lx/2; verts.y[2] = ly/2;
+    verts.x[3] = -lx/2; verts.y[3] = ly/2;
+    verts.diameter = sqrt(lx*lx + ly*ly);
+    return verts;
+    }
+
+UP_TEST( sweep_convex_polygon_behind )
+    {
+    // a vertical rod of length 4 moves along x
+    PolygonVertices rod_a = make_rectangle(0.02, 4.0);
+    ShapeConvexPolygon a(quat<Scalar>(), rod_a);
+    vec3<Scalar> d(1,0,0);
+
+    // a tilted rod from (-2.5,4.1) to (0.5,1.9) has its center behind a, but its lower end is in the path of a's
+    // upper end
+    Scalar L = sqrt(3.0*3.0 + 2.2*2.2);
+    PolygonVertices rod_b = make_rectangle(L, 0.02);
+    ShapeConvexPolygon b(quat<Scalar>::fromAxisAngle(vec3<Scalar>(0,0,1), atan2(-2.2, 3.0)), rod_b);
+    vec3<Scalar> r_ab(-1.0, 3.0, 0);
+
+    OverlapReal s = sweep_distance(r_ab, d, a, b, OverlapReal(10), err_count);
+    UP_ASSERT(s > OverlapReal(0.3) && s < OverlapReal(0.4));
+    UP_ASSERT(!test_overlap(r_ab - Scalar(s - 1e-3)*d, a, b, err_count));
+    UP_ASSERT(test_overlap(r_ab - Scalar(s + 1e-3)*d, a, b, err_count));
+
+    // the same holds with the roles of the rods swapped and the direction reversed
+    OverlapReal s_rev = sweep_distance(-r_ab, -d, b, a, OverlapReal(10), err_count);
+    MY_CHECK_CLOSE(s_rev, s, tol);
+
+    // a rod behind a and out of its path is never hit
+    UP_ASSERT_EQUAL(sweep_distance(vec3<Scalar>(-1.0, 4.5, 0), d, a, b, OverlapReal(10), err_count),
+                    OverlapReal(10));
+
+    // rotated rods with centers behind the mover agree with the overlap test
+    for (unsigned int k = 0; k < 16; k++)
+        {
+        Scalar phi = M_PI*k/16.0;
+        ShapeConvexPolygon c(quat<Scalar>::fromAxisAngle(vec3<Scalar>(0,0,1), phi), rod_b);
+        vec3<Scalar> r_ac(-0.5, 1.5 + 0.1*k, 0);
+        if (test_overlap(r_ac, a, c, err_count))
+            continue;
+
+        OverlapReal t = sweep_distance(r_ac, d, a, c, OverlapReal(10), err_count);
+        if (t < OverlapReal(10))
+            {
+            UP_ASSERT(!test_overlap(r_ac - Scalar(t - 1e-3)*d, a, c, err_count));
+            UP_ASSERT(test_overlap(r_ac - Scalar(t + 1e-3)*d, a, c, err_count));
+            }
+        else
+            {
+            // no contact anywhere along the path
+            for (Scalar x = 0; x < 10; x += 0.005)
+                UP_ASSERT(!test_overlap(r_ac - x*d, a, c, err_count));
+            }
+        }
+    }
+
+//! Compare the generic sweep distance to the exact one of a pair of shapes
+template<class Shape>
+void check_sweep_bisect(const vec3<Scalar>& r_ab, const vec3<Scalar>& d, const Shape& a, const Shape& b,
+                        OverlapReal max_distance)
+    {
+    OverlapReal s_exact = sweep_distance(r_ab, d, a, b, max_distance, err_count);
+    OverlapReal s_bisect = sweep_distance_bisect(r_ab, d, a, b, max_distance, err_count);
+    if (s_exact == max_distance)
+        {
+        UP_ASSERT_EQUAL(s_bisect, max_distance);
+        }
+    else
+        {
+        // the bisection approaches the contact from the disjoint side
+        MY_CHECK_SMALL(s_bisect - s_exact, tol_small);
+        UP_ASSERT(!test_overlap(r_ab - Scalar(s_bisect)*d, a, b, err_count));
+        }
+    }
+
+UP_TEST( sweep_bisect_sphere )
+    {
+    SphereParams par_a, par_b;
+    par_a.ignore = par_b.ignore = 0;
+    par_a.isOriented = par_b.isOriented = false;
+    par_a.radius = 0.5;
+    par_b.radius = 0.3;
+    ShapeSphere a(quat<Scalar>(), par_a);
+    ShapeSphere b(quat<Scalar>(), par_b);
+
+    // head on, off center, out of reach, passing by and behind
+    vec3<Scalar> d(1,0,0);
+    check_sweep_bisect(vec3<Scalar>(3,0,0), d, a, b, OverlapReal(10));
+    check_sweep_bisect(vec3<Scalar>(3,0.6,0), d, a, b, OverlapReal(10));
+    check_sweep_bisect(vec3<Scalar>(3,0,0), d, a, b, OverlapReal(1.5));
+    check_sweep_bisect(vec3<Scalar>(3,0.81,0), d, a, b, OverlapReal(10));
+    check_sweep_bisect(vec3<Scalar>(-3,0,0), d, a, b, OverlapReal(10));
+
+    // random directions and separations
+    srand(12345);
+    for (unsigned int k = 0; k < 200; k++)
+        {
+        vec3<Scalar> r_ab(6*Scalar(rand())/RAND_MAX - 3, 6*Scalar(rand())/RAND_MAX - 3,
+                          6*Scalar(rand())/RAND_MAX - 3);
+        if (test_overlap(r_ab, a, b, err_count))
+            continue;
+        Scalar phi = 2*M_PI*Scalar(rand())/RAND_MAX;
+        Scalar cos_theta = 2*Scalar(rand())/RAND_MAX - 1;
+        Scalar sin_theta = sqrt(1 - cos_theta*cos_theta);
+        vec3<Scalar> dir(sin_theta*cos(phi), sin_theta*sin(phi), cos_theta);
+        check_sweep_bisect(r_ab, dir, a, b, OverlapReal(4));
+        }
+    }
+
+UP_TEST( sweep_bisect_convex_polygon )
+    {
+    PolygonVertices square = make_rectangle(1.0, 1.0);
+    PolygonVertices rod = make_rectangle(3.0, 0.2);
+
+    // aligned squares face to face, and a rotated square hitting with its corner
+    ShapeConvexPolygon a(quat<Scalar>(), square);
+    ShapeConvexPolygon b_rot(quat<Scalar>::fromAxisAngle(vec3<Scalar>(0,0,1), M_PI/4), square);
+    vec3<Scalar> d(1,0,0);
+    check_sweep_bisect(vec3<Scalar>(3,0.3,0), d, a, a, OverlapReal(10));
+    check_sweep_bisect(vec3<Scalar>(3,0,0), d, a, b_rot, OverlapReal(10));
+    check_sweep_bisect(vec3<Scalar>(3,0,0), d, b_rot, a, OverlapReal(10));
+    check_sweep_bisect(vec3<Scalar>(3,1.01,0), d, a, a, OverlapReal(10));
+
+    // random orientations, directions and separations of a square and a rod
+    srand(12345);
+    for (unsigned int k = 0; k < 200; k++)
+        {
+        ShapeConvexPolygon s(quat<Scalar>::fromAxisAngle(vec3<Scalar>(0,0,1), 2*M_PI*Scalar(rand())/RAND_MAX),
+                             square);
+        ShapeConvexPolygon r(quat<Scalar>::fromAxisAngle(vec3<Scalar>(0,0,1), 2*M_PI*Scalar(rand())/RAND_MAX), rod);
+        vec3<Scalar> r_ab(8*Scalar(rand())/RAND_MAX - 4, 8*Scalar(rand())/RAND_MAX - 4, 0);
+        if (test_overlap(r_ab, s, r, err_count))
+            continue;
+        Scalar phi = 2*M_PI*Scalar(rand())/RAND_MAX;
+        vec3<Scalar> dir(cos(phi), sin(phi), 0);
+        check_sweep_bisect(r_ab, dir, s, r, OverlapReal(6));
+        check_sweep_bisect(-r_ab, dir, r, s, OverlapReal(6));
+        }
+    }
+
+//! Run hard disks with event chains and check the resulting configuration
+UP_TEST( event_chain_disks )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+
+    const unsigned int n = 16;
+    const Scalar a = 1.1;
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(n*n, BoxDim(n*a, n*a, 1.0), 1, 0, 0, 0, 0, exec_conf));
+    sysdef->setNDimensions(2);
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+        {
+        ArrayHandle<Scalar4> h_postype(pdata->getPositions(), access_location::host, access_mode::readwrite);
+        for (unsigned int i = 0; i < n*n; i++)
+            {
+            Scalar3 pos = make_scalar3((Scalar(i % n) - n/2)*a, (Scalar(i / n) - n/2)*a, 0);
+            h_postype.data[i] = make_scalar4(pos.x, pos.y, pos.z, __int_as_scalar(0));
+            }
+        }
+
+    std::shared_ptr< IntegratorHPMCMonoNEC<ShapeSphere> > mc(new IntegratorHPMCMonoNEC<ShapeSphere>(sysdef, 123));
+    SphereParams params;
+    params.radius = 0.5;
+    params.ignore = false;
+    params.isOriented = false;
+    mc->setParam(0, params);
+    mc->setD("A", 1.0);
+    mc->setChainLength(5.0);
+
+    mc->prepRun(0);
+    mc->resetStats();
+    for (unsigned int timestep = 0; timestep < 20; timestep++)
+        mc->update(timestep);
+
+    // the chains generate valid configurations
+    UP_ASSERT_EQUAL(mc->countOverlaps(false), 0u);
+
+    // the collisions raise the pressure above the ideal gas pressure
+    Scalar rho = Scalar(n*n) / (n*a*n*a);
+    UP_ASSERT(mc->getPressure() > rho);
+
+    // every chain is made of at least one segment
+    hpmc_counters_t counters = mc->getCounters(0);
+    UP_ASSERT(counters.translate_accept_count >= 20*n*n);
+    UP_ASSERT(counters.translate_reject_count == 0);
+    }
@@ -12,6 +12,7 @@ HOOMD_UP_MAIN();
 
 #include "hoomd/hpmc/Moves.h"
 #include "hoomd/hpmc/IntegratorHPMCMono.h"
+#include "hoomd/hpmc/ShapeSphere.h"
 
 #include <iostream>
 
@@ -175,3 +176,150 @@ UP_TEST( update_order_test )
         test_update_order(max);
         }
     }
+
+//! Check the checkerboard decomposition of a box
+void test_checkerboard_cells(const BoxDim& box, unsigned int ndim)
+    {
+    const unsigned int N = 1000;
+    const Scalar width = 1.1;
+
+    // random positions, some of them outside of the box
+    hoomd::RandomGenerator rng(hoomd::RNGIdentifier::HPMCMonoCheckerboard, 1, 2, 3);
+    hoomd::UniformDistribution<Scalar> uniform(-0.05, 1.05);
+    std::vector<Scalar4> postype(N);
+    for (unsigned int i = 0; i < N; i++)
+        {
+        Scalar3 f = make_scalar3(uniform(rng), uniform(rng), ndim == 3 ? uniform(rng) : Scalar(0.5));
+        Scalar3 pos = box.makeCoordinates(f);
+        postype[i] = make_scalar4(pos.x, pos.y, pos.z, __int_as_scalar(0));
+        }
+
+    CheckerboardCells cells;
+    cells.setBox(box, width, ndim, N);
+    cells.shift(rng);
+
+    UpdateOrder order(10, N);
+    order.shuffle(3);
+    cells.bin(&postype[0], N, order);
+
+    // the colors are visited once each
+    std::vector<unsigned int> visited(CheckerboardCells::n_colors, 0);
+    for (unsigned int phase = 0; phase < CheckerboardCells::n_colors; phase++)
+        visited[cells.getColorOrder(phase)]++;
+    for (unsigned int color = 0; color < CheckerboardCells::n_colors; color++)
+        UP_ASSERT_EQUAL(visited[color], 1u);
+
+    // every particle is listed once, in its cell, in the update order
+    std::vector<unsigned int> listed(N, 0);
+    unsigned int n_listed = 0;
+    for (unsigned int color = 0; color < CheckerboardCells::n_colors; color++)
+        {
+        const std::vector<unsigned int>& color_cells = cells.getColorCells(color);
+        for (unsigned int k = 0; k < color_cells.size(); k++)
+            {
+            unsigned int cell = color_cells[k];
+            UP_ASSERT_EQUAL(cells.getColor(cell), color);
+            for (unsigned int p = cells.getCellStart(cell); p < cells.getCellEnd(cell); p++)
+                {
+                unsigned int i = cells.getParticles()[p];
+                UP_ASSERT_EQUAL(cells.getParticleCell(i), cell);
+                UP_ASSERT_EQUAL(cells.getCell(vec3<Scalar>(postype[i])), cell);
+                if (p > cells.getCellStart(cell))
+                    UP_ASSERT(order[0] == 0 ? cells.getParticles()[p-1] < i : cells.getParticles()[p-1] > i);
+                listed[i]++;
+                n_listed++;
+                }
+            }
+        }
+    UP_ASSERT_EQUAL(n_listed, N);
+    for (unsigned int i = 0; i < N; i++)
+        UP_ASSERT_EQUAL(listed[i], 1u);
+
+    // particles in different cells of the same color are further apart than the cell width
+    for (unsigned int i = 0; i < N; i++)
+        {
+        unsigned int cell_i = cells.getParticleCell(i);
+        for (unsigned int j = i+1; j < N; j++)
+            {
+            unsigned int cell_j = cells.getParticleCell(j);
+            if (cell_i != cell_j && cells.getColor(cell_i) == cells.getColor(cell_j))
+                {
+                Scalar3 dr = box.minImage(make_scalar3(postype[j].x - postype[i].x,
+                                                       postype[j].y - postype[i].y,
+                                                       postype[j].z - postype[i].z));
+                UP_ASSERT(dot(dr,dr) >= width*width);
+                }
+            }
+        }
+    }
+
+UP_TEST( checkerboard_cells_test )
+    {
+    test_checkerboard_cells(BoxDim(10.0, 9.0, 7.5), 3);
+    test_checkerboard_cells(BoxDim(9.0, 0.3, -0.2, 0.4), 3);
+    test_checkerboard_cells(BoxDim(12.0, 2.5, 1.0), 3);
+    test_checkerboard_cells(BoxDim(12.0, 0.5, 0.0, 0.0), 2);
+    }
+
+//! Run hard spheres on a simple cubic lattice with or without checkerboard sweeps
+std::shared_ptr< IntegratorHPMCMono<ShapeSphere> > run_spheres(std::shared_ptr<ExecutionConfiguration> exec_conf,
+                                                                bool checkerboard)
+    {
+    const unsigned int n = 8;
+    const Scalar a = 1.05;
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(n*n*n, BoxDim(n*a), 1, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+        {
+        ArrayHandle<Scalar4> h_postype(pdata->getPositions(), access_location::host, access_mode::readwrite);
+        for (unsigned int i = 0; i < n*n*n; i++)
+            {
+            Scalar3 pos = make_scalar3(Scalar(i % n) - n/2, Scalar((i / n) % n) - n/2, Scalar(i / (n*n)) - n/2);
+            pos.x *= a;
+            pos.y *= a;
+            pos.z *= a;
+            h_postype.data[i] = make_scalar4(pos.x, pos.y, pos.z, __int_as_scalar(0));
+            }
+        }
+
+    std::shared_ptr< IntegratorHPMCMono<ShapeSphere> > mc(new IntegratorHPMCMono<ShapeSphere>(sysdef, 123));
+    SphereParams params;
+    params.radius = 0.5;
+    params.ignore = false;
+    params.isOriented = false;
+    mc->setParam(0, params);
+    mc->setD("A", 0.1);
+    mc->setCheckerboard(checkerboard);
+
+    mc->prepRun(0);
+    for (unsigned int timestep = 0; timestep < 20; timestep++)
+        mc->update(timestep);
+
+    return mc;
+    }
+
+UP_TEST( checkerboard_sweep_test )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    #ifdef ENABLE_TBB
+    exec_conf->setNumThreads(4);
+    #endif
+
+    std::shared_ptr< IntegratorHPMCMono<ShapeSphere> > mc_serial = run_spheres(exec_conf, false);
+    std::shared_ptr< IntegratorHPMCMono<ShapeSphere> > mc = run_spheres(exec_conf, true);
+
+    // the checkerboard sweep generates valid configurations
+    UP_ASSERT_EQUAL(mc->countOverlaps(false), 0u);
+
+    // all trial moves are counted
+    hpmc_counters_t counters = mc->getCounters(0);
+    hpmc_counters_t counters_serial = mc_serial->getCounters(0);
+    UP_ASSERT_EQUAL(counters.getNMoves(), counters_serial.getNMoves());
+
+    // moves out of the cells lower the acceptance, but only slightly
+    double accept = double(counters.translate_accept_count) / double(counters.getNMoves());
+    double accept_serial = double(counters_serial.translate_accept_count) / double(counters_serial.getNMoves());
+    UP_ASSERT(accept > 0.1);
+    UP_ASSERT(accept < accept_serial);
+    UP_ASSERT(accept > 0.7*accept_serial);
+    }
@@ -115,6 +115,45 @@ class EvaluatorPairForceShiftedLJ
             }
 
         #ifndef __HIPCC__
+        //! Evaluate the force and energy for a batch of pairs
+        /*! \sa EvaluatorPairLJ::evalForceAndEnergyBatch()
+        */
+        static void evalForceAndEnergyBatch(unsigned int n,
+                                            const Scalar *rsq,
+                                            const Scalar *rcutsq,
+                                            const param_type *params,
+                                            Scalar *force_divr,
+                                            Scalar *pair_eng,
+                                            bool energy_shift)
+            {
+            for (unsigned int k = 0; k < n; k++)
+                {
+                const Scalar lj1 = params[k].lj1;
+                const Scalar lj2 = params[k].lj2;
+                const bool evaluated = rsq[k] < rcutsq[k] && lj1 != 0;
+
+                Scalar r2inv = Scalar(1.0)/rsq[k];
+                Scalar r6inv = r2inv * r2inv * r2inv;
+                Scalar f = r2inv * r6inv * (Scalar(12.0)*lj1*r6inv - Scalar(6.0)*lj2);
+                Scalar e = r6inv * (lj1*r6inv - lj2);
+
+                Scalar rcut2inv = Scalar(1.0)/rcutsq[k];
+                Scalar rcut6inv = rcut2inv * rcut2inv * rcut2inv;
+
+                if (energy_shift)
+                    e -= rcut6inv * (lj1*rcut6inv - lj2);
+
+                // shift force and add linear term to potential
+                Scalar rcut_r_inv = fast::rsqrt(rsq[k]*rcutsq[k]);
+                Scalar force_rcut_at_rcut = rcut6inv * (Scalar(12.0)*lj1*rcut6inv - Scalar(6.0)*lj2);
+                f -= rcut_r_inv * force_rcut_at_rcut;
+                e += (rsq[k]*rcut_r_inv-Scalar(1.0))*force_rcut_at_rcut;
+
+                force_divr[k] = evaluated ? f : Scalar(0.0);
+                pair_eng[k] = evaluated ? e : Scalar(0.0);
+                }
+            }
+
         //! Get the name of this potential
         /*! \returns The potential name. Must be short and all lowercase, as this is the name energies will be logged as
             via analyze.log.
@@ -151,6 +151,38 @@ class EvaluatorPairGauss
             }
 
         #ifndef __HIPCC__
+        //! Evaluate the force and energy for a batch of pairs
+        /*! \sa EvaluatorPairLJ::evalForceAndEnergyBatch()
+        */
+        static void evalForceAndEnergyBatch(unsigned int n,
+                                            const Scalar *rsq,
+                                            const Scalar *rcutsq,
+                                            const param_type *params,
+                                            Scalar *force_divr,
+                                            Scalar *pair_eng,
+                                            bool energy_shift)
+            {
+            for (unsigned int k = 0; k < n; k++)
+                {
+                const Scalar epsilon = params[k].epsilon;
+                const Scalar sigma = params[k].sigma;
+                const bool evaluated = rsq[k] < rcutsq[k];
+
+                Scalar sigma_sq = sigma*sigma;
+                Scalar r_over_sigma_sq = rsq[k] / sigma_sq;
+                Scalar exp_val = fast::exp(-Scalar(1.0)/Scalar(2.0) * r_over_sigma_sq);
+
+                Scalar f = epsilon / sigma_sq * exp_val;
+                Scalar e = epsilon * exp_val;
+
+                if (energy_shift)
+                    e -= epsilon * fast::exp(-Scalar(1.0)/Scalar(2.0) * rcutsq[k] / sigma_sq);
+
+                force_divr[k] = evaluated ? f : Scalar(0.0);
+                pair_eng[k] = evaluated ? e : Scalar(0.0);
+                }
+            }
+
         //! Get the name of this potential
         /*! \returns The potential name. Must be short and all lowercase, as this is the name energies will be logged as
             via analyze.log.
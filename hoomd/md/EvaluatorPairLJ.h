@@ -69,6 +69,11 @@
     \f$ -\frac{1}{r}\frac{\partial V}{\partial r}\f$ and \a pair_eng must be set to the value \f$ V(r) \f$ if \a energy_shift is false or
     \f$ V(r) - V(r_{\mathrm{cut}}) \f$ if \a energy_shift is true.
 
+    Evaluators that need neither diameter nor charge may optionally provide a static host-side method
+    evalForceAndEnergyBatch(). PotentialPair then gathers the neighbors of a particle in blocks and evaluates each block
+    with a single call, which allows the compiler to vectorize the evaluation across pairs. The batched method must
+    compute the same function as evalForceAndEnergy(), and zero force and energy for pairs that are not evaluated.
+
     A pair potential evaluator class is also used on the GPU. So all of its members must be declared with the
     DEVICE keyword before them to mark them __device__ when compiling in nvcc and blank otherwise. If any other code
     needs to diverge between the host and device (i.e., to use a special math function like __powf on the device), it
@@ -207,6 +212,50 @@ class EvaluatorPairLJ
             }
 
         #ifndef __HIPCC__
+        //! Evaluate the force and energy for a batch of pairs
+        /*! \param n Number of pairs in the batch
+            \param rsq Squared distances of the pairs
+            \param rcutsq Squared cutoff radii of the pairs
+            \param params Per type pair parameters of the pairs
+            \param force_divr Output array for the forces divided by r
+            \param pair_eng Output array for the pair energies
+            \param energy_shift If true, the potential must be shifted so that V(r) is continuous at the cutoff
+
+            This is the host-side, branch free counterpart of evalForceAndEnergy() that PotentialPair uses to
+            evaluate several neighbors at once. Pairs that are not evaluated get a zero force and energy. The loop
+            body is written without data dependent branches so that the compiler can vectorize it.
+        */
+        static void evalForceAndEnergyBatch(unsigned int n,
+                                            const Scalar *rsq,
+                                            const Scalar *rcutsq,
+                                            const param_type *params,
+                                            Scalar *force_divr,
+                                            Scalar *pair_eng,
+                                            bool energy_shift)
+            {
+            for (unsigned int k = 0; k < n; k++)
+                {
+                const Scalar lj1 = params[k].lj1;
+                const Scalar lj2 = params[k].lj2;
+                const bool evaluated = rsq[k] < rcutsq[k] && lj1 != 0;
+
+                Scalar r2inv = Scalar(1.0)/rsq[k];
+                Scalar r6inv = r2inv * r2inv * r2inv;
+                Scalar f = r2inv * r6inv * (Scalar(12.0)*lj1*r6inv - Scalar(6.0)*lj2);
+                Scalar e = r6inv * (lj1*r6inv - lj2);
+
+                if (energy_shift)
+                    {
+                    Scalar rcut2inv = Scalar(1.0)/rcutsq[k];
+                    Scalar rcut6inv = rcut2inv * rcut2inv * rcut2inv;
+                    e -= rcut6inv * (lj1*rcut6inv - lj2);
+                    }
+
+                force_divr[k] = evaluated ? f : Scalar(0.0);
+                pair_eng[k] = evaluated ? e : Scalar(0.0);
+                }
+            }
+
         //! Get the name of this potential
         /*! \returns The potential name. Must be short and all lowercase, as this is the name energies will be logged as
             via analyze.log.
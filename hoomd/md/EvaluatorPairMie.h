@@ -160,6 +160,44 @@ class EvaluatorPairMie
             }
 
         #ifndef __HIPCC__
+        //! Evaluate the force and energy for a batch of pairs
+        /*! \sa EvaluatorPairLJ::evalForceAndEnergyBatch()
+        */
+        static void evalForceAndEnergyBatch(unsigned int n,
+                                            const Scalar *rsq,
+                                            const Scalar *rcutsq,
+                                            const param_type *params,
+                                            Scalar *force_divr,
+                                            Scalar *pair_eng,
+                                            bool energy_shift)
+            {
+            for (unsigned int k = 0; k < n; k++)
+                {
+                const Scalar mie1 = params[k].m1;
+                const Scalar mie2 = params[k].m2;
+                const Scalar mie3 = params[k].m3;
+                const Scalar mie4 = params[k].m4;
+                const bool evaluated = rsq[k] < rcutsq[k] && mie1 != 0;
+
+                Scalar r2inv = Scalar(1.0)/rsq[k];
+                Scalar rninv = pow(r2inv,mie3/Scalar(2.0));
+                Scalar rminv = pow(r2inv,mie4/Scalar(2.0));
+                Scalar f = r2inv * (mie3 * mie1 * rninv - mie4 * mie2 * rminv);
+
+                Scalar e = mie1 * rninv - mie2 * rminv;
+
+                if (energy_shift)
+                    {
+                    Scalar rcutninv = Scalar(1.0)/pow(rcutsq[k],mie3/Scalar(2.0));
+                    Scalar rcutminv = Scalar(1.0)/pow(rcutsq[k],mie4/Scalar(2.0));
+                    e -= mie1 * rcutninv - mie2* rcutminv;
+                    }
+
+                force_divr[k] = evaluated ? f : Scalar(0.0);
+                pair_eng[k] = evaluated ? e : Scalar(0.0);
+                }
+            }
+
         //! Get the name of this potential
         /*! \returns The potential name. Must be short and all lowercase, as this is the name energies will be logged as
             via analyze.log.
@@ -144,6 +144,42 @@ class EvaluatorPairMorse
             }
 
         #ifndef __HIPCC__
+        //! Evaluate the force and energy for a batch of pairs
+        /*! \sa EvaluatorPairLJ::evalForceAndEnergyBatch()
+        */
+        static void evalForceAndEnergyBatch(unsigned int n,
+                                            const Scalar *rsq,
+                                            const Scalar *rcutsq,
+                                            const param_type *params,
+                                            Scalar *force_divr,
+                                            Scalar *pair_eng,
+                                            bool energy_shift)
+            {
+            for (unsigned int k = 0; k < n; k++)
+                {
+                const Scalar D0 = params[k].D0;
+                const Scalar alpha = params[k].alpha;
+                const Scalar r0 = params[k].r0;
+                const bool evaluated = rsq[k] < rcutsq[k];
+
+                Scalar r = fast::sqrt(rsq[k]);
+                Scalar Exp_factor = fast::exp(-alpha*(r-r0));
+
+                Scalar e = D0 * Exp_factor * (Exp_factor - Scalar(2.0));
+                Scalar f = Scalar(2.0) * D0 * alpha * Exp_factor * (Exp_factor - Scalar(1.0)) / r;
+
+                if (energy_shift)
+                    {
+                    Scalar rcut = fast::sqrt(rcutsq[k]);
+                    Scalar Exp_factor_cut = fast::exp(-alpha*(rcut-r0));
+                    e -= D0 * Exp_factor_cut * (Exp_factor_cut - Scalar(2.0));
+                    }
+
+                force_divr[k] = evaluated ? f : Scalar(0.0);
+                pair_eng[k] = evaluated ? e : Scalar(0.0);
+                }
+            }
+
         //! Get the name of this potential
         /*! \returns The potential name. Must be short and all lowercase, as this is the name energies will be logged as
             via analyze.log.
@@ -154,6 +154,44 @@ class EvaluatorPairYukawa
             }
 
         #ifndef __HIPCC__
+        //! Evaluate the force and energy for a batch of pairs
+        /*! \sa EvaluatorPairLJ::evalForceAndEnergyBatch()
+        */
+        static void evalForceAndEnergyBatch(unsigned int n,
+                                            const Scalar *rsq,
+                                            const Scalar *rcutsq,
+                                            const param_type *params,
+                                            Scalar *force_divr,
+                                            Scalar *pair_eng,
+                                            bool energy_shift)
+            {
+            for (unsigned int k = 0; k < n; k++)
+                {
+                const Scalar epsilon = params[k].epsilon;
+                const Scalar kappa = params[k].kappa;
+                const bool evaluated = rsq[k] < rcutsq[k] && epsilon != 0;
+
+                Scalar rinv = fast::rsqrt(rsq[k]);
+                Scalar r = Scalar(1.0) / rinv;
+                Scalar r2inv = Scalar(1.0) / rsq[k];
+
+                Scalar exp_val = fast::exp(-kappa * r);
+
+                Scalar f = epsilon * exp_val * r2inv * (rinv + kappa);
+                Scalar e = epsilon * exp_val * rinv;
+
+                if (energy_shift)
+                    {
+                    Scalar rcutinv = fast::rsqrt(rcutsq[k]);
+                    Scalar rcut = Scalar(1.0) / rcutinv;
+                    e -= epsilon * fast::exp(-kappa * rcut) * rcutinv;
+                    }
+
+                force_divr[k] = evaluated ? f : Scalar(0.0);
+                pair_eng[k] = evaluated ? e : Scalar(0.0);
+                }
+            }
+
         //! Get the name of this potential
         /*! \returns The potential name. Must be short and all lowercase, as this is the name energies will be logged as
             via analyze.log.
@@ -7,6 +7,15 @@
 #include "ForceDistanceConstraint.h"
 
 #include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <unordered_map>
+
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
+
 using namespace Eigen;
 namespace py = pybind11;
 
@@ -21,7 +30,7 @@ ForceDistanceConstraint::ForceDistanceConstraint(std::shared_ptr<SystemDefinitio
           m_cmatrix(m_exec_conf), m_cvec(m_exec_conf), m_lagrange(m_exec_conf),
           m_rel_tol(1e-3), m_constraint_violated(m_exec_conf), m_condition(m_exec_conf),
           m_sparse_idxlookup(m_exec_conf), m_constraint_reorder(true), m_constraints_added_removed(true),
-          m_d_max(0.0)
+          m_d_max(0.0), m_block_solver(true), m_blocks_dirty(true)
     {
     m_constraint_violated.resetFlags(0);
 
@@ -96,17 +105,29 @@ void ForceDistanceConstraint::computeForces(unsigned int timestep)
 
     // reallocate through amortized resizin
     unsigned int n_constraint = m_cdata->getN()+m_cdata->getNGhosts();
-    m_cmatrix.resize(n_constraint*n_constraint);
     m_cvec.resize(n_constraint);
 
-    // populate the terms in the matrix vector equation
-    fillMatrixVector(timestep);
+    if (m_block_solver)
+        {
+        // populate and solve the matrix vector equation of every molecule
+        solveConstraintBlocks(timestep);
+
+        // check violations
+        checkConstraints(timestep);
+        }
+    else
+        {
+        m_cmatrix.resize(n_constraint*n_constraint);
 
-    // check violations
-    checkConstraints(timestep);
+        // populate the terms in the matrix vector equation
+        fillMatrixVector(timestep);
 
-    // solve the matrix vector equation
-    solveConstraints(timestep);
+        // check violations
+        checkConstraints(timestep);
+
+        // solve the matrix vector equation
+        solveConstraints(timestep);
+        }
 
     // compute forces
     computeConstraintForces(timestep);
@@ -405,6 +426,383 @@ void ForceDistanceConstraint::solveConstraints(unsigned int timestep)
         m_prof->pop();
     }
 
+//! Largest number of constraints in a block that is solved with a dense LU decomposition
+const unsigned int MAX_DENSE_BLOCK = 32;
+
+/*! Two constraints belong to the same block if they share a particle. The blocks are labeled with a union-find over
+    the local constraints and are ordered by their first constraint. The particles of a block are numbered in the order
+    in which they first appear in its constraints. Blocks with the same constraint members (in this numbering) share
+    a topology, which holds the sparsity structure of their constraint matrix.
+*/
+void ForceDistanceConstraint::buildConstraintBlocks()
+    {
+    unsigned int n_constraint = m_cdata->getN()+m_cdata->getNGhosts();
+
+    ArrayHandle<ConstraintData::members_t> h_groups(m_cdata->getMembersArray(), access_location::host, access_mode::read);
+
+    // the root of every tree is its smallest constraint index
+    std::vector<unsigned int> parent(n_constraint);
+    auto find = [&parent](unsigned int i)
+        {
+        while (parent[i] != i)
+            {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+            }
+        return i;
+        };
+
+    // first constraint of every particle tag
+    std::unordered_map<unsigned int, unsigned int> first_constraint;
+
+    for (unsigned int n = 0; n < n_constraint; ++n)
+        {
+        parent[n] = n;
+        const ConstraintData::members_t constraint = h_groups.data[n];
+
+        for (unsigned int j = 0; j < 2; ++j)
+            {
+            auto it = first_constraint.insert(std::make_pair(constraint.tag[j], n));
+            if (! it.second)
+                {
+                unsigned int root_a = find(n);
+                unsigned int root_b = find(it.first->second);
+                if (root_a < root_b)
+                    parent[root_b] = root_a;
+                else
+                    parent[root_a] = root_b;
+                }
+            }
+        }
+
+    // number the blocks by their root
+    std::vector<unsigned int> block(n_constraint);
+    unsigned int n_blocks = 0;
+    for (unsigned int n = 0; n < n_constraint; ++n)
+        {
+        unsigned int root = find(n);
+        block[n] = (root == n) ? n_blocks++ : block[root];
+        }
+
+    // sort the constraints by block
+    m_block_start.assign(n_blocks+1, 0);
+    for (unsigned int n = 0; n < n_constraint; ++n)
+        m_block_start[block[n]+1]++;
+    for (unsigned int b = 0; b < n_blocks; ++b)
+        m_block_start[b+1] += m_block_start[b];
+
+    m_block_constraint.resize(n_constraint);
+    std::vector<unsigned int> offset(m_block_start.begin(), m_block_start.end()-1);
+    for (unsigned int n = 0; n < n_constraint; ++n)
+        m_block_constraint[offset[block[n]]++] = n;
+
+    // number the particles of each block and look up its topology
+    m_block_members.resize(2*n_constraint);
+    m_block_ptl_start.resize(n_blocks+1);
+    m_block_ptl.clear();
+    m_block_topology.resize(n_blocks);
+
+    std::unordered_map<unsigned int, unsigned int> ptl_idx;
+    std::vector<unsigned int> key;
+
+    for (unsigned int b = 0; b < n_blocks; ++b)
+        {
+        m_block_ptl_start[b] = m_block_ptl.size();
+        ptl_idx.clear();
+
+        for (unsigned int i = m_block_start[b]; i < m_block_start[b+1]; ++i)
+            {
+            const ConstraintData::members_t constraint = h_groups.data[m_block_constraint[i]];
+            for (unsigned int j = 0; j < 2; ++j)
+                {
+                auto it = ptl_idx.insert(std::make_pair(constraint.tag[j], (unsigned int)ptl_idx.size()));
+                if (it.second)
+                    m_block_ptl.push_back(constraint.tag[j]);
+                m_block_members[2*i+j] = it.first->second;
+                }
+            }
+
+        unsigned int n_block_constraint = m_block_start[b+1] - m_block_start[b];
+        unsigned int n_block_ptl = ptl_idx.size();
+
+        key.assign(m_block_members.begin() + 2*m_block_start[b], m_block_members.begin() + 2*m_block_start[b+1]);
+        key.push_back(n_block_ptl);
+
+        auto it = m_topology_map.find(key);
+        if (it != m_topology_map.end())
+            {
+            m_block_topology[b] = it->second;
+            continue;
+            }
+
+        // new topology
+        BlockTopology topology;
+        topology.n_constraint = n_block_constraint;
+        topology.n_ptl = n_block_ptl;
+        topology.triangle = n_block_ptl == 3 && n_block_constraint == 3;
+        topology.sparse = n_block_constraint > MAX_DENSE_BLOCK;
+
+        const unsigned int *members = &m_block_members[2*m_block_start[b]];
+
+        // constraints of every particle
+        std::vector< std::vector<unsigned int> > ptl_constraints(n_block_ptl);
+        for (unsigned int m = 0; m < n_block_constraint; ++m)
+            {
+            ptl_constraints[members[2*m]].push_back(m);
+            ptl_constraints[members[2*m+1]].push_back(m);
+            }
+
+        // the equation of constraint n depends on the multiplier of every constraint m that shares a particle with it
+        for (unsigned int n = 0; n < n_block_constraint; ++n)
+            {
+            for (unsigned int j = 0; j < 2; ++j)
+                {
+                unsigned int p = members[2*n+j];
+                for (auto m : ptl_constraints[p])
+                    {
+                    BlockTopology::Element element;
+                    element.row = n;
+                    element.col = m;
+                    element.ptl = p;
+                    element.sign = ((members[2*m] == p) == (j == 0)) ? 1.0 : -1.0;
+                    element.sparse_idx = -1;
+                    topology.elements.push_back(element);
+                    }
+                }
+            }
+
+        if (topology.sparse)
+            {
+            std::vector< Triplet<double> > triplets;
+            for (auto& element : topology.elements)
+                triplets.push_back(Triplet<double>(element.row, element.col, 1.0));
+
+            topology.pattern.resize(n_block_constraint, n_block_constraint);
+            topology.pattern.setFromTriplets(triplets.begin(), triplets.end());
+            topology.pattern.makeCompressed();
+
+            // locate every element in the compressed storage
+            for (auto& element : topology.elements)
+                {
+                int *outer = topology.pattern.outerIndexPtr();
+                int *inner = topology.pattern.innerIndexPtr();
+                int *id = std::lower_bound(inner + outer[element.col], inner + outer[element.col+1], (int)element.row);
+                element.sparse_idx = id - inner;
+                }
+
+            // compute the ordering permutation vector from the structural pattern
+            topology.solver.reset(new SparseLU<SparseMatrix<double, ColMajor>, COLAMDOrdering<int> >());
+            topology.solver->analyzePattern(topology.pattern);
+            }
+
+        m_block_topology[b] = m_topology.size();
+        m_topology_map[key] = m_topology.size();
+        m_topology.push_back(topology);
+        }
+    m_block_ptl_start[n_blocks] = m_block_ptl.size();
+
+    m_exec_conf->msg->notice(6) << "ForceDistanceConstraint: " << n_blocks << " blocks with "
+        << m_topology.size() << " distinct topologies" << std::endl;
+    }
+
+/*! The matrix and vector of every block are filled in the same way as in fillMatrixVector(), but only the elements
+    listed in the block topology are computed. Blocks solved with a dense (or closed form) decomposition are
+    independent and are processed in parallel in TBB enabled builds. Sparse blocks share the cached symbolic
+    factorization of their topology and are solved serially.
+
+    \param timestep Current timestep
+*/
+void ForceDistanceConstraint::solveConstraintBlocks(unsigned int timestep)
+    {
+    if (m_prof)
+        m_prof->push("solve blocks");
+
+    if (m_blocks_dirty)
+        {
+        buildConstraintBlocks();
+        m_blocks_dirty = false;
+        }
+
+    unsigned int n_constraint = m_cdata->getN()+m_cdata->getNGhosts();
+    m_lagrange.resize(n_constraint);
+
+    // access particle data
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_netforce(m_pdata->getNetForce(), access_location::host, access_mode::read);
+
+    // access constraints
+    ArrayHandle<ConstraintData::members_t> h_groups(m_cdata->getMembersArray(), access_location::host, access_mode::read);
+    ArrayHandle<typeval_t> h_typeval(m_cdata->getTypeValArray(), access_location::host, access_mode::read);
+
+    // access RHS and solution vector
+    ArrayHandle<double> h_cvec(m_cvec, access_location::host, access_mode::overwrite);
+    ArrayHandle<double> h_lagrange(m_lagrange, access_location::host, access_mode::overwrite);
+
+    const BoxDim& box = m_pdata->getBox();
+    const unsigned int max_local = m_pdata->getN() + m_pdata->getNGhosts();
+
+    // id of a violated constraint + 1
+    std::atomic<unsigned int> constraint_violated(0);
+
+    typedef Matrix<double, Dynamic, Dynamic, ColMajor> matrix_t;
+    typedef Matrix<double, Dynamic, 1> vec_t;
+
+    auto solve_block = [&](unsigned int b)
+        {
+        const BlockTopology& topology = m_topology[m_block_topology[b]];
+        const unsigned int first = m_block_start[b];
+        const unsigned int n_block_constraint = topology.n_constraint;
+        const unsigned int *members = &m_block_members[2*first];
+        const unsigned int *tags = &m_block_ptl[m_block_ptl_start[b]];
+
+        // particle indices and inverse masses
+        std::vector<unsigned int> idx(topology.n_ptl);
+        std::vector<double> inv_mass(topology.n_ptl);
+        for (unsigned int p = 0; p < topology.n_ptl; ++p)
+            {
+            idx[p] = h_rtag.data[tags[p]];
+            if (idx[p] >= max_local)
+                {
+                // report the first constraint of this particle
+                unsigned int i = 0;
+                while (members[2*i] != p && members[2*i+1] != p)
+                    ++i;
+                const ConstraintData::members_t constraint = h_groups.data[m_block_constraint[first+i]];
+                this->m_exec_conf->msg->error() << "constrain.distance(): constraint " <<
+                    constraint.tag[0] << " " << constraint.tag[1] << " incomplete." << std::endl << std::endl;
+                throw std::runtime_error("Error in constraint calculation");
+                }
+            inv_mass[p] = double(1.0)/h_vel.data[idx[p]].w;
+            }
+
+        // constraint vectors at the current and the next time step, and the RHS
+        std::vector< vec3<Scalar> > r(n_block_constraint);
+        std::vector< vec3<Scalar> > q(n_block_constraint);
+        vec_t rhs(n_block_constraint);
+
+        for (unsigned int i = 0; i < n_block_constraint; ++i)
+            {
+            unsigned int n = m_block_constraint[first+i];
+            unsigned int ptl_a = members[2*i];
+            unsigned int ptl_b = members[2*i+1];
+            unsigned int idx_a = idx[ptl_a];
+            unsigned int idx_b = idx[ptl_b];
+
+            vec3<Scalar> rn(box.minImage(vec3<Scalar>(h_pos.data[idx_a]) - vec3<Scalar>(h_pos.data[idx_b])));
+            vec3<Scalar> rndot(vec3<Scalar>(h_vel.data[idx_a]) - vec3<Scalar>(h_vel.data[idx_b]));
+            vec3<Scalar> qn(rn+rndot*m_deltaT);
+            r[i] = rn;
+            q[i] = qn;
+
+            // get constraint distance
+            Scalar d = h_typeval.data[n].val;
+
+            // check distance violation
+            if (fast::sqrt(dot(rn,rn))-d >= m_rel_tol*d || std::isnan(dot(rn,rn)))
+                {
+                constraint_violated = n+1;
+                }
+
+            rhs[i] = (dot(qn,qn)-d*d)/m_deltaT/m_deltaT;
+            rhs[i] += double(2.0)*dot(qn,vec3<Scalar>(h_netforce.data[idx_a])*Scalar(inv_mass[ptl_a])
+                  -vec3<Scalar>(h_netforce.data[idx_b])*Scalar(inv_mass[ptl_b]));
+            }
+
+        vec_t lagrange(n_block_constraint);
+        bool solved = true;
+
+        if (topology.triangle)
+            {
+            // three particles with three constraints: invert the 3x3 matrix in closed form
+            double A[3][3] = {{0.0,0.0,0.0},{0.0,0.0,0.0},{0.0,0.0,0.0}};
+            for (auto& element : topology.elements)
+                A[element.row][element.col] += double(4.0)*element.sign*inv_mass[element.ptl]
+                    *dot(q[element.row],r[element.col]);
+
+            double c00 = A[1][1]*A[2][2]-A[1][2]*A[2][1];
+            double c01 = A[1][2]*A[2][0]-A[1][0]*A[2][2];
+            double c02 = A[1][0]*A[2][1]-A[1][1]*A[2][0];
+            double det = A[0][0]*c00 + A[0][1]*c01 + A[0][2]*c02;
+
+            double inv_det = double(1.0)/det;
+            lagrange[0] = inv_det*(c00*rhs[0] + (A[0][2]*A[2][1]-A[0][1]*A[2][2])*rhs[1]
+                + (A[0][1]*A[1][2]-A[0][2]*A[1][1])*rhs[2]);
+            lagrange[1] = inv_det*(c01*rhs[0] + (A[0][0]*A[2][2]-A[0][2]*A[2][0])*rhs[1]
+                + (A[0][2]*A[1][0]-A[0][0]*A[1][2])*rhs[2]);
+            lagrange[2] = inv_det*(c02*rhs[0] + (A[0][1]*A[2][0]-A[0][0]*A[2][1])*rhs[1]
+                + (A[0][0]*A[1][1]-A[0][1]*A[1][0])*rhs[2]);
+            solved = lagrange.allFinite();
+            }
+        else if (! topology.sparse)
+            {
+            matrix_t A = matrix_t::Zero(n_block_constraint, n_block_constraint);
+            for (auto& element : topology.elements)
+                A(element.row, element.col) += double(4.0)*element.sign*inv_mass[element.ptl]
+                    *dot(q[element.row],r[element.col]);
+
+            lagrange = A.partialPivLu().solve(rhs);
+            solved = lagrange.allFinite();
+            }
+        else
+            {
+            SparseMatrix<double, ColMajor> A(topology.pattern);
+            std::fill(A.valuePtr(), A.valuePtr() + A.nonZeros(), 0.0);
+            for (auto& element : topology.elements)
+                A.valuePtr()[element.sparse_idx] += double(4.0)*element.sign*inv_mass[element.ptl]
+                    *dot(q[element.row],r[element.col]);
+
+            // reuse the symbolic factorization of this topology
+            topology.solver->factorize(A);
+            if (topology.solver->info())
+                solved = false;
+            else
+                lagrange = topology.solver->solve(rhs);
+            }
+
+        if (! solved)
+            {
+            m_exec_conf->msg->error() << "Could not solve linear system of constraint equations." << std::endl;
+            throw std::runtime_error("Error evaluating constraint forces.\n");
+            }
+
+        for (unsigned int i = 0; i < n_block_constraint; ++i)
+            {
+            unsigned int n = m_block_constraint[first+i];
+            h_cvec.data[n] = rhs[i];
+            h_lagrange.data[n] = lagrange[i];
+            }
+        };
+
+    const unsigned int n_blocks = m_block_topology.size();
+
+    #ifdef ENABLE_TBB
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_blocks),
+        [&](const tbb::blocked_range<unsigned int>& range)
+        {
+        for (unsigned int b = range.begin(); b < range.end(); ++b)
+            if (! m_topology[m_block_topology[b]].sparse)
+                solve_block(b);
+        });
+    #else
+    for (unsigned int b = 0; b < n_blocks; ++b)
+        if (! m_topology[m_block_topology[b]].sparse)
+            solve_block(b);
+    #endif
+
+    // blocks of the same topology share a sparse solver
+    for (unsigned int b = 0; b < n_blocks; ++b)
+        if (m_topology[m_block_topology[b]].sparse)
+            solve_block(b);
+
+    if (constraint_violated)
+        m_constraint_violated.resetFlags(constraint_violated);
+
+    if (m_prof)
+        m_prof->pop();
+    }
+
 void ForceDistanceConstraint::computeConstraintForces(unsigned int timestep)
     {
     ArrayHandle<double> h_lagrange(m_lagrange, access_location::host, access_mode::read);
@@ -25,12 +25,25 @@
 #include <Eigen/Dense>
 #include <Eigen/SparseLU>
 
+#include <map>
+#include <memory>
+#include <vector>
+
 /*! Implements a pairwise distance constraint using the algorithm of
 
     [1] M. Yoneya, H. J. C. Berendsen, and K. Hirasawa, “A Non-Iterative Matrix Method for Constraint Molecular Dynamics Simulations,” Mol. Simul., vol. 13, no. 6, pp. 395–405, 1994.
     [2] M. Yoneya, “A Generalized Non-iterative Matrix Method for Constraint Molecular Dynamics Simulations,” J. Comput. Phys., vol. 172, no. 1, pp. 188–197, Sep. 2001.
 
     See Integrator for detailed documentation on constraint force implementation.
+
+    The constraint matrix is block diagonal, with one block per molecule (connected cluster of constraints). By
+    default, the CPU implementation solves each block independently (in parallel in TBB enabled builds), so that
+    the memory and time scale linearly with the number of molecules. Blocks of three particles linked by three
+    constraints (such as rigid water) are solved in closed form, other small blocks with a dense LU decomposition,
+    and large blocks with a sparse LU decomposition whose symbolic factorization is cached per molecule topology.
+    With setBlockSolver(false), a single sparse system over all local constraints is solved instead, which is
+    what the GPU implementation does.
+
     \ingroup computes
 */
 class PYBIND11_EXPORT ForceDistanceConstraint : public MolecularForceCompute
@@ -54,6 +67,18 @@ class PYBIND11_EXPORT ForceDistanceConstraint : public MolecularForceCompute
             m_rel_tol = rel_tol;
             }
 
+        //! Set whether the constraints of each molecule are solved independently
+        void setBlockSolver(bool block_solver)
+            {
+            m_block_solver = block_solver;
+            }
+
+        //! Get whether the constraints of each molecule are solved independently
+        bool getBlockSolver()
+            {
+            return m_block_solver;
+            }
+
         #ifdef ENABLE_MPI
         //! Get ghost particle fields requested by this pair potential
         virtual CommFlags getRequestedCommFlags(unsigned int timestep);
@@ -83,6 +108,41 @@ class PYBIND11_EXPORT ForceDistanceConstraint : public MolecularForceCompute
 
         Scalar m_d_max;                    //!< Maximum constraint extension
 
+        //! Structure of the constraint matrix of a block, shared by all blocks with the same topology
+        struct BlockTopology
+            {
+            //! Contribution of a particle shared by two constraints to an element of the constraint matrix
+            struct Element
+                {
+                unsigned int row;  //!< Constraint of the equation (index in the block)
+                unsigned int col;  //!< Constraint of the Lagrange multiplier (index in the block)
+                unsigned int ptl;  //!< Shared particle (index in the block)
+                double sign;       //!< Sign of the contribution
+                int sparse_idx;    //!< Index into the values of the sparse matrix (sparse blocks only)
+                };
+
+            unsigned int n_constraint;     //!< Number of constraints
+            unsigned int n_ptl;            //!< Number of particles
+            bool triangle;                 //!< True for three particles linked by three constraints
+            bool sparse;                   //!< True if the block is solved with a sparse LU decomposition
+            std::vector<Element> elements; //!< Contributions to the matrix elements
+
+            Eigen::SparseMatrix<double, Eigen::ColMajor> pattern; //!< Sparsity pattern (sparse blocks only)
+            std::shared_ptr< Eigen::SparseLU<Eigen::SparseMatrix<double, Eigen::ColMajor>,
+                Eigen::COLAMDOrdering<int> > > solver; //!< Solver holding the symbolic factorization (sparse blocks only)
+            };
+
+        bool m_block_solver;                          //!< True if the constraints of each block are solved independently
+        bool m_blocks_dirty;                          //!< True if the blocks need to be rebuilt
+        std::vector<unsigned int> m_block_start;      //!< Start of each block in m_block_constraint, plus the end
+        std::vector<unsigned int> m_block_constraint; //!< Constraint indices, grouped by block
+        std::vector<unsigned int> m_block_members;    //!< Members of each constraint in m_block_constraint (index in the block)
+        std::vector<unsigned int> m_block_ptl_start;  //!< Start of each block in m_block_ptl, plus the end
+        std::vector<unsigned int> m_block_ptl;        //!< Particle tags of each block
+        std::vector<unsigned int> m_block_topology;   //!< Topology of each block
+        std::vector<BlockTopology> m_topology;        //!< Distinct block topologies
+        std::map< std::vector<unsigned int>, unsigned int> m_topology_map; //!< Topology index by block structure
+
         //! Compute the forces
         virtual void computeForces(unsigned int timestep);
 
@@ -98,16 +158,24 @@ class PYBIND11_EXPORT ForceDistanceConstraint : public MolecularForceCompute
         //! Solve the linear matrix-vector equation
         virtual void computeConstraintForces(unsigned int timestep);
 
+        //! Group the local constraints into independent blocks
+        void buildConstraintBlocks();
+
+        //! Populate and solve the constraint-force equation of each block
+        virtual void solveConstraintBlocks(unsigned int timestep);
+
         //! Method called when constraint order changes
         virtual void slotConstraintReorder()
             {
             m_constraint_reorder = true;
+            m_blocks_dirty = true;
             }
 
         //! Method called when constraint order changes
         virtual void slotConstraintsAddedRemoved()
             {
             m_constraints_added_removed = true;
+            m_blocks_dirty = true;
             }
 
         //! Returns the requested ghost layer width for all types
@@ -68,6 +68,9 @@ ForceDistanceConstraintGPU::ForceDistanceConstraintGPU(std::shared_ptr<SystemDef
     // reallocate base class array
     GPUVector<int> sparse_idxlookup(m_exec_conf);
     m_sparse_idxlookup.swap(sparse_idxlookup);
+
+    // the matrix is filled on the GPU and solved as a single sparse system
+    m_block_solver = false;
     }
 
 //! Destructor
@@ -15,6 +15,11 @@ namespace py = pybind11;
 #include <stdexcept>
 #include <math.h>
 
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
+
 using namespace std;
 
 // SMALL a relatively small number
@@ -132,19 +137,38 @@ Scalar HarmonicAngleForceCompute::getLogValue(const std::string& quantity, unsig
 
 /*! Actually perform the force computation
     \param timestep Current time step
+
+    In TBB enabled builds with more than one thread, the particles are split into one block per thread. Each particle
+    loops over its angles in the particle-centric lookup table of the AngleData and evaluates those it leads, i.e.
+    where it is the first local member. The forces on particles of other blocks are collected by m_block_forces.
  */
 void HarmonicAngleForceCompute::computeForces(unsigned int timestep)
     {
     if (m_prof) m_prof->push("Harmonic Angle");
 
     assert(m_pdata);
+
+    const unsigned int N = m_pdata->getN();
+
+    bool by_particle = false;
+    #ifdef ENABLE_TBB
+    const unsigned int n_blocks = m_exec_conf->getNumThreads();
+    by_particle = n_blocks > 1 && N > n_blocks;
+    #endif
+
+    // the lookup table is rebuilt on demand, before any particle data is accessed
+    if (by_particle)
+        m_angle_data->getGPUTable();
+
     // access the particle data arrays
     ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
 
-    ArrayHandle<Scalar4> h_force(m_force,access_location::host, access_mode::overwrite);
-    ArrayHandle<Scalar> h_virial(m_virial,access_location::host, access_mode::overwrite);
-    unsigned int virial_pitch = m_virial.getPitch();
+    // the forces are added to the net force arrays when requested
+    const access_mode::Enum force_mode = m_accumulate_net_force ? access_mode::readwrite : access_mode::overwrite;
+    ArrayHandle<Scalar4> h_force(getForceOutput(),access_location::host, force_mode);
+    ArrayHandle<Scalar> h_virial(getVirialOutput(),access_location::host, force_mode);
+    unsigned int virial_pitch = getVirialOutput().getPitch();
 
     // there are enough other checks on the input data: but it doesn't hurt to be safe
     assert(h_force.data);
@@ -153,40 +177,19 @@ void HarmonicAngleForceCompute::computeForces(unsigned int timestep)
     assert(h_rtag.data);
 
     // Zero data for force calculation.
-    memset((void*)h_force.data,0,sizeof(Scalar4)*m_force.getNumElements());
-    memset((void*)h_virial.data,0,sizeof(Scalar)*m_virial.getNumElements());
+    if (!m_accumulate_net_force)
+        {
+        memset((void*)h_force.data,0,sizeof(Scalar4)*m_force.getNumElements());
+        memset((void*)h_virial.data,0,sizeof(Scalar)*m_virial.getNumElements());
+        }
 
     // get a local copy of the simulation box too
     const BoxDim& box = m_pdata->getGlobalBox();
 
-    // for each of the angles
-    const unsigned int size = (unsigned int)m_angle_data->getN();
-    for (unsigned int i = 0; i < size; i++)
+    // evaluates the angle a-b-c, the forces on a and c are fab and fcb, the force on b is -(fab+fcb)
+    auto evaluate = [&](unsigned int idx_a, unsigned int idx_b, unsigned int idx_c, unsigned int angle_type,
+                        Scalar *fab, Scalar *fcb, Scalar& angle_eng, Scalar *angle_virial)
         {
-        // lookup the tag of each of the particles participating in the angle
-        const AngleData::members_t& angle = m_angle_data->getMembersByIndex(i);
-        assert(angle.tag[0] <= m_pdata->getMaximumTag());
-        assert(angle.tag[1] <= m_pdata->getMaximumTag());
-        assert(angle.tag[2] <= m_pdata->getMaximumTag());
-
-        // transform a, b, and c into indices into the particle data arrays
-        // MEM TRANSFER: 6 ints
-        unsigned int idx_a = h_rtag.data[angle.tag[0]];
-        unsigned int idx_b = h_rtag.data[angle.tag[1]];
-        unsigned int idx_c = h_rtag.data[angle.tag[2]];
-
-        // throw an error if this angle is incomplete
-        if (idx_a == NOT_LOCAL|| idx_b == NOT_LOCAL || idx_c == NOT_LOCAL)
-            {
-            this->m_exec_conf->msg->error() << "angle.harmonic: angle " <<
-                angle.tag[0] << " " << angle.tag[1] << " " << angle.tag[2] << " incomplete." << endl << endl;
-            throw std::runtime_error("Error in angle calculation");
-            }
-
-        assert(idx_a < m_pdata->getN()+m_pdata->getNGhosts());
-        assert(idx_b < m_pdata->getN()+m_pdata->getNGhosts());
-        assert(idx_c < m_pdata->getN()+m_pdata->getNGhosts());
-
         // calculate d\vec{r}
         Scalar3 dab;
         dab.x = h_pos.data[idx_a].x - h_pos.data[idx_b].x;
@@ -198,15 +201,9 @@ void HarmonicAngleForceCompute::computeForces(unsigned int timestep)
         dcb.y = h_pos.data[idx_c].y - h_pos.data[idx_b].y;
         dcb.z = h_pos.data[idx_c].z - h_pos.data[idx_b].z;
 
-        Scalar3 dac;
-        dac.x = h_pos.data[idx_a].x - h_pos.data[idx_c].x; // used for the 1-3 JL interaction
-        dac.y = h_pos.data[idx_a].y - h_pos.data[idx_c].y;
-        dac.z = h_pos.data[idx_a].z - h_pos.data[idx_c].z;
-
-        // apply minimum image conventions to all 3 vectors
+        // apply minimum image conventions to both vectors
         dab = box.minImage(dab);
         dcb = box.minImage(dcb);
-        dac = box.minImage(dac);
 
         // on paper, the formula turns out to be: F = K*\vec{r} * (r_0/r - 1)
         // FLOPS: 14 / MEM TRANSFER: 2 Scalars
@@ -229,7 +226,6 @@ void HarmonicAngleForceCompute::computeForces(unsigned int timestep)
         s_abbc = 1.0/s_abbc;
 
         // actually calculate the force
-        unsigned int angle_type = m_angle_data->getTypeByIndex(i);
         Scalar dth = acos(c_abbc) - m_t_0[angle_type];
         Scalar tk = m_K[angle_type]*dth;
 
@@ -238,8 +234,6 @@ void HarmonicAngleForceCompute::computeForces(unsigned int timestep)
         Scalar a12 = -a / (rab*rcb);
         Scalar a22 = a*c_abbc / rsqcb;
 
-        Scalar fab[3], fcb[3];
-
         fab[0] = a11*dab.x + a12*dcb.x;
         fab[1] = a11*dab.y + a12*dcb.y;
         fab[2] = a11*dab.z + a12*dcb.z;
@@ -249,21 +243,112 @@ void HarmonicAngleForceCompute::computeForces(unsigned int timestep)
         fcb[2] = a22*dcb.z + a12*dab.z;
 
         // compute 1/3 of the energy, 1/3 for each atom in the angle
-        Scalar angle_eng = (tk*dth)*Scalar(1.0/6.0);
+        angle_eng = (tk*dth)*Scalar(1.0/6.0);
 
         // compute 1/3 of the virial, 1/3 for each atom in the angle
         // upper triangular version of virial tensor
-        Scalar angle_virial[6];
         angle_virial[0] = Scalar(1./3.) * ( dab.x*fab[0] + dcb.x*fcb[0] );
         angle_virial[1] = Scalar(1./3.) * ( dab.y*fab[0] + dcb.y*fcb[0] );
         angle_virial[2] = Scalar(1./3.) * ( dab.z*fab[0] + dcb.z*fcb[0] );
         angle_virial[3] = Scalar(1./3.) * ( dab.y*fab[1] + dcb.y*fcb[1] );
         angle_virial[4] = Scalar(1./3.) * ( dab.z*fab[1] + dcb.z*fcb[1] );
         angle_virial[5] = Scalar(1./3.) * ( dab.z*fab[2] + dcb.z*fcb[2] );
+        };
+
+    #ifdef ENABLE_TBB
+    if (by_particle)
+        {
+        ArrayHandle<AngleData::members_t> h_gpu_anglelist(m_angle_data->getGPUTable(),
+                                                          access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_gpu_angle_pos(m_angle_data->getGPUPosTable(),
+                                                  access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_n_angles(m_angle_data->getNGroupsArray(), access_location::host, access_mode::read);
+        const Index2D& table_indexer = m_angle_data->getGPUTableIndexer();
+
+        m_block_forces.setup(N, n_blocks);
+
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_blocks, 1),
+            [&](const tbb::blocked_range<unsigned int>& r)
+            {
+            for (unsigned int blk = r.begin(); blk != r.end(); ++blk)
+                {
+                for (unsigned int idx = m_block_forces.begin(blk); idx < m_block_forces.begin(blk+1); idx++)
+                    {
+                    for (unsigned int j = 0; j < h_n_angles.data[idx]; j++)
+                        {
+                        // the table lists the other two members in order, followed by the type
+                        const AngleData::members_t& angle = h_gpu_anglelist.data[table_indexer(idx, j)];
+                        unsigned int cur_angle_abc = h_gpu_angle_pos.data[table_indexer(idx, j)];
+
+                        unsigned int member[3];
+                        for (unsigned int k = 0, n = 0; k < 3; k++)
+                            member[k] = (k == cur_angle_abc) ? idx : angle.idx[n++];
+
+                        // the first local member leads the angle
+                        bool leader = true;
+                        for (unsigned int k = 0; k < cur_angle_abc; k++)
+                            if (member[k] < N)
+                                leader = false;
+                        if (!leader)
+                            continue;
+
+                        Scalar fab[3], fcb[3], angle_eng, angle_virial[6];
+                        evaluate(member[0], member[1], member[2], angle.idx[2], fab, fcb, angle_eng, angle_virial);
+
+                        Scalar4 force[3];
+                        force[0] = make_scalar4(fab[0], fab[1], fab[2], angle_eng);
+                        force[1] = make_scalar4(-fab[0] - fcb[0], -fab[1] - fcb[1], -fab[2] - fcb[2], angle_eng);
+                        force[2] = make_scalar4(fcb[0], fcb[1], fcb[2], angle_eng);
+                        for (unsigned int k = 0; k < 3; k++)
+                            if (member[k] < N)
+                                m_block_forces.add(blk, member[k], force[k], angle_virial,
+                                                   h_force.data, h_virial.data, virial_pitch);
+                        }
+                    }
+                }
+            });
+
+        m_block_forces.apply(h_force.data, h_virial.data, virial_pitch, true);
+
+        if (m_prof) m_prof->pop();
+        return;
+        }
+    #endif
+
+    // for each of the angles
+    const unsigned int size = (unsigned int)m_angle_data->getN();
+    for (unsigned int i = 0; i < size; i++)
+        {
+        // lookup the tag of each of the particles participating in the angle
+        const AngleData::members_t& angle = m_angle_data->getMembersByIndex(i);
+        assert(angle.tag[0] <= m_pdata->getMaximumTag());
+        assert(angle.tag[1] <= m_pdata->getMaximumTag());
+        assert(angle.tag[2] <= m_pdata->getMaximumTag());
+
+        // transform a, b, and c into indices into the particle data arrays
+        // MEM TRANSFER: 6 ints
+        unsigned int idx_a = h_rtag.data[angle.tag[0]];
+        unsigned int idx_b = h_rtag.data[angle.tag[1]];
+        unsigned int idx_c = h_rtag.data[angle.tag[2]];
+
+        // throw an error if this angle is incomplete
+        if (idx_a == NOT_LOCAL|| idx_b == NOT_LOCAL || idx_c == NOT_LOCAL)
+            {
+            this->m_exec_conf->msg->error() << "angle.harmonic: angle " <<
+                angle.tag[0] << " " << angle.tag[1] << " " << angle.tag[2] << " incomplete." << endl << endl;
+            throw std::runtime_error("Error in angle calculation");
+            }
+
+        assert(idx_a < m_pdata->getN()+m_pdata->getNGhosts());
+        assert(idx_b < m_pdata->getN()+m_pdata->getNGhosts());
+        assert(idx_c < m_pdata->getN()+m_pdata->getNGhosts());
+
+        Scalar fab[3], fcb[3], angle_eng, angle_virial[6];
+        evaluate(idx_a, idx_b, idx_c, m_angle_data->getTypeByIndex(i), fab, fcb, angle_eng, angle_virial);
 
         // Now, apply the force to each individual atom a,b,c, and accumulate the energy/virial
         // do not update ghost particles
-        if (idx_a < m_pdata->getN())
+        if (idx_a < N)
             {
             h_force.data[idx_a].x += fab[0];
             h_force.data[idx_a].y += fab[1];
@@ -273,7 +358,7 @@ void HarmonicAngleForceCompute::computeForces(unsigned int timestep)
                 h_virial.data[j*virial_pitch+idx_a]  += angle_virial[j];
             }
 
-        if (idx_b < m_pdata->getN())
+        if (idx_b < N)
             {
             h_force.data[idx_b].x -= fab[0] + fcb[0];
             h_force.data[idx_b].y -= fab[1] + fcb[1];
@@ -283,7 +368,7 @@ void HarmonicAngleForceCompute::computeForces(unsigned int timestep)
                 h_virial.data[j*virial_pitch+idx_b]  += angle_virial[j];
             }
 
-        if (idx_c < m_pdata->getN())
+        if (idx_c < N)
             {
             h_force.data[idx_c].x += fcb[0];
             h_force.data[idx_c].y += fcb[1];
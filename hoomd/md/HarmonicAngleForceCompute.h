@@ -5,6 +5,7 @@
 // Maintainer: dnlebard
 #include "hoomd/ForceCompute.h"
 #include "hoomd/BondedGroupData.h"
+#include "ThreadBlockForces.h"
 
 #include <memory>
 
@@ -64,6 +65,24 @@ class PYBIND11_EXPORT HarmonicAngleForceCompute : public ForceCompute
         //! Destructor
         virtual ~HarmonicAngleForceCompute();
 
+        //! The angle forces only read shared data and may be computed concurrently
+        virtual bool canComputeConcurrently() const
+            {
+            return true;
+            }
+
+        //! Get the name of the profiler category for this ForceCompute
+        virtual std::string getProfileName() const
+            {
+            return "Harmonic Angle";
+            }
+
+        //! Rebuild the angle table before the forces are computed concurrently
+        virtual void prepareConcurrentCompute(unsigned int timestep)
+            {
+            m_angle_data->getGPUTable();
+            }
+
         //! Set the parameters
         virtual void setParams(unsigned int type, Scalar K, Scalar t_0);
 
@@ -97,8 +116,18 @@ class PYBIND11_EXPORT HarmonicAngleForceCompute : public ForceCompute
 
         std::shared_ptr<AngleData> m_angle_data;  //!< Angle data to use in computing angles
 
+        #ifdef ENABLE_TBB
+        ThreadBlockForces m_block_forces;    //!< Forces computed by several threads
+        #endif
+
         //! Actually compute the forces
         virtual void computeForces(unsigned int timestep);
+
+        //! The angle forces can be added directly to the net force arrays
+        virtual bool supportsNetForceAccumulation() const
+            {
+            return true;
+            }
     };
 
 //! Exports the AngleForceCompute class to python
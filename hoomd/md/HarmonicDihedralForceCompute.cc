@@ -15,6 +15,11 @@ namespace py = pybind11;
 #include <stdexcept>
 #include <math.h>
 
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
+
 using namespace std;
 
 // SMALL a relatively small number
@@ -144,22 +149,43 @@ Scalar HarmonicDihedralForceCompute::getLogValue(const std::string& quantity, un
 
 /*! Actually perform the force computation
     \param timestep Current time step
+
+    In TBB enabled builds with more than one thread, the particles are split into one block per thread. Each particle
+    loops over its dihedrals in the particle-centric lookup table of the DihedralData and evaluates those it leads, i.e.
+    where it is the first local member. The forces on particles of other blocks are collected by m_block_forces.
  */
 void HarmonicDihedralForceCompute::computeForces(unsigned int timestep)
     {
     if (m_prof) m_prof->push("Harmonic Dihedral");
 
     assert(m_pdata);
+
+    bool by_particle = false;
+    #ifdef ENABLE_TBB
+    const unsigned int N = m_pdata->getN();
+    const unsigned int n_blocks = m_exec_conf->getNumThreads();
+    by_particle = n_blocks > 1 && N > n_blocks;
+    #endif
+
+    // the lookup table is rebuilt on demand, before any particle data is accessed
+    if (by_particle)
+        m_dihedral_data->getGPUTable();
+
     // access the particle data arrays
     ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
 
-    ArrayHandle<Scalar4> h_force(m_force,access_location::host, access_mode::overwrite);
-    ArrayHandle<Scalar> h_virial(m_virial,access_location::host, access_mode::overwrite);
+    // the forces are added to the net force arrays when requested
+    const access_mode::Enum force_mode = m_accumulate_net_force ? access_mode::readwrite : access_mode::overwrite;
+    ArrayHandle<Scalar4> h_force(getForceOutput(),access_location::host, force_mode);
+    ArrayHandle<Scalar> h_virial(getVirialOutput(),access_location::host, force_mode);
 
     // Zero data for force calculation.
-    memset((void*)h_force.data,0,sizeof(Scalar4)*m_force.getNumElements());
-    memset((void*)h_virial.data,0,sizeof(Scalar)*m_virial.getNumElements());
+    if (!m_accumulate_net_force)
+        {
+        memset((void*)h_force.data,0,sizeof(Scalar4)*m_force.getNumElements());
+        memset((void*)h_virial.data,0,sizeof(Scalar)*m_virial.getNumElements());
+        }
 
     // there are enough other checks on the input data: but it doesn't hurt to be safe
     assert(h_force.data);
@@ -167,42 +193,19 @@ void HarmonicDihedralForceCompute::computeForces(unsigned int timestep)
     assert(h_pos.data);
     assert(h_rtag.data);
 
-    unsigned int virial_pitch = m_virial.getPitch();
+    unsigned int virial_pitch = getVirialOutput().getPitch();
 
     // get a local copy of the simulation box too
     const BoxDim& box = m_pdata->getBox();
 
-    // for each of the dihedrals
-    const unsigned int size = (unsigned int)m_dihedral_data->getN();
-    for (unsigned int i = 0; i < size; i++)
+    // evaluates the dihedral a-b-c-d, ff holds the forces on a, b, c and d
+    auto evaluate = [&](const unsigned int *idx, unsigned int dihedral_type,
+                        Scalar ff[4][3], Scalar& dihedral_eng, Scalar *dihedral_virial)
         {
-        // lookup the tag of each of the particles participating in the dihedral
-        const ImproperData::members_t& dihedral = m_dihedral_data->getMembersByIndex(i);
-        assert(dihedral.tag[0] <= m_pdata->getMaximumTag());
-        assert(dihedral.tag[1] <= m_pdata->getMaximumTag());
-        assert(dihedral.tag[2] <= m_pdata->getMaximumTag());
-        assert(dihedral.tag[3] <= m_pdata->getMaximumTag());
-
-        // transform a, b, and c into indices into the particle data arrays
-        // MEM TRANSFER: 6 ints
-        unsigned int idx_a = h_rtag.data[dihedral.tag[0]];
-        unsigned int idx_b = h_rtag.data[dihedral.tag[1]];
-        unsigned int idx_c = h_rtag.data[dihedral.tag[2]];
-        unsigned int idx_d = h_rtag.data[dihedral.tag[3]];
-
-        // throw an error if this angle is incomplete
-        if (idx_a == NOT_LOCAL|| idx_b == NOT_LOCAL || idx_c == NOT_LOCAL || idx_d == NOT_LOCAL)
-            {
-            this->m_exec_conf->msg->error() << "dihedral.harmonic: dihedral " <<
-                dihedral.tag[0] << " " << dihedral.tag[1] << " " << dihedral.tag[2] << " " << dihedral.tag[3]
-                << " incomplete." << endl << endl;
-            throw std::runtime_error("Error in dihedral calculation");
-            }
-
-        assert(idx_a < m_pdata->getN() + m_pdata->getNGhosts());
-        assert(idx_b < m_pdata->getN() + m_pdata->getNGhosts());
-        assert(idx_c < m_pdata->getN() + m_pdata->getNGhosts());
-        assert(idx_d < m_pdata->getN() + m_pdata->getNGhosts());
+        unsigned int idx_a = idx[0];
+        unsigned int idx_b = idx[1];
+        unsigned int idx_c = idx[2];
+        unsigned int idx_d = idx[3];
 
         // calculate d\vec{r}
         Scalar3 dab;
@@ -258,7 +261,6 @@ void HarmonicDihedralForceCompute::computeForces(unsigned int timestep)
         if (c_abcd > 1.0) c_abcd = 1.0;
         if (c_abcd < -1.0) c_abcd = -1.0;
 
-        unsigned int dihedral_type = m_dihedral_data->getTypeByIndex(i);
         int multi = (int)m_multi[dihedral_type];
         Scalar p = Scalar(1.0);
         Scalar dfab = Scalar(0.0);
@@ -336,49 +338,128 @@ void HarmonicDihedralForceCompute::computeForces(unsigned int timestep)
         Scalar ffcy = -sy2 - ffdy;
         Scalar ffcz = -sz2 - ffdz;
 
-        // Now, apply the force to each individual atom a,b,c,d
-        // and accumulate the energy/virial
+        ff[0][0] = ffax; ff[0][1] = ffay; ff[0][2] = ffaz;
+        ff[1][0] = ffbx; ff[1][1] = ffby; ff[1][2] = ffbz;
+        ff[2][0] = ffcx; ff[2][1] = ffcy; ff[2][2] = ffcz;
+        ff[3][0] = ffdx; ff[3][1] = ffdy; ff[3][2] = ffdz;
+
         // compute 1/4 of the energy, 1/4 for each atom in the dihedral
         //Scalar dihedral_eng = p*m_K[dihedral.type]*Scalar(1.0/4.0);
-        Scalar dihedral_eng = p*m_K[dihedral_type]*Scalar(0.125);  // the .125 term is (1/2)K * 1/4
+        dihedral_eng = p*m_K[dihedral_type]*Scalar(0.125);  // the .125 term is (1/2)K * 1/4
 
         // compute 1/4 of the virial, 1/4 for each atom in the dihedral
         // upper triangular version of virial tensor
-        Scalar dihedral_virial[6];
         dihedral_virial[0] = (1./4.)*(dab.x*ffax + dcb.x*ffcx + (ddc.x+dcb.x)*ffdx);
         dihedral_virial[1] = (1./4.)*(dab.y*ffax + dcb.y*ffcx + (ddc.y+dcb.y)*ffdx);
         dihedral_virial[2] = (1./4.)*(dab.z*ffax + dcb.z*ffcx + (ddc.z+dcb.z)*ffdx);
         dihedral_virial[3] = (1./4.)*(dab.y*ffay + dcb.y*ffcy + (ddc.y+dcb.y)*ffdy);
         dihedral_virial[4] = (1./4.)*(dab.z*ffay + dcb.z*ffcy + (ddc.z+dcb.z)*ffdy);
         dihedral_virial[5] = (1./4.)*(dab.z*ffaz + dcb.z*ffcz + (ddc.z+dcb.z)*ffdz);
+        };
 
-        h_force.data[idx_a].x += ffax;
-        h_force.data[idx_a].y += ffay;
-        h_force.data[idx_a].z += ffaz;
-        h_force.data[idx_a].w += dihedral_eng;
-        for (int k = 0; k < 6; k++)
-           h_virial.data[virial_pitch*k+idx_a]  += dihedral_virial[k];
-
-        h_force.data[idx_b].x += ffbx;
-        h_force.data[idx_b].y += ffby;
-        h_force.data[idx_b].z += ffbz;
-        h_force.data[idx_b].w += dihedral_eng;
-        for (int k = 0; k < 6; k++)
-           h_virial.data[virial_pitch*k+idx_b]  += dihedral_virial[k];
-
-        h_force.data[idx_c].x += ffcx;
-        h_force.data[idx_c].y += ffcy;
-        h_force.data[idx_c].z += ffcz;
-        h_force.data[idx_c].w += dihedral_eng;
-        for (int k = 0; k < 6; k++)
-           h_virial.data[virial_pitch*k+idx_c]  += dihedral_virial[k];
-
-        h_force.data[idx_d].x += ffdx;
-        h_force.data[idx_d].y += ffdy;
-        h_force.data[idx_d].z += ffdz;
-        h_force.data[idx_d].w += dihedral_eng;
-        for (int k = 0; k < 6; k++)
-           h_virial.data[virial_pitch*k+idx_d]  += dihedral_virial[k];
+    #ifdef ENABLE_TBB
+    if (by_particle)
+        {
+        ArrayHandle<DihedralData::members_t> h_gpu_dihedral_list(m_dihedral_data->getGPUTable(),
+                                                                 access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_dihedrals_ABCD(m_dihedral_data->getGPUPosTable(),
+                                                   access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_n_dihedrals(m_dihedral_data->getNGroupsArray(),
+                                                access_location::host, access_mode::read);
+        const Index2D& table_indexer = m_dihedral_data->getGPUTableIndexer();
+
+        m_block_forces.setup(N, n_blocks);
+
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_blocks, 1),
+            [&](const tbb::blocked_range<unsigned int>& r)
+            {
+            for (unsigned int blk = r.begin(); blk != r.end(); ++blk)
+                {
+                for (unsigned int idx = m_block_forces.begin(blk); idx < m_block_forces.begin(blk+1); idx++)
+                    {
+                    for (unsigned int j = 0; j < h_n_dihedrals.data[idx]; j++)
+                        {
+                        // the table lists the other three members in order, followed by the type
+                        const DihedralData::members_t& dihedral = h_gpu_dihedral_list.data[table_indexer(idx, j)];
+                        unsigned int cur_dihedral_abcd = h_dihedrals_ABCD.data[table_indexer(idx, j)];
+
+                        unsigned int member[4];
+                        for (unsigned int k = 0, n = 0; k < 4; k++)
+                            member[k] = (k == cur_dihedral_abcd) ? idx : dihedral.idx[n++];
+
+                        // the first local member leads the dihedral
+                        bool leader = true;
+                        for (unsigned int k = 0; k < cur_dihedral_abcd; k++)
+                            if (member[k] < N)
+                                leader = false;
+                        if (!leader)
+                            continue;
+
+                        Scalar ff[4][3], dihedral_eng, dihedral_virial[6];
+                        evaluate(member, dihedral.idx[3], ff, dihedral_eng, dihedral_virial);
+
+                        for (unsigned int k = 0; k < 4; k++)
+                            if (member[k] < N)
+                                m_block_forces.add(blk, member[k],
+                                                   make_scalar4(ff[k][0], ff[k][1], ff[k][2], dihedral_eng),
+                                                   dihedral_virial, h_force.data, h_virial.data, virial_pitch);
+                        }
+                    }
+                }
+            });
+
+        m_block_forces.apply(h_force.data, h_virial.data, virial_pitch, true);
+
+        if (m_prof) m_prof->pop();
+        return;
+        }
+    #endif
+
+    // for each of the dihedrals
+    const unsigned int size = (unsigned int)m_dihedral_data->getN();
+    for (unsigned int i = 0; i < size; i++)
+        {
+        // lookup the tag of each of the particles participating in the dihedral
+        const ImproperData::members_t& dihedral = m_dihedral_data->getMembersByIndex(i);
+        assert(dihedral.tag[0] <= m_pdata->getMaximumTag());
+        assert(dihedral.tag[1] <= m_pdata->getMaximumTag());
+        assert(dihedral.tag[2] <= m_pdata->getMaximumTag());
+        assert(dihedral.tag[3] <= m_pdata->getMaximumTag());
+
+        // transform a, b, and c into indices into the particle data arrays
+        // MEM TRANSFER: 6 ints
+        unsigned int idx[4];
+        for (unsigned int k = 0; k < 4; k++)
+            idx[k] = h_rtag.data[dihedral.tag[k]];
+
+        // throw an error if this angle is incomplete
+        if (idx[0] == NOT_LOCAL|| idx[1] == NOT_LOCAL || idx[2] == NOT_LOCAL || idx[3] == NOT_LOCAL)
+            {
+            this->m_exec_conf->msg->error() << "dihedral.harmonic: dihedral " <<
+                dihedral.tag[0] << " " << dihedral.tag[1] << " " << dihedral.tag[2] << " " << dihedral.tag[3]
+                << " incomplete." << endl << endl;
+            throw std::runtime_error("Error in dihedral calculation");
+            }
+
+        assert(idx[0] < m_pdata->getN() + m_pdata->getNGhosts());
+        assert(idx[1] < m_pdata->getN() + m_pdata->getNGhosts());
+        assert(idx[2] < m_pdata->getN() + m_pdata->getNGhosts());
+        assert(idx[3] < m_pdata->getN() + m_pdata->getNGhosts());
+
+        Scalar ff[4][3], dihedral_eng, dihedral_virial[6];
+        evaluate(idx, m_dihedral_data->getTypeByIndex(i), ff, dihedral_eng, dihedral_virial);
+
+        // Now, apply the force to each individual atom a,b,c,d
+        // and accumulate the energy/virial
+        for (unsigned int m = 0; m < 4; m++)
+            {
+            h_force.data[idx[m]].x += ff[m][0];
+            h_force.data[idx[m]].y += ff[m][1];
+            h_force.data[idx[m]].z += ff[m][2];
+            h_force.data[idx[m]].w += dihedral_eng;
+            for (int k = 0; k < 6; k++)
+               h_virial.data[virial_pitch*k+idx[m]]  += dihedral_virial[k];
+            }
        }
 
     if (m_prof) m_prof->pop();
@@ -6,6 +6,7 @@
 
 #include "hoomd/ForceCompute.h"
 #include "hoomd/BondedGroupData.h"
+#include "ThreadBlockForces.h"
 
 #include <memory>
 
@@ -66,6 +67,24 @@ class PYBIND11_EXPORT HarmonicDihedralForceCompute : public ForceCompute
         //! Destructor
         virtual ~HarmonicDihedralForceCompute();
 
+        //! The dihedral forces only read shared data and may be computed concurrently
+        virtual bool canComputeConcurrently() const
+            {
+            return true;
+            }
+
+        //! Get the name of the profiler category for this ForceCompute
+        virtual std::string getProfileName() const
+            {
+            return "Harmonic Dihedral";
+            }
+
+        //! Rebuild the dihedral table before the forces are computed concurrently
+        virtual void prepareConcurrentCompute(unsigned int timestep)
+            {
+            m_dihedral_data->getGPUTable();
+            }
+
         //! Set the parameters
         virtual void setParams(unsigned int type, Scalar K, int sign, unsigned int multiplicity, Scalar phi_0);
 
@@ -101,8 +120,18 @@ class PYBIND11_EXPORT HarmonicDihedralForceCompute : public ForceCompute
 
         std::shared_ptr<DihedralData> m_dihedral_data;    //!< Dihedral data to use in computing dihedrals
 
+        #ifdef ENABLE_TBB
+        ThreadBlockForces m_block_forces;    //!< Forces computed by several threads
+        #endif
+
         //! Actually compute the forces
         virtual void computeForces(unsigned int timestep);
+
+        //! The dihedral forces can be added directly to the net force arrays
+        virtual bool supportsNetForceAccumulation() const
+            {
+            return true;
+            }
     };
 
 //! Exports the DihedralForceCompute class to python
@@ -120,7 +120,8 @@ void IntegratorTwoStep::update(unsigned int timestep)
         // b) that forces are calculated correctly, if ghost atom positions are updated every time step
 
         // also updates rigid bodies after ghost updating
-        m_comm->communicate(timestep+1);
+        // without rigid bodies, the ghost update may be completed in computeNetForce()
+        m_comm->communicate(timestep+1, m_composite_forces.empty());
         }
     else
 #endif
@@ -13,6 +13,7 @@
 
 namespace py = pybind11;
 
+#include <algorithm>
 #include <iostream>
 #include <stdexcept>
 
@@ -51,6 +52,8 @@ NeighborList::NeighborList(std::shared_ptr<SystemDefinition> sysdef, Scalar _r_c
     m_last_check_result = false;
     m_rebuild_check_delay = 0;
     m_exclusions_set = false;
+    m_n_interior = 0;
+    m_interior_valid = false;
 
     m_need_reallocate_exlist = false;
 
@@ -365,10 +368,59 @@ void NeighborList::compute(unsigned int timestep)
 
         setLastUpdatedPos();
         m_has_been_updated_once = true;
+        m_interior_valid = false;
         }
     if (m_prof) m_prof->pop();
     }
 
+/*! \param n_interior Number of particles at the front of the returned list that have no ghost neighbors (output)
+    \returns Indices of all local particles, the particles without ghost neighbors first
+
+    Forces on the particles at the front of the list can be computed before the ghost positions are updated. Both
+    parts of the list are in increasing index order. The list is recomputed on the first call after a build.
+*/
+const std::vector<unsigned int>& NeighborList::getInteriorList(unsigned int& n_interior)
+    {
+    if (!m_interior_valid)
+        {
+        ArrayHandle<unsigned int> h_n_neigh(m_n_neigh, access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_nlist(m_nlist, access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_head_list(m_head_list, access_location::host, access_mode::read);
+
+        const unsigned int N = m_pdata->getN();
+        m_interior_list.resize(N);
+
+        // fill the interior particles from the front and the others from the back
+        unsigned int n_front = 0;
+        unsigned int n_back = N;
+        for (unsigned int i = 0; i < N; i++)
+            {
+            const unsigned int head = h_head_list.data[i];
+            bool interior = true;
+            for (unsigned int k = 0; k < h_n_neigh.data[i]; k++)
+                {
+                if (h_nlist.data[head + k] >= N)
+                    {
+                    interior = false;
+                    break;
+                    }
+                }
+
+            if (interior)
+                m_interior_list[n_front++] = i;
+            else
+                m_interior_list[--n_back] = i;
+            }
+        std::reverse(m_interior_list.begin() + n_back, m_interior_list.end());
+
+        m_n_interior = n_front;
+        m_interior_valid = true;
+        }
+
+    n_interior = m_n_interior;
+    return m_interior_list;
+    }
+
 /*! \param num_iters Number of iterations to average for the benchmark
     \returns Milliseconds of execution time per calculation
 
@@ -1705,6 +1757,8 @@ void export_NeighborList(py::module& m)
         .def("estimateNNeigh", &NeighborList::estimateNNeigh)
         .def("getSmallestRebuild", &NeighborList::getSmallestRebuild)
         .def("getNumUpdates", &NeighborList::getNumUpdates)
+        .def("getNumDangerousUpdates", &NeighborList::getNumDangerousUpdates)
+        .def("resetStats", &NeighborList::resetStats)
         .def("getNumExclusions", &NeighborList::getNumExclusions)
         .def("wantExclusions", &NeighborList::wantExclusions)
 #ifdef ENABLE_MPI
@@ -293,6 +293,9 @@ class PYBIND11_EXPORT NeighborList : public Compute
             return m_head_list;
             }
 
+        //! Get the local particles ordered by whether their neighbors include ghost particles
+        const std::vector<unsigned int>& getInteriorList(unsigned int& n_interior);
+
         //! Get the number of exclusions array
         const GlobalArray<unsigned int>& getNExArray()
             {
@@ -480,6 +483,12 @@ class PYBIND11_EXPORT NeighborList : public Compute
             return m_updates + m_forced_updates;
             }
 
+        //! Get the number of dangerous builds since the last call to resetStats
+        unsigned int getNumDangerousUpdates()
+            {
+            return (unsigned int)m_dangerous_updates;
+            }
+
 
 #ifdef ENABLE_MPI
         //! Set the communicator to use
@@ -548,6 +557,10 @@ class PYBIND11_EXPORT NeighborList : public Compute
         Index2D m_ex_list_indexer;             //!< Indexer for accessing the exclusion list
         Index2D m_ex_list_indexer_tag;         //!< Indexer for accessing the by-tag exclusion list
         bool m_exclusions_set;                 //!< True if any exclusions have been set
+
+        std::vector<unsigned int> m_interior_list; //!< Local particles without ghost neighbors, followed by the others
+        unsigned int m_n_interior;             //!< Number of local particles without ghost neighbors
+        bool m_interior_valid;                 //!< True if m_interior_list is current with the neighbor list
         bool m_need_reallocate_exlist;         //!< True if global exclusion list needs to be reallocated
 
         //! Return true if we are supposed to do a distance check in this time step
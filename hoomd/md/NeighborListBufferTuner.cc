@@ -0,0 +1,242 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file NeighborListBufferTuner.cc
+    \brief Defines the NeighborListBufferTuner class
+*/
+
+#include "NeighborListBufferTuner.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+namespace py = pybind11;
+
+//! Fraction of the search interval between an end and the farther inner point
+static const Scalar golden_ratio = Scalar(0.6180339887498949);
+
+//! Relative slowdown of the time per step that restarts the search
+static const Scalar retune_threshold = Scalar(0.1);
+
+/*! \param sysdef System definition
+    \param trigger Steps on which to update
+    \param nlist Neighbor list to tune
+    \param min_buffer Lower limit of the buffer
+    \param max_buffer Upper limit of the buffer
+    \param tolerance Width of the search interval at which the search stops
+*/
+NeighborListBufferTuner::NeighborListBufferTuner(std::shared_ptr<SystemDefinition> sysdef,
+                                                 std::shared_ptr<Trigger> trigger,
+                                                 std::shared_ptr<NeighborList> nlist,
+                                                 Scalar min_buffer,
+                                                 Scalar max_buffer,
+                                                 Scalar tolerance)
+    : Tuner(sysdef, trigger), m_nlist(nlist), m_min_buffer(min_buffer), m_max_buffer(max_buffer),
+      m_tolerance(tolerance), m_last_time(0), m_last_timestep(0), m_has_measured(false), m_searching(true),
+      m_lower(min_buffer), m_upper(max_buffer), m_x1(0), m_x2(0), m_f1(-1), m_f2(-1), m_best_time(-1)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing NeighborListBufferTuner" << endl;
+
+    if (min_buffer < Scalar(0.0) || max_buffer <= min_buffer)
+        {
+        m_exec_conf->msg->error() << "tune.NeighborListBuffer: invalid buffer range [" << min_buffer << ", "
+                                  << max_buffer << "]" << endl;
+        throw runtime_error("Error initializing NeighborListBufferTuner");
+        }
+    setTolerance(tolerance);
+
+    startSearch();
+    }
+
+NeighborListBufferTuner::~NeighborListBufferTuner()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying NeighborListBufferTuner" << endl;
+    }
+
+/*! \param min_buffer New lower limit of the buffer
+    Changing the limits restarts the search.
+*/
+void NeighborListBufferTuner::setMinBuffer(Scalar min_buffer)
+    {
+    if (min_buffer < Scalar(0.0) || min_buffer >= m_max_buffer)
+        {
+        m_exec_conf->msg->error() << "tune.NeighborListBuffer: min_buffer must be in [0, max_buffer)" << endl;
+        throw runtime_error("Error setting NeighborListBufferTuner parameters");
+        }
+    m_min_buffer = min_buffer;
+    startSearch();
+    }
+
+/*! \param max_buffer New upper limit of the buffer
+    Changing the limits restarts the search.
+*/
+void NeighborListBufferTuner::setMaxBuffer(Scalar max_buffer)
+    {
+    if (max_buffer <= m_min_buffer)
+        {
+        m_exec_conf->msg->error() << "tune.NeighborListBuffer: max_buffer must be larger than min_buffer" << endl;
+        throw runtime_error("Error setting NeighborListBufferTuner parameters");
+        }
+    m_max_buffer = max_buffer;
+    startSearch();
+    }
+
+/*! \param timestep Current time step
+*/
+void NeighborListBufferTuner::update(unsigned int timestep)
+    {
+    uint64_t now = m_clock.getTime();
+
+    // the first call (and any call after the time step was reset) only starts the clock
+    if (!m_has_measured || timestep <= m_last_timestep)
+        {
+        m_last_time = now;
+        m_last_timestep = timestep;
+        m_has_measured = true;
+        return;
+        }
+
+    Scalar time_per_step = Scalar(double(now - m_last_time) / 1e9 / double(timestep - m_last_timestep));
+
+    #ifdef ENABLE_MPI
+    // the slowest rank determines the time per step, and all ranks must agree on the buffer
+    if (m_pdata->getDomainDecomposition())
+        {
+        MPI_Allreduce(MPI_IN_PLACE, &time_per_step, 1, MPI_HOOMD_SCALAR, MPI_MAX, m_exec_conf->getMPICommunicator());
+        }
+    #endif
+
+    m_exec_conf->msg->notice(6) << "tune.NeighborListBuffer: buffer " << m_nlist->getRBuff() << " took "
+                                << time_per_step << " s per step" << endl;
+
+    if (m_searching)
+        {
+        searchStep(time_per_step);
+        }
+    else
+        {
+        if (m_best_time < Scalar(0.0) || time_per_step < m_best_time)
+            {
+            m_best_time = time_per_step;
+            }
+        else if (time_per_step > (Scalar(1.0) + retune_threshold) * m_best_time)
+            {
+            m_exec_conf->msg->notice(4) << "tune.NeighborListBuffer: time per step increased from " << m_best_time
+                                        << " s to " << time_per_step << " s, restarting the search" << endl;
+            startSearch();
+            }
+        }
+
+    enforceCheckDelay();
+
+    // restart the clock after any changes, so that the next measurement does not include them
+    m_last_time = m_clock.getTime();
+    m_last_timestep = timestep;
+    }
+
+void NeighborListBufferTuner::startSearch()
+    {
+    m_searching = true;
+    m_best_time = Scalar(-1.0);
+    m_lower = m_min_buffer;
+    m_upper = m_max_buffer;
+    m_x1 = m_upper - golden_ratio * (m_upper - m_lower);
+    m_x2 = m_lower + golden_ratio * (m_upper - m_lower);
+    m_f1 = Scalar(-1.0);
+    m_f2 = Scalar(-1.0);
+
+    enforceCheckDelay();
+    setBuffer(m_x1);
+    }
+
+/*! \param time_per_step Time per step measured with the current buffer
+
+    The inner point that has not been measured yet is always the one currently set in the neighbor list.
+*/
+void NeighborListBufferTuner::searchStep(Scalar time_per_step)
+    {
+    if (m_f1 < Scalar(0.0))
+        m_f1 = time_per_step;
+    else
+        m_f2 = time_per_step;
+
+    // measure the other inner point first
+    if (m_f2 < Scalar(0.0))
+        {
+        setBuffer(m_x2);
+        return;
+        }
+    if (m_f1 < Scalar(0.0))
+        {
+        setBuffer(m_x1);
+        return;
+        }
+
+    // discard the part of the interval that cannot contain the minimum
+    if (m_f1 < m_f2)
+        {
+        m_upper = m_x2;
+        m_x2 = m_x1;
+        m_f2 = m_f1;
+        m_x1 = m_upper - golden_ratio * (m_upper - m_lower);
+        m_f1 = Scalar(-1.0);
+        }
+    else
+        {
+        m_lower = m_x1;
+        m_x1 = m_x2;
+        m_f1 = m_f2;
+        m_x2 = m_lower + golden_ratio * (m_upper - m_lower);
+        m_f2 = Scalar(-1.0);
+        }
+
+    if (m_upper - m_lower < m_tolerance)
+        {
+        m_searching = false;
+        Scalar buffer = Scalar(0.5) * (m_lower + m_upper);
+        m_exec_conf->msg->notice(3) << "tune.NeighborListBuffer: tuned buffer to " << buffer << endl;
+        setBuffer(buffer);
+        }
+    else
+        {
+        setBuffer(m_f1 < Scalar(0.0) ? m_x1 : m_x2);
+        }
+    }
+
+/*! Distance checks on every step cannot produce dangerous builds. Any longer delay relies on the particles moving
+    less than half of the buffer between checks, which no measurement of past rebuilds can guarantee.
+*/
+void NeighborListBufferTuner::enforceCheckDelay()
+    {
+    if (m_nlist->getRebuildCheckDelay() != 1)
+        {
+        m_exec_conf->msg->notice(4) << "tune.NeighborListBuffer: setting the rebuild check delay to 1" << endl;
+        m_nlist->setRebuildCheckDelay(1);
+        }
+    }
+
+/*! \param buffer Buffer to set
+*/
+void NeighborListBufferTuner::setBuffer(Scalar buffer)
+    {
+    m_nlist->setRBuff(buffer);
+    }
+
+void export_NeighborListBufferTuner(py::module& m)
+    {
+    py::class_<NeighborListBufferTuner, Tuner, std::shared_ptr<NeighborListBufferTuner> >(m, "NeighborListBufferTuner")
+    .def(py::init< std::shared_ptr<SystemDefinition>,
+                   std::shared_ptr<Trigger>,
+                   std::shared_ptr<NeighborList>,
+                   Scalar,
+                   Scalar,
+                   Scalar >())
+    .def_property("min_buffer", &NeighborListBufferTuner::getMinBuffer, &NeighborListBufferTuner::setMinBuffer)
+    .def_property("max_buffer", &NeighborListBufferTuner::getMaxBuffer, &NeighborListBufferTuner::setMaxBuffer)
+    .def_property("tolerance", &NeighborListBufferTuner::getTolerance, &NeighborListBufferTuner::setTolerance)
+    .def_property_readonly("tuned", &NeighborListBufferTuner::isTuned)
+    .def_property_readonly("best_time_per_step", &NeighborListBufferTuner::getBestTimePerStep)
+    ;
+    }
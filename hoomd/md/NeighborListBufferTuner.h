@@ -0,0 +1,143 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file NeighborListBufferTuner.h
+    \brief Declares the NeighborListBufferTuner class
+*/
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#include "NeighborList.h"
+#include "hoomd/Tuner.h"
+#include "hoomd/ClockSource.h"
+
+#include <memory>
+#include <pybind11/pybind11.h>
+
+#ifndef __NEIGHBORLISTBUFFERTUNER_H__
+#define __NEIGHBORLISTBUFFERTUNER_H__
+
+//! Tunes the neighbor list buffer for the fastest simulation
+/*! A larger buffer makes the neighbor list and the pair force computations more expensive, but the neighbor list
+    needs to be rebuilt less often. NeighborListBufferTuner finds the buffer that minimizes the measured wall clock
+    time per step, which includes the neighbor list builds and all force computations.
+
+    Each call to update() measures the average time per step since the previous call, using the buffer set at that
+    call. The buffer is searched for between a minimum and a maximum value with a golden section search, one
+    measurement per call. Once the search interval is narrower than the tolerance, the buffer is set to the middle of
+    the interval and the tuner is considered tuned. While tuned, the time per step is monitored and the search is
+    restarted when it becomes more than 10% slower than the best time observed since the search finished. This
+    follows slow changes of the optimum, such as the density changes in a compression run.
+
+    The rebuild check delay is kept at 1, so that every step is checked and no dangerous builds occur. A longer delay
+    saves only the distance checks, which are cheap compared to the builds, and would rely on the particles never
+    moving faster than observed before.
+
+    In MPI simulations, the time per step is the maximum over all ranks, so all ranks make the same decisions.
+
+    \ingroup tuners
+*/
+class PYBIND11_EXPORT NeighborListBufferTuner : public Tuner
+    {
+    public:
+        //! Constructor
+        NeighborListBufferTuner(std::shared_ptr<SystemDefinition> sysdef,
+                                std::shared_ptr<Trigger> trigger,
+                                std::shared_ptr<NeighborList> nlist,
+                                Scalar min_buffer,
+                                Scalar max_buffer,
+                                Scalar tolerance);
+
+        //! Destructor
+        virtual ~NeighborListBufferTuner();
+
+        //! Measure the time per step and adjust the buffer
+        virtual void update(unsigned int timestep);
+
+        //! Set the minimum buffer
+        void setMinBuffer(Scalar min_buffer);
+
+        //! Get the minimum buffer
+        Scalar getMinBuffer()
+            {
+            return m_min_buffer;
+            }
+
+        //! Set the maximum buffer
+        void setMaxBuffer(Scalar max_buffer);
+
+        //! Get the maximum buffer
+        Scalar getMaxBuffer()
+            {
+            return m_max_buffer;
+            }
+
+        //! Set the tolerance
+        void setTolerance(Scalar tolerance)
+            {
+            if (tolerance <= Scalar(0.0))
+                {
+                m_exec_conf->msg->error() << "tune.NeighborListBuffer: tolerance must be positive" << std::endl;
+                throw std::runtime_error("Error setting NeighborListBufferTuner parameters");
+                }
+            m_tolerance = tolerance;
+            }
+
+        //! Get the tolerance
+        Scalar getTolerance()
+            {
+            return m_tolerance;
+            }
+
+        //! Check if the buffer is tuned
+        bool isTuned()
+            {
+            return !m_searching;
+            }
+
+        //! Get the best time per step (in seconds) observed since the search finished
+        Scalar getBestTimePerStep()
+            {
+            return m_best_time;
+            }
+
+    protected:
+        std::shared_ptr<NeighborList> m_nlist;  //!< The neighbor list to tune
+        Scalar m_min_buffer;                    //!< Lower limit of the buffer
+        Scalar m_max_buffer;                    //!< Upper limit of the buffer
+        Scalar m_tolerance;                     //!< Width of the search interval at which the search stops
+
+        ClockSource m_clock;                    //!< Wall clock
+        uint64_t m_last_time;                   //!< Wall clock time at the last update
+        unsigned int m_last_timestep;           //!< Time step of the last update
+        bool m_has_measured;                    //!< True when m_last_time and m_last_timestep are valid
+
+        bool m_searching;                       //!< True while the golden section search is running
+        Scalar m_lower;                         //!< Lower end of the search interval
+        Scalar m_upper;                         //!< Upper end of the search interval
+        Scalar m_x1;                            //!< Inner point closer to m_lower
+        Scalar m_x2;                            //!< Inner point closer to m_upper
+        Scalar m_f1;                            //!< Time per step at m_x1 (negative if not measured yet)
+        Scalar m_f2;                            //!< Time per step at m_x2 (negative if not measured yet)
+        Scalar m_best_time;                     //!< Best time per step since the search finished
+
+        //! Restart the search over the full range of buffers
+        void startSearch();
+
+        //! Record the time per step of the buffer under evaluation and pick the next one
+        void searchStep(Scalar time_per_step);
+
+        //! Set the rebuild check delay to 1
+        void enforceCheckDelay();
+
+        //! Set a new buffer
+        void setBuffer(Scalar buffer);
+    };
+
+//! Exports NeighborListBufferTuner to python
+void export_NeighborListBufferTuner(pybind11::module& m);
+
+#endif // __NEIGHBORLISTBUFFERTUNER_H__
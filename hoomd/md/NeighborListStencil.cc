@@ -47,6 +47,7 @@ NeighborListStencil::NeighborListStencil(std::shared_ptr<SystemDefinition> sysde
     m_cl->setComputeTDB(true);
     m_cl->setFlagIndex();
     m_cl->setComputeAdjList(false);
+    m_cl->setCompact(true);
 
     // cell sizes need update by default
     m_update_cell_size = true;
@@ -160,7 +161,8 @@ void NeighborListStencil::buildNlist(unsigned int timestep)
 
     // access indexers
     Index3D ci = m_cl->getCellIndexer();
-    Index2D cli = m_cl->getCellListIndexer();
+    ArrayHandle<unsigned int> h_cell_start(m_cl->getCellStartArray(), access_location::host, access_mode::read);
+    CellListMemberIndexer cli(m_cl->getCellListIndexer(), m_cl->getCompact() ? h_cell_start.data : NULL);
 
     // for each local particle
     unsigned int nparticles = m_pdata->getN();
@@ -17,6 +17,11 @@ namespace py = pybind11;
 #include "hoomd/Communicator.h"
 #endif
 
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
+
 using namespace std;
 using namespace hpmc::detail;
 
@@ -24,7 +29,8 @@ NeighborListTree::NeighborListTree(std::shared_ptr<SystemDefinition> sysdef,
                                        Scalar r_cut,
                                        Scalar r_buff)
     : NeighborList(sysdef, r_cut, r_buff), m_box_changed(true), m_max_num_changed(true), m_remap_particles(true),
-      m_type_changed(true), m_n_images(0)
+      m_type_changed(true), m_incremental(false), m_tree_valid(false), m_n_tree_particles(0), m_n_escaped(0),
+      m_n_images(0)
     {
     m_exec_conf->msg->notice(5) << "Constructing NeighborListTree" << endl;
 
@@ -63,6 +69,7 @@ void NeighborListTree::setupTree()
         m_map_pid_tree.resize(m_pdata->getMaxN());
 
         m_max_num_changed = false;
+        m_tree_valid = false;
         }
 
     if (m_type_changed)
@@ -73,6 +80,10 @@ void NeighborListTree::setupTree()
         m_aabb_trees.clear();
         m_aabb_trees.resize(m_pdata->getNTypes());
 
+        // the traversal tests the children of four nodes at once
+        for (auto& tree : m_aabb_trees)
+            tree.setWideNodes(true);
+
         m_num_per_type.resize(m_pdata->getNTypes(), 0);
         m_type_head.resize(m_pdata->getNTypes(), 0);
 
@@ -85,12 +96,14 @@ void NeighborListTree::setupTree()
         {
         mapParticlesByType();
         m_remap_particles = false;
+        m_tree_valid = false;
         }
 
     if (m_box_changed)
         {
         updateImageVectors();
         m_box_changed = false;
+        m_tree_valid = false;
         }
     }
 
@@ -190,6 +203,9 @@ void NeighborListTree::updateImageVectors()
 
 /*!
  * \note AABBTree implements its own build routine, so this is a wrapper to call this for multiple tree types.
+ *
+ * In incremental mode, the existing trees are refit to the new particle positions when possible, and only rebuilt
+ * once too many particles have left their leaves.
  */
 void NeighborListTree::buildTree()
     {
@@ -211,8 +227,15 @@ void NeighborListTree::buildTree()
         ghost_width.z = ghost_layer_width;
         }
 
+    // refit the trees built at the last update if the particles in them have not changed
+    const unsigned int n_local = m_pdata->getN()+m_pdata->getNGhosts();
+    bool refit = m_incremental && m_tree_valid && n_local == m_n_tree_particles;
+    #ifdef ENABLE_MPI
+    if (m_comm) refit = false;
+    #endif
+
     // construct a point AABB for each particle owned by this rank, and push it into the right spot in the AABB list
-    for (unsigned int i=0; i < m_pdata->getN()+m_pdata->getNGhosts(); ++i)
+    for (unsigned int i=0; i < n_local; ++i)
         {
         // make a point particle AABB
         vec3<Scalar> my_pos(h_postype.data[i]);
@@ -238,24 +261,59 @@ void NeighborListTree::buildTree()
         unsigned int my_type = __scalar_as_int(h_postype.data[i].w);
         unsigned int my_aabb_idx = m_type_head[my_type] + m_map_pid_tree[i];
         h_aabbs.data[my_aabb_idx] = AABB(my_pos,i);
+
+        // grow the leaf of a particle that has moved out of it
+        if (refit && m_aabb_trees[my_type].update(m_map_pid_tree[i], h_aabbs.data[my_aabb_idx]))
+            ++m_n_escaped;
+        }
+
+    // the refit trees are used until more than 10% of the particles have escaped their original leaves
+    if (refit && 10*(size_t)m_n_escaped <= (size_t)n_local)
+        {
+        if (this->m_prof) this->m_prof->pop();
+        return;
         }
 
     // call the tree build routine, one tree per type
-    for (unsigned int i=0; i < m_pdata->getNTypes(); ++i)
+    const unsigned int n_types = m_pdata->getNTypes();
+    auto build_types = [&](unsigned int first, unsigned int last)
         {
-        if (m_num_per_type[i] > 0)
+        for (unsigned int i=first; i < last; ++i)
             {
-            m_aabb_trees[i].buildTree(&(h_aabbs.data[0]) + m_type_head[i], m_num_per_type[i]);
+            if (m_num_per_type[i] > 0)
+                {
+                m_aabb_trees[i].buildTree(&(h_aabbs.data[0]) + m_type_head[i], m_num_per_type[i]);
+                }
             }
+        };
+
+    #ifdef ENABLE_TBB
+    if (m_exec_conf->getNumThreads() > 1 && n_types > 1)
+        {
+        // the trees of different types are independent
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_types, 1),
+            [&](const tbb::blocked_range<unsigned int>& r)
+            {
+            build_types(r.begin(), r.end());
+            });
         }
+    else
+    #endif
+        {
+        build_types(0, n_types);
+        }
+
+    m_tree_valid = true;
+    m_n_tree_particles = n_local;
+    m_n_escaped = 0;
+
     if (this->m_prof) this->m_prof->pop();
     }
 
 /*!
- * Each AABBTree is traversed in a stackless fashion. One traversal is performed (per particle)-(per tree)-(per image).
- * The stackless traversal is a variation on left descent, where each node knows how far ahead to advance in the list
- * of nodes if there is no intersection between the current node AABB and the query AABB. Otherwise, the search advances
- * by one to the next node in the list.
+ * One traversal of an AABBTree is performed (per particle)-(per tree)-(per image). The trees are built with a wide
+ * view, so AABBTree::traverse() tests the query AABB against the children of a 4-wide node at once with SSE/AVX and
+ * visits every overlapping leaf node.
  */
 void NeighborListTree::traverseTree()
     {
@@ -275,113 +333,136 @@ void NeighborListTree::traverseTree()
     ArrayHandle<unsigned int> h_nlist(m_nlist, access_location::host, access_mode::overwrite);
     ArrayHandle<unsigned int> h_n_neigh(m_n_neigh, access_location::host, access_mode::overwrite);
 
-    // Loop over all particles
-    for (unsigned int i=0; i < m_pdata->getN(); ++i)
+    // each particle only writes into its own segment of the list starting at its head index, so any range of
+    // particles can be processed independently. Overflows are recorded in the per-type array cur_conditions.
+    auto traverse_range = [&](unsigned int first, unsigned int last, unsigned int *cur_conditions)
         {
-        // read in the current position and orientation
-        const Scalar4 postype_i = h_postype.data[i];
-        const vec3<Scalar> pos_i = vec3<Scalar>(postype_i);
-        const unsigned int type_i = __scalar_as_int(postype_i.w);
-        const unsigned int body_i = h_body.data[i];
-        const Scalar diam_i = h_diameter.data[i];
-
-        const unsigned int Nmax_i = h_Nmax.data[type_i];
-        const unsigned int nlist_head_i = h_head_list.data[i];
-
-        unsigned int n_neigh_i = 0;
-        for (unsigned int cur_pair_type=0; cur_pair_type < m_pdata->getNTypes(); ++cur_pair_type) // loop on pair types
+        // Loop over all particles
+        for (unsigned int i=first; i < last; ++i)
             {
-            // pass on empty types
-            if (!m_num_per_type[cur_pair_type])
-                continue;
+            // read in the current position and orientation
+            const Scalar4 postype_i = h_postype.data[i];
+            const vec3<Scalar> pos_i = vec3<Scalar>(postype_i);
+            const unsigned int type_i = __scalar_as_int(postype_i.w);
+            const unsigned int body_i = h_body.data[i];
+            const Scalar diam_i = h_diameter.data[i];
+
+            const unsigned int Nmax_i = h_Nmax.data[type_i];
+            const unsigned int nlist_head_i = h_head_list.data[i];
+
+            unsigned int n_neigh_i = 0;
+            for (unsigned int cur_pair_type=0; cur_pair_type < m_pdata->getNTypes(); ++cur_pair_type) // loop on pair types
+                {
+                // pass on empty types
+                if (!m_num_per_type[cur_pair_type])
+                    continue;
 
-            // Check if this tree type should be excluded by r_cut(i,j) <= 0.0
-            Scalar r_cut = h_r_cut.data[m_typpair_idx(type_i,cur_pair_type)];
-            if (r_cut <= Scalar(0.0))
-                continue;
+                // Check if this tree type should be excluded by r_cut(i,j) <= 0.0
+                Scalar r_cut = h_r_cut.data[m_typpair_idx(type_i,cur_pair_type)];
+                if (r_cut <= Scalar(0.0))
+                    continue;
 
-            // Determine the minimum r_cut_i (no diameter shifting, with buffer) for this particle
-            Scalar r_cut_i = r_cut + m_r_buff;
+                // Determine the minimum r_cut_i (no diameter shifting, with buffer) for this particle
+                Scalar r_cut_i = r_cut + m_r_buff;
 
-            // we save the r_cutsq before diameter shifting, as we will shift later, and reuse the r_cut_i now
-            Scalar r_cutsq_i = r_cut_i*r_cut_i;
+                // we save the r_cutsq before diameter shifting, as we will shift later, and reuse the r_cut_i now
+                Scalar r_cutsq_i = r_cut_i*r_cut_i;
 
-            // the rlist to use for the AABB search has to be at least as big as the biggest diameter
-            Scalar r_list_i = r_cut_i;
-            if (m_diameter_shift)
-                r_list_i += m_d_max - Scalar(1.0);
+                // the rlist to use for the AABB search has to be at least as big as the biggest diameter
+                Scalar r_list_i = r_cut_i;
+                if (m_diameter_shift)
+                    r_list_i += m_d_max - Scalar(1.0);
 
-            AABBTree *cur_aabb_tree = &m_aabb_trees[cur_pair_type];
+                AABBTree *cur_aabb_tree = &m_aabb_trees[cur_pair_type];
 
-            for (unsigned int cur_image = 0; cur_image < m_n_images; ++cur_image) // for each image vector
-                {
-                // make an AABB for the image of this particle
-                vec3<Scalar> pos_i_image = pos_i + m_image_list[cur_image];
-                AABB aabb = AABB(pos_i_image, r_list_i);
-
-                // stackless traversal of the tree
-                for (unsigned int cur_node_idx = 0; cur_node_idx < cur_aabb_tree->getNumNodes(); ++cur_node_idx)
+                for (unsigned int cur_image = 0; cur_image < m_n_images; ++cur_image) // for each image vector
                     {
-                    if (overlap(cur_aabb_tree->getNodeAABB(cur_node_idx), aabb))
+                    // make an AABB for the image of this particle
+                    vec3<Scalar> pos_i_image = pos_i + m_image_list[cur_image];
+                    AABB aabb = AABB(pos_i_image, r_list_i);
+
+                    // traversal of the tree, visiting each leaf node that overlaps the query AABB
+                    cur_aabb_tree->traverse(aabb, [&](unsigned int cur_node_idx)
                         {
-                        if (cur_aabb_tree->isNodeLeaf(cur_node_idx))
+                        for (unsigned int cur_p = 0; cur_p < cur_aabb_tree->getNodeNumParticles(cur_node_idx); ++cur_p)
                             {
-                            for (unsigned int cur_p = 0; cur_p < cur_aabb_tree->getNodeNumParticles(cur_node_idx); ++cur_p)
-                                {
-                                // neighbor j
-                                unsigned int j = cur_aabb_tree->getNodeParticleTag(cur_node_idx, cur_p);
+                            // neighbor j
+                            unsigned int j = cur_aabb_tree->getNodeParticleTag(cur_node_idx, cur_p);
 
-                                // skip self-interaction always
-                                bool excluded = (i == j);
+                            // skip self-interaction always
+                            bool excluded = (i == j);
 
-                                if (m_filter_body && body_i != NO_BODY)
-                                    excluded = excluded | (body_i == h_body.data[j]);
+                            if (m_filter_body && body_i != NO_BODY)
+                                excluded = excluded | (body_i == h_body.data[j]);
 
-                                if (!excluded)
+                            if (!excluded)
+                                {
+                                // now we can trim down the actual particles based on diameter
+                                // compute the shift for the cutoff if not excluded
+                                Scalar sqshift = Scalar(0.0);
+                                if (m_diameter_shift)
                                     {
-                                    // now we can trim down the actual particles based on diameter
-                                    // compute the shift for the cutoff if not excluded
-                                    Scalar sqshift = Scalar(0.0);
-                                    if (m_diameter_shift)
-                                        {
-                                        const Scalar delta = (diam_i + h_diameter.data[j]) * Scalar(0.5) - Scalar(1.0);
-                                        // r^2 < (r_list + delta)^2
-                                        // r^2 < r_listsq + delta^2 + 2*r_list*delta
-                                        sqshift = (delta + Scalar(2.0) * r_cut_i) * delta;
-                                        }
+                                    const Scalar delta = (diam_i + h_diameter.data[j]) * Scalar(0.5) - Scalar(1.0);
+                                    // r^2 < (r_list + delta)^2
+                                    // r^2 < r_listsq + delta^2 + 2*r_list*delta
+                                    sqshift = (delta + Scalar(2.0) * r_cut_i) * delta;
+                                    }
 
-                                    // compute distance
-                                    Scalar4 postype_j = h_postype.data[j];
-                                    Scalar3 drij = make_scalar3(postype_j.x,postype_j.y,postype_j.z)
-                                                   - vec_to_scalar3(pos_i_image);
-                                    Scalar dr_sq = dot(drij,drij);
+                                // compute distance
+                                Scalar4 postype_j = h_postype.data[j];
+                                Scalar3 drij = make_scalar3(postype_j.x,postype_j.y,postype_j.z)
+                                               - vec_to_scalar3(pos_i_image);
+                                Scalar dr_sq = dot(drij,drij);
 
-                                    if (dr_sq <= (r_cutsq_i + sqshift))
+                                if (dr_sq <= (r_cutsq_i + sqshift))
+                                    {
+                                    if (m_storage_mode == full || i < j)
                                         {
-                                        if (m_storage_mode == full || i < j)
-                                            {
-                                            if (n_neigh_i < Nmax_i)
-                                                h_nlist.data[nlist_head_i + n_neigh_i] = j;
-                                            else
-                                                h_conditions.data[type_i] = max(h_conditions.data[type_i], n_neigh_i+1);
-
-                                            ++n_neigh_i;
-                                            }
+                                        if (n_neigh_i < Nmax_i)
+                                            h_nlist.data[nlist_head_i + n_neigh_i] = j;
+                                        else
+                                            cur_conditions[type_i] = max(cur_conditions[type_i], n_neigh_i+1);
+
+                                        ++n_neigh_i;
                                         }
                                     }
                                 }
                             }
-                        }
-                    else
-                        {
-                        // skip ahead
-                        cur_node_idx += cur_aabb_tree->getNodeSkip(cur_node_idx);
-                        }
-                    } // end stackless search
-                } // end loop over images
-            } // end loop over pair types
-            h_n_neigh.data[i] = n_neigh_i;
-        } // end loop over particles
+                        }); // end traversal
+                    } // end loop over images
+                } // end loop over pair types
+                h_n_neigh.data[i] = n_neigh_i;
+            } // end loop over particles
+        };
+
+    const unsigned int nparticles = m_pdata->getN();
+
+    #ifdef ENABLE_TBB
+    const unsigned int n_blocks = m_exec_conf->getNumThreads();
+    if (n_blocks > 1 && nparticles > n_blocks)
+        {
+        // one block of particles and one private copy of the overflow conditions per thread
+        const unsigned int n_types = m_pdata->getNTypes();
+        std::vector<unsigned int> block_conditions((size_t)n_blocks*n_types, 0);
+        auto block_begin = [nparticles, n_blocks](unsigned int b)
+            { return (unsigned int)(((size_t)nparticles*b)/n_blocks); };
+
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_blocks, 1),
+            [&](const tbb::blocked_range<unsigned int>& r)
+            {
+            for (unsigned int b = r.begin(); b != r.end(); ++b)
+                traverse_range(block_begin(b), block_begin(b+1), &block_conditions[(size_t)b*n_types]);
+            });
+
+        for (unsigned int b = 0; b < n_blocks; ++b)
+            for (unsigned int t = 0; t < n_types; ++t)
+                h_conditions.data[t] = max(h_conditions.data[t], block_conditions[(size_t)b*n_types + t]);
+        }
+    else
+    #endif
+        {
+        traverse_range(0, nparticles, h_conditions.data);
+        }
 
     if (this->m_prof) this->m_prof->pop();
     }
@@ -390,5 +471,6 @@ void export_NeighborListTree(py::module& m)
     {
     py::class_<NeighborListTree, NeighborList, std::shared_ptr<NeighborListTree> >(m, "NeighborListTree")
     .def(py::init< std::shared_ptr<SystemDefinition>, Scalar, Scalar >())
+    .def_property("incremental", &NeighborListTree::getIncremental, &NeighborListTree::setIncremental)
                      ;
     }
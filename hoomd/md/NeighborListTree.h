@@ -25,7 +25,7 @@
 /*!
  * A bounding volume hierarchy (BVH) tree is a binary search tree. It is constructed from axis-aligned bounding boxes
  * (AABBs). The AABB for a node in the tree encloses all child AABBs. A leaf AABB holds multiple particles. The tree
- * is constructed in a balanced way using a heuristic to minimize AABB volume. We build one tree per particle type,
+ * is constructed from the Morton order of the particles (see AABBTree). We build one tree per particle type,
  * and use point AABBs for the particles. The neighbor list is built by traversing down the tree with an AABB
  * that encloses the pairwise cutoff for the particle. Periodic boundaries are treated by translating the query AABB
  * by all possible image vectors, many of which are trivially rejected for not intersecting the root node.
@@ -35,6 +35,18 @@
  * Any class directly modifying the types of particles \b must signal this change to NeighborListTree using
  * notifyParticleSort().
  *
+ * In incremental mode, the trees are not rebuilt from scratch on every neighbor list update. Instead, the point AABB
+ * of each particle is refit into the leaf it was assigned to at the last full build with AABBTree::update(), which
+ * only touches the leaves (and their parents) of particles that have left them. Refitting keeps the topology of the
+ * tree, so it becomes less efficient to traverse as particles diffuse. A full build is performed whenever more than
+ * 10% of the particles have escaped their leaves since the last full build, and after any particle sort, box change
+ * or change in the number of particles. Incremental mode is ignored in MPI simulations, because the set of ghost
+ * particles changes on every update.
+ *
+ * When TBB is enabled, the trees for different types are built concurrently and the traversal is split into one
+ * block of particles per thread. Each particle writes only into its own segment of the neighbor list (starting at
+ * its entry in the head list), so no synchronization is needed between blocks.
+ *
  * \ingroup computes
  */
 class PYBIND11_EXPORT NeighborListTree : public NeighborList
@@ -48,6 +60,18 @@ class PYBIND11_EXPORT NeighborListTree : public NeighborList
         //! Destructor
         virtual ~NeighborListTree();
 
+        //! Enable or disable incremental tree updates
+        void setIncremental(bool incremental)
+            {
+            m_incremental = incremental;
+            }
+
+        //! Get the incremental flag
+        bool getIncremental()
+            {
+            return m_incremental;
+            }
+
     protected:
         //! Builds the neighbor list
         virtual void buildNlist(unsigned int timestep);
@@ -82,6 +106,11 @@ class PYBIND11_EXPORT NeighborListTree : public NeighborList
         bool m_remap_particles;                             //!< Flag if the particles need to remapped (triggered by sort)
         bool m_type_changed;                                //!< Flag if the number of types has changed
 
+        bool m_incremental;                                 //!< Flag to refit the trees instead of rebuilding them
+        bool m_tree_valid;                                  //!< Flag if the trees can be refit
+        unsigned int m_n_tree_particles;                    //!< Number of particles in the trees at the last full build
+        unsigned int m_n_escaped;                           //!< Number of leaf escapes since the last full build
+
         // we use stl vectors here because these tree data structures should *never* be
         // accessed on the GPU, they were optimized for the CPU with SIMD support
         std::vector<hpmc::detail::AABBTree>      m_aabb_trees;     //!< Flat array of AABB trees of all types
@@ -4,6 +4,11 @@
 #include "PPPMForceCompute.h"
 #include <map>
 
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
+
 namespace py = pybind11;
 
 bool is_pow2(unsigned int n)
@@ -37,6 +42,8 @@ PPPMForceCompute::PPPMForceCompute(std::shared_ptr<SystemDefinition> sysdef,
       m_n_cells(0),
       m_radius(1),
       m_n_inner_cells(0),
+      m_n_fourier_cells(0),
+      m_ad(false),
       m_need_initialize(true),
       m_params_set(false),
       m_box_changed(false),
@@ -62,6 +69,9 @@ PPPMForceCompute::PPPMForceCompute(std::shared_ptr<SystemDefinition> sysdef,
     m_order = 0;
     m_alpha = Scalar(0.0);
 
+    for (unsigned int i = 0; i < 6; ++i)
+        m_sf_coeff[i] = Scalar(0.0);
+
     m_pdata->getGlobalParticleNumberChangeSignal().connect<PPPMForceCompute, &PPPMForceCompute::slotGlobalParticleNumberChange>(this);
     }
 
@@ -141,16 +151,23 @@ void PPPMForceCompute::setParams(unsigned int nx, unsigned int ny, unsigned int
     m_params_set = true;
     }
 
+/*! \param ad True to compute forces with analytical differentiation, false for ik differentiation
+ */
+void PPPMForceCompute::setAnalyticalDifferentiation(bool ad)
+    {
+    if (ad != m_ad)
+        {
+        m_ad = ad;
+
+        // the influence function and the meshes depend on the scheme
+        m_need_initialize = true;
+        }
+    }
+
 PPPMForceCompute::~PPPMForceCompute()
     {
     m_pdata->getGlobalParticleNumberChangeSignal().disconnect<PPPMForceCompute, &PPPMForceCompute::slotGlobalParticleNumberChange>(this);
 
-    if (m_kiss_fft_initialized)
-        {
-        free(m_kiss_fft);
-        free(m_kiss_ifft);
-        kiss_fft_cleanup();
-        }
     #ifdef ENABLE_MPI
     if (m_dfft_initialized)
         {
@@ -380,17 +397,20 @@ void PPPMForceCompute::setupMesh()
     m_n_cells = m_grid_dim.x*m_grid_dim.y*m_grid_dim.z;
     m_n_inner_cells = m_mesh_points.x * m_mesh_points.y * m_mesh_points.z;
 
+    // initializeFFT() reduces this number if the FFT only stores half of the Fourier coefficients
+    m_n_fourier_cells = m_n_inner_cells;
+
+    initializeFFT();
+
     // allocate memory for influence function and k values
-    GlobalArray<Scalar> inf_f(m_n_inner_cells, m_exec_conf);
+    GlobalArray<Scalar> inf_f(m_n_fourier_cells, m_exec_conf);
     m_inf_f.swap(inf_f);
 
-    GlobalArray<Scalar3> k(m_n_inner_cells, m_exec_conf);
+    GlobalArray<Scalar3> k(m_n_fourier_cells, m_exec_conf);
     m_k.swap(k);
 
-    GlobalArray<Scalar> virial_mesh(6*m_n_inner_cells, m_exec_conf);
+    GlobalArray<Scalar> virial_mesh(6*m_n_fourier_cells, m_exec_conf);
     m_virial_mesh.swap(virial_mesh);
-
-    initializeFFT();
     }
 
 uint3 PPPMForceCompute::computeGhostCellNum()
@@ -481,45 +501,60 @@ void PPPMForceCompute::initializeFFT()
 
     if (local_fft)
         {
-        int dims[3];
-        dims[0] = m_mesh_points.z;
-        dims[1] = m_mesh_points.y;
-        dims[2] = m_mesh_points.x;
-
-        m_kiss_fft = kiss_fftnd_alloc(dims, 3, 0, NULL, NULL);
-        m_kiss_ifft = kiss_fftnd_alloc(dims, 3, 1, NULL, NULL);
+        // the meshes are real, only store the non-negative x frequencies of their transforms
+        m_real_fft = std::unique_ptr<RealFFT3D>(new RealFFT3D(m_mesh_points.x,
+                                                              m_mesh_points.y,
+                                                              m_mesh_points.z,
+                                                              m_exec_conf->getNumThreads()));
+        m_n_fourier_cells = m_real_fft->getNumComplex();
 
         m_kiss_fft_initialized = true;
         }
 
     // allocate mesh and transformed mesh
 
-    // pad with offset
-    GlobalArray<kiss_fft_cpx> mesh(m_n_cells + m_ghost_offset,m_exec_conf);
+    // real space meshes of the local FFT hold one kiss_fft_scalar per cell
+    unsigned int n_mesh_elements = m_n_cells + m_ghost_offset;
+    if (local_fft)
+        n_mesh_elements = (n_mesh_elements + 1)/2;
+
+    GlobalArray<kiss_fft_cpx> mesh(n_mesh_elements, m_exec_conf);
     m_mesh.swap(mesh);
 
-    GlobalArray<kiss_fft_cpx> fourier_mesh(m_n_inner_cells, m_exec_conf);
+    GlobalArray<kiss_fft_cpx> fourier_mesh(m_n_fourier_cells, m_exec_conf);
     m_fourier_mesh.swap(fourier_mesh);
 
-    GlobalArray<kiss_fft_cpx> fourier_mesh_G_x(m_n_inner_cells, m_exec_conf);
+    // ik differentiation needs three components of the field, ad only the potential
+    unsigned int n_fourier_ik = m_ad ? 0 : m_n_fourier_cells;
+    unsigned int n_mesh_ik = m_ad ? 0 : n_mesh_elements;
+    unsigned int n_fourier_ad = m_ad ? m_n_fourier_cells : 0;
+    unsigned int n_mesh_ad = m_ad ? n_mesh_elements : 0;
+
+    GlobalArray<kiss_fft_cpx> fourier_mesh_G_x(n_fourier_ik, m_exec_conf);
     m_fourier_mesh_G_x.swap(fourier_mesh_G_x);
 
-    GlobalArray<kiss_fft_cpx> fourier_mesh_G_y(m_n_inner_cells, m_exec_conf);
+    GlobalArray<kiss_fft_cpx> fourier_mesh_G_y(n_fourier_ik, m_exec_conf);
     m_fourier_mesh_G_y.swap(fourier_mesh_G_y);
 
-    GlobalArray<kiss_fft_cpx> fourier_mesh_G_z(m_n_inner_cells, m_exec_conf);
+    GlobalArray<kiss_fft_cpx> fourier_mesh_G_z(n_fourier_ik, m_exec_conf);
     m_fourier_mesh_G_z.swap(fourier_mesh_G_z);
 
+    GlobalArray<kiss_fft_cpx> fourier_mesh_G(n_fourier_ad, m_exec_conf);
+    m_fourier_mesh_G.swap(fourier_mesh_G);
+
     // pad with offset
 
-    GlobalArray<kiss_fft_cpx> inv_fourier_mesh_x(m_n_cells+m_ghost_offset, m_exec_conf);
+    GlobalArray<kiss_fft_cpx> inv_fourier_mesh_x(n_mesh_ik, m_exec_conf);
     m_inv_fourier_mesh_x.swap(inv_fourier_mesh_x);
 
-    GlobalArray<kiss_fft_cpx> inv_fourier_mesh_y(m_n_cells+m_ghost_offset, m_exec_conf);
+    GlobalArray<kiss_fft_cpx> inv_fourier_mesh_y(n_mesh_ik, m_exec_conf);
     m_inv_fourier_mesh_y.swap(inv_fourier_mesh_y);
 
-    GlobalArray<kiss_fft_cpx> inv_fourier_mesh_z(m_n_cells+m_ghost_offset, m_exec_conf);
+    GlobalArray<kiss_fft_cpx> inv_fourier_mesh_z(n_mesh_ik, m_exec_conf);
     m_inv_fourier_mesh_z.swap(inv_fourier_mesh_z);
+
+    GlobalArray<kiss_fft_cpx> inv_fourier_mesh(n_mesh_ad, m_exec_conf);
+    m_inv_fourier_mesh.swap(inv_fourier_mesh);
     }
 
 //! CPU implementation of sinc(x)==sin(x)/x
@@ -544,16 +579,162 @@ inline Scalar sinc(Scalar x)
     return sinc;
     }
 
+/*! \param n Miller indices of the wave vector
+    \param b Reciprocal lattice vectors
+    \param kH Mesh spacing in units of the reciprocal lattice vectors (times 2 pi)
+    \param nb Number of aliasing images summed along each direction
+    \param k Wave vector (output)
+    \returns The optimized influence function for the current differentiation scheme
+ */
+Scalar PPPMForceCompute::evalInfluenceFunction(int3 n, const Scalar3 *b, Scalar3 kH, int3 nb, Scalar3& k)
+    {
+    k = (Scalar)n.x*b[0]+(Scalar)n.y*b[1]+(Scalar)n.z*b[2];
+
+    if (n.x == 0 && n.y == 0 && n.z == 0)
+        return Scalar(0.0);
+
+    Scalar snx = fast::sin(0.5*kH.x*(Scalar)n.x);
+    Scalar sny = fast::sin(0.5*kH.y*(Scalar)n.y);
+    Scalar snz = fast::sin(0.5*kH.z*(Scalar)n.z);
+
+    Scalar sum1(0.0);
+    Scalar numerator = Scalar(4.0*M_PI)/dot(k,k);
+
+    Scalar denominator = gf_denom(snx*snx, sny*sny, snz*snz);
+
+    for (int ix = -nb.x; ix <= nb.x; ix++)
+        {
+        Scalar qx = ((Scalar)n.x + (Scalar)ix*m_global_dim.x);
+        Scalar3 knx = qx*b[0];
+
+        Scalar argx = Scalar(0.5)*qx*kH.x;
+        Scalar wxs = sinc(argx);
+        Scalar wx(1.0);
+        for (int iorder = 0; iorder < m_order; ++iorder)
+            {
+            wx *= wxs;
+            }
+
+        for (int iy = -nb.y; iy <= nb.y; iy++)
+            {
+            Scalar qy = ((Scalar)n.y + (Scalar)iy*m_global_dim.y);
+            Scalar3 kny = qy*b[1];
+
+            Scalar argy = Scalar(0.5)*qy*kH.y;
+            Scalar wys = sinc(argy);
+            Scalar wy(1.0);
+            for (int iorder = 0; iorder < m_order; ++iorder)
+                {
+                wy *= wys;
+                }
+
+            for (int iz = -nb.z; iz <= nb.z; iz++)
+                {
+                Scalar qz = ((Scalar)n.z + (Scalar)iz*m_global_dim.z);
+                Scalar3 knz = qz*b[2];
+
+                Scalar argz = Scalar(0.5)*qz*kH.z;
+                Scalar wzs = sinc(argz);
+                Scalar wz(1.0);
+                for (int iorder = 0; iorder < m_order; ++iorder)
+                    {
+                    wz *= wzs;
+                    }
+
+                Scalar3 kn = knx + kny + knz;
+                Scalar dot2 = dot(kn, kn)+m_alpha*m_alpha;
+
+                Scalar arg_gauss = Scalar(0.25)*dot2/m_kappa/m_kappa;
+                Scalar gauss = exp(-arg_gauss);
+
+                if (m_ad)
+                    {
+                    // the aliased gradients are not projected onto k with analytical differentiation
+                    sum1 += (Scalar(4.0*M_PI)/dot2) * gauss * wx * wx * wy * wy * wz * wz;
+                    }
+                else
+                    {
+                    Scalar dot1 = dot(kn, k);
+                    sum1 += (dot1/dot2) * gauss * wx * wx * wy * wy * wz * wz;
+                    }
+                }
+            }
+        }
+
+    if (m_ad)
+        return sum1/denominator;
+    else
+        return numerator*sum1/denominator;
+    }
+
+/*! \param n Miller indices of the wave vector
+    \param precoeff Contributions to the self force coefficients (output, six values)
+
+    The self force of a particle at reduced position s along a mesh axis is a Fourier series in s, of which the
+    terms sin(2 pi s) and sin(4 pi s) are kept. Their coefficients are sums over all wave vectors of the influence
+    function times these precoefficients, which are products of the assignment function at the wave vector and at
+    the wave vector shifted by one or two reciprocal mesh vectors along the axis.
+ */
+void PPPMForceCompute::evalSelfForcePrecoeff(int3 n, Scalar *precoeff)
+    {
+    // assignment function along each axis, without shift and with a shift by one or two mesh vectors
+    Scalar w[3][3][5];
+    int n_axis[3] = {n.x, n.y, n.z};
+    unsigned int dim[3] = {m_global_dim.x, m_global_dim.y, m_global_dim.z};
+    for (unsigned int a = 0; a < 3; ++a)
+        {
+        for (int i = 0; i < 5; ++i)
+            {
+            for (int o = 0; o < 3; ++o)
+                {
+                Scalar ws = sinc(Scalar(M_PI)*((Scalar)n_axis[a]/(Scalar)dim[a] + (Scalar)(i-2+o)));
+                w[a][o][i] = Scalar(1.0);
+                for (int iorder = 0; iorder < m_order; ++iorder)
+                    w[a][o][i] *= ws;
+                }
+            }
+        }
+
+    for (unsigned int c = 0; c < 6; ++c)
+        precoeff[c] = Scalar(0.0);
+
+    for (int i = 0; i < 5; ++i)
+        {
+        for (int j = 0; j < 5; ++j)
+            {
+            for (int l = 0; l < 5; ++l)
+                {
+                Scalar u0 = w[0][0][i]*w[1][0][j]*w[2][0][l];
+                precoeff[0] += u0*w[0][1][i]*w[1][0][j]*w[2][0][l];
+                precoeff[1] += u0*w[0][2][i]*w[1][0][j]*w[2][0][l];
+                precoeff[2] += u0*w[0][0][i]*w[1][1][j]*w[2][0][l];
+                precoeff[3] += u0*w[0][0][i]*w[1][2][j]*w[2][0][l];
+                precoeff[4] += u0*w[0][0][i]*w[1][0][j]*w[2][1][l];
+                precoeff[5] += u0*w[0][0][i]*w[1][0][j]*w[2][2][l];
+                }
+            }
+        }
+    }
+
+/*! Without domain decomposition, each stored Fourier coefficient also represents its Hermitian partner at -k
+    (unless it is its own partner). The tables store the sums over both wave vectors:
+    - m_inf_f holds the sum of the influence functions, which multiplies |rho(k)|^2 in the energy
+    - m_k holds the difference of G(k) k and G(-k) (-k) divided by the number of wave vectors, the ik multiplier
+      of the coefficient (the imaginary parts of the two wave vectors cancel in the real field)
+    - m_virial_mesh holds the sums of the virial coefficients
+ */
 void PPPMForceCompute::computeInfluenceFunction()
     {
     if (m_prof) m_prof->push("influence function");
 
     ArrayHandle<Scalar> h_inf_f(m_inf_f,access_location::host, access_mode::overwrite);
     ArrayHandle<Scalar3> h_k(m_k,access_location::host, access_mode::overwrite);
+    ArrayHandle<Scalar> h_virial_mesh(m_virial_mesh, access_location::host, access_mode::overwrite);
 
     // reset arrays
     memset(h_inf_f.data, 0, sizeof(Scalar)*m_inf_f.getNumElements());
     memset(h_k.data, 0, sizeof(Scalar3)*m_k.getNumElements());
+    memset(h_virial_mesh.data, 0, sizeof(Scalar)*m_virial_mesh.getNumElements());
 
     const BoxDim& global_box = m_pdata->getGlobalBox();
 
@@ -563,13 +744,14 @@ void PPPMForceCompute::computeInfluenceFunction()
     Scalar3 a3 = global_box.getLatticeVector(2);
 
     Scalar V_box = global_box.getVolume();
-    Scalar3 b1 = Scalar(2.0*M_PI)*make_scalar3(a2.y*a3.z-a2.z*a3.y, a2.z*a3.x-a2.x*a3.z, a2.x*a3.y-a2.y*a3.x)/V_box;
-    Scalar3 b2 = Scalar(2.0*M_PI)*make_scalar3(a3.y*a1.z-a3.z*a1.y, a3.z*a1.x-a3.x*a1.z, a3.x*a1.y-a3.y*a1.x)/V_box;
-    Scalar3 b3 = Scalar(2.0*M_PI)*make_scalar3(a1.y*a2.z-a1.z*a2.y, a1.z*a2.x-a1.x*a2.z, a1.x*a2.y-a1.y*a2.x)/V_box;
+    Scalar3 b[3];
+    b[0] = Scalar(2.0*M_PI)*make_scalar3(a2.y*a3.z-a2.z*a3.y, a2.z*a3.x-a2.x*a3.z, a2.x*a3.y-a2.y*a3.x)/V_box;
+    b[1] = Scalar(2.0*M_PI)*make_scalar3(a3.y*a1.z-a3.z*a1.y, a3.z*a1.x-a3.x*a1.z, a3.x*a1.y-a3.y*a1.x)/V_box;
+    b[2] = Scalar(2.0*M_PI)*make_scalar3(a1.y*a2.z-a1.z*a2.y, a1.z*a2.x-a1.x*a2.z, a1.x*a2.y-a1.y*a2.x)/V_box;
 
-    #ifdef ENABLE_MPI
     bool local_fft = m_kiss_fft_initialized;
 
+    #ifdef ENABLE_MPI
     uint3 pdim=make_uint3(0,0,0);
     uint3 pidx=make_uint3(0,0,0);
     if (m_pdata->getDomainDecomposition())
@@ -598,7 +780,16 @@ void PPPMForceCompute::computeInfluenceFunction()
                    pow(-log(EPS_HOC),0.25)));
     int nbz = (int)temp;
 
-    for (unsigned int cell_idx = 0; cell_idx < m_n_inner_cells; ++cell_idx)
+    int3 nb = make_int3(nbx, nby, nbz);
+
+    // number of stored frequencies along x
+    unsigned int nx_fourier = local_fft ? m_mesh_points.x/2 + 1 : m_mesh_points.x;
+
+    Scalar sf[6];
+    for (unsigned int i = 0; i < 6; ++i)
+        sf[i] = Scalar(0.0);
+
+    for (unsigned int cell_idx = 0; cell_idx < m_n_fourier_cells; ++cell_idx)
         {
         uint3 wave_idx;
         #ifdef ENABLE_MPI
@@ -619,98 +810,162 @@ void PPPMForceCompute::computeInfluenceFunction()
         #endif
             {
             // kiss FFT expects data in row major format
-            wave_idx.z = cell_idx / (m_mesh_points.y * m_mesh_points.x);
-            wave_idx.y = (cell_idx - wave_idx.z * m_mesh_points.x * m_mesh_points.y)/ m_mesh_points.x;
-            wave_idx.x = cell_idx % m_mesh_points.x;
+            wave_idx.z = cell_idx / (m_mesh_points.y * nx_fourier);
+            wave_idx.y = (cell_idx - wave_idx.z * nx_fourier * m_mesh_points.y)/ nx_fourier;
+            wave_idx.x = cell_idx % nx_fourier;
             }
 
-        int3 n = make_int3(wave_idx.x,wave_idx.y,wave_idx.z);
+        // the wave vector and its Hermitian partner, if that is not stored separately
+        uint3 wave_idx_partner[2];
+        wave_idx_partner[0] = wave_idx;
+        unsigned int n_wave = 1;
+        if (local_fft && wave_idx.x != 0 && 2*wave_idx.x != m_global_dim.x)
+            {
+            wave_idx_partner[1] = make_uint3(m_global_dim.x - wave_idx.x,
+                                             (m_global_dim.y - wave_idx.y) % m_global_dim.y,
+                                             (m_global_dim.z - wave_idx.z) % m_global_dim.z);
+            n_wave = 2;
+            }
 
-        // compute Miller indices
-        if (n.x >= (int)(m_global_dim.x/2 + m_global_dim.x%2))
-            n.x -= (int) m_global_dim.x;
-        if (n.y >= (int)(m_global_dim.y/2 + m_global_dim.y%2))
-            n.y -= (int) m_global_dim.y;
-        if (n.z >= (int)(m_global_dim.z/2 + m_global_dim.z%2))
-            n.z -= (int) m_global_dim.z;
+        Scalar inf_f(0.0);
+        Scalar3 k_inf_f = make_scalar3(0.0,0.0,0.0);
+        Scalar virial[6];
+        for (unsigned int i = 0; i < 6; ++i)
+            virial[i] = Scalar(0.0);
 
-        Scalar3 k = (Scalar)n.x*b1+(Scalar)n.y*b2+(Scalar)n.z*b3;
+        for (unsigned int t = 0; t < n_wave; ++t)
+            {
+            int3 n = make_int3(wave_idx_partner[t].x,wave_idx_partner[t].y,wave_idx_partner[t].z);
 
-        Scalar snx = fast::sin(0.5*kH.x*(Scalar)n.x);
-        Scalar sny = fast::sin(0.5*kH.y*(Scalar)n.y);
-        Scalar snz = fast::sin(0.5*kH.z*(Scalar)n.z);
+            // compute Miller indices
+            if (n.x >= (int)(m_global_dim.x/2 + m_global_dim.x%2))
+                n.x -= (int) m_global_dim.x;
+            if (n.y >= (int)(m_global_dim.y/2 + m_global_dim.y%2))
+                n.y -= (int) m_global_dim.y;
+            if (n.z >= (int)(m_global_dim.z/2 + m_global_dim.z%2))
+                n.z -= (int) m_global_dim.z;
 
-        if (n.x != 0 || n.y != 0 || n.z != 0)
-            {
-            Scalar sum1(0.0);
-            Scalar numerator = Scalar(4.0*M_PI)/dot(k,k);
+            Scalar3 k;
+            Scalar G = evalInfluenceFunction(n, b, kH, nb, k);
 
-            Scalar denominator = gf_denom(snx*snx, sny*sny, snz*snz);
+            if (G == Scalar(0.0))
+                continue;
 
-            for (int ix = -nbx; ix <= nbx; ix++)
-                {
-                Scalar qx = ((Scalar)n.x + (Scalar)ix*m_global_dim.x);
-                Scalar3 knx = qx*b1;
+            inf_f += G;
 
-                Scalar argx = Scalar(0.5)*qx*kH.x;
-                Scalar wxs = sinc(argx);
-                Scalar wx(1.0);
-                for (int iorder = 0; iorder < m_order; ++iorder)
-                    {
-                    wx *= wxs;
-                    }
+            // the partner is at -k, the derivative of its complex conjugate coefficient changes sign
+            k_inf_f += (t ? Scalar(-1.0) : Scalar(1.0))*G*k;
 
-                for (int iy = -nby; iy <= nby; iy++)
-                    {
-                    Scalar qy = ((Scalar)n.y + (Scalar)iy*m_global_dim.y);
-                    Scalar3 kny = qy*b2;
+            Scalar ksq = dot(k,k);
+            Scalar vterm = -Scalar(2.0)*(Scalar(1.0)/ksq + Scalar(0.25)/(m_kappa*m_kappa));
+            virial[0] += G*(Scalar(1.0) + vterm*k.x*k.x); // xx
+            virial[1] += G*(              vterm*k.x*k.y); // xy
+            virial[2] += G*(              vterm*k.x*k.z); // xz
+            virial[3] += G*(Scalar(1.0) + vterm*k.y*k.y); // yy
+            virial[4] += G*(              vterm*k.y*k.z); // yz
+            virial[5] += G*(Scalar(1.0) + vterm*k.z*k.z); // zz
+
+            if (m_ad)
+                {
+                Scalar precoeff[6];
+                evalSelfForcePrecoeff(n, precoeff);
+                for (unsigned int i = 0; i < 6; ++i)
+                    sf[i] += precoeff[i]*G;
+                }
+            }
 
-                    Scalar argy = Scalar(0.5)*qy*kH.y;
-                    Scalar wys = sinc(argy);
-                    Scalar wy(1.0);
-                    for (int iorder = 0; iorder < m_order; ++iorder)
-                        {
-                        wy *= wys;
-                        }
+        h_inf_f.data[cell_idx] = inf_f;
+        h_k.data[cell_idx] = k_inf_f/(Scalar)n_wave;
+        for (unsigned int i = 0; i < 6; ++i)
+            h_virial_mesh.data[i*m_n_fourier_cells + cell_idx] = virial[i];
+        }
 
-                    for (int iz = -nbz; iz <= nbz; iz++)
-                        {
-                        Scalar qz = ((Scalar)n.z + (Scalar)iz*m_global_dim.z);
-                        Scalar3 knz = qz*b3;
+    #ifdef ENABLE_MPI
+    if (m_ad && m_pdata->getDomainDecomposition())
+        {
+        // every rank holds a part of the wave vectors
+        MPI_Allreduce(MPI_IN_PLACE,
+                      sf,
+                      6,
+                      MPI_HOOMD_SCALAR,
+                      MPI_SUM,
+                      m_exec_conf->getMPICommunicator());
+        }
+    #endif
 
-                        Scalar argz = Scalar(0.5)*qz*kH.z;
-                        Scalar wzs = sinc(argz);
-                        Scalar wz(1.0);
-                        for (int iorder = 0; iorder < m_order; ++iorder)
-                            {
-                            wz *= wzs;
-                            }
+    // fold the prefactors of the two Fourier terms of the self force into the coefficients
+    for (unsigned int a = 0; a < 3; ++a)
+        {
+        m_sf_coeff[2*a] = sf[2*a]*Scalar(M_PI)/V_box;
+        m_sf_coeff[2*a+1] = sf[2*a+1]*Scalar(2.0*M_PI)/V_box;
+        }
 
-                        Scalar3 kn = knx + kny + knz;
-                        Scalar dot1 = dot(kn, k);
-                        Scalar dot2 = dot(kn, kn)+m_alpha*m_alpha;
+    if (m_prof) m_prof->pop();
+    }
 
-                        Scalar arg_gauss = Scalar(0.25)*dot2/m_kappa/m_kappa;
-                        Scalar gauss = exp(-arg_gauss);
+/*! \param pos Particle position
+    \param box Local simulation box
+    \param cell Mesh point closest to the particle, the center of its assignment stencil (output)
+    \param d Offset of the mesh point from the particle in units of the mesh spacing (output)
+    \param reduced_pos Particle position in units of the mesh spacing, including ghost cells (output)
+    \returns false if the particle is outside of the mesh
+*/
+bool PPPMForceCompute::findMeshPoint(const Scalar3& pos, const BoxDim& box, int3& cell, Scalar3& d,
+    Scalar3& reduced_pos)
+    {
+    // compute coordinates in units of the mesh size
+    Scalar3 f = box.makeFraction(pos);
+    reduced_pos = make_scalar3(f.x * (Scalar) m_mesh_points.x,
+                               f.y * (Scalar) m_mesh_points.y,
+                               f.z * (Scalar) m_mesh_points.z);
 
-                        sum1 += (dot1/dot2) * gauss * wx * wx * wy * wy * wz * wz;
-                        }
-                    }
-                }
-            h_inf_f.data[cell_idx] = numerator*sum1/denominator;
-            }
-        else // q=0
-            {
-            h_inf_f.data[cell_idx] = Scalar(0.0);
-            }
+    reduced_pos.x += (Scalar) m_n_ghost_cells.x;
+    reduced_pos.y += (Scalar) m_n_ghost_cells.y;
+    reduced_pos.z += (Scalar) m_n_ghost_cells.z;
+
+    Scalar shift, shiftone;
 
-        h_k.data[cell_idx] = k;
+    if (m_order % 2)
+        {
+        shift =0.5;
+        shiftone = 0.0;
+        }
+    else
+        {
+        shift = 0.0;
+        shiftone = 0.5;
         }
 
-    if (m_prof) m_prof->pop();
+    // find cell of the mesh the particle is in
+    int ix = (reduced_pos.x + shift);
+    int iy = (reduced_pos.y + shift);
+    int iz = (reduced_pos.z + shift);
+
+    d.x = shiftone+(Scalar)ix-reduced_pos.x;
+    d.y = shiftone+(Scalar)iy-reduced_pos.y;
+    d.z = shiftone+(Scalar)iz-reduced_pos.z;
+
+    // handle particles on the boundary
+    if (ix == (int) m_grid_dim.x && !m_n_ghost_cells.x)
+        ix = 0;
+    if (iy == (int) m_grid_dim.y && !m_n_ghost_cells.y)
+        iy = 0;
+    if (iz == (int) m_grid_dim.z && !m_n_ghost_cells.z)
+        iz = 0;
+
+    cell = make_int3(ix, iy, iz);
+
+    return !(ix < 0 || ix >= (int)m_grid_dim.x ||
+             iy < 0 || iy >= (int)m_grid_dim.y ||
+             iz < 0 || iz >= (int)m_grid_dim.z);
     }
 
 //! Assignment of particles to mesh using variable order interpolation scheme
+/*! With multiple threads, the particles are sorted into slabs along z that are at least as thick as the assignment
+    stencil. Particles in every other slab cannot write to the same mesh points, so the even and the odd slabs are
+    each assigned in parallel, one slab per task. The summation order is the same for any number of threads
+    greater than one.
+*/
 void PPPMForceCompute::assignParticles()
     {
     if (m_prof) m_prof->push("assign");
@@ -726,72 +981,31 @@ void PPPMForceCompute::assignParticles()
     // set mesh to zero
     memset(h_mesh.data, 0, sizeof(kiss_fft_cpx)*m_mesh.getNumElements());
 
+    // the density is real, only the real parts of a complex mesh are written
+    kiss_fft_scalar *mesh = (kiss_fft_scalar *) h_mesh.data;
+    const unsigned int stride = getMeshStride();
+
     Scalar V_cell = box.getVolume()/(Scalar)(m_mesh_points.x*m_mesh_points.y*m_mesh_points.z);
 
-    // loop over group
-    unsigned int group_size = m_group->getNumMembers();
-    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+    auto assign_particle = [&](unsigned int idx)
         {
-        unsigned int idx = m_group->getMemberIndex(group_idx);
-
         Scalar4 postype = h_postype.data[idx];
         Scalar3 pos = make_scalar3(postype.x, postype.y, postype.z);
 
         // ignore if NaN
         if (std::isnan(pos.x) || std::isnan(pos.y) || std::isnan(pos.z))
             {
-            continue;
+            return;
             }
 
         Scalar qi = h_charge.data[idx];
 
-        // compute coordinates in units of the mesh size
-        Scalar3 f = box.makeFraction(pos);
-        Scalar3 reduced_pos = make_scalar3(f.x * (Scalar) m_mesh_points.x,
-                                           f.y * (Scalar) m_mesh_points.y,
-                                           f.z * (Scalar) m_mesh_points.z);
-
-        reduced_pos.x += (Scalar) m_n_ghost_cells.x;
-        reduced_pos.y += (Scalar) m_n_ghost_cells.y;
-        reduced_pos.z += (Scalar) m_n_ghost_cells.z;
-
-        Scalar shift, shiftone;
-
-        if (m_order % 2)
-            {
-            shift =0.5;
-            shiftone = 0.0;
-            }
-        else
-            {
-            shift = 0.0;
-            shiftone = 0.5;
-            }
-
-        // find cell of the mesh the particle is in
-        int ix = (reduced_pos.x + shift);
-        int iy = (reduced_pos.y + shift);
-        int iz = (reduced_pos.z + shift);
-
-        Scalar dx = shiftone+(Scalar)ix-reduced_pos.x;
-        Scalar dy = shiftone+(Scalar)iy-reduced_pos.y;
-        Scalar dz = shiftone+(Scalar)iz-reduced_pos.z;
-
-
-        // handle particles on the boundary
-        if (ix == (int) m_grid_dim.x && !m_n_ghost_cells.x)
-            ix = 0;
-        if (iy == (int) m_grid_dim.y && !m_n_ghost_cells.y)
-            iy = 0;
-        if (iz == (int) m_grid_dim.z && !m_n_ghost_cells.z)
-            iz = 0;
-
-        if (ix < 0 || ix >= (int)m_grid_dim.x ||
-            iy < 0 || iy >= (int)m_grid_dim.y ||
-            iz < 0 || iz >= (int)m_grid_dim.z)
+        int3 cell;
+        Scalar3 d, reduced_pos;
+        if (!findMeshPoint(pos, box, cell, d, reduced_pos))
             {
             // ignore, error will be thrown elsewhere (in CellList)
-            continue;
+            return;
             }
 
         int mult_fact = 2*m_order+1;
@@ -805,10 +1019,10 @@ void PPPMForceCompute::assignParticles()
             Wx = Scalar(0.0);
             for (int iorder = m_order-1; iorder >= 0; iorder--)
                 {
-                Wx = h_rho_coeff.data[i - nlower + iorder*mult_fact] + Wx * dx;
+                Wx = h_rho_coeff.data[i - nlower + iorder*mult_fact] + Wx * d.x;
                 }
 
-            int neighi = (int)ix + i;
+            int neighi = cell.x + i;
 
             if (! m_n_ghost_cells.x)
                 {
@@ -824,10 +1038,10 @@ void PPPMForceCompute::assignParticles()
                 Wy = Scalar(0.0);
                 for (int iorder = m_order-1; iorder >= 0; iorder--)
                     {
-                    Wy = h_rho_coeff.data[j - nlower + iorder*mult_fact] + Wy * dy;
+                    Wy = h_rho_coeff.data[j - nlower + iorder*mult_fact] + Wy * d.y;
                     }
 
-                int neighj = (int)iy + j;
+                int neighj = cell.y + j;
 
                 if (! m_n_ghost_cells.y)
                     {
@@ -842,10 +1056,10 @@ void PPPMForceCompute::assignParticles()
                     Wz = Scalar(0.0);
                     for (int iorder = m_order-1; iorder >= 0; iorder--)
                         {
-                        Wz = h_rho_coeff.data[k - nlower + iorder*mult_fact] + Wz * dz;
+                        Wz = h_rho_coeff.data[k - nlower + iorder*mult_fact] + Wz * d.z;
                         }
 
-                    int neighk = (int)iz + k;
+                    int neighk = cell.z + k;
                     if (! m_n_ghost_cells.z)
                         {
                         if (neighk >= (int)m_grid_dim.z)
@@ -859,11 +1073,92 @@ void PPPMForceCompute::assignParticles()
                     // store in row major order
                     unsigned int neigh_idx = neighi + m_grid_dim.x * (neighj + m_grid_dim.y*neighk);
 
-                    h_mesh.data[neigh_idx].r += qi*W/V_cell;
+                    mesh[neigh_idx*stride] += qi*W/V_cell;
                     }
                 }
             }
-        } // end loop over particles
+        };
+
+    unsigned int group_size = m_group->getNumMembers();
+    ArrayHandle<unsigned int> h_group_members(m_group->getIndexArray(), access_location::host, access_mode::read);
+
+    #ifdef ENABLE_TBB
+    // slabs must be at least as thick as the stencil, and pair up across a periodic boundary
+    unsigned int n_slabs = m_grid_dim.z / m_order;
+    if (! m_n_ghost_cells.z)
+        n_slabs -= n_slabs % 2;
+
+    const unsigned int n_blocks = m_exec_conf->getNumThreads();
+    if (n_blocks > 1 && n_slabs >= 2 && group_size > n_blocks)
+        {
+        // find the slab of every particle
+        m_particle_slab.resize(group_size);
+        m_slab_particles.resize(group_size);
+
+        auto block_begin = [group_size, n_blocks](unsigned int b)
+            { return (unsigned int)(((size_t)group_size*b)/n_blocks); };
+
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_blocks, 1),
+            [&](const tbb::blocked_range<unsigned int>& r)
+            {
+            for (unsigned int b = r.begin(); b != r.end(); ++b)
+                {
+                for (unsigned int group_idx = block_begin(b); group_idx < block_begin(b+1); ++group_idx)
+                    {
+                    Scalar4 postype = h_postype.data[h_group_members.data[group_idx]];
+                    Scalar3 pos = make_scalar3(postype.x, postype.y, postype.z);
+
+                    int3 cell;
+                    Scalar3 d, reduced_pos;
+                    if (std::isnan(pos.x) || std::isnan(pos.y) || std::isnan(pos.z)
+                        || !findMeshPoint(pos, box, cell, d, reduced_pos))
+                        {
+                        // skipped by assign_particle
+                        m_particle_slab[group_idx] = 0;
+                        }
+                    else
+                        {
+                        m_particle_slab[group_idx] = (unsigned int)(((size_t)cell.z*n_slabs)/m_grid_dim.z);
+                        }
+                    }
+                }
+            });
+
+        // sort the particles by slab, keeping their order within each slab
+        std::vector<unsigned int> slab_start(n_slabs+1, 0);
+        for (unsigned int group_idx = 0; group_idx < group_size; ++group_idx)
+            slab_start[m_particle_slab[group_idx]+1]++;
+        for (unsigned int s = 0; s < n_slabs; ++s)
+            slab_start[s+1] += slab_start[s];
+
+        std::vector<unsigned int> slab_offset(slab_start.begin(), slab_start.end()-1);
+        for (unsigned int group_idx = 0; group_idx < group_size; ++group_idx)
+            m_slab_particles[slab_offset[m_particle_slab[group_idx]]++] = h_group_members.data[group_idx];
+
+        // assign the even slabs, then the odd slabs
+        for (unsigned int parity = 0; parity < 2; ++parity)
+            {
+            tbb::parallel_for(tbb::blocked_range<unsigned int>(0, (n_slabs + 1 - parity)/2, 1),
+                [&](const tbb::blocked_range<unsigned int>& r)
+                {
+                for (unsigned int s = r.begin(); s != r.end(); ++s)
+                    {
+                    unsigned int slab = 2*s + parity;
+                    for (unsigned int i = slab_start[slab]; i < slab_start[slab+1]; ++i)
+                        assign_particle(m_slab_particles[i]);
+                    }
+                });
+            }
+        }
+    else
+    #endif
+        {
+        // loop over group
+        for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+            {
+            assign_particle(h_group_members.data[group_idx]);
+            }
+        }
 
     if (m_prof) m_prof->pop();
     }
@@ -877,7 +1172,7 @@ void PPPMForceCompute::updateMeshes()
         ArrayHandle<kiss_fft_cpx> h_mesh(m_mesh, access_location::host, access_mode::read);
         ArrayHandle<kiss_fft_cpx> h_fourier_mesh(m_fourier_mesh, access_location::host, access_mode::overwrite);
 
-        kiss_fftnd(m_kiss_fft, h_mesh.data, h_fourier_mesh.data);
+        m_real_fft->forward((kiss_fft_scalar *) h_mesh.data, h_fourier_mesh.data);
         if (m_prof) m_prof->pop();
         }
 
@@ -904,33 +1199,59 @@ void PPPMForceCompute::updateMeshes()
 
     if (m_prof) m_prof->push("update");
 
+    unsigned int NNN = m_global_dim.x*m_global_dim.y*m_global_dim.z;
+
+    if (m_ad)
+        {
+        ArrayHandle<kiss_fft_cpx> h_fourier_mesh_G(m_fourier_mesh_G, access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar> h_inf_f(m_inf_f, access_location::host, access_mode::read);
+        ArrayHandle<kiss_fft_cpx> h_fourier_mesh(m_fourier_mesh, access_location::host, access_mode::read);
+
+        unsigned int nx_fourier = m_mesh_points.x/2 + 1;
+
+        // multiply with the influence function to obtain the potential
+        for (unsigned int k = 0; k < m_n_fourier_cells; ++k)
+            {
+            kiss_fft_cpx f = h_fourier_mesh.data[k];
+
+            // average the influence function over the Hermitian partners it was summed over
+            Scalar n_wave(1.0);
+            if (m_kiss_fft_initialized)
+                {
+                unsigned int kx = k % nx_fourier;
+                if (kx != 0 && 2*kx != m_mesh_points.x)
+                    n_wave = Scalar(2.0);
+                }
+
+            Scalar scaled_inf_f = h_inf_f.data[k] / (n_wave*(Scalar)NNN);
+
+            h_fourier_mesh_G.data[k].r = f.r * scaled_inf_f;
+            h_fourier_mesh_G.data[k].i = f.i * scaled_inf_f;
+            }
+        }
+    else
         {
         ArrayHandle<Scalar3> h_k(m_k, access_location::host, access_mode::read);
         ArrayHandle<kiss_fft_cpx> h_fourier_mesh_G_x(m_fourier_mesh_G_x, access_location::host, access_mode::overwrite);
         ArrayHandle<kiss_fft_cpx> h_fourier_mesh_G_y(m_fourier_mesh_G_y, access_location::host, access_mode::overwrite);
         ArrayHandle<kiss_fft_cpx> h_fourier_mesh_G_z(m_fourier_mesh_G_z, access_location::host, access_mode::overwrite);
-        ArrayHandle<Scalar> h_inf_f(m_inf_f, access_location::host, access_mode::read);
         ArrayHandle<kiss_fft_cpx> h_fourier_mesh(m_fourier_mesh, access_location::host, access_mode::read);
 
-        unsigned int NNN = m_global_dim.x*m_global_dim.y*m_global_dim.z;
-
-        // multiply with influence function and I*k
-        for (unsigned int k = 0; k < m_n_inner_cells; ++k)
+        // multiply with I*k (which already includes the influence function)
+        for (unsigned int k = 0; k < m_n_fourier_cells; ++k)
             {
             kiss_fft_cpx f = h_fourier_mesh.data[k];
 
-            Scalar scaled_inf_f = h_inf_f.data[k] / ((Scalar)NNN);
-
-            Scalar3 kvec = h_k.data[k];
+            Scalar3 kvec = h_k.data[k] / ((Scalar)NNN);
 
-            h_fourier_mesh_G_x.data[k].r = f.i * kvec.x * scaled_inf_f;
-            h_fourier_mesh_G_x.data[k].i = -f.r * kvec.x * scaled_inf_f;
+            h_fourier_mesh_G_x.data[k].r = f.i * kvec.x;
+            h_fourier_mesh_G_x.data[k].i = -f.r * kvec.x;
 
-            h_fourier_mesh_G_y.data[k].r = f.i * kvec.y * scaled_inf_f;
-            h_fourier_mesh_G_y.data[k].i = -f.r * kvec.y * scaled_inf_f;
+            h_fourier_mesh_G_y.data[k].r = f.i * kvec.y;
+            h_fourier_mesh_G_y.data[k].i = -f.r * kvec.y;
 
-            h_fourier_mesh_G_z.data[k].r = f.i * kvec.z * scaled_inf_f;
-            h_fourier_mesh_G_z.data[k].i = -f.r * kvec.z * scaled_inf_f;
+            h_fourier_mesh_G_z.data[k].r = f.i * kvec.z;
+            h_fourier_mesh_G_z.data[k].i = -f.r * kvec.z;
             }
         }
 
@@ -939,16 +1260,25 @@ void PPPMForceCompute::updateMeshes()
     if (m_kiss_fft_initialized)
         {
         if (m_prof) m_prof->push("FFT");
-        // do a local inverse transform of the force mesh
-        ArrayHandle<kiss_fft_cpx> h_fourier_mesh_G_x(m_fourier_mesh_G_x, access_location::host, access_mode::read);
-        ArrayHandle<kiss_fft_cpx> h_fourier_mesh_G_y(m_fourier_mesh_G_y, access_location::host, access_mode::read);
-        ArrayHandle<kiss_fft_cpx> h_fourier_mesh_G_z(m_fourier_mesh_G_z, access_location::host, access_mode::read);
-        ArrayHandle<kiss_fft_cpx> h_inv_fourier_mesh_x(m_inv_fourier_mesh_x, access_location::host, access_mode::overwrite);
-        ArrayHandle<kiss_fft_cpx> h_inv_fourier_mesh_y(m_inv_fourier_mesh_y, access_location::host, access_mode::overwrite);
-        ArrayHandle<kiss_fft_cpx> h_inv_fourier_mesh_z(m_inv_fourier_mesh_z, access_location::host, access_mode::overwrite);
-        kiss_fftnd(m_kiss_ifft, h_fourier_mesh_G_x.data, h_inv_fourier_mesh_x.data);
-        kiss_fftnd(m_kiss_ifft, h_fourier_mesh_G_y.data, h_inv_fourier_mesh_y.data);
-        kiss_fftnd(m_kiss_ifft, h_fourier_mesh_G_z.data, h_inv_fourier_mesh_z.data);
+        // do a local inverse transform of the force (or potential) mesh
+        if (m_ad)
+            {
+            ArrayHandle<kiss_fft_cpx> h_fourier_mesh_G(m_fourier_mesh_G, access_location::host, access_mode::read);
+            ArrayHandle<kiss_fft_cpx> h_inv_fourier_mesh(m_inv_fourier_mesh, access_location::host, access_mode::overwrite);
+            m_real_fft->inverse(h_fourier_mesh_G.data, (kiss_fft_scalar *) h_inv_fourier_mesh.data);
+            }
+        else
+            {
+            ArrayHandle<kiss_fft_cpx> h_fourier_mesh_G_x(m_fourier_mesh_G_x, access_location::host, access_mode::read);
+            ArrayHandle<kiss_fft_cpx> h_fourier_mesh_G_y(m_fourier_mesh_G_y, access_location::host, access_mode::read);
+            ArrayHandle<kiss_fft_cpx> h_fourier_mesh_G_z(m_fourier_mesh_G_z, access_location::host, access_mode::read);
+            ArrayHandle<kiss_fft_cpx> h_inv_fourier_mesh_x(m_inv_fourier_mesh_x, access_location::host, access_mode::overwrite);
+            ArrayHandle<kiss_fft_cpx> h_inv_fourier_mesh_y(m_inv_fourier_mesh_y, access_location::host, access_mode::overwrite);
+            ArrayHandle<kiss_fft_cpx> h_inv_fourier_mesh_z(m_inv_fourier_mesh_z, access_location::host, access_mode::overwrite);
+            m_real_fft->inverse(h_fourier_mesh_G_x.data, (kiss_fft_scalar *) h_inv_fourier_mesh_x.data);
+            m_real_fft->inverse(h_fourier_mesh_G_y.data, (kiss_fft_scalar *) h_inv_fourier_mesh_y.data);
+            m_real_fft->inverse(h_fourier_mesh_G_z.data, (kiss_fft_scalar *) h_inv_fourier_mesh_z.data);
+            }
         if (m_prof) m_prof->pop();
         }
 
@@ -959,31 +1289,46 @@ void PPPMForceCompute::updateMeshes()
         // Distributed inverse transform force on mesh points
         m_exec_conf->msg->notice(8) << "charge.pppm: Distributed iFFT" << std::endl;
 
-        ArrayHandle<kiss_fft_cpx> h_fourier_mesh_G_x(m_fourier_mesh_G_x, access_location::host, access_mode::read);
-        ArrayHandle<kiss_fft_cpx> h_fourier_mesh_G_y(m_fourier_mesh_G_y, access_location::host, access_mode::read);
-        ArrayHandle<kiss_fft_cpx> h_fourier_mesh_G_z(m_fourier_mesh_G_z, access_location::host, access_mode::read);
-        ArrayHandle<kiss_fft_cpx> h_inv_fourier_mesh_x(m_inv_fourier_mesh_x, access_location::host, access_mode::overwrite);
-        ArrayHandle<kiss_fft_cpx> h_inv_fourier_mesh_y(m_inv_fourier_mesh_y, access_location::host, access_mode::overwrite);
-        ArrayHandle<kiss_fft_cpx> h_inv_fourier_mesh_z(m_inv_fourier_mesh_z, access_location::host, access_mode::overwrite);
+        if (m_ad)
+            {
+            ArrayHandle<kiss_fft_cpx> h_fourier_mesh_G(m_fourier_mesh_G, access_location::host, access_mode::read);
+            ArrayHandle<kiss_fft_cpx> h_inv_fourier_mesh(m_inv_fourier_mesh, access_location::host, access_mode::overwrite);
 
-        dfft_execute((cpx_t *)h_fourier_mesh_G_x.data, (cpx_t *)(h_inv_fourier_mesh_x.data+m_ghost_offset), 1,m_dfft_plan_inverse);
-        dfft_execute((cpx_t *)h_fourier_mesh_G_y.data, (cpx_t *)(h_inv_fourier_mesh_y.data+m_ghost_offset), 1,m_dfft_plan_inverse);
-        dfft_execute((cpx_t *)h_fourier_mesh_G_z.data, (cpx_t *)(h_inv_fourier_mesh_z.data+m_ghost_offset), 1,m_dfft_plan_inverse);
+            dfft_execute((cpx_t *)h_fourier_mesh_G.data, (cpx_t *)(h_inv_fourier_mesh.data+m_ghost_offset), 1,m_dfft_plan_inverse);
+            }
+        else
+            {
+            ArrayHandle<kiss_fft_cpx> h_fourier_mesh_G_x(m_fourier_mesh_G_x, access_location::host, access_mode::read);
+            ArrayHandle<kiss_fft_cpx> h_fourier_mesh_G_y(m_fourier_mesh_G_y, access_location::host, access_mode::read);
+            ArrayHandle<kiss_fft_cpx> h_fourier_mesh_G_z(m_fourier_mesh_G_z, access_location::host, access_mode::read);
+            ArrayHandle<kiss_fft_cpx> h_inv_fourier_mesh_x(m_inv_fourier_mesh_x, access_location::host, access_mode::overwrite);
+            ArrayHandle<kiss_fft_cpx> h_inv_fourier_mesh_y(m_inv_fourier_mesh_y, access_location::host, access_mode::overwrite);
+            ArrayHandle<kiss_fft_cpx> h_inv_fourier_mesh_z(m_inv_fourier_mesh_z, access_location::host, access_mode::overwrite);
+
+            dfft_execute((cpx_t *)h_fourier_mesh_G_x.data, (cpx_t *)(h_inv_fourier_mesh_x.data+m_ghost_offset), 1,m_dfft_plan_inverse);
+            dfft_execute((cpx_t *)h_fourier_mesh_G_y.data, (cpx_t *)(h_inv_fourier_mesh_y.data+m_ghost_offset), 1,m_dfft_plan_inverse);
+            dfft_execute((cpx_t *)h_fourier_mesh_G_z.data, (cpx_t *)(h_inv_fourier_mesh_z.data+m_ghost_offset), 1,m_dfft_plan_inverse);
+            }
         if (m_prof) m_prof->pop();
         }
     #endif
 
-    // potential optimization: combine vector components into Scalar3
-
     #ifdef ENABLE_MPI
     if (m_pdata->getDomainDecomposition())
         {
         // update outer cells of force mesh using ghost cells from neighboring processors
         if (m_prof) m_prof->push("ghost cell update");
         m_exec_conf->msg->notice(8) << "charge.pppm: Ghost cell update" << std::endl;
-        m_grid_comm_reverse->communicate(m_inv_fourier_mesh_x);
-        m_grid_comm_reverse->communicate(m_inv_fourier_mesh_y);
-        m_grid_comm_reverse->communicate(m_inv_fourier_mesh_z);
+        if (m_ad)
+            {
+            m_grid_comm_reverse->communicate(m_inv_fourier_mesh);
+            }
+        else
+            {
+            m_grid_comm_reverse->communicate(m_inv_fourier_mesh_x);
+            m_grid_comm_reverse->communicate(m_inv_fourier_mesh_y);
+            m_grid_comm_reverse->communicate(m_inv_fourier_mesh_z);
+            }
         if (m_prof) m_prof->pop();
         }
     #endif
@@ -1001,6 +1346,14 @@ void PPPMForceCompute::interpolateForces()
     ArrayHandle<kiss_fft_cpx> h_inv_fourier_mesh_x(m_inv_fourier_mesh_x, access_location::host, access_mode::read);
     ArrayHandle<kiss_fft_cpx> h_inv_fourier_mesh_y(m_inv_fourier_mesh_y, access_location::host, access_mode::read);
     ArrayHandle<kiss_fft_cpx> h_inv_fourier_mesh_z(m_inv_fourier_mesh_z, access_location::host, access_mode::read);
+    ArrayHandle<kiss_fft_cpx> h_inv_fourier_mesh(m_inv_fourier_mesh, access_location::host, access_mode::read);
+
+    // the fields are real, only the real parts of a complex mesh are read
+    const kiss_fft_scalar *E_x_mesh = (const kiss_fft_scalar *) h_inv_fourier_mesh_x.data;
+    const kiss_fft_scalar *E_y_mesh = (const kiss_fft_scalar *) h_inv_fourier_mesh_y.data;
+    const kiss_fft_scalar *E_z_mesh = (const kiss_fft_scalar *) h_inv_fourier_mesh_z.data;
+    const kiss_fft_scalar *phi_mesh = (const kiss_fft_scalar *) h_inv_fourier_mesh.data;
+    const unsigned int stride = getMeshStride();
 
     // access force array
     ArrayHandle<Scalar4> h_force(m_force, access_location::host, access_mode::overwrite);
@@ -1012,11 +1365,25 @@ void PPPMForceCompute::interpolateForces()
 
     const BoxDim& box = m_pdata->getBox();
 
-    // loop over group
-    unsigned int group_size = m_group->getNumMembers();
-    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+    // with analytical differentiation, the gradient with respect to the reduced coordinates is converted
+    // to a force using the reciprocal lattice vectors of the global mesh
+    Scalar3 grad_conv[3];
+    if (m_ad)
+        {
+        const BoxDim& global_box = m_pdata->getGlobalBox();
+        Scalar3 a1 = global_box.getLatticeVector(0);
+        Scalar3 a2 = global_box.getLatticeVector(1);
+        Scalar3 a3 = global_box.getLatticeVector(2);
+        Scalar V_box = global_box.getVolume();
+
+        // reciprocal lattice vectors divided by 2 pi, times the number of mesh points
+        grad_conv[0] = (Scalar)m_global_dim.x*make_scalar3(a2.y*a3.z-a2.z*a3.y, a2.z*a3.x-a2.x*a3.z, a2.x*a3.y-a2.y*a3.x)/V_box;
+        grad_conv[1] = (Scalar)m_global_dim.y*make_scalar3(a3.y*a1.z-a3.z*a1.y, a3.z*a1.x-a3.x*a1.z, a3.x*a1.y-a3.y*a1.x)/V_box;
+        grad_conv[2] = (Scalar)m_global_dim.z*make_scalar3(a1.y*a2.z-a1.z*a2.y, a1.z*a2.x-a1.x*a2.z, a1.x*a2.y-a1.y*a2.x)/V_box;
+        }
+
+    auto interpolate_particle = [&](unsigned int idx)
         {
-        unsigned int idx = m_group->getMemberIndex(group_idx);
         Scalar4 postype = h_postype.data[idx];
 
         Scalar3 pos = make_scalar3(postype.x, postype.y, postype.z);
@@ -1024,63 +1391,28 @@ void PPPMForceCompute::interpolateForces()
         // ignore if NaN
         if (std::isnan(pos.x) || std::isnan(pos.y) || std::isnan(pos.z))
             {
-            continue;
+            return;
             }
 
         Scalar qi = h_charge.data[idx];
 
-        // compute coordinates in units of the mesh size
-        Scalar3 f = box.makeFraction(pos);
-        Scalar3 reduced_pos = make_scalar3(f.x * (Scalar) m_mesh_points.x,
-                                           f.y * (Scalar) m_mesh_points.y,
-                                           f.z * (Scalar) m_mesh_points.z);
-        reduced_pos.x += (Scalar) m_n_ghost_cells.x;
-        reduced_pos.y += (Scalar) m_n_ghost_cells.y;
-        reduced_pos.z += (Scalar) m_n_ghost_cells.z;
-
-        Scalar shift, shiftone;
-
-        if (m_order % 2)
-            {
-            shift =0.5;
-            shiftone = 0.0;
-            }
-        else
-            {
-            shift = 0.0;
-            shiftone = 0.5;
-            }
-
-
         // find cell of the force mesh the particle is in
-        int ix = (reduced_pos.x + shift);
-        int iy = (reduced_pos.y + shift);
-        int iz = (reduced_pos.z + shift);
-
-        Scalar dx = shiftone+(Scalar)ix-reduced_pos.x;
-        Scalar dy = shiftone+(Scalar)iy-reduced_pos.y;
-        Scalar dz = shiftone+(Scalar)iz-reduced_pos.z;
-
-        // handle particles on the boundary
-        if (ix == (int) m_grid_dim.x && !m_n_ghost_cells.x)
-            ix = 0;
-        if (iy == (int) m_grid_dim.y && !m_n_ghost_cells.y)
-            iy = 0;
-        if (iz == (int) m_grid_dim.z && !m_n_ghost_cells.z)
-            iz = 0;
-
-        if (ix < 0 || ix >= (int)m_grid_dim.x ||
-            iy < 0 || iy >= (int)m_grid_dim.y ||
-            iz < 0 || iz >= (int)m_grid_dim.z)
+        int3 cell;
+        Scalar3 d, reduced_pos;
+        if (!findMeshPoint(pos, box, cell, d, reduced_pos))
             {
             // ignore, error will be thrown elsewhere (in CellList)
-            continue;
+            return;
             }
 
         Scalar3 force = make_scalar3(0.0,0.0,0.0);
 
+        // negative gradient of the potential with respect to the reduced coordinates (ad)
+        Scalar3 grad = make_scalar3(0.0,0.0,0.0);
+
         int mult_fact = 2*m_order+1;
         Scalar Wx, Wy, Wz;
+        Scalar dWx(0.0), dWy(0.0), dWz(0.0);
 
         int nlower = -(m_order-1)/2;
         int nupper = m_order/2;
@@ -1090,10 +1422,19 @@ void PPPMForceCompute::interpolateForces()
             Wx = Scalar(0.0);
             for (int iorder = m_order-1; iorder >= 0; iorder--)
                 {
-                Wx = h_rho_coeff.data[i - nlower + iorder*mult_fact] + Wx * dx;
+                Wx = h_rho_coeff.data[i - nlower + iorder*mult_fact] + Wx * d.x;
                 }
 
-            int neighi = (int)ix + i;
+            if (m_ad)
+                {
+                dWx = Scalar(0.0);
+                for (int iorder = m_order-1; iorder >= 1; iorder--)
+                    {
+                    dWx = (Scalar)iorder*h_rho_coeff.data[i - nlower + iorder*mult_fact] + dWx * d.x;
+                    }
+                }
+
+            int neighi = cell.x + i;
 
             if (! m_n_ghost_cells.x)
                 {
@@ -1109,10 +1450,19 @@ void PPPMForceCompute::interpolateForces()
                 Wy = Scalar(0.0);
                 for (int iorder = m_order-1; iorder >= 0; iorder--)
                     {
-                    Wy = h_rho_coeff.data[j - nlower + iorder*mult_fact] + Wy * dy;
+                    Wy = h_rho_coeff.data[j - nlower + iorder*mult_fact] + Wy * d.y;
                     }
 
-                int neighj = (int)iy + j;
+                if (m_ad)
+                    {
+                    dWy = Scalar(0.0);
+                    for (int iorder = m_order-1; iorder >= 1; iorder--)
+                        {
+                        dWy = (Scalar)iorder*h_rho_coeff.data[j - nlower + iorder*mult_fact] + dWy * d.y;
+                        }
+                    }
+
+                int neighj = cell.y + j;
 
                 if (! m_n_ghost_cells.y)
                     {
@@ -1128,10 +1478,19 @@ void PPPMForceCompute::interpolateForces()
                     Wz = Scalar(0.0);
                     for (int iorder = m_order-1; iorder >= 0; iorder--)
                         {
-                        Wz = h_rho_coeff.data[k - nlower + iorder*mult_fact] + Wz * dz;
+                        Wz = h_rho_coeff.data[k - nlower + iorder*mult_fact] + Wz * d.z;
                         }
 
-                    int neighk = (int)iz + k;
+                    if (m_ad)
+                        {
+                        dWz = Scalar(0.0);
+                        for (int iorder = m_order-1; iorder >= 1; iorder--)
+                            {
+                            dWz = (Scalar)iorder*h_rho_coeff.data[k - nlower + iorder*mult_fact] + dWz * d.z;
+                            }
+                        }
+
+                    int neighk = cell.z + k;
                     if (! m_n_ghost_cells.z)
                         {
                         if (neighk >= (int)m_grid_dim.z)
@@ -1142,20 +1501,77 @@ void PPPMForceCompute::interpolateForces()
 
                     unsigned int neigh_idx = neighi + m_grid_dim.x * (neighj + m_grid_dim.y*neighk);
 
-                    kiss_fft_cpx E_x = h_inv_fourier_mesh_x.data[neigh_idx];
-                    kiss_fft_cpx E_y = h_inv_fourier_mesh_y.data[neigh_idx];
-                    kiss_fft_cpx E_z = h_inv_fourier_mesh_z.data[neigh_idx];
-
-                    Scalar W = Wx * Wy * Wz;
-                    force.x += qi*W*E_x.r;
-                    force.y += qi*W*E_y.r;
-                    force.z += qi*W*E_z.r;
+                    if (m_ad)
+                        {
+                        // dx decreases as the reduced coordinate increases, this sums the negative gradient
+                        Scalar phi = phi_mesh[neigh_idx*stride];
+                        grad.x += dWx * Wy * Wz * phi;
+                        grad.y += Wx * dWy * Wz * phi;
+                        grad.z += Wx * Wy * dWz * phi;
+                        }
+                    else
+                        {
+                        Scalar E_x = E_x_mesh[neigh_idx*stride];
+                        Scalar E_y = E_y_mesh[neigh_idx*stride];
+                        Scalar E_z = E_z_mesh[neigh_idx*stride];
+
+                        Scalar W = Wx * Wy * Wz;
+                        force.x += qi*W*E_x;
+                        force.y += qi*W*E_y;
+                        force.z += qi*W*E_z;
+                        }
                     }
                 }
             }
 
+        if (m_ad)
+            {
+            // subtract the self force of the particle, the mesh is periodic in the reduced coordinates
+            Scalar two_pi(2.0*M_PI);
+            Scalar q2_2 = Scalar(2.0)*qi*qi;
+            Scalar self_x = q2_2*(m_sf_coeff[0]*fast::sin(two_pi*reduced_pos.x)
+                + m_sf_coeff[1]*fast::sin(Scalar(2.0)*two_pi*reduced_pos.x));
+            Scalar self_y = q2_2*(m_sf_coeff[2]*fast::sin(two_pi*reduced_pos.y)
+                + m_sf_coeff[3]*fast::sin(Scalar(2.0)*two_pi*reduced_pos.y));
+            Scalar self_z = q2_2*(m_sf_coeff[4]*fast::sin(two_pi*reduced_pos.z)
+                + m_sf_coeff[5]*fast::sin(Scalar(2.0)*two_pi*reduced_pos.z));
+
+            force = (qi*grad.x - self_x)*grad_conv[0]
+                + (qi*grad.y - self_y)*grad_conv[1]
+                + (qi*grad.z - self_z)*grad_conv[2];
+            }
+
         h_force.data[idx] = make_scalar4(force.x,force.y,force.z,0.0);
-        }  // end of loop over particles
+        };
+
+    unsigned int group_size = m_group->getNumMembers();
+    ArrayHandle<unsigned int> h_group_members(m_group->getIndexArray(), access_location::host, access_mode::read);
+
+    #ifdef ENABLE_TBB
+    const unsigned int n_blocks = m_exec_conf->getNumThreads();
+    if (n_blocks > 1 && group_size > n_blocks)
+        {
+        // every particle only writes its own force
+        auto block_begin = [group_size, n_blocks](unsigned int b)
+            { return (unsigned int)(((size_t)group_size*b)/n_blocks); };
+
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_blocks, 1),
+            [&](const tbb::blocked_range<unsigned int>& r)
+            {
+            for (unsigned int b = r.begin(); b != r.end(); ++b)
+                for (unsigned int group_idx = block_begin(b); group_idx < block_begin(b+1); ++group_idx)
+                    interpolate_particle(h_group_members.data[group_idx]);
+            });
+        }
+    else
+    #endif
+        {
+        // loop over group
+        for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+            {
+            interpolate_particle(h_group_members.data[group_idx]);
+            }
+        }
 
     if (m_prof) m_prof->pop();
     }
@@ -1178,7 +1594,7 @@ Scalar PPPMForceCompute::computePE()
         }
     #endif
 
-    for (unsigned int k = 0; k < m_n_inner_cells; ++k)
+    for (unsigned int k = 0; k < m_n_fourier_cells; ++k)
         {
         bool exclude = false;
         if (exclude_dc)
@@ -1310,11 +1726,8 @@ void PPPMForceCompute::computeVirial()
     {
     if (m_prof) m_prof->push("virial");
 
-    ArrayHandle<kiss_fft_cpx> h_fourier_mesh(m_fourier_mesh, access_location::host, access_mode::overwrite);
-
-    ArrayHandle<Scalar> h_inf_f(m_inf_f, access_location::host, access_mode::read);
-    ArrayHandle<Scalar3> h_k(m_k, access_location::host, access_mode::read);
-
+    ArrayHandle<kiss_fft_cpx> h_fourier_mesh(m_fourier_mesh, access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_virial_mesh(m_virial_mesh, access_location::host, access_mode::read);
 
     Scalar virial[6];
     for (unsigned int i = 0; i < 6; ++i)
@@ -1329,7 +1742,7 @@ void PPPMForceCompute::computeVirial()
         }
     #endif
 
-    for (unsigned int kidx = 0; kidx < m_n_inner_cells; ++kidx)
+    for (unsigned int kidx = 0; kidx < m_n_fourier_cells; ++kidx)
         {
         bool exclude = false;
         if (exclude_dc)
@@ -1341,18 +1754,11 @@ void PPPMForceCompute::computeVirial()
             // non-zero wave vector
             kiss_fft_cpx fourier = h_fourier_mesh.data[kidx];
 
-            Scalar3 k = h_k.data[kidx];
-            Scalar ksq = dot(k,k);
-
-            Scalar rhog = (fourier.r * fourier.r + fourier.i * fourier.i)*h_inf_f.data[kidx];
+            Scalar rhog = fourier.r * fourier.r + fourier.i * fourier.i;
 
-            Scalar vterm = -Scalar(2.0)*(Scalar(1.0)/ksq + Scalar(0.25)/(m_kappa*m_kappa));
-            virial[0] += rhog*(Scalar(1.0) + vterm*k.x*k.x); // xx
-            virial[1] += rhog*(              vterm*k.x*k.y); // xy
-            virial[2] += rhog*(              vterm*k.x*k.z); // xz
-            virial[3] += rhog*(Scalar(1.0) + vterm*k.y*k.y); // yy
-            virial[4] += rhog*(              vterm*k.y*k.z); // yz
-            virial[5] += rhog*(Scalar(1.0) + vterm*k.z*k.z); // zz
+            // the virial coefficients include the influence function
+            for (unsigned int i = 0; i < 6; ++i)
+                virial[i] += rhog*h_virial_mesh.data[i*m_n_fourier_cells + kidx];
             }
         }
 
@@ -1671,5 +2077,7 @@ void export_PPPMForceCompute(py::module& m)
         .def("setParams", &PPPMForceCompute::setParams)
         .def("getQSum", &PPPMForceCompute::getQSum)
         .def("getQ2Sum", &PPPMForceCompute::getQ2Sum)
+        .def("setAnalyticalDifferentiation", &PPPMForceCompute::setAnalyticalDifferentiation)
+        .def("getAnalyticalDifferentiation", &PPPMForceCompute::getAnalyticalDifferentiation)
         ;
     }
@@ -13,7 +13,7 @@
 #include "hoomd/extern/dfftlib/src/dfft_host.h"
 #endif
 
-#include "hoomd/extern/kiss_fftnd.h"
+#include "RealFFT3D.h"
 
 #include <memory>
 #include <hoomd/extern/nano-signal-slot/nano_signal_slot.hpp>
@@ -23,6 +23,19 @@ const Scalar EPS_HOC(1.0e-7);
 const unsigned int PPPM_MAX_ORDER = 7;
 
 /*! Compute the long-ranged part of the particle-particle particle-mesh Ewald sum (PPPM)
+
+    Without domain decomposition, the charge density and field meshes are real valued and transformed with a
+    real-to-complex FFT (RealFFT3D), which stores only the half of the Fourier coefficients with non-negative x
+    frequency. Each stored coefficient then stands for itself and its Hermitian partner: the influence function,
+    the virial coefficients and the (ik) differentiation vectors of both wave vectors are combined in
+    computeInfluenceFunction(), so that energy, virial and forces are the same as with a full complex transform.
+    With domain decomposition, the distributed FFT is complex and every coefficient stands only for itself.
+
+    Forces are computed either by ik differentiation (the default), which multiplies the Fourier transformed
+    density with i*k and needs three inverse FFTs for the three components of the field, or by analytical
+    differentiation (ad), which transforms only the potential back to the mesh and differentiates the assignment
+    function when interpolating it to the particles. The ad scheme uses an influence function optimized for it
+    and subtracts the spurious self force on each particle, see Stamm et al., Mol. Phys. 117, 1144 (2019).
  */
 class PYBIND11_EXPORT PPPMForceCompute : public ForceCompute
     {
@@ -39,6 +52,31 @@ class PYBIND11_EXPORT PPPMForceCompute : public ForceCompute
 
         void computeForces(unsigned int timestep);
 
+        //! The mesh is private, but the distributed FFTs communicate
+        virtual bool canComputeConcurrently() const
+            {
+            #ifdef ENABLE_MPI
+            if (m_comm)
+                return false;
+            #endif
+            return true;
+            }
+
+        //! The exclusions are taken from the neighbor list
+        virtual std::vector< std::shared_ptr<Compute> > getDependencies()
+            {
+            std::vector< std::shared_ptr<Compute> > deps;
+            if (m_nlist->getExclusionsSet())
+                deps.push_back(m_nlist);
+            return deps;
+            }
+
+        //! Get the name of the profiler category for this ForceCompute
+        virtual std::string getProfileName() const
+            {
+            return "PPPM";
+            }
+
         /*! Returns the names of provided log quantities.
          */
         std::vector<std::string> getProvidedLogQuantities()
@@ -57,6 +95,15 @@ class PYBIND11_EXPORT PPPMForceCompute : public ForceCompute
          */
         Scalar getLogValue(const std::string& quantity, unsigned int timestep);
 
+        //! Choose between ik and analytical differentiation
+        virtual void setAnalyticalDifferentiation(bool ad);
+
+        //! Check if forces are computed with analytical differentiation
+        bool getAnalyticalDifferentiation()
+            {
+            return m_ad;
+            }
+
         //! Get sum of charges
         Scalar getQSum();
 
@@ -109,8 +156,9 @@ class PYBIND11_EXPORT PPPMForceCompute : public ForceCompute
         unsigned int m_n_cells;             //!< Total number of inner cells
         unsigned int m_radius;              //!< Stencil radius (in units of mesh size)
         unsigned int m_n_inner_cells;       //!< Number of inner mesh points (without ghost cells)
+        unsigned int m_n_fourier_cells;     //!< Number of stored Fourier coefficients
         GlobalArray<Scalar> m_inf_f;           //!< Fourier representation of the influence function (real part)
-        GlobalArray<Scalar3> m_k;              //!< Mesh of k values
+        GlobalArray<Scalar3> m_k;              //!< Mesh of k values (CPU: multiplied with the influence function)
         Scalar m_qstarsq;                   //!< Short wave length cut-off squared for density harmonics
         bool m_need_initialize;             //!< True if we have not yet computed the influence function
         bool m_params_set;                  //!< True if parameters are set
@@ -118,6 +166,9 @@ class PYBIND11_EXPORT PPPMForceCompute : public ForceCompute
 
         GlobalArray<Scalar> m_virial_mesh;     //!< k-space mesh of virial tensor values
 
+        bool m_ad;                          //!< True if forces are computed with analytical differentiation
+        Scalar m_sf_coeff[6];               //!< Coefficients of the ad self force (two per mesh axis)
+
         Scalar m_kappa;                     //!< Splitting parameter
         Scalar m_rcut;                      //!< Cutoff for short-ranged interaction
         int m_order;                        //!< Order of interpolation scheme
@@ -178,8 +229,7 @@ class PYBIND11_EXPORT PPPMForceCompute : public ForceCompute
         virtual void computeBodyCorrection();
 
     private:
-        kiss_fftnd_cfg m_kiss_fft;         //!< The FFT configuration
-        kiss_fftnd_cfg m_kiss_ifft;        //!< Inverse FFT configuration
+        std::unique_ptr<RealFFT3D> m_real_fft; //!< The local real-to-complex FFT
 
         #ifdef ENABLE_MPI
         dfft_plan m_dfft_plan_forward;     //!< Distributed FFT for forward transform
@@ -188,8 +238,9 @@ class PYBIND11_EXPORT PPPMForceCompute : public ForceCompute
         std::unique_ptr<CommunicatorGrid<kiss_fft_cpx> > m_grid_comm_reverse; //!< Communicator for inv fourier mesh
         #endif
 
-        bool m_kiss_fft_initialized;               //!< True if a local KISS FFT has been set up
+        bool m_kiss_fft_initialized;               //!< True if a local (real-to-complex) KISS FFT has been set up
 
+        //! Real space meshes hold kiss_fft_scalar values (packed into the complex arrays) for the local FFT
         GlobalArray<kiss_fft_cpx> m_mesh;             //!< The particle density mesh
         GlobalArray<kiss_fft_cpx> m_fourier_mesh;     //!< The fourier transformed mesh
         GlobalArray<kiss_fft_cpx> m_fourier_mesh_G_x;   //!< Fourier transformed mesh times the influence function, x-component
@@ -198,6 +249,13 @@ class PYBIND11_EXPORT PPPMForceCompute : public ForceCompute
         GlobalArray<kiss_fft_cpx> m_inv_fourier_mesh_x;   //!< Fourier transformed mesh times the influence function, x-component
         GlobalArray<kiss_fft_cpx> m_inv_fourier_mesh_y;   //!< Fourier transformed mesh times the influence function, y-component
         GlobalArray<kiss_fft_cpx> m_inv_fourier_mesh_z;   //!< Fourier transformed mesh times the influence function, z-component
+        GlobalArray<kiss_fft_cpx> m_fourier_mesh_G;       //!< Fourier transformed potential (ad)
+        GlobalArray<kiss_fft_cpx> m_inv_fourier_mesh;     //!< Potential on the mesh (ad)
+
+        #ifdef ENABLE_TBB
+        std::vector<unsigned int> m_particle_slab;    //!< Slab of each group member (multithreaded assignment)
+        std::vector<unsigned int> m_slab_particles;   //!< Particle indices sorted by slab (multithreaded assignment)
+        #endif
 
         std::vector<std::string> m_log_names;           //!< Name of the log quantity
 
@@ -221,6 +279,21 @@ class PYBIND11_EXPORT PPPMForceCompute : public ForceCompute
         //! computes coefficients for the Green's function
         Scalar gf_denom(Scalar x, Scalar y, Scalar z);
 
+        //! Evaluate the influence function at one wave vector
+        Scalar evalInfluenceFunction(int3 n, const Scalar3 *b, Scalar3 kH, int3 nb, Scalar3& k);
+
+        //! Compute the contributions of one wave vector to the self force coefficients (ad)
+        void evalSelfForcePrecoeff(int3 n, Scalar *precoeff);
+
+        //! Find the center of the assignment stencil of a particle
+        bool findMeshPoint(const Scalar3& pos, const BoxDim& box, int3& cell, Scalar3& d, Scalar3& reduced_pos);
+
+        //! Get the number of kiss_fft_scalar values between neighboring points of a real space mesh
+        unsigned int getMeshStride()
+            {
+            return m_kiss_fft_initialized ? 1 : 2;
+            }
+
     };
 
 void export_PPPMForceCompute(pybind11::module& m);
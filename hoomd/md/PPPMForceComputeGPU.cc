@@ -50,6 +50,20 @@ PPPMForceComputeGPU::~PPPMForceComputeGPU()
     #endif
     }
 
+/*! \param ad True to compute forces with analytical differentiation
+
+    The GPU kernels only implement ik differentiation.
+ */
+void PPPMForceComputeGPU::setAnalyticalDifferentiation(bool ad)
+    {
+    if (ad)
+        {
+        m_exec_conf->msg->error() << "charge.pppm: Analytical differentiation is not supported on the GPU" << std::endl;
+        throw std::runtime_error("Error setting PPPM parameters");
+        }
+    PPPMForceCompute::setAnalyticalDifferentiation(ad);
+    }
+
 void PPPMForceComputeGPU::initializeFFT()
     {
     #ifdef ENABLE_MPI
@@ -64,6 +64,9 @@ class PYBIND11_EXPORT PPPMForceComputeGPU : public PPPMForceCompute
             m_tuner_influence->setEnabled(enable);
             }
 
+        //! Choose between ik and analytical differentiation (only ik is supported)
+        virtual void setAnalyticalDifferentiation(bool ad);
+
     protected:
         //! Helper function to setup FFT and allocate the mesh arrays
         virtual void initializeFFT();
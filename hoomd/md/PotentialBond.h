@@ -4,9 +4,16 @@
 #include <memory>
 #include "hoomd/ForceCompute.h"
 #include "hoomd/GPUArray.h"
+#include "ThreadBlockForces.h"
 
 #include <vector>
 
+#ifdef ENABLE_TBB
+#include <atomic>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
+
 /*! \file PotentialBond.h
     \brief Declares PotentialBond
 */
@@ -38,6 +45,24 @@ class PotentialBond : public ForceCompute
         //! Destructor
         virtual ~PotentialBond();
 
+        //! The bond forces only read shared data and may be computed concurrently
+        virtual bool canComputeConcurrently() const
+            {
+            return true;
+            }
+
+        //! Get the name of the profiler category for this ForceCompute
+        virtual std::string getProfileName() const
+            {
+            return m_prof_name;
+            }
+
+        //! Rebuild the bond table before the forces are computed concurrently
+        virtual void prepareConcurrentCompute(unsigned int timestep)
+            {
+            m_bond_data->getGPUTable();
+            }
+
         /// Set the parameters
         virtual void setParams(unsigned int type, const param_type &param);
         virtual void setParamsPython(std::string type,
@@ -66,8 +91,18 @@ class PotentialBond : public ForceCompute
         std::string m_log_name;                     //!< Cached log name
         std::string m_prof_name;                    //!< Cached profiler name
 
+        #ifdef ENABLE_TBB
+        ThreadBlockForces m_block_forces;           //!< Forces computed by several threads
+        #endif
+
         //! Actually compute the forces
         virtual void computeForces(unsigned int timestep);
+
+        //! The bond forces can be added directly to the net force arrays
+        virtual bool supportsNetForceAccumulation() const
+            {
+            return true;
+            }
     };
 
 /*! \param sysdef System to compute forces on
@@ -185,6 +220,10 @@ Scalar PotentialBond< evaluator >::getLogValue(const std::string& quantity, unsi
 
 /*! Actually perform the force computation
     \param timestep Current time step
+
+    In TBB enabled builds with more than one thread, the particles are split into one block per thread. Each particle
+    loops over its bonds in the particle-centric lookup table of the BondData and evaluates those it leads, i.e.
+    where it is the first local member. The forces on particles of other blocks are collected by m_block_forces.
  */
 template< class evaluator >
 void PotentialBond< evaluator >::computeForces(unsigned int timestep)
@@ -193,14 +232,27 @@ void PotentialBond< evaluator >::computeForces(unsigned int timestep)
 
     assert(m_pdata);
 
+    const unsigned int N = m_pdata->getN();
+
+    bool by_particle = false;
+    #ifdef ENABLE_TBB
+    const unsigned int n_blocks = m_exec_conf->getNumThreads();
+    by_particle = n_blocks > 1 && N > n_blocks;
+    #endif
+
+    // the lookup table is rebuilt on demand, before any particle data is accessed
+    if (by_particle)
+        m_bond_data->getGPUTable();
+
     // access the particle data arrays
     ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
     ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
     ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
 
-    ArrayHandle<Scalar4> h_force(m_force,access_location::host, access_mode::readwrite);
-    ArrayHandle<Scalar> h_virial(m_virial,access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_force(this->getForceOutput(),access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar> h_virial(this->getVirialOutput(),access_location::host, access_mode::readwrite);
+    const unsigned int virial_pitch = this->getVirialOutput().getPitch();
 
     // access the parameters
     ArrayHandle<param_type> h_params(m_params, access_location::host, access_mode::read);
@@ -213,9 +265,12 @@ void PotentialBond< evaluator >::computeForces(unsigned int timestep)
     assert(h_diameter.data);
     assert(h_charge.data);
 
-    // Zero data for force calculation
-    memset((void*)h_force.data,0,sizeof(Scalar4)*m_force.getNumElements());
-    memset((void*)h_virial.data,0,sizeof(Scalar)*m_virial.getNumElements());
+    // Zero data for force calculation, unless the forces are added to the net force
+    if (!m_accumulate_net_force)
+        {
+        memset((void*)h_force.data,0,sizeof(Scalar4)*m_force.getNumElements());
+        memset((void*)h_virial.data,0,sizeof(Scalar)*m_virial.getNumElements());
+        }
 
     // we are using the minimum image of the global box here
     // to ensure that ghosts are always correctly wrapped (even if a bond exceeds half the domain length)
@@ -224,44 +279,16 @@ void PotentialBond< evaluator >::computeForces(unsigned int timestep)
     PDataFlags flags = this->m_pdata->getFlags();
     bool compute_virial = flags[pdata_flag::pressure_tensor];
 
-    Scalar bond_virial[6];
-    for (unsigned int i = 0; i< 6; i++)
-        bond_virial[i]=Scalar(0.0);
-
-    ArrayHandle<typename BondData::members_t> h_bonds(m_bond_data->getMembersArray(), access_location::host, access_mode::read);
-    ArrayHandle<typeval_t> h_typeval(m_bond_data->getTypeValArray(), access_location::host, access_mode::read);
-
-    unsigned int max_local = m_pdata->getN() + m_pdata->getNGhosts();
-
-    // for each of the bonds
-    const unsigned int size = (unsigned int)m_bond_data->getN();
-
-    for (unsigned int i = 0; i < size; i++)
+    // evaluates the bond between a and b, dx points from a to b
+    auto evaluate = [&](unsigned int idx_a, unsigned int idx_b, unsigned int type,
+                        Scalar3& dx, Scalar& force_divr, Scalar& bond_eng, Scalar *bond_virial) -> bool
         {
-        // lookup the tag of each of the particles participating in the bond
-        const typename BondData::members_t& bond = h_bonds.data[i];
-        assert(bond.tag[0] < m_pdata->getMaximumTag()+1);
-        assert(bond.tag[1] < m_pdata->getMaximumTag()+1);
-
-        // transform a and b into indices into the particle data arrays
-        // (MEM TRANSFER: 4 integers)
-        unsigned int idx_a = h_rtag.data[bond.tag[0]];
-        unsigned int idx_b = h_rtag.data[bond.tag[1]];
-
-        // throw an error if this bond is incomplete
-        if (idx_a >= max_local || idx_b >= max_local)
-            {
-            this->m_exec_conf->msg->error() << "bond." << evaluator::getName() << ": bond " <<
-                bond.tag[0] << " " << bond.tag[1] << " incomplete." << std::endl << std::endl;
-            throw std::runtime_error("Error in bond calculation");
-            }
-
         // calculate d\vec{r}
         // (MEM TRANSFER: 6 Scalars / FLOPS: 3)
         Scalar3 posa = make_scalar3(h_pos.data[idx_a].x, h_pos.data[idx_a].y, h_pos.data[idx_a].z);
         Scalar3 posb = make_scalar3(h_pos.data[idx_b].x, h_pos.data[idx_b].y, h_pos.data[idx_b].z);
 
-        Scalar3 dx = posb - posa;
+        dx = posb - posa;
 
         // access diameter (if needed)
         Scalar diameter_a = Scalar(0.0);
@@ -288,9 +315,9 @@ void PotentialBond< evaluator >::computeForces(unsigned int timestep)
         Scalar rsq = dot(dx,dx);
 
         // compute the force and potential energy
-        Scalar force_divr = Scalar(0.0);
-        Scalar bond_eng = Scalar(0.0);
-        evaluator eval(rsq, h_params.data[h_typeval.data[i].type]);
+        force_divr = Scalar(0.0);
+        bond_eng = Scalar(0.0);
+        evaluator eval(rsq, h_params.data[type]);
         if (evaluator::needsDiameter())
             eval.setDiameter(diameter_a,diameter_b);
         if (evaluator::needsCharge())
@@ -301,22 +328,124 @@ void PotentialBond< evaluator >::computeForces(unsigned int timestep)
         // Bond energy must be halved
         bond_eng *= Scalar(0.5);
 
-        if (evaluated)
+        // calculate virial
+        if (evaluated && compute_virial)
+            {
+            Scalar force_div2r = Scalar(1.0/2.0)*force_divr;
+            bond_virial[0] = dx.x * dx.x * force_div2r; // xx
+            bond_virial[1] = dx.x * dx.y * force_div2r; // xy
+            bond_virial[2] = dx.x * dx.z * force_div2r; // xz
+            bond_virial[3] = dx.y * dx.y * force_div2r; // yy
+            bond_virial[4] = dx.y * dx.z * force_div2r; // yz
+            bond_virial[5] = dx.z * dx.z * force_div2r; // zz
+            }
+
+        return evaluated;
+        };
+
+    #ifdef ENABLE_TBB
+    if (by_particle)
+        {
+        ArrayHandle<typename BondData::members_t> h_gpu_bondlist(m_bond_data->getGPUTable(),
+                                                                 access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_gpu_bond_pos(m_bond_data->getGPUPosTable(),
+                                                 access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_n_bonds(m_bond_data->getNGroupsArray(), access_location::host, access_mode::read);
+        const Index2D& table_indexer = m_bond_data->getGPUTableIndexer();
+
+        std::atomic<bool> out_of_bounds(false);
+        m_block_forces.setup(N, n_blocks);
+
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_blocks, 1),
+            [&](const tbb::blocked_range<unsigned int>& r)
             {
-            // calculate virial
-            if (compute_virial)
+            for (unsigned int blk = r.begin(); blk != r.end(); ++blk)
                 {
-                Scalar force_div2r = Scalar(1.0/2.0)*force_divr;
-                bond_virial[0] = dx.x * dx.x * force_div2r; // xx
-                bond_virial[1] = dx.x * dx.y * force_div2r; // xy
-                bond_virial[2] = dx.x * dx.z * force_div2r; // xz
-                bond_virial[3] = dx.y * dx.y * force_div2r; // yy
-                bond_virial[4] = dx.y * dx.z * force_div2r; // yz
-                bond_virial[5] = dx.z * dx.z * force_div2r; // zz
+                for (unsigned int idx = m_block_forces.begin(blk); idx < m_block_forces.begin(blk+1); idx++)
+                    {
+                    for (unsigned int j = 0; j < h_n_bonds.data[idx]; j++)
+                        {
+                        const typename BondData::members_t& bond = h_gpu_bondlist.data[table_indexer(idx, j)];
+                        bool is_b = h_gpu_bond_pos.data[table_indexer(idx, j)] == 1;
+
+                        // a local first member leads the bond
+                        if (is_b && bond.idx[0] < N)
+                            continue;
+
+                        unsigned int idx_a = is_b ? bond.idx[0] : idx;
+                        unsigned int idx_b = is_b ? idx : bond.idx[0];
+
+                        Scalar3 dx;
+                        Scalar force_divr, bond_eng, bond_virial[6];
+                        if (!evaluate(idx_a, idx_b, bond.idx[1], dx, force_divr, bond_eng, bond_virial))
+                            {
+                            out_of_bounds = true;
+                            continue;
+                            }
+
+                        const Scalar *virial = compute_virial ? bond_virial : NULL;
+                        if (idx_b < N)
+                            m_block_forces.add(blk, idx_b,
+                                make_scalar4(force_divr * dx.x, force_divr * dx.y, force_divr * dx.z, bond_eng),
+                                virial, h_force.data, h_virial.data, virial_pitch);
+                        if (idx_a < N)
+                            m_block_forces.add(blk, idx_a,
+                                make_scalar4(-force_divr * dx.x, -force_divr * dx.y, -force_divr * dx.z, bond_eng),
+                                virial, h_force.data, h_virial.data, virial_pitch);
+                        }
+                    }
                 }
+            });
+
+        m_block_forces.apply(h_force.data, h_virial.data, virial_pitch, compute_virial);
+
+        if (out_of_bounds)
+            {
+            this->m_exec_conf->msg->error() << "bond." << evaluator::getName() << ": bond out of bounds" << std::endl << std::endl;
+            throw std::runtime_error("Error in bond calculation");
+            }
+
+        if (m_prof) m_prof->pop();
+        return;
+        }
+    #endif
+
+    ArrayHandle<typename BondData::members_t> h_bonds(m_bond_data->getMembersArray(), access_location::host, access_mode::read);
+    ArrayHandle<typeval_t> h_typeval(m_bond_data->getTypeValArray(), access_location::host, access_mode::read);
+
+    unsigned int max_local = m_pdata->getN() + m_pdata->getNGhosts();
+
+    // for each of the bonds
+    const unsigned int size = (unsigned int)m_bond_data->getN();
 
+    for (unsigned int i = 0; i < size; i++)
+        {
+        // lookup the tag of each of the particles participating in the bond
+        const typename BondData::members_t& bond = h_bonds.data[i];
+        assert(bond.tag[0] < m_pdata->getMaximumTag()+1);
+        assert(bond.tag[1] < m_pdata->getMaximumTag()+1);
+
+        // transform a and b into indices into the particle data arrays
+        // (MEM TRANSFER: 4 integers)
+        unsigned int idx_a = h_rtag.data[bond.tag[0]];
+        unsigned int idx_b = h_rtag.data[bond.tag[1]];
+
+        // throw an error if this bond is incomplete
+        if (idx_a >= max_local || idx_b >= max_local)
+            {
+            this->m_exec_conf->msg->error() << "bond." << evaluator::getName() << ": bond " <<
+                bond.tag[0] << " " << bond.tag[1] << " incomplete." << std::endl << std::endl;
+            throw std::runtime_error("Error in bond calculation");
+            }
+
+        Scalar3 dx;
+        Scalar force_divr, bond_eng, bond_virial[6];
+        bool evaluated = evaluate(idx_a, idx_b, h_typeval.data[i].type, dx, force_divr, bond_eng, bond_virial);
+
+        if (evaluated)
+            {
             // add the force to the particles (only for non-ghost particles)
-            if (idx_b < m_pdata->getN())
+            if (idx_b < N)
                 {
                 h_force.data[idx_b].x += force_divr * dx.x;
                 h_force.data[idx_b].y += force_divr * dx.y;
@@ -324,10 +453,10 @@ void PotentialBond< evaluator >::computeForces(unsigned int timestep)
                 h_force.data[idx_b].w += bond_eng;
                 if (compute_virial)
                     for (unsigned int i = 0; i < 6; i++)
-                        h_virial.data[i*m_virial_pitch+idx_b]  += bond_virial[i];
+                        h_virial.data[i*virial_pitch+idx_b]  += bond_virial[i];
                 }
 
-            if (idx_a < m_pdata->getN())
+            if (idx_a < N)
                 {
                 h_force.data[idx_a].x -= force_divr * dx.x;
                 h_force.data[idx_a].y -= force_divr * dx.y;
@@ -335,7 +464,7 @@ void PotentialBond< evaluator >::computeForces(unsigned int timestep)
                 h_force.data[idx_a].w += bond_eng;
                 if (compute_virial)
                     for (unsigned int i = 0; i < 6; i++)
-                        h_virial.data[i*m_virial_pitch+idx_a]  += bond_virial[i];
+                        h_virial.data[i*virial_pitch+idx_a]  += bond_virial[i];
                 }
             }
         else
@@ -34,6 +34,18 @@ class PotentialExternal: public ForceCompute
                                      const std::string& log_suffix="");
         virtual ~PotentialExternal<evaluator>();
 
+        //! The external forces only read shared data and may be computed concurrently
+        virtual bool canComputeConcurrently() const
+            {
+            return true;
+            }
+
+        //! Get the name of the profiler category for this ForceCompute
+        virtual std::string getProfileName() const
+            {
+            return "PotentialExternal";
+            }
+
         //! type of external potential parameters
         typedef typename evaluator::param_type param_type;
         typedef typename evaluator::field_type field_type;
@@ -57,6 +69,12 @@ class PotentialExternal: public ForceCompute
         //! Actually compute the forces
         virtual void computeForces(unsigned int timestep);
 
+        //! The external forces can be added directly to the net force arrays
+        virtual bool supportsNetForceAccumulation() const
+            {
+            return true;
+            }
+
         //! Method to be called when number of types changes
         virtual void slotNumTypesChange()
             {
@@ -143,8 +161,10 @@ void PotentialExternal<evaluator>::computeForces(unsigned int timestep)
     // access the particle data arrays
     ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
 
-    ArrayHandle<Scalar4> h_force(m_force,access_location::host, access_mode::overwrite);
-    ArrayHandle<Scalar> h_virial(m_virial,access_location::host, access_mode::overwrite);
+    // the forces are added to the net force arrays when requested
+    const access_mode::Enum force_mode = this->m_accumulate_net_force ? access_mode::readwrite : access_mode::overwrite;
+    ArrayHandle<Scalar4> h_force(this->getForceOutput(),access_location::host, force_mode);
+    ArrayHandle<Scalar> h_virial(this->getVirialOutput(),access_location::host, force_mode);
     ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
     ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
 
@@ -168,13 +188,18 @@ void PotentialExternal<evaluator>::computeForces(unsigned int timestep)
     unsigned int nparticles = m_pdata->getN();
 
     // Zero data for force calculation.
-    memset((void*)h_force.data,0,sizeof(Scalar4)*m_force.getNumElements());
-    memset((void*)h_virial.data,0,sizeof(Scalar)*m_virial.getNumElements());
+    if (!this->m_accumulate_net_force)
+        {
+        memset((void*)h_force.data,0,sizeof(Scalar4)*m_force.getNumElements());
+        memset((void*)h_virial.data,0,sizeof(Scalar)*m_virial.getNumElements());
+        }
 
    // there are enough other checks on the input data: but it doesn't hurt to be safe
     assert(h_force.data);
     assert(h_virial.data);
 
+    const unsigned int virial_pitch = this->getVirialOutput().getPitch();
+
     // for each of the particles
     for (unsigned int idx = 0; idx < nparticles; idx++)
         {
@@ -201,12 +226,12 @@ void PotentialExternal<evaluator>::computeForces(unsigned int timestep)
         eval.evalForceEnergyAndVirial(F, energy, virial);
 
         // apply the constraint force
-        h_force.data[idx].x = F.x;
-        h_force.data[idx].y = F.y;
-        h_force.data[idx].z = F.z;
-        h_force.data[idx].w = energy;
+        h_force.data[idx].x += F.x;
+        h_force.data[idx].y += F.y;
+        h_force.data[idx].z += F.z;
+        h_force.data[idx].w += energy;
         for (int k = 0; k < 6; k++)
-            h_virial.data[k*m_virial_pitch+idx]  = virial[k];
+            h_virial.data[k*virial_pitch+idx]  += virial[k];
         }
 
 
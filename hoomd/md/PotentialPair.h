@@ -10,6 +10,7 @@
 #include <iostream>
 #include <stdexcept>
 #include <memory>
+#include <type_traits>
 #include <pybind11/pybind11.h>
 #include <pybind11/numpy.h>
 
@@ -17,6 +18,7 @@
 #include "hoomd/Index1D.h"
 #include "hoomd/GlobalArray.h"
 #include "hoomd/ForceCompute.h"
+#include "hoomd/ClockSource.h"
 #include "NeighborList.h"
 #include "hoomd/GSDShapeSpecWriter.h"
 #include "hoomd/md/EvaluatorPairLJ.h"
@@ -29,6 +31,11 @@
 #include "hoomd/Communicator.h"
 #endif
 
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
+
 
 /*! \file PotentialPair.h
     \brief Defines the template class for standard pair potentials
@@ -40,6 +47,55 @@
 #error This header cannot be compiled by nvcc
 #endif
 
+namespace hoomd
+{
+namespace detail
+{
+//! Number of neighbors gathered into one block for batched pair evaluation
+const unsigned int pair_batch_width = 16;
+
+//! Helper type for detecting member functions
+template<class T>
+struct pair_void_type
+    {
+    typedef void type;
+    };
+
+//! Trait that is true when an evaluator provides evalForceAndEnergyBatch()
+template<class evaluator, class Enable = void>
+struct pair_has_batch_eval : std::false_type { };
+
+template<class evaluator>
+struct pair_has_batch_eval<evaluator,
+    typename pair_void_type<decltype(&evaluator::evalForceAndEnergyBatch)>::type> : std::true_type { };
+
+//! Call the batched evaluation of an evaluator that provides one
+template<class evaluator>
+inline void pair_eval_batch(std::true_type,
+                            const Scalar *rsq,
+                            const Scalar *rcutsq,
+                            const typename evaluator::param_type *params,
+                            Scalar *force_divr,
+                            Scalar *pair_eng,
+                            bool energy_shift)
+    {
+    evaluator::evalForceAndEnergyBatch(pair_batch_width, rsq, rcutsq, params, force_divr, pair_eng, energy_shift);
+    }
+
+//! Fallback for evaluators without a batched evaluation (never called)
+template<class evaluator>
+inline void pair_eval_batch(std::false_type,
+                            const Scalar *rsq,
+                            const Scalar *rcutsq,
+                            const typename evaluator::param_type *params,
+                            Scalar *force_divr,
+                            Scalar *pair_eng,
+                            bool energy_shift)
+    {
+    }
+} // end namespace detail
+} // end namespace hoomd
+
 //! Template class for computing pair potentials
 /*! <b>Overview:</b>
     PotentialPair computes standard pair potentials (and forces) between all particle pairs in the simulation. It
@@ -55,6 +111,8 @@
      - Per type pair parameters are stored and a set method is provided
      - Logging methods are provided for the energy
      - And all the details about looping through the particles, computing dr, computing the virial, etc. are handled
+     - When built with TBB and more than one thread is active, the CPU force loop runs in parallel
+     - Evaluators that provide evalForceAndEnergyBatch() are evaluated on blocks of neighbors on the CPU
 
     A note on the design of XPLOR switching:
     We need to be able to handle smooth XPLOR switching in systems of mixed LJ/WCA particles. There are three modes to
@@ -79,6 +137,25 @@
     potential evaluator class passed in. See the appropriate documentation for the evaluator for the definition of each
     element of the parameters.
 
+    When TBB is enabled and ExecutionConfiguration reports more than one thread, computeForces() splits the local
+    particles into one contiguous block per thread. With a full neighbor list, every block writes only the forces
+    of its own particles. With a half neighbor list, every block still writes the forces of the particles it owns
+    (m_thread_owner) directly, but the third law reaction on a particle owned by another block would race. Such
+    contributions are appended to a buffer per pair of source and target block (m_thread_records), and each target
+    block applies its buffers in source block order afterwards. The extra memory is proportional to the number of
+    pairs that cross block boundaries, not to the number of threads times the number of particles, and the result
+    is bitwise reproducible for a fixed number of threads.
+
+    When the evaluator provides evalForceAndEnergyBatch() (see EvaluatorPairLJ) and the shift mode is not xplor, the CPU
+    path gathers the neighbors of each particle into structure-of-arrays blocks of hoomd::detail::pair_batch_width
+    pairs (distance vectors, rsq, rcutsq and parameters) and evaluates a whole block per call. The per-pair branches
+    on the shift mode are hoisted out of the loop, and the evaluation can be vectorized by the compiler (SSE, AVX2 or
+    AVX-512 depending on the target architecture). All other evaluators use the per pair loop.
+
+    The CPU kernels are templates on the shift mode, the virial flag and the neighbor list storage mode (third law).
+    computeForcesRange() selects the instantiation once per call, so the pair loop itself contains no tests of these
+    settings. benchmarkKernels() reports the time per neighbor list entry for every instantiation.
+
     For profiling and logging, PotentialPair needs to know the name of the potential. For now, that will be queried from
     the evaluator. Perhaps in the future we could allow users to change that so multiple pair potentials could be logged
     independently.
@@ -189,6 +266,27 @@ class PotentialPair : public ForceCompute
         virtual CommFlags getRequestedCommFlags(unsigned int timestep);
         #endif
 
+        //! The pair forces only read shared data and may be computed concurrently
+        virtual bool canComputeConcurrently() const
+            {
+            return true;
+            }
+
+        //! The neighbor list is built before the pair forces are computed concurrently
+        virtual std::vector< std::shared_ptr<Compute> > getDependencies()
+            {
+            return std::vector< std::shared_ptr<Compute> >(1, m_nlist);
+            }
+
+        //! Get the name of the profiler category for this ForceCompute
+        virtual std::string getProfileName() const
+            {
+            return m_prof_name;
+            }
+
+        //! Time each CPU force kernel instantiation
+        pybind11::dict benchmarkKernels(unsigned int num_iters);
+
         //! Calculates the energy between two lists of particles.
         template< class InputIterator >
         void computeEnergyBetweenSets(  InputIterator first1, InputIterator last1,
@@ -226,9 +324,93 @@ class PotentialPair : public ForceCompute
         /// r_cut (not squared) given to the neighbor list
         std::shared_ptr<GlobalArray<Scalar>> m_r_cut_nlist;
 
+        //! Third law contribution to a particle owned by another block
+        struct pair_record_t
+            {
+            Scalar4 force;                  //!< Force and energy
+            Scalar virial[6];               //!< Virial
+            unsigned int j;                 //!< Index of the particle
+            };
+
+        #ifdef ENABLE_TBB
+        std::vector<unsigned int> m_thread_owner;   //!< Block that owns each particle (third law, multithreaded)
+        std::vector< std::vector<pair_record_t> > m_thread_records; //!< Contributions per source and target block
+        #endif
+
+        //! Pointers to the data accessed by the CPU force kernels
+        struct kernel_args_t
+            {
+            const Scalar4 *pos;             //!< Particle positions and types
+            const Scalar *diameter;         //!< Particle diameters
+            const Scalar *charge;           //!< Particle charges
+            const unsigned int *n_neigh;    //!< Number of neighbors of each particle
+            const unsigned int *nlist;      //!< Neighbor list
+            const unsigned int *head_list;  //!< Index of the first neighbor of each particle in nlist
+            const Scalar *ronsq;            //!< r_on squared per type pair
+            const Scalar *rcutsq;           //!< r_cut squared per type pair
+            const param_type *params;       //!< Pair parameters per type pair
+            Scalar4 *force;                 //!< Output forces
+            Scalar *virial;                 //!< Output virials
+            unsigned int virial_pitch;      //!< Pitch of the virial array
+            const unsigned int *index;      //!< Indices of the particles to compute, NULL to compute the range itself
+            const unsigned int *owner;      //!< Block that owns each particle, NULL if the kernel owns all particles
+            unsigned int block;             //!< Block of the particles computed by the kernel
+            std::vector<pair_record_t> *records;    //!< Contributions to particles of other blocks, per owner
+            };
+
         //! Actually compute the forces
         virtual void computeForces(unsigned int timestep);
 
+        //! Compute the forces on the particles that do not interact with ghost particles
+        virtual bool computeInteriorForces(unsigned int timestep);
+
+        //! The pair forces can be added directly to the net force arrays
+        virtual bool supportsNetForceAccumulation() const
+            {
+            return true;
+            }
+
+        //! Compute the forces on all local particles
+        void computeForcesAll(bool third_law, bool compute_virial);
+
+        //! Compute the forces on a list of local particles
+        void computeForcesList(const unsigned int *index,
+                               unsigned int n,
+                               bool accumulate,
+                               bool third_law,
+                               bool compute_virial);
+
+        //! Compute the pair forces on a contiguous range of particles
+        void computeForcesRange(unsigned int first,
+                                unsigned int last,
+                                const kernel_args_t& args,
+                                bool third_law,
+                                bool compute_virial);
+
+        //! Select the kernel for a given shift mode
+        template< unsigned int shift_mode >
+        void computeForcesRangeShift(unsigned int first,
+                                     unsigned int last,
+                                     const kernel_args_t& args,
+                                     bool third_law,
+                                     bool compute_virial);
+
+        //! Pair force kernel specialized on the shift mode, virial flag and neighbor list storage
+        template< unsigned int shift_mode, bool compute_virial, bool third_law >
+        void computeForcesKernel(unsigned int first, unsigned int last, const kernel_args_t& args);
+
+        //! Pair force kernel with batched evaluation
+        template< unsigned int shift_mode, bool compute_virial, bool third_law >
+        void computeForcesKernelBatch(unsigned int first, unsigned int last, const kernel_args_t& args);
+
+        //! Add the third law reaction of a pair to the local particle j
+        template< bool compute_virial >
+        inline void addThirdLawForce(const kernel_args_t& args,
+                                     unsigned int j,
+                                     const Scalar3& dx,
+                                     Scalar force_divr,
+                                     Scalar pair_eng);
+
         //! Method to be called when number of types changes
         virtual void slotNumTypesChange()
             {
@@ -614,40 +796,327 @@ void PotentialPair< evaluator >::computeForces(unsigned int timestep)
     // to reduce computations at the cost of memory access complexity: set that flag now
     bool third_law = m_nlist->getStorageMode() == NeighborList::half;
 
+    PDataFlags flags = this->m_pdata->getFlags();
+    bool compute_virial = flags[pdata_flag::pressure_tensor];
+
+    if (m_interior_computed)
+        {
+        // computeInteriorForces() has already computed the particles without ghost neighbors
+        unsigned int n_interior;
+        const std::vector<unsigned int>& interior = m_nlist->getInteriorList(n_interior);
+        computeForcesList(interior.data() + n_interior,
+                          m_pdata->getN() - n_interior,
+                          true,
+                          third_law,
+                          compute_virial);
+        }
+    else
+        {
+        computeForcesAll(third_law, compute_virial);
+        }
+
+    if (m_prof) m_prof->pop();
+    }
+
+/*! \param timestep specifies the current time step of the simulation
+    \returns true, the forces on the remaining particles are added by computeForces()
+
+    Called while the ghost positions are being updated. The neighbor list is not rebuilt on time steps without
+    particle migration, and the positions of the particles computed here do not depend on the ghost update.
+    Splitting the computation changes the order of the force summation, so results are not bitwise identical to
+    a computation without overlap.
+*/
+template< class evaluator >
+bool PotentialPair< evaluator >::computeInteriorForces(unsigned int timestep)
+    {
+    m_nlist->compute(timestep);
+
+    if (m_prof) m_prof->push(m_prof_name);
+
+    bool third_law = m_nlist->getStorageMode() == NeighborList::half;
+
+    PDataFlags flags = this->m_pdata->getFlags();
+    bool compute_virial = flags[pdata_flag::pressure_tensor];
+
+    unsigned int n_interior;
+    const std::vector<unsigned int>& interior = m_nlist->getInteriorList(n_interior);
+    computeForcesList(interior.data(), n_interior, false, third_law, compute_virial);
+
+    if (m_prof) m_prof->pop();
+
+    return true;
+    }
+
+/*! \param third_law True if the neighbor list is stored in half mode
+    \param compute_virial True if the virial should be computed
+
+    Fills m_force and m_virial for all local particles, using all available TBB threads.
+*/
+template< class evaluator >
+void PotentialPair< evaluator >::computeForcesAll(bool third_law, bool compute_virial)
+    {
+    computeForcesList(NULL, m_pdata->getN(), false, third_law, compute_virial);
+    }
+
+/*! \param index Indices of the \a n particles to compute forces for, or NULL for the first \a n particles
+    \param n Number of particles
+    \param accumulate If true, add to the forces in m_force and m_virial instead of overwriting them
+    \param third_law True if the neighbor list is stored in half mode
+    \param compute_virial True if the virial should be computed
+
+    With a half neighbor list, forces are also added to local neighbors that are not in the list. When the forces are
+    added to the net force arrays, they are always accumulated.
+*/
+template< class evaluator >
+void PotentialPair< evaluator >::computeForcesList(const unsigned int *index,
+                                                   unsigned int n,
+                                                   bool accumulate,
+                                                   bool third_law,
+                                                   bool compute_virial)
+    {
     // access the neighbor list, particle data, and system box
     ArrayHandle<unsigned int> h_n_neigh(m_nlist->getNNeighArray(), access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_nlist(m_nlist->getNListArray(), access_location::host, access_mode::read);
-//     Index2D nli = m_nlist->getNListIndexer();
     ArrayHandle<unsigned int> h_head_list(m_nlist->getHeadList(), access_location::host, access_mode::read);
 
     ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
     ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
     ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
 
-
     //force arrays
-    ArrayHandle<Scalar4> h_force(m_force,access_location::host, access_mode::overwrite);
-    ArrayHandle<Scalar>  h_virial(m_virial,access_location::host, access_mode::overwrite);
+    accumulate = accumulate || m_accumulate_net_force;
+    const access_mode::Enum force_mode = accumulate ? access_mode::readwrite : access_mode::overwrite;
+    const GlobalArray<Scalar4>& force_out = this->getForceOutput();
+    const GlobalArray<Scalar>& virial_out = this->getVirialOutput();
+    const unsigned int virial_pitch = virial_out.getPitch();
+    ArrayHandle<Scalar4> h_force(force_out,access_location::host, force_mode);
+    ArrayHandle<Scalar>  h_virial(virial_out,access_location::host, force_mode);
 
-
-    const BoxDim& box = m_pdata->getGlobalBox();
     ArrayHandle<Scalar> h_ronsq(m_ronsq, access_location::host, access_mode::read);
     ArrayHandle<Scalar> h_rcutsq(m_rcutsq, access_location::host, access_mode::read);
     ArrayHandle<param_type> h_params(m_params, access_location::host, access_mode::read);
 
-    PDataFlags flags = this->m_pdata->getFlags();
-    bool compute_virial = flags[pdata_flag::pressure_tensor];
-
     // need to start from a zero force, energy and virial
-    memset((void*)h_force.data,0,sizeof(Scalar4)*m_force.getNumElements());
-    memset((void*)h_virial.data,0,sizeof(Scalar)*m_virial.getNumElements());
+    if (!accumulate)
+        {
+        memset((void*)h_force.data,0,sizeof(Scalar4)*force_out.getNumElements());
+        memset((void*)h_virial.data,0,sizeof(Scalar)*virial_out.getNumElements());
+        }
+
+    kernel_args_t args;
+    args.pos = h_pos.data;
+    args.diameter = h_diameter.data;
+    args.charge = h_charge.data;
+    args.n_neigh = h_n_neigh.data;
+    args.nlist = h_nlist.data;
+    args.head_list = h_head_list.data;
+    args.ronsq = h_ronsq.data;
+    args.rcutsq = h_rcutsq.data;
+    args.params = h_params.data;
+    args.force = h_force.data;
+    args.virial = h_virial.data;
+    args.virial_pitch = virial_pitch;
+    args.index = index;
+    args.owner = NULL;
+    args.block = 0;
+    args.records = NULL;
+
+    const unsigned int N = m_pdata->getN();
+
+    #ifdef ENABLE_TBB
+    const unsigned int n_blocks = m_exec_conf->getNumThreads();
+    if (n_blocks > 1 && n > n_blocks)
+        {
+        // static partition of the particles into one block per thread, so that the summation order
+        // only depends on the number of threads and not on the scheduling
+        auto block_begin = [n, n_blocks](unsigned int b) { return (unsigned int)(((size_t)n*b)/n_blocks); };
+
+        if (!third_law)
+            {
+            // with a full neighbor list, each block only writes forces on its own particles
+            tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_blocks, 1),
+                [&](const tbb::blocked_range<unsigned int>& r)
+                {
+                for (unsigned int b = r.begin(); b != r.end(); ++b)
+                    computeForcesRange(block_begin(b), block_begin(b+1), args, false, compute_virial);
+                });
+            }
+        else
+            {
+            // with a half neighbor list, each block writes the forces of its own particles, and buffers the
+            // reactions on particles of other blocks (or of no block when computing a subset of the particles)
+            m_thread_owner.assign(N, n_blocks);
+            tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_blocks, 1),
+                [&](const tbb::blocked_range<unsigned int>& r)
+                {
+                for (unsigned int b = r.begin(); b != r.end(); ++b)
+                    for (unsigned int ii = block_begin(b); ii < block_begin(b+1); ++ii)
+                        m_thread_owner[index ? index[ii] : ii] = b;
+                });
+
+            const unsigned int n_targets = n_blocks + 1;
+            m_thread_records.resize((size_t)n_blocks*n_targets);
+
+            tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_blocks, 1),
+                [&](const tbb::blocked_range<unsigned int>& r)
+                {
+                for (unsigned int b = r.begin(); b != r.end(); ++b)
+                    {
+                    kernel_args_t block_args = args;
+                    block_args.owner = m_thread_owner.data();
+                    block_args.block = b;
+                    block_args.records = &m_thread_records[(size_t)b*n_targets];
+                    for (unsigned int t = 0; t < n_targets; ++t)
+                        block_args.records[t].clear();
+
+                    computeForcesRange(block_begin(b), block_begin(b+1), block_args, true, compute_virial);
+                    }
+                });
+
+            // each target applies the buffered contributions in a fixed order, the targets own disjoint particles
+            tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_targets, 1),
+                [&](const tbb::blocked_range<unsigned int>& r)
+                {
+                for (unsigned int t = r.begin(); t != r.end(); ++t)
+                    {
+                    for (unsigned int b = 0; b < n_blocks; ++b)
+                        {
+                        for (const pair_record_t& rec : m_thread_records[(size_t)b*n_targets + t])
+                            {
+                            h_force.data[rec.j].x += rec.force.x;
+                            h_force.data[rec.j].y += rec.force.y;
+                            h_force.data[rec.j].z += rec.force.z;
+                            h_force.data[rec.j].w += rec.force.w;
+                            if (compute_virial)
+                                {
+                                for (unsigned int k = 0; k < 6; ++k)
+                                    h_virial.data[k*virial_pitch+rec.j] += rec.virial[k];
+                                }
+                            }
+                        }
+                    }
+                });
+            }
+        return;
+        }
+    #endif
+
+    computeForcesRange(0, n, args, third_law, compute_virial);
+    }
+
+/*! \param first Index of the first particle to compute forces for
+    \param last One past the index of the last particle to compute forces for
+    \param args Input and output arrays
+    \param third_law True if the neighbor list is stored in half mode
+    \param compute_virial True if the virial should be computed
+
+    Selects the kernel instantiation for the current shift mode, \a third_law and \a compute_virial once, so that none
+    of these are tested inside the pair loop.
+*/
+template< class evaluator >
+void PotentialPair< evaluator >::computeForcesRange(unsigned int first,
+                                                    unsigned int last,
+                                                    const kernel_args_t& args,
+                                                    bool third_law,
+                                                    bool compute_virial)
+    {
+    switch (m_shift_mode)
+        {
+        case no_shift:
+            computeForcesRangeShift<no_shift>(first, last, args, third_law, compute_virial);
+            break;
+        case shift:
+            computeForcesRangeShift<shift>(first, last, args, third_law, compute_virial);
+            break;
+        case xplor:
+            computeForcesRangeShift<xplor>(first, last, args, third_law, compute_virial);
+            break;
+        }
+    }
+
+/*! \tparam shift_mode Energy shift mode
+    \param first Index of the first particle to compute forces for
+    \param last One past the index of the last particle to compute forces for
+    \param args Input and output arrays
+    \param third_law True if the neighbor list is stored in half mode
+    \param compute_virial True if the virial should be computed
+*/
+template< class evaluator >
+template< unsigned int shift_mode >
+void PotentialPair< evaluator >::computeForcesRangeShift(unsigned int first,
+                                                         unsigned int last,
+                                                         const kernel_args_t& args,
+                                                         bool third_law,
+                                                         bool compute_virial)
+    {
+    if (third_law)
+        {
+        if (compute_virial)
+            computeForcesKernel<shift_mode, true, true>(first, last, args);
+        else
+            computeForcesKernel<shift_mode, false, true>(first, last, args);
+        }
+    else
+        {
+        if (compute_virial)
+            computeForcesKernel<shift_mode, true, false>(first, last, args);
+        else
+            computeForcesKernel<shift_mode, false, false>(first, last, args);
+        }
+    }
+
+/*! \tparam shift_mode Energy shift mode
+    \tparam compute_virial True if the virial should be computed
+    \tparam third_law True if the neighbor list is stored in half mode
+    \param first Index of the first particle to compute forces for
+    \param last One past the index of the last particle to compute forces for
+    \param args Input and output arrays. The outputs are accumulated and must be initialized by the caller.
+
+    When \a third_law is set, forces are also accumulated on local neighbors j that may lie outside of
+    [\a first, \a last). Concurrent calls on disjoint ranges must therefore set args.owner, so that the
+    contributions to particles of other calls go to args.records (see addThirdLawForce()).
+
+    If args.index is set, the range [\a first, \a last) refers to entries of args.index.
+*/
+template< class evaluator >
+template< unsigned int shift_mode, bool compute_virial, bool third_law >
+void PotentialPair< evaluator >::computeForcesKernel(unsigned int first,
+                                                     unsigned int last,
+                                                     const kernel_args_t& args)
+    {
+    // use the batched kernel when the evaluator supports it
+    if (hoomd::detail::pair_has_batch_eval<evaluator>::value && !evaluator::needsDiameter()
+        && !evaluator::needsCharge() && shift_mode != xplor)
+        {
+        computeForcesKernelBatch<shift_mode, compute_virial, third_law>(first, last, args);
+        return;
+        }
+
+    const BoxDim& box = m_pdata->getGlobalBox();
+    const unsigned int N = m_pdata->getN();
+
+    const Scalar4 * const h_pos = args.pos;
+    const Scalar * const h_diameter = args.diameter;
+    const Scalar * const h_charge = args.charge;
+    const unsigned int * const h_n_neigh = args.n_neigh;
+    const unsigned int * const h_nlist = args.nlist;
+    const unsigned int * const h_head_list = args.head_list;
+    const Scalar * const h_ronsq = args.ronsq;
+    const Scalar * const h_rcutsq = args.rcutsq;
+    const param_type * const h_params = args.params;
+    Scalar4 * const h_force = args.force;
+    Scalar * const h_virial = args.virial;
+    const unsigned int virial_pitch = args.virial_pitch;
+    const unsigned int * const h_index = args.index;
 
     // for each particle
-    for (int i = 0; i < (int)m_pdata->getN(); i++)
+    for (unsigned int ii = first; ii < last; ii++)
         {
+        const unsigned int i = h_index ? h_index[ii] : ii;
+
         // access the particle's position and type (MEM TRANSFER: 4 scalars)
-        Scalar3 pi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
-        unsigned int typei = __scalar_as_int(h_pos.data[i].w);
+        Scalar3 pi = make_scalar3(h_pos[i].x, h_pos[i].y, h_pos[i].z);
+        unsigned int typei = __scalar_as_int(h_pos[i].w);
 
         // sanity check
         assert(typei < m_pdata->getNTypes());
@@ -656,9 +1125,9 @@ void PotentialPair< evaluator >::computeForces(unsigned int timestep)
         Scalar di = Scalar(0.0);
         Scalar qi = Scalar(0.0);
         if (evaluator::needsDiameter())
-            di = h_diameter.data[i];
+            di = h_diameter[i];
         if (evaluator::needsCharge())
-            qi = h_charge.data[i];
+            qi = h_charge[i];
 
         // initialize current particle force, potential energy, and virial to 0
         Scalar3 fi = make_scalar3(0, 0, 0);
@@ -671,29 +1140,29 @@ void PotentialPair< evaluator >::computeForces(unsigned int timestep)
         Scalar virialzzi = 0.0;
 
         // loop over all of the neighbors of this particle
-        const unsigned int myHead = h_head_list.data[i];
-        const unsigned int size = (unsigned int)h_n_neigh.data[i];
+        const unsigned int myHead = h_head_list[i];
+        const unsigned int size = (unsigned int)h_n_neigh[i];
         for (unsigned int k = 0; k < size; k++)
             {
             // access the index of this neighbor (MEM TRANSFER: 1 scalar)
-            unsigned int j = h_nlist.data[myHead + k];
+            unsigned int j = h_nlist[myHead + k];
             assert(j < m_pdata->getN() + m_pdata->getNGhosts());
 
             // calculate dr_ji (MEM TRANSFER: 3 scalars / FLOPS: 3)
-            Scalar3 pj = make_scalar3(h_pos.data[j].x, h_pos.data[j].y, h_pos.data[j].z);
+            Scalar3 pj = make_scalar3(h_pos[j].x, h_pos[j].y, h_pos[j].z);
             Scalar3 dx = pi - pj;
 
             // access the type of the neighbor particle (MEM TRANSFER: 1 scalar)
-            unsigned int typej = __scalar_as_int(h_pos.data[j].w);
+            unsigned int typej = __scalar_as_int(h_pos[j].w);
             assert(typej < m_pdata->getNTypes());
 
             // access diameter and charge (if needed)
             Scalar dj = Scalar(0.0);
             Scalar qj = Scalar(0.0);
             if (evaluator::needsDiameter())
-                dj = h_diameter.data[j];
+                dj = h_diameter[j];
             if (evaluator::needsCharge())
-                qj = h_charge.data[j];
+                qj = h_charge[j];
 
             // apply periodic boundary conditions
             dx = box.minImage(dx);
@@ -703,19 +1172,19 @@ void PotentialPair< evaluator >::computeForces(unsigned int timestep)
 
             // get parameters for this type pair
             unsigned int typpair_idx = m_typpair_idx(typei, typej);
-            param_type param = h_params.data[typpair_idx];
-            Scalar rcutsq = h_rcutsq.data[typpair_idx];
+            param_type param = h_params[typpair_idx];
+            Scalar rcutsq = h_rcutsq[typpair_idx];
             Scalar ronsq = Scalar(0.0);
-            if (m_shift_mode == xplor)
-                ronsq = h_ronsq.data[typpair_idx];
+            if (shift_mode == xplor)
+                ronsq = h_ronsq[typpair_idx];
 
             // design specifies that energies are shifted if
             // 1) shift mode is set to shift
             // or 2) shift mode is explor and ron > rcut
             bool energy_shift = false;
-            if (m_shift_mode == shift)
+            if (shift_mode == shift)
                 energy_shift = true;
-            else if (m_shift_mode == xplor)
+            else if (shift_mode == xplor)
                 {
                 if (ronsq > rcutsq)
                     energy_shift = true;
@@ -735,7 +1204,7 @@ void PotentialPair< evaluator >::computeForces(unsigned int timestep)
             if (evaluated)
                 {
                 // modify the potential for xplor shifting
-                if (m_shift_mode == xplor)
+                if (shift_mode == xplor)
                     {
                     if (rsq >= ronsq && rsq < rcutsq)
                         {
@@ -777,44 +1246,295 @@ void PotentialPair< evaluator >::computeForces(unsigned int timestep)
 
                 // add the force to particle j if we are using the third law (MEM TRANSFER: 10 scalars / FLOPS: 8)
                 // only add force to local particles
-                if (third_law && j < m_pdata->getN())
+                if (third_law && j < N)
+                    addThirdLawForce<compute_virial>(args, j, dx, force_divr, pair_eng);
+                }
+            }
+
+        // finally, increment the force, potential energy and virial for particle i
+        unsigned int mem_idx = i;
+        h_force[mem_idx].x += fi.x;
+        h_force[mem_idx].y += fi.y;
+        h_force[mem_idx].z += fi.z;
+        h_force[mem_idx].w += pei;
+        if (compute_virial)
+            {
+            h_virial[0*virial_pitch+mem_idx] += virialxxi;
+            h_virial[1*virial_pitch+mem_idx] += virialxyi;
+            h_virial[2*virial_pitch+mem_idx] += virialxzi;
+            h_virial[3*virial_pitch+mem_idx] += virialyyi;
+            h_virial[4*virial_pitch+mem_idx] += virialyzi;
+            h_virial[5*virial_pitch+mem_idx] += virialzzi;
+            }
+        }
+    }
+
+/*! \tparam shift_mode Energy shift mode (no_shift or shift)
+    \tparam compute_virial True if the virial should be computed
+    \tparam third_law True if the neighbor list is stored in half mode
+    \param first Index of the first particle to compute forces for
+    \param last One past the index of the last particle to compute forces for
+    \param args Input and output arrays. The outputs are accumulated and must be initialized by the caller.
+
+    The neighbors of each particle are gathered in blocks of hoomd::detail::pair_batch_width into local arrays, and
+    each block is evaluated with one call to evaluator::evalForceAndEnergyBatch(). Unused lanes of the last block are
+    padded with pairs beyond the cutoff, so they contribute zero force. The xplor shift mode is not supported here.
+*/
+template< class evaluator >
+template< unsigned int shift_mode, bool compute_virial, bool third_law >
+void PotentialPair< evaluator >::computeForcesKernelBatch(unsigned int first,
+                                                          unsigned int last,
+                                                          const kernel_args_t& args)
+    {
+    const unsigned int W = hoomd::detail::pair_batch_width;
+    const BoxDim& box = m_pdata->getGlobalBox();
+    const unsigned int N = m_pdata->getN();
+    const bool energy_shift = (shift_mode == shift);
+
+    const Scalar4 * const h_pos = args.pos;
+    const unsigned int * const h_n_neigh = args.n_neigh;
+    const unsigned int * const h_nlist = args.nlist;
+    const unsigned int * const h_head_list = args.head_list;
+    const Scalar * const h_rcutsq = args.rcutsq;
+    const param_type * const h_params = args.params;
+    Scalar4 * const h_force = args.force;
+    Scalar * const h_virial = args.virial;
+    const unsigned int virial_pitch = args.virial_pitch;
+    const unsigned int * const h_index = args.index;
+
+    // structure of arrays for one block of neighbors
+    unsigned int j_block[W];
+    Scalar dx_block[W];
+    Scalar dy_block[W];
+    Scalar dz_block[W];
+    Scalar rsq_block[W];
+    Scalar rcutsq_block[W];
+    param_type param_block[W];
+    Scalar force_divr_block[W];
+    Scalar pair_eng_block[W];
+
+    for (unsigned int ii = first; ii < last; ii++)
+        {
+        const unsigned int i = h_index ? h_index[ii] : ii;
+        Scalar3 pi = make_scalar3(h_pos[i].x, h_pos[i].y, h_pos[i].z);
+        unsigned int typei = __scalar_as_int(h_pos[i].w);
+        assert(typei < m_pdata->getNTypes());
+
+        // initialize current particle force, potential energy, and virial to 0
+        Scalar3 fi = make_scalar3(0, 0, 0);
+        Scalar pei = 0.0;
+        Scalar virialxxi = 0.0;
+        Scalar virialxyi = 0.0;
+        Scalar virialxzi = 0.0;
+        Scalar virialyyi = 0.0;
+        Scalar virialyzi = 0.0;
+        Scalar virialzzi = 0.0;
+
+        const unsigned int myHead = h_head_list[i];
+        const unsigned int size = (unsigned int)h_n_neigh[i];
+        for (unsigned int k0 = 0; k0 < size; k0 += W)
+            {
+            const unsigned int n_block = (size - k0 < W) ? size - k0 : W;
+
+            // gather the neighbors of this block
+            for (unsigned int l = 0; l < n_block; l++)
+                {
+                unsigned int j = h_nlist[myHead + k0 + l];
+                assert(j < m_pdata->getN() + m_pdata->getNGhosts());
+
+                Scalar3 pj = make_scalar3(h_pos[j].x, h_pos[j].y, h_pos[j].z);
+                Scalar3 dx = box.minImage(pi - pj);
+                unsigned int typej = __scalar_as_int(h_pos[j].w);
+                assert(typej < m_pdata->getNTypes());
+
+                unsigned int typpair_idx = m_typpair_idx(typei, typej);
+                j_block[l] = j;
+                dx_block[l] = dx.x;
+                dy_block[l] = dx.y;
+                dz_block[l] = dx.z;
+                rsq_block[l] = dot(dx, dx);
+                rcutsq_block[l] = h_rcutsq[typpair_idx];
+                param_block[l] = h_params[typpair_idx];
+                }
+
+            // pad the block with pairs that are beyond the cutoff
+            for (unsigned int l = n_block; l < W; l++)
+                {
+                dx_block[l] = Scalar(0.0);
+                dy_block[l] = Scalar(0.0);
+                dz_block[l] = Scalar(0.0);
+                rsq_block[l] = Scalar(1.0);
+                rcutsq_block[l] = Scalar(0.0);
+                param_block[l] = param_block[0];
+                }
+
+            hoomd::detail::pair_eval_batch<evaluator>(hoomd::detail::pair_has_batch_eval<evaluator>(),
+                                                      rsq_block,
+                                                      rcutsq_block,
+                                                      param_block,
+                                                      force_divr_block,
+                                                      pair_eng_block,
+                                                      energy_shift);
+
+            // accumulate the forces on particle i, and apply the third law to particle j
+            for (unsigned int l = 0; l < n_block; l++)
+                {
+                Scalar force_divr = force_divr_block[l];
+                Scalar pair_eng = pair_eng_block[l];
+                Scalar3 dx = make_scalar3(dx_block[l], dy_block[l], dz_block[l]);
+                Scalar force_div2r = force_divr * Scalar(0.5);
+
+                fi += dx*force_divr;
+                pei += pair_eng * Scalar(0.5);
+                if (compute_virial)
                     {
-                    unsigned int mem_idx = j;
-                    h_force.data[mem_idx].x -= dx.x*force_divr;
-                    h_force.data[mem_idx].y -= dx.y*force_divr;
-                    h_force.data[mem_idx].z -= dx.z*force_divr;
-                    h_force.data[mem_idx].w += pair_eng * Scalar(0.5);
-                    if (compute_virial)
-                        {
-                        h_virial.data[0*m_virial_pitch+mem_idx] += force_div2r*dx.x*dx.x;
-                        h_virial.data[1*m_virial_pitch+mem_idx] += force_div2r*dx.x*dx.y;
-                        h_virial.data[2*m_virial_pitch+mem_idx] += force_div2r*dx.x*dx.z;
-                        h_virial.data[3*m_virial_pitch+mem_idx] += force_div2r*dx.y*dx.y;
-                        h_virial.data[4*m_virial_pitch+mem_idx] += force_div2r*dx.y*dx.z;
-                        h_virial.data[5*m_virial_pitch+mem_idx] += force_div2r*dx.z*dx.z;
-                        }
+                    virialxxi += force_div2r*dx.x*dx.x;
+                    virialxyi += force_div2r*dx.x*dx.y;
+                    virialxzi += force_div2r*dx.x*dx.z;
+                    virialyyi += force_div2r*dx.y*dx.y;
+                    virialyzi += force_div2r*dx.y*dx.z;
+                    virialzzi += force_div2r*dx.z*dx.z;
                     }
+
+                unsigned int j = j_block[l];
+                if (third_law && j < N)
+                    addThirdLawForce<compute_virial>(args, j, dx, force_divr, pair_eng);
                 }
             }
 
         // finally, increment the force, potential energy and virial for particle i
-        unsigned int mem_idx = i;
-        h_force.data[mem_idx].x += fi.x;
-        h_force.data[mem_idx].y += fi.y;
-        h_force.data[mem_idx].z += fi.z;
-        h_force.data[mem_idx].w += pei;
+        h_force[i].x += fi.x;
+        h_force[i].y += fi.y;
+        h_force[i].z += fi.z;
+        h_force[i].w += pei;
         if (compute_virial)
             {
-            h_virial.data[0*m_virial_pitch+mem_idx] += virialxxi;
-            h_virial.data[1*m_virial_pitch+mem_idx] += virialxyi;
-            h_virial.data[2*m_virial_pitch+mem_idx] += virialxzi;
-            h_virial.data[3*m_virial_pitch+mem_idx] += virialyyi;
-            h_virial.data[4*m_virial_pitch+mem_idx] += virialyzi;
-            h_virial.data[5*m_virial_pitch+mem_idx] += virialzzi;
+            h_virial[0*virial_pitch+i] += virialxxi;
+            h_virial[1*virial_pitch+i] += virialxyi;
+            h_virial[2*virial_pitch+i] += virialxzi;
+            h_virial[3*virial_pitch+i] += virialyyi;
+            h_virial[4*virial_pitch+i] += virialyzi;
+            h_virial[5*virial_pitch+i] += virialzzi;
             }
         }
+    }
 
-    if (m_prof) m_prof->pop();
+/*! \tparam compute_virial True if the virial should be computed
+    \param args Input and output arrays
+    \param j Index of the local particle
+    \param dx Distance vector from j to i
+    \param force_divr Force divided by r
+    \param pair_eng Pair energy
+
+    The contribution is written to the output arrays when the kernel owns particle j, and appended to the records of
+    the block that owns j otherwise.
+*/
+template< class evaluator >
+template< bool compute_virial >
+inline void PotentialPair< evaluator >::addThirdLawForce(const kernel_args_t& args,
+                                                         unsigned int j,
+                                                         const Scalar3& dx,
+                                                         Scalar force_divr,
+                                                         Scalar pair_eng)
+    {
+    const Scalar force_div2r = force_divr * Scalar(0.5);
+    if (!args.owner || args.owner[j] == args.block)
+        {
+        Scalar4 * const h_force = args.force;
+        Scalar * const h_virial = args.virial;
+        const unsigned int virial_pitch = args.virial_pitch;
+
+        h_force[j].x -= dx.x*force_divr;
+        h_force[j].y -= dx.y*force_divr;
+        h_force[j].z -= dx.z*force_divr;
+        h_force[j].w += pair_eng * Scalar(0.5);
+        if (compute_virial)
+            {
+            h_virial[0*virial_pitch+j] += force_div2r*dx.x*dx.x;
+            h_virial[1*virial_pitch+j] += force_div2r*dx.x*dx.y;
+            h_virial[2*virial_pitch+j] += force_div2r*dx.x*dx.z;
+            h_virial[3*virial_pitch+j] += force_div2r*dx.y*dx.y;
+            h_virial[4*virial_pitch+j] += force_div2r*dx.y*dx.z;
+            h_virial[5*virial_pitch+j] += force_div2r*dx.z*dx.z;
+            }
+        }
+    else
+        {
+        pair_record_t rec;
+        rec.force = make_scalar4(-dx.x*force_divr, -dx.y*force_divr, -dx.z*force_divr, pair_eng * Scalar(0.5));
+        if (compute_virial)
+            {
+            rec.virial[0] = force_div2r*dx.x*dx.x;
+            rec.virial[1] = force_div2r*dx.x*dx.y;
+            rec.virial[2] = force_div2r*dx.x*dx.z;
+            rec.virial[3] = force_div2r*dx.y*dx.y;
+            rec.virial[4] = force_div2r*dx.y*dx.z;
+            rec.virial[5] = force_div2r*dx.z*dx.z;
+            }
+        rec.j = j;
+        args.records[args.owner[j]].push_back(rec);
+        }
+    }
+
+/*! \param num_iters Number of iterations to average for each kernel
+    \returns A dictionary that maps the name of each kernel instantiation to its execution time in nanoseconds per
+             neighbor list entry
+
+    Times every combination of energy shift mode, virial computation and neighbor list storage mode (half storage uses
+    the third law). The neighbor list is rebuilt in each storage mode, and restored to its original mode afterwards.
+    The forces are left in an undefined state, call compute() to recompute them.
+*/
+template< class evaluator >
+pybind11::dict PotentialPair< evaluator >::benchmarkKernels(unsigned int num_iters)
+    {
+    pybind11::dict result;
+    ClockSource t;
+
+    const NeighborList::storageMode old_storage_mode = m_nlist->getStorageMode();
+    const energyShiftMode old_shift_mode = m_shift_mode;
+    const std::string shift_names[] = {"none", "shift", "xplor"};
+
+    for (unsigned int s = 0; s < 2; s++)
+        {
+        const bool third_law = (s == 0);
+        m_nlist->setStorageMode(third_law ? NeighborList::half : NeighborList::full);
+        m_nlist->compute(0);
+
+        // count the number of neighbor list entries
+        uint64_t n_pairs = 0;
+            {
+            ArrayHandle<unsigned int> h_n_neigh(m_nlist->getNNeighArray(), access_location::host, access_mode::read);
+            for (unsigned int i = 0; i < m_pdata->getN(); i++)
+                n_pairs += h_n_neigh.data[i];
+            }
+        if (n_pairs == 0)
+            n_pairs = 1;
+
+        for (unsigned int mode = no_shift; mode <= xplor; mode++)
+            {
+            m_shift_mode = energyShiftMode(mode);
+            for (unsigned int v = 0; v < 2; v++)
+                {
+                const bool compute_virial = (v == 1);
+
+                // warm up run
+                computeForcesAll(third_law, compute_virial);
+
+                uint64_t start_time = t.getTime();
+                for (unsigned int iter = 0; iter < num_iters; iter++)
+                    computeForcesAll(third_law, compute_virial);
+                uint64_t total_time_ns = t.getTime() - start_time;
+
+                std::string name = shift_names[mode] + (compute_virial ? "/virial" : "/no_virial")
+                                   + (third_law ? "/half" : "/full");
+                result[name.c_str()] = double(total_time_ns) / double(num_iters) / double(n_pairs);
+                }
+            }
+        }
+
+    m_shift_mode = old_shift_mode;
+    m_nlist->setStorageMode(old_storage_mode);
+    return result;
     }
 
 #ifdef ENABLE_MPI
@@ -1042,6 +1762,7 @@ template < class T > void export_PotentialPair(pybind11::module& m, const std::s
         .def("computeEnergyBetweenSets", &T::computeEnergyBetweenSetsPythonList)
         .def("slotWriteGSDShapeSpec", &T::slotWriteGSDShapeSpec)
         .def("connectGSDShapeSpec", &T::connectGSDShapeSpec)
+        .def("benchmarkKernels", &T::benchmarkKernels)
     ;
 
     pybind11::enum_<typename T::energyShiftMode>(potentialpair,"energyShiftMode")
@@ -53,6 +53,12 @@ class PotentialPairDPDThermo : public PotentialPair<evaluator>
         //! Destructor
         virtual ~PotentialPairDPDThermo() { };
 
+        //! The temperature variant may call into python, which is only allowed on the main thread
+        virtual bool canComputeConcurrently() const
+            {
+            return false;
+            }
+
 
         //! Set the seed
         virtual void setSeed(unsigned int seed);
@@ -81,6 +87,18 @@ class PotentialPairDPDThermo : public PotentialPair<evaluator>
 
         //! Actually compute the forces (overwrites PotentialPair::computeForces())
         virtual void computeForces(unsigned int timestep);
+
+        //! The thermostat forces are always computed for all particles at once
+        virtual bool computeInteriorForces(unsigned int timestep)
+            {
+            return false;
+            }
+
+        //! The thermostat forces are written to the per-particle arrays of this ForceCompute
+        virtual bool supportsNetForceAccumulation() const
+            {
+            return false;
+            }
     };
 
 /*! \param sysdef System to compute forces on
@@ -0,0 +1,237 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file RealFFT3D.cc
+    \brief Defines the RealFFT3D class
+*/
+
+#include "RealFFT3D.h"
+
+#include <algorithm>
+
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
+
+/*! \param nx Number of points along x (fastest varying index)
+    \param ny Number of points along y
+    \param nz Number of points along z
+    \param n_threads Number of threads to use (only in TBB enabled builds)
+*/
+RealFFT3D::RealFFT3D(unsigned int nx, unsigned int ny, unsigned int nz, unsigned int n_threads)
+    : m_nx(nx), m_ny(ny), m_nz(nz), m_nxh(nx/2+1), m_n_blocks(1)
+    {
+    #ifdef ENABLE_TBB
+    m_n_blocks = std::max(n_threads, 1u);
+    #endif
+
+    m_fft_x = kiss_fft_alloc(nx, 0, NULL, NULL);
+    m_ifft_x = kiss_fft_alloc(nx, 1, NULL, NULL);
+    m_fft_y = kiss_fft_alloc(ny, 0, NULL, NULL);
+    m_ifft_y = kiss_fft_alloc(ny, 1, NULL, NULL);
+    m_fft_z = kiss_fft_alloc(nz, 0, NULL, NULL);
+    m_ifft_z = kiss_fft_alloc(nz, 1, NULL, NULL);
+
+    // scratch space for the one dimensional transforms of each block
+    m_n_max = std::max(nx, std::max(ny, nz));
+    m_in.resize(m_n_blocks*m_n_max);
+    m_out.resize(m_n_blocks*m_n_max);
+    }
+
+RealFFT3D::~RealFFT3D()
+    {
+    kiss_fft_free(m_fft_x);
+    kiss_fft_free(m_ifft_x);
+    kiss_fft_free(m_fft_y);
+    kiss_fft_free(m_ifft_y);
+    kiss_fft_free(m_fft_z);
+    kiss_fft_free(m_ifft_z);
+    }
+
+/*! \param in Real mesh (nx*ny*nz values)
+    \param out Non-negative x frequency half of the transform ((nx/2+1)*ny*nz values)
+*/
+void RealFFT3D::forward(const kiss_fft_scalar *in, kiss_fft_cpx *out)
+    {
+    const unsigned int n_rows = m_ny*m_nz;
+
+    // transform pairs of rows
+    forEachBlock((n_rows+1)/2, [&](unsigned int b, unsigned int first, unsigned int last)
+        {
+        kiss_fft_cpx *buf_in = &m_in[b*m_n_max];
+        kiss_fft_cpx *buf_out = &m_out[b*m_n_max];
+
+        for (unsigned int row = 2*first; row < 2*last; row += 2)
+            {
+            const kiss_fft_scalar *a = in + row*m_nx;
+            kiss_fft_cpx *A = out + row*m_nxh;
+
+            if (row + 1 < n_rows)
+                {
+                // transform two rows at once, z = a + i b
+                const kiss_fft_scalar *b = a + m_nx;
+                kiss_fft_cpx *B = A + m_nxh;
+                for (unsigned int n = 0; n < m_nx; ++n)
+                    {
+                    buf_in[n].r = a[n];
+                    buf_in[n].i = b[n];
+                    }
+                kiss_fft(m_fft_x, buf_in, buf_out);
+
+                // A_k = (Z_k + conj(Z_{-k}))/2, B_k = (Z_k - conj(Z_{-k}))/(2i)
+                for (unsigned int k = 0; k < m_nxh; ++k)
+                    {
+                    kiss_fft_cpx Z = buf_out[k];
+                    kiss_fft_cpx Zm = buf_out[k ? m_nx - k : 0];
+                    A[k].r = kiss_fft_scalar(0.5)*(Z.r + Zm.r);
+                    A[k].i = kiss_fft_scalar(0.5)*(Z.i - Zm.i);
+                    B[k].r = kiss_fft_scalar(0.5)*(Z.i + Zm.i);
+                    B[k].i = kiss_fft_scalar(0.5)*(Zm.r - Z.r);
+                    }
+                }
+            else
+                {
+                // last row of an odd number of rows
+                for (unsigned int n = 0; n < m_nx; ++n)
+                    {
+                    buf_in[n].r = a[n];
+                    buf_in[n].i = kiss_fft_scalar(0.0);
+                    }
+                kiss_fft(m_fft_x, buf_in, buf_out);
+                std::copy(buf_out, buf_out + m_nxh, A);
+                }
+            }
+        });
+
+    transformColumns(out, m_fft_y, m_fft_z);
+    }
+
+/*! \param in Non-negative x frequency half of a Hermitian mesh ((nx/2+1)*ny*nz values)
+    \param out Real mesh (nx*ny*nz values)
+*/
+void RealFFT3D::inverse(const kiss_fft_cpx *in, kiss_fft_scalar *out)
+    {
+    m_work.assign(in, in + getNumComplex());
+    transformColumns(&m_work[0], m_ifft_y, m_ifft_z);
+
+    const unsigned int n_rows = m_ny*m_nz;
+    const kiss_fft_cpx zero = {kiss_fft_scalar(0.0), kiss_fft_scalar(0.0)};
+
+    // transform pairs of rows
+    forEachBlock((n_rows+1)/2, [&](unsigned int b, unsigned int first, unsigned int last)
+        {
+        kiss_fft_cpx *buf_in = &m_in[b*m_n_max];
+        kiss_fft_cpx *buf_out = &m_out[b*m_n_max];
+
+        for (unsigned int row = 2*first; row < 2*last; row += 2)
+            {
+            bool pair = row + 1 < n_rows;
+            const kiss_fft_cpx *A = &m_work[row*m_nxh];
+            const kiss_fft_cpx *B = A + m_nxh;
+
+            // build z = a + i b from the Hermitian extensions of both rows
+            for (unsigned int k = 0; k < m_nx; ++k)
+                {
+                kiss_fft_cpx a, b;
+                if (k < m_nxh)
+                    {
+                    a = A[k];
+                    b = pair ? B[k] : zero;
+                    if (k == 0 || 2*k == m_nx)
+                        {
+                        // self-conjugate frequencies only have a Hermitian (real) part
+                        a.i = b.i = kiss_fft_scalar(0.0);
+                        }
+                    }
+                else
+                    {
+                    a = A[m_nx - k];
+                    a.i = -a.i;
+                    b = pair ? B[m_nx - k] : zero;
+                    b.i = -b.i;
+                    }
+                buf_in[k].r = a.r - b.i;
+                buf_in[k].i = a.i + b.r;
+                }
+            kiss_fft(m_ifft_x, buf_in, buf_out);
+
+            kiss_fft_scalar *a_out = out + row*m_nx;
+            for (unsigned int n = 0; n < m_nx; ++n)
+                a_out[n] = buf_out[n].r;
+
+            if (pair)
+                {
+                kiss_fft_scalar *b_out = a_out + m_nx;
+                for (unsigned int n = 0; n < m_nx; ++n)
+                    b_out[n] = buf_out[n].i;
+                }
+            }
+        });
+    }
+
+/*! \param data Half complex mesh, transformed in place
+    \param cfg_y Transform along y
+    \param cfg_z Transform along z
+*/
+void RealFFT3D::transformColumns(kiss_fft_cpx *data, kiss_fft_cfg cfg_y, kiss_fft_cfg cfg_z)
+    {
+    if (m_ny > 1)
+        {
+        forEachBlock(m_nz*m_nxh, [&](unsigned int b, unsigned int first, unsigned int last)
+            {
+            kiss_fft_cpx *buf_out = &m_out[b*m_n_max];
+            for (unsigned int c = first; c < last; ++c)
+                {
+                unsigned int z = c / m_nxh;
+                unsigned int kx = c % m_nxh;
+                kiss_fft_cpx *column = data + z*m_ny*m_nxh + kx;
+                kiss_fft_stride(cfg_y, column, buf_out, m_nxh);
+                for (unsigned int y = 0; y < m_ny; ++y)
+                    column[y*m_nxh] = buf_out[y];
+                }
+            });
+        }
+
+    if (m_nz > 1)
+        {
+        forEachBlock(m_ny*m_nxh, [&](unsigned int b, unsigned int first, unsigned int last)
+            {
+            kiss_fft_cpx *buf_out = &m_out[b*m_n_max];
+            for (unsigned int c = first; c < last; ++c)
+                {
+                kiss_fft_cpx *column = data + c;
+                kiss_fft_stride(cfg_z, column, buf_out, m_ny*m_nxh);
+                for (unsigned int z = 0; z < m_nz; ++z)
+                    column[z*m_ny*m_nxh] = buf_out[z];
+                }
+            });
+        }
+    }
+
+/*! \param n Number of work items
+    \param f Function called with the block index and the range of work items of the block
+
+    Each block uses its own scratch space. Blocks run in parallel in TBB enabled builds.
+*/
+void RealFFT3D::forEachBlock(unsigned int n,
+                             const std::function<void (unsigned int, unsigned int, unsigned int)>& f)
+    {
+    const unsigned int n_blocks = std::min(m_n_blocks, n);
+
+    #ifdef ENABLE_TBB
+    if (n_blocks > 1)
+        {
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_blocks, 1),
+            [&](const tbb::blocked_range<unsigned int>& r)
+            {
+            for (unsigned int b = r.begin(); b != r.end(); ++b)
+                f(b, (unsigned int)(((size_t)n*b)/n_blocks), (unsigned int)(((size_t)n*(b+1))/n_blocks));
+            });
+        return;
+        }
+    #endif
+
+    if (n_blocks > 0)
+        f(0, 0, n);
+    }
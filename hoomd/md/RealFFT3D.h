@@ -0,0 +1,92 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file RealFFT3D.h
+    \brief Declares the RealFFT3D class
+*/
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#include "hoomd/extern/kiss_fft.h"
+
+#include <functional>
+#include <vector>
+
+#ifndef __REAL_FFT_3D_H__
+#define __REAL_FFT_3D_H__
+
+//! Three dimensional FFT of real data
+/*! The input of the forward transform is a real valued mesh of nx*ny*nz points in row major order (x is the fastest
+    varying index). Its Fourier transform is Hermitian, so only the nx/2+1 points with non-negative frequency along x
+    are stored: the output is a (nx/2+1)*ny*nz complex mesh, again in row major order. The inverse transform maps
+    such a half complex mesh back to a real mesh. Like kiss_fftnd, neither transform is normalized.
+
+    Compared to a complex transform of the same mesh, the real transform needs half the memory for the Fourier
+    coefficients and about half of the floating point operations:
+    - Along x, pairs of real rows are packed into the real and imaginary part of a single complex row, transformed
+      together and separated using the Hermitian symmetry of the transform of a real sequence.
+    - Along y and z, only the nx/2+1 stored columns are transformed.
+
+    The inverse transform treats its input as the non-negative x frequency half of a Hermitian mesh. Coefficients
+    with x frequency zero or nx/2 (for even nx) that have no Hermitian partner on the stored half contribute with
+    their Hermitian part, which is equivalent to taking the real part of a complex inverse transform.
+
+    All dimensions are supported, but kiss_fft is fastest for sizes that factor into 2, 3 and 5.
+
+    In TBB enabled builds, the one dimensional transforms along each axis are split into blocks that run in
+    parallel. The result does not depend on the number of threads.
+*/
+class RealFFT3D
+    {
+    public:
+        //! Constructor
+        RealFFT3D(unsigned int nx, unsigned int ny, unsigned int nz, unsigned int n_threads = 1);
+
+        //! Destructor
+        ~RealFFT3D();
+
+        //! Get the number of complex values in the transformed mesh
+        unsigned int getNumComplex() const
+            {
+            return (m_nx/2+1)*m_ny*m_nz;
+            }
+
+        //! Forward transform
+        void forward(const kiss_fft_scalar *in, kiss_fft_cpx *out);
+
+        //! Inverse transform
+        void inverse(const kiss_fft_cpx *in, kiss_fft_scalar *out);
+
+    private:
+        unsigned int m_nx;                  //!< Number of points along x
+        unsigned int m_ny;                  //!< Number of points along y
+        unsigned int m_nz;                  //!< Number of points along z
+        unsigned int m_nxh;                 //!< Number of stored frequencies along x
+        unsigned int m_n_max;               //!< Length of the longest one dimensional transform
+        unsigned int m_n_blocks;            //!< Number of blocks of one dimensional transforms run in parallel
+
+        kiss_fft_cfg m_fft_x;               //!< Forward transform along x
+        kiss_fft_cfg m_ifft_x;              //!< Inverse transform along x
+        kiss_fft_cfg m_fft_y;               //!< Forward transform along y
+        kiss_fft_cfg m_ifft_y;              //!< Inverse transform along y
+        kiss_fft_cfg m_fft_z;               //!< Forward transform along z
+        kiss_fft_cfg m_ifft_z;              //!< Inverse transform along z
+
+        std::vector<kiss_fft_cpx> m_in;     //!< Input of a one dimensional transform (per block)
+        std::vector<kiss_fft_cpx> m_out;    //!< Output of a one dimensional transform (per block)
+        std::vector<kiss_fft_cpx> m_work;   //!< Copy of the input of the inverse transform
+
+        //! Transform all columns of the half complex mesh along y and z
+        void transformColumns(kiss_fft_cpx *data, kiss_fft_cfg cfg_y, kiss_fft_cfg cfg_z);
+
+        //! Split work items into blocks and process them
+        void forEachBlock(unsigned int n, const std::function<void (unsigned int, unsigned int, unsigned int)>& f);
+
+        // prevent copies, the kiss_fft configurations are owned by this object
+        RealFFT3D(const RealFFT3D&);
+        RealFFT3D& operator=(const RealFFT3D&);
+    };
+
+#endif // __REAL_FFT_3D_H__
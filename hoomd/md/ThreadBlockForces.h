@@ -0,0 +1,143 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#include "hoomd/HOOMDMath.h"
+
+#include <vector>
+
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
+
+/*! \file ThreadBlockForces.h
+    \brief Declares the ThreadBlockForces class
+*/
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#ifndef __THREADBLOCKFORCES_H__
+#define __THREADBLOCKFORCES_H__
+
+//! Collects the forces of bonded groups computed by several threads
+/*! The local particles are split into one contiguous block of indices per thread. The thread of a block evaluates
+    the groups led by its particles, so that every group is evaluated exactly once. The forces on members in the same
+    block are written directly to the output arrays, the forces on members owned by other blocks are appended to a
+    buffer per pair of source and target block. apply() then adds the buffers of each target block in source block
+    order, in parallel over the target blocks. Only particles that are local (index < N) receive forces.
+
+    The summation order only depends on the number of blocks, so the result is bitwise reproducible for a fixed
+    number of threads.
+*/
+class ThreadBlockForces
+    {
+    public:
+        //! Split \a N particles into \a n_blocks blocks and clear the buffers
+        void setup(unsigned int N, unsigned int n_blocks)
+            {
+            m_N = N;
+            m_n_blocks = n_blocks;
+            m_records.resize((size_t)n_blocks*n_blocks);
+            for (auto& records : m_records)
+                records.clear();
+            }
+
+        //! Get the index of the first particle of a block
+        /*! \param b Block index in [0, n_blocks], begin(n_blocks) is N
+        */
+        unsigned int begin(unsigned int b) const
+            {
+            return (unsigned int)(((size_t)m_N*b)/m_n_blocks);
+            }
+
+        //! Get the block that owns a local particle
+        unsigned int owner(unsigned int idx) const
+            {
+            // the largest b with begin(b) <= idx
+            return (unsigned int)(((size_t)(idx+1)*m_n_blocks - 1)/m_N);
+            }
+
+        //! Add a force computed by block \a b to the local particle \a idx
+        /*! \param b Block that computes the force
+            \param idx Index of the particle
+            \param force Force and energy
+            \param virial Six virial components, NULL if the virial is not computed
+            \param h_force Output forces
+            \param h_virial Output virials
+            \param virial_pitch Pitch of the virial array
+        */
+        void add(unsigned int b, unsigned int idx, const Scalar4& force, const Scalar *virial,
+                 Scalar4 *h_force, Scalar *h_virial, unsigned int virial_pitch)
+            {
+            unsigned int target = owner(idx);
+            if (target == b)
+                {
+                h_force[idx].x += force.x;
+                h_force[idx].y += force.y;
+                h_force[idx].z += force.z;
+                h_force[idx].w += force.w;
+                if (virial)
+                    for (unsigned int k = 0; k < 6; k++)
+                        h_virial[k*virial_pitch+idx] += virial[k];
+                }
+            else
+                {
+                record_t rec;
+                rec.force = force;
+                if (virial)
+                    for (unsigned int k = 0; k < 6; k++)
+                        rec.virial[k] = virial[k];
+                rec.idx = idx;
+                m_records[(size_t)b*m_n_blocks + target].push_back(rec);
+                }
+            }
+
+        #ifdef ENABLE_TBB
+        //! Add the buffered forces to the output arrays
+        /*! \param h_force Output forces
+            \param h_virial Output virials
+            \param virial_pitch Pitch of the virial array
+            \param compute_virial True if the buffered records contain virials
+        */
+        void apply(Scalar4 *h_force, Scalar *h_virial, unsigned int virial_pitch, bool compute_virial)
+            {
+            tbb::parallel_for(tbb::blocked_range<unsigned int>(0, m_n_blocks, 1),
+                [&](const tbb::blocked_range<unsigned int>& r)
+                {
+                for (unsigned int t = r.begin(); t != r.end(); ++t)
+                    {
+                    for (unsigned int b = 0; b < m_n_blocks; ++b)
+                        {
+                        for (const record_t& rec : m_records[(size_t)b*m_n_blocks + t])
+                            {
+                            h_force[rec.idx].x += rec.force.x;
+                            h_force[rec.idx].y += rec.force.y;
+                            h_force[rec.idx].z += rec.force.z;
+                            h_force[rec.idx].w += rec.force.w;
+                            if (compute_virial)
+                                for (unsigned int k = 0; k < 6; k++)
+                                    h_virial[k*virial_pitch+rec.idx] += rec.virial[k];
+                            }
+                        }
+                    }
+                });
+            }
+        #endif
+
+    private:
+        //! Force on a particle owned by another block
+        struct record_t
+            {
+            Scalar4 force;                  //!< Force and energy
+            Scalar virial[6];               //!< Virial
+            unsigned int idx;               //!< Index of the particle
+            };
+
+        unsigned int m_N = 0;                               //!< Number of local particles
+        unsigned int m_n_blocks = 1;                        //!< Number of blocks
+        std::vector< std::vector<record_t> > m_records;     //!< Forces per source and target block
+    };
+
+#endif // __THREADBLOCKFORCES_H__
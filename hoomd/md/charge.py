@@ -110,7 +110,7 @@ class pppm(force._force):
         force._force.enable(self);
         self.ewald.enable();
 
-    def set_params(self, Nx, Ny, Nz, order, rcut, alpha = 0.0):
+    def set_params(self, Nx, Ny, Nz, order, rcut, alpha = 0.0, diff = 'ik'):
         """ Sets PPPM parameters.
 
         Args:
@@ -121,18 +121,30 @@ class pppm(force._force):
             rcut  (float): Cutoff for the short-ranged part of the electrostatics calculation
             alpha (float, **optional**): Debye screening parameter (in units 1/distance)
                 .. versionadded:: 2.1
+            diff (str, **optional**): Differentiation scheme, ``'ik'`` or ``'ad'``
 
         Examples::
 
             pppm.set_params(Nx=64, Ny=64, Nz=64, order=6, rcut=2.0)
+            pppm.set_params(Nx=64, Ny=64, Nz=64, order=6, rcut=2.0, diff='ad')
 
         Note that the Fourier transforms are much faster for number of grid points of the form 2^N.
+
+        With ``diff='ik'``, the electric field is computed on the mesh in Fourier space, which takes three
+        inverse FFTs. With ``diff='ad'`` (analytical differentiation), only the potential is transformed back and
+        the forces are obtained from the gradient of the assignment function. This takes one inverse FFT, but
+        the forces are somewhat less accurate for the same mesh. Analytical differentiation is only available
+        on the CPU.
         """
 
         if hoomd.context.current.system_definition.getNDimensions() != 3:
             hoomd.context.current.device.cpp_msg.error("System must be 3 dimensional\n");
             raise RuntimeError("Cannot compute PPPM");
 
+        if diff not in ('ik', 'ad'):
+            hoomd.context.current.device.cpp_msg.error("diff must be 'ik' or 'ad'\n");
+            raise RuntimeError("Cannot compute PPPM");
+
         self.params_set = True;
 
         # get sum of charges and of squared charges
@@ -191,6 +203,7 @@ class pppm(force._force):
 
         # set the parameters for the appropriate type
         self.cpp_force.setParams(Nx, Ny, Nz, order, kappa, rcut, alpha);
+        self.cpp_force.setAnalyticalDifferentiation(diff == 'ad');
 
     def update_coeffs(self):
         if not self.params_set:
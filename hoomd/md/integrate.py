@@ -117,6 +117,16 @@ class Integrator(_DynamicIntegrator):
             constraint forces applied to the particles in the system.
             The default value of ``None`` initializes an empty list.
 
+        fused_net_force (bool): When `True`, forces that support it add
+            their contributions directly to the net force instead of storing
+            them separately (CPU only). Per-force quantities such as
+            ``energy`` and ``forces`` are recomputed when queried.
+            Defaults to `False`.
+
+        concurrent_forces (bool): When `True`, forces that do not depend on
+            each other are computed concurrently (CPU only, requires a TBB
+            enabled build and more than one thread). Defaults to `False`.
+
 
     The following classes can be used as elements in `methods`
 
@@ -168,10 +178,17 @@ class Integrator(_DynamicIntegrator):
 
         constraints (List[hoomd.md.constrain.ConstraintForce]): List of
             constraint forces applied to the particles in the system.
+
+        fused_net_force (bool): Whether forces are added directly to the net
+            force.
+
+        concurrent_forces (bool): Whether independent forces are computed
+            concurrently.
     """
 
     def __init__(self, dt, aniso='auto', forces=None, constraints=None,
-                 methods=None):
+                 methods=None, fused_net_force=False,
+                 concurrent_forces=False):
 
         super().__init__(forces, constraints, methods)
 
@@ -179,6 +196,8 @@ class Integrator(_DynamicIntegrator):
             dt=float(dt),
             aniso=OnlyFrom(['true', 'false', 'auto'],
                            preprocess=_preprocess_aniso),
+            fused_net_force=bool(fused_net_force),
+            concurrent_forces=bool(concurrent_forces),
             _defaults=dict(aniso="auto")
             )
         if aniso is not None:
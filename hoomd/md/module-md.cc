@@ -37,6 +37,7 @@
 #include "NeighborList.h"
 #include "NeighborListStencil.h"
 #include "NeighborListTree.h"
+#include "NeighborListBufferTuner.h"
 #include "OPLSDihedralForceCompute.h"
 #include "PotentialBond.h"
 #include "PotentialExternal.h"
@@ -272,6 +273,7 @@ PYBIND11_MODULE(_md, m)
     export_NeighborListBinned(m);
     export_NeighborListStencil(m);
     export_NeighborListTree(m);
+    export_NeighborListBufferTuner(m);
     export_ConstraintSphere(m);
     export_OneDConstraint(m);
     export_MolecularForceCompute(m);
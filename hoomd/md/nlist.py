@@ -370,6 +370,7 @@ class tree(nlist):
         d_max (float): The maximum diameter a particle will achieve, only used in conjunction with slj diameter shifting.
         dist_check (bool): Flag to enable / disable distance checking.
         name (str): Optional name for this neighbor list instance.
+        incremental (bool): When True, refit the trees between builds instead of rebuilding them (CPU only).
 
     :py:class:`tree` creates a neighbor list using bounding volume hierarchy (BVH) tree traversal. Pair potentials are attached
     for computing non-bonded pairwise interactions. A BVH tree of axis-aligned bounding boxes is constructed per particle
@@ -395,13 +396,20 @@ class tree(nlist):
         is the only pair potential requiring this shifting, and setting *d_max* for other potentials may lead to
         significantly degraded performance or incorrect results.
 
+    With *incremental* set, each particle is refit into the tree leaf it was assigned at the last full build, and
+    only particles that left their leaf modify the tree. The trees are still rebuilt from scratch after particle
+    sorts, box or particle number changes, and when many particles have left their leaves. This is most effective
+    for dense systems with small *r_buff*, where particles move little between builds. *incremental* is ignored on
+    the GPU and in MPI simulations.
+
     """
-    def __init__(self, r_buff=0.4, check_period=1, d_max=None, dist_check=True, name=None):
+    def __init__(self, r_buff=0.4, check_period=1, d_max=None, dist_check=True, name=None, incremental=False):
         nlist.__init__(self)
 
         # create the C++ mirror class
         if not hoomd.context.current.device.cpp_exec_conf.isCUDAEnabled():
             self.cpp_nlist = _md.NeighborListTree(hoomd.context.current.system_definition, 0.0, r_buff)
+            self.cpp_nlist.incremental = incremental
         else:
             self.cpp_nlist = _md.NeighborListGPUTree(hoomd.context.current.system_definition, 0.0, r_buff)
 
@@ -0,0 +1,67 @@
+"""Test NeighborListBuffer."""
+
+import hoomd
+
+
+def _make_tuner(**kwargs):
+    nlist = hoomd.md.nlist.Cell()
+    tuner = hoomd.md.tune.NeighborListBuffer(
+        trigger=hoomd.trigger.Periodic(10), nlist=nlist, **kwargs)
+    return nlist, tuner
+
+
+def test_attributes():
+    """Test NeighborListBuffer attributes before attaching."""
+    nlist, tuner = _make_tuner(min_buffer=0.2, max_buffer=0.8, tolerance=0.05)
+
+    assert tuner.nlist is nlist
+    assert tuner.min_buffer == 0.2
+    assert tuner.max_buffer == 0.8
+    assert tuner.tolerance == 0.05
+    assert not tuner.tuned
+
+
+def test_buffer_in_range(simulation_factory, lattice_snapshot_factory):
+    """Test that the tuned buffer stays within the requested range."""
+    nlist, tuner = _make_tuner(min_buffer=0.2, max_buffer=0.6, tolerance=0.1)
+
+    lj = hoomd.md.pair.LJ(nlist, r_cut=2.5)
+    lj.params[('A', 'A')] = dict(epsilon=1, sigma=1)
+    nve = hoomd.md.methods.NVE(filter=hoomd.filter.All())
+
+    sim = simulation_factory(lattice_snapshot_factory(a=1.2, n=6, r=0.05))
+    sim.operations.integrator = hoomd.md.Integrator(0.005,
+                                                    forces=[lj],
+                                                    methods=[nve])
+    sim.operations.tuners.append(tuner)
+    sim.state.thermalize_particle_momenta(hoomd.filter.All(), kT=1.0, seed=1)
+
+    for i in range(10):
+        sim.run(10)
+        assert 0.2 <= nlist.buffer <= 0.6
+
+    assert nlist.rebuild_check_delay >= 1
+
+
+def test_no_dangerous_builds(simulation_factory, lattice_snapshot_factory):
+    """Test that the tuner prevents dangerous neighbor list builds."""
+    nlist, tuner = _make_tuner(min_buffer=0.05, max_buffer=0.4, tolerance=0.05)
+
+    # without the tuner, checking every 10 steps in a hot fluid with a small
+    # buffer leads to dangerous builds
+    nlist.rebuild_check_delay = 10
+
+    lj = hoomd.md.pair.LJ(nlist, r_cut=2.5)
+    lj.params[('A', 'A')] = dict(epsilon=1, sigma=1)
+    nve = hoomd.md.methods.NVE(filter=hoomd.filter.All())
+
+    sim = simulation_factory(lattice_snapshot_factory(a=1.2, n=6, r=0.05))
+    sim.operations.integrator = hoomd.md.Integrator(0.005,
+                                                    forces=[lj],
+                                                    methods=[nve])
+    sim.operations.tuners.append(tuner)
+    sim.state.thermalize_particle_momenta(hoomd.filter.All(), kT=3.0, seed=1)
+
+    sim.run(500)
+    assert nlist.rebuild_check_delay == 1
+    assert nlist._cpp_obj.getNumDangerousUpdates() == 0
@@ -508,6 +508,24 @@ def test_run(simulation_factory, lattice_snapshot_factory, valid_params):
                                    old_snap.particles.position)
 
 
+def test_benchmark_kernels(simulation_factory, lattice_snapshot_factory):
+    lj = hoomd.md.pair.LJ(nlist=hoomd.md.nlist.Cell(), r_cut=2.5)
+    lj.params[('A', 'A')] = {'sigma': 1, 'epsilon': 0.5}
+    snap = lattice_snapshot_factory(n=5, a=1.2)
+    sim = simulation_factory(snap)
+    integrator = hoomd.md.Integrator(dt=0.005)
+    integrator.forces.append(lj)
+    sim.operations.integrator = integrator
+    sim.operations._schedule()
+
+    timings = lj._cpp_obj.benchmarkKernels(2)
+    assert len(timings) == 12
+    for mode, virial, storage in itertools.product(
+            ['none', 'shift', 'xplor'], ['virial', 'no_virial'],
+            ['half', 'full']):
+        assert timings['/'.join([mode, virial, storage])] > 0
+
+
 def test_energy_shifting(simulation_factory, two_particle_snapshot_factory):
 
     def S_r(r, r_cut, r_on):
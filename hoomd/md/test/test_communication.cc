@@ -15,10 +15,13 @@ HOOMD_UP_MAIN()
 
 #include "hoomd/ExecutionConfiguration.h"
 #include "hoomd/Communicator.h"
+#include "hoomd/ClockSource.h"
 
 #include "hoomd/ConstForceCompute.h"
 #include "hoomd/md/TwoStepNVE.h"
 #include "hoomd/md/IntegratorTwoStep.h"
+#include "hoomd/md/NeighborListTree.h"
+#include "hoomd/md/AllPairPotentials.h"
 #include "hoomd/filter/ParticleFilterAll.h"
 
 #ifdef ENABLE_HIP
@@ -3443,6 +3446,223 @@ void test_communicator_ghosts_per_type(communicator_creator comm_creator, std::s
         }
     }
 
+//! Test that overlapping the ghost update with the force computation gives the same forces
+void test_communicator_ghost_overlap(communicator_creator comm_creator,
+                                     std::shared_ptr<ExecutionConfiguration> exec_conf,
+                                     NeighborList::storageMode mode,
+                                     bool single_stage)
+    {
+    // a jittered simple cubic lattice with ten particles per direction
+    const unsigned int n_side = 10;
+    const unsigned int n = n_side*n_side*n_side;
+    const Scalar a = Scalar(1.2);
+    BoxDim box(a*n_side);
+
+    SnapshotParticleData<Scalar> snap(n);
+    snap.type_mapping.push_back("A");
+
+    Scalar3 lo = box.getLo();
+    srand(12345);
+    for (unsigned int i = 0; i < n; ++i)
+        {
+        unsigned int ix = i % n_side;
+        unsigned int iy = (i / n_side) % n_side;
+        unsigned int iz = i / (n_side*n_side);
+        Scalar3 jitter = make_scalar3((Scalar)rand()/(Scalar)RAND_MAX - Scalar(0.5),
+                                      (Scalar)rand()/(Scalar)RAND_MAX - Scalar(0.5),
+                                      (Scalar)rand()/(Scalar)RAND_MAX - Scalar(0.5))*Scalar(0.1);
+        snap.pos[i] = vec3<Scalar>(lo.x + (ix + Scalar(0.5))*a + jitter.x,
+                                   lo.y + (iy + Scalar(0.5))*a + jitter.y,
+                                   lo.z + (iz + Scalar(0.5))*a + jitter.z);
+        snap.vel[i] = vec3<Scalar>((Scalar)rand()/(Scalar)RAND_MAX - Scalar(0.5),
+                                   (Scalar)rand()/(Scalar)RAND_MAX - Scalar(0.5),
+                                   (Scalar)rand()/(Scalar)RAND_MAX - Scalar(0.5));
+        }
+
+    // two identical systems, the second one overlaps the ghost update with the force computation
+    std::shared_ptr<SystemDefinition> sysdef[2];
+    std::shared_ptr<IntegratorTwoStep> integrator[2];
+    std::shared_ptr<Communicator> comm[2];
+    for (unsigned int k = 0; k < 2; ++k)
+        {
+        sysdef[k] = std::shared_ptr<SystemDefinition>(new SystemDefinition(n, box, 1, 0, 0, 0, 0, exec_conf));
+        std::shared_ptr<ParticleData> pdata = sysdef[k]->getParticleData();
+
+        std::shared_ptr<DomainDecomposition> decomposition(new DomainDecomposition(exec_conf, box.getL()));
+        pdata->setDomainDecomposition(decomposition);
+        pdata->initializeFromSnapshot(snap);
+
+        comm[k] = comm_creator(sysdef[k], decomposition);
+        comm[k]->setGhostOverlap(k == 1);
+        comm[k]->setSingleStageGhostUpdate(single_stage && k == 1);
+
+        std::shared_ptr<NeighborListTree> nlist(new NeighborListTree(sysdef[k], Scalar(2.0), Scalar(0.4)));
+        nlist->setStorageMode(mode);
+        nlist->setCommunicator(comm[k]);
+
+        std::shared_ptr<PotentialPairLJ> lj(new PotentialPairLJ(sysdef[k], nlist));
+        lj->setParams(0, 0, EvaluatorPairLJ::param_type(Scalar(1.0), Scalar(1.0)));
+        lj->setRcut(0, 0, Scalar(2.0));
+        lj->setCommunicator(comm[k]);
+
+        std::shared_ptr<ParticleFilter> selector_all(new ParticleFilterAll());
+        std::shared_ptr<ParticleGroup> group_all(new ParticleGroup(sysdef[k], selector_all));
+        std::shared_ptr<TwoStepNVE> nve(new TwoStepNVE(sysdef[k], group_all));
+
+        integrator[k] = std::shared_ptr<IntegratorTwoStep>(new IntegratorTwoStep(sysdef[k], Scalar(0.001)));
+        integrator[k]->addIntegrationMethod(nve);
+        integrator[k]->addForceCompute(lj);
+        integrator[k]->setCommunicator(comm[k]);
+        integrator[k]->prepRun(0);
+        }
+
+    for (unsigned int step = 0; step < 50; ++step)
+        {
+        integrator[0]->update(step);
+        integrator[1]->update(step);
+
+        // the overlapping update must have been completed by the integrator
+        UP_ASSERT(!comm[1]->isGhostUpdatePending());
+
+        std::shared_ptr<ParticleData> pdata_1 = sysdef[0]->getParticleData();
+        std::shared_ptr<ParticleData> pdata_2 = sysdef[1]->getParticleData();
+        UP_ASSERT_EQUAL(pdata_1->getN(), pdata_2->getN());
+
+        ArrayHandle<unsigned int> h_tag_1(pdata_1->getTags(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_rtag_2(pdata_2->getRTags(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_net_force_1(pdata_1->getNetForce(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_net_force_2(pdata_2->getNetForce(), access_location::host, access_mode::read);
+
+        // the summation order differs, so the forces agree to round off
+        for (unsigned int i = 0; i < pdata_1->getN(); ++i)
+            {
+            unsigned int j = h_rtag_2.data[h_tag_1.data[i]];
+            UP_ASSERT(j < pdata_2->getN());
+
+            MY_CHECK_SMALL(h_net_force_1.data[i].x - h_net_force_2.data[j].x, tol_small);
+            MY_CHECK_SMALL(h_net_force_1.data[i].y - h_net_force_2.data[j].y, tol_small);
+            MY_CHECK_SMALL(h_net_force_1.data[i].z - h_net_force_2.data[j].z, tol_small);
+            MY_CHECK_SMALL(h_net_force_1.data[i].w - h_net_force_2.data[j].w, tol_small);
+            }
+        }
+    }
+
+//! Test that computing independent forces concurrently gives the same forces and records the wall time once
+void test_communicator_concurrent_forces(communicator_creator comm_creator,
+                                         std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    #ifdef ENABLE_TBB
+    exec_conf->setNumThreads(4);
+    #endif
+
+    // a jittered simple cubic lattice with ten particles per direction
+    const unsigned int n_side = 10;
+    const unsigned int n = n_side*n_side*n_side;
+    const Scalar a = Scalar(1.2);
+    BoxDim box(a*n_side);
+
+    SnapshotParticleData<Scalar> snap(n);
+    snap.type_mapping.push_back("A");
+
+    Scalar3 lo = box.getLo();
+    srand(54321);
+    for (unsigned int i = 0; i < n; ++i)
+        {
+        unsigned int ix = i % n_side;
+        unsigned int iy = (i / n_side) % n_side;
+        unsigned int iz = i / (n_side*n_side);
+        Scalar3 jitter = make_scalar3((Scalar)rand()/(Scalar)RAND_MAX - Scalar(0.5),
+                                      (Scalar)rand()/(Scalar)RAND_MAX - Scalar(0.5),
+                                      (Scalar)rand()/(Scalar)RAND_MAX - Scalar(0.5))*Scalar(0.1);
+        snap.pos[i] = vec3<Scalar>(lo.x + (ix + Scalar(0.5))*a + jitter.x,
+                                   lo.y + (iy + Scalar(0.5))*a + jitter.y,
+                                   lo.z + (iz + Scalar(0.5))*a + jitter.z);
+        snap.vel[i] = vec3<Scalar>((Scalar)rand()/(Scalar)RAND_MAX - Scalar(0.5),
+                                   (Scalar)rand()/(Scalar)RAND_MAX - Scalar(0.5),
+                                   (Scalar)rand()/(Scalar)RAND_MAX - Scalar(0.5));
+        }
+
+    // two identical systems, the second one computes its forces concurrently
+    std::shared_ptr<SystemDefinition> sysdef[2];
+    std::shared_ptr<IntegratorTwoStep> integrator[2];
+    std::shared_ptr<Communicator> comm[2];
+    for (unsigned int k = 0; k < 2; ++k)
+        {
+        sysdef[k] = std::shared_ptr<SystemDefinition>(new SystemDefinition(n, box, 1, 0, 0, 0, 0, exec_conf));
+        std::shared_ptr<ParticleData> pdata = sysdef[k]->getParticleData();
+
+        std::shared_ptr<DomainDecomposition> decomposition(new DomainDecomposition(exec_conf, box.getL()));
+        pdata->setDomainDecomposition(decomposition);
+        pdata->initializeFromSnapshot(snap);
+
+        comm[k] = comm_creator(sysdef[k], decomposition);
+
+        // both pair potentials share the neighbor list
+        std::shared_ptr<NeighborListTree> nlist(new NeighborListTree(sysdef[k], Scalar(2.0), Scalar(0.4)));
+        nlist->setCommunicator(comm[k]);
+
+        std::shared_ptr<PotentialPairLJ> lj(new PotentialPairLJ(sysdef[k], nlist));
+        lj->setParams(0, 0, EvaluatorPairLJ::param_type(Scalar(1.0), Scalar(1.0)));
+        lj->setRcut(0, 0, Scalar(2.0));
+        lj->setCommunicator(comm[k]);
+
+        std::shared_ptr<PotentialPairGauss> gauss(new PotentialPairGauss(sysdef[k], nlist));
+        gauss->setParams(0, 0, EvaluatorPairGauss::param_type(Scalar(0.5), Scalar(0.8)));
+        gauss->setRcut(0, 0, Scalar(1.5));
+        gauss->setCommunicator(comm[k]);
+
+        std::shared_ptr<ParticleFilter> selector_all(new ParticleFilterAll());
+        std::shared_ptr<ParticleGroup> group_all(new ParticleGroup(sysdef[k], selector_all));
+        std::shared_ptr<TwoStepNVE> nve(new TwoStepNVE(sysdef[k], group_all));
+
+        integrator[k] = std::shared_ptr<IntegratorTwoStep>(new IntegratorTwoStep(sysdef[k], Scalar(0.001)));
+        integrator[k]->addIntegrationMethod(nve);
+        integrator[k]->addForceCompute(lj);
+        integrator[k]->addForceCompute(gauss);
+        integrator[k]->setCommunicator(comm[k]);
+        integrator[k]->setConcurrentForces(k == 1);
+        integrator[k]->prepRun(0);
+        }
+    UP_ASSERT(integrator[1]->getConcurrentForces());
+
+    for (unsigned int step = 0; step < 20; ++step)
+        {
+        integrator[0]->update(step);
+
+        // the work time of the concurrent forces can not exceed the wall time of the step
+        comm[1]->resetWorkTime();
+        ClockSource clk;
+        integrator[1]->update(step);
+        int64_t wall_time = clk.getTime();
+        UP_ASSERT(comm[1]->getWorkTime() > 0);
+        UP_ASSERT(comm[1]->getWorkTime() <= wall_time);
+
+        std::shared_ptr<ParticleData> pdata_1 = sysdef[0]->getParticleData();
+        std::shared_ptr<ParticleData> pdata_2 = sysdef[1]->getParticleData();
+        UP_ASSERT_EQUAL(pdata_1->getN(), pdata_2->getN());
+
+        ArrayHandle<unsigned int> h_tag_1(pdata_1->getTags(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_rtag_2(pdata_2->getRTags(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_net_force_1(pdata_1->getNetForce(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_net_force_2(pdata_2->getNetForce(), access_location::host, access_mode::read);
+
+        for (unsigned int i = 0; i < pdata_1->getN(); ++i)
+            {
+            unsigned int j = h_rtag_2.data[h_tag_1.data[i]];
+            UP_ASSERT(j < pdata_2->getN());
+
+            MY_CHECK_SMALL(h_net_force_1.data[i].x - h_net_force_2.data[j].x, tol_small);
+            MY_CHECK_SMALL(h_net_force_1.data[i].y - h_net_force_2.data[j].y, tol_small);
+            MY_CHECK_SMALL(h_net_force_1.data[i].z - h_net_force_2.data[j].z, tol_small);
+            MY_CHECK_SMALL(h_net_force_1.data[i].w - h_net_force_2.data[j].w, tol_small);
+            }
+        }
+
+    #ifdef ENABLE_TBB
+    exec_conf->setNumThreads(1);
+    #endif
+    }
+
 //! Communicator creator for unit tests
 std::shared_ptr<Communicator> base_class_communicator_creator(std::shared_ptr<SystemDefinition> sysdef,
                                                          std::shared_ptr<DomainDecomposition> decomposition)
@@ -3450,6 +3670,15 @@ std::shared_ptr<Communicator> base_class_communicator_creator(std::shared_ptr<Sy
     return std::shared_ptr<Communicator>(new Communicator(sysdef, decomposition) );
     }
 
+//! Communicator creator for unit tests of the single stage ghost update
+std::shared_ptr<Communicator> single_stage_communicator_creator(std::shared_ptr<SystemDefinition> sysdef,
+                                                           std::shared_ptr<DomainDecomposition> decomposition)
+    {
+    std::shared_ptr<Communicator> comm(new Communicator(sysdef, decomposition));
+    comm->setSingleStageGhostUpdate(true);
+    return comm;
+    }
+
 #ifdef ENABLE_HIP
 std::shared_ptr<Communicator> gpu_communicator_creator(std::shared_ptr<SystemDefinition> sysdef,
                                                   std::shared_ptr<DomainDecomposition> decomposition)
@@ -3657,6 +3886,66 @@ UP_TEST( communicator_ghost_layer_width_test)
     test_communicator_ghost_layer_width(communicator_creator_base, exec_conf_cpu);
     }
 
+UP_TEST( communicator_ghost_overlap_test)
+    {
+    if (!exec_conf_cpu)
+        exec_conf_cpu = std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+
+    communicator_creator communicator_creator_base = bind(base_class_communicator_creator, _1, _2);
+    test_communicator_ghost_overlap(communicator_creator_base, exec_conf_cpu, NeighborList::half, false);
+    test_communicator_ghost_overlap(communicator_creator_base, exec_conf_cpu, NeighborList::full, false);
+
+    // with the single stage ghost update, the whole update overlaps with the force computation
+    test_communicator_ghost_overlap(communicator_creator_base, exec_conf_cpu, NeighborList::half, true);
+    }
+
+UP_TEST( communicator_concurrent_forces_test)
+    {
+    if (!exec_conf_cpu)
+        exec_conf_cpu = std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+
+    communicator_creator communicator_creator_base = bind(base_class_communicator_creator, _1, _2);
+    test_communicator_concurrent_forces(communicator_creator_base, exec_conf_cpu);
+    }
+
+UP_TEST( communicator_single_stage_ghosts_test)
+    {
+    if (!exec_conf_cpu)
+        exec_conf_cpu = std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+
+    communicator_creator communicator_creator_single = bind(single_stage_communicator_creator, _1, _2);
+
+    // test in a cubic box
+        {
+        BoxDim box(2.0);
+        test_communicator_ghosts(communicator_creator_single,
+                                 exec_conf_cpu,
+                                 box,
+                                 std::shared_ptr<DomainDecomposition>(new DomainDecomposition(exec_conf_cpu,box.getL())),
+                                 make_scalar3(0.0,0.0,0.0));
+        }
+    // triclinic box
+        {
+        BoxDim box(1.0,-.6,.7,.5);
+        test_communicator_ghosts(communicator_creator_single,
+                                 exec_conf_cpu,
+                                 box,
+                                 std::shared_ptr<DomainDecomposition>(new DomainDecomposition(exec_conf_cpu,box.getL())),
+                                 make_scalar3(0.0,0.0,0.0));
+        }
+    // balanced decomposition
+        {
+        BoxDim box(2.0);
+        vector<Scalar> fx(1), fy(1), fz(1);
+        fx[0] = 0.55; fy[0] = 0.44; fz[0] = 0.57;
+        test_communicator_ghosts(communicator_creator_single,
+                                 exec_conf_cpu,
+                                 box,
+                                 std::shared_ptr<DomainDecomposition>(new DomainDecomposition(exec_conf_cpu,box.getL(), fx, fy, fz)),
+                                 make_scalar3(0.1,-0.12,0.14));
+        }
+    }
+
 UP_TEST( communicator_ghost_layer_per_type_test)
     {
     if (!exec_conf_cpu)
@@ -0,0 +1,137 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include <iostream>
+
+#include <memory>
+
+#include "hoomd/md/ForceDistanceConstraint.h"
+
+#include <math.h>
+
+using namespace std;
+
+/*! \file test_distance_constraint.cc
+    \brief Implements unit tests for ForceDistanceConstraint
+    \ingroup unit_tests
+*/
+
+#include "hoomd/test/upp11_config.h"
+HOOMD_UP_MAIN();
+
+//! Add a constraint with the current distance between particles a and b
+void add_constraint(std::shared_ptr<SystemDefinition> sysdef, unsigned int a, unsigned int b)
+    {
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    vec3<Scalar> ra = pdata->getPosition(a);
+    vec3<Scalar> rb = pdata->getPosition(b);
+    vec3<Scalar> dr = ra - rb;
+    sysdef->getConstraintData()->addBondedGroup(Constraint(sqrt(dot(dr,dr)), a, b));
+    }
+
+//! Compare the per-molecule block solver to the global sparse solver
+void distance_constraint_block_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    // two rigid waters, a four particle chain and a long chain that exceeds the dense block size
+    const unsigned int n_water = 2;
+    const unsigned int n_short = 4;
+    const unsigned int n_long = 41;
+    const unsigned int N = 3*n_water + n_short + n_long;
+
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(N, BoxDim(1000.0), 1, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    Scalar theta = Scalar(109.47*M_PI/180.0);
+    for (unsigned int i = 0; i < n_water; ++i)
+        {
+        Scalar3 o = make_scalar3(Scalar(-20.0), Scalar(5.0)*i, 0);
+        pdata->setPosition(3*i, o);
+        pdata->setPosition(3*i+1, o + make_scalar3(1.0, 0, 0));
+        pdata->setPosition(3*i+2, o + make_scalar3(cos(theta), sin(theta), 0));
+        pdata->setMass(3*i, 16.0);
+        }
+
+    for (unsigned int i = 0; i < n_short + n_long; ++i)
+        {
+        unsigned int tag = 3*n_water + i;
+        Scalar y = (i < n_short) ? Scalar(-10.0) : Scalar(10.0);
+        unsigned int j = (i < n_short) ? i : i - n_short;
+        pdata->setPosition(tag, make_scalar3(Scalar(0.8)*j - Scalar(15.0), y + Scalar(0.3)*(j % 2), Scalar(0.1)*(j % 3)));
+        pdata->setMass(tag, 1.0 + 0.5*(j % 2));
+        }
+
+    // give the particles some velocity
+    for (unsigned int i = 0; i < N; ++i)
+        pdata->setVelocity(i, make_scalar3(0.1*sin(Scalar(i)), 0.2*cos(Scalar(3*i)), -0.1*sin(Scalar(2*i))));
+
+    for (unsigned int i = 0; i < n_water; ++i)
+        {
+        add_constraint(sysdef, 3*i, 3*i+1);
+        add_constraint(sysdef, 3*i, 3*i+2);
+        add_constraint(sysdef, 3*i+1, 3*i+2);
+        }
+    for (unsigned int i = 0; i < n_short-1; ++i)
+        add_constraint(sysdef, 3*n_water+i, 3*n_water+i+1);
+    for (unsigned int i = 0; i < n_long-1; ++i)
+        add_constraint(sysdef, 3*n_water+n_short+i, 3*n_water+n_short+i+1);
+
+    std::shared_ptr<ForceDistanceConstraint> fc_block(new ForceDistanceConstraint(sysdef));
+    fc_block->setDeltaT(0.005);
+    UP_ASSERT(fc_block->getBlockSolver());
+
+    std::shared_ptr<ForceDistanceConstraint> fc_global(new ForceDistanceConstraint(sysdef));
+    fc_global->setDeltaT(0.005);
+    fc_global->setBlockSolver(false);
+
+    for (unsigned int timestep = 0; timestep < 2; ++timestep)
+        {
+        fc_block->compute(timestep);
+        fc_global->compute(timestep);
+
+        ArrayHandle<Scalar4> h_force_block(fc_block->getForceArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_force_global(fc_global->getForceArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_virial_block(fc_block->getVirialArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_virial_global(fc_global->getVirialArray(), access_location::host, access_mode::read);
+        unsigned int pitch = fc_block->getVirialArray().getPitch();
+
+        Scalar f_max = 0.0;
+        for (unsigned int i = 0; i < N; ++i)
+            {
+            MY_CHECK_CLOSE(h_force_block.data[i].x, h_force_global.data[i].x, tol);
+            MY_CHECK_CLOSE(h_force_block.data[i].y, h_force_global.data[i].y, tol);
+            MY_CHECK_CLOSE(h_force_block.data[i].z, h_force_global.data[i].z, tol);
+            for (unsigned int k = 0; k < 6; ++k)
+                MY_CHECK_CLOSE(h_virial_block.data[k*pitch+i], h_virial_global.data[k*pitch+i], tol);
+            f_max = std::max(f_max, fabs(h_force_block.data[i].x));
+            }
+
+        // the constraints exert forces
+        UP_ASSERT(f_max > tol_small);
+        }
+
+    // the blocks are rebuilt when a constraint is added, joining the two waters
+    add_constraint(sysdef, 1, 3);
+    fc_block->compute(2);
+    fc_global->compute(2);
+
+        {
+        ArrayHandle<Scalar4> h_force_block(fc_block->getForceArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_force_global(fc_global->getForceArray(), access_location::host, access_mode::read);
+        for (unsigned int i = 0; i < N; ++i)
+            {
+            MY_CHECK_CLOSE(h_force_block.data[i].x, h_force_global.data[i].x, tol);
+            MY_CHECK_CLOSE(h_force_block.data[i].y, h_force_global.data[i].y, tol);
+            MY_CHECK_CLOSE(h_force_block.data[i].z, h_force_global.data[i].z, tol);
+            }
+        }
+    }
+
+//! Compare the block and global solvers on the CPU
+UP_TEST( ForceDistanceConstraint_block )
+    {
+    distance_constraint_block_test(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
@@ -24,6 +24,7 @@ using namespace std;
 using namespace std::placeholders;
 
 #include "hoomd/test/upp11_config.h"
+#include "hoomd/test/ForceComputeThreads.h"
 HOOMD_UP_MAIN();
 
 //! Typedef to make using the std::function factory easier
@@ -412,6 +413,18 @@ UP_TEST( HarmonicAngleForceCompute_basic )
     angle_force_basic_tests(af_creator, exec_conf);
     }
 
+#ifdef ENABLE_TBB
+//! test case for comparing the multithreaded and serial computation of the angle forces
+UP_TEST( HarmonicAngleForceCompute_threads_compare )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    exec_conf->setNumThreads(1);
+    angleforce_creator af_creator = bind(base_class_af_creator, _1);
+    angleforce_creator af_creator_threads = bind(threads_creator<HarmonicAngleForceCompute>, _1, exec_conf, 4);
+    angle_force_comparison_tests(af_creator, af_creator_threads, exec_conf);
+    }
+#endif
+
 #ifdef ENABLE_HIP
 //! test case for angle forces on the GPU
 UP_TEST( HarmonicAngleForceComputeGPU_basic )
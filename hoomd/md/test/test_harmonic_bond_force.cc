@@ -25,6 +25,7 @@ using namespace std::placeholders;
 */
 
 #include "hoomd/test/upp11_config.h"
+#include "hoomd/test/ForceComputeThreads.h"
 HOOMD_UP_MAIN();
 
 //! Typedef to make using the std::function factory easier
@@ -482,6 +483,18 @@ UP_TEST( PotentialBondHarmonicGPU_compare )
 
 #endif
 
+#ifdef ENABLE_TBB
+//! test case for comparing the multithreaded and serial computation of the bond forces
+UP_TEST( PotentialBondHarmonic_threads_compare )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    exec_conf->setNumThreads(1);
+    bondforce_creator bf_creator = bind(base_class_bf_creator, _1);
+    bondforce_creator bf_creator_threads = bind(threads_creator<PotentialBondHarmonic>, _1, exec_conf, 4);
+    bond_force_comparison_tests(bf_creator, bf_creator_threads, exec_conf);
+    }
+#endif
+
 //! test case for constant forces
 UP_TEST( ConstForceCompute_basic )
     {
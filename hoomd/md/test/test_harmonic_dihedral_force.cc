@@ -24,6 +24,7 @@ using namespace std;
 using namespace std::placeholders;
 
 #include "hoomd/test/upp11_config.h"
+#include "hoomd/test/ForceComputeThreads.h"
 HOOMD_UP_MAIN();
 
 //! Typedef to make using the std::function factory easier
@@ -541,7 +542,6 @@ void dihedral_force_comparison_tests(dihedralforce_creator tf_creator1,
     }
     }
 
-
 //! HarmonicDihedralForceCompute creator for dihedral_force_basic_tests()
 std::shared_ptr<HarmonicDihedralForceCompute> base_class_tf_creator(std::shared_ptr<SystemDefinition> sysdef)
     {
@@ -565,6 +565,18 @@ UP_TEST( HarmonicDihedralForceCompute_basic )
     dihedral_force_phase_shift(tf_creator, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
 
+#ifdef ENABLE_TBB
+//! test case for comparing the multithreaded and serial computation of the dihedral forces
+UP_TEST( HarmonicDihedralForceCompute_threads_compare )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    exec_conf->setNumThreads(1);
+    dihedralforce_creator tf_creator = bind(base_class_tf_creator, _1);
+    dihedralforce_creator tf_creator_threads = bind(threads_creator<HarmonicDihedralForceCompute>, _1, exec_conf, 4);
+    dihedral_force_comparison_tests(tf_creator, tf_creator_threads, exec_conf);
+    }
+#endif
+
 #ifdef ENABLE_HIP
 //! test case for dihedral forces on the GPU
 UP_TEST( HarmonicDihedralForceComputeGPU_basic )
@@ -1131,6 +1131,79 @@ void neighborlist_comparison_test(std::shared_ptr<ExecutionConfiguration> exec_c
         }
     }
 
+//! Test that incremental updates of the tree neighbor list give the same neighbors as a full build
+void neighborlist_tree_incremental_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    // construct the particle system
+    RandomInitializer init(1000, Scalar(0.016778), Scalar(0.9), "A");
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap = init.getSnapshot();
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    std::shared_ptr<NeighborListTree> nlist_tree(new NeighborListTree(sysdef, Scalar(3.0), Scalar(0.4)));
+    auto r_cut = std::make_shared<GlobalArray<Scalar>>(nlist_tree->getTypePairIndexer().getNumElements(),
+                                               exec_conf);
+        {
+        ArrayHandle<Scalar> h_r_cut(*r_cut, access_location::host, access_mode::overwrite);
+        h_r_cut.data[0] = 3.0;
+        }
+    nlist_tree->addRCutMatrix(r_cut);
+    nlist_tree->setStorageMode(NeighborList::full);
+    nlist_tree->setIncremental(true);
+    UP_ASSERT(nlist_tree->getIncremental());
+    nlist_tree->compute(0);
+
+    for (unsigned int step = 1; step <= 5; ++step)
+        {
+        // displace all particles by a small amount, so that some leave their leaves in the tree
+            {
+            ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+            ArrayHandle<int3> h_image(pdata->getImages(), access_location::host, access_mode::readwrite);
+            const BoxDim& box = pdata->getBox();
+            for (unsigned int i = 0; i < pdata->getN(); ++i)
+                {
+                Scalar3 delta = make_scalar3(Scalar(0.1)*sin(Scalar(i*step)),
+                                             Scalar(0.1)*cos(Scalar(i*step)),
+                                             Scalar(0.1)*sin(Scalar(i+step)));
+                Scalar3 pos = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z) + delta;
+                box.wrap(pos, h_image.data[i]);
+                h_pos.data[i].x = pos.x;
+                h_pos.data[i].y = pos.y;
+                h_pos.data[i].z = pos.z;
+                }
+            }
+
+        nlist_tree->forceUpdate();
+        nlist_tree->compute(step);
+
+        // reference list built from scratch
+        std::shared_ptr<NeighborList> nlist_ref(new NeighborListBinned(sysdef, Scalar(3.0), Scalar(0.4)));
+        nlist_ref->addRCutMatrix(r_cut);
+        nlist_ref->setStorageMode(NeighborList::full);
+        nlist_ref->compute(step);
+
+        ArrayHandle<unsigned int> h_n_neigh1(nlist_ref->getNNeighArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_nlist1(nlist_ref->getNListArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_head_list1(nlist_ref->getHeadList(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_n_neigh2(nlist_tree->getNNeighArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_nlist2(nlist_tree->getNListArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_head_list2(nlist_tree->getHeadList(), access_location::host, access_mode::read);
+
+        for (unsigned int i = 0; i < pdata->getN(); i++)
+            {
+            UP_ASSERT_EQUAL(h_n_neigh2.data[i], h_n_neigh1.data[i]);
+
+            std::vector<unsigned int> ref_list(h_nlist1.data + h_head_list1.data[i],
+                                               h_nlist1.data + h_head_list1.data[i] + h_n_neigh1.data[i]);
+            std::vector<unsigned int> test_list(h_nlist2.data + h_head_list2.data[i],
+                                                h_nlist2.data + h_head_list2.data[i] + h_n_neigh2.data[i]);
+            std::sort(ref_list.begin(), ref_list.end());
+            std::sort(test_list.begin(), test_list.end());
+            UP_ASSERT(ref_list == test_list);
+            }
+        }
+    }
+
 //! Test that a NeighborList can successfully exclude a ridiculously large number of particles
 template <class NL>
 void neighborlist_large_ex_tests(std::shared_ptr<ExecutionConfiguration> exec_conf)
@@ -1603,6 +1676,11 @@ UP_TEST( NeighborListTree_comparison )
     {
     neighborlist_comparison_test<NeighborListBinned, NeighborListTree>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
+//! incremental update test case for tree class
+UP_TEST( NeighborListTree_incremental )
+    {
+    neighborlist_tree_incremental_test(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
 
 #ifdef ENABLE_HIP
 ///////////////
@@ -24,6 +24,7 @@
 #include "hoomd/md/NeighborListTree.h"
 #include "hoomd/Initializers.h"
 #include "hoomd/SnapshotSystemData.h"
+#include "hoomd/filter/ParticleFilterAll.h"
 
 #include <math.h>
 
@@ -342,6 +343,196 @@ void nve_updater_compare_test(twostepnve_creator nve_creator1,
         }
     }
 
+//! Checks that adding the forces directly to the net force gives the same trajectory and per-force values
+void nve_updater_fused_net_force_test(twostepnve_creator nve_creator, std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    // two identical systems, the second sums the net force in fused mode
+    SimpleCubicInitializer cubic_init(8, Scalar(1.2), "A");
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap = cubic_init.getSnapshot();
+
+    std::shared_ptr<SystemDefinition> sysdef1(new SystemDefinition(snap, exec_conf));
+    std::shared_ptr<SystemDefinition> sysdef2(new SystemDefinition(snap, exec_conf));
+    std::shared_ptr<ParticleData> pdata1 = sysdef1->getParticleData();
+    std::shared_ptr<ParticleData> pdata2 = sysdef2->getParticleData();
+    const unsigned int N = pdata1->getN();
+
+    // request the virial, so that it is accumulated as well
+    PDataFlags flags;
+    flags[pdata_flag::pressure_tensor] = 1;
+    pdata1->setFlags(flags);
+    pdata2->setFlags(flags);
+
+    std::shared_ptr<ParticleFilter> selector_all(new ParticleFilterAll());
+    std::shared_ptr<ParticleGroup> group_all1(new ParticleGroup(sysdef1, selector_all));
+    std::shared_ptr<ParticleGroup> group_all2(new ParticleGroup(sysdef2, selector_all));
+
+    std::shared_ptr<NeighborListTree> nlist1(new NeighborListTree(sysdef1, Scalar(3.0), Scalar(0.8)));
+    std::shared_ptr<NeighborListTree> nlist2(new NeighborListTree(sysdef2, Scalar(3.0), Scalar(0.8)));
+
+    std::shared_ptr<PotentialPairLJ> fc1(new PotentialPairLJ(sysdef1, nlist1));
+    std::shared_ptr<PotentialPairLJ> fc2(new PotentialPairLJ(sysdef2, nlist2));
+    fc1->setRcut(0, 0, Scalar(3.0));
+    fc2->setRcut(0, 0, Scalar(3.0));
+    fc1->setParams(0,0,EvaluatorPairLJ::param_type(Scalar(1.2), Scalar(1.0), Scalar(0.45)));
+    fc2->setParams(0,0,EvaluatorPairLJ::param_type(Scalar(1.2), Scalar(1.0), Scalar(0.45)));
+
+    // a force compute without support for accumulation is summed from its own arrays
+    std::shared_ptr<ConstForceCompute> const1(new ConstForceCompute(sysdef1, Scalar(0.1), Scalar(-0.2), Scalar(0.3)));
+    std::shared_ptr<ConstForceCompute> const2(new ConstForceCompute(sysdef2, Scalar(0.1), Scalar(-0.2), Scalar(0.3)));
+
+    std::shared_ptr<IntegratorTwoStep> nve1(new IntegratorTwoStep(sysdef1, Scalar(0.005)));
+    std::shared_ptr<IntegratorTwoStep> nve2(new IntegratorTwoStep(sysdef2, Scalar(0.005)));
+    nve1->addIntegrationMethod(nve_creator(sysdef1, group_all1));
+    nve2->addIntegrationMethod(nve_creator(sysdef2, group_all2));
+    nve1->addForceCompute(fc1);
+    nve1->addForceCompute(const1);
+    nve2->addForceCompute(fc2);
+    nve2->addForceCompute(const2);
+    nve2->setFusedNetForce(true);
+    UP_ASSERT(nve2->getFusedNetForce());
+
+    nve1->prepRun(0);
+    nve2->prepRun(0);
+
+    for (unsigned int i = 0; i < 10; i++)
+        {
+        nve1->update(i);
+        nve2->update(i);
+
+        // the summation order is the same, so the results agree to round off
+            {
+            ArrayHandle<Scalar4> h_pos1(pdata1->getPositions(), access_location::host, access_mode::read);
+            ArrayHandle<Scalar4> h_pos2(pdata2->getPositions(), access_location::host, access_mode::read);
+            ArrayHandle<Scalar4> h_net_force1(pdata1->getNetForce(), access_location::host, access_mode::read);
+            ArrayHandle<Scalar4> h_net_force2(pdata2->getNetForce(), access_location::host, access_mode::read);
+            ArrayHandle<Scalar> h_net_virial1(pdata1->getNetVirial(), access_location::host, access_mode::read);
+            ArrayHandle<Scalar> h_net_virial2(pdata2->getNetVirial(), access_location::host, access_mode::read);
+            unsigned int pitch1 = pdata1->getNetVirial().getPitch();
+            unsigned int pitch2 = pdata2->getNetVirial().getPitch();
+
+            for (unsigned int j = 0; j < N; j++)
+                {
+                MY_CHECK_CLOSE(h_pos1.data[j].x, h_pos2.data[j].x, tol);
+                MY_CHECK_CLOSE(h_pos1.data[j].y, h_pos2.data[j].y, tol);
+                MY_CHECK_CLOSE(h_pos1.data[j].z, h_pos2.data[j].z, tol);
+                MY_CHECK_CLOSE(h_net_force1.data[j].x, h_net_force2.data[j].x, tol);
+                MY_CHECK_CLOSE(h_net_force1.data[j].y, h_net_force2.data[j].y, tol);
+                MY_CHECK_CLOSE(h_net_force1.data[j].z, h_net_force2.data[j].z, tol);
+                MY_CHECK_CLOSE(h_net_force1.data[j].w, h_net_force2.data[j].w, tol);
+                for (unsigned int k = 0; k < 6; k++)
+                    MY_CHECK_SMALL(h_net_virial1.data[k*pitch1+j] - h_net_virial2.data[k*pitch2+j], tol_small);
+                }
+            }
+
+        // the pair forces were not stored in the per-force arrays, they are computed when queried
+        UP_ASSERT(fc2->isNetForceAccumulated());
+        UP_ASSERT(!const2->isNetForceAccumulated());
+        MY_CHECK_CLOSE(fc1->calcEnergySum(), fc2->calcEnergySum(), tol);
+        for (unsigned int tag = 0; tag < N; tag += 37)
+            {
+            Scalar3 f1 = fc1->getForce(tag);
+            Scalar3 f2 = fc2->getForce(tag);
+            MY_CHECK_CLOSE(f1.x, f2.x, tol);
+            MY_CHECK_CLOSE(f1.y, f2.y, tol);
+            MY_CHECK_CLOSE(f1.z, f2.z, tol);
+            MY_CHECK_SMALL(fc1->getVirial(tag, 0) - fc2->getVirial(tag, 0), tol_small);
+            }
+        }
+    }
+
+//! Checks that computing independent forces concurrently gives the same trajectory as computing them in sequence
+void nve_updater_concurrent_forces_test(twostepnve_creator nve_creator,
+                                        std::shared_ptr<ExecutionConfiguration> exec_conf,
+                                        bool fused)
+    {
+    #ifdef ENABLE_TBB
+    exec_conf->setNumThreads(4);
+    #endif
+
+    // two identical systems, the second computes its forces concurrently
+    SimpleCubicInitializer cubic_init(8, Scalar(1.2), "A");
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap = cubic_init.getSnapshot();
+
+    std::shared_ptr<SystemDefinition> sysdef[2];
+    std::shared_ptr<PotentialPairLJ> lj[2];
+    std::shared_ptr<PotentialPairGauss> gauss[2];
+    std::shared_ptr<IntegratorTwoStep> nve[2];
+    for (unsigned int s = 0; s < 2; s++)
+        {
+        sysdef[s] = std::shared_ptr<SystemDefinition>(new SystemDefinition(snap, exec_conf));
+
+        PDataFlags flags;
+        flags[pdata_flag::pressure_tensor] = 1;
+        sysdef[s]->getParticleData()->setFlags(flags);
+
+        std::shared_ptr<ParticleFilter> selector_all(new ParticleFilterAll());
+        std::shared_ptr<ParticleGroup> group_all(new ParticleGroup(sysdef[s], selector_all));
+
+        // both pair potentials share the neighbor list
+        std::shared_ptr<NeighborListTree> nlist(new NeighborListTree(sysdef[s], Scalar(3.0), Scalar(0.8)));
+        lj[s] = std::shared_ptr<PotentialPairLJ>(new PotentialPairLJ(sysdef[s], nlist));
+        lj[s]->setRcut(0, 0, Scalar(3.0));
+        lj[s]->setParams(0,0,EvaluatorPairLJ::param_type(Scalar(1.2), Scalar(1.0), Scalar(0.45)));
+        gauss[s] = std::shared_ptr<PotentialPairGauss>(new PotentialPairGauss(sysdef[s], nlist));
+        gauss[s]->setRcut(0, 0, Scalar(2.5));
+        gauss[s]->setParams(0,0,EvaluatorPairGauss::param_type(Scalar(0.5), Scalar(0.8)));
+
+        // ConstForceCompute can not be computed concurrently, it is computed before the others
+        std::shared_ptr<ConstForceCompute> cf(new ConstForceCompute(sysdef[s], Scalar(0.1), Scalar(-0.2), Scalar(0.3)));
+
+        nve[s] = std::shared_ptr<IntegratorTwoStep>(new IntegratorTwoStep(sysdef[s], Scalar(0.005)));
+        nve[s]->addIntegrationMethod(nve_creator(sysdef[s], group_all));
+        nve[s]->addForceCompute(lj[s]);
+        nve[s]->addForceCompute(cf);
+        nve[s]->addForceCompute(gauss[s]);
+        nve[s]->setFusedNetForce(fused);
+        }
+    nve[1]->setConcurrentForces(true);
+    UP_ASSERT(nve[1]->getConcurrentForces());
+    UP_ASSERT(!nve[0]->getConcurrentForces());
+
+    std::shared_ptr<ParticleData> pdata1 = sysdef[0]->getParticleData();
+    std::shared_ptr<ParticleData> pdata2 = sysdef[1]->getParticleData();
+    const unsigned int N = pdata1->getN();
+
+    nve[0]->prepRun(0);
+    nve[1]->prepRun(0);
+
+    for (unsigned int i = 0; i < 10; i++)
+        {
+        nve[0]->update(i);
+        nve[1]->update(i);
+
+        // the forces are summed in the same order, so the results agree to round off
+            {
+            ArrayHandle<Scalar4> h_pos1(pdata1->getPositions(), access_location::host, access_mode::read);
+            ArrayHandle<Scalar4> h_pos2(pdata2->getPositions(), access_location::host, access_mode::read);
+            ArrayHandle<Scalar4> h_net_force1(pdata1->getNetForce(), access_location::host, access_mode::read);
+            ArrayHandle<Scalar4> h_net_force2(pdata2->getNetForce(), access_location::host, access_mode::read);
+            ArrayHandle<Scalar> h_net_virial1(pdata1->getNetVirial(), access_location::host, access_mode::read);
+            ArrayHandle<Scalar> h_net_virial2(pdata2->getNetVirial(), access_location::host, access_mode::read);
+            unsigned int pitch1 = pdata1->getNetVirial().getPitch();
+            unsigned int pitch2 = pdata2->getNetVirial().getPitch();
+
+            for (unsigned int j = 0; j < N; j++)
+                {
+                MY_CHECK_CLOSE(h_pos1.data[j].x, h_pos2.data[j].x, tol);
+                MY_CHECK_CLOSE(h_pos1.data[j].y, h_pos2.data[j].y, tol);
+                MY_CHECK_CLOSE(h_pos1.data[j].z, h_pos2.data[j].z, tol);
+                MY_CHECK_CLOSE(h_net_force1.data[j].x, h_net_force2.data[j].x, tol);
+                MY_CHECK_CLOSE(h_net_force1.data[j].y, h_net_force2.data[j].y, tol);
+                MY_CHECK_CLOSE(h_net_force1.data[j].z, h_net_force2.data[j].z, tol);
+                MY_CHECK_CLOSE(h_net_force1.data[j].w, h_net_force2.data[j].w, tol);
+                for (unsigned int k = 0; k < 6; k++)
+                    MY_CHECK_SMALL(h_net_virial1.data[k*pitch1+j] - h_net_virial2.data[k*pitch2+j], tol_small);
+                }
+            }
+
+        MY_CHECK_CLOSE(lj[0]->calcEnergySum(), lj[1]->calcEnergySum(), tol);
+        MY_CHECK_CLOSE(gauss[0]->calcEnergySum(), gauss[1]->calcEnergySum(), tol);
+        }
+    }
+
 void nve_updater_aniso_test(std::shared_ptr<ExecutionConfiguration> exec_conf, twostepnve_creator nve_creator)
 {
     // initialize random particle system
@@ -476,6 +667,27 @@ UP_TEST( TwoStepNVE_aniso_test )
     nve_updater_aniso_test(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)),bind(base_class_nve_creator, _1, _2));
     }
 
+//! test case for adding the forces directly to the net force
+UP_TEST( TwoStepNVE_fused_net_force_test )
+    {
+    twostepnve_creator nve_creator = bind(base_class_nve_creator, _1, _2);
+    nve_updater_fused_net_force_test(nve_creator, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
+//! test case for computing independent forces concurrently
+UP_TEST( TwoStepNVE_concurrent_forces_test )
+    {
+    twostepnve_creator nve_creator = bind(base_class_nve_creator, _1, _2);
+    nve_updater_concurrent_forces_test(nve_creator, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)), false);
+    }
+
+//! test case for computing independent forces concurrently and adding them directly to the net force
+UP_TEST( TwoStepNVE_concurrent_fused_net_force_test )
+    {
+    twostepnve_creator nve_creator = bind(base_class_nve_creator, _1, _2);
+    nve_updater_concurrent_forces_test(nve_creator, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)), true);
+    }
+
 //! Need work on NVEUpdaterGPU with rigid bodies to test these cases
 #ifdef ENABLE_HIP
 //! test case for base class integration tests
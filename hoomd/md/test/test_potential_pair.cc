@@ -0,0 +1,358 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include <iostream>
+#include <functional>
+#include <vector>
+
+#include "hoomd/md/AllPairPotentials.h"
+#include "hoomd/md/NeighborListTree.h"
+
+using namespace std;
+using namespace std::placeholders;
+
+/*! \file test_potential_pair.cc
+    \brief Implements unit tests for the CPU kernels of PotentialPair
+    \ingroup unit_tests
+*/
+
+#include "hoomd/test/upp11_config.h"
+HOOMD_UP_MAIN();
+
+//! Wraps a pair evaluator and hides its evalForceAndEnergyBatch(), so that PotentialPair uses the per pair kernel
+template<class evaluator>
+class EvaluatorPairNoBatch
+    {
+    public:
+        typedef typename evaluator::param_type param_type;
+
+        EvaluatorPairNoBatch(Scalar _rsq, Scalar _rcutsq, const param_type& _params)
+            : m_eval(_rsq, _rcutsq, _params)
+            {
+            }
+
+        static bool needsDiameter() { return evaluator::needsDiameter(); }
+        static bool needsCharge() { return evaluator::needsCharge(); }
+        void setDiameter(Scalar di, Scalar dj) { m_eval.setDiameter(di, dj); }
+        void setCharge(Scalar qi, Scalar qj) { m_eval.setCharge(qi, qj); }
+
+        bool evalForceAndEnergy(Scalar& force_divr, Scalar& pair_eng, bool energy_shift)
+            {
+            return m_eval.evalForceAndEnergy(force_divr, pair_eng, energy_shift);
+            }
+
+        static std::string getName() { return evaluator::getName(); }
+        std::string getShapeSpec() const { return m_eval.getShapeSpec(); }
+
+    private:
+        evaluator m_eval;   //!< Wrapped evaluator
+    };
+
+//! Forces, energies and virials of a force compute
+struct pair_forces
+    {
+    std::vector<Scalar4> force;     //!< Forces and energies
+    std::vector<Scalar> virial;     //!< Virials, six arrays of N entries
+    };
+
+//! Create a jittered simple cubic lattice of n_side^3 particles with two types
+std::shared_ptr<SystemDefinition> make_lattice_system(unsigned int n_side,
+                                                      std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    const unsigned int N = n_side*n_side*n_side;
+    const Scalar a = Scalar(1.2);
+    BoxDim box(a*n_side);
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(N, box, 2, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    Scalar3 lo = box.getLo();
+    srand(12345);
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::overwrite);
+        for (unsigned int i = 0; i < N; i++)
+            {
+            unsigned int ix = i % n_side;
+            unsigned int iy = (i / n_side) % n_side;
+            unsigned int iz = i / (n_side*n_side);
+            Scalar3 jitter = make_scalar3((Scalar)rand()/(Scalar)RAND_MAX - Scalar(0.5),
+                                          (Scalar)rand()/(Scalar)RAND_MAX - Scalar(0.5),
+                                          (Scalar)rand()/(Scalar)RAND_MAX - Scalar(0.5))*Scalar(0.3);
+            h_pos.data[i] = make_scalar4(lo.x + (ix + Scalar(0.5))*a + jitter.x,
+                                         lo.y + (iy + Scalar(0.5))*a + jitter.y,
+                                         lo.z + (iz + Scalar(0.5))*a + jitter.z,
+                                         __int_as_scalar(rand() % 2));
+            }
+        }
+
+    pdata->setFlags(~PDataFlags(0));
+    return sysdef;
+    }
+
+//! Copy the forces and virials of a force compute
+pair_forces get_forces(std::shared_ptr<ForceCompute> fc, unsigned int N)
+    {
+    pair_forces result;
+    GlobalArray<Scalar4>& force_array = fc->getForceArray();
+    GlobalArray<Scalar>& virial_array = fc->getVirialArray();
+    unsigned int pitch = virial_array.getPitch();
+    ArrayHandle<Scalar4> h_force(force_array, access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_virial(virial_array, access_location::host, access_mode::read);
+
+    result.force.assign(h_force.data, h_force.data + N);
+    for (unsigned int k = 0; k < 6; k++)
+        result.virial.insert(result.virial.end(), h_virial.data + k*pitch, h_virial.data + k*pitch + N);
+    return result;
+    }
+
+//! Check that a value agrees with a reference to round off, relative to the reference when it is larger than one
+void check_close(Scalar a, Scalar ref)
+    {
+    MY_CHECK_SMALL((a - ref) / std::max(Scalar(1.0), Scalar(fabs(ref))), tol_small);
+    }
+
+//! Check that two sets of forces agree to round off
+void check_forces_close(const pair_forces& a, const pair_forces& b)
+    {
+    UP_ASSERT_EQUAL(a.force.size(), b.force.size());
+    for (unsigned int i = 0; i < a.force.size(); i++)
+        {
+        check_close(a.force[i].x, b.force[i].x);
+        check_close(a.force[i].y, b.force[i].y);
+        check_close(a.force[i].z, b.force[i].z);
+        check_close(a.force[i].w, b.force[i].w);
+        }
+    for (unsigned int i = 0; i < a.virial.size(); i++)
+        check_close(a.virial[i], b.virial[i]);
+    }
+
+//! Set the parameters of all type pairs, params holds those of the pairs (0,0), (0,1) and (1,1)
+template<class Potential>
+void set_pair_params(std::shared_ptr<Potential> pair,
+                     const std::vector<typename Potential::param_type>& params)
+    {
+    unsigned int k = 0;
+    for (unsigned int a = 0; a < 2; a++)
+        for (unsigned int b = a; b < 2; b++, k++)
+            {
+            pair->setParams(a, b, params[k]);
+            pair->setRcut(a, b, Scalar(2.5) - Scalar(0.25)*(a+b));
+            pair->setRon(a, b, Scalar(2.0) - Scalar(0.25)*(a+b));
+            }
+    }
+
+//! Compare the batched evaluation of a pair potential to the per pair evaluation
+/*! The pairs lie inside and beyond the cutoff, some exactly at the cutoff, and the last batch is padded like in
+    PotentialPair::computeForcesKernelBatch(). Pairs that are not evaluated must get zero force and energy.
+*/
+template<class evaluator>
+void evaluator_batch_compare(const std::vector<typename evaluator::param_type>& params)
+    {
+    typedef typename evaluator::param_type param_type;
+    const unsigned int W = hoomd::detail::pair_batch_width;
+
+    std::vector<Scalar> rsq, rcutsq;
+    std::vector<param_type> param;
+    srand(12345);
+    for (unsigned int k = 0; k < 5*W + 3; k++)
+        {
+        Scalar rcut = Scalar(1.5) + Scalar(0.5)*(k % 3);
+        Scalar r = Scalar(0.8) + (Scalar)rand()/(Scalar)RAND_MAX*(rcut + Scalar(0.5) - Scalar(0.8));
+        rsq.push_back((k % 7 == 0) ? rcut*rcut : r*r);
+        rcutsq.push_back(rcut*rcut);
+        param.push_back(params[k % params.size()]);
+        }
+
+    // padding of the last batch
+    const unsigned int n = (unsigned int)rsq.size();
+    while (rsq.size() % W)
+        {
+        rsq.push_back(Scalar(1.0));
+        rcutsq.push_back(Scalar(0.0));
+        param.push_back(param[0]);
+        }
+
+    for (unsigned int s = 0; s < 2; s++)
+        {
+        const bool energy_shift = (s == 1);
+        std::vector<Scalar> force_divr(rsq.size()), pair_eng(rsq.size());
+        for (unsigned int b = 0; b < rsq.size(); b += W)
+            evaluator::evalForceAndEnergyBatch(W, &rsq[b], &rcutsq[b], &param[b], &force_divr[b], &pair_eng[b],
+                                               energy_shift);
+
+        unsigned int n_evaluated = 0;
+        for (unsigned int k = 0; k < rsq.size(); k++)
+            {
+            Scalar force_divr_ref = Scalar(0.0), pair_eng_ref = Scalar(0.0);
+            evaluator eval(rsq[k], rcutsq[k], param[k]);
+            if (eval.evalForceAndEnergy(force_divr_ref, pair_eng_ref, energy_shift))
+                {
+                UP_ASSERT(k < n);
+                n_evaluated++;
+                }
+            else
+                {
+                force_divr_ref = Scalar(0.0);
+                pair_eng_ref = Scalar(0.0);
+                }
+
+            check_close(force_divr[k], force_divr_ref);
+            check_close(pair_eng[k], pair_eng_ref);
+            }
+
+        // the test would be trivial if no pair was evaluated
+        UP_ASSERT(n_evaluated > n/4);
+        }
+    }
+
+//! Batched LJ evaluation, including zero parameters
+UP_TEST( EvaluatorPairLJ_batch_compare )
+    {
+    std::vector<EvaluatorPairLJ::param_type> params;
+    params.push_back(EvaluatorPairLJ::param_type(Scalar(1.0), Scalar(1.0)));
+    params.push_back(EvaluatorPairLJ::param_type(Scalar(1.2), Scalar(0.5), Scalar(0.5)));
+    params.push_back(EvaluatorPairLJ::param_type());
+    evaluator_batch_compare<EvaluatorPairLJ>(params);
+    }
+
+//! Batched Gauss evaluation, including zero epsilon
+UP_TEST( EvaluatorPairGauss_batch_compare )
+    {
+    std::vector<EvaluatorPairGauss::param_type> params;
+    params.push_back(EvaluatorPairGauss::param_type(Scalar(1.0), Scalar(0.5)));
+    params.push_back(EvaluatorPairGauss::param_type(Scalar(-2.0), Scalar(1.1)));
+    params.push_back(EvaluatorPairGauss::param_type(Scalar(0.0), Scalar(1.0)));
+    evaluator_batch_compare<EvaluatorPairGauss>(params);
+    }
+
+//! Batched Yukawa evaluation, including zero parameters
+UP_TEST( EvaluatorPairYukawa_batch_compare )
+    {
+    std::vector<EvaluatorPairYukawa::param_type> params;
+    params.push_back(EvaluatorPairYukawa::param_type(Scalar(1.0), Scalar(0.5)));
+    params.push_back(EvaluatorPairYukawa::param_type(Scalar(2.0), Scalar(3.0)));
+    params.push_back(EvaluatorPairYukawa::param_type());
+    evaluator_batch_compare<EvaluatorPairYukawa>(params);
+    }
+
+//! Batched Morse evaluation, including zero parameters
+UP_TEST( EvaluatorPairMorse_batch_compare )
+    {
+    std::vector<EvaluatorPairMorse::param_type> params;
+    params.push_back(EvaluatorPairMorse::param_type(Scalar(1.0), Scalar(3.0), Scalar(1.1)));
+    params.push_back(EvaluatorPairMorse::param_type(Scalar(0.5), Scalar(1.5), Scalar(1.3)));
+    params.push_back(EvaluatorPairMorse::param_type());
+    evaluator_batch_compare<EvaluatorPairMorse>(params);
+    }
+
+//! Compare the batched force kernel of PotentialPair to the per pair kernel
+/*! Neighbor counts are generally not multiples of the batch width, and the neighbor list buffer adds pairs beyond
+    the cutoff.
+*/
+template<class evaluator>
+void potential_batch_compare(const std::vector<typename evaluator::param_type>& params)
+    {
+    typedef PotentialPair<evaluator> Potential;
+    typedef PotentialPair< EvaluatorPairNoBatch<evaluator> > PotentialNoBatch;
+
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    std::shared_ptr<SystemDefinition> sysdef = make_lattice_system(10, exec_conf);
+    const unsigned int N = sysdef->getParticleData()->getN();
+
+    NeighborList::storageMode modes[] = {NeighborList::half, NeighborList::full};
+    for (unsigned int m = 0; m < 2; m++)
+        {
+        std::shared_ptr<NeighborListTree> nlist(new NeighborListTree(sysdef, Scalar(2.5), Scalar(0.3)));
+        nlist->setStorageMode(modes[m]);
+
+        std::shared_ptr<Potential> pair(new Potential(sysdef, nlist));
+        set_pair_params(pair, params);
+        std::shared_ptr<PotentialNoBatch> pair_ref(new PotentialNoBatch(sysdef, nlist));
+        set_pair_params(pair_ref, params);
+
+        typename Potential::energyShiftMode shift_modes[] = {Potential::no_shift, Potential::shift};
+        for (unsigned int s = 0; s < 2; s++)
+            {
+            pair->setShiftMode(shift_modes[s]);
+            pair_ref->setShiftMode(typename PotentialNoBatch::energyShiftMode(shift_modes[s]));
+            pair->compute(s);
+            pair_ref->compute(s);
+            check_forces_close(get_forces(pair, N), get_forces(pair_ref, N));
+            }
+        }
+    }
+
+//! Batched LJ force kernel
+UP_TEST( PotentialPairLJ_batch_compare )
+    {
+    std::vector<EvaluatorPairLJ::param_type> params;
+    params.push_back(EvaluatorPairLJ::param_type(Scalar(1.0), Scalar(1.0)));
+    params.push_back(EvaluatorPairLJ::param_type());
+    params.push_back(EvaluatorPairLJ::param_type(Scalar(0.9), Scalar(1.5), Scalar(0.5)));
+    potential_batch_compare<EvaluatorPairLJ>(params);
+    }
+
+//! Batched Morse force kernel
+UP_TEST( PotentialPairMorse_batch_compare )
+    {
+    std::vector<EvaluatorPairMorse::param_type> params;
+    params.push_back(EvaluatorPairMorse::param_type(Scalar(1.0), Scalar(3.0), Scalar(1.1)));
+    params.push_back(EvaluatorPairMorse::param_type());
+    params.push_back(EvaluatorPairMorse::param_type(Scalar(0.5), Scalar(1.5), Scalar(1.3)));
+    potential_batch_compare<EvaluatorPairMorse>(params);
+    }
+
+#ifdef ENABLE_TBB
+//! Compare the multithreaded pair forces to the serial ones
+template<class Potential>
+void pair_threads_compare(typename Potential::param_type params,
+                          typename Potential::energyShiftMode shift_mode,
+                          NeighborList::storageMode storage_mode)
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    std::shared_ptr<SystemDefinition> sysdef = make_lattice_system(13, exec_conf);
+    const unsigned int N = sysdef->getParticleData()->getN();
+
+    std::shared_ptr<NeighborListTree> nlist(new NeighborListTree(sysdef, Scalar(2.5), Scalar(0.3)));
+    nlist->setStorageMode(storage_mode);
+    std::shared_ptr<Potential> pair(new Potential(sysdef, nlist));
+    set_pair_params(pair, std::vector<typename Potential::param_type>(3, params));
+    pair->setShiftMode(shift_mode);
+
+    exec_conf->setNumThreads(1);
+    pair->compute(0);
+    pair_forces serial = get_forces(pair, N);
+
+    // an odd number of blocks, and more blocks than cores
+    unsigned int num_threads[] = {3, 8};
+    for (unsigned int t = 0; t < 2; t++)
+        {
+        exec_conf->setNumThreads(num_threads[t]);
+        pair->compute(2*t+1);
+        pair_forces threads = get_forces(pair, N);
+        check_forces_close(serial, threads);
+
+        // the summation order only depends on the number of threads
+        pair->compute(2*t+2);
+        pair_forces repeat = get_forces(pair, N);
+        for (unsigned int i = 0; i < N; i++)
+            {
+            UP_ASSERT_EQUAL(threads.force[i].x, repeat.force[i].x);
+            UP_ASSERT_EQUAL(threads.force[i].w, repeat.force[i].w);
+            }
+        }
+    exec_conf->setNumThreads(1);
+    }
+
+//! Multithreaded LJ forces with half and full neighbor lists, in the batched (shift) and per pair (xplor) kernels
+UP_TEST( PotentialPairLJ_threads_compare )
+    {
+    EvaluatorPairLJ::param_type params(Scalar(1.0), Scalar(1.0));
+    pair_threads_compare<PotentialPairLJ>(params, PotentialPairLJ::shift, NeighborList::half);
+    pair_threads_compare<PotentialPairLJ>(params, PotentialPairLJ::xplor, NeighborList::half);
+    pair_threads_compare<PotentialPairLJ>(params, PotentialPairLJ::shift, NeighborList::full);
+    }
+#endif
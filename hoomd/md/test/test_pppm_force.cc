@@ -18,6 +18,7 @@
 
 #include "hoomd/md/NeighborListTree.h"
 #include "hoomd/Initializers.h"
+#include "hoomd/filter/ParticleFilterAll.h"
 #include "hoomd/filter/ParticleFilterTags.h"
 
 #include <math.h>
@@ -200,6 +201,160 @@ void pppm_force_particle_test_triclinic(pppmforce_creator pppm_creator, std::sha
     }
 
 
+//! Test that analytical differentiation gives the same forces as ik differentiation on a fine mesh
+void pppm_force_ad_test(pppmforce_creator pppm_creator, std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    // the same 2-particle system as in pppm_force_particle_test, on a finer mesh where the discretization
+    // errors of both schemes are small
+    std::shared_ptr<SystemDefinition> sysdef_2(new SystemDefinition(2, BoxDim(6.0, 10.0, 14.0), 1, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata_2 = sysdef_2->getParticleData();
+    pdata_2->setFlags(~PDataFlags(0));
+
+    std::shared_ptr<NeighborListTree> nlist_2(new NeighborListTree(sysdef_2, Scalar(1.0), Scalar(1.0)));
+    std::shared_ptr<ParticleFilter> selector_all(new ParticleFilterTags(std::vector<unsigned int>({0, 1})));
+    std::shared_ptr<ParticleGroup> group_all(new ParticleGroup(sysdef_2, selector_all));
+
+    {
+    ArrayHandle<Scalar4> h_pos(pdata_2->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar> h_charge(pdata_2->getCharges(), access_location::host, access_mode::readwrite);
+
+    h_pos.data[0].x = h_pos.data[0].y = h_pos.data[0].z = 1.0;
+    h_charge.data[0] = 1.0;
+    h_pos.data[1].x = h_pos.data[1].y = h_pos.data[1].z = 2.0;
+    h_charge.data[1] = -1.0;
+    }
+
+    std::shared_ptr<PPPMForceCompute> fc_ik = pppm_creator(sysdef_2, nlist_2, group_all);
+    std::shared_ptr<PPPMForceCompute> fc_ad = pppm_creator(sysdef_2, nlist_2, group_all);
+
+    int Nx = 12;
+    int Ny = 20;
+    int Nz = 28;
+    int order = 5;
+    Scalar kappa = 1.0;
+    Scalar rcut = 1.0;
+    fc_ik->setParams(Nx, Ny, Nz, order, kappa, rcut);
+    fc_ad->setParams(Nx, Ny, Nz, order, kappa, rcut);
+    fc_ad->setAnalyticalDifferentiation(true);
+    UP_ASSERT(fc_ad->getAnalyticalDifferentiation());
+
+    fc_ik->compute(0);
+    fc_ad->compute(0);
+
+    ArrayHandle<Scalar4> h_force_ik(fc_ik->getForceArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_force_ad(fc_ad->getForceArray(), access_location::host, access_mode::read);
+
+    for (unsigned int i = 0; i < 2; ++i)
+        {
+        MY_CHECK_CLOSE(h_force_ad.data[i].x, h_force_ik.data[i].x, tol_small);
+        MY_CHECK_CLOSE(h_force_ad.data[i].y, h_force_ik.data[i].y, tol_small);
+        MY_CHECK_CLOSE(h_force_ad.data[i].z, h_force_ik.data[i].z, tol_small);
+        }
+
+    // the self force correction keeps the forces on the pair equal and opposite
+    MY_CHECK_CLOSE(h_force_ad.data[0].x, -h_force_ad.data[1].x, tol_small);
+    MY_CHECK_CLOSE(h_force_ad.data[0].y, -h_force_ad.data[1].y, tol_small);
+    MY_CHECK_CLOSE(h_force_ad.data[0].z, -h_force_ad.data[1].z, tol_small);
+
+    // without aliasing images in the sum, the influence functions of both schemes agree
+    MY_CHECK_CLOSE(fc_ad->getExternalEnergy(), fc_ik->getExternalEnergy(), tol_small);
+    for (unsigned int i = 0; i < 6; ++i)
+        MY_CHECK_CLOSE(fc_ad->getExternalVirial(i), fc_ik->getExternalVirial(i), tol_small);
+    }
+
+#ifdef ENABLE_TBB
+//! Test that multithreaded PPPM gives the same forces, energies and virials as a single thread
+/*! The charges are assigned in slabs along z that are at least \a order mesh points thick. Without domain
+    decomposition, the number of slabs is rounded down to an even number, so that the two slabs at the periodic
+    boundary are assigned in different passes. \a Nz is chosen such that Nz/order is odd before the rounding and the
+    slabs are not multiples of \a order thick.
+*/
+void pppm_force_threads_test(pppmforce_creator pppm_creator, std::shared_ptr<ExecutionConfiguration> exec_conf,
+                             int Nz, int order)
+    {
+    // a neutral system of random charges
+    const unsigned int N = 500;
+    BoxDim box(8.0, 9.0, 11.0);
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(N, box, 1, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    pdata->setFlags(~PDataFlags(0));
+
+    Scalar3 lo = box.getLo();
+    Scalar3 L = box.getL();
+    srand(12345);
+    {
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar> h_charge(pdata->getCharges(), access_location::host, access_mode::readwrite);
+    for (unsigned int i = 0; i < N; ++i)
+        {
+        h_pos.data[i].x = lo.x + (Scalar)rand()/(Scalar)RAND_MAX*L.x;
+        h_pos.data[i].y = lo.y + (Scalar)rand()/(Scalar)RAND_MAX*L.y;
+        h_pos.data[i].z = lo.z + (Scalar)rand()/(Scalar)RAND_MAX*L.z;
+        h_charge.data[i] = (i % 2) ? Scalar(-1.0) : Scalar(1.0);
+        }
+    }
+
+    std::shared_ptr<NeighborListTree> nlist(new NeighborListTree(sysdef, Scalar(1.0), Scalar(0.4)));
+    std::shared_ptr<ParticleFilter> selector_all(new ParticleFilterAll());
+    std::shared_ptr<ParticleGroup> group_all(new ParticleGroup(sysdef, selector_all));
+
+    // the FFT is set up for the number of threads at the first compute, so every run gets a new compute
+    unsigned int num_threads[] = {1, 2, 3, 5};
+    std::vector<Scalar4> force[4];
+    std::vector<Scalar> virial[4];
+    Scalar energy[4];
+    Scalar external_virial[4][6];
+    for (unsigned int t = 0; t < 4; ++t)
+        {
+        exec_conf->setNumThreads(num_threads[t]);
+        std::shared_ptr<PPPMForceCompute> fc = pppm_creator(sysdef, nlist, group_all);
+        fc->setParams(12, 15, Nz, order, Scalar(1.5), Scalar(1.0));
+        fc->compute(0);
+
+        ArrayHandle<Scalar4> h_force(fc->getForceArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_virial(fc->getVirialArray(), access_location::host, access_mode::read);
+        unsigned int pitch = fc->getVirialArray().getPitch();
+        force[t].assign(h_force.data, h_force.data + N);
+        for (unsigned int k = 0; k < 6; ++k)
+            {
+            virial[t].insert(virial[t].end(), h_virial.data + k*pitch, h_virial.data + k*pitch + N);
+            external_virial[t][k] = fc->getExternalVirial(k);
+            }
+        energy[t] = fc->getExternalEnergy();
+        }
+    exec_conf->setNumThreads(1);
+
+    for (unsigned int t = 1; t < 4; ++t)
+        {
+        // the summation order differs from the serial code, so the results agree to round off
+        for (unsigned int i = 0; i < N; ++i)
+            {
+            MY_CHECK_SMALL(force[t][i].x - force[0][i].x, tol_small);
+            MY_CHECK_SMALL(force[t][i].y - force[0][i].y, tol_small);
+            MY_CHECK_SMALL(force[t][i].z - force[0][i].z, tol_small);
+            MY_CHECK_SMALL(force[t][i].w - force[0][i].w, tol_small);
+            }
+        for (unsigned int i = 0; i < 6*N; ++i)
+            MY_CHECK_SMALL(virial[t][i] - virial[0][i], tol_small);
+        MY_CHECK_CLOSE(energy[t], energy[0], tol_small);
+        for (unsigned int k = 0; k < 6; ++k)
+            MY_CHECK_CLOSE(external_virial[t][k], external_virial[0][k], tol_small);
+
+        // and the summation order is the same for any number of threads greater than one
+        if (t > 1)
+            {
+            for (unsigned int i = 0; i < N; ++i)
+                {
+                UP_ASSERT_EQUAL(force[t][i].x, force[1][i].x);
+                UP_ASSERT_EQUAL(force[t][i].y, force[1][i].y);
+                UP_ASSERT_EQUAL(force[t][i].z, force[1][i].z);
+                }
+            UP_ASSERT_EQUAL(energy[t], energy[1]);
+            }
+        }
+    }
+#endif
+
 //! PPPMForceCompute creator for unit tests
 std::shared_ptr<PPPMForceCompute> base_class_pppm_creator(std::shared_ptr<SystemDefinition> sysdef,
                                                      std::shared_ptr<NeighborList> nlist,
@@ -234,6 +389,28 @@ UP_TEST( PPPMForceCompute_triclinic )
     pppm_force_particle_test_triclinic(pppm_creator, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
 
+//! test case for analytical differentiation on CPU
+UP_TEST( PPPMForceCompute_ad )
+    {
+    pppmforce_creator pppm_creator = bind(base_class_pppm_creator, _1, _2, _3);
+    pppm_force_ad_test(pppm_creator, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
+
+#ifdef ENABLE_TBB
+//! test case for multithreaded PPPM on CPU
+UP_TEST( PPPMForceCompute_threads )
+    {
+    pppmforce_creator pppm_creator = bind(base_class_pppm_creator, _1, _2, _3);
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+
+    // 3 slabs of 16/5 points are rounded down to 2, and 7 slabs of 37/5 or 22/3 points to 6
+    pppm_force_threads_test(pppm_creator, exec_conf, 16, 5);
+    pppm_force_threads_test(pppm_creator, exec_conf, 37, 5);
+    pppm_force_threads_test(pppm_creator, exec_conf, 22, 3);
+    }
+#endif
+
 
 #ifdef ENABLE_HIP
 //! test case for bond forces on the GPU
@@ -0,0 +1,3 @@
+"""Tuners for molecular dynamics simulations."""
+
+from hoomd.md.tune.nlist_buffer import NeighborListBuffer
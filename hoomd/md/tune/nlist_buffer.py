@@ -0,0 +1,115 @@
+# Copyright (c) 2009-2019 The Regents of the University of Michigan
+# This file is part of the HOOMD-blue project, released under the BSD 3-Clause
+# License.
+
+"""Define NeighborListBuffer."""
+
+from hoomd.data.parameterdicts import ParameterDict
+from hoomd.data.typeconverter import OnlyType
+from hoomd.operation import Tuner
+from hoomd.trigger import Trigger
+from hoomd.md import _md
+from hoomd.md.nlist import NList
+
+
+class NeighborListBuffer(Tuner):
+    r"""Tune the neighbor list buffer for the fastest simulation.
+
+    Args:
+        trigger (hoomd.trigger.Trigger): Select the timesteps on which to
+            measure the performance and adjust the buffer.
+        nlist (hoomd.md.nlist.NList): Neighbor list to tune.
+        min_buffer (float): Smallest buffer to consider (in distance units).
+        max_buffer (float): Largest buffer to consider (in distance units).
+        tolerance (float): Stop the search when the optimal buffer is known
+            within this distance (in distance units).
+
+    A larger neighbor list `buffer <hoomd.md.nlist.NList.buffer>` reduces how
+    often the neighbor list needs to be rebuilt, but makes each build and each
+    pair force evaluation more expensive. `NeighborListBuffer` measures the
+    wall clock time per step between consecutive triggered time steps and
+    searches for the buffer in the range [*min_buffer*, *max_buffer*] that
+    minimizes it with a golden section search. After the search has narrowed
+    the range to *tolerance*, the buffer is set to the middle of the remaining
+    range and `tuned` becomes `True`.
+
+    While tuned, `NeighborListBuffer` continues to monitor the time per step
+    and restarts the search when it becomes more than 10% slower than the best
+    time observed, for example when the density changes.
+
+    `NeighborListBuffer` sets the neighbor list `rebuild_check_delay
+    <hoomd.md.nlist.NList.rebuild_check_delay>` to 1 so that no dangerous
+    builds occur.
+
+    Choose a trigger period long enough that each measurement includes several
+    neighbor list builds, such as a few hundred time steps. In MPI simulations,
+    the slowest rank determines the time per step.
+
+    Attributes:
+        trigger (hoomd.trigger.Trigger): Select the timesteps on which to
+            measure the performance and adjust the buffer.
+        nlist (hoomd.md.nlist.NList): Neighbor list to tune.
+        min_buffer (float): Smallest buffer to consider (in distance units).
+        max_buffer (float): Largest buffer to consider (in distance units).
+        tolerance (float): Stop the search when the optimal buffer is known
+            within this distance (in distance units).
+    """
+
+    def __init__(self,
+                 trigger,
+                 nlist,
+                 min_buffer=0.1,
+                 max_buffer=1.0,
+                 tolerance=0.02):
+        defaults = dict(min_buffer=min_buffer,
+                        max_buffer=max_buffer,
+                        tolerance=tolerance,
+                        trigger=trigger)
+        self._param_dict = ParameterDict(min_buffer=float,
+                                         max_buffer=float,
+                                         tolerance=float,
+                                         trigger=Trigger)
+        self._param_dict.update(defaults)
+        self._nlist = OnlyType(NList)(nlist)
+
+    def _attach(self):
+        if not self._nlist._added:
+            self._nlist._add(self._simulation)
+        else:
+            if self._simulation != self._nlist._simulation:
+                raise RuntimeError("{} object's neighbor list is used in a "
+                                   "different simulation.".format(type(self)))
+        if not self._nlist._attached:
+            self._nlist._attach()
+
+        self._cpp_obj = _md.NeighborListBufferTuner(
+            self._simulation.state._cpp_sys_def, self.trigger,
+            self._nlist._cpp_obj, self.min_buffer, self.max_buffer,
+            self.tolerance)
+
+        super()._attach()
+
+    @property
+    def nlist(self):
+        return self._nlist
+
+    @nlist.setter
+    def nlist(self, value):
+        if self._attached:
+            raise RuntimeError("nlist cannot be set after scheduling.")
+        else:
+            self._nlist = OnlyType(NList)(value)
+
+    @property
+    def _children(self):
+        return [self._nlist]
+
+    @property
+    def tuned(self):
+        """bool: Whether the buffer search has finished.
+
+        `tuned` is `False` before the tuner is attached.
+        """
+        if not self._attached:
+            return False
+        return self._cpp_obj.tuned
@@ -374,16 +374,21 @@ void EAMForceCompute::computeForces(unsigned int timestep)
     // sum up the number of forces calculated
     int64_t n_calc = 0;
 
-    // parameters for each particle
-    vector<Scalar> atomElectronDensity;
-    atomElectronDensity.resize(m_pdata->getN());
-    vector<Scalar> atomDerivativeEmbeddingFunction;
-    atomDerivativeEmbeddingFunction.resize(m_pdata->getN());
-    vector<Scalar> atomEmbeddingFunction;
-    atomEmbeddingFunction.resize(m_pdata->getN());
+    // number of local particles, neighbors with larger indices are ghosts
+    const unsigned int N = m_pdata->getN();
+
+    // electron density of each local particle
+    vector<Scalar> atomElectronDensity(N, Scalar(0.0));
     unsigned int ntypes = m_pdata->getNTypes();
 
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
+    // the derivative of the embedding function is also needed for the ghost particles
+    if (m_dFdP.getNumElements() < N + m_pdata->getNGhosts())
+        {
+        GlobalArray<Scalar> dFdP(N + m_pdata->getNGhosts(), m_exec_conf);
+        m_dFdP.swap(dFdP);
+        }
+
+    for (unsigned int i = 0; i < N; i++)
         {
         // access the particle's position and type
         Scalar3 pi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
@@ -404,7 +409,7 @@ void EAMForceCompute::computeForces(unsigned int timestep)
             // access the index of this neighbor
             unsigned int k = h_nlist.data[head_i + j];
             // sanity check
-            assert(k < m_pdata->getN());
+            assert(k < m_pdata->getN() + m_pdata->getNGhosts());
 
             // calculate dr
             Scalar3 pk = make_scalar3(h_pos.data[k].x, h_pos.data[k].y, h_pos.data[k].z);
@@ -436,7 +441,8 @@ void EAMForceCompute::computeForces(unsigned int timestep)
                 atomElectronDensity[i] += v.w + v.z * remainder + v.y * remainder * remainder
                         + v.x * remainder * remainder * remainder;
                 // if third_law, pair it
-                if (third_law)
+                // the density of ghost particles is computed by the rank that owns them
+                if (third_law && k < N)
                     {
                     idxs = int_position + nr * (typei * ntypes + typej);
                     v = h_rho.data[idxs];
@@ -447,27 +453,38 @@ void EAMForceCompute::computeForces(unsigned int timestep)
             }
         }
 
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
         {
-        unsigned int typei = __scalar_as_int(h_pos.data[i].w);
-        // calculate position rho for F(rho)
-        position = atomElectronDensity[i] * rdrho;
-        int_position = (unsigned int) position;
-        int_position = min(int_position, nrho - 1);
-        remainder = position - int_position;
-
-        idxs = int_position + typei * nrho;
-        v = h_F.data[idxs];
-        dv = h_dF.data[idxs];
-        // compute dF / dP
-        atomDerivativeEmbeddingFunction[i] = dv.z + dv.y * remainder + dv.x * remainder * remainder;
-        // compute embedded energy F(P), sum up each particle
-        h_force.data[i].w += v.w + v.z * remainder + v.y * remainder * remainder
-                + v.x * remainder * remainder * remainder;
+        ArrayHandle<Scalar> h_dFdP(m_dFdP, access_location::host, access_mode::overwrite);
+
+        for (unsigned int i = 0; i < N; i++)
+            {
+            unsigned int typei = __scalar_as_int(h_pos.data[i].w);
+            // calculate position rho for F(rho)
+            position = atomElectronDensity[i] * rdrho;
+            int_position = (unsigned int) position;
+            int_position = min(int_position, nrho - 1);
+            remainder = position - int_position;
 
+            idxs = int_position + typei * nrho;
+            v = h_F.data[idxs];
+            dv = h_dF.data[idxs];
+            // compute dF / dP
+            h_dFdP.data[i] = dv.z + dv.y * remainder + dv.x * remainder * remainder;
+            // compute embedded energy F(P), sum up each particle
+            h_force.data[i].w += v.w + v.z * remainder + v.y * remainder * remainder
+                    + v.x * remainder * remainder * remainder;
+            }
         }
 
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
+#ifdef ENABLE_MPI
+    // the force on a particle depends on dF / dP of its neighbors, fetch it for the ghost particles
+    if (m_comm)
+        m_comm->updateGhostField(m_dFdP);
+#endif
+
+    ArrayHandle<Scalar> h_dFdP(m_dFdP, access_location::host, access_mode::read);
+
+    for (unsigned int i = 0; i < N; i++)
         {
         // access the particle's position and type
         Scalar3 pi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
@@ -495,7 +512,7 @@ void EAMForceCompute::computeForces(unsigned int timestep)
             // access the index of this neighbor
             unsigned int k = h_nlist.data[head_i + j];
             // sanity check
-            assert(k < m_pdata->getN());
+            assert(k < m_pdata->getN() + m_pdata->getNGhosts());
 
             // calculate \Delta r
             Scalar3 pk = make_scalar3(h_pos.data[k].x, h_pos.data[k].y, h_pos.data[k].z);
@@ -545,27 +562,37 @@ void EAMForceCompute::computeForces(unsigned int timestep)
             dv = h_drho.data[idxs];
             Scalar derivativeRhoJ = dv.z + dv.y * remainder + dv.x * remainder * remainder;
             // fullDerivativePhi = dF/dP * drho / dr for j + dF/dP * drho / dr for j + phi
-            Scalar fullDerivativePhi = atomDerivativeEmbeddingFunction[i] * derivativeRhoJ
-                    + atomDerivativeEmbeddingFunction[k] * derivativeRhoI + derivativePhi;
+            Scalar fullDerivativePhi = h_dFdP.data[i] * derivativeRhoJ
+                    + h_dFdP.data[k] * derivativeRhoI + derivativePhi;
             // compute forces
             Scalar pairForce = -fullDerivativePhi * inverseR;
-            viriali[0] += dx.x * dx.x * pairForce;
-            viriali[1] += dx.x * dx.y * pairForce;
-            viriali[2] += dx.x * dx.z * pairForce;
-            viriali[3] += dx.y * dx.y * pairForce;
-            viriali[4] += dx.y * dx.z * pairForce;
-            viriali[5] += dx.z * dx.z * pairForce;
+            // split the pair virial between i and k, like the energy
+            Scalar pairForceover2 = Scalar(0.5) * pairForce;
+            viriali[0] += dx.x * dx.x * pairForceover2;
+            viriali[1] += dx.x * dx.y * pairForceover2;
+            viriali[2] += dx.x * dx.z * pairForceover2;
+            viriali[3] += dx.y * dx.y * pairForceover2;
+            viriali[4] += dx.y * dx.z * pairForceover2;
+            viriali[5] += dx.z * dx.z * pairForceover2;
             fxi += dx.x * pairForce;
             fyi += dx.y * pairForce;
             fzi += dx.z * pairForce;
             pei += pair_eng * 0.5;
 
-            if (third_law)
+            // only add the force to local particles, pairs with ghosts are also in the neighbor list of the rank
+            // that owns the ghost
+            if (third_law && k < N)
                 {
                 h_force.data[k].x -= dx.x * pairForce;
                 h_force.data[k].y -= dx.y * pairForce;
                 h_force.data[k].z -= dx.z * pairForce;
                 h_force.data[k].w += pair_eng * 0.5;
+                h_virial.data[0 * virial_pitch + k] += dx.x * dx.x * pairForceover2;
+                h_virial.data[1 * virial_pitch + k] += dx.x * dx.y * pairForceover2;
+                h_virial.data[2 * virial_pitch + k] += dx.x * dx.z * pairForceover2;
+                h_virial.data[3 * virial_pitch + k] += dx.y * dx.y * pairForceover2;
+                h_virial.data[4 * virial_pitch + k] += dx.y * dx.z * pairForceover2;
+                h_virial.data[5 * virial_pitch + k] += dx.z * dx.z * pairForceover2;
                 }
             }
         h_force.data[i].x += fxi;
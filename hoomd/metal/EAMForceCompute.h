@@ -42,6 +42,12 @@
  h_dF.data[100].z, h_dF.data[100].y, h_dF.data[100].x, are for interpolating derivative embedded
  function.
 
+ \b Domain decomposition
+ The force on a particle depends on the derivative of the embedding function (m_dFdP) of its neighbors. It is
+ computed for the local particles after the electron density pass and then copied to the ghost particles with
+ Communicator::updateGhostField() before the force pass. With a half neighbor list, pairs between a local and a
+ ghost particle are listed on both ranks, so contributions to ghost particles are skipped.
+
  \ingroup computes
  */
 class EAMForceCompute: public ForceCompute
@@ -91,7 +97,7 @@ protected:
     GPUArray<Scalar4> m_dF;                //!< derivative embedded function and its coefficients
     GPUArray<Scalar4> m_drho;              //!< derivative electron density and its coefficients
     GPUArray<Scalar4> m_drphi;             //!< derivative pair wise function and its coefficients
-    GPUArray<Scalar> m_dFdP;               //!< derivative F / derivative P
+    GlobalArray<Scalar> m_dFdP;            //!< derivative F / derivative P of local and ghost particles
 
     //! Actually compute the forces
     virtual void computeForces(unsigned int timestep);
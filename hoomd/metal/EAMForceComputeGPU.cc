@@ -75,6 +75,15 @@ void EAMForceComputeGPU::computeForces(unsigned int timestep)
         throw runtime_error("Error computing forces in EAMForceComputeGPU");
         }
 
+#ifdef ENABLE_MPI
+    // The GPU kernels compute dF/dP and the forces in one launch, without exchanging dF/dP for ghosts
+    if (m_comm)
+        {
+        m_exec_conf->msg->error() << "EAMForceComputeGPU does not support domain decomposition" << endl;
+        throw runtime_error("Error computing forces in EAMForceComputeGPU");
+        }
+#endif
+
     // access the neighbor list, which just selects the neighborlist into the device's memory, copying
     // it there if needed
     ArrayHandle<unsigned int> d_n_neigh(this->m_nlist->getNNeighArray(), access_location::device, access_mode::read);
@@ -98,7 +107,7 @@ void EAMForceComputeGPU::computeForces(unsigned int timestep)
     ArrayHandle<EAMTexInterData> d_eam_data(m_eam_data, access_location::device, access_mode::read);
 
     // Derivative Embedding Function for each atom
-    GPUArray<Scalar> t_dFdP(m_pdata->getN(), m_exec_conf);
+    GlobalArray<Scalar> t_dFdP(m_pdata->getN(), m_exec_conf);
     m_dFdP.swap(t_dFdP);
     ArrayHandle<Scalar> d_dFdP(m_dFdP, access_location::device, access_mode::overwrite);
 
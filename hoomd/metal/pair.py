@@ -48,10 +48,10 @@ class eam(force._force):
 
     """
     def __init__(self, file, type, nlist):
-        # Error out in MPI simulations
-        if (hoomd.version.mpi_enabled):
+        # Error out in MPI simulations on the GPU
+        if (hoomd.version.mpi_enabled and hoomd.context.current.device.cpp_exec_conf.isCUDAEnabled()):
             if hoomd.context.current.system_definition.getParticleData().getDomainDecomposition():
-                hoomd.context.current.device.cpp_msg.error("pair.eam is not supported in multi-processor simulations.\n\n")
+                hoomd.context.current.device.cpp_msg.error("pair.eam is not supported in multi-processor simulations on the GPU.\n\n")
                 raise RuntimeError("Error setting up pair potential.")
 
         # initialize the base class
@@ -0,0 +1,277 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+#ifdef ENABLE_MPI
+
+// this has to be included after naming the test module
+#include "hoomd/test/upp11_config.h"
+HOOMD_UP_MAIN()
+
+#include <memory>
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+#include "hoomd/ExecutionConfiguration.h"
+#include "hoomd/Communicator.h"
+#include "hoomd/Index1D.h"
+#include "hoomd/SystemDefinition.h"
+
+#include "hoomd/md/NeighborListTree.h"
+#include "hoomd/metal/EAMForceCompute.h"
+
+/*! \file test_eam_communication.cc
+    \brief Compares the EAM forces computed with domain decomposition to those of a single rank
+    \ingroup unit_tests
+*/
+
+using namespace std;
+
+//! Cut off radius of the test potential
+const Scalar eam_r_cut = Scalar(2.0);
+
+//! Write a two type EAM/Alloy (setfl) file with smooth tabulated functions
+/*! The electron density of each type is a multiple of (r_cut - r)^2, the embedding function is a parabola in rho
+    and r*phi(r) is a multiple of (r_cut - r)^3, so that all functions and their derivatives vanish at r_cut.
+*/
+void write_eam_alloy(const std::string& filename)
+    {
+    const unsigned int nrho = 2000;
+    const double drho = 0.01;
+    const unsigned int nr = 2001;
+    const double dr = eam_r_cut / (nr - 1);
+
+    FILE *fp = fopen(filename.c_str(), "w");
+    UP_ASSERT(fp != NULL);
+
+    fprintf(fp, "test potential for test_eam_communication\n");
+    fprintf(fp, "smooth polynomials\n");
+    fprintf(fp, "not a physical material\n");
+    fprintf(fp, "2 A B\n");
+    fprintf(fp, "%u %.16g %u %.16g %.16g\n", nrho, drho, nr, dr, double(eam_r_cut));
+
+    const double F_a[] = {0.05, 0.04};
+    const double F_rho0[] = {6.0, 5.0};
+    const double rho_a[] = {1.0, 1.5};
+    for (unsigned int type = 0; type < 2; type++)
+        {
+        fprintf(fp, "%u %.16g %.16g fcc\n", type + 1, 1.0, 1.2);
+        for (unsigned int i = 0; i < nrho; i++)
+            {
+            double rho = i*drho;
+            fprintf(fp, "%.16g\n", F_a[type]*(rho - F_rho0[type])*(rho - F_rho0[type]) - 1.0);
+            }
+        for (unsigned int i = 0; i < nr; i++)
+            {
+            double x = eam_r_cut - i*dr;
+            fprintf(fp, "%.16g\n", rho_a[type]*x*x);
+            }
+        }
+
+    // r*phi(r) for the pairs AA, AB and BB
+    const double rphi_a[] = {1.0, 0.8, 1.2};
+    for (unsigned int pair = 0; pair < 3; pair++)
+        {
+        for (unsigned int i = 0; i < nr; i++)
+            {
+            double x = eam_r_cut - i*dr;
+            fprintf(fp, "%.16g\n", rphi_a[pair]*x*x*x);
+            }
+        }
+
+    fclose(fp);
+    }
+
+//! Request the ghost fields needed by the EAM force
+CommFlags eam_comm_flag_request(unsigned int timestep)
+    {
+    CommFlags flags(0);
+    flags[comm_flag::position] = 1;
+    flags[comm_flag::tag] = 1;
+    return flags;
+    }
+
+//! Forces, energies and virials of all particles, indexed by tag
+struct eam_forces
+    {
+    std::vector<Scalar4> force;     //!< Forces and energies
+    std::vector<Scalar> virial;     //!< Virials, six entries per particle
+    std::vector<bool> local;        //!< True if the particle is local on this rank
+    };
+
+//! Compute the EAM forces on a system initialized from \a snap
+/*! \param exec_conf Execution configuration
+    \param box Simulation box
+    \param snap Initial configuration
+    \param filename EAM potential file
+    \param mode Neighbor list storage mode
+    \param decompose True to distribute the particles over all ranks of \a exec_conf
+*/
+eam_forces compute_eam_forces(std::shared_ptr<ExecutionConfiguration> exec_conf,
+                              const BoxDim& box,
+                              const SnapshotParticleData<Scalar>& snap,
+                              std::string filename,
+                              NeighborList::storageMode mode,
+                              bool decompose)
+    {
+    const unsigned int n = snap.size;
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(n, box, 2, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    std::shared_ptr<DomainDecomposition> decomposition;
+    if (decompose)
+        {
+        decomposition = std::shared_ptr<DomainDecomposition>(new DomainDecomposition(exec_conf, box.getL()));
+        pdata->setDomainDecomposition(decomposition);
+        }
+    pdata->initializeFromSnapshot(snap);
+    pdata->setFlags(~PDataFlags(0));
+
+    std::shared_ptr<EAMForceCompute> eam(new EAMForceCompute(sysdef, &filename[0], 0));
+    UP_ASSERT_EQUAL(eam->get_r_cut(), eam_r_cut);
+
+    std::shared_ptr<NeighborListTree> nlist(new NeighborListTree(sysdef, eam->get_r_cut(), Scalar(0.4)));
+    nlist->setStorageMode(mode);
+
+    Index2DUpperTriangular typpair_idx(pdata->getNTypes());
+    std::shared_ptr<GlobalArray<Scalar>> r_cut(new GlobalArray<Scalar>(typpair_idx.getNumElements(), exec_conf));
+        {
+        ArrayHandle<Scalar> h_r_cut(*r_cut, access_location::host, access_mode::overwrite);
+        for (unsigned int i = 0; i < typpair_idx.getNumElements(); i++)
+            h_r_cut.data[i] = eam->get_r_cut();
+        }
+    nlist->addRCutMatrix(r_cut);
+    eam->set_neighbor_list(nlist);
+
+    std::shared_ptr<Communicator> comm;
+    if (decompose)
+        {
+        comm = std::shared_ptr<Communicator>(new Communicator(sysdef, decomposition));
+        comm->getCommFlagsRequestSignal().connect<eam_comm_flag_request>();
+        nlist->setCommunicator(comm);
+        eam->setCommunicator(comm);
+
+        // migrate the particles and exchange the ghosts
+        comm->communicate(0);
+        UP_ASSERT(pdata->getNGhosts() > 0);
+        }
+
+    eam->compute(0);
+
+    eam_forces result;
+    result.force.resize(n, make_scalar4(0,0,0,0));
+    result.virial.resize(6*n, Scalar(0.0));
+    result.local.resize(n, false);
+
+    ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_force(eam->getForceArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_virial(eam->getVirialArray(), access_location::host, access_mode::read);
+    unsigned int pitch = eam->getVirialArray().getPitch();
+    for (unsigned int i = 0; i < pdata->getN(); i++)
+        {
+        unsigned int tag = h_tag.data[i];
+        result.force[tag] = h_force.data[i];
+        for (unsigned int k = 0; k < 6; k++)
+            result.virial[6*tag+k] = h_virial.data[k*pitch+i];
+        result.local[tag] = true;
+        }
+    return result;
+    }
+
+//! Compare the EAM forces on multiple ranks to those on a single rank
+/*! Particles near the domain boundaries need the derivative of the embedding function of their ghost neighbors
+    (Communicator::updateGhostField()). With a half neighbor list, the pairs with ghosts are listed on both ranks and
+    the ghost third law terms must be skipped. The per particle virials only agree between half and full neighbor
+    lists if every pair virial is split evenly between both particles.
+*/
+void test_eam_communication(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    // a jittered simple cubic lattice with alternating types
+    const unsigned int n_side = 10;
+    const unsigned int n = n_side*n_side*n_side;
+    const Scalar a = Scalar(1.2);
+    BoxDim box(a*n_side);
+
+    SnapshotParticleData<Scalar> snap(n);
+    snap.type_mapping.push_back("A");
+    snap.type_mapping.push_back("B");
+
+    Scalar3 lo = box.getLo();
+    srand(12345);
+    for (unsigned int i = 0; i < n; ++i)
+        {
+        unsigned int ix = i % n_side;
+        unsigned int iy = (i / n_side) % n_side;
+        unsigned int iz = i / (n_side*n_side);
+        Scalar3 jitter = make_scalar3((Scalar)rand()/(Scalar)RAND_MAX - Scalar(0.5),
+                                      (Scalar)rand()/(Scalar)RAND_MAX - Scalar(0.5),
+                                      (Scalar)rand()/(Scalar)RAND_MAX - Scalar(0.5))*Scalar(0.3);
+        snap.pos[i] = vec3<Scalar>(lo.x + (ix + Scalar(0.5))*a + jitter.x,
+                                   lo.y + (iy + Scalar(0.5))*a + jitter.y,
+                                   lo.z + (iz + Scalar(0.5))*a + jitter.z);
+        snap.type[i] = (ix + iy + iz) % 2;
+        }
+
+    // every rank reads its own copy of the potential file
+    std::ostringstream os;
+    os << "test_eam_communication." << exec_conf->getRank() << ".eam.alloy";
+    std::string filename = os.str();
+    write_eam_alloy(filename);
+
+    // reference: the whole system on a single rank with a full neighbor list
+    std::shared_ptr<MPIConfiguration> mpi_conf_self(new MPIConfiguration(MPI_COMM_SELF));
+    std::shared_ptr<ExecutionConfiguration> exec_conf_self(new ExecutionConfiguration(ExecutionConfiguration::CPU,
+        std::vector<int>(), mpi_conf_self, exec_conf->msg));
+    eam_forces ref = compute_eam_forces(exec_conf_self, box, snap, filename, NeighborList::full, false);
+
+    // the forces must not vanish, or the test would be trivial
+    Scalar max_force = Scalar(0.0);
+    for (unsigned int tag = 0; tag < n; ++tag)
+        max_force = std::max(max_force, fabs(ref.force[tag].x));
+    UP_ASSERT(max_force > Scalar(0.1));
+
+    struct
+        {
+        NeighborList::storageMode mode;
+        bool decompose;
+        } cases[] = { {NeighborList::half, false}, {NeighborList::half, true}, {NeighborList::full, true} };
+
+    for (unsigned int c = 0; c < 3; ++c)
+        {
+        eam_forces result = compute_eam_forces(exec_conf, box, snap, filename, cases[c].mode, cases[c].decompose);
+
+        unsigned int n_local = 0;
+        for (unsigned int tag = 0; tag < n; ++tag)
+            {
+            if (!result.local[tag])
+                continue;
+            n_local++;
+
+            MY_CHECK_SMALL(result.force[tag].x - ref.force[tag].x, tol_small);
+            MY_CHECK_SMALL(result.force[tag].y - ref.force[tag].y, tol_small);
+            MY_CHECK_SMALL(result.force[tag].z - ref.force[tag].z, tol_small);
+            MY_CHECK_SMALL(result.force[tag].w - ref.force[tag].w, tol_small);
+            for (unsigned int k = 0; k < 6; ++k)
+                MY_CHECK_SMALL(result.virial[6*tag+k] - ref.virial[6*tag+k], tol_small);
+            }
+
+        // every particle is local on exactly one rank
+        if (cases[c].decompose)
+            MPI_Allreduce(MPI_IN_PLACE, &n_local, 1, MPI_UNSIGNED, MPI_SUM, exec_conf->getMPICommunicator());
+        UP_ASSERT_EQUAL(n_local, n);
+        }
+
+    std::remove(filename.c_str());
+    }
+
+//! Tests the EAM force with domain decomposition
+UP_TEST( eam_communication_test )
+    {
+    if (!exec_conf_cpu)
+        exec_conf_cpu = std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+
+    test_eam_communication(exec_conf_cpu);
+    }
+
+#endif //ENABLE_MPI
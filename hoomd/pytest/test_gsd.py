@@ -0,0 +1,105 @@
+"""Test the GSD writer."""
+
+import hoomd
+import numpy as np
+
+
+def test_attributes():
+    """Test GSD attributes before attaching."""
+    gsd_writer = hoomd.write.GSD(filename='test.gsd',
+                                 trigger=hoomd.trigger.Periodic(10))
+    assert not gsd_writer.asynchronous
+
+    gsd_writer.asynchronous = True
+    assert gsd_writer.asynchronous
+
+    assert gsd_writer.position_precision is None
+    gsd_writer.position_precision = 1e-4
+    assert gsd_writer.position_precision == 1e-4
+    gsd_writer.position_precision = None
+    assert gsd_writer.position_precision is None
+
+
+def test_asynchronous(simulation_factory, two_particle_snapshot_factory,
+                      device, tmp_path):
+    """Test that asynchronous writes produce the same frames."""
+    snap = two_particle_snapshot_factory()
+    if snap.exists:
+        snap.particles.velocity[:] = [[1, 0, 0], [0, -1, 0]]
+    sim = simulation_factory(snap)
+    nve = hoomd.md.methods.NVE(filter=hoomd.filter.All())
+    sim.operations.integrator = hoomd.md.Integrator(0.005, methods=[nve])
+
+    filename_sync = str(tmp_path / 'sync.gsd')
+    filename_async = str(tmp_path / 'async.gsd')
+    trigger = hoomd.trigger.Periodic(2)
+    gsd_sync = hoomd.write.GSD(filename=filename_sync,
+                               trigger=trigger,
+                               mode='wb')
+    gsd_async = hoomd.write.GSD(filename=filename_async,
+                                trigger=trigger,
+                                mode='wb',
+                                asynchronous=True)
+    sim.operations.writers.append(gsd_sync)
+    sim.operations.writers.append(gsd_async)
+    sim.run(10)
+    assert gsd_async.asynchronous
+    gsd_async.flush()
+
+    for frame in range(5):
+        sim_sync = hoomd.Simulation(device)
+        sim_sync.create_state_from_gsd(filename_sync, frame)
+        sim_async = hoomd.Simulation(device)
+        sim_async.create_state_from_gsd(filename_async, frame)
+
+        assert sim_sync.timestep == sim_async.timestep
+        snap_sync = sim_sync.state.snapshot
+        snap_async = sim_async.state.snapshot
+        if snap_sync.exists:
+            np.testing.assert_array_equal(snap_sync.particles.position,
+                                          snap_async.particles.position)
+
+
+def test_position_precision(simulation_factory, lattice_snapshot_factory,
+                            device, tmp_path):
+    """Test that compressed positions are within the requested precision."""
+    snap = lattice_snapshot_factory(n=5, a=1.5)
+    if snap.exists:
+        rng = np.random.default_rng(5)
+        snap.particles.velocity[:] = rng.normal(size=(snap.particles.N, 3))
+    sim = simulation_factory(snap)
+    nve = hoomd.md.methods.NVE(filter=hoomd.filter.All())
+    sim.operations.integrator = hoomd.md.Integrator(0.005, methods=[nve])
+
+    filename_full = str(tmp_path / 'full.gsd')
+    filename_compressed = str(tmp_path / 'compressed.gsd')
+    precision = 1e-4
+    trigger = hoomd.trigger.Periodic(5)
+    gsd_full = hoomd.write.GSD(filename=filename_full,
+                               trigger=trigger,
+                               mode='wb')
+    gsd_compressed = hoomd.write.GSD(filename=filename_compressed,
+                                     trigger=trigger,
+                                     mode='wb',
+                                     position_precision=precision)
+    sim.operations.writers.append(gsd_full)
+    sim.operations.writers.append(gsd_compressed)
+    sim.run(200)
+    assert gsd_compressed.position_precision == precision
+
+    # read key frames and delta frames on both sides of the second key frame
+    for frame in [0, 1, 31, 32, 33, 39]:
+        sim_full = hoomd.Simulation(device)
+        sim_full.create_state_from_gsd(filename_full, frame)
+        sim_compressed = hoomd.Simulation(device)
+        sim_compressed.create_state_from_gsd(filename_compressed, frame)
+
+        snap_full = sim_full.state.snapshot
+        snap_compressed = sim_compressed.state.snapshot
+        if snap_full.exists:
+            box = sim_full.state.box
+            L = np.array([box.Lx, box.Ly, box.Lz])
+            delta = snap_compressed.particles.position \
+                - snap_full.particles.position
+            delta -= np.round(delta / L) * L
+            np.testing.assert_array_less(np.abs(delta), precision * L)
@@ -198,6 +198,33 @@ def test_state_from_gsd(simulation_factory, get_snapshot,
         assert_equivalent_snapshots(snap, sim.state.snapshot)
 
 
+@skip_gsd
+def test_state_from_gsd_topology(simulation_factory, get_snapshot, device,
+                                 tmp_path):
+    """Bonds and angles are read together with the particles."""
+    snap = get_snapshot(n=20)
+    if snap.exists:
+        snap.bonds.types = ['b']
+        snap.bonds.N = 19
+        snap.bonds.group[:] = [[i, i + 1] for i in range(19)]
+        snap.angles.types = ['a']
+        snap.angles.N = 18
+        snap.angles.group[:] = [[i, i + 1, i + 2] for i in range(18)]
+
+    d = tmp_path / "sub"
+    d.mkdir()
+    filename = d / "temporary_test_file.gsd"
+    with gsd.hoomd.open(name=filename, mode='wb+') as file:
+        sim = simulation_factory(snap)
+        snap = sim.state.snapshot
+        file.append(make_gsd_snapshot(snap))
+
+    sim = hoomd.Simulation(device)
+    sim.create_state_from_gsd(filename)
+    assert sim.state.N_particles == 20
+    assert_equivalent_snapshots(snap, sim.state.snapshot)
+
+
 def test_writer_order(simulation_factory, two_particle_snapshot_factory):
     """Ensure that writers run at the end of the loop step."""
 
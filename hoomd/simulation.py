@@ -105,14 +105,14 @@ class Simulation(metaclass=Loggable):
             raise RuntimeError("Cannot initialize more than once\n")
         filename = _hoomd.mpi_bcast_str(filename,
                                         self.device._cpp_exec_conf)
-        # Grab snapshot and timestep
+        # Grab snapshot and timestep, every MPI rank reads a slice of the frame
         reader = _hoomd.GSDReader(self.device._cpp_exec_conf,
-                                  filename, abs(frame), frame < 0)
+                                  filename, abs(frame), frame < 0, True)
         snapshot = Snapshot._from_cpp_snapshot(reader.getSnapshot(),
                                                self.device.communicator)
 
         step = reader.getTimeStep() if self.timestep is None else self.timestep
-        self._state = State(self, snapshot)
+        self._state = State(self, snapshot, reader.isDistributed())
 
         reader.clearSnapshot()
         # Store System and Reader for Operations
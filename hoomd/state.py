@@ -59,14 +59,22 @@ class State:
         `State` object.
     """
 
-    def __init__(self, simulation, snapshot):
+    def __init__(self, simulation, snapshot, distributed=False):
         self._simulation = simulation
         snapshot._broadcast_box()
         domain_decomp = _create_domain_decomposition(
             simulation.device,
             snapshot._cpp_obj._global_box)
 
-        if domain_decomp is not None:
+        if domain_decomp is not None and distributed:
+            # every rank holds a slice of the system, which is sent to the
+            # owning ranks without gathering it on the root rank
+            self._cpp_sys_def = _hoomd.SystemDefinition(
+                0, snapshot._cpp_obj._global_box, 1, 0, 0, 0, 0,
+                simulation.device._cpp_exec_conf, domain_decomp)
+            self._cpp_sys_def.initializeFromDistributedSnapshot(
+                snapshot._cpp_obj)
+        elif domain_decomp is not None:
             self._cpp_sys_def = _hoomd.SystemDefinition(
                 snapshot._cpp_obj, simulation.device._cpp_exec_conf,
                 domain_decomp)
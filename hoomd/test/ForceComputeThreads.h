@@ -0,0 +1,59 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file ForceComputeThreads.h
+    \brief Helps unit tests compare the multithreaded and serial computation of a force
+    \details Include after upp11_config.h in TBB enabled builds
+*/
+
+#ifndef __FORCE_COMPUTE_THREADS_H__
+#define __FORCE_COMPUTE_THREADS_H__
+
+#include "hoomd/ExecutionConfiguration.h"
+#include "hoomd/SystemDefinition.h"
+
+#include <memory>
+
+#ifdef ENABLE_TBB
+//! Force compute that computes the forces with a given number of threads
+/*! \tparam Base Force compute class, constructed from a SystemDefinition
+
+    The execution configuration of the system is shared with the serial computation, so the thread count is only set
+    for the duration of computeForces().
+*/
+template<class Base>
+class ForceComputeThreads : public Base
+    {
+    public:
+        ForceComputeThreads(std::shared_ptr<SystemDefinition> sysdef,
+                            std::shared_ptr<ExecutionConfiguration> exec_conf,
+                            unsigned int num_threads)
+            : Base(sysdef), m_threads_exec_conf(exec_conf), m_num_threads(num_threads)
+            {
+            }
+
+    protected:
+        std::shared_ptr<ExecutionConfiguration> m_threads_exec_conf; //!< Execution configuration of sysdef
+        unsigned int m_num_threads;                                  //!< Number of threads to compute with
+
+        virtual void computeForces(unsigned int timestep)
+            {
+            unsigned int num_threads = m_threads_exec_conf->getNumThreads();
+            m_threads_exec_conf->setNumThreads(m_num_threads);
+            Base::computeForces(timestep);
+            m_threads_exec_conf->setNumThreads(num_threads);
+            }
+    };
+
+//! Creator for the multithreaded computation of a force
+template<class Base>
+std::shared_ptr<Base> threads_creator(std::shared_ptr<SystemDefinition> sysdef,
+                                      std::shared_ptr<ExecutionConfiguration> exec_conf,
+                                      unsigned int num_threads)
+    {
+    return std::shared_ptr<Base>(new ForceComputeThreads<Base>(sysdef, exec_conf, num_threads));
+    }
+#endif
+
+#endif // __FORCE_COMPUTE_THREADS_H__
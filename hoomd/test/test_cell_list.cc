@@ -575,6 +575,88 @@ UP_TEST( CellList_large )
     celllist_large_test<CellList>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
 
+//! Validate that the compact layout holds the same cells as the padded layout
+void celllist_compact_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    unsigned int N = 10000;
+    RandomInitializer rand_init(N, Scalar(0.2), Scalar(0.9), "A");
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap;
+    snap = rand_init.getSnapshot();
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    // ********* initialize a padded and a compact cell list *********
+    std::shared_ptr<CellList> cl(new CellList(sysdef));
+    cl->setNominalWidth(Scalar(3.0));
+    cl->setRadius(1);
+    cl->setComputeTDB(true);
+    cl->setComputeIdx(true);
+    cl->setFlagIndex();
+    cl->compute(0);
+
+    std::shared_ptr<CellList> cl_compact(new CellList(sysdef));
+    cl_compact->setNominalWidth(Scalar(3.0));
+    cl_compact->setRadius(1);
+    cl_compact->setComputeTDB(true);
+    cl_compact->setComputeIdx(true);
+    cl_compact->setFlagIndex();
+    cl_compact->setCompact(true);
+    UP_ASSERT(cl_compact->getCompact());
+    cl_compact->compute(0);
+
+    // the compact layout holds exactly one entry per particle
+    CHECK_EQUAL_UINT(cl_compact->getXYZFArray().getNumElements(), N);
+    CHECK_EQUAL_UINT(cl_compact->getNmax(), cl->getNmax());
+
+    unsigned int ncell = cl->getCellIndexer().getNumElements();
+    CHECK_EQUAL_UINT(cl_compact->getCellIndexer().getNumElements(), ncell);
+
+    ArrayHandle<unsigned int> h_cell_size(cl->getCellSizeArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_xyzf(cl->getXYZFArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_tdb(cl->getTDBArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_idx(cl->getIndexArray(), access_location::host, access_mode::read);
+    Index2D cli = cl->getCellListIndexer();
+
+    ArrayHandle<unsigned int> h_cell_size_compact(cl_compact->getCellSizeArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_cell_start(cl_compact->getCellStartArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_xyzf_compact(cl_compact->getXYZFArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_tdb_compact(cl_compact->getTDBArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_idx_compact(cl_compact->getIndexArray(), access_location::host, access_mode::read);
+    CellListMemberIndexer cli_compact(cl_compact->getCellListIndexer(), h_cell_start.data);
+
+    CHECK_EQUAL_UINT(h_cell_start.data[0], 0);
+    CHECK_EQUAL_UINT(h_cell_start.data[ncell], N);
+
+    // every cell has the same members in the same order
+    for (unsigned int cell = 0; cell < ncell; cell++)
+        {
+        CHECK_EQUAL_UINT(h_cell_size_compact.data[cell], h_cell_size.data[cell]);
+        CHECK_EQUAL_UINT(h_cell_start.data[cell+1], h_cell_start.data[cell] + h_cell_size.data[cell]);
+
+        for (unsigned int offset = 0; offset < h_cell_size.data[cell]; offset++)
+            {
+            const Scalar4 xyzf = h_xyzf.data[cli(offset, cell)];
+            const Scalar4 xyzf_compact = h_xyzf_compact.data[cli_compact(offset, cell)];
+            CHECK_EQUAL_UINT(__scalar_as_int(xyzf_compact.w), __scalar_as_int(xyzf.w));
+            UP_ASSERT_EQUAL(xyzf_compact.x, xyzf.x);
+            UP_ASSERT_EQUAL(xyzf_compact.y, xyzf.y);
+            UP_ASSERT_EQUAL(xyzf_compact.z, xyzf.z);
+
+            const Scalar4 tdb = h_tdb.data[cli(offset, cell)];
+            const Scalar4 tdb_compact = h_tdb_compact.data[cli_compact(offset, cell)];
+            UP_ASSERT_EQUAL(tdb_compact.y, tdb.y);
+
+            CHECK_EQUAL_UINT(h_idx_compact.data[cli_compact(offset, cell)], h_idx.data[cli(offset, cell)]);
+            }
+        }
+    }
+
+//! test case for celllist_compact_test
+UP_TEST( CellList_compact )
+    {
+    celllist_compact_test(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
 #ifdef ENABLE_HIP
 //! test case for celllist_large_test on the GPU
 UP_TEST( CellListGPU_large )
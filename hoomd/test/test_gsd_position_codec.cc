@@ -0,0 +1,110 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include <iostream>
+#include <cmath>
+#include <vector>
+
+#include "upp11_config.h"
+
+HOOMD_UP_MAIN();
+
+
+#include "hoomd/GSDPositionCodec.h"
+#include "hoomd/RandomNumbers.h"
+
+using namespace std;
+using namespace hoomd::detail;
+
+/*! \file test_gsd_position_codec.cc
+    \brief Implements unit tests for GSDPositionCodec
+    \ingroup unit_tests
+*/
+
+//! Encode and decode a trajectory of random walkers, checking the decoded grid and the position error
+UP_TEST( GSDPositionCodec_roundtrip )
+    {
+    const unsigned int N = 1000;
+    BoxDim box(10.0, 8.0, 6.0);
+    box.setTiltFactors(0.5, 0.0, 0.1);
+    const Scalar precision = 1e-4;
+    const unsigned int bits = GSDPositionCodec::getBits(precision);
+    UP_ASSERT_EQUAL(bits, (unsigned int)14);
+
+    hoomd::RandomGenerator rng(0x4f8e27a1, 1);
+    hoomd::UniformDistribution<Scalar> uniform(0, 1);
+    hoomd::NormalDistribution<Scalar> normal(0.01);
+
+    std::vector<Scalar3> frac(N);
+    for (unsigned int i = 0; i < N; i++)
+        frac[i] = make_scalar3(uniform(rng), uniform(rng), uniform(rng));
+
+    std::vector<uint32_t> grid, reference, decoded;
+    std::vector<uint8_t> encoded;
+    std::vector<float> pos(N*3), decoded_pos(N*3);
+    for (unsigned int frame = 0; frame < 5; frame++)
+        {
+        for (unsigned int i = 0; i < N; i++)
+            {
+            // move in fractional coordinates and wrap, so that particles cross the boundaries
+            frac[i].x += normal(rng);
+            frac[i].x -= std::floor(frac[i].x);
+            frac[i].y += normal(rng);
+            frac[i].y -= std::floor(frac[i].y);
+            frac[i].z += normal(rng);
+            frac[i].z -= std::floor(frac[i].z);
+            Scalar3 p = box.makeCoordinates(frac[i]);
+            pos[i*3+0] = float(p.x);
+            pos[i*3+1] = float(p.y);
+            pos[i*3+2] = float(p.z);
+            }
+
+        GSDPositionCodec::quantize(grid, &pos[0], N, box, bits);
+        GSDPositionCodec::encode(encoded, grid, frame == 0 ? NULL : &reference, bits);
+        UP_ASSERT_EQUAL(GSDPositionCodec::isDelta(&encoded[0], encoded.size()), frame != 0);
+
+        // delta frames must be much smaller than the raw positions
+        if (frame > 0)
+            UP_ASSERT(encoded.size() < N*12/3);
+
+        unsigned int decoded_bits = 0;
+        GSDPositionCodec::decode(decoded, &encoded[0], encoded.size(), decoded_bits);
+        UP_ASSERT_EQUAL(decoded_bits, bits);
+        UP_ASSERT(decoded == grid);
+
+        // the error in fractional coordinates is at most half of the grid spacing
+        GSDPositionCodec::dequantize(&decoded_pos[0], decoded, box, decoded_bits);
+        for (unsigned int i = 0; i < N; i++)
+            {
+            Scalar3 f = box.makeFraction(make_scalar3(decoded_pos[i*3+0], decoded_pos[i*3+1], decoded_pos[i*3+2]));
+            Scalar3 f_ref = box.makeFraction(make_scalar3(pos[i*3+0], pos[i*3+1], pos[i*3+2]));
+            UP_ASSERT(std::abs(f.x - f_ref.x) <= Scalar(0.5001) / Scalar(1 << bits));
+            UP_ASSERT(std::abs(f.y - f_ref.y) <= Scalar(0.5001) / Scalar(1 << bits));
+            UP_ASSERT(std::abs(f.z - f_ref.z) <= Scalar(0.5001) / Scalar(1 << bits));
+            }
+
+        reference = grid;
+        }
+    }
+
+//! Values far from the block mean are escaped
+UP_TEST( GSDPositionCodec_escape )
+    {
+    const unsigned int bits = 20;
+    std::vector<uint32_t> reference(300, 5), grid(300, 5), decoded;
+    grid[7] = (1 << bits) - 1;
+    grid[100] = 1 << (bits - 1);
+    grid[299] = 6;
+
+    std::vector<uint8_t> encoded;
+    GSDPositionCodec::encode(encoded, grid, &reference, bits);
+
+    decoded = reference;
+    unsigned int decoded_bits = 0;
+    GSDPositionCodec::decode(decoded, &encoded[0], encoded.size(), decoded_bits);
+    UP_ASSERT(decoded == grid);
+    }
@@ -363,6 +363,88 @@ void test_load_balancer_ghost(std::shared_ptr<ExecutionConfiguration> exec_conf,
     UP_ASSERT_EQUAL(pdata->getOwnerRank(7), di(1,0,1));
     }
 
+//! Test balancing of the measured time
+void test_load_balancer_time(std::shared_ptr<ExecutionConfiguration> exec_conf, const BoxDim& dest_box, bool balance_time)
+{
+    // this test needs to be run on eight processors
+    int size;
+    MPI_Comm_size(exec_conf->getHOOMDWorldMPICommunicator(), &size);
+    UP_ASSERT_EQUAL(size,8);
+
+    // create a system with eight particles
+    BoxDim ref_box = BoxDim(2.0);
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(8,           // number of particles
+                                                             dest_box,        // box dimensions
+                                                             1,           // number of particle types
+                                                             0,           // number of bond types
+                                                             0,           // number of angle types
+                                                             0,           // number of dihedral types
+                                                             0,           // number of dihedral types
+                                                             exec_conf));
+
+    std::shared_ptr<ParticleData> pdata(sysdef->getParticleData());
+
+    // one particle in the center of each domain
+    pdata->setPosition(0, TO_TRICLINIC(make_scalar3(-0.5,-0.5,-0.5)),false);
+    pdata->setPosition(1, TO_TRICLINIC(make_scalar3(-0.5,-0.5,0.5)),false);
+    pdata->setPosition(2, TO_TRICLINIC(make_scalar3(-0.5,0.5,-0.5)),false);
+    pdata->setPosition(3, TO_TRICLINIC(make_scalar3(-0.5,0.5,0.5)),false);
+    pdata->setPosition(4, TO_TRICLINIC(make_scalar3(0.5,-0.5,-0.5)),false);
+    pdata->setPosition(5, TO_TRICLINIC(make_scalar3(0.5,-0.5,0.5)),false);
+    pdata->setPosition(6, TO_TRICLINIC(make_scalar3(0.5,0.5,-0.5)),false);
+    pdata->setPosition(7, TO_TRICLINIC(make_scalar3(0.5,0.5,0.5)),false);
+
+    SnapshotParticleData<Scalar> snap(8);
+    pdata->takeSnapshot(snap);
+
+    // initialize a 2x2x2 domain decomposition on processor with rank 0
+    std::vector<Scalar> fxs(1), fys(1), fzs(1);
+    fxs[0] = Scalar(0.5);
+    fys[0] = Scalar(0.5);
+    fzs[0] = Scalar(0.5);
+    std::shared_ptr<DomainDecomposition> decomposition(new DomainDecomposition(exec_conf, pdata->getBox().getL(), fxs, fys, fzs));
+    std::shared_ptr<Communicator> comm(new Communicator(sysdef, decomposition));
+    pdata->setDomainDecomposition(decomposition);
+
+    pdata->initializeFromSnapshot(snap);
+
+    auto trigger = std::make_shared<PeriodicTrigger>(1);
+    std::shared_ptr<LoadBalancer> lb(new LoadBalancer(sysdef,decomposition, trigger));
+    lb->setCommunicator(comm);
+    lb->enableDimension(0, false);
+    lb->enableDimension(1, false);
+    if (balance_time)
+        lb->setLoad("time");
+    UP_ASSERT_EQUAL(lb->getLoad(), std::string(balance_time ? "time" : "particles"));
+
+    comm->migrateParticles();
+    UP_ASSERT_EQUAL(pdata->getN(), 1);
+
+    // the lower half of the box takes three times as long per particle as the upper half
+    uint3 grid_pos = decomposition->getGridPos();
+    comm->addWorkTime(grid_pos.z == 0 ? 3000 : 1000);
+    lb->update(0);
+
+    // the measured time is reported for either load and the work time is consumed
+    MY_CHECK_CLOSE(lb->getTimeImbalance(), 1.5, tol);
+    UP_ASSERT_EQUAL(comm->getWorkTime(), int64_t(0));
+
+    // the particles are balanced, so only the time balancing moves the domain boundary (by at most 5%)
+    std::vector<Scalar> cum_frac_z = decomposition->getCumulativeFractions(2);
+    if (balance_time)
+        {
+        MY_CHECK_CLOSE(cum_frac_z[1], 0.475, tol);
+        }
+    else
+        {
+        MY_CHECK_CLOSE(cum_frac_z[1], 0.5, tol);
+        }
+
+    // the boundary does not reach the particles, so each rank still owns one
+    UP_ASSERT_EQUAL(pdata->getN(), 1);
+    MY_CHECK_CLOSE(lb->getParticleImbalance(), 1.0, tol);
+    }
+
 //! Tests basic particle redistribution
 UP_TEST( LoadBalancer_test_basic)
     {
@@ -399,6 +481,18 @@ UP_TEST( LoadBalancer_test_ghost)
     test_load_balancer_ghost<LoadBalancer>(exec_conf, BoxDim(1.0,-.6,.7,.5));
     }
 
+//! Tests balancing of the measured time
+UP_TEST( LoadBalancer_test_time)
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    // balance the number of particles
+    test_load_balancer_time(exec_conf, BoxDim(2.0), false);
+    // balance the time, cubic box
+    test_load_balancer_time(exec_conf, BoxDim(2.0), true);
+    // balance the time, triclinic box
+    test_load_balancer_time(exec_conf, BoxDim(1.0,.1,.2,.3), true);
+    }
+
 #ifdef ENABLE_HIP
 //! Tests basic particle redistribution on the GPU
 UP_TEST( LoadBalancerGPU_test_basic)
@@ -0,0 +1,234 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+#ifdef ENABLE_MPI
+
+// this has to be included after naming the test module
+#include "upp11_config.h"
+HOOMD_UP_MAIN();
+
+#include <memory>
+#include <algorithm>
+
+#include "hoomd/ExecutionConfiguration.h"
+#include "hoomd/Communicator.h"
+#include "hoomd/ParticleGroup.h"
+#include "hoomd/filter/ParticleFilterTags.h"
+
+/*! \file test_particle_group_mpi.cc
+    \brief Unit tests for dynamic ParticleGroups with domain decomposition
+    \ingroup unit_tests
+*/
+
+using namespace std;
+
+//! Number of group membership bits in ParticleData
+const unsigned int n_group_flags = sizeof(unsigned int)*8;
+
+//! Create a system of eight particles, one in each domain of a 2x2x2 decomposition
+std::shared_ptr<SystemDefinition> create_sysdef(std::shared_ptr<ExecutionConfiguration> exec_conf,
+                                                std::shared_ptr<Communicator>& comm)
+    {
+    // this test needs to be run on eight processors
+    int size;
+    MPI_Comm_size(exec_conf->getHOOMDWorldMPICommunicator(), &size);
+    UP_ASSERT_EQUAL(size,8);
+
+    BoxDim box(2.0);
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(8, box, 1, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata(sysdef->getParticleData());
+
+    for (unsigned int tag = 0; tag < 8; ++tag)
+        {
+        Scalar x = (tag & 1) ? Scalar(0.5) : Scalar(-0.5);
+        Scalar y = (tag & 2) ? Scalar(0.5) : Scalar(-0.5);
+        Scalar z = (tag & 4) ? Scalar(0.5) : Scalar(-0.5);
+        pdata->setPosition(tag, make_scalar3(x,y,z), false);
+        }
+
+    SnapshotParticleData<Scalar> snap(8);
+    pdata->takeSnapshot(snap);
+
+    std::shared_ptr<DomainDecomposition> decomposition(new DomainDecomposition(exec_conf, box.getL(), 2, 2, 2));
+    comm = std::shared_ptr<Communicator>(new Communicator(sysdef, decomposition));
+    pdata->setDomainDecomposition(decomposition);
+    pdata->initializeFromSnapshot(snap);
+
+    // every rank owns one particle
+    UP_ASSERT_EQUAL(pdata->getN(), 1);
+    return sysdef;
+    }
+
+//! Move every particle into the domain diagonally opposite to its current one and migrate it
+void flip_particles(std::shared_ptr<SystemDefinition> sysdef, std::shared_ptr<Communicator> comm)
+    {
+    std::shared_ptr<ParticleData> pdata(sysdef->getParticleData());
+    for (unsigned int tag = 0; tag < 8; ++tag)
+        {
+        Scalar3 pos = pdata->getPosition(tag);
+        pdata->setPosition(tag, -pos, false);
+        }
+    comm->migrateParticles();
+    UP_ASSERT_EQUAL(pdata->getN(), 1);
+    }
+
+//! Check the local and global membership of a group against the selected tags
+void check_group(std::shared_ptr<SystemDefinition> sysdef,
+                 std::shared_ptr<ParticleGroup> group,
+                 const std::vector<unsigned int>& group_tags)
+    {
+    std::shared_ptr<ParticleData> pdata(sysdef->getParticleData());
+    UP_ASSERT_EQUAL(group->getNumMembersGlobal(), (unsigned int)group_tags.size());
+
+    // every local particle is a member if and only if its tag was selected
+    unsigned int n_local_members = group->getNumMembers();
+    unsigned int n_selected = 0;
+        {
+        ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
+        for (unsigned int idx = 0; idx < pdata->getN(); ++idx)
+            {
+            bool selected = std::find(group_tags.begin(), group_tags.end(), h_tag.data[idx]) != group_tags.end();
+            UP_ASSERT_EQUAL(group->isMember(idx), selected);
+            if (selected)
+                n_selected++;
+            }
+        }
+    UP_ASSERT_EQUAL(n_local_members, n_selected);
+
+    // the member indices point to selected local particles
+    for (unsigned int j = 0; j < n_local_members; ++j)
+        {
+        unsigned int idx = group->getMemberIndex(j);
+        UP_ASSERT(idx < pdata->getN());
+        UP_ASSERT(group->isMember(idx));
+        }
+
+    // the writers gather the member tags on the root rank
+    group->gatherMemberTags();
+    if (sysdef->getParticleData()->getExecConf()->isRoot())
+        {
+        for (unsigned int i = 0; i < group_tags.size(); ++i)
+            UP_ASSERT_EQUAL(group->getMemberTag(i), group_tags[i]);
+        }
+    }
+
+//! Select the tags {k, k+3, k+5} modulo 8, sorted
+std::vector<unsigned int> make_group_tags(unsigned int k)
+    {
+    std::vector<unsigned int> tags = {k % 8, (k + 3) % 8, (k + 5) % 8};
+    std::sort(tags.begin(), tags.end());
+    return tags;
+    }
+
+//! Test that the members of a dynamic group migrate with the particles
+UP_TEST( dynamic_group_migrate )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    std::shared_ptr<Communicator> comm;
+    std::shared_ptr<SystemDefinition> sysdef = create_sysdef(exec_conf, comm);
+
+    std::vector<unsigned int> group_tags = {1, 4, 6};
+    std::shared_ptr<ParticleGroup> group(new ParticleGroup(sysdef,
+        std::shared_ptr<ParticleFilter>(new ParticleFilterTags(group_tags))));
+    check_group(sysdef, group, group_tags);
+
+    flip_particles(sysdef, comm);
+    check_group(sysdef, group, group_tags);
+
+    flip_particles(sysdef, comm);
+    check_group(sysdef, group, group_tags);
+    }
+
+//! Test dynamic groups created after all membership bits are in use
+UP_TEST( dynamic_group_flags_exhausted )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    std::shared_ptr<Communicator> comm;
+    std::shared_ptr<SystemDefinition> sysdef = create_sysdef(exec_conf, comm);
+
+    // the groups beyond the first n_group_flags store their member tags on every rank
+    const unsigned int n_groups = n_group_flags + 8;
+    std::vector< std::shared_ptr<ParticleGroup> > groups;
+    for (unsigned int k = 0; k < n_groups; ++k)
+        {
+        groups.push_back(std::shared_ptr<ParticleGroup>(new ParticleGroup(sysdef,
+            std::shared_ptr<ParticleFilter>(new ParticleFilterTags(make_group_tags(k))))));
+        }
+
+    for (unsigned int k = 0; k < n_groups; ++k)
+        check_group(sysdef, groups[k], make_group_tags(k));
+
+    flip_particles(sysdef, comm);
+    for (unsigned int k = 0; k < n_groups; ++k)
+        check_group(sysdef, groups[k], make_group_tags(k));
+
+    // a new group reuses a released bit and must not inherit the members of its previous owner
+    groups[0].reset();
+    std::vector<unsigned int> new_tags = {2, 7};
+    std::shared_ptr<ParticleGroup> new_group(new ParticleGroup(sysdef,
+        std::shared_ptr<ParticleFilter>(new ParticleFilterTags(new_tags))));
+    check_group(sysdef, new_group, new_tags);
+
+    flip_particles(sysdef, comm);
+    check_group(sysdef, new_group, new_tags);
+    for (unsigned int k = 1; k < n_groups; ++k)
+        check_group(sysdef, groups[k], make_group_tags(k));
+    }
+
+//! Test access to the member tags of a dynamic group on the ranks other than root
+UP_TEST( dynamic_group_member_tags_non_root )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    std::shared_ptr<Communicator> comm;
+    std::shared_ptr<SystemDefinition> sysdef = create_sysdef(exec_conf, comm);
+
+    std::vector<unsigned int> tags_a = {0, 3, 5};
+    std::vector<unsigned int> tags_b = {3, 6};
+    std::shared_ptr<ParticleGroup> group_a(new ParticleGroup(sysdef,
+        std::shared_ptr<ParticleFilter>(new ParticleFilterTags(tags_a))));
+    std::shared_ptr<ParticleGroup> group_b(new ParticleGroup(sysdef,
+        std::shared_ptr<ParticleFilter>(new ParticleFilterTags(tags_b))));
+    flip_particles(sysdef, comm);
+
+    // the gathered tags are only available on the root rank
+    group_a->gatherMemberTags();
+    if (exec_conf->isRoot())
+        {
+        for (unsigned int i = 0; i < tags_a.size(); ++i)
+            UP_ASSERT_EQUAL(group_a->getMemberTag(i), tags_a[i]);
+        }
+    else
+        {
+        UP_ASSERT_EXCEPTION(std::runtime_error, [&]{ group_a->getMemberTag(0); });
+        }
+
+    // group set operations gather the member tags on all ranks and return groups with replicated tag lists
+    std::shared_ptr<ParticleGroup> group_union = ParticleGroup::groupUnion(group_a, group_b);
+    std::shared_ptr<ParticleGroup> group_intersection = ParticleGroup::groupIntersection(group_a, group_b);
+    std::shared_ptr<ParticleGroup> group_difference = ParticleGroup::groupDifference(group_a, group_b);
+
+    std::vector<unsigned int> union_tags = {0, 3, 5, 6};
+    std::vector<unsigned int> intersection_tags = {3};
+    std::vector<unsigned int> difference_tags = {0, 5};
+
+    UP_ASSERT_EQUAL(group_union->getNumMembersGlobal(), (unsigned int)union_tags.size());
+    for (unsigned int i = 0; i < union_tags.size(); ++i)
+        UP_ASSERT_EQUAL(group_union->getMemberTag(i), union_tags[i]);
+
+    UP_ASSERT_EQUAL(group_intersection->getNumMembersGlobal(), (unsigned int)intersection_tags.size());
+    for (unsigned int i = 0; i < intersection_tags.size(); ++i)
+        UP_ASSERT_EQUAL(group_intersection->getMemberTag(i), intersection_tags[i]);
+
+    UP_ASSERT_EQUAL(group_difference->getNumMembersGlobal(), (unsigned int)difference_tags.size());
+    for (unsigned int i = 0; i < difference_tags.size(); ++i)
+        UP_ASSERT_EQUAL(group_difference->getMemberTag(i), difference_tags[i]);
+
+    // the local membership of the new groups follows the particles
+    check_group(sysdef, group_union, union_tags);
+    flip_particles(sysdef, comm);
+    check_group(sysdef, group_union, union_tags);
+    check_group(sysdef, group_a, tags_a);
+    }
+
+#endif //ENABLE_MPI
@@ -1,6 +1,8 @@
 """Define LoadBalancer."""
 
 from hoomd.data.parameterdicts import ParameterDict
+from hoomd.data.typeconverter import OnlyFrom
+from hoomd.logging import log
 from hoomd.operation import Tuner
 from hoomd.trigger import Trigger
 from hoomd import _hoomd
@@ -19,6 +21,8 @@ class LoadBalancer(Tuner):
         tolerance (:obj:`float`): Load imbalance tolerance.
         max_iterations (:obj:`int`): Maximum number of iterations to
             attempt in a single step.
+        load (:obj:`str`): Quantity to balance, ``'particles'`` or
+            ``'time'``.
 
     `LoadBalancer` adjusts the boundaries of the MPI domains to distribute
     the particle load close to evenly between them. The load imbalance is
@@ -48,6 +52,19 @@ class LoadBalancer(Tuner):
     significantly more pair force neighbors than others, this estimate of the
     load imbalance may not produce the optimal results.
 
+    Set *load* to ``'time'`` to balance the measured wall clock time instead.
+    Each rank then weights its particles by its cost per particle: the time
+    spent in force computes (including neighbor list builds) on the rank since
+    the last update divided by the number of particles it owns. In
+    :math:`I`, :math:`N_i` becomes the weighted number of particles, so dense
+    regions or regions with expensive bonded interactions end up in smaller
+    domains. Balancing the time is only supported on the CPU.
+
+    `time_imbalance` logs the ratio of the largest to the average time per rank
+    measured before the last update, for either *load*. Compare it to
+    `particle_imbalance` to judge how well the number of particles represents
+    the work.
+
     A load balancing adjustment is only performed when the maximum load
     imbalance exceeds a *tolerance*. The ideal load balance is 1.0, so setting
     *tolerance* less than 1.0 will force an adjustment every update. The load
@@ -82,6 +99,8 @@ class LoadBalancer(Tuner):
         tolerance (:obj:`float`): Load imbalance tolerance.
         max_iterations (:obj:`int`): Maximum number of iterations to
             attempt in a single step.
+        load (:obj:`str`): Quantity to balance, ``'particles'`` or
+            ``'time'``.
     """
 
     def __init__(self,
@@ -90,18 +109,21 @@ class LoadBalancer(Tuner):
                  y=True,
                  z=True,
                  tolerance=1.02,
-                 max_iterations=1):
+                 max_iterations=1,
+                 load='particles'):
         defaults = dict(x=x,
                         y=y,
                         z=z,
                         tolerance=tolerance,
                         max_iterations=max_iterations,
+                        load=load,
                         trigger=trigger)
         self._param_dict = ParameterDict(x=bool,
                                          y=bool,
                                          z=bool,
                                          max_iterations=int,
                                          tolerance=float,
+                                         load=OnlyFrom(['particles', 'time']),
                                          trigger=Trigger)
         self._param_dict.update(defaults)
 
@@ -116,3 +138,23 @@ class LoadBalancer(Tuner):
             ), self.trigger)
 
         super()._attach()
+
+    @log
+    def particle_imbalance(self):
+        """float: Maximum particle imbalance after the last update."""
+        if self._attached:
+            return self._cpp_obj.particle_imbalance
+        else:
+            return None
+
+    @log
+    def time_imbalance(self):
+        """float: Maximum imbalance of the measured time before the last update.
+
+        The largest time any rank spent in force computes between the last two
+        updates divided by the average over all ranks.
+        """
+        if self._attached:
+            return self._cpp_obj.time_imbalance
+        else:
+            return None
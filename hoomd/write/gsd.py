@@ -5,7 +5,7 @@
 
 from hoomd import _hoomd
 from hoomd.util import dict_flatten, array_to_strings
-from hoomd.data.typeconverter import OnlyFrom
+from hoomd.data.typeconverter import OnlyFrom, OnlyType
 from hoomd.filter import ParticleFilter, All
 from hoomd.data.parameterdicts import ParameterDict
 from hoomd.logging import Logger, TypeFlags
@@ -29,6 +29,11 @@ class GSD(Writer):
             Defaults to ``['property']``.
         log (hoomd.logging.Logger): Provide log quantities to write. Defaults to
             `None`.
+        asynchronous (bool): When `True`, write frames to the file on a
+            background thread. Defaults to `False`.
+        position_precision (float): Resolution of the stored particle
+            positions as a fraction of the box length, or `None` to store full
+            precision positions. Defaults to `None`.
 
     `GSD` writes a simulation snapshot to the specified file each time it
     triggers. `GSD` can store all particle, bond, angle, dihedral, improper,
@@ -120,6 +125,33 @@ class GSD(Writer):
         to `None` or remove specific quantities from the logger, but do not
         add additional quantities after the first frame.
 
+    .. rubric:: Asynchronous writes
+
+    When `asynchronous` is `True`, `GSD` gathers each frame and hands it to a
+    background thread that writes it to the file while the simulation
+    continues. `GSD` waits for the previous frame to complete only when it
+    writes the next one, so writing a frame does not stall the simulation
+    unless frames are triggered faster than the file system can store them.
+    A frame may still be incomplete in the file after `Simulation.run
+    <hoomd.Simulation.run>` returns. Call `flush` before reading the file
+    while `GSD` is attached.
+
+    .. rubric:: Compressed positions
+
+    When `position_precision` is set, `GSD` rounds particle positions to a grid
+    with spacing `position_precision` (in fractions of the box length) and
+    stores them in the chunk ``hoomd/compressed/particles/position`` instead of
+    ``particles/position``. Every 32nd frame stores the full grid coordinates,
+    and the frames in between store the differences to the previous frame in a
+    variable length code. Trajectories of liquids typically need 4 to 6 times
+    less space for the positions than with full precision. The positions of
+    particles that do not move between frames take up about 3 bits per frame.
+
+    Warning:
+        Only `hoomd.Simulation.create_state_from_gsd` decodes compressed
+        positions. Other GSD readers, including the ``gsd`` Python package and
+        visualization tools, will not find particle positions in the file.
+
     Attributes:
         filename (str): File name to write.
         trigger (hoomd.trigger.Trigger): Select the timesteps to write.
@@ -128,6 +160,11 @@ class GSD(Writer):
         truncate (bool): When `True`, truncate the file and write a new frame 0
             each time this operation triggers.
         dynamic (list[str]): Quantity categories to save in every frame.
+        asynchronous (bool): When `True`, write frames to the file on a
+            background thread.
+        position_precision (float): Resolution of the stored particle
+            positions as a fraction of the box length, or `None` to store full
+            precision positions.
     """
 
     def __init__(self,
@@ -137,7 +174,9 @@ class GSD(Writer):
                  mode='ab',
                  truncate=False,
                  dynamic=None,
-                 log=None):
+                 log=None,
+                 asynchronous=False,
+                 position_precision=None):
 
         super().__init__(trigger)
 
@@ -152,7 +191,12 @@ class GSD(Writer):
                           mode=str(mode),
                           truncate=bool(truncate),
                           dynamic=[dynamic_validation],
-                          _defaults=dict(filter=filter, dynamic=dynamic)))
+                          asynchronous=bool(asynchronous),
+                          position_precision=OnlyType(float, allow_none=True),
+                          _defaults=dict(
+                              filter=filter,
+                              dynamic=dynamic,
+                              position_precision=position_precision)))
 
         self._log = None if log is None else _GSDLogWriter(log)
 
@@ -181,6 +225,14 @@ class GSD(Writer):
         self._cpp_obj.log_writer = self.log
         super()._attach()
 
+    def flush(self):
+        """Wait until all frames are written to the file.
+
+        `flush` has no effect unless `asynchronous` is `True`.
+        """
+        if self._attached:
+            self._cpp_obj.flush()
+
     @staticmethod
     def write(state, filename, filter=All(), mode='wb', log=None):
         """Write the given simulation state out to a GSD file.